@@ -26,6 +26,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkCommandLineParser.h>
 
 #include <mitkIntensityQuantifier.h>
+#include <mitkGlobalImageFeatureContext.h>
 
 // STD Includes
 
@@ -212,6 +213,14 @@ public:
   itkSetMacro(MorphMask, mitk::Image::Pointer);
   itkGetConstMacro(MorphMask, mitk::Image::Pointer);
 
+  /**
+  * \brief Shared information of the current image. If the context belongs to the image passed to
+  * InitializeQuantifier or GetQuantizedRegion, the intensity ranges and the quantized voxels are taken from
+  * the context instead of walking the image again.
+  */
+  itkSetMacro(Context, GlobalImageFeatureContext::Pointer);
+  itkGetConstMacro(Context, GlobalImageFeatureContext::Pointer);
+
   itkSetMacro(Bins, int);
   itkSetMacro(UseBins, bool);
   itkGetConstMacro(UseBins, bool);
@@ -237,8 +246,17 @@ public:
   void AddQuantifierArguments(mitkCommandLineParser &parser);
   void InitializeQuantifierFromParameters(const Image::Pointer & feature, const Image::Pointer &mask,unsigned int defaultBins = 256);
   void InitializeQuantifier(const Image::Pointer & feature, const Image::Pointer &mask, unsigned int defaultBins = 256);
+  void InitializeQuantifierFromContext(const Image::Pointer &mask, unsigned int defaultBins = 256);
   std::string QuantifierParameterString();
 
+  /**
+  * \brief Masked voxels of the feature image, quantized by the current quantifier and padded by the given number of voxels.
+  *
+  * The region is shared through the context if the context belongs to the feature image. Otherwise
+  * it is gathered for this call only. InitializeQuantifier has to be called before.
+  */
+  GlobalImageFeatureContext::QuantizedRegion::ConstPointer GetQuantizedRegion(const Image::Pointer & feature, const Image::Pointer &mask, unsigned int padding);
+
 public:
 
 //#ifndef DOXYGEN_SKIP
@@ -287,6 +305,7 @@ private:
   bool m_CalculateWithParameter = false;
 
   mitk::Image::Pointer m_MorphMask = nullptr;
+  GlobalImageFeatureContext::Pointer m_Context = nullptr;
 //#endif // Skip Doxygen
 
 };
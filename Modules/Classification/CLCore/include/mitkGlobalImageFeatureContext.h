@@ -0,0 +1,169 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef mitkGlobalImageFeatureContext_h
+#define mitkGlobalImageFeatureContext_h
+
+#include <MitkCLCoreExports.h>
+
+#include <mitkImage.h>
+#include <mitkIntensityQuantifier.h>
+#include <itkObject.h>
+#include <itkOffset.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * \brief Caches the intensity information that is shared between all feature classes working on one image.
+  *
+  * Every feature class that uses a histogram initializes its IntensityQuantifier from the
+  * intensity range of the image or of the masked region. Without a context, each class casts
+  * the mask and walks the complete image again for this, usually twice per class. The context
+  * performs this walk once per (image, mask) pair.
+  *
+  * The texture classes additionally need the quantized intensities of the masked voxels and of
+  * their neighbours. The context gathers them once per mask and quantifier setting into a
+  * QuantizedRegion, which all classes with the same setting share.
+  *
+  * All getters are thread safe, so that a single context can be shared by feature classes that
+  * are calculated concurrently. The context only stores raw pointers to the masks as keys, the
+  * caller has to keep the image and the masks alive for the lifetime of the context.
+  */
+  class MITKCLCORE_EXPORT GlobalImageFeatureContext : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(GlobalImageFeatureContext, itk::Object)
+      itkFactorylessNewMacro(Self)
+
+    /** \brief Sets the intensity image. Discards all cached information. */
+    void SetImage(const Image::Pointer &image);
+    itkGetConstMacro(Image, Image::Pointer);
+
+    /** \brief Returns true if the context caches information for the given intensity image */
+    bool IsContextOf(const Image::Pointer &image) const;
+
+    /** \brief Minimum and maximum of all voxels of the image */
+    void GetImageRange(double &minimum, double &maximum);
+
+    /** \brief Minimum and maximum of all voxels with a mask value greater than zero */
+    void GetRegionRange(const Image::Pointer &mask, double &minimum, double &maximum);
+
+    /**
+    * \brief Bin indices of the masked voxels in a padded buffer.
+    *
+    * The buffer covers the largest possible region of the image and Padding additional voxels on
+    * both sides of every image dimension. Each entry is the bin index of the voxel, OutsideMask for
+    * voxels that are not masked or have a NaN intensity, and OutsideImage for the padding. This way
+    * neighbours up to the padding distance are addressed by a constant linear offset without bounds
+    * checks. Unused dimensions of 2D images have the size 1 and no padding.
+    */
+    struct QuantizedRegion
+    {
+      typedef std::shared_ptr<const QuantizedRegion> ConstPointer;
+
+      /** Bins of voxels that are not part of the masked region */
+      enum
+      {
+        OutsideMask = -1,
+        OutsideImage = -2
+      };
+
+      unsigned int Dimension = 0;
+      unsigned int NumberOfBins = 0;
+      int Size[3] = { 1, 1, 1 };
+      int Padding[3] = { 0, 0, 0 };
+      std::ptrdiff_t Stride[3] = { 1, 1, 1 };
+
+      /** Bin indices of the padded buffer */
+      std::vector<int> Bins;
+      /** Buffer positions of all masked voxels, in image order */
+      std::vector<std::ptrdiff_t> Voxels;
+
+      /** Buffer position of the voxel with the given index relative to the start of the image region */
+      std::ptrdiff_t Position(const int *index) const
+      {
+        return (index[0] + Padding[0]) * Stride[0] + (index[1] + Padding[1]) * Stride[1] + (index[2] + Padding[2]) * Stride[2];
+      }
+
+      /** Index relative to the start of the image region of the given buffer position */
+      void Index(std::ptrdiff_t position, int *index) const
+      {
+        for (int d = 2; d >= 0; --d)
+        {
+          index[d] = static_cast<int>(position / Stride[d]) - Padding[d];
+          position %= Stride[d];
+        }
+      }
+
+      /** Difference of the buffer positions of two voxels that are separated by the given offset */
+      template <unsigned int VDimension>
+      std::ptrdiff_t LinearOffset(const itk::Offset<VDimension> &offset) const
+      {
+        std::ptrdiff_t linearOffset = 0;
+        for (unsigned int d = 0; d < VDimension; ++d)
+          linearOffset += offset[d] * Stride[d];
+        return linearOffset;
+      }
+    };
+
+    /**
+    * \brief Masked voxels of the image quantized by the given quantifier, padded by the given number of voxels.
+    *
+    * The region is gathered on the first request and shared by all later requests with the same mask,
+    * the same quantifier setting (minimum, bin size, number of bins) and the same padding.
+    */
+    QuantizedRegion::ConstPointer GetQuantizedRegion(const Image::Pointer &mask, const IntensityQuantifier::Pointer &quantifier, unsigned int padding);
+
+    /**
+    * \brief Gathers the quantized region of an image without caching it.
+    */
+    static QuantizedRegion::ConstPointer CreateQuantizedRegion(const Image::Pointer &image, const Image::Pointer &mask, const IntensityQuantifier::Pointer &quantifier, unsigned int padding);
+
+    struct RegionInformation
+    {
+      double Minimum = 0;
+      double Maximum = 0;
+    };
+
+  protected:
+    GlobalImageFeatureContext();
+    ~GlobalImageFeatureContext() override;
+
+  private:
+    RegionInformation & GetRegion(const Image::Pointer &mask);
+
+    Image::Pointer m_Image;
+
+    bool m_ImageRangeValid;
+    double m_ImageMinimum;
+    double m_ImageMaximum;
+
+    std::map<const Image *, RegionInformation> m_Regions;
+
+    typedef std::tuple<const Image *, double, double, unsigned int, unsigned int> QuantizedRegionKey;
+    std::map<QuantizedRegionKey, QuantizedRegion::ConstPointer> m_QuantizedRegions;
+    std::recursive_mutex m_Mutex;
+  };
+}
+
+#endif //mitkGlobalImageFeatureContext_h
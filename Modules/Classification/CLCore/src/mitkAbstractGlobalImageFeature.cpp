@@ -232,6 +232,12 @@ void  mitk::AbstractGlobalImageFeature::InitializeQuantifierFromParameters(const
 void  mitk::AbstractGlobalImageFeature::InitializeQuantifier(const Image::Pointer & feature, const Image::Pointer &mask, unsigned int defaultBins)
 {
   m_Quantifier = IntensityQuantifier::New();
+  if (m_Context.IsNotNull() && m_Context->IsContextOf(feature))
+  {
+    InitializeQuantifierFromContext(mask, defaultBins);
+    return;
+  }
+
   if (GetUseMinimumIntensity() && GetUseMaximumIntensity() && GetUseBinsize())
     m_Quantifier->InitializeByBinsizeAndMaximum(GetMinimumIntensity(), GetMaximumIntensity(), GetBinsize());
   else if (GetUseMinimumIntensity() && GetUseBins() && GetUseBinsize())
@@ -273,6 +279,64 @@ void  mitk::AbstractGlobalImageFeature::InitializeQuantifier(const Image::Pointe
     m_Quantifier->InitializeByImageRegion(feature, mask, defaultBins);
 }
 
+void  mitk::AbstractGlobalImageFeature::InitializeQuantifierFromContext(const Image::Pointer &mask, unsigned int defaultBins)
+{
+  // Same decision order as InitializeQuantifier, but the intensity ranges of the image
+  // and of the masked region are taken from the shared context.
+  double minimum = 0;
+  double maximum = 0;
+  if (GetUseMinimumIntensity() && GetUseMaximumIntensity() && GetUseBinsize())
+    m_Quantifier->InitializeByBinsizeAndMaximum(GetMinimumIntensity(), GetMaximumIntensity(), GetBinsize());
+  else if (GetUseMinimumIntensity() && GetUseBins() && GetUseBinsize())
+    m_Quantifier->InitializeByBinsizeAndBins(GetMinimumIntensity(), GetBins(), GetBinsize());
+  else if (GetUseMinimumIntensity() && GetUseMaximumIntensity() && GetUseBins())
+    m_Quantifier->InitializeByMinimumMaximum(GetMinimumIntensity(), GetMaximumIntensity(), GetBins());
+  // Intialize from Image and Binsize
+  else if (GetUseBinsize() && GetIgnoreMask())
+  {
+    m_Context->GetImageRange(minimum, maximum);
+    minimum = GetUseMinimumIntensity() ? GetMinimumIntensity() : minimum;
+    maximum = (!GetUseMinimumIntensity() && GetUseMaximumIntensity()) ? GetMaximumIntensity() : maximum;
+    m_Quantifier->InitializeByBinsizeAndMaximum(minimum, maximum, GetBinsize());
+  }
+  // Initialize form Image, Mask and Binsize
+  else if (GetUseBinsize())
+  {
+    m_Context->GetRegionRange(mask, minimum, maximum);
+    minimum = GetUseMinimumIntensity() ? GetMinimumIntensity() : minimum;
+    maximum = (!GetUseMinimumIntensity() && GetUseMaximumIntensity()) ? GetMaximumIntensity() : maximum;
+    m_Quantifier->InitializeByBinsizeAndMaximum(minimum, maximum, GetBinsize());
+  }
+  // Intialize from Image and Bins
+  else if (GetUseBins())
+  {
+    m_Context->GetImageRange(minimum, maximum);
+    minimum = (GetIgnoreMask() && GetUseMinimumIntensity()) ? GetMinimumIntensity() : minimum;
+    maximum = (GetIgnoreMask() && !GetUseMinimumIntensity() && GetUseMaximumIntensity()) ? GetMaximumIntensity() : maximum;
+    m_Quantifier->InitializeByMinimumMaximum(minimum, maximum, GetBins());
+  }
+  // Default
+  else if (GetIgnoreMask())
+  {
+    m_Context->GetImageRange(minimum, maximum);
+    m_Quantifier->InitializeByMinimumMaximum(minimum, maximum, GetBins());
+  }
+  else
+  {
+    m_Context->GetRegionRange(mask, minimum, maximum);
+    m_Quantifier->InitializeByMinimumMaximum(minimum, maximum, defaultBins);
+  }
+}
+
+mitk::GlobalImageFeatureContext::QuantizedRegion::ConstPointer mitk::AbstractGlobalImageFeature::GetQuantizedRegion(const Image::Pointer & feature, const Image::Pointer &mask, unsigned int padding)
+{
+  if (m_Context.IsNotNull() && m_Context->IsContextOf(feature))
+  {
+    return m_Context->GetQuantizedRegion(mask, m_Quantifier, padding);
+  }
+  return GlobalImageFeatureContext::CreateQuantizedRegion(feature, mask, m_Quantifier, padding);
+}
+
 std::string mitk::AbstractGlobalImageFeature::GetCurrentFeatureEncoding()
 {
   return "";
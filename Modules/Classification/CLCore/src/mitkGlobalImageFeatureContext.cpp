@@ -0,0 +1,224 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkGlobalImageFeatureContext.h>
+
+// STD
+#include <limits>
+
+// ITK
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+
+// MITK
+#include <mitkImageCast.h>
+#include <mitkImageAccessByItk.h>
+
+template<typename TPixel, unsigned int VImageDimension>
+static void
+CalculateContextImageRange(itk::Image<TPixel, VImageDimension>* itkImage, double &minimum, double &maximum)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+
+  TPixel localMinimum = std::numeric_limits<TPixel>::max();
+  TPixel localMaximum = std::numeric_limits<TPixel>::lowest();
+
+  itk::ImageRegionConstIterator<ImageType> iter(itkImage, itkImage->GetLargestPossibleRegion());
+  while (!iter.IsAtEnd())
+  {
+    localMinimum = std::min<TPixel>(localMinimum, iter.Get());
+    localMaximum = std::max<TPixel>(localMaximum, iter.Get());
+    ++iter;
+  }
+  minimum = localMinimum;
+  maximum = localMaximum;
+}
+
+template<typename TPixel, unsigned int VImageDimension>
+static void
+GatherContextRegion(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, mitk::GlobalImageFeatureContext::RegionInformation &region)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+  typedef itk::Image<int, VImageDimension> MaskType;
+
+  typename MaskType::Pointer itkMask = MaskType::New();
+  mitk::CastToItkImage(mask, itkMask);
+
+  TPixel localMinimum = std::numeric_limits<TPixel>::max();
+  TPixel localMaximum = std::numeric_limits<TPixel>::lowest();
+
+  itk::ImageRegionConstIterator<ImageType> iter(itkImage, itkImage->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<MaskType> maskIter(itkMask, itkMask->GetLargestPossibleRegion());
+
+  while (!iter.IsAtEnd())
+  {
+    if (maskIter.Get() > 0)
+    {
+      localMinimum = std::min<TPixel>(localMinimum, iter.Get());
+      localMaximum = std::max<TPixel>(localMaximum, iter.Get());
+    }
+    ++iter;
+    ++maskIter;
+  }
+  region.Minimum = localMinimum;
+  region.Maximum = localMaximum;
+}
+
+template<typename TPixel, unsigned int VImageDimension>
+static void
+GatherQuantizedRegion(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, mitk::IntensityQuantifier::Pointer quantifier, unsigned int padding, mitk::GlobalImageFeatureContext::QuantizedRegion &region)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+  typedef itk::Image<int, VImageDimension> MaskType;
+  typedef mitk::GlobalImageFeatureContext::QuantizedRegion QuantizedRegionType;
+
+  typename MaskType::Pointer itkMask = MaskType::New();
+  mitk::CastToItkImage(mask, itkMask);
+
+  auto imageRegion = itkImage->GetLargestPossibleRegion();
+  region.Dimension = VImageDimension;
+  region.NumberOfBins = quantifier->GetBins();
+
+  std::size_t bufferSize = 1;
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    region.Size[d] = (d < VImageDimension) ? static_cast<int>(imageRegion.GetSize(d)) : 1;
+    region.Padding[d] = (d < VImageDimension) ? static_cast<int>(padding) : 0;
+    region.Stride[d] = bufferSize;
+    bufferSize *= region.Size[d] + 2 * region.Padding[d];
+  }
+  region.Bins.assign(bufferSize, QuantizedRegionType::OutsideImage);
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> iter(itkImage, imageRegion);
+  itk::ImageRegionConstIterator<MaskType> maskIter(itkMask, itkMask->GetLargestPossibleRegion());
+
+  int index[3] = { 0, 0, 0 };
+  while (!iter.IsAtEnd())
+  {
+    for (unsigned int d = 0; d < VImageDimension; ++d)
+      index[d] = iter.GetIndex()[d] - imageRegion.GetIndex(d);
+    const std::ptrdiff_t position = region.Position(index);
+
+    const TPixel value = iter.Get();
+    if (maskIter.Get() > 0 && value == value)
+    {
+      region.Bins[position] = quantifier->IntensityToIndex(value);
+      region.Voxels.push_back(position);
+    }
+    else
+    {
+      region.Bins[position] = QuantizedRegionType::OutsideMask;
+    }
+    ++iter;
+    ++maskIter;
+  }
+}
+
+mitk::GlobalImageFeatureContext::GlobalImageFeatureContext() :
+  m_Image(nullptr),
+  m_ImageRangeValid(false),
+  m_ImageMinimum(0),
+  m_ImageMaximum(0)
+{
+}
+
+mitk::GlobalImageFeatureContext::~GlobalImageFeatureContext()
+{
+}
+
+void mitk::GlobalImageFeatureContext::SetImage(const Image::Pointer &image)
+{
+  std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+  m_Image = image;
+  m_ImageRangeValid = false;
+  m_Regions.clear();
+  m_QuantizedRegions.clear();
+  this->Modified();
+}
+
+bool mitk::GlobalImageFeatureContext::IsContextOf(const Image::Pointer &image) const
+{
+  return m_Image.IsNotNull() && m_Image.GetPointer() == image.GetPointer();
+}
+
+void mitk::GlobalImageFeatureContext::GetImageRange(double &minimum, double &maximum)
+{
+  std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+  if (m_Image.IsNull())
+    mitkThrow() << "GlobalImageFeatureContext: No image set.";
+
+  if (!m_ImageRangeValid)
+  {
+    AccessByItk_2(m_Image, CalculateContextImageRange, m_ImageMinimum, m_ImageMaximum);
+    m_ImageRangeValid = true;
+  }
+  minimum = m_ImageMinimum;
+  maximum = m_ImageMaximum;
+}
+
+mitk::GlobalImageFeatureContext::RegionInformation & mitk::GlobalImageFeatureContext::GetRegion(const Image::Pointer &mask)
+{
+  if (m_Image.IsNull())
+    mitkThrow() << "GlobalImageFeatureContext: No image set.";
+  if (mask.IsNull())
+    mitkThrow() << "GlobalImageFeatureContext: No mask given.";
+
+  auto iter = m_Regions.find(mask.GetPointer());
+  if (iter != m_Regions.end())
+    return iter->second;
+
+  RegionInformation &region = m_Regions[mask.GetPointer()];
+  AccessByItk_2(m_Image, GatherContextRegion, mask, region);
+  return region;
+}
+
+void mitk::GlobalImageFeatureContext::GetRegionRange(const Image::Pointer &mask, double &minimum, double &maximum)
+{
+  std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+  RegionInformation &region = GetRegion(mask);
+  minimum = region.Minimum;
+  maximum = region.Maximum;
+}
+
+mitk::GlobalImageFeatureContext::QuantizedRegion::ConstPointer mitk::GlobalImageFeatureContext::GetQuantizedRegion(const Image::Pointer &mask, const IntensityQuantifier::Pointer &quantifier, unsigned int padding)
+{
+  std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+  if (m_Image.IsNull())
+    mitkThrow() << "GlobalImageFeatureContext: No image set.";
+  if (mask.IsNull())
+    mitkThrow() << "GlobalImageFeatureContext: No mask given.";
+  if (quantifier.IsNull() || !quantifier->GetInitialized())
+    mitkThrow() << "GlobalImageFeatureContext: The quantifier is not initialized.";
+
+  QuantizedRegionKey key(mask.GetPointer(), quantifier->GetMinimum(), quantifier->GetBinsize(), quantifier->GetBins(), padding);
+  auto iter = m_QuantizedRegions.find(key);
+  if (iter != m_QuantizedRegions.end())
+    return iter->second;
+
+  auto region = CreateQuantizedRegion(m_Image, mask, quantifier, padding);
+  m_QuantizedRegions[key] = region;
+  return region;
+}
+
+mitk::GlobalImageFeatureContext::QuantizedRegion::ConstPointer mitk::GlobalImageFeatureContext::CreateQuantizedRegion(const Image::Pointer &image, const Image::Pointer &mask, const IntensityQuantifier::Pointer &quantifier, unsigned int padding)
+{
+  if (quantifier.IsNull() || !quantifier->GetInitialized())
+    mitkThrow() << "GlobalImageFeatureContext: The quantifier is not initialized.";
+
+  auto region = std::make_shared<QuantizedRegion>();
+  AccessByItk_n(image, GatherQuantizedRegion, (mask, quantifier, padding, *region));
+  return region;
+}
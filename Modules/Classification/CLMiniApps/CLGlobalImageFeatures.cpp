@@ -670,11 +670,18 @@ int main(int argc, char* argv[])
 
     mitk::AbstractGlobalImageFeature::FeatureListType stats;
 
+    // The context gathers the intensity ranges and the quantized masked voxels of the
+    // image only once for all feature classes.
+    mitk::GlobalImageFeatureContext::Pointer context = mitk::GlobalImageFeatureContext::New();
+    context->SetImage(cImage);
+
     for (auto cFeature : features)
     {
       log << " Calculating " << cFeature->GetFeatureClassName() << " -";
       cFeature->SetMorphMask(cMorphMask);
+      cFeature->SetContext(context);
       cFeature->CalculateFeaturesUsingParameters(cImage, cMask, cMaskNoNaN, stats);
+      cFeature->SetContext(nullptr);
     }
 
     for (std::size_t i = 0; i < stats.size(); ++i)
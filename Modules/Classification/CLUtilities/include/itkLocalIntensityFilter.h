@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkArray.h"
 #include "itkSimpleDataObjectDecorator.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -149,6 +151,9 @@ namespace itk
     Array< RealType >       m_ThreadLocalMaximum;
     Array< RealType >       m_ThreadLocalPeakValue;
     Array< RealType >       m_ThreadGlobalPeakValue;
+    // Prefix sums along each image row (dimension 0), one more entry than the
+    // row length, so that the sum of every row segment takes two lookups.
+    std::vector< double >   m_RowPrefixSums;
     typename MaskImageType::Pointer m_Mask;
     double m_Range;
   }; // end of class
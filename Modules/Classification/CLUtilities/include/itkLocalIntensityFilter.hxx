@@ -22,7 +22,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkNeighborhoodIterator.h>
 #include <itkImageRegionIterator.h>
 #include <itkImageIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
+#include <algorithm>
 #include <limits>
 
 #include "itkImageScanlineIterator.h"
@@ -174,6 +176,22 @@ namespace itk
     m_ThreadLocalPeakValue.Fill(std::numeric_limits< RealType>::lowest());
     m_ThreadGlobalPeakValue.Fill(std::numeric_limits< RealType>::lowest());
 
+    typename TInputImage::ConstPointer itkImage = this->GetInput();
+    auto imageSize = itkImage->GetLargestPossibleRegion().GetSize();
+    const std::size_t rowLength = imageSize[0];
+    const std::size_t numberOfRows = itkImage->GetLargestPossibleRegion().GetNumberOfPixels() / rowLength;
+    m_RowPrefixSums.assign(numberOfRows * (rowLength + 1), 0);
+
+    itk::ImageRegionConstIterator<TInputImage> iter(itkImage, itkImage->GetLargestPossibleRegion());
+    for (std::size_t row = 0; row < numberOfRows; ++row)
+    {
+      double *prefix = &m_RowPrefixSums[row * (rowLength + 1)];
+      for (std::size_t x = 0; x < rowLength; ++x)
+      {
+        prefix[x + 1] = prefix[x] + iter.Get();
+        ++iter;
+      }
+    }
   }
 
   template< typename TInputImage >
@@ -227,63 +245,92 @@ namespace itk
       regionSize[i] = offset;
     }
 
+    // The spherical neighbourhood is split into segments along dimension 0. For
+    // every combination of the remaining offsets the in-range voxels of a row
+    // form one interval, whose sum is taken from the row prefix sums. The cost
+    // per voxel grows with the cross section of the sphere instead of its volume.
     itk::ConstNeighborhoodIterator<TInputImage> iter(regionSize, itkImage, outputRegionForThread);
-    itk::ConstNeighborhoodIterator<MaskImageType> iterMask(regionSize, itkMask, outputRegionForThread);
 
     typename TInputImage::PointType origin;
     typename TInputImage::PointType localPoint;
     itk::Index<TInputImage::ImageDimension> index;
 
-    double tmpPeakValue;
-    double globalPeakValue = std::numeric_limits<double>::lowest();
-    double localPeakValue = std::numeric_limits<double>::lowest();
-    PixelType localMaximum = std::numeric_limits<PixelType>::lowest();
+    struct RowSegment
+    {
+      itk::Offset<TInputImage::ImageDimension> offset;
+      long first;
+      long last;
+    };
+    std::vector<RowSegment> segments;
 
-    std::vector<bool> vectorIsInRange;
     index = iter.GetIndex();
     itkImage->TransformIndexToPhysicalPoint(index, origin);
     for (itk::SizeValueType i = 0; i < iter.Size(); ++i)
     {
       itkImage->TransformIndexToPhysicalPoint(iter.GetIndex(i), localPoint);
       double dist = origin.EuclideanDistanceTo(localPoint);
-      vectorIsInRange.push_back((dist < range));
+      if (!(dist < range))
+        continue;
+
+      auto neighbourOffset = iter.GetOffset(i);
+      long dx = neighbourOffset[0];
+      neighbourOffset[0] = 0;
+      auto segment = std::find_if(segments.begin(), segments.end(),
+        [&neighbourOffset](const RowSegment &s) { return s.offset == neighbourOffset; });
+      if (segment == segments.end())
+      {
+        segments.push_back({ neighbourOffset, dx, dx });
+      }
+      else
+      {
+        segment->first = std::min(segment->first, dx);
+        segment->last = std::max(segment->last, dx);
+      }
     }
 
-    int count = 0;
-
-    iter.NeedToUseBoundaryConditionOff();
-    iterMask.NeedToUseBoundaryConditionOff();
+    double tmpPeakValue;
+    double globalPeakValue = std::numeric_limits<double>::lowest();
+    double localPeakValue = std::numeric_limits<double>::lowest();
+    PixelType localMaximum = std::numeric_limits<PixelType>::lowest();
 
     auto imageSize = itkImage->GetLargestPossibleRegion().GetSize();
     unsigned int imageDimension = itkImage->GetImageDimension();
+    const long rowLength = imageSize[0];
+
+    itk::ImageRegionConstIteratorWithIndex<TInputImage> imageIter(itkImage, outputRegionForThread);
+    itk::ImageRegionConstIterator<MaskImageType> maskIter(itkMask, outputRegionForThread);
 
-    while (!iter.IsAtEnd())
+    while (!imageIter.IsAtEnd())
     {
-      if (iterMask.GetCenterPixel() > 0)
+      if (maskIter.Get() > 0)
       {
+        index = imageIter.GetIndex();
         tmpPeakValue = 0;
-        count = 0;
-        for (itk::SizeValueType i = 0; i < iter.Size(); ++i)
+        long count = 0;
+        for (const auto &segment : segments)
         {
-          if (vectorIsInRange[i])
+          std::size_t row = 0;
+          std::size_t rowStride = 1;
+          bool rowInside = true;
+          for (unsigned int dimension = 1; dimension < imageDimension; ++dimension)
           {
-            auto localIndex = iter.GetIndex(i);
-            bool calculatePoint = true;
-            for (unsigned int dimension = 0; dimension < imageDimension; ++dimension)
-            {
-              calculatePoint &= (localIndex[dimension] < static_cast<signed int>(imageSize[dimension]));
-              calculatePoint &= (0 <= localIndex[dimension]);
-            }
-            if (calculatePoint)
-            {
-              tmpPeakValue += iter.GetPixel(i);
-              ++count;
-            }
+            long position = index[dimension] + segment.offset[dimension];
+            rowInside &= (0 <= position) && (position < static_cast<long>(imageSize[dimension]));
+            row += position * rowStride;
+            rowStride *= imageSize[dimension];
           }
+          long first = std::max<long>(0, index[0] + segment.first);
+          long last = std::min<long>(rowLength - 1, index[0] + segment.last);
+          if (!rowInside || first > last)
+            continue;
+
+          const double *prefix = &m_RowPrefixSums[row * (rowLength + 1)];
+          tmpPeakValue += prefix[last + 1] - prefix[first];
+          count += last - first + 1;
         }
         tmpPeakValue /= count;
         globalPeakValue = std::max<double>(tmpPeakValue, globalPeakValue);
-        auto currentCenterPixelValue = iter.GetCenterPixel();
+        auto currentCenterPixelValue = imageIter.Get();
         if (localMaximum == currentCenterPixelValue)
         {
           localPeakValue = std::max<double>(tmpPeakValue, localPeakValue);
@@ -294,8 +341,8 @@ namespace itk
           localPeakValue = tmpPeakValue;
         }
       }
-      ++iterMask;
-      ++iter;
+      ++maskIter;
+      ++imageIter;
     }
 
     m_ThreadLocalMaximum[threadId] = localMaximum;
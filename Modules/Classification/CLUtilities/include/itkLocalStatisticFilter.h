@@ -15,6 +15,7 @@ namespace itk
       typedef typename TInputImageType::ConstPointer                       InputImagePointer;
       typedef typename TOuputImageType::Pointer                       OutputImagePointer;
       typedef typename TOuputImageType::RegionType                    OutputImageRegionType;
+      typedef itk::Image<unsigned short, TInputImageType::ImageDimension> MaskImageType;
 
       itkNewMacro (Self);
       itkTypeMacro(LocalStatisticFilter, ImageToImageFilter);
@@ -22,12 +23,21 @@ namespace itk
       itkSetMacro(Size, int);
       itkGetConstMacro(Size, int);
 
+      /** Optional mask. If set, only voxels with a mask value greater than zero
+      contribute to the statistics of a window. */
+      void SetMask(typename MaskImageType::Pointer mask)
+      {
+        m_Mask = mask;
+        this->Modified();
+      }
+
     protected:
       LocalStatisticFilter();
       ~LocalStatisticFilter(){};
 
       virtual void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId);
       virtual void BeforeThreadedGenerateData(void);
+      virtual void GenerateInputRequestedRegion() override;
 
 
       using itk::ProcessObject::MakeOutput;
@@ -41,6 +51,7 @@ namespace itk
 
       int m_Size;
       int m_Bins;
+      typename MaskImageType::Pointer m_Mask;
   };
 }
 
@@ -3,12 +3,78 @@
 
 #include <itkLocalStatisticFilter.h>
 
-#include <itkNeighborhoodIterator.h>
 #include <itkImageRegionIterator.h>
-#include <itkImageIterator.h>
-#include "itkMinimumMaximumImageCalculator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <limits>
+#include <vector>
+
+namespace itk
+{
+  namespace LocalStatisticFilterHelper
+  {
+    // Window sum of length 2*radius+1 along a line using prefix sums.
+    inline void BoxSum(const std::vector<double> &line, int radius, std::vector<double> &result)
+    {
+      std::vector<double> prefix(line.size() + 1, 0);
+      for (std::size_t i = 0; i < line.size(); ++i)
+        prefix[i + 1] = prefix[i] + line[i];
+      for (std::size_t k = 0; k < result.size(); ++k)
+        result[k] = prefix[k + 2 * radius + 1] - prefix[k];
+    }
+
+    // Running window minimum / maximum after van Herk and Gil-Werman. The line is split
+    // into blocks of the window width; each window is covered by the suffix of one block
+    // and the prefix of the next, which gives three comparisons per voxel for any width.
+    template <typename TCompare>
+    void RunningExtremum(const std::vector<double> &line, int radius, std::vector<double> &result, TCompare compare)
+    {
+      const std::size_t width = 2 * radius + 1;
+      const std::size_t n = line.size();
+      std::vector<double> prefix(n), suffix(n);
+      for (std::size_t i = 0; i < n; ++i)
+        prefix[i] = (i % width == 0) ? line[i] : std::min(prefix[i - 1], line[i], compare);
+      for (std::size_t i = n; i-- > 0;)
+        suffix[i] = (i == n - 1 || (i + 1) % width == 0) ? line[i] : std::min(suffix[i + 1], line[i], compare);
+      for (std::size_t k = 0; k < result.size(); ++k)
+        result[k] = std::min(suffix[k], prefix[k + width - 1], compare);
+    }
+
+    // Applies a line operation along one dimension of a dense block with dimension 0
+    // running fastest. The extent of that dimension shrinks by 2*radius.
+    template <typename TOperation>
+    void WindowPass(std::vector<double> &data, std::vector<std::size_t> &extent, unsigned int dimension, int radius, TOperation operation)
+    {
+      std::size_t stride = 1;
+      for (unsigned int d = 0; d < dimension; ++d)
+        stride *= extent[d];
+      const std::size_t inLength = extent[dimension];
+      const std::size_t outLength = inLength - 2 * radius;
+      const std::size_t outer = data.size() / (stride * inLength);
+
+      std::vector<double> result(outer * stride * outLength);
+      std::vector<double> line(inLength);
+      std::vector<double> lineResult(outLength);
+      for (std::size_t o = 0; o < outer; ++o)
+      {
+        for (std::size_t inner = 0; inner < stride; ++inner)
+        {
+          const std::size_t inStart = o * stride * inLength + inner;
+          for (std::size_t t = 0; t < inLength; ++t)
+            line[t] = data[inStart + t * stride];
+          operation(line, radius, lineResult);
+          const std::size_t outStart = o * stride * outLength + inner;
+          for (std::size_t t = 0; t < outLength; ++t)
+            result[outStart + t * stride] = lineResult[t];
+        }
+      }
+      data.swap(result);
+      extent[dimension] = outLength;
+    }
+  }
+}
 
 template< class TInputImageType, class TOuputImageType>
 itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::LocalStatisticFilter():
@@ -34,22 +100,90 @@ itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::BeforeThreadedGener
   }
 }
 
+template< class TInputImageType, class TOuputImageType>
+void
+itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  if (this->GetInput())
+  {
+    typename TInputImageType::Pointer input = const_cast<TInputImageType *>(this->GetInput());
+    input->SetRequestedRegionToLargestPossibleRegion();
+  }
+}
+
 template< class TInputImageType, class TOuputImageType>
 void
 itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType /*threadId*/)
 {
-  typedef itk::ImageRegionIterator<TInputImageType> IteratorType;
-  typedef itk::ConstNeighborhoodIterator<TInputImageType> ConstIteratorType;
+  typedef itk::ImageRegionIterator<TOuputImageType> IteratorType;
+  const unsigned int dimension = TInputImageType::ImageDimension;
 
-  typename TInputImageType::SizeType size; size.Fill(m_Size);
   InputImagePointer input = this->GetInput(0);
+  auto largestRegion = input->GetLargestPossibleRegion();
+
+  // The window has the radius m_Size in each direction, except the third
+  // direction of 3D images (2.5D). Voxels outside the image are replaced by
+  // the nearest voxel inside the image (zero flux Neumann boundary).
+  std::vector<int> radius(dimension);
+  std::vector<std::size_t> extent(dimension);
+  std::size_t numberOfVoxels = 1;
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    radius[d] = (dimension == 3 && d == 2) ? 0 : m_Size;
+    extent[d] = outputRegionForThread.GetSize(d) + 2 * radius[d];
+    numberOfVoxels *= extent[d];
+  }
+
+  // Gather the padded block of the thread region. Statistics are then computed
+  // with separable passes, so that the cost per voxel does not depend on m_Size.
+  std::vector<double> sum(numberOfVoxels);
+  std::vector<double> sumOfSquares(numberOfVoxels);
+  std::vector<double> count(numberOfVoxels);
+  std::vector<double> minimum(numberOfVoxels);
+  std::vector<double> maximum(numberOfVoxels);
+
+  typename TInputImageType::IndexType index;
+  for (std::size_t i = 0; i < numberOfVoxels; ++i)
+  {
+    std::size_t remainder = i;
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      long position = outputRegionForThread.GetIndex(d) - radius[d] + static_cast<long>(remainder % extent[d]);
+      long lower = largestRegion.GetIndex(d);
+      long upper = lower + static_cast<long>(largestRegion.GetSize(d)) - 1;
+      index[d] = std::max(lower, std::min(upper, position));
+      remainder /= extent[d];
+    }
+
+    double value = input->GetPixel(index);
+    bool inside = m_Mask.IsNull() || m_Mask->GetPixel(index) > 0;
+    sum[i] = inside ? value : 0;
+    sumOfSquares[i] = inside ? value * value : 0;
+    count[i] = inside ? 1 : 0;
+    minimum[i] = inside ? value : std::numeric_limits<double>::max();
+    maximum[i] = inside ? value : std::numeric_limits<double>::lowest();
+  }
 
-  if (TInputImageType::ImageDimension == 3)
+  for (unsigned int d = 0; d < dimension; ++d)
   {
-    size[2] = 0;
+    if (radius[d] == 0)
+      continue;
+    std::vector<std::size_t> passExtent = extent;
+    LocalStatisticFilterHelper::WindowPass(sum, passExtent, d, radius[d], LocalStatisticFilterHelper::BoxSum);
+    passExtent = extent;
+    LocalStatisticFilterHelper::WindowPass(sumOfSquares, passExtent, d, radius[d], LocalStatisticFilterHelper::BoxSum);
+    passExtent = extent;
+    LocalStatisticFilterHelper::WindowPass(count, passExtent, d, radius[d], LocalStatisticFilterHelper::BoxSum);
+    passExtent = extent;
+    LocalStatisticFilterHelper::WindowPass(minimum, passExtent, d, radius[d],
+      [](const std::vector<double> &line, int r, std::vector<double> &result) { LocalStatisticFilterHelper::RunningExtremum(line, r, result, std::less<double>()); });
+    passExtent = extent;
+    LocalStatisticFilterHelper::WindowPass(maximum, passExtent, d, radius[d],
+      [](const std::vector<double> &line, int r, std::vector<double> &result) { LocalStatisticFilterHelper::RunningExtremum(line, r, result, std::greater<double>()); });
+    extent = passExtent;
   }
 
-//  MITK_INFO << "Creating output iterator";
   std::vector<IteratorType> iterVector;
   for (int i = 0; i < m_Bins; ++i)
   {
@@ -57,39 +191,32 @@ itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::ThreadedGenerateDat
     iterVector.push_back(iter);
   }
 
-  ConstIteratorType inputIter(size, input, outputRegionForThread);
-  while (!inputIter.IsAtEnd())
+  // The block is now the size of the thread region and has the same order as
+  // the region iterator.
+  for (std::size_t i = 0; i < sum.size(); ++i)
   {
-    for (int i = 0; i < m_Bins; ++i)
-    {
-      iterVector[i].Set(0);
-    }
-
-    double min = std::numeric_limits<double>::max();
-    double max = std::numeric_limits<double>::lowest();
+    double windowMinimum = 0;
+    double windowMaximum = 0;
     double mean = 0;
-    double std = 0;
-
-    for (unsigned int i = 0; i < inputIter.Size(); ++i)
+    double standardDeviation = 0;
+    if (count[i] > 0)
     {
-      double value = inputIter.GetPixel(i);
-      min = std::min<double>(min, value);
-      max = std::max<double>(max, value);
-      mean += value / inputIter.Size();
-      std += (value*value) / inputIter.Size();
+      windowMinimum = minimum[i];
+      windowMaximum = maximum[i];
+      mean = sum[i] / count[i];
+      standardDeviation = std::sqrt(std::max(0.0, sumOfSquares[i] / count[i] - mean*mean));
     }
 
-    iterVector[0].Value() = min;
-    iterVector[1].Value() = max;
+    iterVector[0].Value() = windowMinimum;
+    iterVector[1].Value() = windowMaximum;
     iterVector[2].Value() = mean;
-    iterVector[3].Value() = std::sqrt(std - mean*mean);
-    iterVector[4].Value() = max-min;
+    iterVector[3].Value() = standardDeviation;
+    iterVector[4].Value() = windowMaximum - windowMinimum;
 
-    for (int i = 0; i < m_Bins; ++i)
+    for (int j = 0; j < m_Bins; ++j)
     {
-      ++(iterVector[i]);
+      ++(iterVector[j]);
     }
-    ++inputIter;
   }
 }
 
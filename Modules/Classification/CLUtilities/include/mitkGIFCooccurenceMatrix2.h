@@ -143,6 +143,16 @@ namespace mitk
       itkGetConstMacro(Range,double);
       itkSetMacro(Range, double);
 
+      /**
+      * \brief Co-occurence matrices of a quantized region, one symmetric count matrix per offset.
+      *
+      * The offsets are given as linear offsets of the region buffer (see QuantizedRegion::LinearOffset),
+      * the region has to be padded by at least the largest offset. All matrices are built in a single
+      * pass over the masked voxels.
+      */
+      static std::vector<Eigen::MatrixXd> CalculateCoOcMatrices(const GlobalImageFeatureContext::QuantizedRegion &region,
+                                                                const std::vector<std::ptrdiff_t> &linearOffsets);
+
     struct GIFCooccurenceMatrix2Configuration
     {
       double range;
@@ -102,6 +102,17 @@ namespace mitk
 
     virtual std::string GetCurrentFeatureEncoding() override;
 
+    /**
+    * \brief Run-length matrices of a quantized region, one matrix per offset.
+    *
+    * The rows of each matrix are the bins, the columns the run lengths starting with 1. The offsets are
+    * given as linear offsets of the region buffer (see QuantizedRegion::LinearOffset) and must not be
+    * longer than one voxel in any dimension, the region has to be padded by at least one voxel. All
+    * matrices are built in a single pass over the masked voxels.
+    */
+    static std::vector<Eigen::MatrixXd> CalculateRunLengthMatrices(const GlobalImageFeatureContext::QuantizedRegion &region,
+                                                                   const std::vector<std::ptrdiff_t> &linearOffsets);
+
     struct ParameterStruct
     {
       unsigned int m_Direction;
@@ -7,7 +7,6 @@
 
 // ITK
 #include <itkEnhancedScalarImageToTextureFeaturesFilter.h>
-#include <itkShapedNeighborhoodIterator.h>
 #include <itkImageRegionConstIterator.h>
 
 // STL
@@ -151,54 +150,51 @@ double mitk::CoocurenceMatrixHolder::IndexToMaxIntensity(int index)
   return m_MinimumRange + (index + 1) * m_Stepsize;
 }
 
-template<typename TPixel, unsigned int VImageDimension>
-void
-CalculateCoOcMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
-                    itk::Image<unsigned short, VImageDimension>* mask,
-                    itk::Offset<VImageDimension> offset,
-                    int range,
-                    mitk::CoocurenceMatrixHolder &holder)
+std::vector<Eigen::MatrixXd>
+mitk::GIFCooccurenceMatrix2::CalculateCoOcMatrices(const GlobalImageFeatureContext::QuantizedRegion &region,
+                                                   const std::vector<std::ptrdiff_t> &linearOffsets)
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typedef itk::Image<unsigned short, VImageDimension> MaskImageType;
-  typedef itk::ShapedNeighborhoodIterator<ImageType> ShapeIterType;
-  typedef itk::ShapedNeighborhoodIterator<MaskImageType> ShapeMaskIterType;
-  typedef itk::ImageRegionConstIterator<ImageType> ConstIterType;
-  typedef itk::ImageRegionConstIterator<MaskImageType> ConstMaskIterType;
-
-
-  itk::Size<VImageDimension> radius;
-  radius.Fill(range+1);
-  ShapeIterType imageOffsetIter(radius, itkImage, itkImage->GetLargestPossibleRegion());
-  ShapeMaskIterType maskOffsetIter(radius, mask, mask->GetLargestPossibleRegion());
-  imageOffsetIter.ActivateOffset(offset);
-  maskOffsetIter.ActivateOffset(offset);
-  ConstIterType imageIter(itkImage, itkImage->GetLargestPossibleRegion());
-  ConstMaskIterType maskIter(mask, mask->GetLargestPossibleRegion());
-  //  iterator.GetIndex() + ci.GetNeighborhoodOffset()
-  auto region = mask->GetLargestPossibleRegion();
-
-
-  while (!maskIter.IsAtEnd())
+  const int numberOfBins = region.NumberOfBins;
+  const int numberOfOffsets = linearOffsets.size();
+  std::vector<Eigen::MatrixXd> matrices(numberOfOffsets, Eigen::MatrixXd::Zero(numberOfBins, numberOfBins));
+  if (linearOffsets.empty())
+    return matrices;
+
+  // The quantized region is padded by the largest offset, so that neighbours can be
+  // addressed by a constant linear offset without bounds checks. Voxels outside the
+  // mask, NaN voxels and the padding have a negative bin.
+  // Every thread accumulates private matrices for all offsets which are merged
+  // at the end. The matrices hold counts, so the result does not depend on the
+  // order of the merge.
+  const int *bins = region.Bins.data();
+  const int numberOfVoxels = region.Voxels.size();
+#pragma omp parallel
   {
-    auto ciMask = maskOffsetIter.Begin();
-    auto ciValue = imageOffsetIter.Begin();
-    if (maskIter.Value() > 0 &&
-      ciMask.Get() > 0 &&
-      imageIter.Get() == imageIter.Get() &&
-      ciValue.Get() == ciValue.Get() &&
-      region.IsInside(maskOffsetIter.GetIndex() + ciMask.GetNeighborhoodOffset()))
+    std::vector<Eigen::MatrixXd> localMatrices(numberOfOffsets, Eigen::MatrixXd::Zero(numberOfBins, numberOfBins));
+
+#pragma omp for
+    for (int v = 0; v < numberOfVoxels; ++v)
     {
-      int i = holder.IntensityToIndex(imageIter.Get());
-      int j = holder.IntensityToIndex(ciValue.Get());
-      holder.m_Matrix(i, j) += 1;
-      holder.m_Matrix(j, i) += 1;
+      const std::ptrdiff_t position = region.Voxels[v];
+      const int i = bins[position];
+      for (int k = 0; k < numberOfOffsets; ++k)
+      {
+        const int j = bins[position + linearOffsets[k]];
+        if (j >= 0)
+        {
+          localMatrices[k](i, j) += 1;
+          localMatrices[k](j, i) += 1;
+        }
+      }
+    }
+
+#pragma omp critical (CoocurenceMatrixMerge)
+    for (int k = 0; k < numberOfOffsets; ++k)
+    {
+      matrices[k] += localMatrices[k];
     }
-    ++imageOffsetIter;
-    ++maskOffsetIter;
-    ++imageIter;
-    ++maskIter;
   }
+  return matrices;
 }
 
 void CalculateFeatures(
@@ -363,9 +359,8 @@ void CalculateFeatures(
 
 template<typename TPixel, unsigned int VImageDimension>
 void
-CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, mitk::GIFCooccurenceMatrix2::FeatureListType & featureList, mitk::GIFCooccurenceMatrix2::GIFCooccurenceMatrix2Configuration config)
+CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* /*itkImage*/, mitk::GlobalImageFeatureContext::QuantizedRegion::ConstPointer region, mitk::GIFCooccurenceMatrix2::FeatureListType & featureList, mitk::GIFCooccurenceMatrix2::GIFCooccurenceMatrix2Configuration config)
 {
-  typedef itk::Image<unsigned short, VImageDimension> MaskType;
   typedef itk::Neighborhood<TPixel, VImageDimension > NeighborhoodType;
   typedef itk::Offset<VImageDimension> OffsetType;
 
@@ -374,9 +369,6 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
   double rangeMax = config.MaximumIntensity;
   int numberOfBins = config.Bins;
 
-  typename MaskType::Pointer maskImage = MaskType::New();
-  mitk::CastToItkImage(mask, maskImage);
-
   //Find possible directions
   std::vector < itk::Offset<VImageDimension> > offsetVector;
   NeighborhoodType hood;
@@ -408,9 +400,7 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
     offset[2] = 1;
   }
 
-  std::vector<mitk::CoocurenceMatrixFeatures> resultVector;
-  mitk::CoocurenceMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins);
-  mitk::CoocurenceMatrixFeatures overallFeature;
+  std::vector < itk::Offset<VImageDimension> > usedOffsets;
   for (std::size_t i = 0; i < offsetVector.size(); ++i)
   {
     if (config.direction > 1)
@@ -420,12 +410,28 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
         continue;
       }
     }
+    usedOffsets.push_back(offsetVector[i]);
+  }
 
+  std::vector<std::ptrdiff_t> linearOffsets;
+  for (auto usedOffset : usedOffsets)
+  {
+    linearOffsets.push_back(region->LinearOffset(usedOffset));
+  }
 
-    offset = offsetVector[i];
-    mitk::CoocurenceMatrixHolder holder(rangeMin, rangeMax, numberOfBins);
+  auto matrices = mitk::GIFCooccurenceMatrix2::CalculateCoOcMatrices(*region, linearOffsets);
+  std::vector<mitk::CoocurenceMatrixHolder> holders(usedOffsets.size(), mitk::CoocurenceMatrixHolder(rangeMin, rangeMax, numberOfBins));
+  for (std::size_t i = 0; i < holders.size(); ++i)
+  {
+    holders[i].m_Matrix = matrices[i];
+  }
+
+  std::vector<mitk::CoocurenceMatrixFeatures> resultVector;
+  mitk::CoocurenceMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins);
+  mitk::CoocurenceMatrixFeatures overallFeature;
+  for (auto &holder : holders)
+  {
     mitk::CoocurenceMatrixFeatures coocResults;
-    CalculateCoOcMatrix<TPixel, VImageDimension>(itkImage, maskImage, offset, config.range, holder);
     holderOverall.m_Matrix += holder.m_Matrix;
     CalculateFeatures(holder, coocResults);
     resultVector.push_back(coocResults);
@@ -629,7 +635,9 @@ mitk::GIFCooccurenceMatrix2::FeatureListType mitk::GIFCooccurenceMatrix2::Calcul
   config.Bins = GetQuantifier()->GetBins();
   config.prefix = FeatureDescriptionPrefix();
 
-  AccessByItk_3(image, CalculateCoocurenceFeatures, mask, featureList,config);
+  // the offsets are the neighbourhood offsets scaled by the range
+  auto region = GetQuantizedRegion(image, mask, static_cast<unsigned int>(std::abs(m_Range)));
+  AccessByItk_3(image, CalculateCoocurenceFeatures, region, featureList,config);
 
   return featureList;
 }
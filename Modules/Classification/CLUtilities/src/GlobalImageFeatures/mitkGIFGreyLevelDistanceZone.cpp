@@ -54,92 +54,74 @@ int mitk::GreyLevelDistanceZoneMatrixHolder::IntensityToIndex(double intensity)
 }
 
 
-template<typename TPixel, unsigned int VImageDimension>
+template<unsigned int VImageDimension>
 int
-CalculateGlSZMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
-                    itk::Image<unsigned short, VImageDimension>* mask,
+CalculateGlSZMatrix(const mitk::GlobalImageFeatureContext::QuantizedRegion &region,
                     itk::Image<unsigned short, VImageDimension>* distanceImage,
-                    std::vector<itk::Offset<VImageDimension> > offsets,
+                    const std::vector<itk::Offset<VImageDimension> > &offsets,
                     bool estimateLargestRegion,
                     mitk::GreyLevelDistanceZoneMatrixHolder &holder)
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typedef itk::Image<unsigned short, VImageDimension> MaskImageType;
-  typedef typename ImageType::IndexType IndexType;
-
-  typedef itk::ImageRegionIteratorWithIndex<ImageType> ConstIterType;
-  typedef itk::ImageRegionIteratorWithIndex<MaskImageType> ConstMaskIterType;
-
-  auto region = mask->GetLargestPossibleRegion();
-  typename MaskImageType::RegionType newRegion;
-  newRegion.SetSize(region.GetSize());
-  newRegion.SetIndex(region.GetIndex());
+  // The quantized region is padded by one voxel, so the zones can grow by linear offsets.
+  // The padding, voxels outside the mask and NaN voxels have a negative bin and never
+  // match the bin of a zone.
+  std::vector<std::ptrdiff_t> linearOffsets;
+  for (auto offset : offsets)
+  {
+    linearOffsets.push_back(region.LinearOffset(offset));
+  }
 
-  ConstIterType imageIter(itkImage, itkImage->GetLargestPossibleRegion());
-  ConstMaskIterType maskIter(mask, mask->GetLargestPossibleRegion());
+  // The distance image has the geometry of the image, its buffer is not padded
+  const unsigned short *distances = distanceImage->GetBufferPointer();
+  auto DistanceAt = [&region, distances](std::ptrdiff_t position)
+  {
+    int index[3];
+    region.Index(position, index);
+    return distances[index[0] + region.Size[0] * (index[1] + static_cast<std::ptrdiff_t>(region.Size[1]) * index[2])];
+  };
 
-  typename MaskImageType::Pointer visitedImage = MaskImageType::New();
-  visitedImage->SetRegions(newRegion);
-  visitedImage->Allocate();
-  visitedImage->FillBuffer(0);
+  const int *bins = region.Bins.data();
+  std::vector<char> visited(region.Bins.size(), 0);
+  std::vector<std::ptrdiff_t> positions;
 
   int largestRegion = 0;
   holder.m_NumberOfBins = 0;
 
-  while (!maskIter.IsAtEnd())
+  for (auto startPosition : region.Voxels)
   {
-    if (maskIter.Value() > 0 )
+    auto startIntensityIndex = bins[startPosition];
+    positions.push_back(startPosition);
+    unsigned int steps = 0;
+    int smallestDistance = 500;
+
+    while (positions.size() > 0)
     {
-      auto startIntensityIndex = holder.IntensityToIndex(imageIter.Value());
-      std::vector<IndexType> indices;
-      indices.push_back(maskIter.GetIndex());
-      unsigned int steps = 0;
-      int smallestDistance = 500;
+      auto currentPosition = positions.back();
+      positions.pop_back();
 
-      while (indices.size() > 0)
+      if ((bins[currentPosition] == startIntensityIndex) &&
+          (visited[currentPosition] < 1))
       {
-        auto currentIndex = indices.back();
-        indices.pop_back();
-
-        if (!region.IsInside(currentIndex))
+        ++(holder.m_NumerOfVoxels);
+        smallestDistance = std::min<int>(smallestDistance, DistanceAt(currentPosition));
+        ++steps;
+        visited[currentPosition] = 1;
+        for (auto linearOffset : linearOffsets)
         {
-          continue;
-        }
-
-        auto wasVisited = visitedImage->GetPixel(currentIndex);
-        auto newIntensityIndex = holder.IntensityToIndex(itkImage->GetPixel(currentIndex));
-        auto isInMask = mask->GetPixel(currentIndex);
-
-        if ((isInMask > 0) &&
-            (newIntensityIndex == startIntensityIndex) &&
-            (wasVisited < 1))
-        {
-          ++(holder.m_NumerOfVoxels);
-          smallestDistance = (smallestDistance > distanceImage->GetPixel(currentIndex)) ? distanceImage->GetPixel(currentIndex) : smallestDistance;
-          ++steps;
-          visitedImage->SetPixel(currentIndex, 1);
-          for (auto offset : offsets)
-          {
-            auto newIndex = currentIndex + offset;
-            indices.push_back(newIndex);
-            newIndex = currentIndex - offset;
-            indices.push_back(newIndex);
-          }
-
+          positions.push_back(currentPosition + linearOffset);
+          positions.push_back(currentPosition - linearOffset);
         }
       }
-      if (steps > 0)
+    }
+    if (steps > 0)
+    {
+      largestRegion = std::max<int>(steps, largestRegion);
+      steps = std::min<unsigned int>(steps, holder.m_MaximumSize);
+      if (!estimateLargestRegion)
       {
-        largestRegion = std::max<int>(steps, largestRegion);
-        steps = std::min<unsigned int>(steps, holder.m_MaximumSize);
-        if (!estimateLargestRegion)
-        {
-          holder.m_Matrix(startIntensityIndex, smallestDistance-1) += 1;
-        }
+        holder.m_Matrix(startIntensityIndex, smallestDistance-1) += 1;
       }
     }
-    ++imageIter;
-    ++maskIter;
   }
   return largestRegion;
 }
@@ -309,7 +291,7 @@ void static CalculateFeatures(
 
 template<typename TPixel, unsigned int VImageDimension>
 static void
-CalculateGreyLevelDistanceZoneFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, mitk::GIFGreyLevelDistanceZone::FeatureListType & featureList, mitk::GIFGreyLevelDistanceZone::GIFGreyLevelDistanceZoneConfiguration config)
+CalculateGreyLevelDistanceZoneFeatures(itk::Image<TPixel, VImageDimension>* /*itkImage*/, mitk::GlobalImageFeatureContext::QuantizedRegion::ConstPointer region, mitk::GIFGreyLevelDistanceZone::FeatureListType & featureList, mitk::GIFGreyLevelDistanceZone::GIFGreyLevelDistanceZoneConfiguration config)
 {
   typedef itk::Image<unsigned short, VImageDimension> MaskType;
   typedef itk::Neighborhood<TPixel, VImageDimension > NeighborhoodType;
@@ -322,9 +304,6 @@ CalculateGreyLevelDistanceZoneFeatures(itk::Image<TPixel, VImageDimension>* itkI
   typename MaskType::Pointer distanceImage = MaskType::New();
   mitk::CastToItkImage(mitkDistanceImage, distanceImage);
 
-  typename MaskType::Pointer maskImage = MaskType::New();
-  mitk::CastToItkImage(mask, maskImage);
-
   //Find possible directions
   std::vector < itk::Offset<VImageDimension> > offsetVector;
   NeighborhoodType hood;
@@ -360,7 +339,7 @@ CalculateGreyLevelDistanceZoneFeatures(itk::Image<TPixel, VImageDimension>* itkI
   std::vector<mitk::GreyLevelDistanceZoneFeatures> resultVector;
   mitk::GreyLevelDistanceZoneMatrixHolder holderOverall(config.Quantifier, config.Bins, maximumDistance + 1);
   mitk::GreyLevelDistanceZoneFeatures overallFeature;
-  CalculateGlSZMatrix<TPixel, VImageDimension>(itkImage, maskImage, distanceImage, offsetVector, false, holderOverall);
+  CalculateGlSZMatrix<VImageDimension>(*region, distanceImage, offsetVector, false, holderOverall);
   CalculateFeatures(holderOverall, overallFeature);
 
   MatrixFeaturesTo(overallFeature, config.prefix, featureList);
@@ -423,7 +402,8 @@ mitk::GIFGreyLevelDistanceZone::FeatureListType mitk::GIFGreyLevelDistanceZone::
   config.prefix = FeatureDescriptionPrefix();
   config.Quantifier = GetQuantifier();
 
-  AccessByItk_3(image, CalculateGreyLevelDistanceZoneFeatures, mask, featureList, config);
+  auto region = GetQuantizedRegion(image, mask, 1);
+  AccessByItk_3(image, CalculateGreyLevelDistanceZoneFeatures, region, featureList, config);
 
   return featureList;
 }
@@ -22,38 +22,131 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImageAccessByItk.h>
 
 // ITK
-#include <itkEnhancedScalarImageToRunLengthFeaturesFilter.h>
+#include <itkNeighborhood.h>
 
 // STL
 #include <sstream>
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+  // Same order as the features of itk::Statistics::EnhancedHistogramToRunLengthFeaturesFilter
+  enum RunLengthFeature
+  {
+    ShortRunEmphasis,
+    LongRunEmphasis,
+    GreyLevelNonuniformity,
+    GreyLevelNonuniformityNormalized,
+    RunLengthNonuniformity,
+    RunLengthNonuniformityNormalized,
+    LowGreyLevelRunEmphasis,
+    HighGreyLevelRunEmphasis,
+    ShortRunLowGreyLevelEmphasis,
+    ShortRunHighGreyLevelEmphasis,
+    LongRunLowGreyLevelEmphasis,
+    LongRunHighGreyLevelEmphasis,
+    RunPercentage,
+    NumberOfRuns,
+    GreyLevelVariance,
+    RunLengthVariance,
+    RunEntropy,
+    NumberOfRunLengthFeatures
+  };
+}
+
+static void
+CalculateMatrixFeatures(const Eigen::MatrixXd &matrix, double numberOfVoxels, std::vector<double> &features)
+{
+  features.assign(NumberOfRunLengthFeatures, 0.0);
+
+  const double totalNumberOfRuns = matrix.sum();
+  if (totalNumberOfRuns <= 0)
+    return;
+
+  double mu_i = 0.0;
+  double mu_j = 0.0;
+  for (int l = 0; l < matrix.cols(); ++l)
+  {
+    for (int x = 0; x < matrix.rows(); ++x)
+    {
+      const double frequency = matrix(x, l);
+      if (frequency == 0)
+        continue;
+      const double p_ij = frequency / totalNumberOfRuns;
+      mu_i += (x + 1) * p_ij;
+      mu_j += (l + 1) * p_ij;
+    }
+  }
+
+  const double log2 = std::log(2.0);
+  for (int l = 0; l < matrix.cols(); ++l)
+  {
+    for (int x = 0; x < matrix.rows(); ++x)
+    {
+      const double frequency = matrix(x, l);
+      if (frequency == 0)
+        continue;
+
+      const double i = x + 1;
+      const double j = l + 1;
+      const double i2 = i*i;
+      const double j2 = j*j;
+      const double p_ij = frequency / totalNumberOfRuns;
+
+      features[GreyLevelVariance] += (i - mu_i) * (i - mu_i) * p_ij;
+      features[RunLengthVariance] += (j - mu_j) * (j - mu_j) * p_ij;
+      features[RunEntropy] -= (p_ij > 0.0001) ? p_ij * std::log(p_ij) / log2 : 0;
+
+      features[ShortRunEmphasis] += frequency / j2;
+      features[LongRunEmphasis] += frequency * j2;
+      features[LowGreyLevelRunEmphasis] += frequency / i2;
+      features[HighGreyLevelRunEmphasis] += frequency * i2;
+      features[ShortRunLowGreyLevelEmphasis] += frequency / (i2 * j2);
+      features[ShortRunHighGreyLevelEmphasis] += frequency * i2 / j2;
+      features[LongRunLowGreyLevelEmphasis] += frequency * j2 / i2;
+      features[LongRunHighGreyLevelEmphasis] += frequency * i2 * j2;
+    }
+  }
+
+  features[GreyLevelNonuniformity] = matrix.rowwise().sum().squaredNorm();
+  features[RunLengthNonuniformity] = matrix.colwise().sum().squaredNorm();
+
+  // Normalize all measures by the total number of runs
+  for (int feature : { ShortRunEmphasis, LongRunEmphasis, GreyLevelNonuniformity, RunLengthNonuniformity,
+                       LowGreyLevelRunEmphasis, HighGreyLevelRunEmphasis, ShortRunLowGreyLevelEmphasis,
+                       ShortRunHighGreyLevelEmphasis, LongRunLowGreyLevelEmphasis, LongRunHighGreyLevelEmphasis })
+  {
+    features[feature] /= totalNumberOfRuns;
+  }
+  features[GreyLevelNonuniformityNormalized] = features[GreyLevelNonuniformity] / totalNumberOfRuns;
+  features[RunLengthNonuniformityNormalized] = features[RunLengthNonuniformity] / totalNumberOfRuns;
+  features[RunPercentage] = totalNumberOfRuns / numberOfVoxels;
+  features[NumberOfRuns] = totalNumberOfRuns;
+}
 
 template<typename TPixel, unsigned int VImageDimension>
 void
-  CalculateGrayLevelRunLengthFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, mitk::GIFGreyLevelRunLength::FeatureListType & featureList, mitk::GIFGreyLevelRunLength::ParameterStruct params)
+  CalculateGrayLevelRunLengthFeatures(itk::Image<TPixel, VImageDimension>* /*itkImage*/, mitk::GlobalImageFeatureContext::QuantizedRegion::ConstPointer region, mitk::GIFGreyLevelRunLength::FeatureListType & featureList, mitk::GIFGreyLevelRunLength::ParameterStruct params)
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typedef itk::Image<TPixel, VImageDimension> MaskType;
-  typedef itk::Statistics::EnhancedScalarImageToRunLengthFeaturesFilter<ImageType> FilterType;
-  typedef typename FilterType::RunLengthFeaturesFilterType TextureFilterType;
-
-  typename MaskType::Pointer maskImage = MaskType::New();
-  mitk::CastToItkImage(mask, maskImage);
+  typedef itk::Neighborhood<TPixel, VImageDimension> NeighborhoodType;
+  typedef itk::Offset<VImageDimension> OffsetType;
 
-  typename FilterType::Pointer filter = FilterType::New();
-  typename FilterType::Pointer filter2 = FilterType::New();
+  // Half of all directions one voxel away, the other half is included by symmetry.
+  NeighborhoodType hood;
+  hood.SetRadius(1);
+  unsigned int centerIndex = hood.GetCenterNeighborhoodIndex();
 
-  typename FilterType::OffsetVector::Pointer newOffset = FilterType::OffsetVector::New();
-  auto oldOffsets = filter->GetOffsets();
-  auto oldOffsetsIterator = oldOffsets->Begin();
-  while (oldOffsetsIterator != oldOffsets->End())
+  std::vector<OffsetType> offsets;
+  for (unsigned int d = 0; d < centerIndex; ++d)
   {
-    bool continueOuterLoop = false;
-    typename FilterType::OffsetType offset = oldOffsetsIterator->Value();
+    OffsetType offset = hood.GetOffset(d);
+    bool useOffset = true;
     for (unsigned int i = 0; i < VImageDimension; ++i)
     {
       if (params.m_Direction == i + 2 && offset[i] != 0)
       {
-        continueOuterLoop = true;
+        useOffset = false;
       }
     }
     if (params.m_Direction == 1)
@@ -61,157 +154,137 @@ void
       offset[0] = 0;
       offset[1] = 0;
       offset[2] = 1;
-      newOffset->push_back(offset);
+      offsets.assign(1, offset);
       break;
     }
+    if (useOffset)
+    {
+      offsets.push_back(offset);
+    }
+  }
+  if (offsets.empty())
+    return;
+
+  std::vector<std::ptrdiff_t> linearOffsets;
+  for (auto offset : offsets)
+  {
+    linearOffsets.push_back(region->LinearOffset(offset));
+  }
+
+  auto matrices = mitk::GIFGreyLevelRunLength::CalculateRunLengthMatrices(*region, linearOffsets);
 
-    oldOffsetsIterator++;
-    if (continueOuterLoop)
-      continue;
-    newOffset->push_back(offset);
+  // Features of every offset and of the sum of all matrices
+  const double numberOfVoxels = region->Voxels.size();
+  Eigen::MatrixXd combinedMatrix = Eigen::MatrixXd::Zero(region->NumberOfBins, region->NumberOfBins);
+  std::vector<std::vector<double> > offsetFeatures(matrices.size());
+  for (std::size_t k = 0; k < matrices.size(); ++k)
+  {
+    CalculateMatrixFeatures(matrices[k], numberOfVoxels, offsetFeatures[k]);
+    combinedMatrix += matrices[k];
+  }
+  std::vector<double> featureCombined;
+  CalculateMatrixFeatures(combinedMatrix, numberOfVoxels, featureCombined);
+
+  // Mean and population standard deviation of each feature across the offsets
+  std::vector<double> featureMeans(NumberOfRunLengthFeatures, 0.0);
+  std::vector<double> featureStd(NumberOfRunLengthFeatures, 0.0);
+  for (int i = 0; i < NumberOfRunLengthFeatures; ++i)
+  {
+    for (auto &features : offsetFeatures)
+      featureMeans[i] += features[i] / offsetFeatures.size();
+    for (auto &features : offsetFeatures)
+      featureStd[i] += (features[i] - featureMeans[i]) * (features[i] - featureMeans[i]);
+    featureStd[i] = std::sqrt(featureStd[i] / offsetFeatures.size());
   }
-  filter->SetOffsets(newOffset);
-  filter2->SetOffsets(newOffset);
-
-
-  // All features are required
-  typename FilterType::FeatureNameVectorPointer requestedFeatures = FilterType::FeatureNameVector::New();
-  requestedFeatures->push_back(TextureFilterType::ShortRunEmphasis);
-  requestedFeatures->push_back(TextureFilterType::LongRunEmphasis);
-  requestedFeatures->push_back(TextureFilterType::GreyLevelNonuniformity);
-  requestedFeatures->push_back(TextureFilterType::GreyLevelNonuniformityNormalized);
-  requestedFeatures->push_back(TextureFilterType::RunLengthNonuniformity);
-  requestedFeatures->push_back(TextureFilterType::RunLengthNonuniformityNormalized);
-  requestedFeatures->push_back(TextureFilterType::LowGreyLevelRunEmphasis);
-  requestedFeatures->push_back(TextureFilterType::HighGreyLevelRunEmphasis);
-  requestedFeatures->push_back(TextureFilterType::ShortRunLowGreyLevelEmphasis);
-  requestedFeatures->push_back(TextureFilterType::ShortRunHighGreyLevelEmphasis);
-  requestedFeatures->push_back(TextureFilterType::LongRunLowGreyLevelEmphasis);
-  requestedFeatures->push_back(TextureFilterType::LongRunHighGreyLevelEmphasis);
-  requestedFeatures->push_back(TextureFilterType::RunPercentage);
-  requestedFeatures->push_back(TextureFilterType::NumberOfRuns);
-  requestedFeatures->push_back(TextureFilterType::GreyLevelVariance);
-  requestedFeatures->push_back(TextureFilterType::RunLengthVariance);
-  requestedFeatures->push_back(TextureFilterType::RunEntropy);
-
-  filter->SetInput(itkImage);
-  filter->SetMaskImage(maskImage);
-  filter->SetRequestedFeatures(requestedFeatures);
-  filter2->SetInput(itkImage);
-  filter2->SetMaskImage(maskImage);
-  filter2->SetRequestedFeatures(requestedFeatures);
-  int numberOfBins = params.Bins;
-  if (numberOfBins < 2)
-    numberOfBins = 256;
-
-  double minRange = params.MinimumIntensity;
-  double maxRange = params.MaximumIntensity;
-
-  filter->SetPixelValueMinMax(minRange, maxRange);
-  filter->SetNumberOfBinsPerAxis(numberOfBins);
-  filter2->SetPixelValueMinMax(minRange, maxRange);
-  filter2->SetNumberOfBinsPerAxis(numberOfBins);
-
-  filter->SetDistanceValueMinMax(0, numberOfBins);
-  filter2->SetDistanceValueMinMax(0, numberOfBins);
-
-  filter2->CombinedFeatureCalculationOn();
-
-  filter->Update();
-  filter2->Update();
-
-  auto featureMeans = filter->GetFeatureMeans ();
-  auto featureStd = filter->GetFeatureStandardDeviations();
-  auto featureCombined = filter2->GetFeatureMeans();
-
-  for (std::size_t i = 0; i < featureMeans->size(); ++i)
+
+  for (std::size_t i = 0; i < featureMeans.size(); ++i)
   {
     switch (i)
     {
-    case TextureFilterType::ShortRunEmphasis :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run emphasis Means",featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run emphasis Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run emphasis Comb.", featureCombined->ElementAt(i)));
+    case ShortRunEmphasis :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run emphasis Means",featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run emphasis Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run emphasis Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::LongRunEmphasis :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run emphasis Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run emphasis Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run emphasis Comb.", featureCombined->ElementAt(i)));
+    case LongRunEmphasis :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run emphasis Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run emphasis Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run emphasis Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::GreyLevelNonuniformity :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity Comb.", featureCombined->ElementAt(i)));
+    case GreyLevelNonuniformity :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::GreyLevelNonuniformityNormalized :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity normalized Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity normalized Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity normalized Comb.", featureCombined->ElementAt(i)));
+    case GreyLevelNonuniformityNormalized :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity normalized Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity normalized Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level nonuniformity normalized Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::RunLengthNonuniformity :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity Comb.", featureCombined->ElementAt(i)));
+    case RunLengthNonuniformity :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::RunLengthNonuniformityNormalized :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity normalized Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity normalized Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity normalized Comb.", featureCombined->ElementAt(i)));
+    case RunLengthNonuniformityNormalized :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity normalized Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity normalized Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length nonuniformity normalized Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::LowGreyLevelRunEmphasis :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Low grey level run emphasis Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Low grey level run emphasis Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Low grey level run emphasis Comb.", featureCombined->ElementAt(i)));
+    case LowGreyLevelRunEmphasis :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Low grey level run emphasis Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Low grey level run emphasis Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Low grey level run emphasis Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::HighGreyLevelRunEmphasis :
-      featureList.push_back(std::make_pair(params.featurePrefix + "High grey level run emphasis Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "High grey level run emphasis Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "High grey level run emphasis Comb.", featureCombined->ElementAt(i)));
+    case HighGreyLevelRunEmphasis :
+      featureList.push_back(std::make_pair(params.featurePrefix + "High grey level run emphasis Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "High grey level run emphasis Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "High grey level run emphasis Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::ShortRunLowGreyLevelEmphasis :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run low grey level emphasis Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run low grey level emphasis  Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run low grey level emphasis  Comb.", featureCombined->ElementAt(i)));
+    case ShortRunLowGreyLevelEmphasis :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run low grey level emphasis Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run low grey level emphasis  Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run low grey level emphasis  Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::ShortRunHighGreyLevelEmphasis :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run high grey level emphasis Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run high grey level emphasis Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Short run high grey level emphasis Comb.", featureCombined->ElementAt(i)));
+    case ShortRunHighGreyLevelEmphasis :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run high grey level emphasis Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run high grey level emphasis Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Short run high grey level emphasis Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::LongRunLowGreyLevelEmphasis :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run low grey level emphasis Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run low grey level emphasis Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run low grey level emphasis Comb.", featureCombined->ElementAt(i)));
+    case LongRunLowGreyLevelEmphasis :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run low grey level emphasis Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run low grey level emphasis Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run low grey level emphasis Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::LongRunHighGreyLevelEmphasis :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run high grey level emphasis Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run high grey level emphasis Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Long run high grey level emphasis Comb.", featureCombined->ElementAt(i)));
+    case LongRunHighGreyLevelEmphasis :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run high grey level emphasis Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run high grey level emphasis Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Long run high grey level emphasis Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::RunPercentage :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run percentage Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run percentage Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run percentage Comb.", featureCombined->ElementAt(i) / newOffset->size()));
+    case RunPercentage :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run percentage Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run percentage Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run percentage Comb.", featureCombined[i] / offsets.size()));
       break;
-    case TextureFilterType::NumberOfRuns :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Number of runs Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Number of runs Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Number of runs Comb.", featureCombined->ElementAt(i)));
+    case NumberOfRuns :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Number of runs Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Number of runs Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Number of runs Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::GreyLevelVariance :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level variance Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level variance Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level variance Comb.", featureCombined->ElementAt(i)));
+    case GreyLevelVariance :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level variance Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level variance Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Grey level variance Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::RunLengthVariance :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length variance Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length variance Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length variance Comb.", featureCombined->ElementAt(i)));
+    case RunLengthVariance :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length variance Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length variance Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length variance Comb.", featureCombined[i]));
       break;
-    case TextureFilterType::RunEntropy :
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length entropy Means", featureMeans->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length entropy Std.", featureStd->ElementAt(i)));
-      featureList.push_back(std::make_pair(params.featurePrefix + "Run length entropy Comb.", featureCombined->ElementAt(i)));
+    case RunEntropy :
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length entropy Means", featureMeans[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length entropy Std.", featureStd[i]));
+      featureList.push_back(std::make_pair(params.featurePrefix + "Run length entropy Comb.", featureCombined[i]));
       break;
     default:
       break;
@@ -219,6 +292,59 @@ void
   }
 }
 
+std::vector<Eigen::MatrixXd>
+mitk::GIFGreyLevelRunLength::CalculateRunLengthMatrices(const GlobalImageFeatureContext::QuantizedRegion &region,
+                                                        const std::vector<std::ptrdiff_t> &linearOffsets)
+{
+  const int numberOfBins = region.NumberOfBins;
+  const int numberOfOffsets = linearOffsets.size();
+  std::vector<Eigen::MatrixXd> matrices(numberOfOffsets, Eigen::MatrixXd::Zero(numberOfBins, numberOfBins));
+  if (linearOffsets.empty())
+    return matrices;
+
+  // A masked voxel starts a run if its predecessor along the offset has another bin.
+  // Voxels outside the mask, NaN voxels and the padding have a negative bin, so that
+  // every run ends at the border of the region without bounds checks. Each voxel is
+  // therefore visited once as a possible start and once while walking its run.
+  //
+  // As in the ITK run-length filter, the length axis has as many bins as the
+  // intensity axis and covers lengths up to NumberOfBins + 1: the longest length
+  // is counted in the last bin and longer runs are dropped.
+  const int *bins = region.Bins.data();
+  const int numberOfVoxels = region.Voxels.size();
+#pragma omp parallel
+  {
+    std::vector<Eigen::MatrixXd> localMatrices(numberOfOffsets, Eigen::MatrixXd::Zero(numberOfBins, numberOfBins));
+
+#pragma omp for
+    for (int v = 0; v < numberOfVoxels; ++v)
+    {
+      const std::ptrdiff_t position = region.Voxels[v];
+      const int bin = bins[position];
+      for (int k = 0; k < numberOfOffsets; ++k)
+      {
+        const std::ptrdiff_t linearOffset = linearOffsets[k];
+        if (bins[position - linearOffset] == bin)
+          continue;
+
+        int length = 1;
+        for (std::ptrdiff_t next = position + linearOffset; bins[next] == bin; next += linearOffset)
+          ++length;
+        if (length > numberOfBins + 1)
+          continue;
+        localMatrices[k](bin, std::min(length, numberOfBins) - 1) += 1;
+      }
+    }
+
+#pragma omp critical (RunLengthMatrixMerge)
+    for (int k = 0; k < numberOfOffsets; ++k)
+    {
+      matrices[k] += localMatrices[k];
+    }
+  }
+  return matrices;
+}
+
 mitk::GIFGreyLevelRunLength::GIFGreyLevelRunLength()
 {
   SetShortName("rl");
@@ -245,7 +371,9 @@ mitk::GIFGreyLevelRunLength::FeatureListType mitk::GIFGreyLevelRunLength::Calcul
   MITK_INFO << params.m_Direction;
   MITK_INFO << params.Bins;
 
-  AccessByItk_3(image, CalculateGrayLevelRunLengthFeatures, mask, featureList,params);
+  // the runs are walked along offsets of one voxel
+  auto region = GetQuantizedRegion(image, mask, 1);
+  AccessByItk_3(image, CalculateGrayLevelRunLengthFeatures, region, featureList,params);
 
   return featureList;
 }
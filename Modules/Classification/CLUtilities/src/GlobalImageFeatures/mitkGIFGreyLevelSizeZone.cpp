@@ -6,7 +6,7 @@
 #include <mitkImageAccessByItk.h>
 
 // ITK
-#include <itkImageRegionIteratorWithIndex.h>
+#include <itkNeighborhood.h>
 
 // STL
 
@@ -113,87 +113,60 @@ double mitk::GreyLevelSizeZoneMatrixHolder::IndexToMaxIntensity(int index)
   return m_MinimumRange + (index + 1) * m_Stepsize;
 }
 
-template<typename TPixel, unsigned int VImageDimension>
+template<unsigned int VImageDimension>
 static int
-CalculateGlSZMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
-                    itk::Image<unsigned short, VImageDimension>* mask,
-                    std::vector<itk::Offset<VImageDimension> > offsets,
+CalculateGlSZMatrix(const mitk::GlobalImageFeatureContext::QuantizedRegion &region,
+                    const std::vector<itk::Offset<VImageDimension> > &offsets,
                     bool estimateLargestRegion,
                     mitk::GreyLevelSizeZoneMatrixHolder &holder)
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typedef itk::Image<unsigned short, VImageDimension> MaskImageType;
-  typedef typename ImageType::IndexType IndexType;
-
-  typedef itk::ImageRegionIteratorWithIndex<ImageType> ConstIterType;
-  typedef itk::ImageRegionIteratorWithIndex<MaskImageType> ConstMaskIterType;
-
-  auto region = mask->GetLargestPossibleRegion();
-  typename MaskImageType::RegionType newRegion;
-  newRegion.SetSize(region.GetSize());
-  newRegion.SetIndex(region.GetIndex());
-
-  ConstIterType imageIter(itkImage, itkImage->GetLargestPossibleRegion());
-  ConstMaskIterType maskIter(mask, mask->GetLargestPossibleRegion());
+  // The quantized region is padded by one voxel, so the zones can grow by linear offsets.
+  // The padding, voxels outside the mask and NaN voxels have a negative bin and never
+  // match the bin of a zone.
+  std::vector<std::ptrdiff_t> linearOffsets;
+  for (auto offset : offsets)
+  {
+    linearOffsets.push_back(region.LinearOffset(offset));
+  }
 
-  typename MaskImageType::Pointer visitedImage = MaskImageType::New();
-  visitedImage->SetRegions(newRegion);
-  visitedImage->Allocate();
-  visitedImage->FillBuffer(0);
+  const int *bins = region.Bins.data();
+  std::vector<char> visited(region.Bins.size(), 0);
+  std::vector<std::ptrdiff_t> positions;
 
   int largestRegion = 0;
 
-  while (!maskIter.IsAtEnd())
+  for (auto startPosition : region.Voxels)
   {
-    if (maskIter.Value() > 0 )
+    auto startIntensityIndex = bins[startPosition];
+    positions.push_back(startPosition);
+    unsigned int steps = 0;
+
+    while (positions.size() > 0)
     {
-      auto startIntensityIndex = holder.IntensityToIndex(imageIter.Value());
-      std::vector<IndexType> indices;
-      indices.push_back(maskIter.GetIndex());
-      unsigned int steps = 0;
+      auto currentPosition = positions.back();
+      positions.pop_back();
 
-      while (indices.size() > 0)
+      if ((bins[currentPosition] == startIntensityIndex) &&
+          (visited[currentPosition] < 1))
       {
-        auto currentIndex = indices.back();
-        indices.pop_back();
-
-        if (!region.IsInside(currentIndex))
-        {
-          continue;
-        }
-
-        auto wasVisited = visitedImage->GetPixel(currentIndex);
-        auto newIntensityIndex = holder.IntensityToIndex(itkImage->GetPixel(currentIndex));
-        auto isInMask = mask->GetPixel(currentIndex);
-
-        if ((isInMask > 0) &&
-            (newIntensityIndex == startIntensityIndex) &&
-            (wasVisited < 1))
+        ++steps;
+        visited[currentPosition] = 1;
+        for (auto linearOffset : linearOffsets)
         {
-          ++steps;
-          visitedImage->SetPixel(currentIndex, 1);
-          for (auto offset : offsets)
-          {
-            auto newIndex = currentIndex + offset;
-            indices.push_back(newIndex);
-            newIndex = currentIndex - offset;
-            indices.push_back(newIndex);
-          }
-
+          positions.push_back(currentPosition + linearOffset);
+          positions.push_back(currentPosition - linearOffset);
         }
       }
-      if (steps > 0)
+    }
+    if (steps > 0)
+    {
+      largestRegion = std::max<int>(steps, largestRegion);
+      steps = std::min<unsigned int>(steps, holder.m_MaximumSize);
+      if (!estimateLargestRegion)
       {
-        largestRegion = std::max<int>(steps, largestRegion);
-        steps = std::min<unsigned int>(steps, holder.m_MaximumSize);
-        if (!estimateLargestRegion)
-        {
-          holder.m_Matrix(startIntensityIndex, steps - 1) += 1;
-        }
+        holder.m_Matrix(startIntensityIndex, steps - 1) += 1;
       }
     }
-    ++imageIter;
-    ++maskIter;
   }
   return largestRegion;
 }
@@ -287,9 +260,8 @@ static void CalculateFeatures(
 
 template<typename TPixel, unsigned int VImageDimension>
 static void
-CalculateGreyLevelSizeZoneFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, mitk::GIFGreyLevelSizeZone::FeatureListType & featureList, mitk::GIFGreyLevelSizeZone::GIFGreyLevelSizeZoneConfiguration config)
+CalculateGreyLevelSizeZoneFeatures(itk::Image<TPixel, VImageDimension>* /*itkImage*/, mitk::GlobalImageFeatureContext::QuantizedRegion::ConstPointer region, mitk::GIFGreyLevelSizeZone::FeatureListType & featureList, mitk::GIFGreyLevelSizeZone::GIFGreyLevelSizeZoneConfiguration config)
 {
-  typedef itk::Image<unsigned short, VImageDimension> MaskType;
   typedef itk::Neighborhood<TPixel, VImageDimension > NeighborhoodType;
   typedef itk::Offset<VImageDimension> OffsetType;
 
@@ -298,9 +270,6 @@ CalculateGreyLevelSizeZoneFeatures(itk::Image<TPixel, VImageDimension>* itkImage
   double rangeMax = config.MaximumIntensity;
   int numberOfBins = config.Bins;
 
-  typename MaskType::Pointer maskImage = MaskType::New();
-  mitk::CastToItkImage(mask, maskImage);
-
   //Find possible directions
   std::vector < itk::Offset<VImageDimension> > offsetVector;
   NeighborhoodType hood;
@@ -335,10 +304,10 @@ CalculateGreyLevelSizeZoneFeatures(itk::Image<TPixel, VImageDimension>* itkImage
 
   std::vector<mitk::GreyLevelSizeZoneFeatures> resultVector;
   mitk::GreyLevelSizeZoneMatrixHolder tmpHolder(rangeMin, rangeMax, numberOfBins, 3);
-  int largestRegion = CalculateGlSZMatrix<TPixel, VImageDimension>(itkImage, maskImage, offsetVector, true, tmpHolder);
+  int largestRegion = CalculateGlSZMatrix<VImageDimension>(*region, offsetVector, true, tmpHolder);
   mitk::GreyLevelSizeZoneMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins,largestRegion);
   mitk::GreyLevelSizeZoneFeatures overallFeature;
-  CalculateGlSZMatrix<TPixel, VImageDimension>(itkImage, maskImage, offsetVector, false, holderOverall);
+  CalculateGlSZMatrix<VImageDimension>(*region, offsetVector, false, holderOverall);
   CalculateFeatures(holderOverall, overallFeature);
 
   MatrixFeaturesTo(overallFeature, config.prefix, featureList);
@@ -391,7 +360,8 @@ mitk::GIFGreyLevelSizeZone::FeatureListType mitk::GIFGreyLevelSizeZone::Calculat
   config.Bins = GetQuantifier()->GetBins();
   config.prefix = FeatureDescriptionPrefix();
 
-  AccessByItk_3(image, CalculateGreyLevelSizeZoneFeatures, mask, featureList, config);
+  auto region = GetQuantizedRegion(image, mask, 1);
+  AccessByItk_3(image, CalculateGreyLevelSizeZoneFeatures, region, featureList, config);
 
   return featureList;
 }
@@ -27,6 +27,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkImageRegionIteratorWithIndex.h>
 #include <itkNeighborhoodIterator.h>
 // STL
+#include <array>
 #include <limits>
 
 struct GIFNeighbourhoodGreyToneDifferenceParameter
@@ -36,21 +37,33 @@ struct GIFNeighbourhoodGreyToneDifferenceParameter
   std::string prefix;
 };
 
-template<typename TPixel, unsigned int VImageDimension>
 static void
-CalculateIntensityPeak(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, GIFNeighbourhoodGreyToneDifferenceParameter params, mitk::GIFNeighbourhoodGreyToneDifferenceFeatures::FeatureListType & featureList)
+CalculateIntensityPeak(const mitk::GlobalImageFeatureContext::QuantizedRegion &region, GIFNeighbourhoodGreyToneDifferenceParameter params, mitk::GIFNeighbourhoodGreyToneDifferenceFeatures::FeatureListType & featureList)
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typedef itk::Image<unsigned short, VImageDimension> MaskType;
+  typedef mitk::GlobalImageFeatureContext::QuantizedRegion QuantizedRegionType;
 
-  typename MaskType::Pointer itkMask = MaskType::New();
-  mitk::CastToItkImage(mask, itkMask);
-
-  typename ImageType::SizeType regionSize;
-  regionSize.Fill(params.Range);
-
-  itk::NeighborhoodIterator<ImageType> iter(regionSize, itkImage, itkImage->GetLargestPossibleRegion());
-  itk::NeighborhoodIterator<MaskType> iterMask(regionSize, itkMask, itkMask->GetLargestPossibleRegion());
+  // Offsets of all neighbours within the range, the region is padded by the range
+  std::vector<std::array<int, 3> > offsets;
+  std::vector<std::ptrdiff_t> linearOffsets;
+  int range[3];
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    range[d] = (d < region.Dimension) ? params.Range : 0;
+  }
+  for (int z = -range[2]; z <= range[2]; ++z)
+  {
+    for (int y = -range[1]; y <= range[1]; ++y)
+    {
+      for (int x = -range[0]; x <= range[0]; ++x)
+      {
+        if (x == 0 && y == 0 && z == 0)
+          continue;
+        std::array<int, 3> offset = { { x, y, z } };
+        offsets.push_back(offset);
+        linearOffsets.push_back(x * region.Stride[0] + y * region.Stride[1] + z * region.Stride[2]);
+      }
+    }
+  }
 
   std::vector<double> pVector;
   std::vector<double> sVector;
@@ -58,37 +71,41 @@ CalculateIntensityPeak(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Imag
   sVector.resize(params.quantifier->GetBins(), 0);
 
   int count = 0;
-  while (!iter.IsAtEnd())
+  for (auto position : region.Voxels)
   {
-    if (iterMask.GetCenterPixel() > 0)
+    int localCount = 0;
+    double localMean = 0;
+    unsigned int localIndex = region.Bins[position];
+    for (std::size_t k = 0; k < offsets.size(); ++k)
     {
-      int localCount = 0;
-      double localMean = 0;
-      unsigned int localIndex = params.quantifier->IntensityToIndex(iter.GetCenterPixel());
-      for (itk::SizeValueType i = 0; i < iter.Size(); ++i)
+      int bin = region.Bins[position + linearOffsets[k]];
+      if (bin == QuantizedRegionType::OutsideImage)
       {
-        if (i == (iter.Size() / 2))
-          continue;
-        if (iterMask.GetPixel(i) > 0)
+        // Neighbours outside of the image are replaced by the nearest voxel inside,
+        // like the boundary condition of a neighbourhood iterator does.
+        int index[3];
+        region.Index(position, index);
+        for (unsigned int d = 0; d < 3; ++d)
         {
-          ++localCount;
-          localMean += params.quantifier->IntensityToIndex(iter.GetPixel(i)) + 1;
+          index[d] = std::max(0, std::min(region.Size[d] - 1, index[d] + offsets[k][d]));
         }
+        bin = region.Bins[region.Position(index)];
       }
-      if (localCount > 0)
+      if (bin >= 0)
       {
-        localMean /= localCount;
+        ++localCount;
+        localMean += bin + 1;
       }
-        localMean = std::abs<double>(localIndex + 1 - localMean);
-
-        pVector[localIndex] += 1;
-        sVector[localIndex] += localMean;
-        ++count;
-
-
     }
-    ++iterMask;
-    ++iter;
+    if (localCount > 0)
+    {
+      localMean /= localCount;
+    }
+    localMean = std::abs<double>(localIndex + 1 - localMean);
+
+    pVector[localIndex] += 1;
+    sVector[localIndex] += localMean;
+    ++count;
   }
 
   unsigned int Ngp = 0;
@@ -167,7 +184,8 @@ mitk::GIFNeighbourhoodGreyToneDifferenceFeatures::FeatureListType mitk::GIFNeigh
   params.quantifier = GetQuantifier();
   params.prefix = FeatureDescriptionPrefix();
 
-  AccessByItk_3(image, CalculateIntensityPeak, mask, params, featureList);
+  auto region = GetQuantizedRegion(image, mask, params.Range);
+  CalculateIntensityPeak(*region, params, featureList);
   return featureList;
 }
 
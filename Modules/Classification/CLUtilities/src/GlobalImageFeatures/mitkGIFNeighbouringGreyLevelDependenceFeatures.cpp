@@ -8,7 +8,7 @@
 // ITK
 #include <itkEnhancedScalarImageToTextureFeaturesFilter.h>
 #include <itkMinimumMaximumImageCalculator.h>
-#include <itkNeighborhoodIterator.h>
+#include <itkNeighborhood.h>
 #include <itkImageRegionConstIterator.h>
 
 // STL
@@ -143,20 +143,14 @@ double mitk::NGLDMMatrixHolder::IndexToMaxIntensity(int index)
   return m_MinimumRange + (index + 1) * m_Stepsize;
 }
 
-template<typename TPixel, unsigned int VImageDimension>
+template<unsigned int VImageDimension>
 void
-CalculateNGLDMMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
-                    itk::Image<unsigned short, VImageDimension>* mask,
+CalculateNGLDMMatrix(const mitk::GlobalImageFeatureContext::QuantizedRegion &region,
                     int alpha,
                     int range,
                     unsigned int direction,
                     mitk::NGLDMMatrixHolder &holder)
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typedef itk::Image<unsigned short, VImageDimension> MaskImageType;
-  typedef itk::NeighborhoodIterator<ImageType> ShapeIterType;
-  typedef itk::NeighborhoodIterator<MaskImageType> ShapeMaskIterType;
-
   holder.m_NumberOfCompleteNeighbourhoods = 0;
   holder.m_NumberOfNeighbourhoods = 0;
   holder.m_NumberOfNeighbourVoxels = 0;
@@ -170,50 +164,37 @@ CalculateNGLDMMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
     radius[direction - 2] = 0;
   }
 
-  ShapeIterType imageIter(radius, itkImage, itkImage->GetLargestPossibleRegion());
-  ShapeMaskIterType maskIter(radius, mask, mask->GetLargestPossibleRegion());
-
-  auto region = mask->GetLargestPossibleRegion();
+  // The quantized region is padded by the range, so every neighbour can be addressed by
+  // a linear offset. Neighbours outside the image, outside the mask or with a NaN value
+  // have a negative bin and make the neighbourhood incomplete.
+  itk::Neighborhood<int, VImageDimension> hood;
+  hood.SetRadius(radius);
+  std::vector<std::ptrdiff_t> linearOffsets;
+  for (unsigned int position = 0; position < hood.Size(); ++position)
+  {
+    if (position != hood.GetCenterNeighborhoodIndex())
+    {
+      linearOffsets.push_back(region.LinearOffset(hood.GetOffset(position)));
+    }
+  }
+  holder.m_NeighbourhoodSize = linearOffsets.size();
 
-  auto center = imageIter.Size() / 2;
-  auto iterSize = imageIter.Size();
-  holder.m_NeighbourhoodSize = iterSize-1;
-  while (!maskIter.IsAtEnd())
+  const int *bins = region.Bins.data();
+  for (auto position : region.Voxels)
   {
     int sameValues = 0;
     bool completeNeighbourhood = true;
 
-    int i = holder.IntensityToIndex(imageIter.GetCenterPixel());
-
-    if ((imageIter.GetCenterPixel() != imageIter.GetCenterPixel()) ||
-      (maskIter.GetCenterPixel() < 1))
-    {
-      ++imageIter;
-      ++maskIter;
-      continue;
-    }
-
-    for (unsigned int position = 0; position < iterSize; ++position)
+    int i = bins[position];
+    for (auto linearOffset : linearOffsets)
     {
-      if (position == center)
-      {
-        continue;
-      }
-      if ( ! region.IsInside(maskIter.GetIndex(position)))
-      {
-        completeNeighbourhood = false;
-        continue;
-      }
-      bool isInBounds;
-      auto jIntensity = imageIter.GetPixel(position, isInBounds);
-      auto jMask = maskIter.GetPixel(position, isInBounds);
-      if (jMask < 1 || (jIntensity != jIntensity) || ( ! isInBounds))
+      int j = bins[position + linearOffset];
+      if (j < 0)
       {
         completeNeighbourhood = false;
         continue;
       }
 
-      int j = holder.IntensityToIndex(jIntensity);
       holder.m_NumberOfNeighbourVoxels += 1;
       if (std::abs(i - j) <= alpha)
       {
@@ -227,9 +208,6 @@ CalculateNGLDMMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
     {
       holder.m_NumberOfCompleteNeighbourhoods += 1;
     }
-
-    ++imageIter;
-    ++maskIter;
   }
 
 }
@@ -339,17 +317,12 @@ void LocalCalculateFeatures(
 
 template<typename TPixel, unsigned int VImageDimension>
 void
-CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, mitk::GIFNeighbouringGreyLevelDependenceFeature::FeatureListType & featureList, mitk::GIFNeighbouringGreyLevelDependenceFeature::GIFNeighbouringGreyLevelDependenceFeatureConfiguration config)
+CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* /*itkImage*/, mitk::GlobalImageFeatureContext::QuantizedRegion::ConstPointer region, mitk::GIFNeighbouringGreyLevelDependenceFeature::FeatureListType & featureList, mitk::GIFNeighbouringGreyLevelDependenceFeature::GIFNeighbouringGreyLevelDependenceFeatureConfiguration config)
 {
-  typedef itk::Image<unsigned short, VImageDimension> MaskType;
-
   double rangeMin = config.MinimumIntensity;
   double rangeMax = config.MaximumIntensity;
   int numberOfBins = config.Bins;
 
-  typename MaskType::Pointer maskImage = MaskType::New();
-  mitk::CastToItkImage(mask, maskImage);
-
   std::vector<mitk::NGLDMMatrixFeatures> resultVector;
   int numberofDependency = 37;
   if (VImageDimension == 2)
@@ -357,7 +330,7 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
 
   mitk::NGLDMMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins, numberofDependency);
   mitk::NGLDMMatrixFeatures overallFeature;
-  CalculateNGLDMMatrix<TPixel, VImageDimension>(itkImage, maskImage, config.alpha, config.range, config.direction, holderOverall);
+  CalculateNGLDMMatrix<VImageDimension>(*region, config.alpha, config.range, config.direction, holderOverall);
   LocalCalculateFeatures(holderOverall, overallFeature);
 
   MatrixFeaturesTo(overallFeature, config.FeatureEncoding, featureList);
@@ -423,7 +396,8 @@ mitk::GIFNeighbouringGreyLevelDependenceFeature::FeatureListType mitk::GIFNeighb
 
   config.FeatureEncoding = FeatureDescriptionPrefix();
 
-  AccessByItk_3(image, CalculateCoocurenceFeatures, mask, featureList,config);
+  auto region = GetQuantizedRegion(image, mask, static_cast<unsigned int>(config.range));
+  AccessByItk_3(image, CalculateCoocurenceFeatures, region, featureList,config);
 
   return featureList;
 }
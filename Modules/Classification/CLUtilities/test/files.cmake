@@ -5,6 +5,7 @@ set(MODULE_TESTS
   mitkGIFFirstOrderNumericStatisticsTest
   mitkGIFFirstOrderStatisticsTest
   mitkGIFGreyLevelDistanceZoneTest
+  mitkGIFGreyLevelRunLengthTest
   mitkGIFGreyLevelSizeZoneTest
   mitkGIFImageDescriptionFeaturesTest
   mitkGIFIntensityVolumeHistogramTest
@@ -13,6 +14,8 @@ set(MODULE_TESTS
   mitkGIFNeighbouringGreyLevelDependenceFeatureTest
   mitkGIFVolumetricDensityStatisticsTest
   mitkGIFVolumetricStatisticsTest
+  mitkGlobalImageFeatureContextTest
+  mitkLocalStatisticFilterTest
   #mitkSmoothedClassProbabilitesTest.cpp
   #mitkGlobalFeaturesTest.cpp
 )
@@ -20,6 +20,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <cmath>
 
 #include <mitkGIFCooccurenceMatrix2.h>
+#include <mitkImageCast.h>
+
+#include <itkImageRegionConstIterator.h>
+#include <itkNeighborhood.h>
+#include <itkShapedNeighborhoodIterator.h>
 
 class mitkGIFCooc2TestSuite : public mitk::TestFixture
 {
@@ -27,6 +32,7 @@ class mitkGIFCooc2TestSuite : public mitk::TestFixture
 
   MITK_TEST(ImageDescription_PhantomTest_3D);
   MITK_TEST(ImageDescription_PhantomTest_2D);
+  MITK_TEST(CoOcMatrices_EqualPerOffsetWalk);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -36,6 +42,50 @@ private:
   mitk::Image::Pointer m_IBSI_Phantom_Mask_Small;
   mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
 
+  typedef itk::Image<double, 3> ImageType;
+  typedef itk::Image<unsigned short, 3> MaskType;
+
+  /** Co-occurence matrix of a single offset, walking the whole image with a shaped neighbourhood
+  iterator as the feature class did before the matrices were built from the quantized region.*/
+  Eigen::MatrixXd PerOffsetCoOcMatrix(ImageType *image, MaskType *mask, const ImageType::OffsetType &offset, int range, mitk::IntensityQuantifier::Pointer quantifier)
+  {
+    typedef itk::ShapedNeighborhoodIterator<ImageType> ShapeIterType;
+    typedef itk::ShapedNeighborhoodIterator<MaskType> ShapeMaskIterType;
+
+    itk::Size<3> radius;
+    radius.Fill(range + 1);
+    ShapeIterType imageOffsetIter(radius, image, image->GetLargestPossibleRegion());
+    ShapeMaskIterType maskOffsetIter(radius, mask, mask->GetLargestPossibleRegion());
+    imageOffsetIter.ActivateOffset(offset);
+    maskOffsetIter.ActivateOffset(offset);
+    itk::ImageRegionConstIterator<ImageType> imageIter(image, image->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<MaskType> maskIter(mask, mask->GetLargestPossibleRegion());
+    auto region = mask->GetLargestPossibleRegion();
+
+    Eigen::MatrixXd matrix = Eigen::MatrixXd::Zero(quantifier->GetBins(), quantifier->GetBins());
+    while (!maskIter.IsAtEnd())
+    {
+      auto ciMask = maskOffsetIter.Begin();
+      auto ciValue = imageOffsetIter.Begin();
+      if (maskIter.Value() > 0 &&
+        ciMask.Get() > 0 &&
+        imageIter.Get() == imageIter.Get() &&
+        ciValue.Get() == ciValue.Get() &&
+        region.IsInside(maskOffsetIter.GetIndex() + ciMask.GetNeighborhoodOffset()))
+      {
+        int i = quantifier->IntensityToIndex(imageIter.Get());
+        int j = quantifier->IntensityToIndex(ciValue.Get());
+        matrix(i, j) += 1;
+        matrix(j, i) += 1;
+      }
+      ++imageOffsetIter;
+      ++maskOffsetIter;
+      ++imageIter;
+      ++maskIter;
+    }
+    return matrix;
+  }
+
 public:
 
   void setUp(void) override
@@ -246,6 +296,47 @@ public:
     CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("SliceWise Mean Co-occurenced Based Features::Mean Second Row-Column Entropy with Large IBSI Phantom Image", 2.24761, results["SliceWise Mean Co-occurenced Based Features::Mean Second Row-Column Entropy"], 0.001);
   }
 
+  void CoOcMatrices_EqualPerOffsetWalk()
+  {
+    mitk::GIFCooccurenceMatrix2::Pointer featureCalculator = mitk::GIFCooccurenceMatrix2::New();
+    featureCalculator->SetUseBinsize(true);
+    featureCalculator->SetBinsize(0.5);
+    featureCalculator->InitializeQuantifier(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    auto quantifier = featureCalculator->GetQuantifier();
+
+    ImageType::Pointer itkImage = ImageType::New();
+    MaskType::Pointer itkMask = MaskType::New();
+    mitk::CastToItkImage(m_IBSI_Phantom_Image_Large, itkImage);
+    mitk::CastToItkImage(m_IBSI_Phantom_Mask_Large, itkMask);
+
+    for (int range = 1; range <= 2; ++range)
+    {
+      auto region = mitk::GlobalImageFeatureContext::CreateQuantizedRegion(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large, quantifier, range);
+
+      itk::Neighborhood<double, 3> hood;
+      hood.SetRadius(1);
+      std::vector<ImageType::OffsetType> offsets;
+      std::vector<std::ptrdiff_t> linearOffsets;
+      for (unsigned int d = 0; d < hood.GetCenterNeighborhoodIndex(); ++d)
+      {
+        ImageType::OffsetType offset = hood.GetOffset(d);
+        for (unsigned int i = 0; i < 3; ++i)
+          offset[i] *= range;
+        offsets.push_back(offset);
+        linearOffsets.push_back(region->LinearOffset(offset));
+      }
+
+      auto matrices = mitk::GIFCooccurenceMatrix2::CalculateCoOcMatrices(*region, linearOffsets);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("One matrix per offset", offsets.size(), matrices.size());
+      for (std::size_t k = 0; k < offsets.size(); ++k)
+      {
+        Eigen::MatrixXd reference = PerOffsetCoOcMatrix(itkImage, itkMask, offsets[k], range, quantifier);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Co-occurence matrix with range " + std::to_string(range) + " and offset #" + std::to_string(k),
+          0.0, (matrices[k] - reference).cwiseAbs().maxCoeff(), 0.000001);
+      }
+    }
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkGIFCooc2 )
\ No newline at end of file
@@ -0,0 +1,189 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include "mitkIOUtil.h"
+
+#include <mitkGIFGreyLevelRunLength.h>
+#include <mitkImageCast.h>
+
+#include <itkEnhancedScalarImageToRunLengthFeaturesFilter.h>
+#include <itkEnhancedScalarImageToRunLengthMatrixFilter.h>
+#include <itkNeighborhood.h>
+
+// Compares the run-length matrices and features built from the quantized region with the per offset
+// walk of the ITK run-length filters.
+class mitkGIFGreyLevelRunLengthTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkGIFGreyLevelRunLengthTestSuite);
+
+  MITK_TEST(RunLengthMatrices_EqualItkFilter);
+  MITK_TEST(RunLengthFeatures_EqualItkFilter);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> ImageType;
+  typedef itk::Statistics::EnhancedScalarImageToRunLengthMatrixFilter<ImageType> MatrixFilterType;
+  typedef itk::Statistics::EnhancedScalarImageToRunLengthFeaturesFilter<ImageType> FeaturesFilterType;
+
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Large;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
+  ImageType::Pointer m_Image;
+  ImageType::Pointer m_Mask;
+
+  mitk::GIFGreyLevelRunLength::Pointer CreateFeatureCalculator()
+  {
+    mitk::GIFGreyLevelRunLength::Pointer featureCalculator = mitk::GIFGreyLevelRunLength::New();
+    featureCalculator->SetUseBinsize(true);
+    featureCalculator->SetBinsize(1.0);
+    featureCalculator->SetUseMinimumIntensity(true);
+    featureCalculator->SetUseMaximumIntensity(true);
+    featureCalculator->SetMinimumIntensity(0.5);
+    featureCalculator->SetMaximumIntensity(6.5);
+    return featureCalculator;
+  }
+
+  /** Half of all offsets of the 26 neighbourhood, as used by the feature class */
+  std::vector<ImageType::OffsetType> NeighbourhoodOffsets()
+  {
+    itk::Neighborhood<double, 3> hood;
+    hood.SetRadius(1);
+    std::vector<ImageType::OffsetType> offsets;
+    for (unsigned int d = 0; d < hood.GetCenterNeighborhoodIndex(); ++d)
+    {
+      offsets.push_back(hood.GetOffset(d));
+    }
+    return offsets;
+  }
+
+public:
+
+  void setUp(void) override
+  {
+    m_IBSI_Phantom_Image_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Large.nrrd"));
+    m_IBSI_Phantom_Mask_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Large.nrrd"));
+
+    m_Image = ImageType::New();
+    m_Mask = ImageType::New();
+    mitk::CastToItkImage(m_IBSI_Phantom_Image_Large, m_Image);
+    mitk::CastToItkImage(m_IBSI_Phantom_Mask_Large, m_Mask);
+  }
+
+  void tearDown(void) override
+  {
+    m_Image = nullptr;
+    m_Mask = nullptr;
+  }
+
+  void RunLengthMatrices_EqualItkFilter()
+  {
+    auto featureCalculator = CreateFeatureCalculator();
+    featureCalculator->InitializeQuantifier(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    auto quantifier = featureCalculator->GetQuantifier();
+    const int numberOfBins = quantifier->GetBins();
+
+    auto region = mitk::GlobalImageFeatureContext::CreateQuantizedRegion(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large, quantifier, 1);
+    auto offsets = NeighbourhoodOffsets();
+    std::vector<std::ptrdiff_t> linearOffsets;
+    for (auto offset : offsets)
+    {
+      linearOffsets.push_back(region->LinearOffset(offset));
+    }
+
+    auto matrices = mitk::GIFGreyLevelRunLength::CalculateRunLengthMatrices(*region, linearOffsets);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("One matrix per offset", offsets.size(), matrices.size());
+
+    for (std::size_t k = 0; k < offsets.size(); ++k)
+    {
+      MatrixFilterType::Pointer filter = MatrixFilterType::New();
+      filter->SetInput(m_Image);
+      filter->SetMaskImage(m_Mask);
+      filter->SetOffset(offsets[k]);
+      filter->SetPixelValueMinMax(quantifier->GetMinimum(), quantifier->GetMaximum());
+      filter->SetNumberOfBinsPerAxis(numberOfBins);
+      filter->SetDistanceValueMinMax(0, numberOfBins);
+      filter->Update();
+
+      auto histogram = filter->GetOutput();
+      MatrixFilterType::HistogramType::IndexType index(2);
+      for (int x = 0; x < numberOfBins; ++x)
+      {
+        for (int l = 0; l < numberOfBins; ++l)
+        {
+          index[0] = x;
+          index[1] = l;
+          CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Run-length matrix of offset #" + std::to_string(k),
+            histogram->GetFrequency(index), matrices[k](x, l), 0.000001);
+        }
+      }
+    }
+  }
+
+  void RunLengthFeatures_EqualItkFilter()
+  {
+    auto featureCalculator = CreateFeatureCalculator();
+    auto featureList = featureCalculator->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    auto quantifier = featureCalculator->GetQuantifier();
+    const int numberOfBins = quantifier->GetBins();
+
+    auto offsets = NeighbourhoodOffsets();
+    FeaturesFilterType::OffsetVector::Pointer offsetVector = FeaturesFilterType::OffsetVector::New();
+    for (auto offset : offsets)
+    {
+      offsetVector->push_back(offset);
+    }
+
+    FeaturesFilterType::FeatureNameVectorPointer requestedFeatures = FeaturesFilterType::FeatureNameVector::New();
+    for (int i = FeaturesFilterType::RunLengthFeaturesFilterType::ShortRunEmphasis; i <= FeaturesFilterType::RunLengthFeaturesFilterType::RunEntropy; ++i)
+    {
+      requestedFeatures->push_back(i);
+    }
+
+    FeaturesFilterType::Pointer filter = FeaturesFilterType::New();
+    FeaturesFilterType::Pointer combinedFilter = FeaturesFilterType::New();
+    for (auto currentFilter : { filter, combinedFilter })
+    {
+      currentFilter->SetInput(m_Image);
+      currentFilter->SetMaskImage(m_Mask);
+      currentFilter->SetOffsets(offsetVector);
+      currentFilter->SetRequestedFeatures(requestedFeatures);
+      currentFilter->SetPixelValueMinMax(quantifier->GetMinimum(), quantifier->GetMaximum());
+      currentFilter->SetNumberOfBinsPerAxis(numberOfBins);
+      currentFilter->SetDistanceValueMinMax(0, numberOfBins);
+    }
+    combinedFilter->CombinedFeatureCalculationOn();
+    filter->Update();
+    combinedFilter->Update();
+
+    // Means, Std. and Comb. of every feature in the order of the ITK features
+    const std::size_t numberOfFeatures = requestedFeatures->size();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Run-length should calculate 51 features.", 3 * numberOfFeatures, featureList.size());
+    for (std::size_t i = 0; i < numberOfFeatures; ++i)
+    {
+      double combined = combinedFilter->GetFeatureMeans()->ElementAt(i);
+      if (i == FeaturesFilterType::RunLengthFeaturesFilterType::RunPercentage)
+        combined /= offsets.size();
+
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(featureList[3 * i].first, filter->GetFeatureMeans()->ElementAt(i), featureList[3 * i].second, 0.000001);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(featureList[3 * i + 1].first, filter->GetFeatureStandardDeviations()->ElementAt(i), featureList[3 * i + 1].second, 0.000001);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(featureList[3 * i + 2].first, combined, featureList[3 * i + 2].second, 0.000001);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkGIFGreyLevelRunLength)
@@ -0,0 +1,155 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include "mitkIOUtil.h"
+
+#include <mitkGlobalImageFeatureContext.h>
+#include <mitkGIFFirstOrderNumericStatistics.h>
+#include <mitkImageCast.h>
+
+#include <itkImageRegionConstIteratorWithIndex.h>
+
+class mitkGlobalImageFeatureContextTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkGlobalImageFeatureContextTestSuite);
+
+  MITK_TEST(RegionRange_PhantomTest);
+  MITK_TEST(QuantifierInitialization_PhantomTest);
+  MITK_TEST(QuantizedRegion_PhantomTest);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Large;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
+
+  void CompareQuantifier(mitk::GIFFirstOrderNumericStatistics::Pointer featureCalculator, const std::string &setting)
+  {
+    featureCalculator->SetContext(nullptr);
+    featureCalculator->InitializeQuantifier(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    auto reference = featureCalculator->GetQuantifier();
+
+    mitk::GlobalImageFeatureContext::Pointer context = mitk::GlobalImageFeatureContext::New();
+    context->SetImage(m_IBSI_Phantom_Image_Large);
+    featureCalculator->SetContext(context);
+    featureCalculator->InitializeQuantifier(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    auto shared = featureCalculator->GetQuantifier();
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Minimum with " + setting, reference->GetMinimum(), shared->GetMinimum(), 0.000001);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Maximum with " + setting, reference->GetMaximum(), shared->GetMaximum(), 0.000001);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Binsize with " + setting, reference->GetBinsize(), shared->GetBinsize(), 0.000001);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Bins with " + setting, reference->GetBins(), shared->GetBins());
+  }
+
+public:
+
+  void setUp(void) override
+  {
+    m_IBSI_Phantom_Image_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Large.nrrd"));
+    m_IBSI_Phantom_Mask_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Large.nrrd"));
+  }
+
+  void RegionRange_PhantomTest()
+  {
+    mitk::GlobalImageFeatureContext::Pointer context = mitk::GlobalImageFeatureContext::New();
+    context->SetImage(m_IBSI_Phantom_Image_Large);
+
+    double minimum, maximum;
+    context->GetRegionRange(m_IBSI_Phantom_Mask_Large, minimum, maximum);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Region minimum of Large IBSI Phantom Image", 1, minimum, 0.01);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Region maximum of Large IBSI Phantom Image", 6, maximum, 0.01);
+  }
+
+  void QuantifierInitialization_PhantomTest()
+  {
+    mitk::GIFFirstOrderNumericStatistics::Pointer featureCalculator = mitk::GIFFirstOrderNumericStatistics::New();
+    CompareQuantifier(featureCalculator, "default bins");
+
+    featureCalculator->SetUseBins(false);
+    CompareQuantifier(featureCalculator, "default region");
+
+    featureCalculator->SetIgnoreMask(true);
+    CompareQuantifier(featureCalculator, "default image");
+
+    featureCalculator->SetUseBinsize(true);
+    featureCalculator->SetBinsize(0.5);
+    CompareQuantifier(featureCalculator, "binsize and image");
+
+    featureCalculator->SetIgnoreMask(false);
+    CompareQuantifier(featureCalculator, "binsize and region");
+
+    featureCalculator->SetUseMinimumIntensity(true);
+    featureCalculator->SetMinimumIntensity(0.5);
+    CompareQuantifier(featureCalculator, "binsize, minimum and region");
+
+    featureCalculator->SetUseMaximumIntensity(true);
+    featureCalculator->SetMaximumIntensity(6.5);
+    CompareQuantifier(featureCalculator, "binsize, minimum and maximum");
+  }
+
+  void QuantizedRegion_PhantomTest()
+  {
+    typedef itk::Image<double, 3> ImageType;
+    typedef itk::Image<unsigned short, 3> MaskType;
+    typedef mitk::GlobalImageFeatureContext::QuantizedRegion QuantizedRegionType;
+
+    mitk::GIFFirstOrderNumericStatistics::Pointer featureCalculator = mitk::GIFFirstOrderNumericStatistics::New();
+    featureCalculator->InitializeQuantifier(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    auto quantifier = featureCalculator->GetQuantifier();
+
+    mitk::GlobalImageFeatureContext::Pointer context = mitk::GlobalImageFeatureContext::New();
+    context->SetImage(m_IBSI_Phantom_Image_Large);
+    auto region = context->GetQuantizedRegion(m_IBSI_Phantom_Mask_Large, quantifier, 2);
+    CPPUNIT_ASSERT_MESSAGE("Quantized region is cached", region == context->GetQuantizedRegion(m_IBSI_Phantom_Mask_Large, quantifier, 2));
+    CPPUNIT_ASSERT_MESSAGE("Quantized region depends on the padding", region != context->GetQuantizedRegion(m_IBSI_Phantom_Mask_Large, quantifier, 1));
+
+    ImageType::Pointer itkImage = ImageType::New();
+    MaskType::Pointer itkMask = MaskType::New();
+    mitk::CastToItkImage(m_IBSI_Phantom_Image_Large, itkImage);
+    mitk::CastToItkImage(m_IBSI_Phantom_Mask_Large, itkMask);
+
+    std::size_t numberOfVoxels = 0;
+    itk::ImageRegionConstIteratorWithIndex<MaskType> maskIter(itkMask, itkMask->GetLargestPossibleRegion());
+    while (!maskIter.IsAtEnd())
+    {
+      auto index = maskIter.GetIndex() - itkMask->GetLargestPossibleRegion().GetIndex();
+      int regionIndex[3] = { static_cast<int>(index[0]), static_cast<int>(index[1]), static_cast<int>(index[2]) };
+      int bin = region->Bins[region->Position(regionIndex)];
+      if (maskIter.Get() > 0)
+      {
+        ++numberOfVoxels;
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Bin of masked voxel", static_cast<int>(quantifier->IntensityToIndex(itkImage->GetPixel(maskIter.GetIndex()))), bin);
+      }
+      else
+      {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Bin of voxel outside the mask", static_cast<int>(QuantizedRegionType::OutsideMask), bin);
+      }
+      ++maskIter;
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of masked voxels", numberOfVoxels, region->Voxels.size());
+
+    int corner[3] = { -2, -2, -2 };
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Bin of the padding", static_cast<int>(QuantizedRegionType::OutsideImage), region->Bins[region->Position(corner)]);
+    int index[3];
+    region->Index(region->Voxels.back(), index);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Index of buffer position", region->Voxels.back(), region->Position(index));
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkGlobalImageFeatureContext )
@@ -0,0 +1,261 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <itkImage.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkImageRegionIterator.h>
+#include <itkLocalIntensityFilter.h>
+#include <itkLocalStatisticFilter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+// Compares the window based local filters with a brute force calculation on a small random image.
+class mitkLocalStatisticFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLocalStatisticFilterTestSuite);
+
+  MITK_TEST(LocalStatistic_WithoutMask_EqualsBruteForce);
+  MITK_TEST(LocalStatistic_WithMask_EqualsBruteForce);
+  MITK_TEST(LocalIntensity_FullMask_EqualsBruteForce);
+  MITK_TEST(LocalIntensity_WithMask_EqualsBruteForce);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> ImageType;
+  typedef itk::Image<unsigned short, 3> MaskType;
+  typedef itk::LocalStatisticFilter<ImageType, ImageType> LocalStatisticFilterType;
+  typedef itk::LocalIntensityFilter<ImageType> LocalIntensityFilterType;
+
+  ImageType::Pointer m_Image;
+  MaskType::Pointer m_Mask;
+  MaskType::Pointer m_FullMask;
+
+  template <typename TImage>
+  typename TImage::Pointer CreateImage()
+  {
+    typename TImage::SizeType size;
+    size[0] = 11;
+    size[1] = 9;
+    size[2] = 4;
+    typename TImage::SpacingType spacing;
+    spacing[0] = 1.0;
+    spacing[1] = 1.5;
+    spacing[2] = 2.0;
+
+    typename TImage::Pointer image = TImage::New();
+    image->SetRegions(size);
+    image->SetSpacing(spacing);
+    image->Allocate();
+    return image;
+  }
+
+  /** Brute force statistics of the window with radius size in x and y around index. Voxels outside the image
+  are replaced by the nearest voxel inside. If a mask is given, only masked voxels are used.*/
+  void BruteForceStatistic(const ImageType::IndexType &index, int size, MaskType *mask, double result[5])
+  {
+    auto imageSize = m_Image->GetLargestPossibleRegion().GetSize();
+    double minimum = std::numeric_limits<double>::max();
+    double maximum = std::numeric_limits<double>::lowest();
+    double sum = 0;
+    double sumOfSquares = 0;
+    double count = 0;
+    for (int dy = -size; dy <= size; ++dy)
+    {
+      for (int dx = -size; dx <= size; ++dx)
+      {
+        ImageType::IndexType neighbour = index;
+        neighbour[0] = std::max<long>(0, std::min<long>(imageSize[0] - 1, index[0] + dx));
+        neighbour[1] = std::max<long>(0, std::min<long>(imageSize[1] - 1, index[1] + dy));
+        if (mask && mask->GetPixel(neighbour) == 0)
+          continue;
+
+        double value = m_Image->GetPixel(neighbour);
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+        sum += value;
+        sumOfSquares += value * value;
+        count += 1;
+      }
+    }
+
+    std::fill(result, result + 5, 0.0);
+    if (count > 0)
+    {
+      double mean = sum / count;
+      result[0] = minimum;
+      result[1] = maximum;
+      result[2] = mean;
+      result[3] = std::sqrt(std::max(0.0, sumOfSquares / count - mean * mean));
+      result[4] = maximum - minimum;
+    }
+  }
+
+  void CompareLocalStatistic(MaskType *mask)
+  {
+    const int size = 2;
+    LocalStatisticFilterType::Pointer filter = LocalStatisticFilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetSize(size);
+    if (mask)
+      filter->SetMask(mask);
+    // several thread regions, so that the padding of the region borders is covered
+    filter->SetNumberOfThreads(3);
+    filter->Update();
+
+    itk::ImageRegionConstIteratorWithIndex<ImageType> iter(m_Image, m_Image->GetLargestPossibleRegion());
+    while (!iter.IsAtEnd())
+    {
+      double expected[5];
+      BruteForceStatistic(iter.GetIndex(), size, mask, expected);
+      for (unsigned int i = 0; i < 5; ++i)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Local statistic #" + std::to_string(i), expected[i],
+                                             filter->GetOutput(i)->GetPixel(iter.GetIndex()), 1e-6);
+      }
+      ++iter;
+    }
+  }
+
+  /** Brute force local and global intensity peaks: the mean of all voxels of the image within the range
+  around each masked voxel.*/
+  void CompareLocalIntensity(MaskType *mask)
+  {
+    const double range = 2.6;
+    LocalIntensityFilterType::Pointer filter = LocalIntensityFilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetMask(mask);
+    filter->SetRange(range);
+    filter->SetNumberOfThreads(3);
+    filter->Update();
+
+    double globalPeak = std::numeric_limits<double>::lowest();
+    double localPeak = std::numeric_limits<double>::lowest();
+    double localMaximum = std::numeric_limits<double>::lowest();
+
+    itk::ImageRegionConstIteratorWithIndex<ImageType> centerIter(m_Image, m_Image->GetLargestPossibleRegion());
+    while (!centerIter.IsAtEnd())
+    {
+      if (mask->GetPixel(centerIter.GetIndex()) > 0)
+      {
+        ImageType::PointType center;
+        m_Image->TransformIndexToPhysicalPoint(centerIter.GetIndex(), center);
+
+        double sum = 0;
+        double count = 0;
+        itk::ImageRegionConstIteratorWithIndex<ImageType> iter(m_Image, m_Image->GetLargestPossibleRegion());
+        while (!iter.IsAtEnd())
+        {
+          ImageType::PointType point;
+          m_Image->TransformIndexToPhysicalPoint(iter.GetIndex(), point);
+          if (center.EuclideanDistanceTo(point) < range)
+          {
+            sum += iter.Get();
+            count += 1;
+          }
+          ++iter;
+        }
+
+        double peak = sum / count;
+        globalPeak = std::max(globalPeak, peak);
+        if (centerIter.Get() == localMaximum)
+        {
+          localPeak = std::max(localPeak, peak);
+        }
+        else if (centerIter.Get() > localMaximum)
+        {
+          localMaximum = centerIter.Get();
+          localPeak = peak;
+        }
+      }
+      ++centerIter;
+    }
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Global intensity peak", globalPeak, filter->GetGlobalPeak(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Local intensity peak", localPeak, filter->GetLocalPeak(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Local maximum", localMaximum, filter->GetLocalMaximum(), 1e-6);
+  }
+
+public:
+
+  void setUp(void) override
+  {
+    m_Image = CreateImage<ImageType>();
+    m_Mask = CreateImage<MaskType>();
+    m_FullMask = CreateImage<MaskType>();
+    m_FullMask->FillBuffer(1);
+
+    // integer intensities with few distinct values, so that the local maximum has several peaks
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> intensity(-5, 5);
+    std::bernoulli_distribution masked(0.6);
+
+    itk::ImageRegionIterator<ImageType> imageIter(m_Image, m_Image->GetLargestPossibleRegion());
+    itk::ImageRegionIterator<MaskType> maskIter(m_Mask, m_Mask->GetLargestPossibleRegion());
+    while (!imageIter.IsAtEnd())
+    {
+      imageIter.Set(intensity(generator));
+      maskIter.Set(masked(generator) ? 1 : 0);
+      ++imageIter;
+      ++maskIter;
+    }
+
+    // one window without any masked voxel
+    for (long y = 0; y < 5; ++y)
+    {
+      for (long x = 0; x < 5; ++x)
+      {
+        MaskType::IndexType index = { { x, y, 0 } };
+        m_Mask->SetPixel(index, 0);
+      }
+    }
+  }
+
+  void tearDown(void) override
+  {
+    m_Image = nullptr;
+    m_Mask = nullptr;
+    m_FullMask = nullptr;
+  }
+
+  void LocalStatistic_WithoutMask_EqualsBruteForce()
+  {
+    CompareLocalStatistic(nullptr);
+  }
+
+  void LocalStatistic_WithMask_EqualsBruteForce()
+  {
+    CompareLocalStatistic(m_Mask);
+  }
+
+  void LocalIntensity_FullMask_EqualsBruteForce()
+  {
+    CompareLocalIntensity(m_FullMask);
+  }
+
+  void LocalIntensity_WithMask_EqualsBruteForce()
+  {
+    CompareLocalIntensity(m_Mask);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLocalStatisticFilter)
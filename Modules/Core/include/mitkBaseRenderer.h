@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDataStorage.h"
 #include "mitkPlaneGeometry.h"
 #include "mitkPlaneGeometryData.h"
+#include "mitkPropertyKey.h"
 #include "mitkSliceNavigationController.h"
 #include "mitkTimeGeometry.h"
 
@@ -344,6 +345,10 @@ namespace mitk
       return m_Name.c_str();
     }
 
+    //##Documentation
+    //## @brief get the interned name of the Renderer, identifies its PropertyList in a DataNode
+    const PropertyKey &GetNameKey() const { return m_NameKey; }
+
     //##Documentation
     //## @brief get the x_size of the RendererWindow
     //## @note
@@ -529,6 +534,8 @@ namespace mitk
 
     std::string m_Name;
 
+    PropertyKey m_NameKey;
+
     double m_Bounds[6];
 
     bool m_EmptyWorldGeometry;
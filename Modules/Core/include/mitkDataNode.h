@@ -242,6 +242,16 @@ namespace mitk
      */
     mitk::BaseProperty *GetProperty(const char *propertyKey, const mitk::BaseRenderer *renderer = nullptr, bool fallBackOnDataProperties = true) const;
 
+    /**
+     * \brief Like GetProperty(const char *, const mitk::BaseRenderer *, bool), but with an interned key.
+     *
+     * Neither compares nor allocates strings, the PropertyList of the \a renderer is found by
+     * the interned name of the renderer. Use this for lookups in every rendering pass.
+     *
+     * \sa PropertyKey
+     */
+    mitk::BaseProperty *GetProperty(const PropertyKey &propertyKey, const mitk::BaseRenderer *renderer = nullptr, bool fallBackOnDataProperties = true) const;
+
     /**
      * \brief Get the property of type T with key \a propertyKey from the PropertyList
      * of the \a renderer, if available there, otherwise use the BaseRenderer-independent PropertyList.
@@ -280,6 +290,17 @@ namespace mitk
       return property != nullptr;
     }
 
+    /**
+     * \brief Get the property of type T with the interned key \a propertyKey.
+     * \sa GetProperty(const PropertyKey &, const mitk::BaseRenderer *, bool)
+     */
+    template <typename T>
+    bool GetProperty(T *&property, const PropertyKey &propertyKey, const mitk::BaseRenderer *renderer = nullptr) const
+    {
+      property = dynamic_cast<T *>(GetProperty(propertyKey, renderer));
+      return property != nullptr;
+    }
+
     /**
      * \brief Convenience access method for GenericProperty<T> properties
      * (T being the type of the second parameter)
@@ -307,6 +328,9 @@ namespace mitk
      */
     bool GetBoolProperty(const char *propertyKey, bool &boolValue, const mitk::BaseRenderer *renderer = nullptr) const;
 
+    /** \brief GetBoolProperty() with an interned key */
+    bool GetBoolProperty(const PropertyKey &propertyKey, bool &boolValue, const mitk::BaseRenderer *renderer = nullptr) const;
+
     /**
      * \brief Convenience access method for int properties (instances of
      * IntProperty)
@@ -314,6 +338,9 @@ namespace mitk
      */
     bool GetIntProperty(const char *propertyKey, int &intValue, const mitk::BaseRenderer *renderer = nullptr) const;
 
+    /** \brief GetIntProperty() with an interned key */
+    bool GetIntProperty(const PropertyKey &propertyKey, int &intValue, const mitk::BaseRenderer *renderer = nullptr) const;
+
     /**
      * \brief Convenience access method for float properties (instances of
      * FloatProperty)
@@ -323,6 +350,11 @@ namespace mitk
                           float &floatValue,
                           const mitk::BaseRenderer *renderer = nullptr) const;
 
+    /** \brief GetFloatProperty() with an interned key */
+    bool GetFloatProperty(const PropertyKey &propertyKey,
+                          float &floatValue,
+                          const mitk::BaseRenderer *renderer = nullptr) const;
+
     /**
      * \brief Convenience access method for double properties (instances of
      * DoubleProperty)
@@ -594,6 +626,9 @@ namespace mitk
     /// \brief Map associating each BaseRenderer with its own PropertyList
     mutable MapOfPropertyLists m_MapOfPropertyLists;
 
+    /// \brief The lists of m_MapOfPropertyLists sorted by the ID of the interned renderer name
+    mutable std::vector<std::pair<PropertyKey::IdType, PropertyList *>> m_PropertyListsByRenderer;
+
     DataInteractor::Pointer m_DataInteractor;
 
     /// \brief Timestamp of the last change of m_Data
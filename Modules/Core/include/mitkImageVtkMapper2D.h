@@ -23,6 +23,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 // MITK Rendering
 #include "mitkBaseRenderer.h"
 #include "mitkExtractSliceFilter.h"
+#include "mitkReslicedImageCache.h"
+#include "mitkSlidingThickSlab.h"
 #include "mitkVtkMapper.h"
 
 // VTK
@@ -56,6 +58,10 @@ namespace mitk
    * properties such as thick slices. This code was already present in the old version
    * (mitkImageMapperGL2D).
    *
+   * Resliced slices are kept in a ReslicedImageCache which is shared by all render windows
+   * showing the image. While scrolling, the next slices in scroll direction are resliced in
+   * the background. Thick slices are not cached.
+   *
    * Next, the obtained slice (m_ReslicedImage) is put into a vtkMitkLevelWindowFilter
    * and the scalar levelwindow, opacity levelwindow and optional clipping to
    * local image bounds are applied
@@ -176,6 +182,8 @@ namespace mitk
       mitk::ExtractSliceFilter::Pointer m_Reslicer;
       /** \brief Filter for thick slices */
       vtkSmartPointer<vtkMitkThickSlicesFilter> m_TSFilter;
+      /** \brief Thick slices of plane geometries, reuses the slab while scrolling */
+      mitk::SlidingThickSlab m_ThickSlab;
       /** \brief PolyData object containg all lines/points needed for outlining the contour.
             This container is used to save a computed contour for the next rendering execution.
             For instance, if you zoom or pann, there is no need to recompute the contour. */
@@ -187,6 +195,12 @@ namespace mitk
       /** \brief mmPerPixel relation between pixel and mm. (World spacing).*/
       mitk::ScalarType *m_mmPerPixel;
 
+      /** \brief Reslice axes of m_ReslicedImage, used to transform the actor. */
+      vtkSmartPointer<vtkMatrix4x4> m_ResliceAxes;
+
+      /** \brief Slice of the renderer at the last update, gives the scroll direction for prefetching. */
+      int m_LastSlice;
+
       /** \brief This filter is used to apply the level window to Grayvalue and RBG(A) images. */
       vtkSmartPointer<vtkMitkLevelWindowFilter> m_LevelWindowFilter;
 
@@ -202,6 +216,9 @@ namespace mitk
     /** \brief Get the LocalStorage corresponding to the current renderer. */
     LocalStorage *GetLocalStorage(mitk::BaseRenderer *renderer);
 
+    /** \brief Resliced slices of the image that are shared by all render windows. */
+    ReslicedImageCache &GetReslicedImageCache();
+
     /** \brief Set the default properties for general image rendering. */
     static void SetDefaultProperties(mitk::DataNode *node, mitk::BaseRenderer *renderer = nullptr, bool overwrite = false);
 
@@ -235,7 +252,7 @@ namespace mitk
 
     /** \brief Generates a vtkPolyData object containing the outline of a given binary slice.
         \param renderer: Pointer to the renderer containing the needed information
-        \note This code is based on code from the iil library.
+        \note The outline consists of one polyline per connected boundary, see mitk::LabelOutlineTracer.
         */
     template <typename TPixel>
     vtkSmartPointer<vtkPolyData> CreateOutlinePolyData(mitk::BaseRenderer *renderer);
@@ -303,6 +320,14 @@ namespace mitk
       * If the distances have different sign, there is an intersection.
       **/
     bool RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry, SlicedGeometry3D *imageGeometry);
+
+    /** \brief Extracts the next slices in scroll direction of the renderer in the background. */
+    void PrefetchSlices(mitk::BaseRenderer *renderer,
+                        ExtractSliceFilter::ResliceInterpolation interpolationMode,
+                        bool inPlaneResampleExtentByGeometry);
+
+  private:
+    ReslicedImageCache m_ReslicedImageCache;
   };
 
 } // namespace mitk
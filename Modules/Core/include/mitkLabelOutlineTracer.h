@@ -0,0 +1,91 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkLabelOutlineTracer_h
+#define mitkLabelOutlineTracer_h
+
+#include <MitkCoreExports.h>
+
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief Traces the outlines of the labels of a 2D slice along the pixel edges.
+   *
+   * The boundary edges of all labels are determined in one pass over the slice (in parallel row
+   * bands) and then walked into closed polylines, one per connected boundary of a label. Collinear
+   * edges are merged, so a polyline only contains its corners. Pixels of the same label that only
+   * touch at a corner get separate outlines.
+   *
+   * The points are given in pixel units, pixel (x,y) covers [x,x+1]x[y,y+1]. Each polyline ends with
+   * its first point.
+   *
+   * The tracer does not depend on VTK; ImageVtkMapper2D and LabelSetImageVtkMapper2D convert the result
+   * into their outline poly data.
+   *
+   * \ingroup Rendering
+   */
+  class MITKCORE_EXPORT LabelOutlineTracer
+  {
+  public:
+    typedef long LabelType;
+
+    /** Defines which pixels form the regions whose outlines are traced. */
+    enum ModeType
+    {
+      AllLabels,   ///< every value except 0 is a label of its own
+      NonZero,     ///< all values except 0 form one region with label 1 (binary images)
+      SingleLabel  ///< only the pixels with the given label (which may be 0)
+    };
+
+    struct Outlines
+    {
+      /** x and y of all points */
+      std::vector<float> Points;
+      /** polyline i consists of the points [LineOffsets[i], LineOffsets[i + 1]) */
+      std::vector<unsigned int> LineOffsets;
+      /** label of each polyline */
+      std::vector<LabelType> LineLabels;
+
+      std::size_t GetNumberOfPoints() const { return Points.size() / 2; }
+      std::size_t GetNumberOfLines() const { return LineLabels.size(); }
+    };
+
+    /**
+     * \brief Traces the outlines of a row major slice of width x height values.
+     * \param label The traced label if mode is SingleLabel, otherwise ignored.
+     * \param numberOfThreads Number of row bands processed in parallel. 0 uses the number of cores.
+     */
+    static void Trace(const unsigned char *values,
+                      unsigned int width,
+                      unsigned int height,
+                      Outlines &outlines,
+                      ModeType mode = AllLabels,
+                      LabelType label = 0,
+                      unsigned int numberOfThreads = 0);
+
+    static void Trace(const unsigned short *values,
+                      unsigned int width,
+                      unsigned int height,
+                      Outlines &outlines,
+                      ModeType mode = AllLabels,
+                      LabelType label = 0,
+                      unsigned int numberOfThreads = 0);
+  };
+}
+
+#endif
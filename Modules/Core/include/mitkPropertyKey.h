@@ -0,0 +1,75 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkPropertyKey_h
+#define mitkPropertyKey_h
+
+#include <MitkCoreExports.h>
+
+#include <string>
+
+namespace mitk
+{
+  /**
+   * \brief Interned property key.
+   *
+   * All keys with the same string share one ID in a process-wide table, so that comparing
+   * keys is comparing integers. Creating a key from a string looks it up in the table (and
+   * adds it if necessary), so code that queries properties repeatedly should create its keys
+   * once, e.g. as function-local statics:
+   *
+   * \code
+   * static const mitk::PropertyKey visibleKey("visible");
+   * node->GetBoolProperty(visibleKey, visible, renderer);
+   * \endcode
+   *
+   * Keys are never removed from the table. The default key is the empty string.
+   *
+   * \ingroup DataManagement
+   */
+  class MITKCORE_EXPORT PropertyKey
+  {
+  public:
+    typedef unsigned int IdType;
+
+    PropertyKey();
+    explicit PropertyKey(const char *key);
+    explicit PropertyKey(const std::string &key);
+
+    /**
+     * \brief Looks up the key of a string without adding it to the table.
+     *
+     * \return false if no key was created for the string yet, which means that no
+     * PropertyList contains a property of that name.
+     */
+    static bool Find(const std::string &key, PropertyKey &result);
+
+    IdType GetId() const { return m_Id; }
+    const std::string &GetString() const { return *m_String; }
+
+    bool operator==(const PropertyKey &other) const { return m_Id == other.m_Id; }
+    bool operator!=(const PropertyKey &other) const { return m_Id != other.m_Id; }
+    /** \brief Order of creation, not the order of the strings */
+    bool operator<(const PropertyKey &other) const { return m_Id < other.m_Id; }
+
+  private:
+    IdType m_Id;
+    /** points into the table, the strings are never moved */
+    const std::string *m_String;
+  };
+}
+
+#endif
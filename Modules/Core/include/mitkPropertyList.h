@@ -21,12 +21,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkGenericProperty.h"
 #include "mitkUIDGenerator.h"
 #include "mitkIPropertyOwner.h"
+#include "mitkPropertyKey.h"
 #include <MitkCoreExports.h>
 
 #include <itkObjectFactory.h>
 
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace mitk
 {
@@ -63,6 +66,10 @@ namespace mitk
    * Please also regard, that the key of a property must be a none empty string.
    * This is a precondition. Setting properties with empty keys will raise an exception.
    *
+   * Besides the map, the list keeps an index of its properties sorted by their interned PropertyKey.
+   * GetProperty(const PropertyKey &) searches this index without comparing or allocating strings,
+   * the string based getters look up the key and use the index as well.
+   *
    * @ingroup DataManagement
    */
   class MITKCORE_EXPORT PropertyList : public itk::Object, public IPropertyOwner
@@ -97,6 +104,11 @@ namespace mitk
      */
     mitk::BaseProperty *GetProperty(const std::string &propertyKey) const;
 
+    /**
+     * @brief Get a property by its interned key.
+     */
+    mitk::BaseProperty *GetProperty(const PropertyKey &propertyKey) const;
+
     /**
      * @brief Set a property object in the list/map by reference.
      *
@@ -249,7 +261,17 @@ namespace mitk
     PropertyMap m_Properties;
 
   private:
+    typedef std::vector<std::pair<PropertyKey, BaseProperty *>> PropertyIndex;
+
     itk::LightObject::Pointer InternalClone() const override;
+
+    void AddToIndex(const std::string &propertyKey, BaseProperty *property);
+    void RemoveFromIndex(const std::string &propertyKey);
+
+    /**
+     * @brief The properties of m_Properties sorted by the IDs of their keys.
+     */
+    PropertyIndex m_PropertyIndex;
   };
 
 } // namespace mitk
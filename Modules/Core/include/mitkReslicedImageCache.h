@@ -0,0 +1,160 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkReslicedImageCache_h
+#define mitkReslicedImageCache_h
+
+#include <MitkCoreExports.h>
+
+#include <mitkExtractSliceFilter.h>
+#include <mitkImage.h>
+#include <mitkPlaneGeometry.h>
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+
+#include <atomic>
+#include <future>
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief LRU cache of resliced (not yet level windowed) slices of one image.
+   *
+   * Used by ImageVtkMapper2D so that scrolling back to a slice or showing the same plane in
+   * several views does not reslice the image again. Slices are identified by the parameters
+   * of the plane geometry, the geometry of the image, the time step and the reslice settings.
+   * All slices are dropped when the image is modified.
+   *
+   * Prefetch() extracts further slices on a background thread. The thread reads the image
+   * via an ImageReadAccessor and uses its own ExtractSliceFilter, so it does not interfere
+   * with the rendering pipeline.
+   *
+   * \ingroup Renderer
+   */
+  class MITKCORE_EXPORT ReslicedImageCache
+  {
+  public:
+    typedef std::vector<double> KeyType;
+
+    struct Slice
+    {
+      /** \brief The output of the ExtractSliceFilter, must not be modified */
+      vtkSmartPointer<vtkImageData> Image;
+      /** \brief ExtractSliceFilter::GetOutputSpacing() */
+      mitk::ScalarType Spacing[2];
+      /** \brief ExtractSliceFilter::GetResliceAxes() */
+      vtkSmartPointer<vtkMatrix4x4> ResliceAxes;
+    };
+
+    /** \brief Memory budget of new caches in bytes (64 MB by default) */
+    static void SetDefaultMemoryBudget(std::size_t bytes);
+    static std::size_t GetDefaultMemoryBudget();
+
+    static KeyType CreateKey(const Image *image,
+                             unsigned int timeStep,
+                             const PlaneGeometry *planeGeometry,
+                             ExtractSliceFilter::ResliceInterpolation interpolationMode,
+                             bool inPlaneResampleExtentByGeometry);
+
+    /** \brief Copies the current output of the filter into a Slice */
+    static Slice CreateSlice(ExtractSliceFilter *filter);
+
+    ReslicedImageCache();
+    /** \brief Waits for a running prefetch */
+    ~ReslicedImageCache();
+
+    /** \brief A budget of 0 disables the cache */
+    void SetMemoryBudget(std::size_t bytes);
+    std::size_t GetMemoryBudget() const;
+    std::size_t GetMemoryUsage() const;
+    std::size_t GetNumberOfSlices() const;
+
+    /** \brief Drops all slices if they were not extracted from the current state of the image */
+    void SetImage(const Image *image);
+
+    bool Get(const KeyType &key, Slice &slice);
+    void Add(const KeyType &key, const Slice &slice);
+    void Clear();
+
+    /**
+     * \brief Extracts the slices of the planes that are not cached yet on a background thread.
+     *
+     * Does nothing while a previous prefetch is still running. The planes are copied, the image
+     * must be the one passed to SetImage().
+     */
+    void Prefetch(const Image *image,
+                  unsigned int timeStep,
+                  const std::vector<PlaneGeometry::ConstPointer> &planes,
+                  ExtractSliceFilter::ResliceInterpolation interpolationMode,
+                  bool inPlaneResampleExtentByGeometry);
+
+    /** \brief Blocks until the running prefetch is finished */
+    void WaitForPrefetch();
+
+  private:
+    struct Entry
+    {
+      KeyType Key;
+      Slice Data;
+      std::size_t Size;
+    };
+
+    struct PrefetchJob
+    {
+      Image::ConstPointer SourceImage;
+      ImageDataItem::Pointer Volume;
+      Image::Pointer View;
+      unsigned int TimeStep;
+      unsigned long ImageMTime;
+      ExtractSliceFilter::ResliceInterpolation InterpolationMode;
+      bool InPlaneResampleExtentByGeometry;
+      std::vector<KeyType> Keys;
+      std::vector<PlaneGeometry::Pointer> Planes;
+      std::vector<BaseGeometry::Pointer> ReferenceGeometries;
+    };
+
+    ReslicedImageCache(const ReslicedImageCache &) = delete;
+    ReslicedImageCache &operator=(const ReslicedImageCache &) = delete;
+
+    static unsigned long GetImageMTime(const Image *image);
+
+    void RunPrefetch(const PrefetchJob &job);
+    void AddUnlocked(const KeyType &key, const Slice &slice);
+    void ShrinkUnlocked(std::size_t budget);
+
+    mutable std::mutex m_Mutex;
+    std::list<Entry> m_Entries;
+    std::map<KeyType, std::list<Entry>::iterator> m_Index;
+    std::size_t m_MemoryBudget;
+    std::size_t m_MemoryUsage;
+
+    const Image *m_Image;
+    unsigned long m_ImageMTime;
+
+    std::future<void> m_Prefetch;
+    std::atomic<bool> m_CancelPrefetch;
+
+    static std::size_t s_DefaultMemoryBudget;
+  };
+}
+
+#endif
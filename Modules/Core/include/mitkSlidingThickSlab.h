@@ -0,0 +1,137 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkSlidingThickSlab_h
+#define mitkSlidingThickSlab_h
+
+#include <MitkCoreExports.h>
+
+#include <mitkExtractSliceFilter.h>
+#include <mitkReslicedImageCache.h>
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief Computes thick slices like vtkMitkThickSlicesFilter and reuses the slab when the plane is moved.
+   *
+   * The resliced planes of the slab are kept in a ring buffer. If the plane moves by whole slab
+   * planes along its normal, only the planes that enter the slab are resliced:
+   *
+   *   - SUM and MEAN keep the running sum of all planes,
+   *   - MIP and MINIP keep a binary tree of the maxima (minima) of the ring slots, so that replacing
+   *     one plane costs log2(number of planes) passes,
+   *   - WEIGHTED combines the stored planes again, as the weights depend on the distance to the plane.
+   *
+   * Whether the old planes can be reused is checked with the reslice axes of the new planes. All loops
+   * run over whole planes and can be vectorized by the compiler.
+   *
+   * \ingroup Renderer
+   */
+  class MITKCORE_EXPORT SlidingThickSlab
+  {
+  public:
+    SlidingThickSlab();
+    ~SlidingThickSlab();
+
+    /**
+     * \brief Returns the thick slice of the plane.
+     *
+     * The reslicer has to be set up for the plane like for a single slice; its output dimensionality,
+     * z spacing and z extent are set here.
+     *
+     * \param sliceSpacing distance of the slab planes in mm
+     * \param mode one of the modes of vtkMitkThickSlicesFilter
+     * \param numberOfSlices number of slab planes on each side of the plane
+     */
+    vtkImageData *Update(ExtractSliceFilter *reslicer,
+                         const Image *image,
+                         unsigned int timeStep,
+                         const PlaneGeometry *plane,
+                         ExtractSliceFilter::ResliceInterpolation interpolationMode,
+                         bool inPlaneResampleExtentByGeometry,
+                         double sliceSpacing,
+                         int mode,
+                         int numberOfSlices);
+
+    /** \brief Reslice axes of the current plane, see ExtractSliceFilter::GetResliceAxes() */
+    vtkMatrix4x4 *GetResliceAxes();
+
+    /** \brief In-plane spacing of the current plane, see ExtractSliceFilter::GetOutputSpacing() */
+    const mitk::ScalarType *GetOutputSpacing() const;
+
+    /** \brief Number of planes that were resliced by the last call of Update() */
+    int GetNumberOfReslicedPlanes() const;
+
+    /** \brief Forgets the slab, the next Update() reslices all planes */
+    void Reset();
+
+  private:
+    SlidingThickSlab(const SlidingThickSlab &) = delete;
+    SlidingThickSlab &operator=(const SlidingThickSlab &) = delete;
+
+    void Reslice(ExtractSliceFilter *reslicer, int zMin, int zMax);
+    void BuildSlab(vtkImageData *slab);
+    bool ShiftSlab(vtkImageData *slab, vtkMatrix4x4 *resliceAxes, long shift);
+
+    int GetSlot(long plane) const;
+    void *GetPlane(long plane);
+    void CopyPlane(vtkImageData *slab, int z, void *target) const;
+
+    void ComputeAggregate();
+    void UpdateTreePath(int slot);
+    void UpdateTreeNode(int node);
+    bool IsTreeNodeEmpty(int node) const;
+    void *GetTreeNode(int node);
+    void WriteOutput();
+
+    vtkSmartPointer<vtkImageData> m_Output;
+    vtkSmartPointer<vtkMatrix4x4> m_ResliceAxes;
+    mitk::ScalarType m_OutputSpacing[2];
+
+    /** plane p (relative to the plane of the last full reslice) is stored in slot p mod number of planes */
+    std::vector<vtkSmartPointer<vtkDataArray>> m_Planes;
+    /** inner nodes of the MIP / MINIP tree, node 1 is the root, the leaves are the slots of m_Planes */
+    std::vector<vtkSmartPointer<vtkDataArray>> m_TreeNodes;
+    int m_NumberOfTreeLeaves;
+    /** sum of the planes for SUM and MEAN (kept up to date for integer types), weighted sum for WEIGHTED */
+    std::vector<double> m_Sum;
+
+    long m_Center;
+    double m_Position;
+    int m_Extent[6];
+    int m_ScalarType;
+    vtkIdType m_PlaneSize;
+    int m_NumberOfReslicedPlanes;
+
+    bool m_Valid;
+    ReslicedImageCache::KeyType m_PlaneKey;
+    ReslicedImageCache::KeyType m_StateKey;
+    const Image *m_Image;
+    unsigned long m_ImageMTime;
+    double m_SliceSpacing;
+    int m_Mode;
+    int m_NumberOfSlices;
+  };
+}
+
+#endif
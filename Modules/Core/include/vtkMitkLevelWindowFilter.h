@@ -23,6 +23,9 @@ class vtkPiecewiseFunction;
 #include <vtkThreadedImageAlgorithm.h>
 
 #include <MitkCoreExports.h>
+
+#include <vector>
+
 /** Documentation
 * \brief Applies the grayvalue or color/opacity level window to scalar or RGB(A) images.
 *
@@ -33,6 +36,10 @@ class vtkPiecewiseFunction;
 *
 * The filter is also able to apply an opacity level window to RGBA images.
 *
+* Scalar images of 8 or 16 bit integer type are mapped through a table with one
+* RGBA entry for every possible pixel value, which is only recomputed when the
+* lookup table or the opacity function changes.
+*
 * \ingroup Renderer
 */
 class MITKCORE_EXPORT vtkMitkLevelWindowFilter : public vtkThreadedImageAlgorithm
@@ -80,6 +87,11 @@ protected:
    */
   void ThreadedExecute(vtkImageData *inData, vtkImageData *outData, int extent[6], int id) override;
 
+  /** \brief Builds the lookup table and the table for integer input once before the threads are started. */
+  int RequestData(vtkInformation *request,
+                  vtkInformationVector **inputVector,
+                  vtkInformationVector *outputVector) override;
+
   //  /** Standard VTK filter method to apply the filter. See VTK documentation.*/
   int RequestInformation(vtkInformation *request,
                          vtkInformationVector **inputVector,
@@ -98,5 +110,15 @@ private:
   double m_MaxOpacity;
 
   double m_ClippingBounds[4];
+
+  /** \brief Recomputes m_IntegerLookupTable if the input type, the lookup table or the opacity function changed. */
+  void UpdateIntegerLookupTable(vtkImageData *inData, vtkIdType numberOfPixels);
+
+  /** RGBA values (as ints) of all values of the 8 or 16 bit input type, empty if not used */
+  std::vector<int> m_IntegerLookupTable;
+  int m_IntegerLookupTableScalarType;
+  vtkScalarsToColors *m_IntegerLookupTableSource;
+  vtkPiecewiseFunction *m_IntegerLookupTableOpacity;
+  vtkMTimeType m_IntegerLookupTableMTime;
 };
 #endif
@@ -31,6 +31,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLevelWindowProperty.h"
 #include "mitkRenderingManager.h"
 
+#include <algorithm>
+
+namespace
+{
+  typedef std::pair<mitk::PropertyKey::IdType, mitk::PropertyList *> RendererPropertyListEntry;
+
+  bool HasLowerRendererId(const RendererPropertyListEntry &entry, mitk::PropertyKey::IdType id)
+  {
+    return entry.first < id;
+  }
+}
+
 mitk::Mapper *mitk::DataNode::GetMapper(MapperSlotId id) const
 {
   if ((id >= m_Mappers.size()) || (m_Mappers[id].IsNull()))
@@ -208,8 +220,17 @@ mitk::PropertyList *mitk::DataNode::GetPropertyList(const std::string &rendererN
   mitk::PropertyList::Pointer &propertyList = m_MapOfPropertyLists[rendererName];
 
   if (propertyList.IsNull())
+  {
     propertyList = mitk::PropertyList::New();
 
+    const PropertyKey rendererKey(rendererName);
+    m_PropertyListsByRenderer.insert(std::lower_bound(m_PropertyListsByRenderer.begin(),
+                                                      m_PropertyListsByRenderer.end(),
+                                                      rendererKey.GetId(),
+                                                      HasLowerRendererId),
+                                     std::make_pair(rendererKey.GetId(), propertyList.GetPointer()));
+  }
+
   assert(m_MapOfPropertyLists[rendererName].IsNotNull());
 
   return propertyList;
@@ -225,11 +246,23 @@ mitk::BaseProperty *mitk::DataNode::GetProperty(const char *propertyKey, const m
   if (nullptr == propertyKey)
     return nullptr;
 
+  // a key that was never interned cannot be in any list
+  PropertyKey key;
+  if (!PropertyKey::Find(propertyKey, key))
+    return nullptr;
+
+  return this->GetProperty(key, renderer, fallBackOnDataProperties);
+}
+
+mitk::BaseProperty *mitk::DataNode::GetProperty(const PropertyKey &propertyKey, const mitk::BaseRenderer *renderer, bool fallBackOnDataProperties) const
+{
   if (nullptr != renderer)
   {
-    auto it = m_MapOfPropertyLists.find(renderer->GetName());
+    const PropertyKey::IdType rendererId = renderer->GetNameKey().GetId();
+    auto it = std::lower_bound(
+      m_PropertyListsByRenderer.cbegin(), m_PropertyListsByRenderer.cend(), rendererId, HasLowerRendererId);
 
-    if (m_MapOfPropertyLists.end() != it)
+    if (m_PropertyListsByRenderer.cend() != it && it->first == rendererId)
     {
       auto property = it->second->GetProperty(propertyKey);
 
@@ -241,7 +274,7 @@ mitk::BaseProperty *mitk::DataNode::GetProperty(const char *propertyKey, const m
   auto property = m_PropertyList->GetProperty(propertyKey);
 
   if (nullptr == property && fallBackOnDataProperties && m_Data.IsNotNull())
-    property = m_Data->GetProperty(propertyKey);
+    property = m_Data->GetPropertyList()->GetProperty(propertyKey);
 
   return property;
 }
@@ -276,6 +309,16 @@ bool mitk::DataNode::GetBoolProperty(const char *propertyKey, bool &boolValue, c
   return true;
 }
 
+bool mitk::DataNode::GetBoolProperty(const PropertyKey &propertyKey, bool &boolValue, const mitk::BaseRenderer *renderer) const
+{
+  auto boolprop = dynamic_cast<mitk::BoolProperty *>(GetProperty(propertyKey, renderer));
+  if (boolprop == nullptr)
+    return false;
+
+  boolValue = boolprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetIntProperty(const char *propertyKey, int &intValue, const mitk::BaseRenderer *renderer) const
 {
   mitk::IntProperty::Pointer intprop = dynamic_cast<mitk::IntProperty *>(GetProperty(propertyKey, renderer));
@@ -286,6 +329,16 @@ bool mitk::DataNode::GetIntProperty(const char *propertyKey, int &intValue, cons
   return true;
 }
 
+bool mitk::DataNode::GetIntProperty(const PropertyKey &propertyKey, int &intValue, const mitk::BaseRenderer *renderer) const
+{
+  auto intprop = dynamic_cast<mitk::IntProperty *>(GetProperty(propertyKey, renderer));
+  if (intprop == nullptr)
+    return false;
+
+  intValue = intprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetFloatProperty(const char *propertyKey,
                                       float &floatValue,
                                       const mitk::BaseRenderer *renderer) const
@@ -298,6 +351,18 @@ bool mitk::DataNode::GetFloatProperty(const char *propertyKey,
   return true;
 }
 
+bool mitk::DataNode::GetFloatProperty(const PropertyKey &propertyKey,
+                                      float &floatValue,
+                                      const mitk::BaseRenderer *renderer) const
+{
+  auto floatprop = dynamic_cast<mitk::FloatProperty *>(GetProperty(propertyKey, renderer));
+  if (floatprop == nullptr)
+    return false;
+
+  floatValue = floatprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetDoubleProperty(const char *propertyKey,
                                        double &doubleValue,
                                        const mitk::BaseRenderer *renderer) const
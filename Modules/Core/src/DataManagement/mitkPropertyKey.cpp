@@ -0,0 +1,88 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPropertyKey.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace
+{
+  struct PropertyKeyTable
+  {
+    PropertyKeyTable() : EmptyKey(&Ids.emplace(std::string(), 0).first->first) {}
+
+    /** lookups of existing keys, which are by far the most frequent, only take a shared lock */
+    std::shared_timed_mutex Mutex;
+    /** node based, so the keys keep their address when the table grows */
+    std::unordered_map<std::string, mitk::PropertyKey::IdType> Ids;
+    const std::string *EmptyKey;
+  };
+
+  PropertyKeyTable &GetPropertyKeyTable()
+  {
+    static PropertyKeyTable table;
+    return table;
+  }
+
+  const std::string *Intern(const std::string &key, mitk::PropertyKey::IdType &id)
+  {
+    PropertyKeyTable &table = GetPropertyKeyTable();
+    {
+      std::shared_lock<std::shared_timed_mutex> lock(table.Mutex);
+      auto iter = table.Ids.find(key);
+      if (iter != table.Ids.end())
+      {
+        id = iter->second;
+        return &iter->first;
+      }
+    }
+
+    std::lock_guard<std::shared_timed_mutex> lock(table.Mutex);
+    auto iter = table.Ids.emplace(key, static_cast<mitk::PropertyKey::IdType>(table.Ids.size())).first;
+    id = iter->second;
+    return &iter->first;
+  }
+}
+
+mitk::PropertyKey::PropertyKey() : m_Id(0), m_String(GetPropertyKeyTable().EmptyKey)
+{
+}
+
+mitk::PropertyKey::PropertyKey(const char *key)
+{
+  m_String = Intern(key != nullptr ? std::string(key) : std::string(), m_Id);
+}
+
+mitk::PropertyKey::PropertyKey(const std::string &key)
+{
+  m_String = Intern(key, m_Id);
+}
+
+bool mitk::PropertyKey::Find(const std::string &key, PropertyKey &result)
+{
+  PropertyKeyTable &table = GetPropertyKeyTable();
+  std::shared_lock<std::shared_timed_mutex> lock(table.Mutex);
+
+  auto iter = table.Ids.find(key);
+  if (iter == table.Ids.end())
+    return false;
+
+  result.m_Id = iter->second;
+  result.m_String = &iter->first;
+  return true;
+}
@@ -20,15 +20,19 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkProperties.h"
 #include "mitkStringProperty.h"
 
-mitk::BaseProperty::ConstPointer mitk::PropertyList::GetConstProperty(const std::string &propertyKey, const std::string &/*contextName*/, bool /*fallBackOnDefaultContext*/) const
+#include <algorithm>
+
+namespace
 {
-  PropertyMap::const_iterator it;
+  bool HasLowerKeyId(const std::pair<mitk::PropertyKey, mitk::BaseProperty *> &entry, mitk::PropertyKey::IdType id)
+  {
+    return entry.first.GetId() < id;
+  }
+}
 
-  it = m_Properties.find(propertyKey);
-  if (it != m_Properties.cend())
-    return it->second.GetPointer();
-  else
-    return nullptr;
+mitk::BaseProperty::ConstPointer mitk::PropertyList::GetConstProperty(const std::string &propertyKey, const std::string &/*contextName*/, bool /*fallBackOnDefaultContext*/) const
+{
+  return this->GetProperty(propertyKey);
 };
 
 std::vector<std::string> mitk::PropertyList::GetPropertyKeys(const std::string &contextName, bool includeDefaultContext) const
@@ -51,15 +55,47 @@ std::vector<std::string> mitk::PropertyList::GetPropertyContextNames() const
 
 mitk::BaseProperty *mitk::PropertyList::GetProperty(const std::string &propertyKey) const
 {
-  PropertyMap::const_iterator it;
+  // a key that was never interned cannot be in any list
+  PropertyKey key;
+  if (!PropertyKey::Find(propertyKey, key))
+    return nullptr;
 
-  it = m_Properties.find(propertyKey);
-  if (it != m_Properties.cend())
+  return this->GetProperty(key);
+}
+
+mitk::BaseProperty *mitk::PropertyList::GetProperty(const PropertyKey &propertyKey) const
+{
+  auto it = std::lower_bound(m_PropertyIndex.cbegin(), m_PropertyIndex.cend(), propertyKey.GetId(), HasLowerKeyId);
+
+  if (it != m_PropertyIndex.cend() && it->first == propertyKey)
     return it->second;
   else
     return nullptr;
 }
 
+void mitk::PropertyList::AddToIndex(const std::string &propertyKey, BaseProperty *property)
+{
+  PropertyKey key(propertyKey);
+  auto it = std::lower_bound(m_PropertyIndex.begin(), m_PropertyIndex.end(), key.GetId(), HasLowerKeyId);
+
+  if (it != m_PropertyIndex.end() && it->first == key)
+    it->second = property;
+  else
+    m_PropertyIndex.insert(it, std::make_pair(key, property));
+}
+
+void mitk::PropertyList::RemoveFromIndex(const std::string &propertyKey)
+{
+  PropertyKey key;
+  if (!PropertyKey::Find(propertyKey, key))
+    return;
+
+  auto it = std::lower_bound(m_PropertyIndex.begin(), m_PropertyIndex.end(), key.GetId(), HasLowerKeyId);
+
+  if (it != m_PropertyIndex.end() && it->first == key)
+    m_PropertyIndex.erase(it);
+}
+
 mitk::BaseProperty * mitk::PropertyList::GetNonConstProperty(const std::string &propertyKey, const std::string &/*contextName*/, bool /*fallBackOnDefaultContext*/)
 {
   return this->GetProperty(propertyKey);
@@ -108,6 +144,7 @@ void mitk::PropertyList::SetProperty(const std::string &propertyKey, BasePropert
 
   // no? add it.
   m_Properties.insert(PropertyMap::value_type(propertyKey, property));
+  this->AddToIndex(propertyKey, property);
   this->Modified();
 }
 
@@ -127,6 +164,7 @@ void mitk::PropertyList::ReplaceProperty(const std::string &propertyKey, BasePro
 
   // no? add/replace it.
   m_Properties.insert(PropertyMap::value_type(propertyKey, property));
+  this->AddToIndex(propertyKey, property);
   Modified();
 }
 
@@ -139,6 +177,7 @@ void mitk::PropertyList::RemoveProperty(const std::string &propertyKey, const st
   {
     it->second = nullptr;
     m_Properties.erase(it);
+    this->RemoveFromIndex(propertyKey);
     Modified();
   }
 }
@@ -149,9 +188,13 @@ mitk::PropertyList::PropertyList()
 
 mitk::PropertyList::PropertyList(const mitk::PropertyList &other) : itk::Object()
 {
-  for (auto i = other.m_Properties.cbegin(); i != other.m_Properties.cend(); ++i)
+  // the index of the other list is already sorted
+  m_PropertyIndex.reserve(other.m_PropertyIndex.size());
+  for (auto i = other.m_PropertyIndex.cbegin(); i != other.m_PropertyIndex.cend(); ++i)
   {
-    m_Properties.insert(std::make_pair(i->first, i->second->Clone()));
+    BaseProperty::Pointer property = i->second->Clone();
+    m_Properties.insert(std::make_pair(i->first.GetString(), property));
+    m_PropertyIndex.push_back(std::make_pair(i->first, property.GetPointer()));
   }
 }
 
@@ -190,6 +233,7 @@ bool mitk::PropertyList::DeleteProperty(const std::string &propertyKey)
   {
     it->second = nullptr;
     m_Properties.erase(it);
+    this->RemoveFromIndex(propertyKey);
     Modified();
     return true;
   }
@@ -205,6 +249,7 @@ void mitk::PropertyList::Clear()
     ++it;
   }
   m_Properties.clear();
+  m_PropertyIndex.clear();
 }
 
 itk::LightObject::Pointer mitk::PropertyList::InternalClone() const
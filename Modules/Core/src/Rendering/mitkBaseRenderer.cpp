@@ -137,6 +137,7 @@ mitk::BaseRenderer::BaseRenderer(const char *name,
     m_Name = "unnamed renderer";
     itkWarningMacro(<< "Created unnamed renderer. Bad for serialization. Please choose a name.");
   }
+  m_NameKey = PropertyKey(m_Name);
 
   if (renWin != nullptr)
   {
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkAbstractTransformGeometry.h>
 #include <mitkDataNode.h>
 #include <mitkImageSliceSelector.h>
+#include <mitkLabelOutlineTracer.h>
 #include <mitkLevelWindowProperty.h>
 #include <mitkLookupTableProperty.h>
 #include <mitkPixelType.h>
@@ -59,6 +60,34 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+// STL
+#include <algorithm>
+
+namespace
+{
+  // interned once, the mapper queries these properties in every rendering pass
+  const mitk::PropertyKey LayerKey("layer");
+  const mitk::PropertyKey ResampleExtentByGeometryKey("in plane resample extent by geometry");
+  const mitk::PropertyKey ResliceInterpolationKey("reslice interpolation");
+  const mitk::PropertyKey ThickSlicesModeKey("reslice.thickslices");
+  const mitk::PropertyKey ThickSlicesNumKey("reslice.thickslices.num");
+  const mitk::PropertyKey BinaryKey("binary");
+  const mitk::PropertyKey OutlineBinaryKey("outline binary");
+  const mitk::PropertyKey OutlineWidthKey("outline width");
+  const mitk::PropertyKey OutlineShadowWidthKey("outline shadow width");
+  const mitk::PropertyKey DisplayedComponentKey("Image.Displayed Component");
+  const mitk::PropertyKey TextureInterpolationKey("texture interpolation");
+  const mitk::PropertyKey OutlineBinaryShadowKey("outline binary shadow");
+  const mitk::PropertyKey HoveringKey("binaryimage.ishovering");
+  const mitk::PropertyKey SelectedKey("selected");
+  const mitk::PropertyKey HoveringColorKey("binaryimage.hoveringcolor");
+  const mitk::PropertyKey SelectedColorKey("binaryimage.selectedcolor");
+  const mitk::PropertyKey OutlineShadowColorKey("outline binary shadow color");
+  const mitk::PropertyKey RenderingModeKey("Image Rendering.Mode");
+  const mitk::PropertyKey LookupTableKey("LookupTable");
+  const mitk::PropertyKey TransferFunctionKey("Image Rendering.Transfer Function");
+}
+
 mitk::ImageVtkMapper2D::ImageVtkMapper2D()
 {
 }
@@ -94,7 +123,7 @@ float mitk::ImageVtkMapper2D::CalculateLayerDepth(mitk::BaseRenderer *renderer)
   // Due to a VTK bug, we cannot use the whole clipping range. /100 is empirically determined
   float depth = -maxRange * 0.01; // divide by 100
   int layer = 0;
-  GetDataNode()->GetIntProperty("layer", layer, renderer);
+  GetDataNode()->GetIntProperty(LayerKey, layer, renderer);
   // add the layer property for each image to render images with a higher layer on top of the others
   depth += layer * 10; //*10: keep some room for each image (e.g. for ODFs in between)
   if (depth > 0.0f)
@@ -159,15 +188,16 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
 
   // is the geometry of the slice based on the input image or the worldgeometry?
   bool inPlaneResampleExtentByGeometry = false;
-  datanode->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
+  datanode->GetBoolProperty(ResampleExtentByGeometryKey, inPlaneResampleExtentByGeometry, renderer);
   localStorage->m_Reslicer->SetInPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry);
 
   // Initialize the interpolation mode for resampling; switch to nearest
   // neighbor if the input image is too small.
+  ExtractSliceFilter::ResliceInterpolation resliceInterpolation = ExtractSliceFilter::RESLICE_NEAREST;
   if ((image->GetDimension() >= 3) && (image->GetDimension(2) > 1))
   {
     VtkResliceInterpolationProperty *resliceInterpolationProperty;
-    datanode->GetProperty(resliceInterpolationProperty, "reslice interpolation", renderer);
+    datanode->GetProperty(resliceInterpolationProperty, ResliceInterpolationKey, renderer);
 
     int interpolationMode = VTK_RESLICE_NEAREST;
     if (resliceInterpolationProperty != nullptr)
@@ -178,20 +208,17 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     switch (interpolationMode)
     {
       case VTK_RESLICE_NEAREST:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
+        resliceInterpolation = ExtractSliceFilter::RESLICE_NEAREST;
         break;
       case VTK_RESLICE_LINEAR:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_LINEAR);
+        resliceInterpolation = ExtractSliceFilter::RESLICE_LINEAR;
         break;
       case VTK_RESLICE_CUBIC:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_CUBIC);
+        resliceInterpolation = ExtractSliceFilter::RESLICE_CUBIC;
         break;
     }
   }
-  else
-  {
-    localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
-  }
+  localStorage->m_Reslicer->SetInterpolationMode(resliceInterpolation);
 
   // set the vtk output property to true, makes sure that no unneeded mitk image convertion
   // is done.
@@ -208,11 +235,11 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     {
       ResliceMethodProperty *resliceMethodEnumProperty = nullptr;
 
-      if (dn->GetProperty(resliceMethodEnumProperty, "reslice.thickslices", renderer) && resliceMethodEnumProperty)
+      if (dn->GetProperty(resliceMethodEnumProperty, ThickSlicesModeKey, renderer) && resliceMethodEnumProperty)
         thickSlicesMode = resliceMethodEnumProperty->GetValueAsId();
 
       IntProperty *intProperty = nullptr;
-      if (dn->GetProperty(intProperty, "reslice.thickslices.num", renderer) && intProperty)
+      if (dn->GetProperty(intProperty, ThickSlicesNumKey, renderer) && intProperty)
       {
         thickSlicesNum = intProperty->GetValue();
         if (thickSlicesNum < 1)
@@ -252,35 +279,89 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
 
     dataZSpacing = 1.0 / normInIndex.GetNorm();
 
-    localStorage->m_Reslicer->SetOutputDimensionality(3);
-    localStorage->m_Reslicer->SetOutputSpacingZDirection(dataZSpacing);
-    localStorage->m_Reslicer->SetOutputExtentZDirection(-thickSlicesNum, 0 + thickSlicesNum);
-
-    // Do the reslicing. Modified() is called to make sure that the reslicer is
-    // executed even though the input geometry information did not change; this
-    // is necessary when the input /em data, but not the /em geometry changes.
-    localStorage->m_TSFilter->SetThickSliceMode(thickSlicesMode - 1);
-    localStorage->m_TSFilter->SetInputData(localStorage->m_Reslicer->GetVtkOutput());
-
-    // vtkFilter=>mitkFilter=>vtkFilter update mechanism will fail without calling manually
-    localStorage->m_Reslicer->Modified();
-    localStorage->m_Reslicer->Update();
-
-    localStorage->m_TSFilter->Modified();
-    localStorage->m_TSFilter->Update();
-    localStorage->m_ReslicedImage = localStorage->m_TSFilter->GetOutput();
+    if (abstractGeometry == nullptr)
+    {
+      // while scrolling only the planes that enter the slab are resliced
+      localStorage->m_ReslicedImage = localStorage->m_ThickSlab.Update(localStorage->m_Reslicer,
+                                                                       image,
+                                                                       this->GetTimestep(),
+                                                                       planeGeometry,
+                                                                       resliceInterpolation,
+                                                                       inPlaneResampleExtentByGeometry,
+                                                                       dataZSpacing,
+                                                                       thickSlicesMode - 1,
+                                                                       thickSlicesNum);
+      // m_mmPerPixel points to the spacing of the reslicer, which is recomputed by its next update
+      std::copy(localStorage->m_ThickSlab.GetOutputSpacing(),
+                localStorage->m_ThickSlab.GetOutputSpacing() + 2,
+                localStorage->m_Reslicer->GetOutputSpacing());
+      localStorage->m_ResliceAxes->DeepCopy(localStorage->m_ThickSlab.GetResliceAxes());
+    }
+    else
+    {
+      localStorage->m_Reslicer->SetOutputDimensionality(3);
+      localStorage->m_Reslicer->SetOutputSpacingZDirection(dataZSpacing);
+      localStorage->m_Reslicer->SetOutputExtentZDirection(-thickSlicesNum, 0 + thickSlicesNum);
+
+      // Do the reslicing. Modified() is called to make sure that the reslicer is
+      // executed even though the input geometry information did not change; this
+      // is necessary when the input /em data, but not the /em geometry changes.
+      localStorage->m_TSFilter->SetThickSliceMode(thickSlicesMode - 1);
+      localStorage->m_TSFilter->SetInputData(localStorage->m_Reslicer->GetVtkOutput());
+
+      // vtkFilter=>mitkFilter=>vtkFilter update mechanism will fail without calling manually
+      localStorage->m_Reslicer->Modified();
+      localStorage->m_Reslicer->Update();
+
+      localStorage->m_TSFilter->Modified();
+      localStorage->m_TSFilter->Update();
+      localStorage->m_ReslicedImage = localStorage->m_TSFilter->GetOutput();
+      localStorage->m_ResliceAxes->DeepCopy(localStorage->m_Reslicer->GetResliceAxes());
+    }
   }
   else
   {
     // this is needed when thick mode was enable bevore. These variable have to be reset to default values
+    localStorage->m_ThickSlab.Reset();
     localStorage->m_Reslicer->SetOutputDimensionality(2);
     localStorage->m_Reslicer->SetOutputSpacingZDirection(1.0);
     localStorage->m_Reslicer->SetOutputExtentZDirection(0, 0);
 
-    localStorage->m_Reslicer->Modified();
-    // start the pipeline with updating the largest possible, needed if the geometry of the input has changed
-    localStorage->m_Reslicer->UpdateLargestPossibleRegion();
-    localStorage->m_ReslicedImage = localStorage->m_Reslicer->GetVtkOutput();
+    // slices of curved geometries are not cached
+    const bool useCache = m_ReslicedImageCache.GetMemoryBudget() > 0 && planeGeometry != nullptr &&
+                          dynamic_cast<const AbstractTransformGeometry *>(worldGeometry) == nullptr;
+
+    ReslicedImageCache::KeyType cacheKey;
+    ReslicedImageCache::Slice cachedSlice;
+    if (useCache)
+    {
+      m_ReslicedImageCache.SetImage(image);
+      cacheKey = ReslicedImageCache::CreateKey(
+        image, this->GetTimestep(), planeGeometry, resliceInterpolation, inPlaneResampleExtentByGeometry);
+    }
+
+    if (useCache && m_ReslicedImageCache.Get(cacheKey, cachedSlice))
+    {
+      // the slice was already resliced for another render window or prefetched while scrolling.
+      // m_mmPerPixel points to the spacing of the reslicer, which is recomputed by its next update
+      localStorage->m_ReslicedImage = cachedSlice.Image;
+      std::copy(cachedSlice.Spacing, cachedSlice.Spacing + 2, localStorage->m_Reslicer->GetOutputSpacing());
+      localStorage->m_ResliceAxes->DeepCopy(cachedSlice.ResliceAxes);
+    }
+    else
+    {
+      localStorage->m_Reslicer->Modified();
+      // start the pipeline with updating the largest possible, needed if the geometry of the input has changed
+      localStorage->m_Reslicer->UpdateLargestPossibleRegion();
+      localStorage->m_ReslicedImage = localStorage->m_Reslicer->GetVtkOutput();
+      localStorage->m_ResliceAxes->DeepCopy(localStorage->m_Reslicer->GetResliceAxes());
+
+      if (useCache)
+        m_ReslicedImageCache.Add(cacheKey, ReslicedImageCache::CreateSlice(localStorage->m_Reslicer));
+    }
+
+    if (useCache)
+      this->PrefetchSlices(renderer, resliceInterpolation, inPlaneResampleExtentByGeometry);
   }
 
   // Bounds information for reslicing (only reuqired if reference geometry
@@ -322,10 +403,10 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
   // get the binary property
   bool binary = false;
   bool binaryOutline = false;
-  datanode->GetBoolProperty("binary", binary, renderer);
+  datanode->GetBoolProperty(BinaryKey, binary, renderer);
   if (binary) // binary image
   {
-    datanode->GetBoolProperty("outline binary", binaryOutline, renderer);
+    datanode->GetBoolProperty(OutlineBinaryKey, binaryOutline, renderer);
     if (binaryOutline) // contour rendering
     {
       // get pixel type of vtk image
@@ -348,12 +429,12 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
       if (binaryOutline) // binary outline is still true --> add outline
       {
         float binaryOutlineWidth = 1.0;
-        if (datanode->GetFloatProperty("outline width", binaryOutlineWidth, renderer))
+        if (datanode->GetFloatProperty(OutlineWidthKey, binaryOutlineWidth, renderer))
         {
           if (localStorage->m_Actors->GetNumberOfPaths() > 1)
           {
             float binaryOutlineShadowWidth = 1.5;
-            datanode->GetFloatProperty("outline shadow width", binaryOutlineShadowWidth, renderer);
+            datanode->GetFloatProperty(OutlineShadowWidthKey, binaryOutlineShadowWidth, renderer);
 
             dynamic_cast<vtkActor *>(localStorage->m_Actors->GetParts()->GetItemAsObject(0))
               ->GetProperty()
@@ -380,7 +461,7 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
 
   int displayedComponent = 0;
 
-  if (datanode->GetIntProperty("Image.Displayed Component", displayedComponent, renderer) && numberOfComponents > 1)
+  if (datanode->GetIntProperty(DisplayedComponentKey, displayedComponent, renderer) && numberOfComponents > 1)
   {
     localStorage->m_VectorComponentExtractor->SetComponents(displayedComponent);
     localStorage->m_VectorComponentExtractor->SetInputData(localStorage->m_ReslicedImage);
@@ -395,7 +476,7 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
 
   // check for texture interpolation property
   bool textureInterpolation = false;
-  GetDataNode()->GetBoolProperty("texture interpolation", textureInterpolation, renderer);
+  GetDataNode()->GetBoolProperty(TextureInterpolationKey, textureInterpolation, renderer);
 
   // set the interpolation modus according to the property
   localStorage->m_Texture->SetInterpolate(textureInterpolation);
@@ -414,7 +495,7 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     localStorage->m_Actor->SetTexture(nullptr); // no texture for contours
 
     bool binaryOutlineShadow = false;
-    datanode->GetBoolProperty("outline binary shadow", binaryOutlineShadow, renderer);
+    datanode->GetBoolProperty(OutlineBinaryShadowKey, binaryOutlineShadow, renderer);
     if (binaryOutlineShadow)
     {
       contourShadowActor->SetVisibility(true);
@@ -475,13 +556,13 @@ void mitk::ImageVtkMapper2D::ApplyColor(mitk::BaseRenderer *renderer)
   bool hover = false;
   bool selected = false;
   bool binary = false;
-  GetDataNode()->GetBoolProperty("binaryimage.ishovering", hover, renderer);
-  GetDataNode()->GetBoolProperty("selected", selected, renderer);
-  GetDataNode()->GetBoolProperty("binary", binary, renderer);
+  GetDataNode()->GetBoolProperty(HoveringKey, hover, renderer);
+  GetDataNode()->GetBoolProperty(SelectedKey, selected, renderer);
+  GetDataNode()->GetBoolProperty(BinaryKey, binary, renderer);
   if (binary && hover && !selected)
   {
     mitk::ColorProperty::Pointer colorprop =
-      dynamic_cast<mitk::ColorProperty *>(GetDataNode()->GetProperty("binaryimage.hoveringcolor", renderer));
+      dynamic_cast<mitk::ColorProperty *>(GetDataNode()->GetProperty(HoveringColorKey, renderer));
     if (colorprop.IsNotNull())
     {
       memcpy(rgb, colorprop->GetColor().GetDataPointer(), 3 * sizeof(float));
@@ -494,7 +575,7 @@ void mitk::ImageVtkMapper2D::ApplyColor(mitk::BaseRenderer *renderer)
   if (binary && selected)
   {
     mitk::ColorProperty::Pointer colorprop =
-      dynamic_cast<mitk::ColorProperty *>(GetDataNode()->GetProperty("binaryimage.selectedcolor", renderer));
+      dynamic_cast<mitk::ColorProperty *>(GetDataNode()->GetProperty(SelectedColorKey, renderer));
     if (colorprop.IsNotNull())
     {
       memcpy(rgb, colorprop->GetColor().GetDataPointer(), 3 * sizeof(float));
@@ -517,7 +598,7 @@ void mitk::ImageVtkMapper2D::ApplyColor(mitk::BaseRenderer *renderer)
   {
     float rgb[3] = {1.0f, 1.0f, 1.0f};
     mitk::ColorProperty::Pointer colorprop =
-      dynamic_cast<mitk::ColorProperty *>(GetDataNode()->GetProperty("outline binary shadow color", renderer));
+      dynamic_cast<mitk::ColorProperty *>(GetDataNode()->GetProperty(OutlineShadowColorKey, renderer));
     if (colorprop.IsNotNull())
     {
       memcpy(rgb, colorprop->GetColor().GetDataPointer(), 3 * sizeof(float));
@@ -548,7 +629,7 @@ void mitk::ImageVtkMapper2D::ApplyRenderingMode(mitk::BaseRenderer *renderer)
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
 
   bool binary = false;
-  this->GetDataNode()->GetBoolProperty("binary", binary, renderer);
+  this->GetDataNode()->GetBoolProperty(BinaryKey, binary, renderer);
   if (binary) // is it a binary image?
   {
     // for binary images, we always use our default LuT and map every value to (0,1)
@@ -560,7 +641,7 @@ void mitk::ImageVtkMapper2D::ApplyRenderingMode(mitk::BaseRenderer *renderer)
     // all other image types can make use of the rendering mode
     int renderingMode = mitk::RenderingModeProperty::LOOKUPTABLE_LEVELWINDOW_COLOR;
     mitk::RenderingModeProperty::Pointer mode =
-      dynamic_cast<mitk::RenderingModeProperty *>(this->GetDataNode()->GetProperty("Image Rendering.Mode", renderer));
+      dynamic_cast<mitk::RenderingModeProperty *>(this->GetDataNode()->GetProperty(RenderingModeKey, renderer));
     if (mode.IsNotNull())
     {
       renderingMode = mode->GetRenderingMode();
@@ -603,7 +684,7 @@ void mitk::ImageVtkMapper2D::ApplyLookuptable(mitk::BaseRenderer *renderer)
 
   // If lookup table or transferfunction use is requested...
   mitk::LookupTableProperty::Pointer lookupTableProp =
-    dynamic_cast<mitk::LookupTableProperty *>(this->GetDataNode()->GetProperty("LookupTable"));
+    dynamic_cast<mitk::LookupTableProperty *>(this->GetDataNode()->GetProperty(LookupTableKey));
 
   if (lookupTableProp.IsNotNull()) // is a lookuptable set?
   {
@@ -622,7 +703,7 @@ void mitk::ImageVtkMapper2D::ApplyLookuptable(mitk::BaseRenderer *renderer)
 void mitk::ImageVtkMapper2D::ApplyColorTransferFunction(mitk::BaseRenderer *renderer)
 {
   mitk::TransferFunctionProperty::Pointer transferFunctionProp = dynamic_cast<mitk::TransferFunctionProperty *>(
-    this->GetDataNode()->GetProperty("Image Rendering.Transfer Function", renderer));
+    this->GetDataNode()->GetProperty(TransferFunctionKey, renderer));
 
   if (transferFunctionProp.IsNull())
   {
@@ -868,150 +949,37 @@ vtkSmartPointer<vtkPolyData> mitk::ImageVtkMapper2D::CreateOutlinePolyData(mitk:
 {
   LocalStorage *localStorage = this->GetLocalStorage(renderer);
 
-  // get the min and max index values of each direction
   int *extent = localStorage->m_ReslicedImage->GetExtent();
-  int xMin = extent[0];
-  int xMax = extent[1];
-  int yMin = extent[2];
-  int yMax = extent[3];
-
   int *dims = localStorage->m_ReslicedImage->GetDimensions(); // dimensions of the image
-  int line = dims[0];                                         // how many pixels per line?
-  int x = xMin;                                               // pixel index x
-  int y = yMin;                                               // pixel index y
 
   // get the depth for each contour
   float depth = CalculateLayerDepth(renderer);
 
-  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();      // the points to draw
-  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New(); // the lines to connect the points
+  mitk::LabelOutlineTracer::Outlines outlines;
+  mitk::LabelOutlineTracer::Trace(static_cast<const TPixel *>(localStorage->m_ReslicedImage->GetScalarPointer()), dims[0], dims[1], outlines, mitk::LabelOutlineTracer::NonZero);
 
-  // We take the pointer to the first pixel of the image
-  auto* currentPixel = static_cast<TPixel*>(localStorage->m_ReslicedImage->GetScalarPointer());
+  // the outline points are given in pixels relative to the first pixel
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New(); // the points to draw
+  points->SetNumberOfPoints(outlines.GetNumberOfPoints());
+  for (vtkIdType i = 0; i < static_cast<vtkIdType>(outlines.GetNumberOfPoints()); ++i)
+  {
+    points->SetPoint(i,
+                     (outlines.Points[2 * i] + extent[0]) * localStorage->m_mmPerPixel[0],
+                     (outlines.Points[2 * i + 1] + extent[2]) * localStorage->m_mmPerPixel[1],
+                     depth);
+  }
 
-  while (y <= yMax)
+  // one polyline per connected outline
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New(); // the lines to connect the points
+  lines->Allocate(outlines.GetNumberOfLines() + outlines.GetNumberOfPoints());
+  for (std::size_t i = 0; i < outlines.GetNumberOfLines(); ++i)
   {
-    // if the current pixel value is set to something
-    if ((currentPixel) && (*currentPixel != 0))
+    lines->InsertNextCell(outlines.LineOffsets[i + 1] - outlines.LineOffsets[i]);
+    for (vtkIdType pointId = outlines.LineOffsets[i]; pointId < outlines.LineOffsets[i + 1]; ++pointId)
     {
-      // check in which direction a line is necessary
-      // a line is added if the neighbor of the current pixel has the value 0
-      // and if the pixel is located at the edge of the image
-
-      // if   vvvvv  not the first line vvvvv
-      if (y > yMin && *(currentPixel - line) == 0)
-      { // x direction - bottom edge of the pixel
-        // add the 2 points
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        // add the line between both points
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  not the last line vvvvv
-      if (y < yMax && *(currentPixel + line) == 0)
-      { // x direction - top edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  not the first pixel vvvvv
-      if ((x > xMin || y > yMin) && *(currentPixel - 1) == 0)
-      { // y direction - left edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  not the last pixel vvvvv
-      if ((y < yMax || (x < xMax)) && *(currentPixel + 1) == 0)
-      { // y direction - right edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      /*  now consider pixels at the edge of the image  */
-
-      // if   vvvvv  left edge of image vvvvv
-      if (x == xMin)
-      { // draw left edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  right edge of image vvvvv
-      if (x == xMax)
-      { // draw right edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  bottom edge of image vvvvv
-      if (y == yMin)
-      { // draw bottom edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  top edge of image vvvvv
-      if (y == yMax)
-      { // draw top edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-    } // end if currentpixel is set
-
-    x++;
-
-    if (x > xMax)
-    { // reached end of line
-      x = xMin;
-      y++;
+      lines->InsertCellPoint(pointId);
     }
-
-    // Increase the pointer-position to the next pixel.
-    // This is safe, as the while-loop and the x-reset logic above makes
-    // sure we do not exceed the bounds of the image
-    currentPixel++;
-  } // end of while
+  }
 
   // Create a polydata to store everything in
   vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
@@ -1027,8 +995,7 @@ void mitk::ImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
   // get the transformation matrix of the reslicer in order to render the slice as axial, coronal or saggital
   vtkSmartPointer<vtkTransform> trans = vtkSmartPointer<vtkTransform>::New();
-  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_Reslicer->GetResliceAxes();
-  trans->SetMatrix(matrix);
+  trans->SetMatrix(localStorage->m_ResliceAxes);
   // transform the plane/contour (the actual actor) to the corresponding view (axial, coronal or saggital)
   localStorage->m_Actor->SetUserTransform(trans);
   // transform the origin to center based coordinates, because MITK is center based.
@@ -1042,6 +1009,49 @@ void mitk::ImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
   }
 }
 
+mitk::ReslicedImageCache &mitk::ImageVtkMapper2D::GetReslicedImageCache()
+{
+  return m_ReslicedImageCache;
+}
+
+void mitk::ImageVtkMapper2D::PrefetchSlices(mitk::BaseRenderer *renderer,
+                                            ExtractSliceFilter::ResliceInterpolation interpolationMode,
+                                            bool inPlaneResampleExtentByGeometry)
+{
+  LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
+
+  const int slice = static_cast<int>(renderer->GetSlice());
+  const int direction = localStorage->m_LastSlice < 0 || slice == localStorage->m_LastSlice
+                          ? 0
+                          : (slice > localStorage->m_LastSlice ? 1 : -1);
+  localStorage->m_LastSlice = slice;
+
+  // the world geometry holds the planes the renderer will show next
+  const auto *slicedWorldGeometry = dynamic_cast<const SlicedGeometry3D *>(renderer->GetCurrentWorldGeometry());
+  if (direction == 0 || slicedWorldGeometry == nullptr)
+    return;
+
+  auto *image = const_cast<mitk::Image *>(this->GetInput());
+
+  const int numberOfPrefetchedSlices = 2;
+  std::vector<PlaneGeometry::ConstPointer> planes;
+  for (int i = 1; i <= numberOfPrefetchedSlices; ++i)
+  {
+    const int nextSlice = slice + i * direction;
+    if (nextSlice < 0 || nextSlice >= static_cast<int>(slicedWorldGeometry->GetSlices()))
+      break;
+
+    const PlaneGeometry *plane = slicedWorldGeometry->GetPlaneGeometry(nextSlice);
+    if (plane == nullptr || !RenderingGeometryIntersectsImage(plane, image->GetSlicedGeometry()))
+      break;
+
+    planes.push_back(plane);
+  }
+
+  m_ReslicedImageCache.Prefetch(
+    image, this->GetTimestep(), planes, interpolationMode, inPlaneResampleExtentByGeometry);
+}
+
 bool mitk::ImageVtkMapper2D::RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry,
                                                               SlicedGeometry3D *imageGeometry)
 {
@@ -1094,6 +1104,8 @@ mitk::ImageVtkMapper2D::LocalStorage::LocalStorage()
   m_OutlinePolyData = vtkSmartPointer<vtkPolyData>::New();
   m_ReslicedImage = vtkSmartPointer<vtkImageData>::New();
   m_EmptyPolyData = vtkSmartPointer<vtkPolyData>::New();
+  m_ResliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+  m_LastSlice = -1;
 
   // the following actions are always the same and thus can be performed
   // in the constructor for each image (i.e. the image-corresponding local storage)
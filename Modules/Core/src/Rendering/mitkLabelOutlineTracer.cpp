@@ -0,0 +1,297 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkLabelOutlineTracer.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace
+{
+  typedef mitk::LabelOutlineTracer::LabelType LabelType;
+
+  /** Label of pixels that do not belong to any traced region, including the pixels outside the slice. */
+  const LabelType Background = std::numeric_limits<LabelType>::min();
+
+  /** Minimal number of vertex rows per thread, smaller bands do not pay off. */
+  const unsigned int MinimumRowsPerBand = 16;
+
+  /** Directions of the edges, counter clockwise. A boundary edge has its region on the left. */
+  enum Direction
+  {
+    PlusX = 0,
+    PlusY = 1,
+    MinusX = 2,
+    MinusY = 3
+  };
+
+  const int DirectionX[4] = {1, 0, -1, 0};
+  const int DirectionY[4] = {0, 1, 0, -1};
+
+  template <typename TPixel>
+  class LabelSlice
+  {
+  public:
+    LabelSlice(const TPixel *values,
+               unsigned int width,
+               unsigned int height,
+               mitk::LabelOutlineTracer::ModeType mode,
+               LabelType label)
+      : m_Values(values), m_Width(width), m_Height(height), m_Mode(mode), m_Label(label)
+    {
+    }
+
+    bool IsEmpty() const { return !m_Values || m_Width == 0 || m_Height == 0; }
+    unsigned int GetWidth() const { return m_Width; }
+    unsigned int GetHeight() const { return m_Height; }
+
+    LabelType GetLabel(long x, long y) const
+    {
+      if (x < 0 || y < 0 || x >= static_cast<long>(m_Width) || y >= static_cast<long>(m_Height))
+      {
+        return Background;
+      }
+
+      const LabelType value = m_Values[static_cast<std::size_t>(y) * m_Width + x];
+      switch (m_Mode)
+      {
+        case mitk::LabelOutlineTracer::NonZero:
+          return value != 0 ? 1 : Background;
+        case mitk::LabelOutlineTracer::SingleLabel:
+          return value == m_Label ? value : Background;
+        default:
+          return value != 0 ? value : Background;
+      }
+    }
+
+    /** Label of the pixel on the left of the edge leaving vertex (x,y) in the given direction. */
+    LabelType GetLeftLabel(long x, long y, int direction) const
+    {
+      switch (direction)
+      {
+        case PlusX:
+          return this->GetLabel(x, y);
+        case PlusY:
+          return this->GetLabel(x - 1, y);
+        case MinusX:
+          return this->GetLabel(x - 1, y - 1);
+        default:
+          return this->GetLabel(x, y - 1);
+      }
+    }
+
+  private:
+    const TPixel *m_Values;
+    unsigned int m_Width;
+    unsigned int m_Height;
+    mitk::LabelOutlineTracer::ModeType m_Mode;
+    LabelType m_Label;
+  };
+
+  /** Marks the boundary edges leaving the vertices of the rows [firstRow, endRow).
+   * Each vertex only reads the four pixels around it, so the bands can be processed in parallel.
+   * \return the number of marked edges */
+  template <typename TPixel>
+  std::size_t MarkBoundaryEdges(const LabelSlice<TPixel> &slice,
+                                unsigned int firstRow,
+                                unsigned int endRow,
+                                std::vector<unsigned char> &edges)
+  {
+    const long vertexColumns = slice.GetWidth() + 1;
+    std::size_t count = 0;
+
+    for (long y = firstRow; y < static_cast<long>(endRow); ++y)
+    {
+      for (long x = 0; x < vertexColumns; ++x)
+      {
+        // the pixels around the vertex, counter clockwise starting at the lower left one
+        const LabelType lowerLeft = slice.GetLabel(x - 1, y - 1);
+        const LabelType lowerRight = slice.GetLabel(x, y - 1);
+        const LabelType upperRight = slice.GetLabel(x, y);
+        const LabelType upperLeft = slice.GetLabel(x - 1, y);
+
+        unsigned char mask = 0;
+        if (upperRight != Background && upperRight != lowerRight)
+        { // bottom edge of the upper right pixel
+          mask |= 1 << PlusX;
+        }
+        if (upperLeft != Background && upperLeft != upperRight)
+        { // right edge of the upper left pixel
+          mask |= 1 << PlusY;
+        }
+        if (lowerLeft != Background && lowerLeft != upperLeft)
+        { // top edge of the lower left pixel
+          mask |= 1 << MinusX;
+        }
+        if (lowerRight != Background && lowerRight != lowerLeft)
+        { // left edge of the lower right pixel
+          mask |= 1 << MinusY;
+        }
+
+        edges[y * vertexColumns + x] = mask;
+        count += ((mask >> PlusX) & 1) + ((mask >> PlusY) & 1) + ((mask >> MinusX) & 1) + ((mask >> MinusY) & 1);
+      }
+    }
+
+    return count;
+  }
+
+  template <typename TPixel>
+  void TraceOutlines(const LabelSlice<TPixel> &slice,
+                     mitk::LabelOutlineTracer::Outlines &outlines,
+                     unsigned int numberOfThreads)
+  {
+    outlines.Points.clear();
+    outlines.LineOffsets.assign(1, 0);
+    outlines.LineLabels.clear();
+
+    if (slice.IsEmpty())
+    {
+      return;
+    }
+
+    const long vertexColumns = slice.GetWidth() + 1;
+    const unsigned int vertexRows = slice.GetHeight() + 1;
+    std::vector<unsigned char> edges(static_cast<std::size_t>(vertexColumns) * vertexRows, 0);
+
+    // mark the boundary edges in row bands
+    unsigned int bandCount = numberOfThreads > 0 ? numberOfThreads : std::thread::hardware_concurrency();
+    bandCount = std::max(1u, std::min(bandCount, vertexRows / MinimumRowsPerBand));
+
+    std::vector<std::size_t> edgeCounts(bandCount, 0);
+    {
+      std::vector<std::thread> threads;
+      for (unsigned int band = 1; band < bandCount; ++band)
+      {
+        threads.emplace_back([&slice, &edges, &edgeCounts, band, bandCount, vertexRows]() {
+          edgeCounts[band] = MarkBoundaryEdges(
+            slice, band * vertexRows / bandCount, (band + 1) * vertexRows / bandCount, edges);
+        });
+      }
+      edgeCounts[0] = MarkBoundaryEdges(slice, 0, vertexRows / bandCount, edges);
+
+      for (auto &thread : threads)
+      {
+        thread.join();
+      }
+    }
+
+    std::size_t edgeCount = 0;
+    for (auto count : edgeCounts)
+    {
+      edgeCount += count;
+    }
+
+    if (edgeCount == 0)
+    {
+      return;
+    }
+
+    // every polyline has at least 4 edges and at most one point per edge plus the closing point
+    outlines.Points.reserve(2 * (edgeCount + edgeCount / 4));
+    outlines.LineOffsets.reserve(edgeCount / 4 + 1);
+    outlines.LineLabels.reserve(edgeCount / 4);
+
+    auto addPoint = [&outlines](long x, long y) {
+      outlines.Points.push_back(static_cast<float>(x));
+      outlines.Points.push_back(static_cast<float>(y));
+    };
+
+    // walk the edges; in/out degree of every label is balanced at each vertex, so all polylines are closed
+    for (long startY = 0; startY < static_cast<long>(vertexRows); ++startY)
+    {
+      for (long startX = 0; startX < vertexColumns; ++startX)
+      {
+        while (edges[startY * vertexColumns + startX] != 0)
+        {
+          const unsigned char startMask = edges[startY * vertexColumns + startX];
+          int direction = PlusX;
+          while (!(startMask & (1 << direction)))
+          {
+            ++direction;
+          }
+
+          const LabelType label = slice.GetLeftLabel(startX, startY, direction);
+          long x = startX;
+          long y = startY;
+          addPoint(x, y);
+
+          while (true)
+          {
+            edges[y * vertexColumns + x] &= ~(1 << direction);
+            x += DirectionX[direction];
+            y += DirectionY[direction];
+
+            if (x == startX && y == startY)
+            {
+              addPoint(x, y);
+              break;
+            }
+
+            // prefer turning left, so that pixels touching at a corner get separate outlines
+            const unsigned char mask = edges[y * vertexColumns + x];
+            int next = -1;
+            for (int candidate : {(direction + 1) % 4, direction, (direction + 3) % 4})
+            {
+              if ((mask & (1 << candidate)) && slice.GetLeftLabel(x, y, candidate) == label)
+              {
+                next = candidate;
+                break;
+              }
+            }
+
+            if (next != direction)
+            { // corner (or, for inconsistent input, the end of an open line)
+              addPoint(x, y);
+            }
+
+            if (next < 0)
+            {
+              break;
+            }
+            direction = next;
+          }
+
+          outlines.LineOffsets.push_back(static_cast<unsigned int>(outlines.GetNumberOfPoints()));
+          outlines.LineLabels.push_back(label);
+        }
+      }
+    }
+  }
+}
+
+void mitk::LabelOutlineTracer::Trace(const unsigned char *values,
+                                     unsigned int width,
+                                     unsigned int height,
+                                     Outlines &outlines,
+                                     ModeType mode,
+                                     LabelType label,
+                                     unsigned int numberOfThreads)
+{
+  TraceOutlines(LabelSlice<unsigned char>(values, width, height, mode, label), outlines, numberOfThreads);
+}
+
+void mitk::LabelOutlineTracer::Trace(const unsigned short *values,
+                                     unsigned int width,
+                                     unsigned int height,
+                                     Outlines &outlines,
+                                     ModeType mode,
+                                     LabelType label,
+                                     unsigned int numberOfThreads)
+{
+  TraceOutlines(LabelSlice<unsigned short>(values, width, height, mode, label), outlines, numberOfThreads);
+}
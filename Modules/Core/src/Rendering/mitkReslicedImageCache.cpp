@@ -0,0 +1,320 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkReslicedImageCache.h"
+
+#include <mitkImageReadAccessor.h>
+#include <mitkLogMacros.h>
+
+#include <algorithm>
+#include <chrono>
+
+std::size_t mitk::ReslicedImageCache::s_DefaultMemoryBudget = 64 * 1024 * 1024;
+
+namespace
+{
+  void AppendGeometry(mitk::ReslicedImageCache::KeyType &key, const mitk::BaseGeometry *geometry)
+  {
+    if (geometry == nullptr)
+    {
+      key.push_back(0.0);
+      return;
+    }
+
+    key.push_back(1.0);
+    key.push_back(geometry->GetImageGeometry() ? 1.0 : 0.0);
+
+    const auto &matrix = geometry->GetIndexToWorldTransform()->GetMatrix();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int j = 0; j < 3; ++j)
+      {
+        key.push_back(matrix[i][j]);
+      }
+    }
+
+    const auto &offset = geometry->GetIndexToWorldTransform()->GetOffset();
+    key.insert(key.end(), offset.Begin(), offset.End());
+
+    const auto &bounds = geometry->GetBounds();
+    key.insert(key.end(), bounds.Begin(), bounds.End());
+  }
+}
+
+void mitk::ReslicedImageCache::SetDefaultMemoryBudget(std::size_t bytes)
+{
+  s_DefaultMemoryBudget = bytes;
+}
+
+std::size_t mitk::ReslicedImageCache::GetDefaultMemoryBudget()
+{
+  return s_DefaultMemoryBudget;
+}
+
+mitk::ReslicedImageCache::KeyType mitk::ReslicedImageCache::CreateKey(
+  const Image *image,
+  unsigned int timeStep,
+  const PlaneGeometry *planeGeometry,
+  ExtractSliceFilter::ResliceInterpolation interpolationMode,
+  bool inPlaneResampleExtentByGeometry)
+{
+  KeyType key;
+  key.reserve(64);
+
+  key.push_back(timeStep);
+  key.push_back(interpolationMode);
+  key.push_back(inPlaneResampleExtentByGeometry ? 1.0 : 0.0);
+
+  // the reference geometry determines the clipped extent of the slice
+  AppendGeometry(key, planeGeometry);
+  AppendGeometry(key, planeGeometry != nullptr ? planeGeometry->GetReferenceGeometry() : nullptr);
+  AppendGeometry(key, image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep).GetPointer());
+
+  return key;
+}
+
+mitk::ReslicedImageCache::Slice mitk::ReslicedImageCache::CreateSlice(ExtractSliceFilter *filter)
+{
+  Slice slice;
+
+  slice.Image = vtkSmartPointer<vtkImageData>::New();
+  slice.Image->DeepCopy(filter->GetVtkOutput());
+
+  std::copy(filter->GetOutputSpacing(), filter->GetOutputSpacing() + 2, slice.Spacing);
+
+  slice.ResliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+  slice.ResliceAxes->DeepCopy(filter->GetResliceAxes());
+
+  return slice;
+}
+
+unsigned long mitk::ReslicedImageCache::GetImageMTime(const Image *image)
+{
+  return std::max(image->GetMTime(), image->GetPipelineMTime());
+}
+
+mitk::ReslicedImageCache::ReslicedImageCache()
+  : m_MemoryBudget(s_DefaultMemoryBudget), m_MemoryUsage(0), m_Image(nullptr), m_ImageMTime(0), m_CancelPrefetch(false)
+{
+}
+
+mitk::ReslicedImageCache::~ReslicedImageCache()
+{
+  m_CancelPrefetch = true;
+  this->WaitForPrefetch();
+}
+
+void mitk::ReslicedImageCache::SetMemoryBudget(std::size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MemoryBudget = bytes;
+  this->ShrinkUnlocked(m_MemoryBudget);
+}
+
+std::size_t mitk::ReslicedImageCache::GetMemoryBudget() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemoryBudget;
+}
+
+std::size_t mitk::ReslicedImageCache::GetMemoryUsage() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemoryUsage;
+}
+
+std::size_t mitk::ReslicedImageCache::GetNumberOfSlices() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+void mitk::ReslicedImageCache::SetImage(const Image *image)
+{
+  const unsigned long mTime = image != nullptr ? GetImageMTime(image) : 0;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (image == m_Image && mTime == m_ImageMTime)
+    return;
+
+  m_Image = image;
+  m_ImageMTime = mTime;
+  m_Entries.clear();
+  m_Index.clear();
+  m_MemoryUsage = 0;
+
+  // the results of a running prefetch would be discarded anyway
+  m_CancelPrefetch = true;
+}
+
+bool mitk::ReslicedImageCache::Get(const KeyType &key, Slice &slice)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  auto iter = m_Index.find(key);
+  if (iter == m_Index.end())
+    return false;
+
+  // most recently used slices are at the front
+  m_Entries.splice(m_Entries.begin(), m_Entries, iter->second);
+  slice = iter->second->Data;
+  return true;
+}
+
+void mitk::ReslicedImageCache::Add(const KeyType &key, const Slice &slice)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  this->AddUnlocked(key, slice);
+}
+
+void mitk::ReslicedImageCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_Index.clear();
+  m_MemoryUsage = 0;
+}
+
+void mitk::ReslicedImageCache::AddUnlocked(const KeyType &key, const Slice &slice)
+{
+  // vtkDataObject::GetActualMemorySize() is in kibibytes
+  const std::size_t size = static_cast<std::size_t>(slice.Image->GetActualMemorySize()) * 1024;
+  if (size > m_MemoryBudget)
+    return;
+
+  auto iter = m_Index.find(key);
+  if (iter != m_Index.end())
+  {
+    m_MemoryUsage -= iter->second->Size;
+    m_Entries.erase(iter->second);
+    m_Index.erase(iter);
+  }
+
+  m_Entries.push_front(Entry{key, slice, size});
+  m_Index[key] = m_Entries.begin();
+  m_MemoryUsage += size;
+
+  this->ShrinkUnlocked(m_MemoryBudget);
+}
+
+void mitk::ReslicedImageCache::ShrinkUnlocked(std::size_t budget)
+{
+  while (!m_Entries.empty() && m_MemoryUsage > budget)
+  {
+    m_MemoryUsage -= m_Entries.back().Size;
+    m_Index.erase(m_Entries.back().Key);
+    m_Entries.pop_back();
+  }
+}
+
+void mitk::ReslicedImageCache::Prefetch(const Image *image,
+                                        unsigned int timeStep,
+                                        const std::vector<PlaneGeometry::ConstPointer> &planes,
+                                        ExtractSliceFilter::ResliceInterpolation interpolationMode,
+                                        bool inPlaneResampleExtentByGeometry)
+{
+  if (image == nullptr || planes.empty() || !image->IsVolumeSet(timeStep))
+    return;
+
+  if (m_Prefetch.valid() && m_Prefetch.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return;
+
+  PrefetchJob job;
+  job.TimeStep = timeStep;
+  job.InterpolationMode = interpolationMode;
+  job.InPlaneResampleExtentByGeometry = inPlaneResampleExtentByGeometry;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_MemoryBudget == 0 || image != m_Image)
+      return;
+    job.ImageMTime = m_ImageMTime;
+
+    for (const auto &plane : planes)
+    {
+      KeyType key = CreateKey(image, timeStep, plane, interpolationMode, inPlaneResampleExtentByGeometry);
+      if (m_Index.find(key) != m_Index.end())
+        continue;
+
+      // the worker gets its own copies of the geometries, the originals belong to the renderer
+      PlaneGeometry::Pointer planeCopy = plane->Clone();
+      if (plane->GetReferenceGeometry() != nullptr)
+      {
+        BaseGeometry::Pointer referenceCopy = plane->GetReferenceGeometry()->Clone();
+        planeCopy->SetReferenceGeometry(referenceCopy);
+        job.ReferenceGeometries.push_back(referenceCopy);
+      }
+
+      job.Keys.push_back(key);
+      job.Planes.push_back(planeCopy);
+    }
+  }
+
+  if (job.Keys.empty())
+    return;
+
+  // the worker reslices an image that only references the voxels of the source image
+  job.SourceImage = image;
+  job.Volume = image->GetVolumeData(timeStep);
+  job.View = Image::New();
+  job.View->Initialize(image);
+
+  m_CancelPrefetch = false;
+  m_Prefetch = std::async(std::launch::async, [this, job]() { this->RunPrefetch(job); });
+}
+
+void mitk::ReslicedImageCache::RunPrefetch(const PrefetchJob &job)
+{
+  try
+  {
+    // blocks writers of the source image until the slices are extracted
+    ImageReadAccessor accessor(job.SourceImage, job.Volume.GetPointer());
+    job.View->SetImportVolume(const_cast<void *>(accessor.GetData()), job.TimeStep, 0, Image::ReferenceMemory);
+
+    for (std::size_t i = 0; i < job.Planes.size(); ++i)
+    {
+      if (m_CancelPrefetch)
+        return;
+
+      ExtractSliceFilter::Pointer reslicer = ExtractSliceFilter::New();
+      reslicer->SetInput(job.View);
+      reslicer->SetWorldGeometry(job.Planes[i]);
+      reslicer->SetTimeStep(job.TimeStep);
+      reslicer->SetResliceTransformByGeometry(job.View->GetTimeGeometry()->GetGeometryForTimeStep(job.TimeStep));
+      reslicer->SetInPlaneResampleExtentByGeometry(job.InPlaneResampleExtentByGeometry);
+      reslicer->SetInterpolationMode(job.InterpolationMode);
+      reslicer->SetVtkOutputRequest(true);
+      reslicer->UpdateLargestPossibleRegion();
+
+      Slice slice = CreateSlice(reslicer);
+
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (m_Image != job.SourceImage.GetPointer() || m_ImageMTime != job.ImageMTime)
+        return;
+      this->AddUnlocked(job.Keys[i], slice);
+    }
+  }
+  catch (const std::exception &e)
+  {
+    MITK_WARN << "Prefetching of resliced images failed: " << e.what();
+  }
+}
+
+void mitk::ReslicedImageCache::WaitForPrefetch()
+{
+  if (m_Prefetch.valid())
+    m_Prefetch.wait();
+}
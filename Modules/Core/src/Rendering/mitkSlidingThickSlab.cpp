@@ -0,0 +1,534 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkSlidingThickSlab.h"
+
+#include "vtkMitkThickSlicesFilter.h"
+
+#include <vtkPointData.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+  template <class T>
+  void SlidingThickSlabMax(const T *first, const T *second, T *target, vtkIdType size)
+  {
+    for (vtkIdType i = 0; i < size; ++i)
+      target[i] = std::max(first[i], second[i]);
+  }
+
+  template <class T>
+  void SlidingThickSlabMin(const T *first, const T *second, T *target, vtkIdType size)
+  {
+    for (vtkIdType i = 0; i < size; ++i)
+      target[i] = std::min(first[i], second[i]);
+  }
+
+  template <class T>
+  void SlidingThickSlabAccumulate(const T *plane, double weight, double *sum, vtkIdType size)
+  {
+    for (vtkIdType i = 0; i < size; ++i)
+      sum[i] += plane[i] * weight;
+  }
+
+  template <class T>
+  void SlidingThickSlabAdd(const T *plane, double *sum, vtkIdType size)
+  {
+    for (vtkIdType i = 0; i < size; ++i)
+      sum[i] += plane[i];
+  }
+
+  template <class T>
+  void SlidingThickSlabSubtract(const T *plane, double *sum, vtkIdType size)
+  {
+    for (vtkIdType i = 0; i < size; ++i)
+      sum[i] -= plane[i];
+  }
+
+  // the conversions are the ones of vtkMitkThickSlicesFilterExecute
+  template <class T>
+  void SlidingThickSlabWriteScaled(const double *sum, double factor, T *target, vtkIdType size)
+  {
+    for (vtkIdType i = 0; i < size; ++i)
+      target[i] = static_cast<T>(factor * sum[i]);
+  }
+
+  template <class T>
+  void SlidingThickSlabWriteMean(const double *sum, int count, T *target, vtkIdType size)
+  {
+    for (vtkIdType i = 0; i < size; ++i)
+      target[i] = static_cast<T>(static_cast<long double>(sum[i]) / count);
+  }
+
+  template <class T>
+  void SlidingThickSlabWriteWeighted(const double *sum, T *target, vtkIdType size)
+  {
+    for (vtkIdType i = 0; i < size; ++i)
+      target[i] = static_cast<T>(sum[i]);
+  }
+
+  /** Sums of up to a few hundred values of these types are exact in double precision */
+  bool HasExactRunningSum(int scalarType)
+  {
+    switch (scalarType)
+    {
+      case VTK_CHAR:
+      case VTK_SIGNED_CHAR:
+      case VTK_UNSIGNED_CHAR:
+      case VTK_SHORT:
+      case VTK_UNSIGNED_SHORT:
+      case VTK_INT:
+      case VTK_UNSIGNED_INT:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /** Like vtkMitkThickSlicesFilter, unknown modes are treated as MIP */
+  bool UsesTree(int mode)
+  {
+    return mode != vtkMitkThickSlicesFilter::SUM && mode != vtkMitkThickSlicesFilter::WEIGHTED &&
+           mode != vtkMitkThickSlicesFilter::MEAN;
+  }
+}
+
+mitk::SlidingThickSlab::SlidingThickSlab()
+  : m_Output(vtkSmartPointer<vtkImageData>::New()),
+    m_ResliceAxes(vtkSmartPointer<vtkMatrix4x4>::New()),
+    m_NumberOfTreeLeaves(0),
+    m_Center(0),
+    m_Position(0.0),
+    m_ScalarType(VTK_VOID),
+    m_PlaneSize(0),
+    m_NumberOfReslicedPlanes(0),
+    m_Valid(false),
+    m_Image(nullptr),
+    m_ImageMTime(0),
+    m_SliceSpacing(0.0),
+    m_Mode(vtkMitkThickSlicesFilter::MIP),
+    m_NumberOfSlices(0)
+{
+  m_OutputSpacing[0] = m_OutputSpacing[1] = 1.0;
+  std::fill(m_Extent, m_Extent + 6, 0);
+}
+
+mitk::SlidingThickSlab::~SlidingThickSlab()
+{
+}
+
+vtkMatrix4x4 *mitk::SlidingThickSlab::GetResliceAxes()
+{
+  return m_ResliceAxes;
+}
+
+const mitk::ScalarType *mitk::SlidingThickSlab::GetOutputSpacing() const
+{
+  return m_OutputSpacing;
+}
+
+int mitk::SlidingThickSlab::GetNumberOfReslicedPlanes() const
+{
+  return m_NumberOfReslicedPlanes;
+}
+
+void mitk::SlidingThickSlab::Reset()
+{
+  m_Valid = false;
+  m_Image = nullptr;
+  m_PlaneKey.clear();
+  m_StateKey.clear();
+  m_Planes.clear();
+  m_TreeNodes.clear();
+  m_Sum.clear();
+}
+
+vtkImageData *mitk::SlidingThickSlab::Update(ExtractSliceFilter *reslicer,
+                                             const Image *image,
+                                             unsigned int timeStep,
+                                             const PlaneGeometry *plane,
+                                             ExtractSliceFilter::ResliceInterpolation interpolationMode,
+                                             bool inPlaneResampleExtentByGeometry,
+                                             double sliceSpacing,
+                                             int mode,
+                                             int numberOfSlices)
+{
+  m_NumberOfReslicedPlanes = 0;
+
+  reslicer->SetOutputDimensionality(3);
+  reslicer->SetOutputSpacingZDirection(sliceSpacing);
+
+  // everything but the plane itself, the planes of the slab can only be reused if this did not change
+  const unsigned long imageMTime = std::max(image->GetMTime(), image->GetPipelineMTime());
+  ReslicedImageCache::KeyType stateKey =
+    ReslicedImageCache::CreateKey(image, timeStep, nullptr, interpolationMode, inPlaneResampleExtentByGeometry);
+  ReslicedImageCache::KeyType planeKey =
+    ReslicedImageCache::CreateKey(image, timeStep, plane, interpolationMode, inPlaneResampleExtentByGeometry);
+
+  const bool sameState = m_Valid && image == m_Image && imageMTime == m_ImageMTime && stateKey == m_StateKey &&
+                         sliceSpacing == m_SliceSpacing && mode == m_Mode && numberOfSlices == m_NumberOfSlices;
+
+  // e.g. a changed level window or another mapper update of the same plane
+  if (sameState && planeKey == m_PlaneKey)
+    return m_Output;
+
+  Vector3D normal = plane->GetNormal();
+  normal.Normalize();
+  const double position = (plane->GetOrigin().GetVectorFromOrigin() * normal) / sliceSpacing;
+
+  bool shifted = false;
+  if (sameState)
+  {
+    const int numberOfPlanes = 2 * numberOfSlices + 1;
+    const double delta = position - m_Position;
+    const long shift = std::lround(delta);
+
+    if (std::abs(delta - shift) < 1e-3 && shift != 0 && std::abs(shift) < numberOfPlanes)
+    {
+      // only the planes that enter the slab are resliced
+      if (shift > 0)
+        this->Reslice(reslicer, numberOfSlices - static_cast<int>(shift) + 1, numberOfSlices);
+      else
+        this->Reslice(reslicer, -numberOfSlices, -numberOfSlices - static_cast<int>(shift) - 1);
+
+      shifted = reslicer->GetOutputSpacing()[0] == m_OutputSpacing[0] &&
+                reslicer->GetOutputSpacing()[1] == m_OutputSpacing[1] &&
+                this->ShiftSlab(reslicer->GetVtkOutput(), reslicer->GetResliceAxes(), shift);
+    }
+  }
+
+  if (!shifted)
+  {
+    m_Image = image;
+    m_ImageMTime = imageMTime;
+    m_StateKey = stateKey;
+    m_SliceSpacing = sliceSpacing;
+    m_Mode = mode;
+    m_NumberOfSlices = numberOfSlices;
+
+    this->Reslice(reslicer, -numberOfSlices, numberOfSlices);
+    this->BuildSlab(reslicer->GetVtkOutput());
+
+    // e.g. the plane does not intersect the image, nothing to combine
+    if (!m_Valid)
+    {
+      m_PlaneKey.clear();
+      return reslicer->GetVtkOutput();
+    }
+  }
+
+  m_PlaneKey = planeKey;
+  m_Position = position;
+  std::copy(reslicer->GetOutputSpacing(), reslicer->GetOutputSpacing() + 2, m_OutputSpacing);
+  m_ResliceAxes->DeepCopy(reslicer->GetResliceAxes());
+
+  this->WriteOutput();
+  return m_Output;
+}
+
+void mitk::SlidingThickSlab::Reslice(ExtractSliceFilter *reslicer, int zMin, int zMax)
+{
+  reslicer->SetOutputExtentZDirection(zMin, zMax);
+
+  // vtkFilter=>mitkFilter=>vtkFilter update mechanism will fail without calling manually
+  reslicer->Modified();
+  reslicer->Update();
+
+  m_NumberOfReslicedPlanes += zMax - zMin + 1;
+}
+
+int mitk::SlidingThickSlab::GetSlot(long plane) const
+{
+  const long numberOfPlanes = static_cast<long>(m_Planes.size());
+  return static_cast<int>(((plane % numberOfPlanes) + numberOfPlanes) % numberOfPlanes);
+}
+
+void *mitk::SlidingThickSlab::GetPlane(long plane)
+{
+  return m_Planes[this->GetSlot(plane)]->GetVoidPointer(0);
+}
+
+void mitk::SlidingThickSlab::CopyPlane(vtkImageData *slab, int z, void *target) const
+{
+  const int *extent = slab->GetExtent();
+  std::memcpy(target, slab->GetScalarPointer(extent[0], extent[2], z), m_PlaneSize * slab->GetScalarSize());
+}
+
+void mitk::SlidingThickSlab::BuildSlab(vtkImageData *slab)
+{
+  m_Valid = false;
+  m_Planes.clear();
+  m_TreeNodes.clear();
+  m_Sum.clear();
+
+  if (slab == nullptr || slab->GetPointData()->GetScalars() == nullptr || slab->GetNumberOfPoints() == 0 ||
+      slab->GetNumberOfScalarComponents() != 1)
+    return;
+
+  slab->GetExtent(m_Extent);
+  m_ScalarType = slab->GetScalarType();
+  m_PlaneSize = static_cast<vtkIdType>(m_Extent[1] - m_Extent[0] + 1) * (m_Extent[3] - m_Extent[2] + 1);
+  m_Center = 0;
+
+  const int numberOfPlanes = 2 * m_NumberOfSlices + 1;
+  for (int i = 0; i < numberOfPlanes; ++i)
+  {
+    vtkSmartPointer<vtkDataArray> plane;
+    plane.TakeReference(vtkDataArray::CreateDataArray(m_ScalarType));
+    plane->SetNumberOfTuples(m_PlaneSize);
+    m_Planes.push_back(plane);
+  }
+
+  for (int z = -m_NumberOfSlices; z <= m_NumberOfSlices; ++z)
+    this->CopyPlane(slab, z, this->GetPlane(z));
+
+  m_Valid = true;
+
+  if (UsesTree(m_Mode))
+  {
+    m_NumberOfTreeLeaves = 1;
+    while (m_NumberOfTreeLeaves < numberOfPlanes)
+      m_NumberOfTreeLeaves *= 2;
+
+    // node 0 is unused, nodes whose subtree holds no plane are never allocated
+    m_TreeNodes.resize(m_NumberOfTreeLeaves);
+    for (int node = m_NumberOfTreeLeaves - 1; node > 0; --node)
+    {
+      if (this->IsTreeNodeEmpty(node))
+        continue;
+      m_TreeNodes[node].TakeReference(vtkDataArray::CreateDataArray(m_ScalarType));
+      m_TreeNodes[node]->SetNumberOfTuples(m_PlaneSize);
+      this->UpdateTreeNode(node);
+    }
+  }
+  else
+  {
+    this->ComputeAggregate();
+  }
+}
+
+bool mitk::SlidingThickSlab::ShiftSlab(vtkImageData *slab, vtkMatrix4x4 *resliceAxes, long shift)
+{
+  if (slab == nullptr || slab->GetPointData()->GetScalars() == nullptr || slab->GetScalarType() != m_ScalarType ||
+      slab->GetNumberOfScalarComponents() != 1)
+    return false;
+
+  const int *extent = slab->GetExtent();
+  for (int i = 0; i < 4; ++i)
+  {
+    if (extent[i] != m_Extent[i])
+      return false;
+  }
+
+  // the new planes continue the slab only if the plane moved along its normal by whole planes
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      if (std::abs(resliceAxes->GetElement(i, j) - m_ResliceAxes->GetElement(i, j)) > 1e-6)
+        return false;
+    }
+
+    const double expectedOrigin = m_ResliceAxes->GetElement(i, 3) + shift * m_SliceSpacing * m_ResliceAxes->GetElement(i, 2);
+    if (std::abs(resliceAxes->GetElement(i, 3) - expectedOrigin) > 1e-3 * m_SliceSpacing)
+      return false;
+  }
+
+  const long center = m_Center + shift;
+  const bool runningSum = (m_Mode == vtkMitkThickSlicesFilter::SUM || m_Mode == vtkMitkThickSlicesFilter::MEAN) &&
+                          HasExactRunningSum(m_ScalarType);
+
+  for (int z = extent[4]; z <= extent[5]; ++z)
+  {
+    void *plane = this->GetPlane(center + z);
+
+    // the slot held the plane that leaves the slab on the other side
+    if (runningSum)
+    {
+      switch (m_ScalarType)
+      {
+        vtkTemplateMacro(SlidingThickSlabSubtract(static_cast<VTK_TT *>(plane), m_Sum.data(), m_PlaneSize));
+      }
+    }
+
+    this->CopyPlane(slab, z, plane);
+
+    if (runningSum)
+    {
+      switch (m_ScalarType)
+      {
+        vtkTemplateMacro(SlidingThickSlabAdd(static_cast<VTK_TT *>(plane), m_Sum.data(), m_PlaneSize));
+      }
+    }
+    else if (UsesTree(m_Mode))
+    {
+      this->UpdateTreePath(this->GetSlot(center + z));
+    }
+  }
+
+  m_Center = center;
+
+  if (!runningSum && !UsesTree(m_Mode))
+    this->ComputeAggregate();
+
+  return true;
+}
+
+void mitk::SlidingThickSlab::ComputeAggregate()
+{
+  // sums in the order of vtkMitkThickSlicesFilter, so that the results are the same
+  m_Sum.assign(m_PlaneSize, 0.0);
+
+  if (m_Mode == vtkMitkThickSlicesFilter::WEIGHTED)
+  {
+    const int size = 2 * m_NumberOfSlices;
+    const double sigmaSq = (size / 6.0) * (size / 6.0);
+
+    std::vector<double> weights;
+    double sum = 0.0;
+    for (int z = -m_NumberOfSlices + 1; z <= m_NumberOfSlices; ++z)
+    {
+      weights.push_back(std::exp(-(z / sigmaSq)));
+      sum += weights.back();
+    }
+
+    for (int z = -m_NumberOfSlices + 1; z <= m_NumberOfSlices; ++z)
+    {
+      const double weight = weights[z + m_NumberOfSlices - 1] / sum;
+      switch (m_ScalarType)
+      {
+        vtkTemplateMacro(SlidingThickSlabAccumulate(
+          static_cast<VTK_TT *>(this->GetPlane(m_Center + z)), weight, m_Sum.data(), m_PlaneSize));
+      }
+    }
+  }
+  else
+  {
+    for (int z = -m_NumberOfSlices; z <= m_NumberOfSlices; ++z)
+    {
+      switch (m_ScalarType)
+      {
+        vtkTemplateMacro(
+          SlidingThickSlabAdd(static_cast<VTK_TT *>(this->GetPlane(m_Center + z)), m_Sum.data(), m_PlaneSize));
+      }
+    }
+  }
+}
+
+bool mitk::SlidingThickSlab::IsTreeNodeEmpty(int node) const
+{
+  // the subtree is empty if its leftmost leaf is behind the last plane
+  while (node < m_NumberOfTreeLeaves)
+    node *= 2;
+  return node - m_NumberOfTreeLeaves >= static_cast<int>(m_Planes.size());
+}
+
+void *mitk::SlidingThickSlab::GetTreeNode(int node)
+{
+  if (node >= m_NumberOfTreeLeaves)
+    return m_Planes[node - m_NumberOfTreeLeaves]->GetVoidPointer(0);
+  return m_TreeNodes[node]->GetVoidPointer(0);
+}
+
+void mitk::SlidingThickSlab::UpdateTreeNode(int node)
+{
+  void *target = m_TreeNodes[node]->GetVoidPointer(0);
+  void *left = this->GetTreeNode(2 * node);
+
+  if (this->IsTreeNodeEmpty(2 * node + 1))
+  {
+    std::memcpy(target, left, m_PlaneSize * m_TreeNodes[node]->GetDataTypeSize());
+    return;
+  }
+
+  void *right = this->GetTreeNode(2 * node + 1);
+  if (m_Mode != vtkMitkThickSlicesFilter::MINIP)
+  {
+    switch (m_ScalarType)
+    {
+      vtkTemplateMacro(SlidingThickSlabMax(static_cast<VTK_TT *>(left),
+                                           static_cast<VTK_TT *>(right),
+                                           static_cast<VTK_TT *>(target),
+                                           m_PlaneSize));
+    }
+  }
+  else
+  {
+    switch (m_ScalarType)
+    {
+      vtkTemplateMacro(SlidingThickSlabMin(static_cast<VTK_TT *>(left),
+                                           static_cast<VTK_TT *>(right),
+                                           static_cast<VTK_TT *>(target),
+                                           m_PlaneSize));
+    }
+  }
+}
+
+void mitk::SlidingThickSlab::UpdateTreePath(int slot)
+{
+  for (int node = (m_NumberOfTreeLeaves + slot) / 2; node > 0; node /= 2)
+    this->UpdateTreeNode(node);
+}
+
+void mitk::SlidingThickSlab::WriteOutput()
+{
+  int *extent = m_Output->GetExtent();
+  if (m_Output->GetPointData()->GetScalars() == nullptr || m_Output->GetScalarType() != m_ScalarType ||
+      extent[0] != m_Extent[0] || extent[1] != m_Extent[1] || extent[2] != m_Extent[2] || extent[3] != m_Extent[3])
+  {
+    m_Output->SetExtent(m_Extent[0], m_Extent[1], m_Extent[2], m_Extent[3], 0, 0);
+    m_Output->AllocateScalars(m_ScalarType, 1);
+  }
+
+  // like the output of vtkMitkThickSlicesFilter
+  m_Output->SetOrigin(0.0, 0.0, 0.0);
+  m_Output->SetSpacing(m_OutputSpacing[0], m_OutputSpacing[1], m_SliceSpacing);
+
+  void *target = m_Output->GetScalarPointer();
+  switch (m_Mode)
+  {
+    case vtkMitkThickSlicesFilter::SUM:
+      switch (m_ScalarType)
+      {
+        vtkTemplateMacro(SlidingThickSlabWriteScaled(
+          m_Sum.data(), 1.0 / (2 * m_NumberOfSlices + 1), static_cast<VTK_TT *>(target), m_PlaneSize));
+      }
+      break;
+    case vtkMitkThickSlicesFilter::MEAN:
+      // vtkMitkThickSlicesFilter divides by the number of planes minus one
+      switch (m_ScalarType)
+      {
+        vtkTemplateMacro(
+          SlidingThickSlabWriteMean(m_Sum.data(), 2 * m_NumberOfSlices, static_cast<VTK_TT *>(target), m_PlaneSize));
+      }
+      break;
+    case vtkMitkThickSlicesFilter::WEIGHTED:
+      switch (m_ScalarType)
+      {
+        vtkTemplateMacro(SlidingThickSlabWriteWeighted(m_Sum.data(), static_cast<VTK_TT *>(target), m_PlaneSize));
+      }
+      break;
+    default:
+      std::memcpy(target, this->GetTreeNode(1), m_PlaneSize * m_Output->GetScalarSize());
+      break;
+  }
+
+  m_Output->Modified();
+}
@@ -29,6 +29,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 // used for acos etc.
 #include <cmath>
 
+#include <algorithm>
+#include <limits>
+
 // used for PI
 #include <itkMath.h>
 
@@ -39,7 +42,14 @@ static const double PI = itk::Math::pi;
 vtkStandardNewMacro(vtkMitkLevelWindowFilter);
 
 vtkMitkLevelWindowFilter::vtkMitkLevelWindowFilter()
-  : m_LookupTable(nullptr), m_OpacityFunction(nullptr), m_MinOpacity(0.0), m_MaxOpacity(255.0)
+  : m_LookupTable(nullptr),
+    m_OpacityFunction(nullptr),
+    m_MinOpacity(0.0),
+    m_MaxOpacity(255.0),
+    m_IntegerLookupTableScalarType(-1),
+    m_IntegerLookupTableSource(nullptr),
+    m_IntegerLookupTableOpacity(nullptr),
+    m_IntegerLookupTableMTime(0)
 {
   // MITK_INFO << "mitk level/window filter uses " << GetNumberOfThreads() << " thread(s)";
 }
@@ -144,6 +154,28 @@ void HSItoRGB(T *HSI, T *RGB)
   RGB[2] = (T)(B < 0 ? 0 : (B > 255 ? 255 : B));
 }
 
+// Internal method which should never be used anywhere else and should not be in th header.
+// Computes the pixels [begin, end) of the row y of the extent that lie inside of the clipping bounds.
+// The offsets are relative to the first pixel of the row, begin == end if the row is clipped completely.
+static void vtkGetClippedSpan(const int outExt[6], int y, const double *clippingBounds, int &begin, int &end)
+{
+  begin = 0;
+  end = 0;
+
+  if (y < clippingBounds[2] || y >= clippingBounds[3])
+    return;
+
+  // first x with x >= clippingBounds[0] and first x with x >= clippingBounds[1]
+  const double first = std::max(static_cast<double>(outExt[0]), std::ceil(clippingBounds[0]));
+  const double last = std::min(static_cast<double>(outExt[1] + 1), std::ceil(clippingBounds[1]));
+
+  if (first < last)
+  {
+    begin = static_cast<int>(first) - outExt[0];
+    end = static_cast<int>(last) - outExt[0];
+  }
+}
+
 // Internal method which should never be used anywhere else and should not be in th header.
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
@@ -281,8 +313,12 @@ void vtkApplyLookupTableOnRGBA(vtkMitkLevelWindowFilter *self,
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 template <class T>
-void vtkApplyLookupTableOnScalarsFast(
-  vtkMitkLevelWindowFilter *self, vtkImageData *inData, vtkImageData *outData, int outExt[6], T *)
+void vtkApplyLookupTableOnScalarsFast(vtkMitkLevelWindowFilter *self,
+                                      vtkImageData *inData,
+                                      vtkImageData *outData,
+                                      int outExt[6],
+                                      double *clippingBounds,
+                                      T *)
 {
   vtkImageIterator<T> inputIt(inData, outExt);
   vtkImageIterator<unsigned char> outputIt(outData, outExt);
@@ -303,32 +339,141 @@ void vtkApplyLookupTableOnScalarsFast(
   // due to later conversion to int for rounding
   bias += 0.5f;
 
+  const int width = outExt[1] - outExt[0] + 1;
+  int y = outExt[2];
+
   // Loop through ouput pixels
   while (!outputIt.IsAtEnd())
   {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
+    auto *outputSI = reinterpret_cast<int *>(outputIt.BeginSpan());
+    const T *inputSI = inputIt.BeginSpan();
 
-    T *inputSI = inputIt.BeginSpan();
+    // the clipping is resolved once per row, the loop over the visible pixels has no branches
+    // and can be vectorized by the compiler
+    int begin, end;
+    vtkGetClippedSpan(outExt, y, clippingBounds, begin, end);
 
-    while (outputSI != outputSIEnd)
+    std::fill(outputSI, outputSI + begin, 0);
+    for (int x = begin; x < end; ++x)
     {
       // map to an index
-      auto idx = static_cast<int>(*inputSI * scale + bias);
+      auto idx = static_cast<int>(inputSI[x] * scale + bias);
+      idx = std::min(std::max(idx, 0), maxIndex);
 
-      if (idx < 0)
-        idx = 0;
-      else if (idx > maxIndex)
-        idx = maxIndex;
+      outputSI[x] = realLookupTable[idx];
+    }
+    std::fill(outputSI + end, outputSI + width, 0);
 
-      *reinterpret_cast<int *>(outputSI) = realLookupTable[idx];
+    inputIt.NextSpan();
+    outputIt.NextSpan();
+    y++;
+  }
+}
+
+// Like vtkTemplateMacro, but only for the scalar types that are mapped through m_IntegerLookupTable.
+#define vtkIntegerLookupTableTemplateMacro(call)                                                                        \
+  vtkTemplateMacroCase(VTK_CHAR, char, call);                                                                          \
+  vtkTemplateMacroCase(VTK_SIGNED_CHAR, signed char, call);                                                            \
+  vtkTemplateMacroCase(VTK_UNSIGNED_CHAR, unsigned char, call);                                                        \
+  vtkTemplateMacroCase(VTK_SHORT, short, call);                                                                        \
+  vtkTemplateMacroCase(VTK_UNSIGNED_SHORT, unsigned short, call)
 
-      inputSI++;
-      outputSI += 4;
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Applies a lookup table with one RGBA entry for every possible value of an 8 or 16 bit type.
+template <class T>
+void vtkApplyIntegerLookupTable(
+  const int *table, vtkImageData *inData, vtkImageData *outData, int outExt[6], double *clippingBounds, T *)
+{
+  vtkImageIterator<T> inputIt(inData, outExt);
+  vtkImageIterator<unsigned char> outputIt(outData, outExt);
+
+  // the entry of the smallest value of T is at index 0
+  const int offset = -static_cast<int>(std::numeric_limits<T>::min());
+  const int width = outExt[1] - outExt[0] + 1;
+  int y = outExt[2];
+
+  while (!outputIt.IsAtEnd())
+  {
+    auto *outputSI = reinterpret_cast<int *>(outputIt.BeginSpan());
+    const T *inputSI = inputIt.BeginSpan();
+
+    int begin, end;
+    vtkGetClippedSpan(outExt, y, clippingBounds, begin, end);
+
+    std::fill(outputSI, outputSI + begin, 0);
+    for (int x = begin; x < end; ++x)
+    {
+      outputSI[x] = table[inputSI[x] + offset];
     }
+    std::fill(outputSI + end, outputSI + width, 0);
 
     inputIt.NextSpan();
     outputIt.NextSpan();
+    y++;
+  }
+}
+
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Fills the table of vtkApplyIntegerLookupTable with the same arithmetic the per-pixel kernels use.
+template <class T>
+void vtkFillIntegerLookupTable(vtkMitkLevelWindowFilter *self, std::vector<int> &table, T *)
+{
+  const int minimum = std::numeric_limits<T>::min();
+  const int maximum = std::numeric_limits<T>::max();
+  table.resize(maximum - minimum + 1);
+
+  vtkScalarsToColors *lookupTable = self->GetLookupTable();
+  auto *vlt = dynamic_cast<vtkLookupTable *>(lookupTable);
+  auto *ctf = dynamic_cast<vtkColorTransferFunction *>(lookupTable);
+
+  if (ctf)
+  {
+    // see vtkApplyLookupTableOnScalarsCTF
+    vtkPiecewiseFunction *opacityFunction = self->GetOpacityPiecewiseFunction();
+    for (int value = minimum; value <= maximum; ++value)
+    {
+      double rgba[4];
+      ctf->GetColor(value, rgba);
+      rgba[3] = 1.0;
+      if (opacityFunction)
+        rgba[3] = opacityFunction->GetValue(value);
+
+      auto *entry = reinterpret_cast<unsigned char *>(&table[value - minimum]);
+      for (int i = 0; i < 4; ++i)
+      {
+        entry[i] = static_cast<unsigned char>(255.0 * rgba[i] + 0.5);
+      }
+    }
+  }
+  else if (vlt && vlt->GetScale() == VTK_SCALE_LINEAR)
+  {
+    // see vtkApplyLookupTableOnScalarsFast
+    double tableRange[2];
+    vlt->GetTableRange(tableRange);
+
+    const int *realLookupTable = reinterpret_cast<int *>(vlt->GetTable()->GetPointer(0));
+    int maxIndex = vlt->GetNumberOfColors() - 1;
+
+    const float scale = (tableRange[1] - tableRange[0] > 0 ? (maxIndex + 1) / (tableRange[1] - tableRange[0]) : 0.0);
+    float bias = -tableRange[0] * scale;
+    bias += 0.5f;
+
+    for (int value = minimum; value <= maximum; ++value)
+    {
+      auto idx = static_cast<int>(static_cast<T>(value) * scale + bias);
+      idx = std::min(std::max(idx, 0), maxIndex);
+      table[value - minimum] = realLookupTable[idx];
+    }
+  }
+  else
+  {
+    // see vtkApplyLookupTableOnScalars
+    for (int value = minimum; value <= maximum; ++value)
+    {
+      table[value - minimum] = *reinterpret_cast<const int *>(lookupTable->MapValue(value));
+    }
   }
 }
 
@@ -347,51 +492,28 @@ void vtkApplyLookupTableOnScalars(vtkMitkLevelWindowFilter *self,
   vtkImageIterator<unsigned char> outputIt(outData, outExt);
   vtkScalarsToColors *lookupTable = self->GetLookupTable();
 
+  const int width = outExt[1] - outExt[0] + 1;
   int y = outExt[2];
 
   // Loop through ouput pixels
   while (!outputIt.IsAtEnd())
   {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
-
-    // do we iterate over the inner vertical clipping bounds
-    if (y >= clippingBounds[2] && y < clippingBounds[3])
-    {
-      T *inputSI = inputIt.BeginSpan();
+    auto *outputSI = reinterpret_cast<int *>(outputIt.BeginSpan());
+    const T *inputSI = inputIt.BeginSpan();
 
-      int x = outExt[0];
+    // outer clipping bounds - write transparent RGBA pixels as single ints
+    int begin, end;
+    vtkGetClippedSpan(outExt, y, clippingBounds, begin, end);
 
-      while (outputSI != outputSIEnd)
-      {
-        // is this pixel within horizontal clipping bounds
-        if (x >= clippingBounds[0] && x < clippingBounds[1])
-        {
-          // fetching original value
-          auto grayValue = static_cast<double>(*inputSI);
-          // applying lookuptable - copy the 4 (RGBA) chars as a single int
-          *reinterpret_cast<int *>(outputSI) = *reinterpret_cast<int *>(lookupTable->MapValue(grayValue));
-        }
-        else
-        {
-          // outer horizontal clipping bounds - write a transparent RGBA pixel as a single int
-          *reinterpret_cast<int *>(outputSI) = 0;
-        }
-
-        inputSI++;
-        outputSI += 4;
-        x++;
-      }
-    }
-    else
+    std::fill(outputSI, outputSI + begin, 0);
+    for (int x = begin; x < end; ++x)
     {
-      // outer vertical clipping bounds - write a transparent RGBA line as ints
-      while (outputSI != outputSIEnd)
-      {
-        *reinterpret_cast<int *>(outputSI) = 0;
-        outputSI += 4;
-      }
+      // fetching original value
+      auto grayValue = static_cast<double>(inputSI[x]);
+      // applying lookuptable - copy the 4 (RGBA) chars as a single int
+      outputSI[x] = *reinterpret_cast<int *>(lookupTable->MapValue(grayValue));
     }
+    std::fill(outputSI + end, outputSI + width, 0);
 
     inputIt.NextSpan();
     outputIt.NextSpan();
@@ -415,62 +537,39 @@ void vtkApplyLookupTableOnScalarsCTF(vtkMitkLevelWindowFilter *self,
   auto *lookupTable = dynamic_cast<vtkColorTransferFunction *>(self->GetLookupTable());
   vtkPiecewiseFunction *opacityFunction = self->GetOpacityPiecewiseFunction();
 
+  const int width = outExt[1] - outExt[0] + 1;
   int y = outExt[2];
 
   // Loop through ouput pixels
   while (!outputIt.IsAtEnd())
   {
     unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
+    const T *inputSI = inputIt.BeginSpan();
 
-    // do we iterate over the inner vertical clipping bounds
-    if (y >= clippingBounds[2] && y < clippingBounds[3])
-    {
-      T *inputSI = inputIt.BeginSpan();
-
-      int x = outExt[0];
+    // outer clipping bounds - write transparent RGBA pixels
+    int begin, end;
+    vtkGetClippedSpan(outExt, y, clippingBounds, begin, end);
 
-      while (outputSI != outputSIEnd)
-      {
-        // is this pixel within horizontal clipping bounds
-        if (x >= clippingBounds[0] && x < clippingBounds[1])
-        {
-          // fetching original value
-          auto grayValue = static_cast<double>(*inputSI);
-
-          // applying directly colortransferfunction
-          // because vtkColorTransferFunction::MapValue is not threadsafe
-          double rgba[4];
-          lookupTable->GetColor(grayValue, rgba); // RGB mapping
-          rgba[3] = 1.0;
-          if (opacityFunction)
-            rgba[3] = opacityFunction->GetValue(grayValue); // Alpha mapping
-
-          for (int i = 0; i < 4; ++i)
-          {
-            outputSI[i] = static_cast<unsigned char>(255.0 * rgba[i] + 0.5);
-          }
-        }
-        else
-        {
-          // outer horizontal clipping bounds - write a transparent RGBA pixel as a single int
-          *reinterpret_cast<int *>(outputSI) = 0;
-        }
-
-        inputSI++;
-        outputSI += 4;
-        x++;
-      }
-    }
-    else
+    std::fill(outputSI, outputSI + 4 * begin, 0);
+    for (int x = begin; x < end; ++x)
     {
-      // outer vertical clipping bounds - write a transparent RGBA line as ints
-      while (outputSI != outputSIEnd)
+      // fetching original value
+      auto grayValue = static_cast<double>(inputSI[x]);
+
+      // applying directly colortransferfunction
+      // because vtkColorTransferFunction::MapValue is not threadsafe
+      double rgba[4];
+      lookupTable->GetColor(grayValue, rgba); // RGB mapping
+      rgba[3] = 1.0;
+      if (opacityFunction)
+        rgba[3] = opacityFunction->GetValue(grayValue); // Alpha mapping
+
+      for (int i = 0; i < 4; ++i)
       {
-        *reinterpret_cast<int *>(outputSI) = 0;
-        outputSI += 4;
+        outputSI[4 * x + i] = static_cast<unsigned char>(255.0 * rgba[i] + 0.5);
       }
     }
+    std::fill(outputSI + 4 * end, outputSI + 4 * width, 0);
 
     inputIt.NextSpan();
     outputIt.NextSpan();
@@ -492,6 +591,71 @@ int vtkMitkLevelWindowFilter::RequestInformation(vtkInformation *request,
   return 1;
 }
 
+int vtkMitkLevelWindowFilter::RequestData(vtkInformation *request,
+                                          vtkInformationVector **inputVector,
+                                          vtkInformationVector *outputVector)
+{
+  // the lookup table is prepared once here, the threads only read it
+  if (this->GetLookupTable())
+    this->GetLookupTable()->Build();
+
+  int updateExtent[6];
+  outputVector->GetInformationObject(0)->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent);
+  const vtkIdType numberOfPixels = vtkIdType(updateExtent[1] - updateExtent[0] + 1) *
+                                   (updateExtent[3] - updateExtent[2] + 1) * (updateExtent[5] - updateExtent[4] + 1);
+
+  this->UpdateIntegerLookupTable(vtkImageData::GetData(inputVector[0]), numberOfPixels);
+
+  return Superclass::RequestData(request, inputVector, outputVector);
+}
+
+void vtkMitkLevelWindowFilter::UpdateIntegerLookupTable(vtkImageData *inData, vtkIdType numberOfPixels)
+{
+  if (!inData || !m_LookupTable || inData->GetNumberOfScalarComponents() > 2)
+  {
+    m_IntegerLookupTable.clear();
+    return;
+  }
+
+  const int scalarType = inData->GetScalarType();
+  const bool isSmallIntegerType = scalarType == VTK_CHAR || scalarType == VTK_SIGNED_CHAR ||
+                                  scalarType == VTK_UNSIGNED_CHAR || scalarType == VTK_SHORT ||
+                                  scalarType == VTK_UNSIGNED_SHORT;
+  if (!isSmallIntegerType)
+  {
+    m_IntegerLookupTable.clear();
+    return;
+  }
+
+  vtkMTimeType mTime = m_LookupTable->GetMTime();
+  if (m_OpacityFunction)
+    mTime = std::max(mTime, m_OpacityFunction->GetMTime());
+
+  if (!m_IntegerLookupTable.empty() && m_IntegerLookupTableScalarType == scalarType &&
+      m_IntegerLookupTableSource == m_LookupTable && m_IntegerLookupTableOpacity == m_OpacityFunction &&
+      m_IntegerLookupTableMTime == mTime)
+    return;
+
+  // a 16 bit table only pays off if it has not more entries than there are pixels to map
+  const std::size_t tableSize = std::size_t(1) << (8 * inData->GetScalarSize());
+  if (numberOfPixels < static_cast<vtkIdType>(tableSize))
+  {
+    m_IntegerLookupTable.clear();
+    return;
+  }
+
+  switch (scalarType)
+  {
+    vtkIntegerLookupTableTemplateMacro(
+      vtkFillIntegerLookupTable(this, m_IntegerLookupTable, static_cast<VTK_TT *>(nullptr)));
+  }
+
+  m_IntegerLookupTableScalarType = scalarType;
+  m_IntegerLookupTableSource = m_LookupTable;
+  m_IntegerLookupTableOpacity = m_OpacityFunction;
+  m_IntegerLookupTableMTime = mTime;
+}
+
 // Method to run the filter in different threads.
 void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageData *outData, int extent[6], int /*id*/)
 {
@@ -508,20 +672,28 @@ void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageDat
   }
   else
   {
-    bool dontClip = extent[2] >= m_ClippingBounds[2] && extent[3] <= m_ClippingBounds[3] &&
-                    extent[0] >= m_ClippingBounds[0] && extent[1] <= m_ClippingBounds[1];
-
-    if (this->GetLookupTable())
-      this->GetLookupTable()->Build();
-
     auto *vlt = dynamic_cast<vtkLookupTable *>(this->GetLookupTable());
     auto *ctf = dynamic_cast<vtkColorTransferFunction *>(this->GetLookupTable());
 
     bool linearLookupTable = vlt && vlt->GetScale() == VTK_SCALE_LINEAR;
 
-    bool useFast = dontClip && linearLookupTable;
-
-    if (ctf)
+    if (!m_IntegerLookupTable.empty() && m_IntegerLookupTableScalarType == inData->GetScalarType())
+    {
+      // 8 and 16 bit input: every possible value was already mapped by UpdateIntegerLookupTable
+      switch (inData->GetScalarType())
+      {
+        vtkIntegerLookupTableTemplateMacro(vtkApplyIntegerLookupTable(m_IntegerLookupTable.data(),
+                                                                      inData,
+                                                                      outData,
+                                                                      extent,
+                                                                      m_ClippingBounds,
+                                                                      static_cast<VTK_TT *>(nullptr)));
+        default:
+          vtkErrorMacro(<< "Execute: Unknown ScalarType");
+          return;
+      }
+    }
+    else if (ctf)
     {
       switch (inData->GetScalarType())
       {
@@ -532,12 +704,12 @@ void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageDat
           return;
       }
     }
-    else if (useFast)
+    else if (linearLookupTable)
     {
       switch (inData->GetScalarType())
       {
-        vtkTemplateMacro(
-          vtkApplyLookupTableOnScalarsFast(this, inData, outData, extent, static_cast<VTK_TT *>(nullptr)));
+        vtkTemplateMacro(vtkApplyLookupTableOnScalarsFast(
+          this, inData, outData, extent, m_ClippingBounds, static_cast<VTK_TT *>(nullptr)));
         default:
           vtkErrorMacro(<< "Execute: Unknown ScalarType");
           return;
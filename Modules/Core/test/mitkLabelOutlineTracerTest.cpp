@@ -0,0 +1,159 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkLabelOutlineTracer.h>
+
+#include <vector>
+
+class mitkLabelOutlineTracerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelOutlineTracerTestSuite);
+  MITK_TEST(TestLabelsAreTracedSeparately);
+  MITK_TEST(TestNonZeroMergesLabels);
+  MITK_TEST(TestSingleLabel);
+  MITK_TEST(TestHolesAndDiagonalPixels);
+  MITK_TEST(TestThreadsAgree);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  // 4x3 slice, the first row is y = 0
+  std::vector<unsigned char> m_Slice;
+
+  /** Checks the points of a polyline, given as x0, y0, x1, y1, ... */
+  static void AssertLine(const mitk::LabelOutlineTracer::Outlines &outlines,
+                         std::size_t line,
+                         mitk::LabelOutlineTracer::LabelType label,
+                         const std::vector<float> &expectedPoints)
+  {
+    CPPUNIT_ASSERT_EQUAL(label, outlines.LineLabels[line]);
+
+    const std::vector<float> points(outlines.Points.begin() + 2 * outlines.LineOffsets[line],
+                                    outlines.Points.begin() + 2 * outlines.LineOffsets[line + 1]);
+    CPPUNIT_ASSERT(expectedPoints == points);
+  }
+
+  static void AssertClosed(const mitk::LabelOutlineTracer::Outlines &outlines)
+  {
+    for (std::size_t i = 0; i < outlines.GetNumberOfLines(); ++i)
+    {
+      const unsigned int first = outlines.LineOffsets[i];
+      const unsigned int last = outlines.LineOffsets[i + 1] - 1;
+      CPPUNIT_ASSERT(last > first);
+      CPPUNIT_ASSERT_EQUAL(outlines.Points[2 * first], outlines.Points[2 * last]);
+      CPPUNIT_ASSERT_EQUAL(outlines.Points[2 * first + 1], outlines.Points[2 * last + 1]);
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Slice = {1, 0, 0, 0,
+               0, 1, 2, 2,
+               0, 1, 2, 0};
+  }
+
+  void TestLabelsAreTracedSeparately()
+  {
+    mitk::LabelOutlineTracer::Outlines outlines;
+    mitk::LabelOutlineTracer::Trace(m_Slice.data(), 4, 3, outlines);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), outlines.GetNumberOfLines());
+    AssertClosed(outlines);
+    // only the corners are part of the polylines
+    AssertLine(outlines, 0, 1, {0, 0, 1, 0, 1, 1, 0, 1, 0, 0});
+    AssertLine(outlines, 1, 1, {1, 1, 2, 1, 2, 3, 1, 3, 1, 1});
+    AssertLine(outlines, 2, 2, {2, 1, 4, 1, 4, 2, 3, 2, 3, 3, 2, 3, 2, 1});
+  }
+
+  void TestNonZeroMergesLabels()
+  {
+    mitk::LabelOutlineTracer::Outlines outlines;
+    mitk::LabelOutlineTracer::Trace(m_Slice.data(), 4, 3, outlines, mitk::LabelOutlineTracer::NonZero);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), outlines.GetNumberOfLines());
+    AssertLine(outlines, 0, 1, {0, 0, 1, 0, 1, 1, 0, 1, 0, 0});
+    AssertLine(outlines, 1, 1, {1, 1, 4, 1, 4, 2, 3, 2, 3, 3, 1, 3, 1, 1});
+  }
+
+  void TestSingleLabel()
+  {
+    const std::vector<unsigned short> slice(m_Slice.begin(), m_Slice.end());
+    mitk::LabelOutlineTracer::Outlines outlines;
+
+    mitk::LabelOutlineTracer::Trace(slice.data(), 4, 3, outlines, mitk::LabelOutlineTracer::SingleLabel, 2);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), outlines.GetNumberOfLines());
+    AssertLine(outlines, 0, 2, {2, 1, 4, 1, 4, 2, 3, 2, 3, 3, 2, 3, 2, 1});
+
+    // label 0 is a label like any other
+    mitk::LabelOutlineTracer::Trace(slice.data(), 4, 3, outlines, mitk::LabelOutlineTracer::SingleLabel, 0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), outlines.GetNumberOfLines());
+    AssertClosed(outlines);
+  }
+
+  void TestHolesAndDiagonalPixels()
+  {
+    const std::vector<unsigned char> ring = {1, 1, 1, 1, 1,
+                                             1, 0, 0, 0, 1,
+                                             1, 0, 1, 0, 1,
+                                             1, 0, 0, 0, 1,
+                                             1, 1, 1, 1, 1};
+    mitk::LabelOutlineTracer::Outlines outlines;
+    mitk::LabelOutlineTracer::Trace(ring.data(), 5, 5, outlines);
+
+    // outer boundary, boundary of the hole and the island in the hole
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), outlines.GetNumberOfLines());
+    AssertLine(outlines, 0, 1, {0, 0, 5, 0, 5, 5, 0, 5, 0, 0});
+    AssertLine(outlines, 1, 1, {1, 1, 1, 4, 4, 4, 4, 1, 1, 1});
+    AssertLine(outlines, 2, 1, {2, 2, 3, 2, 3, 3, 2, 3, 2, 2});
+
+    const std::vector<unsigned char> diagonal = {1, 0,
+                                                 0, 1};
+    mitk::LabelOutlineTracer::Trace(diagonal.data(), 2, 2, outlines);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), outlines.GetNumberOfLines());
+    AssertLine(outlines, 0, 1, {0, 0, 1, 0, 1, 1, 0, 1, 0, 0});
+    AssertLine(outlines, 1, 1, {1, 1, 2, 1, 2, 2, 1, 2, 1, 1});
+  }
+
+  void TestThreadsAgree()
+  {
+    const unsigned int width = 211;
+    const unsigned int height = 157;
+    std::vector<unsigned short> slice(width * height);
+    for (unsigned int y = 0; y < height; ++y)
+    {
+      for (unsigned int x = 0; x < width; ++x)
+      {
+        slice[y * width + x] = static_cast<unsigned short>(((x / 7) * 3 + (y / 5) * 5 + x * y) % 4);
+      }
+    }
+
+    mitk::LabelOutlineTracer::Outlines serial;
+    mitk::LabelOutlineTracer::Outlines parallel;
+    mitk::LabelOutlineTracer::Trace(slice.data(), width, height, serial, mitk::LabelOutlineTracer::AllLabels, 0, 1);
+    mitk::LabelOutlineTracer::Trace(slice.data(), width, height, parallel, mitk::LabelOutlineTracer::AllLabels, 0, 4);
+
+    CPPUNIT_ASSERT(serial.GetNumberOfLines() > 0);
+    AssertClosed(serial);
+    CPPUNIT_ASSERT(serial.Points == parallel.Points);
+    CPPUNIT_ASSERT(serial.LineOffsets == parallel.LineOffsets);
+    CPPUNIT_ASSERT(serial.LineLabels == parallel.LineLabels);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelOutlineTracer)
@@ -0,0 +1,155 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkDataNode.h>
+#include <mitkPointSet.h>
+#include <mitkProperties.h>
+#include <mitkPropertyKey.h>
+#include <mitkPropertyList.h>
+
+#include <thread>
+#include <vector>
+
+class mitkPropertyKeyTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPropertyKeyTestSuite);
+  MITK_TEST(TestKeysAreInterned);
+  MITK_TEST(TestConcurrentKeysAreInterned);
+  MITK_TEST(TestPropertyListIndexFollowsChanges);
+  MITK_TEST(TestClonedPropertyListHasIndex);
+  MITK_TEST(TestDataNodeFallsBackOnDataProperties);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void TestKeysAreInterned()
+  {
+    const mitk::PropertyKey key("mitkPropertyKeyTest.interned");
+    CPPUNIT_ASSERT(key == mitk::PropertyKey(std::string("mitkPropertyKeyTest.interned")));
+    CPPUNIT_ASSERT(key != mitk::PropertyKey("mitkPropertyKeyTest.other"));
+    CPPUNIT_ASSERT_EQUAL(std::string("mitkPropertyKeyTest.interned"), key.GetString());
+
+    CPPUNIT_ASSERT(mitk::PropertyKey().GetString().empty());
+    CPPUNIT_ASSERT(mitk::PropertyKey() == mitk::PropertyKey(""));
+
+    mitk::PropertyKey found;
+    CPPUNIT_ASSERT(mitk::PropertyKey::Find("mitkPropertyKeyTest.interned", found));
+    CPPUNIT_ASSERT(found == key);
+    CPPUNIT_ASSERT(!mitk::PropertyKey::Find("mitkPropertyKeyTest.never created", found));
+  }
+
+  void TestConcurrentKeysAreInterned()
+  {
+    const int numberOfThreads = 4;
+    const int numberOfKeys = 200;
+    std::vector<std::vector<mitk::PropertyKey::IdType>> ids(numberOfThreads, std::vector<mitk::PropertyKey::IdType>(numberOfKeys));
+    std::vector<int> missingKeys(numberOfThreads, 0);
+
+    // every thread creates the same new keys and looks them up again, partly while others insert them
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numberOfThreads; ++t)
+    {
+      threads.emplace_back([&ids, &missingKeys, t]() {
+        for (int k = 0; k < numberOfKeys; ++k)
+        {
+          const std::string name = "mitkPropertyKeyTest.concurrent" + std::to_string(k);
+          ids[t][k] = mitk::PropertyKey(name).GetId();
+
+          mitk::PropertyKey found;
+          if (!mitk::PropertyKey::Find(name, found) || found.GetId() != ids[t][k] || found.GetString() != name)
+            ++missingKeys[t];
+        }
+      });
+    }
+    for (auto &thread : threads)
+      thread.join();
+
+    for (int t = 0; t < numberOfThreads; ++t)
+    {
+      CPPUNIT_ASSERT_EQUAL(0, missingKeys[t]);
+      CPPUNIT_ASSERT(ids[t] == ids[0]);
+    }
+  }
+
+  void TestPropertyListIndexFollowsChanges()
+  {
+    mitk::PropertyList::Pointer list = mitk::PropertyList::New();
+    const mitk::PropertyKey boolKey("mitkPropertyKeyTest.bool");
+    const mitk::PropertyKey intKey("mitkPropertyKeyTest.int");
+
+    list->SetBoolProperty("mitkPropertyKeyTest.bool", true);
+    list->SetIntProperty("mitkPropertyKeyTest.int", 3);
+    CPPUNIT_ASSERT(list->GetProperty(boolKey) == list->GetProperty("mitkPropertyKeyTest.bool"));
+    CPPUNIT_ASSERT(list->GetProperty(intKey) == list->GetProperty("mitkPropertyKeyTest.int"));
+
+    // the index refers to the new property object
+    mitk::StringProperty::Pointer replacement = mitk::StringProperty::New("replaced");
+    list->ReplaceProperty("mitkPropertyKeyTest.bool", replacement);
+    CPPUNIT_ASSERT(list->GetProperty(boolKey) == replacement.GetPointer());
+
+    list->DeleteProperty("mitkPropertyKeyTest.bool");
+    CPPUNIT_ASSERT(list->GetProperty(boolKey) == nullptr);
+    CPPUNIT_ASSERT(list->GetProperty(intKey) != nullptr);
+
+    list->RemoveProperty("mitkPropertyKeyTest.int");
+    CPPUNIT_ASSERT(list->GetProperty(intKey) == nullptr);
+
+    list->SetIntProperty("mitkPropertyKeyTest.int", 4);
+    list->Clear();
+    CPPUNIT_ASSERT(list->GetProperty(intKey) == nullptr);
+  }
+
+  void TestClonedPropertyListHasIndex()
+  {
+    mitk::PropertyList::Pointer list = mitk::PropertyList::New();
+    list->SetIntProperty("mitkPropertyKeyTest.cloned", 7);
+
+    mitk::PropertyList::Pointer clone = list->Clone();
+    auto property = dynamic_cast<mitk::IntProperty *>(clone->GetProperty(mitk::PropertyKey("mitkPropertyKeyTest.cloned")));
+
+    CPPUNIT_ASSERT(property != nullptr);
+    CPPUNIT_ASSERT(property != list->GetProperty("mitkPropertyKeyTest.cloned"));
+    CPPUNIT_ASSERT_EQUAL(7, property->GetValue());
+  }
+
+  void TestDataNodeFallsBackOnDataProperties()
+  {
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    mitk::PointSet::Pointer data = mitk::PointSet::New();
+    node->SetData(data);
+
+    data->SetProperty("mitkPropertyKeyTest.data", mitk::IntProperty::New(1));
+    node->SetIntProperty("mitkPropertyKeyTest.node", 2);
+
+    int value = 0;
+    CPPUNIT_ASSERT(node->GetIntProperty(mitk::PropertyKey("mitkPropertyKeyTest.data"), value));
+    CPPUNIT_ASSERT_EQUAL(1, value);
+    CPPUNIT_ASSERT(node->GetIntProperty(mitk::PropertyKey("mitkPropertyKeyTest.node"), value));
+    CPPUNIT_ASSERT_EQUAL(2, value);
+
+    // node properties win over data properties
+    node->SetIntProperty("mitkPropertyKeyTest.data", 3);
+    CPPUNIT_ASSERT(node->GetIntProperty(mitk::PropertyKey("mitkPropertyKeyTest.data"), value));
+    CPPUNIT_ASSERT_EQUAL(3, value);
+
+    CPPUNIT_ASSERT(node->GetProperty(mitk::PropertyKey("mitkPropertyKeyTest.data"), nullptr, false) != nullptr);
+    CPPUNIT_ASSERT(node->GetProperty("mitkPropertyKeyTest.unknown") == nullptr);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPropertyKey)
@@ -0,0 +1,166 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkImageGenerator.h>
+#include <mitkReslicedImageCache.h>
+#include <mitkSlicedGeometry3D.h>
+
+#include <cstring>
+
+class mitkReslicedImageCacheTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkReslicedImageCacheTestSuite);
+  MITK_TEST(TestKeysIdentifySlices);
+  MITK_TEST(TestMemoryBudgetEvictsLeastRecentlyUsedSlice);
+  MITK_TEST(TestModifiedImageDropsSlices);
+  MITK_TEST(TestPrefetchedSlicesMatchResliceResult);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+  mitk::SlicedGeometry3D::Pointer m_WorldGeometry;
+
+  mitk::ReslicedImageCache::KeyType CreateKey(
+    int slice, mitk::ExtractSliceFilter::ResliceInterpolation interpolation = mitk::ExtractSliceFilter::RESLICE_NEAREST)
+  {
+    return mitk::ReslicedImageCache::CreateKey(
+      m_Image, 0, m_WorldGeometry->GetPlaneGeometry(slice), interpolation, false);
+  }
+
+  mitk::ReslicedImageCache::Slice Reslice(int slice)
+  {
+    mitk::ExtractSliceFilter::Pointer reslicer = mitk::ExtractSliceFilter::New();
+    reslicer->SetInput(m_Image);
+    reslicer->SetWorldGeometry(m_WorldGeometry->GetPlaneGeometry(slice));
+    reslicer->SetTimeStep(0);
+    reslicer->SetResliceTransformByGeometry(m_Image->GetTimeGeometry()->GetGeometryForTimeStep(0));
+    reslicer->SetVtkOutputRequest(true);
+    reslicer->UpdateLargestPossibleRegion();
+    return mitk::ReslicedImageCache::CreateSlice(reslicer);
+  }
+
+  static bool HaveEqualScalars(vtkImageData *first, vtkImageData *second)
+  {
+    const vtkIdType size = first->GetNumberOfPoints() * first->GetScalarSize() * first->GetNumberOfScalarComponents();
+    return first->GetNumberOfPoints() == second->GetNumberOfPoints() &&
+           0 == std::memcmp(first->GetScalarPointer(), second->GetScalarPointer(), size);
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::ImageGenerator::GenerateGradientImage<unsigned short>(32, 24, 16);
+
+    m_WorldGeometry = mitk::SlicedGeometry3D::New();
+    m_WorldGeometry->InitializePlanes(m_Image->GetGeometry(), mitk::PlaneGeometry::Axial);
+    m_WorldGeometry->SetReferenceGeometry(m_Image->GetGeometry());
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_WorldGeometry = nullptr;
+  }
+
+  void TestKeysIdentifySlices()
+  {
+    CPPUNIT_ASSERT(this->CreateKey(3) == this->CreateKey(3));
+    CPPUNIT_ASSERT(this->CreateKey(3) != this->CreateKey(4));
+    CPPUNIT_ASSERT(this->CreateKey(3) != this->CreateKey(3, mitk::ExtractSliceFilter::RESLICE_LINEAR));
+  }
+
+  void TestMemoryBudgetEvictsLeastRecentlyUsedSlice()
+  {
+    mitk::ReslicedImageCache cache;
+    cache.SetImage(m_Image);
+
+    cache.Add(this->CreateKey(0), this->Reslice(0));
+    const std::size_t sliceSize = cache.GetMemoryUsage();
+    CPPUNIT_ASSERT(sliceSize > 0);
+
+    cache.SetMemoryBudget(3 * sliceSize);
+    cache.Add(this->CreateKey(1), this->Reslice(1));
+    cache.Add(this->CreateKey(2), this->Reslice(2));
+
+    // slice 0 becomes the most recently used slice, slice 1 has to go
+    mitk::ReslicedImageCache::Slice slice;
+    CPPUNIT_ASSERT(cache.Get(this->CreateKey(0), slice));
+    cache.Add(this->CreateKey(3), this->Reslice(3));
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), cache.GetNumberOfSlices());
+    CPPUNIT_ASSERT(cache.GetMemoryUsage() <= cache.GetMemoryBudget());
+    CPPUNIT_ASSERT(cache.Get(this->CreateKey(0), slice));
+    CPPUNIT_ASSERT(!cache.Get(this->CreateKey(1), slice));
+    CPPUNIT_ASSERT(cache.Get(this->CreateKey(2), slice));
+    CPPUNIT_ASSERT(cache.Get(this->CreateKey(3), slice));
+
+    cache.SetMemoryBudget(0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.GetNumberOfSlices());
+  }
+
+  void TestModifiedImageDropsSlices()
+  {
+    mitk::ReslicedImageCache cache;
+    cache.SetImage(m_Image);
+    cache.Add(this->CreateKey(5), this->Reslice(5));
+
+    cache.SetImage(m_Image);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), cache.GetNumberOfSlices());
+
+    m_Image->Modified();
+    cache.SetImage(m_Image);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.GetNumberOfSlices());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.GetMemoryUsage());
+  }
+
+  void TestPrefetchedSlicesMatchResliceResult()
+  {
+    mitk::ReslicedImageCache cache;
+    cache.SetImage(m_Image);
+
+    std::vector<mitk::PlaneGeometry::ConstPointer> planes;
+    planes.push_back(m_WorldGeometry->GetPlaneGeometry(6));
+    planes.push_back(m_WorldGeometry->GetPlaneGeometry(7));
+
+    cache.Prefetch(m_Image, 0, planes, mitk::ExtractSliceFilter::RESLICE_NEAREST, false);
+    cache.WaitForPrefetch();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), cache.GetNumberOfSlices());
+
+    for (int slice = 6; slice <= 7; ++slice)
+    {
+      mitk::ReslicedImageCache::Slice prefetched;
+      CPPUNIT_ASSERT(cache.Get(this->CreateKey(slice), prefetched));
+
+      mitk::ReslicedImageCache::Slice resliced = this->Reslice(slice);
+      CPPUNIT_ASSERT(HaveEqualScalars(prefetched.Image, resliced.Image));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(resliced.Spacing[0], prefetched.Spacing[0], mitk::eps);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(resliced.Spacing[1], prefetched.Spacing[1], mitk::eps);
+      for (int i = 0; i < 4; ++i)
+      {
+        for (int j = 0; j < 4; ++j)
+        {
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(
+            resliced.ResliceAxes->GetElement(i, j), prefetched.ResliceAxes->GetElement(i, j), mitk::eps);
+        }
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkReslicedImageCache)
@@ -0,0 +1,158 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkImageGenerator.h>
+#include <mitkSlicedGeometry3D.h>
+#include <mitkSlidingThickSlab.h>
+
+#include <vtkMitkThickSlicesFilter.h>
+
+#include <cstdlib>
+
+class mitkSlidingThickSlabTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSlidingThickSlabTestSuite);
+  MITK_TEST(TestScrollingMatchesThickSlicesFilter);
+  MITK_TEST(TestScrollingReslicesOnlyNewPlanes);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static const int NumberOfSlices = 2;
+
+  mitk::Image::Pointer m_Image;
+  mitk::SlicedGeometry3D::Pointer m_WorldGeometry;
+
+  mitk::ExtractSliceFilter::Pointer CreateReslicer(int slice)
+  {
+    mitk::ExtractSliceFilter::Pointer reslicer = mitk::ExtractSliceFilter::New();
+    reslicer->SetInput(m_Image);
+    reslicer->SetWorldGeometry(m_WorldGeometry->GetPlaneGeometry(slice));
+    reslicer->SetTimeStep(0);
+    reslicer->SetResliceTransformByGeometry(m_Image->GetTimeGeometry()->GetGeometryForTimeStep(0));
+    reslicer->SetVtkOutputRequest(true);
+    return reslicer;
+  }
+
+  vtkImageData *UpdateSlab(mitk::SlidingThickSlab &slab, int slice, int mode)
+  {
+    mitk::ExtractSliceFilter::Pointer reslicer = this->CreateReslicer(slice);
+    return slab.Update(reslicer,
+                       m_Image,
+                       0,
+                       m_WorldGeometry->GetPlaneGeometry(slice),
+                       mitk::ExtractSliceFilter::RESLICE_NEAREST,
+                       false,
+                       1.0,
+                       mode,
+                       NumberOfSlices);
+  }
+
+  /** The thick slice as ImageVtkMapper2D computed it before */
+  vtkSmartPointer<vtkImageData> FilterSlab(int slice, int mode)
+  {
+    mitk::ExtractSliceFilter::Pointer reslicer = this->CreateReslicer(slice);
+    reslicer->SetOutputDimensionality(3);
+    reslicer->SetOutputSpacingZDirection(1.0);
+    reslicer->SetOutputExtentZDirection(-NumberOfSlices, NumberOfSlices);
+    reslicer->Update();
+
+    vtkSmartPointer<vtkMitkThickSlicesFilter> filter = vtkSmartPointer<vtkMitkThickSlicesFilter>::New();
+    filter->SetThickSliceMode(mode);
+    filter->SetInputData(reslicer->GetVtkOutput());
+    filter->Update();
+    return filter->GetOutput();
+  }
+
+  static void AssertEqualSlices(vtkImageData *expected, vtkImageData *actual, int tolerance)
+  {
+    CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfPoints(), actual->GetNumberOfPoints());
+    CPPUNIT_ASSERT_EQUAL(expected->GetScalarType(), actual->GetScalarType());
+
+    const auto *expectedValues = static_cast<const short *>(expected->GetScalarPointer());
+    const auto *actualValues = static_cast<const short *>(actual->GetScalarPointer());
+    for (vtkIdType i = 0; i < expected->GetNumberOfPoints(); ++i)
+    {
+      CPPUNIT_ASSERT(std::abs(expectedValues[i] - actualValues[i]) <= tolerance);
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<short>(32, 24, 16, 1, 1, 1, 1, 1000, 0);
+
+    m_WorldGeometry = mitk::SlicedGeometry3D::New();
+    m_WorldGeometry->InitializePlanes(m_Image->GetGeometry(), mitk::PlaneGeometry::Axial);
+    m_WorldGeometry->SetReferenceGeometry(m_Image->GetGeometry());
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_WorldGeometry = nullptr;
+  }
+
+  void TestScrollingMatchesThickSlicesFilter()
+  {
+    const int modes[] = {vtkMitkThickSlicesFilter::MIP,
+                         vtkMitkThickSlicesFilter::SUM,
+                         vtkMitkThickSlicesFilter::WEIGHTED,
+                         vtkMitkThickSlicesFilter::MINIP,
+                         vtkMitkThickSlicesFilter::MEAN};
+    const int slices[] = {5, 6, 7, 9, 8, 8, 1, 14};
+
+    for (int mode : modes)
+    {
+      mitk::SlidingThickSlab slab;
+      for (int slice : slices)
+      {
+        // the weights are applied in the same order, but the compiler may contract the operations differently
+        AssertEqualSlices(this->FilterSlab(slice, mode),
+                          this->UpdateSlab(slab, slice, mode),
+                          mode == vtkMitkThickSlicesFilter::WEIGHTED ? 1 : 0);
+      }
+    }
+  }
+
+  void TestScrollingReslicesOnlyNewPlanes()
+  {
+    mitk::SlidingThickSlab slab;
+
+    this->UpdateSlab(slab, 5, vtkMitkThickSlicesFilter::MIP);
+    CPPUNIT_ASSERT_EQUAL(2 * NumberOfSlices + 1, slab.GetNumberOfReslicedPlanes());
+
+    this->UpdateSlab(slab, 6, vtkMitkThickSlicesFilter::MIP);
+    CPPUNIT_ASSERT_EQUAL(1, slab.GetNumberOfReslicedPlanes());
+
+    this->UpdateSlab(slab, 4, vtkMitkThickSlicesFilter::MIP);
+    CPPUNIT_ASSERT_EQUAL(2, slab.GetNumberOfReslicedPlanes());
+
+    this->UpdateSlab(slab, 4, vtkMitkThickSlicesFilter::MIP);
+    CPPUNIT_ASSERT_EQUAL(0, slab.GetNumberOfReslicedPlanes());
+
+    // a jump larger than the slab and a new mode need all planes
+    this->UpdateSlab(slab, 12, vtkMitkThickSlicesFilter::MIP);
+    CPPUNIT_ASSERT_EQUAL(2 * NumberOfSlices + 1, slab.GetNumberOfReslicedPlanes());
+
+    this->UpdateSlab(slab, 12, vtkMitkThickSlicesFilter::SUM);
+    CPPUNIT_ASSERT_EQUAL(2 * NumberOfSlices + 1, slab.GetNumberOfReslicedPlanes());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSlidingThickSlab)
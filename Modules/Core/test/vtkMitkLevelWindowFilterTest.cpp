@@ -0,0 +1,194 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <vtkMitkLevelWindowFilter.h>
+
+#include <vtkColorTransferFunction.h>
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkSmartPointer.h>
+
+#include <limits>
+
+/**
+ * Compares the table based mapping of 8 and 16 bit integer images with the per-pixel mapping,
+ * which is used for a float image with the same values.
+ */
+class vtkMitkLevelWindowFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(vtkMitkLevelWindowFilterTestSuite);
+  MITK_TEST(LinearLookupTable_IntegerEqualsPerPixel);
+  MITK_TEST(LogLookupTable_IntegerEqualsPerPixel);
+  MITK_TEST(ColorTransferFunction_IntegerEqualsPerPixel);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  // the integer table of 16 bit types is only used for at least 2^16 pixels
+  static const int m_Size = 256;
+
+  double m_ClippingBounds[4];
+
+  /** Creates a slice of the scalar type that contains every value of 8 and 16 bit types and a float slice
+  with the same values.*/
+  template <typename T>
+  void CreateSlices(int scalarType,
+                    vtkSmartPointer<vtkImageData> &integerSlice,
+                    vtkSmartPointer<vtkImageData> &floatSlice)
+  {
+    integerSlice = vtkSmartPointer<vtkImageData>::New();
+    integerSlice->SetDimensions(m_Size, m_Size, 1);
+    integerSlice->AllocateScalars(scalarType, 1);
+
+    floatSlice = vtkSmartPointer<vtkImageData>::New();
+    floatSlice->SetDimensions(m_Size, m_Size, 1);
+    floatSlice->AllocateScalars(VTK_FLOAT, 1);
+
+    auto *integerValues = static_cast<T *>(integerSlice->GetScalarPointer());
+    auto *floatValues = static_cast<float *>(floatSlice->GetScalarPointer());
+    const int minimum = std::numeric_limits<T>::min();
+    const int numberOfValues = std::numeric_limits<T>::max() - minimum + 1;
+    for (int i = 0; i < m_Size * m_Size; ++i)
+    {
+      integerValues[i] = static_cast<T>(minimum + i % numberOfValues);
+      floatValues[i] = static_cast<float>(integerValues[i]);
+    }
+  }
+
+  vtkSmartPointer<vtkImageData> ApplyFilter(vtkImageData *slice, vtkScalarsToColors *lookupTable,
+                                            vtkPiecewiseFunction *opacityFunction)
+  {
+    vtkSmartPointer<vtkMitkLevelWindowFilter> filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    filter->SetInputData(slice);
+    filter->SetLookupTable(lookupTable);
+    filter->SetOpacityPiecewiseFunction(opacityFunction);
+    filter->SetClippingBounds(m_ClippingBounds);
+    // several extents, so that the rows are split between threads
+    filter->SetNumberOfThreads(4);
+    filter->Update();
+
+    vtkSmartPointer<vtkImageData> result = vtkSmartPointer<vtkImageData>::New();
+    result->DeepCopy(filter->GetOutput());
+    return result;
+  }
+
+  bool IsClipped(int x, int y) const
+  {
+    return x < m_ClippingBounds[0] || x >= m_ClippingBounds[1] || y < m_ClippingBounds[2] || y >= m_ClippingBounds[3];
+  }
+
+  void CompareOutputs(vtkImageData *integerOutput, vtkImageData *floatOutput, const std::string &name)
+  {
+    auto *integerRGBA = static_cast<unsigned char *>(integerOutput->GetScalarPointer());
+    auto *floatRGBA = static_cast<unsigned char *>(floatOutput->GetScalarPointer());
+
+    int numberOfVisiblePixels = 0;
+    for (int y = 0; y < m_Size; ++y)
+    {
+      for (int x = 0; x < m_Size; ++x)
+      {
+        const int pixel = 4 * (y * m_Size + x);
+        for (int c = 0; c < 4; ++c)
+        {
+          CPPUNIT_ASSERT_EQUAL_MESSAGE(name + ": integer mapping equals per-pixel mapping",
+                                       static_cast<int>(floatRGBA[pixel + c]),
+                                       static_cast<int>(integerRGBA[pixel + c]));
+          if (IsClipped(x, y))
+          {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(name + ": clipped pixels are transparent", 0,
+                                         static_cast<int>(integerRGBA[pixel + c]));
+          }
+        }
+        if (!IsClipped(x, y))
+          ++numberOfVisiblePixels;
+      }
+    }
+    CPPUNIT_ASSERT_MESSAGE(name + ": clipping bounds cut the slice",
+                           numberOfVisiblePixels > 0 && numberOfVisiblePixels < m_Size * m_Size);
+  }
+
+  template <typename T>
+  void CompareScalarType(int scalarType, vtkScalarsToColors *lookupTable, vtkPiecewiseFunction *opacityFunction,
+                         const std::string &name)
+  {
+    vtkSmartPointer<vtkImageData> integerSlice;
+    vtkSmartPointer<vtkImageData> floatSlice;
+    CreateSlices<T>(scalarType, integerSlice, floatSlice);
+
+    auto integerOutput = ApplyFilter(integerSlice, lookupTable, opacityFunction);
+    auto floatOutput = ApplyFilter(floatSlice, lookupTable, opacityFunction);
+    CompareOutputs(integerOutput, floatOutput, name);
+  }
+
+  void CompareAllScalarTypes(vtkScalarsToColors *lookupTable, vtkPiecewiseFunction *opacityFunction)
+  {
+    CompareScalarType<unsigned char>(VTK_UNSIGNED_CHAR, lookupTable, opacityFunction, "unsigned char");
+    CompareScalarType<signed char>(VTK_SIGNED_CHAR, lookupTable, opacityFunction, "signed char");
+    CompareScalarType<short>(VTK_SHORT, lookupTable, opacityFunction, "short");
+    CompareScalarType<unsigned short>(VTK_UNSIGNED_SHORT, lookupTable, opacityFunction, "unsigned short");
+  }
+
+public:
+  void setUp() override
+  {
+    // non-integer bounds that cut all four sides of the slice
+    m_ClippingBounds[0] = 13.4;
+    m_ClippingBounds[1] = 200.6;
+    m_ClippingBounds[2] = 20;
+    m_ClippingBounds[3] = 230.5;
+  }
+
+  void LinearLookupTable_IntegerEqualsPerPixel()
+  {
+    vtkSmartPointer<vtkLookupTable> lookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    lookupTable->SetTableRange(-50, 170);
+    lookupTable->SetHueRange(0.0, 0.7);
+    lookupTable->SetAlphaRange(0.2, 1.0);
+    lookupTable->Build();
+
+    CompareAllScalarTypes(lookupTable, nullptr);
+  }
+
+  void LogLookupTable_IntegerEqualsPerPixel()
+  {
+    vtkSmartPointer<vtkLookupTable> lookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    lookupTable->SetScaleToLog10();
+    lookupTable->SetTableRange(1, 1000);
+    lookupTable->Build();
+
+    CompareAllScalarTypes(lookupTable, nullptr);
+  }
+
+  void ColorTransferFunction_IntegerEqualsPerPixel()
+  {
+    vtkSmartPointer<vtkColorTransferFunction> transferFunction = vtkSmartPointer<vtkColorTransferFunction>::New();
+    transferFunction->AddRGBPoint(-100, 0.0, 0.0, 1.0);
+    transferFunction->AddRGBPoint(0, 1.0, 1.0, 1.0);
+    transferFunction->AddRGBPoint(120, 1.0, 0.0, 0.0);
+
+    vtkSmartPointer<vtkPiecewiseFunction> opacityFunction = vtkSmartPointer<vtkPiecewiseFunction>::New();
+    opacityFunction->AddPoint(-20, 0.0);
+    opacityFunction->AddPoint(100, 1.0);
+
+    CompareAllScalarTypes(transferFunction, opacityFunction);
+    CompareAllScalarTypes(transferFunction, nullptr);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(vtkMitkLevelWindowFilter)
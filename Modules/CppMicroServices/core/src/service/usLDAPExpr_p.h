@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <string>
+#include <utility>
 
 US_BEGIN_NAMESPACE
 
@@ -57,6 +58,7 @@ public:
   typedef std::vector<std::string> StringList;
   typedef std::vector<StringList> LocalCache;
   typedef US_UNORDERED_SET_TYPE<std::string> ObjectClassSet;
+  typedef std::vector<std::pair<std::string, std::string> > AttributeValueList;
 
 
   /**
@@ -83,6 +85,18 @@ public:
    */
   bool GetMatchedObjectClasses(ObjectClassSet& objClasses) const;
 
+  /**
+   * Get the <code>(<it>name</it>=<it>value</it>)</code> terms which every
+   * matching property set must satisfy, i.e. the equality terms without
+   * wildcards which are the expression itself or operands of (nested)
+   * AND expressions. Terms below OR and NOT expressions are not required
+   * and are therefore ignored.
+   *
+   * \param terms The attribute name and value of the required terms will be
+   *        added to terms.
+   */
+  void GetRequiredEqualityTerms(AttributeValueList& terms) const;
+
   /**
    * Checks if this LDAP expression is "simple". The definition of
    * a simple filter is:
@@ -19,9 +19,12 @@
 
 =============================================================================*/
 
+#include <algorithm>
 #include <iterator>
+#include <list>
 #include <stdexcept>
 #include <cassert>
+#include <cctype>
 
 #include "usServiceRegistry_p.h"
 #include "usServiceFactory.h"
@@ -34,6 +37,33 @@
 
 US_BEGIN_NAMESPACE
 
+namespace {
+
+// Bounds the memory used by clients which create many different filters
+const std::size_t MaxCachedFilters = 256;
+
+bool IsObjectClass(const std::string& attribute)
+{
+  const std::string& objectClass = ServiceConstants::OBJECTCLASS();
+  if (attribute.size() != objectClass.size()) return false;
+  for (std::size_t i = 0; i < attribute.size(); ++i)
+  {
+    if (std::tolower(attribute[i]) != std::tolower(objectClass[i])) return false;
+  }
+  return true;
+}
+
+void AddPosition(std::vector<std::size_t>& positions, std::size_t pos)
+{
+  // a list property may contain the same value more than once
+  if (positions.empty() || positions.back() != pos)
+  {
+    positions.push_back(pos);
+  }
+}
+
+}
+
 ServicePropertiesImpl ServiceRegistry::CreateServiceProperties(const ServiceProperties& in,
                                                                const std::vector<std::string>& classes,
                                                                bool isFactory, bool isPrototypeFactory,
@@ -81,6 +111,8 @@ void ServiceRegistry::Clear()
   services.clear();
   serviceRegistrations.clear();
   classServices.clear();
+  propertyIndices.clear();
+  filterCache.clear();
   core = nullptr;
 }
 
@@ -123,6 +155,7 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
           std::lower_bound(s.begin(), s.end(), res);
       s.insert(ip, res);
     }
+    InvalidatePropertyIndex_unlocked(classes);
   }
 
   ServiceReferenceBase r = res.GetReference(std::string());
@@ -145,6 +178,99 @@ void ServiceRegistry::UpdateServiceRegistrationOrder(const ServiceRegistrationBa
     s.erase(std::remove(s.begin(), s.end(), sr), s.end());
     s.insert(std::lower_bound(s.begin(), s.end(), sr), sr);
   }
+  InvalidatePropertyIndex_unlocked(classes);
+}
+
+void ServiceRegistry::InvalidatePropertyIndex(const std::vector<std::string>& classes)
+{
+  MutexLock lock(mutex);
+  InvalidatePropertyIndex_unlocked(classes);
+}
+
+void ServiceRegistry::InvalidatePropertyIndex_unlocked(const std::vector<std::string>& classes)
+{
+  for (std::vector<std::string>::const_iterator i = classes.begin();
+       i != classes.end(); ++i)
+  {
+    MapPropertyIndices::iterator first = propertyIndices.lower_bound(std::make_pair(*i, std::string()));
+    MapPropertyIndices::iterator last = first;
+    while (last != propertyIndices.end() && last->first.first == *i)
+    {
+      ++last;
+    }
+    propertyIndices.erase(first, last);
+  }
+}
+
+LDAPExpr ServiceRegistry::GetFilter_unlocked(const std::string& filter) const
+{
+  US_UNORDERED_MAP_TYPE<std::string, LDAPExpr>::const_iterator i = filterCache.find(filter);
+  if (i != filterCache.end())
+  {
+    return i->second;
+  }
+
+  // throws std::invalid_argument for malformed filters, which are not cached
+  LDAPExpr ldap(filter);
+  if (filterCache.size() >= MaxCachedFilters)
+  {
+    filterCache.clear();
+  }
+  filterCache.insert(std::make_pair(filter, ldap));
+  return ldap;
+}
+
+const ServiceRegistry::PropertyIndex& ServiceRegistry::GetPropertyIndex_unlocked(
+    const std::string& clazz, const std::string& attribute,
+    const std::vector<ServiceRegistrationBase>& serviceRegs) const
+{
+  std::pair<std::string, std::string> key(clazz, attribute);
+  MapPropertyIndices::const_iterator i = propertyIndices.find(key);
+  if (i != propertyIndices.end())
+  {
+    return i->second;
+  }
+
+  PropertyIndex& index = propertyIndices[key];
+  for (std::size_t pos = 0; pos < serviceRegs.size(); ++pos)
+  {
+    const ServicePropertiesImpl& props = serviceRegs[pos].d->properties;
+
+    // look up the property the same way LDAPExpr::Evaluate does
+    int propIndex = props.FindCaseSensitive(attribute);
+    if (propIndex < 0) propIndex = props.Find(attribute);
+    if (propIndex < 0) continue; // can never match
+
+    const Any& value = props.Value(propIndex);
+    if (value.Empty()) continue;
+
+    const std::type_info& type = value.Type();
+    if (type == typeid(std::string))
+    {
+      index.valuePositions[ref_any_cast<std::string>(value)].push_back(pos);
+    }
+    else if (type == typeid(std::vector<std::string>))
+    {
+      const std::vector<std::string>& list = ref_any_cast<std::vector<std::string> >(value);
+      for (std::vector<std::string>::const_iterator it = list.begin(); it != list.end(); ++it)
+      {
+        AddPosition(index.valuePositions[*it], pos);
+      }
+    }
+    else if (type == typeid(std::list<std::string>))
+    {
+      const std::list<std::string>& list = ref_any_cast<std::list<std::string> >(value);
+      for (std::list<std::string>::const_iterator it = list.begin(); it != list.end(); ++it)
+      {
+        AddPosition(index.valuePositions[*it], pos);
+      }
+    }
+    else
+    {
+      index.otherPositions.push_back(pos);
+    }
+  }
+  return index;
 }
 
 void ServiceRegistry::Get(const std::string& clazz,
@@ -203,7 +329,7 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   {
     if (!filter.empty())
     {
-      ldap = LDAPExpr(filter);
+      ldap = GetFilter_unlocked(filter);
       LDAPExpr::ObjectClassSet matched;
       if (ldap.GetMatchedObjectClasses(matched))
       {
@@ -253,7 +379,47 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
     }
     if (!filter.empty())
     {
-      ldap = LDAPExpr(filter);
+      ldap = GetFilter_unlocked(filter);
+
+      // Narrow the services down to the candidates which satisfy a required
+      // (name=value) term of the filter, in ranking order. The candidates are
+      // still evaluated against the complete filter below.
+      LDAPExpr::AttributeValueList terms;
+      ldap.GetRequiredEqualityTerms(terms);
+      for (LDAPExpr::AttributeValueList::const_iterator term = terms.begin();
+           term != terms.end(); ++term)
+      {
+        if (IsObjectClass(term->first)) continue;
+
+        const PropertyIndex& index = GetPropertyIndex_unlocked(clazz, term->first, it->second);
+        US_UNORDERED_MAP_TYPE<std::string, std::vector<std::size_t> >::const_iterator values =
+            index.valuePositions.find(term->second);
+
+        std::vector<std::size_t> positions;
+        if (values != index.valuePositions.end())
+        {
+          std::merge(values->second.begin(), values->second.end(),
+                     index.otherPositions.begin(), index.otherPositions.end(),
+                     std::back_inserter(positions));
+        }
+        else
+        {
+          positions = index.otherPositions;
+        }
+
+        if (positions.empty())
+        {
+          return;
+        }
+        for (std::vector<std::size_t>::const_iterator pos = positions.begin();
+             pos != positions.end(); ++pos)
+        {
+          v.push_back(it->second[*pos]);
+        }
+        s = v.begin();
+        send = v.end();
+        break;
+      }
     }
   }
 
@@ -303,6 +469,7 @@ void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& s
       classServices.erase(*i);
     }
   }
+  InvalidatePropertyIndex_unlocked(classes);
 }
 
 void ServiceRegistry::GetRegisteredByModule(ModulePrivate* p,
@@ -26,8 +26,11 @@
 #include "usServiceInterface.h"
 #include "usServiceRegistration.h"
 
+#include "usLDAPExpr_p.h"
 #include "usThreads_p.h"
 
+#include <map>
+
 US_BEGIN_NAMESPACE
 
 class CoreModuleContext;
@@ -116,6 +119,14 @@ public:
   void UpdateServiceRegistrationOrder(const ServiceRegistrationBase& sr,
                                       const std::vector<std::string>& classes);
 
+  /**
+   * Service properties changed, discard the property indices
+   * of the given classes.
+   *
+   * @param classes The class names of the modified service.
+   */
+  void InvalidatePropertyIndex(const std::vector<std::string>& classes);
+
   /**
    * Get all services implementing a certain class.
    * Only used internally by the framework.
@@ -173,6 +184,44 @@ private:
 
   friend class ServiceHooks;
 
+  /**
+   * Positions in the ranking ordered list of a class, grouped by the
+   * string values of one service property.
+   */
+  struct PropertyIndex
+  {
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<std::size_t> > valuePositions;
+
+    /**
+     * Positions of services where the property is not a string or
+     * a list of strings. They must always be evaluated.
+     */
+    std::vector<std::size_t> otherPositions;
+  };
+
+  typedef std::map<std::pair<std::string, std::string>, PropertyIndex> MapPropertyIndices;
+
+  /**
+   * Property indices keyed by class name and property name. They are
+   * created on demand by filtered lookups and discarded whenever the
+   * services of the class or their properties change.
+   */
+  mutable MapPropertyIndices propertyIndices;
+
+  /**
+   * Parsed filters, keyed by the filter string. Parsing dominates the
+   * cost of filtered lookups which are typically done with a small set
+   * of different filters.
+   */
+  mutable US_UNORDERED_MAP_TYPE<std::string, LDAPExpr> filterCache;
+
+  LDAPExpr GetFilter_unlocked(const std::string& filter) const;
+
+  const PropertyIndex& GetPropertyIndex_unlocked(const std::string& clazz, const std::string& attribute,
+                                                 const std::vector<ServiceRegistrationBase>& serviceRegs) const;
+
+  void InvalidatePropertyIndex_unlocked(const std::vector<std::string>& classes);
+
   void Get_unlocked(const std::string& clazz, std::vector<ServiceRegistrationBase>& serviceRegs) const;
 
   void Get_unlocked(const std::string& clazz, const std::string& filter,
@@ -203,8 +203,10 @@ public:
 
   void TestAddListeners();
   void TestRegisterServices();
+  void TestLookupServices();
 
   void TestModifyServices();
+  void TestLookupModifiedServices();
   void TestUnregisterServices();
 
 private:
@@ -216,6 +218,7 @@ private:
 
   void AddListeners(int n);
   void RegisterServices(int n);
+  std::size_t LookupServices(int n, const std::string& filterPrefix, const std::string& filterSuffix);
   void ModifyServices();
   void UnregisterServices();
 
@@ -358,6 +361,63 @@ void ServiceRegistryPerformanceTest::RegisterServices(int n)
   }
 }
 
+void ServiceRegistryPerformanceTest::TestLookupServices()
+{
+  Log() << "Look up each of the " << nServices << " services by its pid, and check that "
+        << "we get exactly one service reference per lookup\n";
+
+  HighPrecisionTimer t;
+  t.Start();
+  std::size_t nFound = LookupServices(nServices, "(service.pid=my.service.", ")");
+  long long us = t.ElapsedMicro();
+  Log() << "lookup by pid took " << us << "us ("
+        << (us > 0 ? nServices * 1000LL * 1000LL / us : 0) << " lookups/s)\n";
+  US_TEST_CONDITION_REQUIRED(static_cast<std::size_t>(nServices) == nFound,
+                             "# of found services must be same as # of lookups");
+
+  // a complex filter with one required (name=value) term
+  t.Start();
+  nFound = 0;
+  for(int i = 0; i < nServices; i++)
+  {
+    std::stringstream ss;
+    ss << "(&(perf.service.value>=1)(|(service.pid=my.service." << i << ")(service.pid=none))"
+       << "(service.pid=my.service." << i << "))";
+    nFound += mc->GetServiceReferences<IPerfTestService>(ss.str()).size();
+  }
+  us = t.ElapsedMicro();
+  Log() << "lookup by complex filter took " << us << "us ("
+        << (us > 0 ? nServices * 1000LL * 1000LL / us : 0) << " lookups/s)\n";
+  US_TEST_CONDITION_REQUIRED(static_cast<std::size_t>(nServices) == nFound,
+                             "# of found services must be same as # of complex lookups");
+
+  // the same filter over and over again
+  t.Start();
+  nFound = 0;
+  for(int i = 0; i < nServices; i++)
+  {
+    nFound += mc->GetServiceReferences<IPerfTestService>("(service.pid=my.service.1)").size();
+  }
+  us = t.ElapsedMicro();
+  Log() << "repeated lookup took " << us << "us ("
+        << (us > 0 ? nServices * 1000LL * 1000LL / us : 0) << " lookups/s)\n";
+  US_TEST_CONDITION_REQUIRED(static_cast<std::size_t>(nServices) == nFound,
+                             "# of found services must be same as # of repeated lookups");
+}
+
+std::size_t ServiceRegistryPerformanceTest::LookupServices(int n, const std::string& filterPrefix,
+                                                           const std::string& filterSuffix)
+{
+  std::size_t nFound = 0;
+  for(int i = 0; i < n; i++)
+  {
+    std::stringstream ss;
+    ss << filterPrefix << i << filterSuffix;
+    nFound += mc->GetServiceReferences<IPerfTestService>(ss.str()).size();
+  }
+  return nFound;
+}
+
 void ServiceRegistryPerformanceTest::TestModifyServices()
 {
   Log() << "Modify all services, and check that we get #of services ("
@@ -385,6 +445,19 @@ void ServiceRegistryPerformanceTest::ModifyServices()
   }
 }
 
+void ServiceRegistryPerformanceTest::TestLookupModifiedServices()
+{
+  Log() << "Look up the modified services by their former pid, and check that "
+        << "we do not get any service reference\n";
+
+  // the modified services do not have a service.pid property any more
+  std::size_t nFound = LookupServices(nServices, "(service.pid=my.service.", ")");
+  US_TEST_CONDITION_REQUIRED(0 == nFound, "Modified services must not be found by their former pid");
+
+  nFound = LookupServices(nServices, "(&(perf.service.value>=0)(service.pid=my.service.", "))");
+  US_TEST_CONDITION_REQUIRED(0 == nFound, "Modified services must not be found by a filter with their former pid");
+}
+
 void ServiceRegistryPerformanceTest::TestUnregisterServices()
 {
   Log() << "Unregister all services, and check that we get #of services ("
@@ -420,7 +493,9 @@ int usServiceRegistryPerformanceTest(int /*argc*/, char* /*argv*/[])
   perfTest.InitTestCase();
   perfTest.TestAddListeners();
   perfTest.TestRegisterServices();
+  perfTest.TestLookupServices();
   perfTest.TestModifyServices();
+  perfTest.TestLookupModifiedServices();
   perfTest.TestUnregisterServices();
   perfTest.CleanupTestCase();
 
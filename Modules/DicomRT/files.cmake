@@ -9,6 +9,7 @@ SET(CPP_FILES
   mitkDoseImageVtkMapper2D.cpp
   mitkIsoLevelsGenerator.cpp
   mitkDoseNodeHelper.cpp
+  mitkIsoLineExtractor.cpp
 )
 
 set(TPP_FILES
@@ -235,9 +235,9 @@ namespace mitk {
     */
     void GeneratePlane(mitk::BaseRenderer* renderer, double planeBounds[6]);
 
-    /** \brief Generates a vtkPolyData object containing the outline of a given binary slice.
+    /** \brief Generates a vtkPolyData object containing the iso lines of all visible iso dose levels.
     \param renderer: Pointer to the renderer containing the needed information
-    \note This code is based on code from the iil library.
+    \note All levels are extracted in one pass over the resliced slice, see mitk::IsoLineExtractor.
     */
     vtkSmartPointer<vtkPolyData> CreateOutlinePolyData(mitk::BaseRenderer* renderer);
 
@@ -303,9 +303,6 @@ namespace mitk {
     **/
     bool RenderingGeometryIntersectsImage( const PlaneGeometry* renderingGeometry, SlicedGeometry3D* imageGeometry );
 
-  private:
-    void CreateLevelOutline(mitk::BaseRenderer* renderer, const mitk::IsoDoseLevel* level, float pref, vtkSmartPointer<vtkPoints> points, vtkSmartPointer<vtkCellArray> lines,  vtkSmartPointer<vtkUnsignedCharArray> colors);
-
   };
 
 } // namespace mitk
@@ -0,0 +1,57 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __ISO_LINE_EXTRACTOR_H
+#define __ISO_LINE_EXTRACTOR_H
+
+#include <mitkNumericTypes.h>
+
+#include <vector>
+
+#include "MitkDicomRTExports.h"
+
+namespace mitk
+{
+  /** \brief Extracts the iso lines of several levels from a 2D slice in one pass (multi level marching squares).
+   *
+   * Each cell between four pixel centers is classified against all levels at once; only the levels between
+   * the minimum and the maximum of the cell are processed. The crossings are linearly interpolated between the
+   * pixel centers and the segments are merged into polylines per level. A pixel belongs to the region of a level
+   * if its value is greater or equal than the level. The slice is treated as surrounded by pixels below all
+   * levels, so regions touching the border are closed at the border of the slice.
+   * The rows of the slice are processed in parallel bands.
+   */
+  class MITKDICOMRT_EXPORT IsoLineExtractor
+  {
+  public:
+    /** Points in pixel units: pixel (x,y) covers [x,x+1]x[y,y+1]. Closed polylines end with their first point.*/
+    typedef std::vector<mitk::Point2D> PolyLineType;
+    typedef std::vector<PolyLineType> PolyLineVectorType;
+
+    /** \brief Extracts the polylines of all levels.
+     * \param values Row major slice of width x height values.
+     * \param levels Iso levels, neither sorted nor unique.
+     * \param numberOfThreads Number of row bands processed in parallel. 0 uses the number of cores.
+     * \return The polylines of each level in the order of levels.*/
+    static std::vector<PolyLineVectorType> Extract(const float *values,
+                                                   unsigned int width,
+                                                   unsigned int height,
+                                                   const std::vector<double> &levels,
+                                                   unsigned int numberOfThreads = 0);
+  };
+}
+
+#endif
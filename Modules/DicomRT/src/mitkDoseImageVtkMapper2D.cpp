@@ -23,6 +23,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImageSliceSelector.h>
 #include <mitkIsoDoseLevelSetProperty.h>
 #include <mitkIsoDoseLevelVectorProperty.h>
+#include <mitkIsoLineExtractor.h>
 #include <mitkLevelWindowProperty.h>
 #include <mitkLookupTableProperty.h>
 #include <mitkPixelType.h>
@@ -848,6 +849,8 @@ mitk::DoseImageVtkMapper2D::LocalStorage *mitk::DoseImageVtkMapper2D::GetLocalSt
 
 vtkSmartPointer<vtkPolyData> mitk::DoseImageVtkMapper2D::CreateOutlinePolyData(mitk::BaseRenderer *renderer)
 {
+  LocalStorage *localStorage = this->GetLocalStorage(renderer);
+
   vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();      // the points to draw
   vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New(); // the lines to connect the points
   vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
@@ -857,6 +860,11 @@ vtkSmartPointer<vtkPolyData> mitk::DoseImageVtkMapper2D::CreateOutlinePolyData(m
   float pref;
   this->GetDataNode()->GetFloatProperty(mitk::RTConstants::REFERENCE_DOSE_PROPERTY_NAME.c_str(), pref);
 
+  // collect the visible levels of the iso dose level set and the free iso values,
+  // so that all of them are extracted in one pass over the slice
+  std::vector<double> doseValues;
+  std::vector<const mitk::IsoDoseLevel *> visibleLevels;
+
   mitk::IsoDoseLevelSetProperty::Pointer propIsoSet = dynamic_cast<mitk::IsoDoseLevelSetProperty *>(
     GetDataNode()->GetProperty(mitk::RTConstants::DOSE_ISO_LEVELS_PROPERTY_NAME.c_str()));
   mitk::IsoDoseLevelSet::Pointer isoDoseLevelSet = propIsoSet->GetValue();
@@ -866,7 +874,8 @@ vtkSmartPointer<vtkPolyData> mitk::DoseImageVtkMapper2D::CreateOutlinePolyData(m
   {
     if (doseIT->GetVisibleIsoLine())
     {
-      this->CreateLevelOutline(renderer, &(doseIT.Value()), pref, points, lines, colors);
+      visibleLevels.push_back(&(doseIT.Value()));
+      doseValues.push_back(doseIT->GetDoseValue() * pref);
     } // end of if visible dose value
   }   // end of loop over all does values
 
@@ -880,189 +889,56 @@ vtkSmartPointer<vtkPolyData> mitk::DoseImageVtkMapper2D::CreateOutlinePolyData(m
   {
     if (freeDoseIT->Value()->GetVisibleIsoLine())
     {
-      this->CreateLevelOutline(renderer, freeDoseIT->Value(), pref, points, lines, colors);
+      visibleLevels.push_back(freeDoseIT->Value());
+      doseValues.push_back(freeDoseIT->Value()->GetDoseValue() * pref);
     } // end of if visible dose value
   }   // end of loop over all does values
 
-  // Create a polydata to store everything in
-  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-  // Add the points to the dataset
-  polyData->SetPoints(points);
-  // Add the lines to the dataset
-  polyData->SetLines(lines);
-  polyData->GetCellData()->SetScalars(colors);
-  return polyData;
-}
+  // We take the pointer to the first pixel of the image
+  const float *firstPixel = static_cast<const float *>(localStorage->m_ReslicedImage->GetScalarPointer());
 
-void mitk::DoseImageVtkMapper2D::CreateLevelOutline(mitk::BaseRenderer *renderer,
-                                                    const mitk::IsoDoseLevel *level,
-                                                    float pref,
-                                                    vtkSmartPointer<vtkPoints> points,
-                                                    vtkSmartPointer<vtkCellArray> lines,
-                                                    vtkSmartPointer<vtkUnsignedCharArray> colors)
-{
-  LocalStorage *localStorage = this->GetLocalStorage(renderer);
+  if (!firstPixel)
+  {
+    mitkThrow() << "currentPixel invalid";
+  }
 
-  // get the min and max index values of each direction
   int *extent = localStorage->m_ReslicedImage->GetExtent();
-  int xMin = extent[0];
-  int xMax = extent[1];
-  int yMin = extent[2];
-  int yMax = extent[3];
-
-  int *dims = localStorage->m_ReslicedImage->GetDimensions(); // dimensions of the image
-  int line = dims[0];                                         // how many pixels per line?
+  int *dims = localStorage->m_ReslicedImage->GetDimensions();
   // get the depth for each contour
   float depth = CalculateLayerDepth(renderer);
 
-  double doseValue = level->GetDoseValue() * pref;
-  mitk::IsoDoseLevel::ColorType isoColor = level->GetColor();
-  unsigned char colorLine[3] = {static_cast<unsigned char>(isoColor.GetRed() * 255),
-                                static_cast<unsigned char>(isoColor.GetGreen() * 255),
-                                static_cast<unsigned char>(isoColor.GetBlue() * 255)};
-
-  int x = xMin; // pixel index x
-  int y = yMin; // pixel index y
-  float *currentPixel;
+  std::vector<mitk::IsoLineExtractor::PolyLineVectorType> isoLines =
+    mitk::IsoLineExtractor::Extract(firstPixel, dims[0], dims[1], doseValues);
 
-  // We take the pointer to the first pixel of the image
-  currentPixel = static_cast<float *>(localStorage->m_ReslicedImage->GetScalarPointer());
-
-  if (!currentPixel){
-    mitkThrow() << "currentPixel invalid";
-  }
-
-  while (y <= yMax)
+  for (std::size_t i = 0; i < visibleLevels.size(); ++i)
   {
-    // if the current pixel value is set to something
-    if ((currentPixel) && (*currentPixel >= doseValue))
-    {
-      // check in which direction a line is necessary
-      // a line is added if the neighbor of the current pixel has the value 0
-      // and if the pixel is located at the edge of the image
-
-      // if   vvvvv  not the first line vvvvv
-      if (y > yMin && *(currentPixel - line) < doseValue)
-      { // x direction - bottom edge of the pixel
-        // add the 2 points
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        // add the line between both points
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
-
-      // if   vvvvv  not the last line vvvvv
-      if (y < yMax && *(currentPixel + line) < doseValue)
-      { // x direction - top edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
-
-      // if   vvvvv  not the first pixel vvvvv
-      if ((x > xMin || y > yMin) && *(currentPixel - 1) < doseValue)
-      { // y direction - left edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
-
-      // if   vvvvv  not the last pixel vvvvv
-      if ((y < yMax || (x < xMax)) && *(currentPixel + 1) < doseValue)
-      { // y direction - right edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
-
-      /*  now consider pixels at the edge of the image  */
-
-      // if   vvvvv  left edge of image vvvvv
-      if (x == xMin)
-      { // draw left edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
-
-      // if   vvvvv  right edge of image vvvvv
-      if (x == xMax)
-      { // draw right edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
-
-      // if   vvvvv  bottom edge of image vvvvv
-      if (y == yMin)
-      { // draw bottom edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
+    mitk::IsoDoseLevel::ColorType isoColor = visibleLevels[i]->GetColor();
+    unsigned char colorLine[3] = {static_cast<unsigned char>(isoColor.GetRed() * 255),
+                                  static_cast<unsigned char>(isoColor.GetGreen() * 255),
+                                  static_cast<unsigned char>(isoColor.GetBlue() * 255)};
 
-      // if   vvvvv  top edge of image vvvvv
-      if (y == yMax)
-      { // draw top edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
+    for (const auto &isoLine : isoLines[i])
+    {
+      // one polyline cell per iso line; the points are given in pixels relative to the first pixel
+      lines->InsertNextCell(static_cast<int>(isoLine.size()));
+      for (const auto &point : isoLine)
+      {
+        lines->InsertCellPoint(points->InsertNextPoint((point[0] + extent[0]) * localStorage->m_mmPerPixel[0],
+                                                       (point[1] + extent[2]) * localStorage->m_mmPerPixel[1],
+                                                       depth));
       }
-    } // end if currentpixel is set
-
-    x++;
-
-    if (x > xMax)
-    { // reached end of line
-      x = xMin;
-      y++;
+      colors->InsertNextTypedTuple(colorLine);
     }
+  }
 
-    // Increase the pointer-position to the next pixel.
-    // This is safe, as the while-loop and the x-reset logic above makes
-    // sure we do not exceed the bounds of the image
-    currentPixel++;
-  } // end of while
+  // Create a polydata to store everything in
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  // Add the points to the dataset
+  polyData->SetPoints(points);
+  // Add the lines to the dataset
+  polyData->SetLines(lines);
+  polyData->GetCellData()->SetScalars(colors);
+  return polyData;
 }
 
 void mitk::DoseImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
@@ -0,0 +1,359 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkIsoLineExtractor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+  /** Identifies the edge between two neighboring samples of the padded slice:
+   * ((y * paddedWidth + x) << 1) | vertical, with (x,y) the lower/left sample.*/
+  typedef long long EdgeKeyType;
+
+  struct Segment
+  {
+    EdgeKeyType first;
+    EdgeKeyType second;
+  };
+
+  typedef std::vector<Segment> SegmentVectorType;
+
+  /** Minimal number of cell rows per thread, smaller bands do not pay off. */
+  const unsigned int MinimumRowsPerBand = 16;
+
+  /** The slice surrounded by one pixel below all levels. NaN is below all levels, too. */
+  class PaddedSlice
+  {
+  public:
+    PaddedSlice(const float *values, unsigned int width, unsigned int height)
+      : m_Values(values), m_Width(width), m_Height(height)
+    {
+    }
+
+    unsigned int GetWidth() const { return m_Width + 2; }
+    unsigned int GetHeight() const { return m_Height + 2; }
+
+    double GetValue(unsigned int x, unsigned int y) const
+    {
+      if (x < 1 || y < 1 || x > m_Width || y > m_Height)
+      {
+        return -std::numeric_limits<double>::infinity();
+      }
+
+      const double value = m_Values[static_cast<std::size_t>(y - 1) * m_Width + x - 1];
+      return std::isnan(value) ? -std::numeric_limits<double>::infinity() : value;
+    }
+
+    EdgeKeyType GetEdgeKey(unsigned int x, unsigned int y, bool vertical) const
+    {
+      return ((static_cast<EdgeKeyType>(y) * this->GetWidth() + x) << 1) | (vertical ? 1 : 0);
+    }
+
+    /** Interpolated crossing of the level on the edge, in pixel units of the unpadded slice. */
+    mitk::Point2D GetEdgePoint(EdgeKeyType key, double level) const
+    {
+      const bool vertical = (key & 1) != 0;
+      const unsigned int x = static_cast<unsigned int>((key >> 1) % this->GetWidth());
+      const unsigned int y = static_cast<unsigned int>((key >> 1) / this->GetWidth());
+
+      const double valueA = this->GetValue(x, y);
+      const double valueB = vertical ? this->GetValue(x, y + 1) : this->GetValue(x + 1, y);
+
+      // the border of the slice lies in the middle between the outermost pixel and the padding
+      double t = 0.5;
+      if (std::isfinite(valueA) && std::isfinite(valueB))
+      {
+        t = (level - valueA) / (valueB - valueA);
+      }
+
+      // the center of padded sample x is located at x - 1 + 0.5
+      mitk::Point2D point;
+      point[0] = x - 0.5 + (vertical ? 0.0 : t);
+      point[1] = y - 0.5 + (vertical ? t : 0.0);
+      return point;
+    }
+
+  private:
+    const float *m_Values;
+    unsigned int m_Width;
+    unsigned int m_Height;
+  };
+
+  /** Marching squares over the cell rows [firstRow, endRow) for all levels (sorted and unique). */
+  void ExtractSegments(const PaddedSlice &slice,
+                       const std::vector<double> &levels,
+                       unsigned int firstRow,
+                       unsigned int endRow,
+                       std::vector<SegmentVectorType> &segments)
+  {
+    const unsigned int columns = slice.GetWidth() - 1;
+
+    for (unsigned int y = firstRow; y < endRow; ++y)
+    {
+      for (unsigned int x = 0; x < columns; ++x)
+      {
+        // corners counter clockwise, starting at the lower left one
+        const double values[4] = {
+          slice.GetValue(x, y), slice.GetValue(x + 1, y), slice.GetValue(x + 1, y + 1), slice.GetValue(x, y + 1)};
+
+        const double minValue = std::min(std::min(values[0], values[1]), std::min(values[2], values[3]));
+        const double maxValue = std::max(std::max(values[0], values[1]), std::max(values[2], values[3]));
+
+        // only the levels in (min, max] cross the cell
+        auto levelIter = std::upper_bound(levels.begin(), levels.end(), minValue);
+        if (levelIter == levels.end() || *levelIter > maxValue)
+        {
+          continue;
+        }
+
+        // edges: bottom, right, top, left
+        const EdgeKeyType edges[4] = {slice.GetEdgeKey(x, y, false),
+                                      slice.GetEdgeKey(x + 1, y, true),
+                                      slice.GetEdgeKey(x, y + 1, false),
+                                      slice.GetEdgeKey(x, y, true)};
+
+        for (; levelIter != levels.end() && *levelIter <= maxValue; ++levelIter)
+        {
+          const double level = *levelIter;
+          SegmentVectorType &levelSegments = segments[levelIter - levels.begin()];
+
+          const int cellCase = (values[0] >= level ? 1 : 0) | (values[1] >= level ? 2 : 0) |
+                               (values[2] >= level ? 4 : 0) | (values[3] >= level ? 8 : 0);
+
+          switch (cellCase)
+          {
+            case 1:
+            case 14:
+              levelSegments.push_back({edges[3], edges[0]});
+              break;
+            case 2:
+            case 13:
+              levelSegments.push_back({edges[0], edges[1]});
+              break;
+            case 3:
+            case 12:
+              levelSegments.push_back({edges[3], edges[1]});
+              break;
+            case 4:
+            case 11:
+              levelSegments.push_back({edges[1], edges[2]});
+              break;
+            case 6:
+            case 9:
+              levelSegments.push_back({edges[0], edges[2]});
+              break;
+            case 7:
+            case 8:
+              levelSegments.push_back({edges[3], edges[2]});
+              break;
+            case 5:
+            case 10:
+            {
+              // saddle: the mean of the corners decides which diagonal is connected
+              const bool centerInside = (values[0] + values[1] + values[2] + values[3]) / 4.0 >= level;
+              if (centerInside == (cellCase == 5))
+              { // cut off the lower right and the upper left corner
+                levelSegments.push_back({edges[0], edges[1]});
+                levelSegments.push_back({edges[2], edges[3]});
+              }
+              else
+              { // cut off the lower left and the upper right corner
+                levelSegments.push_back({edges[3], edges[0]});
+                levelSegments.push_back({edges[1], edges[2]});
+              }
+              break;
+            }
+            default:
+              break;
+          }
+        }
+      }
+    }
+  }
+
+  /** Merges the segments of one level into polylines. */
+  mitk::IsoLineExtractor::PolyLineVectorType StitchSegments(const PaddedSlice &slice,
+                                                            const SegmentVectorType &segments,
+                                                            double level)
+  {
+    const std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    // every edge is shared by at most two segments (the cells on both sides)
+    std::unordered_map<EdgeKeyType, std::pair<std::size_t, std::size_t>> adjacency;
+    adjacency.reserve(2 * segments.size());
+    for (std::size_t i = 0; i < segments.size(); ++i)
+    {
+      for (EdgeKeyType key : {segments[i].first, segments[i].second})
+      {
+        auto finding = adjacency.emplace(key, std::make_pair(i, none));
+        if (!finding.second)
+        {
+          finding.first->second.second = i;
+        }
+      }
+    }
+
+    std::vector<bool> used(segments.size(), false);
+    mitk::IsoLineExtractor::PolyLineVectorType result;
+
+    auto walk = [&](std::size_t segment, EdgeKeyType key) {
+      mitk::IsoLineExtractor::PolyLineType line;
+      line.push_back(slice.GetEdgePoint(key, level));
+
+      while (segment != none)
+      {
+        used[segment] = true;
+        key = segments[segment].first == key ? segments[segment].second : segments[segment].first;
+        line.push_back(slice.GetEdgePoint(key, level));
+
+        const auto &neighbors = adjacency[key];
+        if (!used[neighbors.first])
+        {
+          segment = neighbors.first;
+        }
+        else if (neighbors.second != none && !used[neighbors.second])
+        {
+          segment = neighbors.second;
+        }
+        else
+        {
+          segment = none;
+        }
+      }
+
+      result.push_back(line);
+    };
+
+    // the padding closes all lines, but a line that is open for whatever reason is walked from one of its ends
+    for (std::size_t i = 0; i < segments.size(); ++i)
+    {
+      if (!used[i] && adjacency[segments[i].first].second == none)
+      {
+        walk(i, segments[i].first);
+      }
+      else if (!used[i] && adjacency[segments[i].second].second == none)
+      {
+        walk(i, segments[i].second);
+      }
+    }
+
+    // all remaining segments belong to closed polylines
+    for (std::size_t i = 0; i < segments.size(); ++i)
+    {
+      if (!used[i])
+      {
+        walk(i, segments[i].first);
+      }
+    }
+
+    return result;
+  }
+
+  unsigned int GetNumberOfThreads(unsigned int requested, unsigned int tasks)
+  {
+    unsigned int threads = requested > 0 ? requested : std::thread::hardware_concurrency();
+    return std::max(1u, std::min(threads, tasks));
+  }
+}
+
+std::vector<mitk::IsoLineExtractor::PolyLineVectorType> mitk::IsoLineExtractor::Extract(
+  const float *values, unsigned int width, unsigned int height, const std::vector<double> &levels, unsigned int numberOfThreads)
+{
+  std::vector<PolyLineVectorType> result(levels.size());
+
+  if (!values || width == 0 || height == 0 || levels.empty())
+  {
+    return result;
+  }
+
+  std::vector<double> sortedLevels(levels);
+  std::sort(sortedLevels.begin(), sortedLevels.end());
+  sortedLevels.erase(std::unique(sortedLevels.begin(), sortedLevels.end()), sortedLevels.end());
+
+  const PaddedSlice slice(values, width, height);
+
+  // classify the cells in row bands
+  const unsigned int rows = slice.GetHeight() - 1;
+  const unsigned int bandCount =
+    GetNumberOfThreads(numberOfThreads, std::max(1u, rows / MinimumRowsPerBand));
+
+  std::vector<std::vector<SegmentVectorType>> bandSegments(bandCount,
+                                                           std::vector<SegmentVectorType>(sortedLevels.size()));
+  {
+    std::vector<std::thread> threads;
+    for (unsigned int band = 1; band < bandCount; ++band)
+    {
+      threads.emplace_back(ExtractSegments,
+                           std::cref(slice),
+                           std::cref(sortedLevels),
+                           band * rows / bandCount,
+                           (band + 1) * rows / bandCount,
+                           std::ref(bandSegments[band]));
+    }
+    ExtractSegments(slice, sortedLevels, 0, rows / bandCount, bandSegments[0]);
+
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  // merge the segments of all bands and stitch the levels in parallel; the edge keys are global,
+  // so lines crossing band borders are merged, too.
+  std::vector<PolyLineVectorType> sortedResult(sortedLevels.size());
+  {
+    std::atomic<std::size_t> nextLevel(0);
+    auto stitchLevels = [&]() {
+      for (std::size_t level = nextLevel++; level < sortedLevels.size(); level = nextLevel++)
+      {
+        SegmentVectorType segments;
+        for (const auto &band : bandSegments)
+        {
+          segments.insert(segments.end(), band[level].begin(), band[level].end());
+        }
+        sortedResult[level] = StitchSegments(slice, segments, sortedLevels[level]);
+      }
+    };
+
+    const unsigned int stitchThreadCount =
+      GetNumberOfThreads(numberOfThreads, static_cast<unsigned int>(sortedLevels.size()));
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < stitchThreadCount; ++i)
+    {
+      threads.emplace_back(stitchLevels);
+    }
+    stitchLevels();
+
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  for (std::size_t i = 0; i < levels.size(); ++i)
+  {
+    const auto finding = std::lower_bound(sortedLevels.begin(), sortedLevels.end(), levels[i]);
+    result[i] = sortedResult[finding - sortedLevels.begin()];
+  }
+
+  return result;
+}
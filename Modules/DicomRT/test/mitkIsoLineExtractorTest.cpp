@@ -0,0 +1,132 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+#include "mitkIsoLineExtractor.h"
+
+#include <cmath>
+
+class mitkIsoLineExtractorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkIsoLineExtractorTestSuite);
+  MITK_TEST(Extract_SinglePeak);
+  MITK_TEST(Extract_BorderIsClosed);
+  MITK_TEST(Extract_ThreadsAgree);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::vector<float> m_Peak;
+
+  static void AssertClosed(const mitk::IsoLineExtractor::PolyLineType &line)
+  {
+    CPPUNIT_ASSERT(line.size() > 2);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(line.front()[0], line.back()[0], mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(line.front()[1], line.back()[1], mitk::eps);
+  }
+
+  static void AssertBounds(const mitk::IsoLineExtractor::PolyLineType &line, double min, double max)
+  {
+    for (const auto &point : line)
+    {
+      for (unsigned int i = 0; i < 2; ++i)
+      {
+        CPPUNIT_ASSERT(point[i] >= min - mitk::eps && point[i] <= max + mitk::eps);
+      }
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    // 5x5 slice with a single pixel of 10 in the center
+    m_Peak.assign(25, 0.0f);
+    m_Peak[12] = 10.0f;
+  }
+
+  void Extract_SinglePeak()
+  {
+    std::vector<double> levels = {20.0, 5.0, 7.5};
+    auto result = mitk::IsoLineExtractor::Extract(m_Peak.data(), 5, 5, levels);
+
+    CPPUNIT_ASSERT_EQUAL(levels.size(), result.size());
+    CPPUNIT_ASSERT(result[0].empty());
+
+    // the crossings are interpolated between the pixel centers (2.5 and 1.5/3.5)
+    CPPUNIT_ASSERT_EQUAL(size_t(1), result[1].size());
+    AssertClosed(result[1][0]);
+    AssertBounds(result[1][0], 2.0, 3.0);
+
+    CPPUNIT_ASSERT_EQUAL(size_t(1), result[2].size());
+    AssertClosed(result[2][0]);
+    AssertBounds(result[2][0], 2.25, 2.75);
+  }
+
+  void Extract_BorderIsClosed()
+  {
+    std::vector<double> levels = {0.0};
+    auto result = mitk::IsoLineExtractor::Extract(m_Peak.data(), 5, 5, levels);
+
+    CPPUNIT_ASSERT_EQUAL(size_t(1), result[0].size());
+    AssertClosed(result[0][0]);
+    AssertBounds(result[0][0], 0.0, 5.0);
+  }
+
+  void Extract_ThreadsAgree()
+  {
+    const unsigned int width = 120;
+    const unsigned int height = 97;
+    std::vector<float> values(width * height);
+    for (unsigned int y = 0; y < height; ++y)
+    {
+      for (unsigned int x = 0; x < width; ++x)
+      {
+        values[y * width + x] = static_cast<float>(100.0 * std::sin(x * 0.1) * std::cos(y * 0.13));
+      }
+    }
+
+    std::vector<double> levels;
+    for (int i = -9; i < 10; ++i)
+    {
+      levels.push_back(i * 10.0);
+    }
+
+    auto serial = mitk::IsoLineExtractor::Extract(values.data(), width, height, levels, 1);
+    auto parallel = mitk::IsoLineExtractor::Extract(values.data(), width, height, levels, 4);
+
+    for (std::size_t i = 0; i < levels.size(); ++i)
+    {
+      CPPUNIT_ASSERT(!serial[i].empty());
+      CPPUNIT_ASSERT_EQUAL(serial[i].size(), parallel[i].size());
+
+      std::size_t serialPoints = 0;
+      std::size_t parallelPoints = 0;
+      for (const auto &line : serial[i])
+      {
+        AssertClosed(line);
+        serialPoints += line.size();
+      }
+      for (const auto &line : parallel[i])
+      {
+        parallelPoints += line.size();
+      }
+      CPPUNIT_ASSERT_EQUAL(serialPoints, parallelPoints);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIsoLineExtractor)
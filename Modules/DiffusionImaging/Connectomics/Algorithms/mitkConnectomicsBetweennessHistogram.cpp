@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <boost/numeric/conversion/converter.hpp>
 
 #include <mitkConnectomicsConstantsManager.h>
+#include <mitkConnectomicsPathEngine.h>
 
 mitk::ConnectomicsBetweennessHistogram::ConnectomicsBetweennessHistogram()
 : m_Mode( UnweightedUndirectedMode )
@@ -71,13 +72,19 @@ void mitk::ConnectomicsBetweennessHistogram::ComputeFromConnectomicsNetwork( Con
 void mitk::ConnectomicsBetweennessHistogram::CalculateUnweightedUndirectedBetweennessCentrality(
   NetworkType* boostGraph, IteratorType /*vertex_iterator_begin*/, IteratorType /*vertex_iterator_end*/ )
 {
-  boost::brandes_betweenness_centrality(
-    *boostGraph,
-    boost::centrality_map(
-    boost::make_iterator_property_map( m_CentralityMap.begin(), boost::get( &mitk::ConnectomicsNetwork::NetworkNode::id, *boostGraph ), double() )
-    ).vertex_index_map( boost::get( &mitk::ConnectomicsNetwork::NetworkNode::id, *boostGraph ) )
-    );
-
+  // the multithreaded Brandes passes report the centralities by vertex index
+  mitk::ConnectomicsPathEngine::Pointer pathEngine = mitk::ConnectomicsPathEngine::New();
+  pathEngine->SetGraph( boostGraph );
+  pathEngine->CalculateBetweennessCentrality();
+  const std::vector< double > centralities = pathEngine->GetVectorOfVertexBetweennessCentralities();
+
+  // the centrality map is indexed by node id
+  boost::property_map< NetworkType, boost::vertex_index_t >::type vertexIndex = boost::get( boost::vertex_index, *boostGraph );
+  IteratorType vertexIter, vertexEnd;
+  for( boost::tie( vertexIter, vertexEnd ) = boost::vertices( *boostGraph ); vertexIter != vertexEnd; ++vertexIter )
+  {
+    m_CentralityMap[ (*boostGraph)[ *vertexIter ].id ] = centralities[ vertexIndex[ *vertexIter ] ];
+  }
 }
 
 void mitk::ConnectomicsBetweennessHistogram::CalculateWeightedUndirectedBetweennessCentrality(
@@ -0,0 +1,234 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkConnectomicsModularityState.h"
+
+mitk::ConnectomicsModularityState::ConnectomicsModularityState()
+  : m_NumberOfLinks( 0.0 )
+{
+}
+
+void mitk::ConnectomicsModularityState::Initialize(
+  mitk::ConnectomicsNetwork::Pointer network, const ToModuleMapType* vertexToModuleMap )
+{
+  m_Vertices = network->GetVectorOfAllVertexDescriptors();
+  const int numberOfVertices = m_Vertices.size();
+
+  std::map< VertexDescriptorType, int > vertexToIndex;
+  for( int index( 0 ); index < numberOfVertices; index++ )
+  {
+    vertexToIndex[ m_Vertices[ index ] ] = index;
+  }
+
+  m_AdjacencyStart.assign( numberOfVertices + 1, 0 );
+  m_Adjacency.clear();
+  for( int index( 0 ); index < numberOfVertices; index++ )
+  {
+    const std::vector< VertexDescriptorType > adjacentNodesVector = network->GetVectorOfAdjacentNodes( m_Vertices[ index ] );
+    for( unsigned int adjacentNodeNumber( 0 ); adjacentNodeNumber < adjacentNodesVector.size(); adjacentNodeNumber++ )
+    {
+      m_Adjacency.push_back( vertexToIndex[ adjacentNodesVector[ adjacentNodeNumber ] ] );
+    }
+    m_AdjacencyStart[ index + 1 ] = m_Adjacency.size();
+  }
+
+  // each edge is contained twice in the adjacency
+  m_NumberOfLinks = m_Adjacency.size() / 2.0;
+
+  this->SetMapping( vertexToModuleMap );
+}
+
+void mitk::ConnectomicsModularityState::SetMapping( const ToModuleMapType* vertexToModuleMap )
+{
+  const int numberOfVertices = m_Vertices.size();
+  if( numberOfVertices != (int)vertexToModuleMap->size() )
+  {
+    MBI_ERROR << "Number of vertices and vertex to module map size do not match!";
+  }
+
+  int numberOfModules( 0 );
+  m_ModuleOfVertex.assign( numberOfVertices, 0 );
+  for( int index( 0 ); index < numberOfVertices; index++ )
+  {
+    auto iter = vertexToModuleMap->find( m_Vertices[ index ] );
+    m_ModuleOfVertex[ index ] = ( iter != vertexToModuleMap->end() ) ? iter->second : 0;
+    numberOfModules = std::max( numberOfModules, m_ModuleOfVertex[ index ] + 1 );
+  }
+
+  m_VerticesInModule.assign( numberOfModules, 0 );
+  m_SumOfDegreesInModule.assign( numberOfModules, 0.0 );
+  m_LinksInModule.assign( numberOfModules, 0.0 );
+
+  for( int index( 0 ); index < numberOfVertices; index++ )
+  {
+    const int module = m_ModuleOfVertex[ index ];
+    m_VerticesInModule[ module ]++;
+    m_SumOfDegreesInModule[ module ] += m_AdjacencyStart[ index + 1 ] - m_AdjacencyStart[ index ];
+    for( int entry( m_AdjacencyStart[ index ] ); entry < m_AdjacencyStart[ index + 1 ]; entry++ )
+    {
+      if( m_ModuleOfVertex[ m_Adjacency[ entry ] ] == module )
+      {
+        // internal links are seen from both of their vertices
+        m_LinksInModule[ module ] += 0.5;
+      }
+    }
+  }
+}
+
+mitk::ConnectomicsModularityState::ToModuleMapType mitk::ConnectomicsModularityState::GetMapping() const
+{
+  ToModuleMapType mapping;
+  for( unsigned int index( 0 ); index < m_Vertices.size(); index++ )
+  {
+    mapping.insert( std::pair< VertexDescriptorType, int >( m_Vertices[ index ], m_ModuleOfVertex[ index ] ) );
+  }
+  return mapping;
+}
+
+double mitk::ConnectomicsModularityState::GetModularity() const
+{
+  // if the network contains no links return 0
+  if( m_NumberOfLinks < 1 )
+  {
+    return 0;
+  }
+
+  double modularity( 0.0 );
+  for( unsigned int module( 0 ); module < m_LinksInModule.size(); module++ )
+  {
+    const double degreeFraction = m_SumOfDegreesInModule[ module ] / ( 2 * m_NumberOfLinks );
+    modularity += m_LinksInModule[ module ] / m_NumberOfLinks - degreeFraction * degreeFraction;
+  }
+  return modularity;
+}
+
+double mitk::ConnectomicsModularityState::CalculateMoveDelta( int vertex, int targetModule ) const
+{
+  const int sourceModule = m_ModuleOfVertex[ vertex ];
+  if( sourceModule == targetModule || m_NumberOfLinks < 1 )
+  {
+    return 0;
+  }
+
+  double linksToSource( 0.0 ), linksToTarget( 0.0 ), selfLinks( 0.0 );
+  CountLinksToModules( vertex, sourceModule, targetModule, linksToSource, linksToTarget, selfLinks );
+
+  const double degree = m_AdjacencyStart[ vertex + 1 ] - m_AdjacencyStart[ vertex ];
+  const double sourceDegrees = m_SumOfDegreesInModule[ sourceModule ];
+  const double targetDegrees = targetModule < (int)m_SumOfDegreesInModule.size() ? m_SumOfDegreesInModule[ targetModule ] : 0.0;
+
+  // the self links move along with the vertex and cancel out
+  //dM = (k_t - k_s) / L - 2 k ( d_t - d_s + k ) / ( 2L )^2
+  return ( linksToTarget - linksToSource ) / m_NumberOfLinks
+    - 2 * degree * ( targetDegrees - sourceDegrees + degree ) / ( 4 * m_NumberOfLinks * m_NumberOfLinks );
+}
+
+void mitk::ConnectomicsModularityState::CommitMove( int vertex, int targetModule )
+{
+  const int sourceModule = m_ModuleOfVertex[ vertex ];
+  if( sourceModule == targetModule )
+  {
+    return;
+  }
+
+  if( targetModule >= (int)m_VerticesInModule.size() )
+  {
+    m_VerticesInModule.resize( targetModule + 1, 0 );
+    m_SumOfDegreesInModule.resize( targetModule + 1, 0.0 );
+    m_LinksInModule.resize( targetModule + 1, 0.0 );
+  }
+
+  double linksToSource( 0.0 ), linksToTarget( 0.0 ), selfLinks( 0.0 );
+  CountLinksToModules( vertex, sourceModule, targetModule, linksToSource, linksToTarget, selfLinks );
+  const double degree = m_AdjacencyStart[ vertex + 1 ] - m_AdjacencyStart[ vertex ];
+
+  m_LinksInModule[ sourceModule ] -= linksToSource + selfLinks / 2;
+  m_LinksInModule[ targetModule ] += linksToTarget + selfLinks / 2;
+  m_SumOfDegreesInModule[ sourceModule ] -= degree;
+  m_SumOfDegreesInModule[ targetModule ] += degree;
+  m_VerticesInModule[ sourceModule ]--;
+  m_VerticesInModule[ targetModule ]++;
+  m_ModuleOfVertex[ vertex ] = targetModule;
+
+  if( m_VerticesInModule[ sourceModule ] < 1 )
+  {
+    RemoveEmptyModule( sourceModule );
+  }
+}
+
+int mitk::ConnectomicsModularityState::GetNumberOfVertices() const
+{
+  return m_Vertices.size();
+}
+
+int mitk::ConnectomicsModularityState::GetNumberOfModules() const
+{
+  return m_VerticesInModule.size();
+}
+
+int mitk::ConnectomicsModularityState::GetModuleOfVertex( int vertex ) const
+{
+  return m_ModuleOfVertex[ vertex ];
+}
+
+int mitk::ConnectomicsModularityState::GetNumberOfVerticesInModule( int module ) const
+{
+  return m_VerticesInModule[ module ];
+}
+
+void mitk::ConnectomicsModularityState::CountLinksToModules(
+  int vertex, int moduleA, int moduleB, double& linksToA, double& linksToB, double& selfLinks ) const
+{
+  for( int entry( m_AdjacencyStart[ vertex ] ); entry < m_AdjacencyStart[ vertex + 1 ]; entry++ )
+  {
+    const int adjacentVertex = m_Adjacency[ entry ];
+    if( adjacentVertex == vertex )
+    {
+      selfLinks++;
+    }
+    else if( m_ModuleOfVertex[ adjacentVertex ] == moduleA )
+    {
+      linksToA++;
+    }
+    else if( m_ModuleOfVertex[ adjacentVertex ] == moduleB )
+    {
+      linksToB++;
+    }
+  }
+}
+
+void mitk::ConnectomicsModularityState::RemoveEmptyModule( int module )
+{
+  const int lastModule = m_VerticesInModule.size() - 1;
+  if( module != lastModule )
+  {
+    // renumber last module to to-be-deleted module
+    for( unsigned int index( 0 ); index < m_ModuleOfVertex.size(); index++ )
+    {
+      if( m_ModuleOfVertex[ index ] == lastModule )
+      {
+        m_ModuleOfVertex[ index ] = module;
+      }
+    }
+    m_VerticesInModule[ module ] = m_VerticesInModule[ lastModule ];
+    m_SumOfDegreesInModule[ module ] = m_SumOfDegreesInModule[ lastModule ];
+    m_LinksInModule[ module ] = m_LinksInModule[ lastModule ];
+  }
+
+  m_VerticesInModule.pop_back();
+  m_SumOfDegreesInModule.pop_back();
+  m_LinksInModule.pop_back();
+}
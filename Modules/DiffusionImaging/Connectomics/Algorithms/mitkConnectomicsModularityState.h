@@ -0,0 +1,99 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkConnectomicsModularityState_h
+#define mitkConnectomicsModularityState_h
+
+#include "mitkConnectomicsNetwork.h"
+
+#include <MitkConnectomicsExports.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * \brief Incrementally maintained module assignment of a network for modularity optimization
+  *
+  * The state keeps a compact adjacency (CSR) copy of the network, the module of every vertex, the sum of
+  * degrees and the number of internal links of every module. This allows to score the move of a single
+  * vertex to another module in O(degree) and to commit it without recalculating the modularity of the
+  * whole network. Vertices are addressed by their index in GetVectorOfAllVertexDescriptors().
+  *
+  * The modularity is defined as in ConnectomicsSimulatedAnnealingCostFunctionModularity::CalculateModularity. */
+  class MITKCONNECTOMICS_EXPORT ConnectomicsModularityState
+  {
+  public:
+
+    typedef mitk::ConnectomicsNetwork::VertexDescriptorType VertexDescriptorType;
+    typedef std::map< VertexDescriptorType, int > ToModuleMapType;
+
+    ConnectomicsModularityState();
+
+    // Build the adjacency of the network and the module statistics of the given mapping
+    void Initialize( mitk::ConnectomicsNetwork::Pointer network, const ToModuleMapType* vertexToModuleMap );
+
+    // Replace the module assignment, keeping the adjacency
+    void SetMapping( const ToModuleMapType* vertexToModuleMap );
+
+    // Get the module assignment as vertex descriptor to module map
+    ToModuleMapType GetMapping() const;
+
+    // Modularity of the current assignment
+    double GetModularity() const;
+
+    // Change in modularity if the vertex was moved to targetModule, targetModule may be GetNumberOfModules()
+    double CalculateMoveDelta( int vertex, int targetModule ) const;
+
+    // Move the vertex to targetModule, if its previous module becomes empty the last module takes its number
+    void CommitMove( int vertex, int targetModule );
+
+    int GetNumberOfVertices() const;
+
+    int GetNumberOfModules() const;
+
+    int GetModuleOfVertex( int vertex ) const;
+
+    int GetNumberOfVerticesInModule( int module ) const;
+
+  protected:
+
+    // Count adjacency entries of vertex pointing to module, self loops are counted separately
+    void CountLinksToModules( int vertex, int moduleA, int moduleB, double& linksToA, double& linksToB, double& selfLinks ) const;
+
+    // Renumber the last module to the given empty module
+    void RemoveEmptyModule( int module );
+
+    std::vector< VertexDescriptorType > m_Vertices;
+
+    // CSR adjacency, neighbors of vertex i are m_Adjacency[ m_AdjacencyStart[ i ] .. m_AdjacencyStart[ i + 1 ] )
+    std::vector< int > m_AdjacencyStart;
+    std::vector< int > m_Adjacency;
+
+    std::vector< int > m_ModuleOfVertex;
+    std::vector< int > m_VerticesInModule;
+    std::vector< double > m_SumOfDegreesInModule;
+    std::vector< double > m_LinksInModule;
+
+    // number of links in the network
+    double m_NumberOfLinks;
+  };
+
+}// end namespace mitk
+
+#endif // mitkConnectomicsModularityState_h
@@ -0,0 +1,254 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkConnectomicsPathEngine.h"
+
+#include <cmath>
+#include <map>
+
+mitk::ConnectomicsPathEngine::ConnectomicsPathEngine()
+  : m_NumberOfEdges( 0 )
+{
+}
+
+mitk::ConnectomicsPathEngine::~ConnectomicsPathEngine()
+{
+}
+
+void mitk::ConnectomicsPathEngine::SetNetwork( mitk::ConnectomicsNetwork* network )
+{
+  SetGraph( network->GetBoostGraph() );
+}
+
+void mitk::ConnectomicsPathEngine::SetGraph( NetworkType* graph )
+{
+  const int numberOfVertices = boost::num_vertices( *graph );
+
+  // enumerate the edges in the same order as the statistics calculator does
+  std::map< EdgeDescriptorType, int > edgeIndex;
+  boost::graph_traits< NetworkType >::edge_iterator edgeIter, edgeEnd;
+  int index( 0 );
+  for( boost::tie( edgeIter, edgeEnd ) = boost::edges( *graph ); edgeIter != edgeEnd; ++edgeIter, ++index )
+  {
+    edgeIndex.insert( std::pair< EdgeDescriptorType, int >( *edgeIter, index ) );
+  }
+  m_NumberOfEdges = index;
+
+  boost::property_map< NetworkType, boost::vertex_index_t >::type vertexIndex = boost::get( boost::vertex_index, *graph );
+
+  std::vector< std::vector< std::pair< int, int > > > neighbors( numberOfVertices );
+  boost::graph_traits< NetworkType >::vertex_iterator vertexIter, vertexEnd;
+  for( boost::tie( vertexIter, vertexEnd ) = boost::vertices( *graph ); vertexIter != vertexEnd; ++vertexIter )
+  {
+    boost::graph_traits< NetworkType >::out_edge_iterator outIter, outEnd;
+    for( boost::tie( outIter, outEnd ) = boost::out_edges( *vertexIter, *graph ); outIter != outEnd; ++outIter )
+    {
+      neighbors[ vertexIndex[ *vertexIter ] ].push_back(
+        std::make_pair( (int)vertexIndex[ boost::target( *outIter, *graph ) ], edgeIndex[ *outIter ] ) );
+    }
+  }
+
+  m_AdjacencyStart.assign( numberOfVertices + 1, 0 );
+  m_Adjacency.clear();
+  m_AdjacencyEdge.clear();
+  for( int vertex( 0 ); vertex < numberOfVertices; vertex++ )
+  {
+    for( unsigned int entry( 0 ); entry < neighbors[ vertex ].size(); entry++ )
+    {
+      m_Adjacency.push_back( neighbors[ vertex ][ entry ].first );
+      m_AdjacencyEdge.push_back( neighbors[ vertex ][ entry ].second );
+    }
+    m_AdjacencyStart[ vertex + 1 ] = m_Adjacency.size();
+  }
+}
+
+void mitk::ConnectomicsPathEngine::CalculateShortestPaths()
+{
+  const int numberOfVertices = (int)m_AdjacencyStart.size() - 1;
+
+  m_VectorOfEccentricities.assign( numberOfVertices, 0 );
+  m_VectorOfEccentricities90.assign( numberOfVertices, 0 );
+  m_VectorOfAveragePathLengths.assign( numberOfVertices, 0.0 );
+  m_VectorOfReachableVertices.assign( numberOfVertices, 0 );
+  m_HopCounts.assign( numberOfVertices, 0 );
+
+#pragma omp parallel
+  {
+    // per thread buffers
+    std::vector< int > distances( numberOfVertices, -1 );
+    std::vector< int > queue( numberOfVertices );
+    std::vector< int > hopCounts( numberOfVertices, 0 );
+    std::vector< int > bucket;
+
+#pragma omp for schedule(dynamic, 16)
+    for( int source = 0; source < numberOfVertices; source++ )
+    {
+      int head( 0 ), tail( 0 );
+      queue[ tail++ ] = source;
+      distances[ source ] = 0;
+
+      while( head < tail )
+      {
+        const int vertex = queue[ head++ ];
+        for( int entry( m_AdjacencyStart[ vertex ] ); entry < m_AdjacencyStart[ vertex + 1 ]; entry++ )
+        {
+          const int adjacent = m_Adjacency[ entry ];
+          if( distances[ adjacent ] < 0 )
+          {
+            distances[ adjacent ] = distances[ vertex ] + 1;
+            queue[ tail++ ] = adjacent;
+          }
+        }
+      }
+
+      // the queue is ordered by distance, so the last discovered vertex is the farthest one
+      const int maxDistance = distances[ queue[ tail - 1 ] ];
+      const int reachable = tail - 1;
+      bucket.assign( maxDistance + 1, 0 );
+      double sumOfDistances( 0.0 );
+      for( int position( 1 ); position < tail; position++ )
+      {
+        const int distance = distances[ queue[ position ] ];
+        bucket[ distance ]++;
+        hopCounts[ distance ]++;
+        sumOfDistances += distance;
+      }
+
+      // number of hops needed to reach 90 percent of the reachable vertices
+      int reachable90 = std::ceil( (double)reachable * 0.9 );
+      int eccentricity90 = 0;
+      while( reachable90 > 0 )
+      {
+        eccentricity90++;
+        reachable90 = reachable90 - bucket[ eccentricity90 ];
+      }
+
+      m_VectorOfEccentricities[ source ] = maxDistance;
+      m_VectorOfEccentricities90[ source ] = eccentricity90;
+      m_VectorOfReachableVertices[ source ] = reachable;
+      m_VectorOfAveragePathLengths[ source ] = reachable > 0 ? sumOfDistances / reachable : 0.0;
+
+      // reset only the visited vertices
+      for( int position( 0 ); position < tail; position++ )
+      {
+        distances[ queue[ position ] ] = -1;
+      }
+    }
+
+#pragma omp critical
+    for( int distance( 0 ); distance < numberOfVertices; distance++ )
+    {
+      m_HopCounts[ distance ] += hopCounts[ distance ];
+    }
+  }
+}
+
+void mitk::ConnectomicsPathEngine::CalculateBetweennessCentrality()
+{
+  const int numberOfVertices = (int)m_AdjacencyStart.size() - 1;
+
+  m_VectorOfVertexBetweennessCentralities.assign( numberOfVertices, 0.0 );
+  m_VectorOfEdgeBetweennessCentralities.assign( m_NumberOfEdges, 0.0 );
+
+#pragma omp parallel
+  {
+    // per thread buffers and accumulators
+    std::vector< int > distances( numberOfVertices, -1 );
+    std::vector< int > queue( numberOfVertices );
+    std::vector< double > pathCount( numberOfVertices, 0.0 );
+    std::vector< double > dependency( numberOfVertices, 0.0 );
+    std::vector< double > vertexCentrality( numberOfVertices, 0.0 );
+    std::vector< double > edgeCentrality( m_NumberOfEdges, 0.0 );
+
+#pragma omp for schedule(dynamic, 16)
+    for( int source = 0; source < numberOfVertices; source++ )
+    {
+      int head( 0 ), tail( 0 );
+      queue[ tail++ ] = source;
+      distances[ source ] = 0;
+      pathCount[ source ] = 1;
+
+      // count the shortest paths, every edge leading one level down adds the paths of its source
+      while( head < tail )
+      {
+        const int vertex = queue[ head++ ];
+        for( int entry( m_AdjacencyStart[ vertex ] ); entry < m_AdjacencyStart[ vertex + 1 ]; entry++ )
+        {
+          const int adjacent = m_Adjacency[ entry ];
+          if( distances[ adjacent ] < 0 )
+          {
+            distances[ adjacent ] = distances[ vertex ] + 1;
+            queue[ tail++ ] = adjacent;
+          }
+          if( distances[ adjacent ] == distances[ vertex ] + 1 )
+          {
+            pathCount[ adjacent ] += pathCount[ vertex ];
+          }
+        }
+      }
+
+      // accumulate the dependencies in order of decreasing distance
+      for( int position( tail - 1 ); position >= 0; position-- )
+      {
+        const int vertex = queue[ position ];
+        for( int entry( m_AdjacencyStart[ vertex ] ); entry < m_AdjacencyStart[ vertex + 1 ]; entry++ )
+        {
+          const int predecessor = m_Adjacency[ entry ];
+          if( distances[ predecessor ] == distances[ vertex ] - 1 )
+          {
+            const double factor = pathCount[ predecessor ] / pathCount[ vertex ] * ( 1.0 + dependency[ vertex ] );
+            dependency[ predecessor ] += factor;
+            edgeCentrality[ m_AdjacencyEdge[ entry ] ] += factor;
+          }
+        }
+        if( vertex != source )
+        {
+          vertexCentrality[ vertex ] += dependency[ vertex ];
+        }
+      }
+
+      for( int position( 0 ); position < tail; position++ )
+      {
+        const int vertex = queue[ position ];
+        distances[ vertex ] = -1;
+        pathCount[ vertex ] = 0;
+        dependency[ vertex ] = 0;
+      }
+    }
+
+#pragma omp critical
+    {
+      for( int vertex( 0 ); vertex < numberOfVertices; vertex++ )
+      {
+        m_VectorOfVertexBetweennessCentralities[ vertex ] += vertexCentrality[ vertex ];
+      }
+      for( int edge( 0 ); edge < m_NumberOfEdges; edge++ )
+      {
+        m_VectorOfEdgeBetweennessCentralities[ edge ] += edgeCentrality[ edge ];
+      }
+    }
+  }
+
+  // every path of an undirected network has been counted from both of its ends
+  for( int vertex( 0 ); vertex < numberOfVertices; vertex++ )
+  {
+    m_VectorOfVertexBetweennessCentralities[ vertex ] /= 2.0;
+  }
+  for( int edge( 0 ); edge < m_NumberOfEdges; edge++ )
+  {
+    m_VectorOfEdgeBetweennessCentralities[ edge ] /= 2.0;
+  }
+}
@@ -0,0 +1,113 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkConnectomicsPathEngine_h
+#define mitkConnectomicsPathEngine_h
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkMacro.h>
+
+#include "mitkCommon.h"
+
+#include <MitkConnectomicsExports.h>
+
+#include <mitkConnectomicsNetwork.h>
+
+namespace mitk
+{
+  /**
+  * \brief Multithreaded all pairs shortest path and betweenness calculation on unweighted networks
+  *
+  * The network is copied into a compact adjacency (CSR) representation. Every source vertex is one task,
+  * which runs a breadth first search (shortest path metrics) or a Brandes pass (betweenness centrality).
+  * Tasks are distributed over threads using OpenMP, each thread accumulates into its own buffers, which
+  * are merged at the end.
+  *
+  * Vertices are indexed by the boost vertex index, edges in the order of boost::edges, as in
+  * ConnectomicsStatisticsCalculator. The results are identical to running boost::breadth_first_search
+  * and boost::brandes_betweenness_centrality on the boost graph. */
+  class MITKCONNECTOMICS_EXPORT ConnectomicsPathEngine : public itk::Object
+  {
+  public:
+
+    /** Standard class typedefs. */
+    /** Method for creation through the object factory. */
+
+    mitkClassMacroItkParent(ConnectomicsPathEngine, itk::Object);
+    itkFactorylessNewMacro(Self)
+    itkCloneMacro(Self)
+
+    // Typedefs
+    typedef mitk::ConnectomicsNetwork::NetworkType NetworkType;
+    typedef mitk::ConnectomicsNetwork::VertexDescriptorType VertexDescriptorType;
+    typedef mitk::ConnectomicsNetwork::EdgeDescriptorType EdgeDescriptorType;
+
+    // Set/Get Macros
+    itkGetMacro( VectorOfEccentricities, std::vector< unsigned int > );
+    itkGetMacro( VectorOfEccentricities90, std::vector< unsigned int > );
+    itkGetMacro( VectorOfAveragePathLengths, std::vector< double > );
+    itkGetMacro( VectorOfReachableVertices, std::vector< unsigned int > );
+    itkGetMacro( HopCounts, std::vector< int > );
+    itkGetMacro( VectorOfVertexBetweennessCentralities, std::vector< double > );
+    itkGetMacro( VectorOfEdgeBetweennessCentralities, std::vector< double > );
+
+    // Copy the adjacency of the network
+    void SetNetwork( mitk::ConnectomicsNetwork* network );
+
+    // Copy the adjacency of a boost graph
+    void SetGraph( NetworkType* graph );
+
+    /**
+    * \brief Run a breadth first search from every vertex
+    *
+    * Fills the eccentricity, the 90 percent eccentricity, the average path length and the number of
+    * vertices reachable (excluding the source) per vertex, as well as the number of ordered vertex pairs
+    * per hop distance.
+    */
+    void CalculateShortestPaths();
+
+    // Run a Brandes pass from every vertex and fill the vertex and edge betweenness centralities
+    void CalculateBetweennessCentrality();
+
+  protected:
+
+    //////////////////// Functions ///////////////////////
+    ConnectomicsPathEngine();
+    ~ConnectomicsPathEngine() override;
+
+    /////////////////////// Variables ////////////////////////
+
+    // CSR adjacency, neighbors of vertex i are m_Adjacency[ m_AdjacencyStart[ i ] .. m_AdjacencyStart[ i + 1 ] )
+    std::vector< int > m_AdjacencyStart;
+    std::vector< int > m_Adjacency;
+    // index of the edge of each adjacency entry
+    std::vector< int > m_AdjacencyEdge;
+    int m_NumberOfEdges;
+
+    // Results
+    std::vector< unsigned int > m_VectorOfEccentricities;
+    std::vector< unsigned int > m_VectorOfEccentricities90;
+    std::vector< double > m_VectorOfAveragePathLengths;
+    std::vector< unsigned int > m_VectorOfReachableVertices;
+    std::vector< int > m_HopCounts;
+    std::vector< double > m_VectorOfVertexBetweennessCentralities;
+    std::vector< double > m_VectorOfEdgeBetweennessCentralities;
+  };
+
+}// end namespace mitk
+
+#endif // mitkConnectomicsPathEngine_h
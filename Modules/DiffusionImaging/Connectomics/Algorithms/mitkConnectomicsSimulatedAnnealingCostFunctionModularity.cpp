@@ -31,6 +31,17 @@ double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::Evaluate( mit
   return cost;
 }
 
+double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::Evaluate( const mitk::ConnectomicsModularityState* state ) const
+{
+  return 100.0 * ( 1.0 - state->GetModularity() );
+}
+
+double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::EvaluateMove(
+  const mitk::ConnectomicsModularityState* state, int vertex, int targetModule ) const
+{
+  return -100.0 * state->CalculateMoveDelta( vertex, targetModule );
+}
+
 double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::CalculateModularity( mitk::ConnectomicsNetwork::Pointer network, ToModuleMapType* vertexToModuleMap ) const
 {
   double modularity( 0.0 );
@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConnectomicsSimulatedAnnealingCostFunctionBase.h"
 
 #include "mitkConnectomicsNetwork.h"
+#include "mitkConnectomicsModularityState.h"
 
 namespace mitk
 {
@@ -46,6 +47,12 @@ namespace mitk
     // Will calculate and return the modularity of the network
     double CalculateModularity( mitk::ConnectomicsNetwork::Pointer network, ToModuleMapType *vertexToModuleMap  ) const;
 
+    // Evaluate an incrementally maintained module assignment
+    double Evaluate( const mitk::ConnectomicsModularityState* state ) const;
+
+    // Change of the cost if the vertex is moved to the target module, O(degree)
+    double EvaluateMove( const mitk::ConnectomicsModularityState* state, int vertex, int targetModule ) const;
+
 
   protected:
 
@@ -20,8 +20,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vnl/vnl_random.h"
 #include "vnl/vnl_math.h"
 
+#include <vector>
+
 mitk::ConnectomicsSimulatedAnnealingManager::ConnectomicsSimulatedAnnealingManager()
 : m_Permutation( nullptr )
+, m_Seed( 0 )
 {
 }
 
@@ -61,7 +64,8 @@ void mitk::ConnectomicsSimulatedAnnealingManager::SetPermutation( mitk::Connecto
 
 void mitk::ConnectomicsSimulatedAnnealingManager::RunSimulatedAnnealing(
   double temperature,
-  double stepSize
+  double stepSize,
+  int numberOfChains
   )
 {
   if( m_Permutation.IsNull() )
@@ -76,20 +80,64 @@ void mitk::ConnectomicsSimulatedAnnealingManager::RunSimulatedAnnealing(
     return;
   }
 
-  // Initialize the associated permutation
-  m_Permutation->Initialize();
+  if( numberOfChains < 2 )
+  {
+    RunChain( m_Permutation, temperature, stepSize );
+    return;
+  }
+
+  // the first chain is the assigned permutation, all others are independently seeded clones
+  vnl_random rng( m_Seed );
+  std::vector< mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer > chains;
+  chains.push_back( m_Permutation );
+  for( int chain( 1 ); chain < numberOfChains; chain++ )
+  {
+    mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer clone = m_Permutation->Clone();
+    clone->SetSeed( rng.lrand32() );
+    chains.push_back( clone );
+  }
+
+#pragma omp parallel for
+  for( int chain = 0; chain < numberOfChains; chain++ )
+  {
+    RunChain( chains[ chain ], temperature, stepSize );
+  }
+
+  int bestChain( 0 );
+  double bestCost( chains[ 0 ]->GetCost() );
+  for( int chain( 1 ); chain < numberOfChains; chain++ )
+  {
+    const double cost = chains[ chain ]->GetCost();
+    if( cost < bestCost )
+    {
+      bestCost = cost;
+      bestChain = chain;
+    }
+  }
 
+  if( bestChain != 0 )
+  {
+    m_Permutation->AdoptSolution( chains[ bestChain ] );
+  }
+}
+
+void mitk::ConnectomicsSimulatedAnnealingManager::RunChain(
+  mitk::ConnectomicsSimulatedAnnealingPermutationBase* permutation,
+  double temperature,
+  double stepSize
+  )
+{
+  // Initialize the associated permutation
+  permutation->Initialize();
 
   for( double currentTemperature( temperature );
     currentTemperature > 0.00001;
     currentTemperature = currentTemperature / stepSize )
   {
     // Run Permutations at the current temperature
-    m_Permutation->Permutate( currentTemperature );
-
+    permutation->Permutate( currentTemperature );
   }
 
   // Clean up result
-  m_Permutation->CleanUp();
-
+  permutation->CleanUp();
 }
@@ -46,21 +46,33 @@ namespace mitk
     bool AcceptChange( double costBefore, double costAfter, double temperature );
 
     // Run the permutations at different temperatures, where t_n = t_n-1 / stepSize
-    void RunSimulatedAnnealing( double temperature, double stepSize );
+    // If numberOfChains > 1, independent chains are run in parallel on clones of the
+    // permutation and the best solution is handed back to the assigned permutation
+    void RunSimulatedAnnealing( double temperature, double stepSize, int numberOfChains = 1 );
 
     // Set the permutation to be used
     void SetPermutation( mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer permutation );
 
+    // Seed of the generator that seeds the additional chains, so that runs with several chains are reproducible
+    itkSetMacro( Seed, unsigned int );
+    itkGetConstMacro( Seed, unsigned int );
+
   protected:
 
     //////////////////// Functions ///////////////////////
     ConnectomicsSimulatedAnnealingManager();
     ~ConnectomicsSimulatedAnnealingManager() override;
 
+    // Run a single chain of permutations
+    void RunChain( mitk::ConnectomicsSimulatedAnnealingPermutationBase* permutation, double temperature, double stepSize );
+
     /////////////////////// Variables ////////////////////////
     // The permutation assigned to the simulated annealing manager
     mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer m_Permutation;
 
+    // The seed of the additional chains
+    unsigned int m_Seed;
+
   };
 
 }// end namespace mitk
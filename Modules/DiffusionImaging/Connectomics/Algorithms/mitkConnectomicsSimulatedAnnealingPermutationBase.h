@@ -58,6 +58,15 @@ namespace mitk
     // Do clean up necessary after a permutation
     virtual void CleanUp(){};
 
+    // Seed the random number generator of the permutation, used for independent chains
+    virtual void SetSeed( unsigned int /*seed*/ ){};
+
+    // Returns the cost of the current best solution
+    virtual double GetCost() const { return 0; };
+
+    // Take over the best solution of another permutation of the same type
+    virtual void AdoptSolution( const ConnectomicsSimulatedAnnealingPermutationBase* /*other*/ ){};
+
   protected:
 
     //////////////////// Functions ///////////////////////
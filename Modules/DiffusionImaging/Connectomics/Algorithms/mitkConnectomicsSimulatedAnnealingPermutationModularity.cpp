@@ -23,6 +23,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vnl/vnl_math.h"
 
 mitk::ConnectomicsSimulatedAnnealingPermutationModularity::ConnectomicsSimulatedAnnealingPermutationModularity()
+  : m_Depth( 0 )
+  , m_StepSize( 0 )
 {
 }
 
@@ -51,31 +53,49 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::Initialize()
   int n( 5 );
   randomlyAssignNodesToModules( &m_BestSolution, n );
 
+  m_State.Initialize( m_Network, &m_BestSolution );
 }
 
 void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::Permutate( double temperature )
 {
-
-  ToModuleMapType currentSolution = m_BestSolution;
-  ToModuleMapType currentBestSolution = m_BestSolution;
-
   int factor = 1;
   int numberOfVertices = m_BestSolution.size();
   int singleNodeMaxNumber = factor * numberOfVertices * numberOfVertices;
   int moduleMaxNumber = factor  * numberOfVertices;
-  double currentBestCost = Evaluate( &currentBestSolution );
 
-  // do singleNodeMaxNumber node permutations and evaluate
+  if( m_State.GetNumberOfVertices() != numberOfVertices )
+  {
+    m_State.Initialize( m_Network, &m_BestSolution );
+  }
+  else
+  {
+    m_State.SetMapping( &m_BestSolution );
+  }
+  double currentBestCost = EvaluateState();
+
+  // do singleNodeMaxNumber node permutations, each one is scored and committed
+  // incrementally on the module statistics of the state
   for(int loop( 0 ); loop < singleNodeMaxNumber; loop++)
   {
-    permutateMappingSingleNodeShift( &currentSolution, m_Network );
-    if( AcceptChange( currentBestCost, Evaluate( &currentSolution ), temperature ) )
+    int vertex( 0 ), module( 0 );
+    if( !proposeSingleNodeShift( &vertex, &module ) )
     {
-      currentBestSolution = currentSolution;
-      currentBestCost = Evaluate( &currentBestSolution );
+      continue;
+    }
+
+    const double costAfter = currentBestCost + EvaluateMove( vertex, module );
+    if( AcceptChange( currentBestCost, costAfter, temperature ) )
+    {
+      m_State.CommitMove( vertex, module );
+      currentBestCost = costAfter;
     }
   }
 
+  ToModuleMapType currentBestSolution = m_State.GetMapping();
+  ToModuleMapType currentSolution = currentBestSolution;
+  // recalculate to avoid accumulating rounding errors of the incremental updates
+  currentBestCost = Evaluate( &currentBestSolution );
+
   // do moduleMaxNumber module permutations
   for(int loop( 0 ); loop < moduleMaxNumber; loop++)
   {
@@ -103,56 +123,41 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::CleanUp()
   }
 }
 
-void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::permutateMappingSingleNodeShift(
-  ToModuleMapType *vertexToModuleMap, mitk::ConnectomicsNetwork::Pointer network )
+bool mitk::ConnectomicsSimulatedAnnealingPermutationModularity::proposeSingleNodeShift( int *vertex, int *module )
 {
-
-  const int nodeCount = vertexToModuleMap->size();
-  const int moduleCount = getNumberOfModules( vertexToModuleMap );
+  const int nodeCount = m_State.GetNumberOfVertices();
+  const int moduleCount = m_State.GetNumberOfModules();
 
   // the random number generators
-  vnl_random rng( (unsigned int) rand() );
-  unsigned long randomNode = rng.lrand32( nodeCount - 1 );
+  unsigned long randomNode = m_RandomGenerator.lrand32( nodeCount - 1 );
   // move the node either to any existing module, or to its own
-  //unsigned long randomModule = rng.lrand32( moduleCount );
-  unsigned long randomModule = rng.lrand32( moduleCount - 1 );
+  //unsigned long randomModule = m_RandomGenerator.lrand32( moduleCount );
+  unsigned long randomModule = m_RandomGenerator.lrand32( moduleCount - 1 );
 
   // do some sanity checks
 
   if ( nodeCount < 2 )
   {
     // no sense in doing anything
-    return;
+    return false;
   }
 
-  const std::vector< VertexDescriptorType > allNodesVector
-    = network->GetVectorOfAllVertexDescriptors();
-
-  auto iter = vertexToModuleMap->find( allNodesVector[ randomNode ] );
-  const int previousModuleNumber = iter->second;
-
   // if we move the node to its own module, do nothing
-  if( previousModuleNumber == (long)randomModule )
+  if( m_State.GetModuleOfVertex( randomNode ) == (long)randomModule )
   {
-    return;
+    return false;
   }
 
-  iter->second = randomModule;
-
-  if( getNumberOfVerticesInModule( vertexToModuleMap, previousModuleNumber ) < 1 )
-  {
-    removeModule( vertexToModuleMap, previousModuleNumber );
-  }
+  *vertex = randomNode;
+  *module = randomModule;
+  return true;
 }
 
 void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::permutateMappingModuleChange(
   ToModuleMapType *vertexToModuleMap, double currentTemperature, mitk::ConnectomicsNetwork::Pointer network )
 {
-  //the random number generators
-  vnl_random rng( (unsigned int) rand() );
-
   //randomly generate threshold
-  const double threshold = rng.drand64( 0.0 , 1.0);
+  const double threshold = m_RandomGenerator.drand64( 0.0 , 1.0);
 
   //for deciding whether to join two modules or split one
   double splitThreshold = 0.5;
@@ -162,10 +167,10 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::permutateMapping
 
   //select random module
   int numberOfModules = getNumberOfModules( vertexToModuleMap );
-  unsigned long randomModuleA = rng.lrand32( numberOfModules - 1 );
+  unsigned long randomModuleA = m_RandomGenerator.lrand32( numberOfModules - 1 );
 
   //select the second module to join, if joining
-  unsigned long randomModuleB = rng.lrand32( numberOfModules - 1 );
+  unsigned long randomModuleB = m_RandomGenerator.lrand32( numberOfModules - 1 );
 
   if( ( threshold < splitThreshold ) && ( randomModuleA != randomModuleB )  )
   {
@@ -249,6 +254,7 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::splitModule(
     permutation->SetNetwork( subNetwork );
     permutation->SetDepth( m_Depth - 1 );
     permutation->SetStepSize( m_StepSize * 2 );
+    permutation->SetSeed( m_RandomGenerator.lrand32() );
 
     manager->SetPermutation( permutation.GetPointer() );
 
@@ -433,9 +439,6 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::randomlyAssignNo
     numberOfIntendedModules = vertexToModuleMap->size();
   }
 
-  //the random number generators
-  vnl_random rng( (unsigned int) rand() );
-
   std::vector< int > histogram;
   std::vector< int > nodeList;
 
@@ -448,7 +451,7 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::randomlyAssignNo
   for( unsigned int nodeIndex( 0 ); nodeIndex < nodeList.size(); nodeIndex++ )
   {
     //select random module
-    nodeList[ nodeIndex ] = rng.lrand32( numberOfIntendedModules - 1 );
+    nodeList[ nodeIndex ] = m_RandomGenerator.lrand32( numberOfIntendedModules - 1 );
 
     histogram[ nodeList[ nodeIndex ] ]++;
 
@@ -460,7 +463,7 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::randomlyAssignNo
   {
     while( histogram[ moduleIndex ] == 0 )
     {
-      int randomNodeIndex = rng.lrand32( numberOfVertices - 1 );
+      int randomNodeIndex = m_RandomGenerator.lrand32( numberOfVertices - 1 );
       if( histogram[ nodeList[ randomNodeIndex ] ] > 1 )
       {
         histogram[ moduleIndex ]++;
@@ -490,6 +493,34 @@ mitk::ConnectomicsSimulatedAnnealingPermutationModularity::GetMapping()
   return m_BestSolution;
 }
 
+double mitk::ConnectomicsSimulatedAnnealingPermutationModularity::EvaluateState() const
+{
+  mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity* costMapping =
+    dynamic_cast<mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity*>( m_CostFunction.GetPointer() );
+  if( costMapping )
+  {
+    return costMapping->Evaluate( &m_State );
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+double mitk::ConnectomicsSimulatedAnnealingPermutationModularity::EvaluateMove( int vertex, int module ) const
+{
+  mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity* costMapping =
+    dynamic_cast<mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity*>( m_CostFunction.GetPointer() );
+  if( costMapping )
+  {
+    return costMapping->EvaluateMove( &m_State, vertex, module );
+  }
+  else
+  {
+    return 0;
+  }
+}
+
 double mitk::ConnectomicsSimulatedAnnealingPermutationModularity::Evaluate( ToModuleMapType* mapping ) const
 {
   mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity* costMapping =
@@ -511,11 +542,8 @@ bool mitk::ConnectomicsSimulatedAnnealingPermutationModularity::AcceptChange( do
     return true;
   }
 
-  //the random number generators
-  vnl_random rng( (unsigned int) rand() );
-
   //randomly generate threshold
-  const double threshold = rng.drand64( 0.0 , 1.0);
+  const double threshold = m_RandomGenerator.drand64( 0.0 , 1.0);
 
   //the likelihood of acceptance
   double likelihood = std::exp( - ( costAfter - costBefore ) / temperature );
@@ -538,3 +566,37 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::SetStepSize( dou
 {
   m_StepSize = size;
 }
+
+void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::SetSeed( unsigned int seed )
+{
+  m_RandomGenerator.reseed( seed );
+}
+
+double mitk::ConnectomicsSimulatedAnnealingPermutationModularity::GetCost() const
+{
+  ToModuleMapType mapping = m_BestSolution;
+  return Evaluate( &mapping );
+}
+
+void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::AdoptSolution(
+  const ConnectomicsSimulatedAnnealingPermutationBase* other )
+{
+  const Self* otherModularity = dynamic_cast< const Self* >( other );
+  if( otherModularity )
+  {
+    m_BestSolution = otherModularity->m_BestSolution;
+  }
+}
+
+::itk::LightObject::Pointer mitk::ConnectomicsSimulatedAnnealingPermutationModularity::InternalClone() const
+{
+  Self::Pointer clone = Self::New();
+  clone->SetCostFunction( m_CostFunction );
+  clone->SetNetwork( m_Network );
+  clone->SetDepth( m_Depth );
+  clone->SetStepSize( m_StepSize );
+  clone->SetMapping( m_BestSolution );
+
+  ::itk::LightObject::Pointer result = clone.GetPointer();
+  return result;
+}
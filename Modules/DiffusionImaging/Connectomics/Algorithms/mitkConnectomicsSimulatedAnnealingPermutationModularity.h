@@ -20,6 +20,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConnectomicsSimulatedAnnealingPermutationBase.h"
 
 #include "mitkConnectomicsNetwork.h"
+#include "mitkConnectomicsModularityState.h"
+
+#include "vnl/vnl_random.h"
 
 namespace mitk
 {
@@ -70,16 +73,29 @@ namespace mitk
     // Set stepSize
     void SetStepSize( double size );
 
+    // Seed the random number generator, used for independent chains.
+    // Without a seed the generator starts from the fixed default seed of vnl_random,
+    // so the caller has to pass a seed to get different results on each run
+    void SetSeed( unsigned int seed ) override;
+
+    // Returns the cost of the current best solution
+    double GetCost() const override;
+
+    // Take over the best solution of another modularity permutation
+    void AdoptSolution( const ConnectomicsSimulatedAnnealingPermutationBase* other ) override;
+
   protected:
 
     //////////////////// Functions ///////////////////////
     ConnectomicsSimulatedAnnealingPermutationModularity();
     ~ConnectomicsSimulatedAnnealingPermutationModularity() override;
 
-    // This function moves one single node from a module to another
-        void permutateMappingSingleNodeShift(
-      ToModuleMapType *vertexToModuleMap,
-      mitk::ConnectomicsNetwork::Pointer network );
+    // Creates a permutation with the same network, cost function and settings
+    ::itk::LightObject::Pointer InternalClone() const override;
+
+    // This function proposes to move one single node from its module to another,
+    // returns false if the proposal does not change anything
+    bool proposeSingleNodeShift( int *vertex, int *module );
 
         // This function splits and joins modules
     void permutateMappingModuleChange(
@@ -119,6 +135,12 @@ namespace mitk
     // Evaluate mapping using a modularity cost function
     double Evaluate( ToModuleMapType* mapping ) const;
 
+    // Evaluate the incrementally maintained state using a modularity cost function
+    double EvaluateState() const;
+
+    // Evaluate the change in cost when moving a vertex of the state using a modularity cost function
+    double EvaluateMove( int vertex, int module ) const;
+
     // Whether to accept the permutation
     bool AcceptChange( double costBefore, double costAfter, double temperature ) const;
 
@@ -133,6 +155,13 @@ namespace mitk
 
     // The step size for recursive configuring of simulated annealing manager
     double m_StepSize;
+
+    // Incrementally updated module statistics for single node shifts
+    mitk::ConnectomicsModularityState m_State;
+
+    // The random number generator of this chain, it does not use the global rand()
+    // because permutations are created concurrently by parallel chains
+    mutable vnl_random m_RandomGenerator;
   };
 
 }// end namespace mitk
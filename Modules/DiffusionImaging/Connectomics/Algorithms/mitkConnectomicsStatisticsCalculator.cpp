@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkConnectomicsStatisticsCalculator.h"
 #include "mitkConnectomicsNetworkConverter.h"
+#include "mitkConnectomicsPathEngine.h"
 
 #include <numeric>
 
@@ -36,33 +37,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "vnl/algo/vnl_symmetric_eigensystem.h"
 
-template<typename GraphType>
-class all_pairs_shortest_recorder : public boost::default_bfs_visitor
-{
-public:
-  typedef typename boost::graph_traits<GraphType>::vertex_descriptor VertexType;
-  typedef typename boost::graph_traits<GraphType>::edge_descriptor EdgeType;
-
-  all_pairs_shortest_recorder(int* dist, int &max, unsigned int &size)
-  {
-    d = dist;
-    ecc = &max;
-    component_size = &size;
-  }
-
-  void tree_edge(EdgeType edge, const GraphType& graph) {
-    VertexType u = boost::source(edge, graph);
-    VertexType v = boost::target(edge, graph);
-    d[v] = d[u] + 1;
-    *ecc = d[v];
-    *component_size = *component_size + 1;
-  }
-private:
-  int* d;
-  int* ecc;
-  unsigned int* component_size;
-};
-
 mitk::ConnectomicsStatisticsCalculator::ConnectomicsStatisticsCalculator()
   : m_Network( nullptr )
   , m_NumberOfVertices( 0 )
@@ -121,6 +95,7 @@ mitk::ConnectomicsStatisticsCalculator::ConnectomicsStatisticsCalculator()
   , m_NormalizedLaplacianLowerSlope( 0.0 )
   , m_NormalizedLaplacianUpperSlope( 0.0 )
   , m_SmallWorldness( 0.0 )
+  , m_PathEngine( nullptr )
 {
 }
 
@@ -138,6 +113,12 @@ void mitk::ConnectomicsStatisticsCalculator::Update()
   CalculateAverageComponentSize();
   CalculateLargestComponentSize();
   CalculateRatioOfNodesInLargestComponent();
+
+  // all pairs breadth first searches are shared by the hop plot and the shortest path metrics
+  m_PathEngine = mitk::ConnectomicsPathEngine::New();
+  m_PathEngine->SetNetwork( m_Network );
+  m_PathEngine->CalculateShortestPaths();
+
   CalculateHopPlotValues();
   CalculateClusteringCoefficients();
   CalculateBetweennessCentrality();
@@ -208,32 +189,10 @@ void mitk::ConnectomicsStatisticsCalculator::CalculateRatioOfNodesInLargestCompo
 
 void mitk::ConnectomicsStatisticsCalculator::CalculateHopPlotValues()
 {
-  std::vector<int> bins( m_NumberOfVertices );
-
-  VertexIteratorType vi, vi_end;
+  // number of vertex pairs per hop distance from the breadth first searches of all vertices
+  std::vector<int> bins = m_PathEngine->GetHopCounts();
   unsigned int index( 0 );
 
-  for( boost::tie( vi, vi_end ) = boost::vertices( *(m_Network->GetBoostGraph()) ); vi != vi_end; ++vi)
-  {
-    std::vector<int> distances(m_NumberOfVertices, 0);
-    int max_distance = 0;
-    VertexDescriptorType src = *vi;
-    distances[src] = 0;
-    unsigned int size = 0;
-
-    boost::breadth_first_search(*(m_Network->GetBoostGraph()), src,
-      visitor(all_pairs_shortest_recorder< NetworkType >
-      (&distances[0], max_distance, size)));
-
-    for(index=0; index < distances.size(); index++)
-    {
-      if(distances[index] > 0)
-      {
-        bins[distances[index]]++;
-      }
-    }
-  }
-
   bins[0] = m_NumberOfVertices;
   for(index=1; index < bins.size(); index++)
   {
@@ -351,36 +310,35 @@ void mitk::ConnectomicsStatisticsCalculator::CalculateClusteringCoefficients()
 
 void mitk::ConnectomicsStatisticsCalculator::CalculateBetweennessCentrality()
 {
-  // std::map used for convenient initialization
-  EdgeIndexStdMapType stdEdgeIndex;
   // associative property map needed for iterator property map-wrapper
-  EdgeIndexMapType edgeIndex(stdEdgeIndex);
+  EdgeIndexMapType edgeIndex(m_EdgeIndexStdMap);
 
   EdgeIteratorType iterator, end;
 
   // sets iterator to start end end to end
   boost::tie(iterator, end) = boost::edges( *(m_Network->GetBoostGraph()) );
 
+  m_EdgeIndexStdMap.clear();
   int i(0);
   for ( ; iterator != end; ++iterator, ++i)
   {
-    stdEdgeIndex.insert(std::pair< EdgeDescriptorType, int >( *iterator, i));
+    m_EdgeIndexStdMap.insert(std::pair< EdgeDescriptorType, int >( *iterator, i));
   }
 
+  // the path engine uses the same edge order
+  m_PathEngine->CalculateBetweennessCentrality();
+
   // Define EdgeCentralityMap
-  m_VectorOfEdgeBetweennessCentralities.resize( m_NumberOfEdges, 0.0);
+  m_VectorOfEdgeBetweennessCentralities = m_PathEngine->GetVectorOfEdgeBetweennessCentralities();
   // Create the external property map
   m_PropertyMapOfEdgeBetweennessCentralities = EdgeIteratorPropertyMapType(m_VectorOfEdgeBetweennessCentralities.begin(), edgeIndex);
 
   // Define VertexCentralityMap
   VertexIndexMapType vertexIndex = get(boost::vertex_index, *(m_Network->GetBoostGraph()) );
-  m_VectorOfVertexBetweennessCentralities.resize( m_NumberOfVertices, 0.0);
+  m_VectorOfVertexBetweennessCentralities = m_PathEngine->GetVectorOfVertexBetweennessCentralities();
   // Create the external property map
   m_PropertyMapOfVertexBetweennessCentralities = VertexIteratorPropertyMapType(m_VectorOfVertexBetweennessCentralities.begin(), vertexIndex);
 
-  boost::brandes_betweenness_centrality( *(m_Network->GetBoostGraph()),
-    m_PropertyMapOfVertexBetweennessCentralities, m_PropertyMapOfEdgeBetweennessCentralities );
-
   m_AverageVertexBetweennessCentrality = std::accumulate(m_VectorOfVertexBetweennessCentralities.begin(),
     m_VectorOfVertexBetweennessCentralities.end(),
     0.0) / (double) m_NumberOfVertices;
@@ -428,11 +386,6 @@ void mitk::ConnectomicsStatisticsCalculator::CalculateShortestPathMetrics()
   //for all vertices:
   VertexIteratorType vi, vi_end;
 
-  //store the eccentricities in a vector.
-  m_VectorOfEccentrities.resize( m_NumberOfVertices );
-  m_VectorOfEccentrities90.resize( m_NumberOfVertices );
-  m_VectorOfAveragePathLengths.resize( m_NumberOfVertices );
-
   //assign diameter and radius while iterating over the ecccencirities.
   m_Diameter              = 0;
   m_Diameter90            = 0;
@@ -446,27 +399,20 @@ void mitk::ConnectomicsStatisticsCalculator::CalculateShortestPathMetrics()
   unsigned int giant_component_size = 0;
   VertexDescriptorType radius_src(0);
 
+  //The breadth first searches from all vertices are run by the path
+  //engine, which stores per source vertex the maximum distance
+  //(eccentricity), the number of hops needed to reach 90 percent of
+  //the reachable nodes, the average distance to all reachable nodes
+  //and the number of nodes discovered.
+  m_VectorOfEccentrities = m_PathEngine->GetVectorOfEccentricities();
+  m_VectorOfEccentrities90 = m_PathEngine->GetVectorOfEccentricities90();
+  m_VectorOfAveragePathLengths = m_PathEngine->GetVectorOfAveragePathLengths();
+  const std::vector< unsigned int > reachableVertices = m_PathEngine->GetVectorOfReachableVertices();
+
   //Loop over the vertices
   for( boost::tie(vi, vi_end) = boost::vertices( *(m_Network->GetBoostGraph()) ); vi!=vi_end; ++vi)
   {
-    //We are going to start a BFS, initialize the neccessary
-    //structures for that.  Store the distances of nodes from the
-    //source in distance vector. The maximum distance is stored in
-    //max. The BFS will start from the node that vi is pointing, that
-    //is the src is *vi. We also init the distance of the src node to
-    //itself to 0. size gives the number of nodes discovered during
-    //this BFS.
-    std::vector<int> distances( m_NumberOfVertices );
-    int max_distance = 0;
     VertexDescriptorType src = *vi;
-    distances[src] = 0;
-    unsigned int size = 0;
-
-    breadth_first_search(*(m_Network->GetBoostGraph()), src,
-      visitor(all_pairs_shortest_recorder<NetworkType>
-      (&distances[0], max_distance, size)));
-    // vertex vi has eccentricity equal to max_distance
-    m_VectorOfEccentrities[src] = max_distance;
 
     //check whether there is any change in the diameter or the radius.
     //note that the diameter we are calculating here is also the
@@ -483,44 +429,12 @@ void mitk::ConnectomicsStatisticsCalculator::CalculateShortestPathMetrics()
     //found we should loop over this connected component and find the
     //minimum eccentricity which is the radius. So we keep the src
     //node, so that we can find the connected component later on.
-    if(size > giant_component_size)
+    if(reachableVertices[src] > giant_component_size)
     {
-      giant_component_size = size;
+      giant_component_size = reachableVertices[src];
       radius_src = src;
     }
 
-    //Calculate in how many hops we can reach 90 percent of the
-    //nodes. We store the number of hops we can reach in h hops in the
-    //bucket vector. That is bucket[h] gives the number of nodes
-    //reachable in exactly h hops. sum of bucket[i<h] gives the number
-    //of nodes that are reachable in less than h hops. We also
-    //calculate sum of the distances from this node to every single
-    //other node in the graph.
-    int reachable90 = std::ceil((double)size * 0.9);
-    std::vector <int> bucket (max_distance+1);
-    int counter = 0;
-    for(unsigned int i=0; i<distances.size(); i++)
-    {
-      if(distances[i]>0)
-      {
-        bucket[distances[i]]++;
-        m_VectorOfAveragePathLengths[src] += distances[i];
-        counter ++;
-      }
-    }
-    if(counter > 0)
-    {
-      m_VectorOfAveragePathLengths[src] = m_VectorOfAveragePathLengths[src] / counter;
-    }
-
-    int eccentricity90 = 0;
-    while(reachable90 > 0)
-    {
-      eccentricity90 ++;
-      reachable90 = reachable90 - bucket[eccentricity90];
-    }
-    // vertex vi has eccentricity90 equal to eccentricity90
-    m_VectorOfEccentrities90[src] = eccentricity90;
     if(m_VectorOfEccentrities90[src] > m_Diameter90)
     {
       m_Diameter90 = m_VectorOfEccentrities90[src];
@@ -747,3 +661,21 @@ void mitk::ConnectomicsStatisticsCalculator::CalculateSmallWorldness()
 
   m_SmallWorldness = gamma / lambda;
 }
+
+std::vector< mitk::ConnectomicsStatisticsCalculator::Pointer > mitk::ConnectomicsStatisticsCalculator::CalculateStatistics(
+  const std::vector< mitk::ConnectomicsNetwork::Pointer >& networks )
+{
+  std::vector< Pointer > calculators( networks.size() );
+
+  // one network per task, the path calculations of a single network run serially inside
+#pragma omp parallel for schedule(dynamic)
+  for( int index = 0; index < (int)networks.size(); index++ )
+  {
+    Pointer calculator = Self::New();
+    calculator->SetNetwork( networks[ index ] );
+    calculator->Update();
+    calculators[ index ] = calculator;
+  }
+
+  return calculators;
+}
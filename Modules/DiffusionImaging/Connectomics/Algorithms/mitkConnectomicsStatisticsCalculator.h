@@ -26,6 +26,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkConnectomicsExports.h>
 
 #include <mitkConnectomicsNetwork.h>
+#include "mitkConnectomicsPathEngine.h"
 
 namespace mitk
 {
@@ -117,6 +118,13 @@ namespace mitk
 
     void Update();
 
+    /**
+    * \brief Calculate the statistics of many networks in one call
+    *
+    * The networks are processed in parallel, one calculator per network is returned in the same order.
+    */
+    static std::vector< Pointer > CalculateStatistics( const std::vector< mitk::ConnectomicsNetwork::Pointer >& networks );
+
   protected:
 
     //////////////////// Functions ///////////////////////
@@ -236,6 +244,12 @@ namespace mitk
     double m_NormalizedLaplacianLowerSlope;
     double m_NormalizedLaplacianUpperSlope;
     double m_SmallWorldness;
+
+    // Edge indices used by the edge betweenness property map
+    EdgeIndexStdMapType m_EdgeIndexStdMap;
+
+    // Multithreaded breadth first search and betweenness calculation
+    mitk::ConnectomicsPathEngine::Pointer m_PathEngine;
   };
 
 }// end namespace mitk
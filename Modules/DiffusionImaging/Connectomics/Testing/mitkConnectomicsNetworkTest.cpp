@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConnectomicsSimulatedAnnealingManager.h"
 #include "mitkConnectomicsSimulatedAnnealingPermutationModularity.h"
 #include "mitkConnectomicsSimulatedAnnealingCostFunctionModularity.h"
+#include "mitkConnectomicsModularityState.h"
 
 #include <vtkDebugLeaks.h>
 
@@ -519,6 +520,52 @@ int mitkConnectomicsNetworkTest(int, char* [])
 
     bool noInternalThreeModuleModularity( std::abs(-0.3395 - costFunction->CalculateModularity( network, &noInternalLinksThreeModuleSolution )) < eps);
     MITK_TEST_CONDITION_REQUIRED( noInternalThreeModuleModularity, "Expected three module modularity containing no internal links")
+
+    // Test whether the incremental modularity matches the full calculation
+    mitk::ConnectomicsModularityState state;
+    state.Initialize( network, &threeModuleSolution );
+
+    bool stateModularity( std::abs( costFunction->CalculateModularity( network, &threeModuleSolution ) - state.GetModularity() ) < eps );
+    MITK_TEST_CONDITION_REQUIRED( stateModularity, "Expected incremental modularity to match full calculation")
+
+    bool correctMoveDelta( true );
+    ToModuleMapType movedSolution = threeModuleSolution;
+    for( int vertex( 0 ); vertex < state.GetNumberOfVertices(); vertex++ )
+    {
+      // move every vertex to the next module, the last one into a new module
+      const int targetModule = ( vertex == state.GetNumberOfVertices() - 1 )
+        ? state.GetNumberOfModules() : ( state.GetModuleOfVertex( vertex ) + 1 ) % state.GetNumberOfModules();
+      const double modularityBefore = state.GetModularity();
+      const double delta = state.CalculateMoveDelta( vertex, targetModule );
+      state.CommitMove( vertex, targetModule );
+      movedSolution = state.GetMapping();
+
+      correctMoveDelta = correctMoveDelta
+        && std::abs( modularityBefore + delta - costFunction->CalculateModularity( network, &movedSolution ) ) < eps
+        && std::abs( state.GetModularity() - costFunction->CalculateModularity( network, &movedSolution ) ) < eps;
+    }
+    MITK_TEST_CONDITION_REQUIRED( correctMoveDelta, "Expected modularity change of single vertex moves to match full calculation")
+
+    // Test whether several annealing chains give the same division for the same seeds
+    ToModuleMapType chainSolutions[ 2 ];
+    for( int run( 0 ); run < 2; run++ )
+    {
+      mitk::ConnectomicsSimulatedAnnealingManager::Pointer chainManager = mitk::ConnectomicsSimulatedAnnealingManager::New();
+      mitk::ConnectomicsSimulatedAnnealingPermutationModularity::Pointer chainPermutation = mitk::ConnectomicsSimulatedAnnealingPermutationModularity::New();
+
+      chainPermutation->SetCostFunction( costFunction.GetPointer() );
+      chainPermutation->SetNetwork( network );
+      chainPermutation->SetDepth( 2 );
+      chainPermutation->SetStepSize( 4.0 );
+      chainPermutation->SetSeed( 42 );
+
+      chainManager->SetPermutation( chainPermutation.GetPointer() );
+      chainManager->SetSeed( 7 );
+      chainManager->RunSimulatedAnnealing( 2.0, 4.0, 3 );
+
+      chainSolutions[ run ] = chainPermutation->GetMapping();
+    }
+    MITK_TEST_CONDITION_REQUIRED( chainSolutions[ 0 ] == chainSolutions[ 1 ], "Expected identical division of several annealing chains with the same seeds")
   }
   catch (...)
   {
@@ -38,6 +38,7 @@ class mitkConnectomicsStatisticsCalculatorTestSuite : public mitk::TestFixture
   vtkDebugLeaks::SetExitError(0);
 
   MITK_TEST(StatisticsCalculatorUpdate);
+  MITK_TEST(StatisticsCalculatorBatch);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -136,6 +137,27 @@ public:
     CPPUNIT_ASSERT_MESSAGE( "GetSmallWorldness", mitk::Equal( statisticsCalculator->GetSmallWorldness( ), 1.72908 , eps, true ) );
 
   }
+
+  void StatisticsCalculatorBatch()
+  {
+    std::vector< mitk::ConnectomicsNetwork::Pointer > networks( 3, m_Network );
+    std::vector< mitk::ConnectomicsStatisticsCalculator::Pointer > calculators =
+      mitk::ConnectomicsStatisticsCalculator::CalculateStatistics( networks );
+
+    double eps( 0.0001 );
+
+    CPPUNIT_ASSERT_MESSAGE( "Number of calculators", calculators.size() == networks.size() );
+    for( unsigned int index( 0 ); index < calculators.size(); index++ )
+    {
+      CPPUNIT_ASSERT_MESSAGE( "GetHopPlotExponent", mitk::Equal( calculators[ index ]->GetHopPlotExponent( ), 0.192645 , eps, true ) );
+      CPPUNIT_ASSERT_MESSAGE( "GetAverageVertexBetweennessCentrality", mitk::Equal( calculators[ index ]->GetAverageVertexBetweennessCentrality( ), 0.25 , eps, true ) );
+      CPPUNIT_ASSERT_MESSAGE( "GetAverageEdgeBetweennessCentrality", mitk::Equal( calculators[ index ]->GetAverageEdgeBetweennessCentrality( ), 1.4 , eps, true ) );
+      CPPUNIT_ASSERT_MESSAGE( "GetDiameter90", mitk::Equal( calculators[ index ]->GetDiameter90( ), 2 , eps, true ) );
+      CPPUNIT_ASSERT_MESSAGE( "GetRadius" , mitk::Equal( calculators[ index ]->GetRadius( ), 1 , eps, true ) );
+      CPPUNIT_ASSERT_MESSAGE( "GetAveragePathLength" , mitk::Equal( calculators[ index ]->GetAveragePathLength( ), 1.16667 , eps, true ) );
+      CPPUNIT_ASSERT_MESSAGE( "GetSmallWorldness", mitk::Equal( calculators[ index ]->GetSmallWorldness( ), 1.72908 , eps, true ) );
+    }
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkConnectomicsStatisticsCalculator)
@@ -30,7 +30,9 @@ set(CPP_FILES
   Algorithms/mitkConnectomicsSimulatedAnnealingManager.cpp
   Algorithms/mitkConnectomicsSimulatedAnnealingCostFunctionBase.cpp
   Algorithms/mitkConnectomicsSimulatedAnnealingCostFunctionModularity.cpp
+  Algorithms/mitkConnectomicsModularityState.cpp
   Algorithms/mitkConnectomicsStatisticsCalculator.cpp
+  Algorithms/mitkConnectomicsPathEngine.cpp
   Algorithms/mitkConnectomicsNetworkConverter.cpp
   Algorithms/mitkConnectomicsNetworkThresholder.cpp
   Algorithms/mitkFreeSurferParcellationTranslator.cpp
@@ -69,8 +71,10 @@ set(H_FILES
   Algorithms/mitkConnectomicsSimulatedAnnealingManager.h
   Algorithms/mitkConnectomicsSimulatedAnnealingCostFunctionBase.h
   Algorithms/mitkConnectomicsSimulatedAnnealingCostFunctionModularity.h
+  Algorithms/mitkConnectomicsModularityState.h
   Algorithms/itkConnectomicsNetworkToConnectivityMatrixImageFilter.h
   Algorithms/mitkConnectomicsStatisticsCalculator.h
+  Algorithms/mitkConnectomicsPathEngine.h
   Algorithms/mitkConnectomicsNetworkConverter.h
   Algorithms/BrainParcellation/mitkCostFunctionBase.h
   Algorithms/BrainParcellation/mitkRandomParcellationGenerator.h
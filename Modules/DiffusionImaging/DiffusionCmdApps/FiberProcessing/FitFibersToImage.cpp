@@ -59,6 +59,7 @@ int main(int argc, char* argv[])
   parser.addArgument("filter_outliers", "", mitkCommandLineParser::Bool, "Filter outliers:", "perform second optimization run with an upper weight bound based on the first weight estimation (99% quantile)", false);
   parser.addArgument("join_tracts", "", mitkCommandLineParser::Bool, "Join output tracts:", "outout tracts are merged into a single tractogram", false);
   parser.addArgument("regu", "", mitkCommandLineParser::String, "Regularization:", "MSM, Variance, VoxelVariance (default), Lasso, GroupLasso, GroupVariance, NONE");
+  parser.addArgument("solver", "", mitkCommandLineParser::String, "Solver:", "LBFGSB (default), ProjectedGradient");
 
   std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
   if (parsedArgs.size()==0)
@@ -84,6 +85,10 @@ int main(int argc, char* argv[])
   if (parsedArgs.count("regu"))
     regu = us::any_cast<std::string>(parsedArgs["regu"]);
 
+  std::string solver = "LBFGSB";
+  if (parsedArgs.count("solver"))
+    solver = us::any_cast<std::string>(parsedArgs["solver"]);
+
   bool join_tracts = false;
   if (parsedArgs.count("join_tracts"))
     join_tracts = us::any_cast<bool>(parsedArgs["join_tracts"]);
@@ -172,6 +177,11 @@ int main(int argc, char* argv[])
     else if (regu=="NONE")
       fitter->SetRegularization(VnlCostFunction::REGU::NONE);
 
+    if (solver=="ProjectedGradient")
+      fitter->SetSolver(itk::FitFibersToImageFilter::PROJECTED_GRADIENT);
+    else
+      fitter->SetSolver(itk::FitFibersToImageFilter::LBFGSB);
+
     fitter->Update();
 
     mitk::LocaleSwitch localeSwitch("C");
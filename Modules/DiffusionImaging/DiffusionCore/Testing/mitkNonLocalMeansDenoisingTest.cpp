@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkGradientDirectionsProperty.h"
 #include "mitkITKImageImport.h"
 #include <mitkImageCast.h>
+#include <itkImageRegionConstIterator.h>
 
 class mitkNonLocalMeansDenoisingTestSuite : public mitk::TestFixture
 {
@@ -30,6 +31,11 @@ class mitkNonLocalMeansDenoisingTestSuite : public mitk::TestFixture
   MITK_TEST(Denoise_NLMr_shouldReturnTrue);
   MITK_TEST(Denoise_NLMv_shouldReturnTrue);
   MITK_TEST(Denoise_NLMvr_shouldReturnTrue);
+  MITK_TEST(Denoise_NLMgFast_shouldMatchExactMode);
+  MITK_TEST(Denoise_NLMrFast_shouldMatchExactMode);
+  MITK_TEST(Denoise_NLMvFast_shouldMatchExactMode);
+  MITK_TEST(Denoise_Blockwise_shouldNotDependOnThreads);
+  MITK_TEST(Denoise_BlockwiseConstantImage_shouldStayConstant);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -43,6 +49,35 @@ private:
   itk::Image<short, 3>::Pointer m_ImageMask;
   itk::NonLocalMeansDenoisingFilter<short>::Pointer m_DenoisingFilter;
 
+  /** Runs the filter in exact and in fast mode and returns the largest absolute voxel difference. */
+  double CompareFastToExactMode(bool useRicianAdaption, bool useJointInformation)
+  {
+    m_DenoisingFilter->SetUseRicianAdaption(useRicianAdaption);
+    m_DenoisingFilter->SetUseJointInformation(useJointInformation);
+    m_DenoisingFilter->SetUseFastMode(false);
+    m_DenoisingFilter->Update();
+    VectorImagetType::Pointer exact = m_DenoisingFilter->GetOutput();
+    exact->DisconnectPipeline();
+
+    m_DenoisingFilter->SetUseFastMode(true);
+    m_DenoisingFilter->SetBlockSize(2);
+    m_DenoisingFilter->Modified();
+    m_DenoisingFilter->Update();
+    VectorImagetType::Pointer fast = m_DenoisingFilter->GetOutput();
+
+    double maxDiff = 0;
+    itk::ImageRegionConstIterator<VectorImagetType> eit(exact, exact->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<VectorImagetType> fit(fast, fast->GetLargestPossibleRegion());
+    for (; !eit.IsAtEnd(); ++eit, ++fit)
+    {
+      for (unsigned int i = 0; i < exact->GetVectorLength(); ++i)
+      {
+        maxDiff = std::max(maxDiff, std::fabs(static_cast<double>(eit.Get()[i]) - fit.Get()[i]));
+      }
+    }
+    return maxDiff;
+  }
+
 public:
 
   /**
@@ -164,6 +199,79 @@ public:
     MITK_ASSERT_EQUAL( m_DenoisedImage, m_ReferenceImage, "NLMvr should always return the same result.");
   }
 
+  void Denoise_NLMgFast_shouldMatchExactMode()
+  {
+    // both modes compute the same weights, only rounding of the final value may differ
+    CPPUNIT_ASSERT_MESSAGE("Fast NLMg should match the exact mode.", CompareFastToExactMode(false, false) <= 1);
+  }
+
+  void Denoise_NLMrFast_shouldMatchExactMode()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Fast NLMr should match the exact mode.", CompareFastToExactMode(true, false) <= 1);
+  }
+
+  void Denoise_NLMvFast_shouldMatchExactMode()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Fast NLMv should match the exact mode.", CompareFastToExactMode(false, true) <= 1);
+  }
+
+  void Denoise_Blockwise_shouldNotDependOnThreads()
+  {
+    // the block centers lie on a global grid, so the thread regions must not change the result
+    m_DenoisingFilter->SetUseRicianAdaption(true);
+    m_DenoisingFilter->SetUseJointInformation(true);
+    m_DenoisingFilter->SetUseFastMode(true);
+    m_DenoisingFilter->SetUseBlockwiseEstimation(true);
+    m_DenoisingFilter->SetBlockSize(2);
+    m_DenoisingFilter->Update();
+    VectorImagetType::Pointer single = m_DenoisingFilter->GetOutput();
+    single->DisconnectPipeline();
+
+    m_DenoisingFilter->SetNumberOfThreads(3);
+    m_DenoisingFilter->Modified();
+    m_DenoisingFilter->Update();
+    VectorImagetType::Pointer multi = m_DenoisingFilter->GetOutput();
+
+    itk::ImageRegionConstIterator<VectorImagetType> sit(single, single->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<VectorImagetType> mit(multi, multi->GetLargestPossibleRegion());
+    for (; !sit.IsAtEnd(); ++sit, ++mit)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Blockwise estimation should not depend on the number of threads.", sit.Get() == mit.Get());
+    }
+  }
+
+  void Denoise_BlockwiseConstantImage_shouldStayConstant()
+  {
+    VectorImagetType::RegionType region;
+    region.SetSize(0, 9);
+    region.SetSize(1, 8);
+    region.SetSize(2, 7);
+    VectorImagetType::Pointer image = VectorImagetType::New();
+    image->SetRegions(region);
+    image->SetVectorLength(3);
+    image->Allocate();
+    VectorImagetType::PixelType value;
+    value.SetSize(3);
+    value.Fill(100);
+    image->FillBuffer(value);
+
+    m_DenoisingFilter->SetInputImage(image);
+    m_DenoisingFilter->SetComparisonRadius(2);
+    m_DenoisingFilter->SetSearchRadius(2);
+    m_DenoisingFilter->SetUseRicianAdaption(false);
+    m_DenoisingFilter->SetUseJointInformation(true);
+    m_DenoisingFilter->SetUseFastMode(true);
+    m_DenoisingFilter->SetUseBlockwiseEstimation(true);
+    m_DenoisingFilter->SetBlockDistance(3);
+    m_DenoisingFilter->Update();
+
+    itk::ImageRegionConstIterator<VectorImagetType> it(m_DenoisingFilter->GetOutput(), region);
+    for (; !it.IsAtEnd(); ++it)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Every voxel should be covered by a block.", it.Get() == value);
+    }
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkNonLocalMeansDenoising)
@@ -27,6 +27,17 @@ namespace itk{
    *
    * This Filter needs as an input a diffusion weigthed image, which will be denoised unsing the non-local means principle.
    * An input mask is optional to denoise only inside the mask range. All other voxels will be set to 0.
+   *
+   * Two computation modes are available. The exact mode compares every neighborhood pair explicitly. The fast mode
+   * iterates over the search offsets instead and obtains the neighborhood distances of all voxels of a block from an
+   * integral image of squared differences, so the runtime no longer depends on the comparison radius. Both modes
+   * yield the same weights up to floating point rounding. The only exception is the combination of joint information
+   * and Rician adaption: here the exact mode additionally averages the unsquared neighbor values, which the fast mode
+   * does not reproduce.
+   *
+   * In the fast mode the weights can optionally be estimated blockwise: they are only computed for the centers of a
+   * grid and every voxel uses the summed weights of the blocks (comparison neighborhoods) it belongs to. This reduces
+   * the number of weight evaluations by the cubed block distance but does not reproduce the voxelwise result.
   */
 
   template< class TPixelType >
@@ -83,6 +94,38 @@ namespace itk{
      * If this flag is true the filter uses a method which is optimized for Rician distributed noise.
      */
     itkSetMacro(UseRicianAdaption, bool)
+    /**
+     * @brief Set flag to use the fast integral image based computation
+     *
+     * If this flag is true the neighborhood distances are computed per search offset using integral images of the
+     * squared differences. Default is false.
+     */
+    itkSetMacro(UseFastMode, bool)
+    itkGetMacro(UseFastMode, bool)
+    /**
+     * @brief Set the number of slices that are processed at once in the fast mode
+     *
+     * Larger blocks reduce the overhead of the integral image borders but need more memory
+     * (approx. (blocksize + 2 * comparisonradius) slices of doubles per gradient direction and thread).
+     * Default is 4.
+     */
+    itkSetMacro(BlockSize, int)
+    itkGetMacro(BlockSize, int)
+    /**
+     * @brief Set flag to estimate the weights blockwise in the fast mode
+     *
+     * Default is false. Ignored in the exact mode.
+     */
+    itkSetMacro(UseBlockwiseEstimation, bool)
+    itkGetMacro(UseBlockwiseEstimation, bool)
+    /**
+     * @brief Set the distance between the block centers of the blockwise estimation
+     *
+     * The distance is limited to comparisonradius + 1, so that each voxel belongs to at least one block.
+     * Default is 2.
+     */
+    itkSetMacro(BlockDistance, int)
+    itkGetMacro(BlockDistance, int)
     /**
      * @brief Get the amount of calculated Voxels
      *
@@ -124,6 +167,16 @@ namespace itk{
      */
     void ThreadedGenerateData( const OutputImageRegionType &outputRegionForThread, ThreadIdType) override;
 
+    /**
+     * @brief Integral image based denoising procedure
+     *
+     * The region is processed in blocks of m_BlockSize slices. For every search offset the squared differences of the
+     * block (padded by the comparison radius) are summed up into an integral image with all gradient channels stored
+     * contiguously per voxel, which allows to read the distance of each neighborhood pair in constant time.
+     *
+     * @param outputRegionForThread Region to denoise for each thread.
+     */
+    void FastThreadedGenerateData( const OutputImageRegionType &outputRegionForThread );
 
 
   private:
@@ -132,6 +185,10 @@ namespace itk{
     int m_ComparisonRadius;                           ///< Radius of the comparisonblock.
     bool m_UseJointInformation;                       ///< Flag to use joint information.
     bool m_UseRicianAdaption;                         ///< Flag to use rician adaption.
+    bool m_UseFastMode;                               ///< Flag to use the integral image based computation.
+    int m_BlockSize;                                  ///< Number of slices per block in the fast mode.
+    bool m_UseBlockwiseEstimation;                    ///< Flag to compute the weights only at the block centers.
+    int m_BlockDistance;                              ///< Distance between the block centers.
     unsigned int m_CurrentVoxelCount;                 ///< Amount of processed voxels.
     double m_Variance;                                ///< Estimated noise variance.
     typename MaskImageType::Pointer m_Mask;           ///< Pointer to the mask image.
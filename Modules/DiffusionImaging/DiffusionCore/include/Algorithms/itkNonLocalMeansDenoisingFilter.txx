@@ -28,6 +28,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkNeighborhoodIterator.h"
 #include <itkImageRegionIteratorWithIndex.h>
 #include <vector>
+#include <algorithm>
 
 namespace itk {
 
@@ -39,6 +40,10 @@ NonLocalMeansDenoisingFilter< TPixelType >
     m_ComparisonRadius(1),
     m_UseJointInformation(false),
     m_UseRicianAdaption(false),
+    m_UseFastMode(false),
+    m_BlockSize(4),
+    m_UseBlockwiseEstimation(false),
+    m_BlockDistance(2),
     m_Variance(1),
     m_Mask(nullptr)
 {
@@ -56,6 +61,8 @@ NonLocalMeansDenoisingFilter< TPixelType >
   MITK_INFO << "Noisevariance: " << m_Variance;
   MITK_INFO << "Use Rician Adaption: " << std::boolalpha << m_UseRicianAdaption;
   MITK_INFO << "Use Joint Information: " << std::boolalpha << m_UseJointInformation;
+  MITK_INFO << "Use Fast Mode: " << std::boolalpha << m_UseFastMode;
+  MITK_INFO << "Use Blockwise Estimation: " << std::boolalpha << m_UseBlockwiseEstimation;
 
 
   typename InputImageType::Pointer inputImagePointer = static_cast< InputImageType * >( this->ProcessObject::GetInput(0) );
@@ -127,7 +134,11 @@ void
 NonLocalMeansDenoisingFilter< TPixelType >
 ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType )
 {
-
+  if (m_UseFastMode)
+  {
+    this->FastThreadedGenerateData(outputRegionForThread);
+    return;
+  }
 
   // initialize iterators
   typename OutputImageType::Pointer outputImage =
@@ -372,6 +383,349 @@ NonLocalMeansDenoisingFilter< TPixelType >
   MITK_INFO << "One Thread finished calculation";
 }
 
+template< class TPixelType >
+void
+NonLocalMeansDenoisingFilter< TPixelType >
+::FastThreadedGenerateData(const OutputImageRegionType& outputRegionForThread)
+{
+  typename InputImageType::Pointer inputImagePointer = static_cast< InputImageType * >( this->ProcessObject::GetInput(0) );
+  typename OutputImageType::Pointer outputImage = static_cast< OutputImageType * >(this->ProcessObject::GetOutput(0));
+
+  const typename InputImageType::RegionType imageRegion = inputImagePointer->GetLargestPossibleRegion();
+  const int numChannels = static_cast<int>(inputImagePointer->GetVectorLength());
+  // in joint mode the distances of all channels are accumulated in a single integral image
+  const int numDist = m_UseJointInformation ? 1 : numChannels;
+  const double normalization = m_UseJointInformation ? numChannels + 1 : 1;
+  const TPixelType* inputBuffer = inputImagePointer->GetBufferPointer();
+  const typename InputImageType::OffsetValueType* offsetTable = inputImagePointer->GetOffsetTable();
+
+  int imageMin[3], imageMax[3];
+  for (int d = 0; d < 3; ++d)
+  {
+    imageMin[d] = imageRegion.GetIndex(d);
+    imageMax[d] = imageMin[d] + static_cast<int>(imageRegion.GetSize(d)) - 1;
+  }
+
+  const int regionStartZ = outputRegionForThread.GetIndex(2);
+  const int regionEndZ = regionStartZ + static_cast<int>(outputRegionForThread.GetSize(2));
+  const int blockSize = m_BlockSize > 0 ? m_BlockSize : regionEndZ - regionStartZ;
+
+  // In the blockwise estimation the weights are only computed at the centers of a grid with the given spacing (global,
+  // so the result does not depend on the thread regions). Each voxel uses the summed weights of all centers whose
+  // comparison neighborhood contains it; the spacing is limited so that every voxel is covered by at least one center.
+  const bool blockwise = m_UseBlockwiseEstimation && m_ComparisonRadius > 0;
+  const int centerSpacing = blockwise ? std::max(1, std::min(m_BlockDistance, m_ComparisonRadius + 1)) : 1;
+  // the comparison neighborhoods of the centers reach up to twice the comparison radius beyond the block
+  const int padRadius = blockwise ? 2 * m_ComparisonRadius : m_ComparisonRadius;
+
+  std::vector<double> table;
+  std::vector<double> weightSum;
+  std::vector<double> valueSum;
+  std::vector<double> blockWeight;
+  std::vector<double> weight(numDist);
+  std::vector<char> inMask;
+
+  typename OutputImageType::PixelType outpix;
+  outpix.SetSize(numChannels);
+
+  for (int blockStartZ = regionStartZ; blockStartZ < regionEndZ; blockStartZ += blockSize)
+  {
+    // current block and the block padded by the comparison radius (cropped to the image)
+    int blockMin[3], blockMax[3], blockSz[3], padMin[3], padSz[3], centerMin[3], centerMax[3];
+    for (int d = 0; d < 2; ++d)
+    {
+      blockMin[d] = outputRegionForThread.GetIndex(d);
+      blockSz[d] = outputRegionForThread.GetSize(d);
+    }
+    blockMin[2] = blockStartZ;
+    blockSz[2] = std::min(blockSize, regionEndZ - blockStartZ);
+    for (int d = 0; d < 3; ++d)
+    {
+      blockMax[d] = blockMin[d] + blockSz[d] - 1;
+      padMin[d] = std::max(blockMin[d] - padRadius, imageMin[d]);
+      padSz[d] = std::min(blockMax[d] + padRadius, imageMax[d]) - padMin[d] + 1;
+
+      // grid centers whose comparison neighborhood overlaps the block
+      const int first = std::max(blockMin[d] - m_ComparisonRadius, imageMin[d]) - imageMin[d];
+      centerMin[d] = imageMin[d] + (first + centerSpacing - 1) / centerSpacing * centerSpacing;
+      centerMax[d] = std::min(blockMax[d] + m_ComparisonRadius, imageMax[d]);
+    }
+
+    const std::size_t numBlockVoxels = static_cast<std::size_t>(blockSz[0]) * blockSz[1] * blockSz[2];
+    // the integral image has an additional zero slice in front of every dimension
+    const std::size_t strideY = padSz[0] + 1;
+    const std::size_t strideZ = strideY * (padSz[1] + 1);
+    table.assign(strideZ * (padSz[2] + 1) * numDist, 0.0);
+    weightSum.assign(numBlockVoxels * numDist, 0.0);
+    valueSum.assign(numBlockVoxels * numChannels, 0.0);
+    inMask.assign(numBlockVoxels, 0);
+
+    std::size_t voxel = 0;
+    for (int z = blockMin[2]; z < blockMin[2] + blockSz[2]; ++z)
+      for (int y = blockMin[1]; y < blockMin[1] + blockSz[1]; ++y)
+        for (int x = blockMin[0]; x < blockMin[0] + blockSz[0]; ++x, ++voxel)
+        {
+          typename MaskImageType::IndexType index;
+          index[0] = x; index[1] = y; index[2] = z;
+          inMask[voxel] = m_Mask->GetPixel(index) != 0;
+        }
+
+    for (int oz = -m_SearchRadius; oz <= m_SearchRadius; ++oz)
+    {
+      for (int oy = -m_SearchRadius; oy <= m_SearchRadius; ++oy)
+      {
+        for (int ox = -m_SearchRadius; ox <= m_SearchRadius; ++ox)
+        {
+          if (this->GetAbortGenerateData())
+            return;
+
+          const int offset[3] = {ox, oy, oz};
+          const typename InputImageType::OffsetValueType bufferOffset =
+              (ox * offsetTable[0] + oy * offsetTable[1] + oz * offsetTable[2]) * numChannels;
+
+          // squared differences between the padded block and its shifted copy, zero where the shifted voxel is outside
+          for (int z = 0; z < padSz[2]; ++z)
+          {
+            for (int y = 0; y < padSz[1]; ++y)
+            {
+              double* row = &table[((z + 1) * strideZ + (y + 1) * strideY + 1) * numDist];
+              typename InputImageType::IndexType index;
+              index[0] = padMin[0]; index[1] = padMin[1] + y; index[2] = padMin[2] + z;
+              const TPixelType* pi = inputBuffer + inputImagePointer->ComputeOffset(index) * numChannels;
+
+              const bool rowValid = index[1] + oy >= imageMin[1] && index[1] + oy <= imageMax[1] &&
+                                    index[2] + oz >= imageMin[2] && index[2] + oz <= imageMax[2];
+              for (int x = 0; x < padSz[0]; ++x, pi += numChannels, row += numDist)
+              {
+                const int xj = padMin[0] + x + ox;
+                if (!rowValid || xj < imageMin[0] || xj > imageMax[0])
+                {
+                  std::fill(row, row + numDist, 0.0);
+                  continue;
+                }
+                const TPixelType* pj = pi + bufferOffset;
+                if (m_UseJointInformation)
+                {
+                  double sum = 0;
+                  for (int c = 0; c < numChannels; ++c)
+                  {
+                    const double diff = static_cast<double>(pi[c]) - static_cast<double>(pj[c]);
+                    sum += diff * diff;
+                  }
+                  row[0] = sum;
+                }
+                else
+                {
+                  for (int c = 0; c < numChannels; ++c)
+                  {
+                    const double diff = static_cast<double>(pi[c]) - static_cast<double>(pj[c]);
+                    row[c] = diff * diff;
+                  }
+                }
+              }
+            }
+          }
+
+          // prefix sums along x, y and z turn the squared differences into the integral image
+          for (int z = 1; z <= padSz[2]; ++z)
+          {
+            for (int y = 1; y <= padSz[1]; ++y)
+            {
+              double* row = &table[(z * strideZ + y * strideY) * numDist];
+              for (int x = 1; x <= padSz[0]; ++x)
+              {
+                double* current = row + x * numDist;
+                const double* prev = current - numDist;
+                for (int c = 0; c < numDist; ++c)
+                  current[c] += prev[c];
+              }
+            }
+          }
+          for (int z = 1; z <= padSz[2]; ++z)
+          {
+            for (int y = 1; y <= padSz[1]; ++y)
+            {
+              double* row = &table[(z * strideZ + y * strideY) * numDist];
+              const double* prev = row - strideY * numDist;
+              for (std::size_t i = 0; i < strideY * numDist; ++i)
+                row[i] += prev[i];
+            }
+          }
+          for (int z = 1; z <= padSz[2]; ++z)
+          {
+            double* slice = &table[z * strideZ * numDist];
+            const double* prev = slice - strideZ * numDist;
+            for (std::size_t i = 0; i < strideZ * numDist; ++i)
+              slice[i] += prev[i];
+          }
+
+          // weights of the neighborhood of pos (inside the padded block) and its shifted copy, false if the shifted
+          // voxel is outside of the image
+          auto computeWeights = [&](const int* pos, double* w) -> bool
+          {
+            for (int d = 0; d < 3; ++d)
+            {
+              if (pos[d] + offset[d] < imageMin[d] || pos[d] + offset[d] > imageMax[d])
+                return false;
+            }
+
+            // comparison window inside the padded block and number of valid neighborhood pairs in it
+            std::size_t lo[3], hi[3];
+            double size = normalization;
+            for (int d = 0; d < 3; ++d)
+            {
+              const int first = std::max(pos[d] - m_ComparisonRadius, imageMin[d]);
+              const int last = std::min(pos[d] + m_ComparisonRadius, imageMax[d]);
+              lo[d] = first - padMin[d];
+              hi[d] = last - padMin[d] + 1;
+              size *= std::min(last, imageMax[d] - offset[d]) - std::max(first, imageMin[d] - offset[d]) + 1;
+            }
+
+            const double* t111 = &table[(hi[2] * strideZ + hi[1] * strideY + hi[0]) * numDist];
+            const double* t110 = &table[(hi[2] * strideZ + hi[1] * strideY + lo[0]) * numDist];
+            const double* t101 = &table[(hi[2] * strideZ + lo[1] * strideY + hi[0]) * numDist];
+            const double* t100 = &table[(hi[2] * strideZ + lo[1] * strideY + lo[0]) * numDist];
+            const double* t011 = &table[(lo[2] * strideZ + hi[1] * strideY + hi[0]) * numDist];
+            const double* t010 = &table[(lo[2] * strideZ + hi[1] * strideY + lo[0]) * numDist];
+            const double* t001 = &table[(lo[2] * strideZ + lo[1] * strideY + hi[0]) * numDist];
+            const double* t000 = &table[(lo[2] * strideZ + lo[1] * strideY + lo[0]) * numDist];
+
+            for (int c = 0; c < numDist; ++c)
+            {
+              const double sumk = t111[c] - t110[c] - t101[c] + t100[c] - t011[c] + t010[c] + t001[c] - t000[c];
+              w[c] = std::exp( - sumk / size / m_Variance);
+            }
+            return true;
+          };
+
+          if (blockwise)
+          {
+            // spread the weights of the grid centers over their comparison neighborhoods
+            blockWeight.assign(numBlockVoxels * numDist, 0.0);
+            for (int cz = centerMin[2]; cz <= centerMax[2]; cz += centerSpacing)
+            {
+              for (int cy = centerMin[1]; cy <= centerMax[1]; cy += centerSpacing)
+              {
+                for (int cx = centerMin[0]; cx <= centerMax[0]; cx += centerSpacing)
+                {
+                  const int center[3] = {cx, cy, cz};
+                  if (!computeWeights(center, &weight[0]))
+                    continue;
+
+                  const int firstX = std::max(cx - m_ComparisonRadius, blockMin[0]);
+                  const int lastX = std::min(cx + m_ComparisonRadius, blockMax[0]);
+                  for (int z = std::max(cz - m_ComparisonRadius, blockMin[2]); z <= std::min(cz + m_ComparisonRadius, blockMax[2]); ++z)
+                  {
+                    for (int y = std::max(cy - m_ComparisonRadius, blockMin[1]); y <= std::min(cy + m_ComparisonRadius, blockMax[1]); ++y)
+                    {
+                      double* bw = &blockWeight[(((z - blockMin[2]) * blockSz[1] + y - blockMin[1]) * blockSz[0] + firstX - blockMin[0]) * numDist];
+                      for (int x = firstX; x <= lastX; ++x, bw += numDist)
+                      {
+                        for (int c = 0; c < numDist; ++c)
+                          bw[c] += weight[c];
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+
+          // accumulate the weighted contribution of the shifted voxel for every voxel of the block
+          voxel = 0;
+          for (int z = blockMin[2]; z <= blockMax[2]; ++z)
+          {
+            for (int y = blockMin[1]; y <= blockMax[1]; ++y)
+            {
+              for (int x = blockMin[0]; x <= blockMax[0]; ++x, ++voxel)
+              {
+                if (!inMask[voxel])
+                  continue;
+
+                const int pos[3] = {x, y, z};
+                const double* w = &weight[0];
+                if (blockwise)
+                {
+                  bool valid = true;
+                  for (int d = 0; d < 3 && valid; ++d)
+                    valid = pos[d] + offset[d] >= imageMin[d] && pos[d] + offset[d] <= imageMax[d];
+                  if (!valid)
+                    continue;
+                  w = &blockWeight[voxel * numDist];
+                }
+                else if (!computeWeights(pos, &weight[0]))
+                {
+                  continue;
+                }
+
+                typename InputImageType::IndexType indexJ;
+                indexJ[0] = x + ox; indexJ[1] = y + oy; indexJ[2] = z + oz;
+                const TPixelType* pj = inputBuffer + inputImagePointer->ComputeOffset(indexJ) * numChannels;
+                double* ws = &weightSum[voxel * numDist];
+                double* vs = &valueSum[voxel * numChannels];
+
+                for (int c = 0; c < numDist; ++c)
+                  ws[c] += w[c];
+                for (int c = 0; c < numChannels; ++c)
+                {
+                  const double wc = w[m_UseJointInformation ? 0 : c];
+                  const double p = pj[c];
+                  vs[c] += m_UseRicianAdaption ? wc * p * p : wc * p;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // normalize the accumulated values and write the block
+    voxel = 0;
+    for (int z = blockMin[2]; z < blockMin[2] + blockSz[2]; ++z)
+    {
+      for (int y = blockMin[1]; y < blockMin[1] + blockSz[1]; ++y)
+      {
+        for (int x = blockMin[0]; x < blockMin[0] + blockSz[0]; ++x, ++voxel)
+        {
+          typename OutputImageType::IndexType index;
+          index[0] = x; index[1] = y; index[2] = z;
+          if (!inMask[voxel])
+          {
+            outpix.Fill(0);
+          }
+          else
+          {
+            for (int c = 0; c < numChannels; ++c)
+            {
+              double sumj = valueSum[voxel * numChannels + c] / weightSum[voxel * numDist + (m_UseJointInformation ? 0 : c)];
+              if (m_UseRicianAdaption)
+              {
+                sumj -= 2 * m_Variance;
+              }
+              if (sumj < 0)
+              {
+                sumj = 0;
+              }
+              TPixelType outval;
+              if (m_UseRicianAdaption)
+              {
+                outval = std::floor(std::sqrt(sumj) + 0.5);
+              }
+              else
+              {
+                outval = std::floor(sumj + 0.5);
+              }
+              outpix.SetElement(c, outval);
+            }
+          }
+          outputImage->SetPixel(index, outpix);
+          ++m_CurrentVoxelCount;
+        }
+      }
+    }
+  }
+}
+
 template< class TPixelType >
 void NonLocalMeansDenoisingFilter< TPixelType >::SetInputImage(const InputImageType* image)
 {
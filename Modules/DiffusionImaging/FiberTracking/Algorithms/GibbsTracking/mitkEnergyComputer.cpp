@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkEnergyComputer.h"
 #include <vnl/vnl_copy.h>
 #include <itkNumericTraits.h>
+#include <algorithm>
 
 using namespace mitk;
 
@@ -81,6 +82,7 @@ EnergyComputer::EnergyComputer(ItkFloatImageType* mask, ParticleGrid* particleGr
                     m_NumActiveVoxels++;
                 }
             }
+    m_TotalSpatialProbability = m_CumulatedSpatialProbability[m_NumActiveVoxels];
     for (int k = 0; k < m_NumActiveVoxels; k++)
         m_CumulatedSpatialProbability[k] /= m_CumulatedSpatialProbability[m_NumActiveVoxels];
 
@@ -130,6 +132,73 @@ void EnergyComputer::DrawRandomPosition(vnl_vector_fixed<float, 3>& R)
     R[2] = m_Spacing[2]*((float)(m_ActiveIndices[rh-1]/(m_Size[0]*m_Size[1]))    + m_RandGen->GetVariate());
 }
 
+// cumulate spatial probability of all active voxels overlapping the box, each voxel is weighted by its overlap
+float EnergyComputer::ComputeBoxProbability(const vnl_vector_fixed<float, 3>& lower, const vnl_vector_fixed<float, 3>& upper, std::vector< int >& voxels, std::vector< float >& cumulatedProbability)
+{
+    voxels.clear();
+    cumulatedProbability.clear();
+
+    vnl_vector_fixed<int, 3> start, end;
+    for (int d=0; d<3; d++)
+    {
+        start[d] = std::max(0, (int)floor(lower[d]/m_Spacing[d]));
+        end[d] = std::min(m_Size[d], (int)ceil(upper[d]/m_Spacing[d]));
+    }
+
+    float sum = 0;
+    for (int z = start[2]; z < end[2]; z++)
+    {
+        float wz = (std::min(upper[2], (z+1)*m_Spacing[2]) - std::max(lower[2], z*m_Spacing[2]))/m_Spacing[2];
+        for (int y = start[1]; y < end[1]; y++)
+        {
+            float wy = (std::min(upper[1], (y+1)*m_Spacing[1]) - std::max(lower[1], y*m_Spacing[1]))/m_Spacing[1];
+            for (int x = start[0]; x < end[0]; x++)
+            {
+                ItkFloatImageType::IndexType index;
+                index[0] = x; index[1] = y; index[2] = z;
+                float val = m_Mask->GetPixel(index);
+                if (val <= 0.5)
+                    continue;
+
+                float wx = (std::min(upper[0], (x+1)*m_Spacing[0]) - std::max(lower[0], x*m_Spacing[0]))/m_Spacing[0];
+                float w = val*wx*wy*wz;
+                if (w <= 0)
+                    continue;
+
+                sum += w;
+                voxels.push_back(x+(y+z*m_Size[1])*m_Size[0]);
+                cumulatedProbability.push_back(sum);
+            }
+        }
+    }
+
+    if (m_TotalSpatialProbability <= 0)
+        return 0;
+    return sum/m_TotalSpatialProbability;
+}
+
+// draw random position from the active voxels overlapping the box
+void EnergyComputer::DrawRandomPositionInBox(const vnl_vector_fixed<float, 3>& lower, const vnl_vector_fixed<float, 3>& upper, const std::vector< int >& voxels, const std::vector< float >& cumulatedProbability, ItkRandGenType* randGen, vnl_vector_fixed<float, 3>& R)
+{
+    float r = static_cast<float>(randGen->GetVariate())*cumulatedProbability.back();
+    int j = std::upper_bound(cumulatedProbability.begin(), cumulatedProbability.end(), r) - cumulatedProbability.begin();
+    if (j >= (int)voxels.size())
+        j = voxels.size()-1;
+
+    vnl_vector_fixed<int, 3> voxel;
+    voxel[0] = voxels[j] % m_Size[0];
+    voxel[1] = (voxels[j]/m_Size[0]) % m_Size[1];
+    voxel[2] = voxels[j]/(m_Size[0]*m_Size[1]);
+
+    // uniform inside of the intersection of voxel and box
+    for (int d=0; d<3; d++)
+    {
+        float a = std::max(lower[d], voxel[d]*m_Spacing[d]);
+        float b = std::min(upper[d], (voxel[d]+1)*m_Spacing[d]);
+        R[d] = a + (b-a)*randGen->GetVariate();
+    }
+}
+
 // return spatial probability of position
 float EnergyComputer::SpatProb(vnl_vector_fixed<float, 3> pos)
 {
@@ -42,6 +42,12 @@ public:
     // get random position inside mask
     void DrawRandomPosition(vnl_vector_fixed<float, 3>& R);
 
+    // cumulated spatial probability of the mask voxels overlapping the box [lower, upper), returns the probability mass of the box
+    float ComputeBoxProbability(const vnl_vector_fixed<float, 3>& lower, const vnl_vector_fixed<float, 3>& upper, std::vector< int >& voxels, std::vector< float >& cumulatedProbability);
+
+    // get random position inside mask and box, voxels and cumulatedProbability as computed by ComputeBoxProbability
+    void DrawRandomPositionInBox(const vnl_vector_fixed<float, 3>& lower, const vnl_vector_fixed<float, 3>& upper, const std::vector< int >& voxels, const std::vector< float >& cumulatedProbability, ItkRandGenType* randGen, vnl_vector_fixed<float, 3>& R);
+
     // external energy calculation
     virtual float ComputeExternalEnergy(vnl_vector_fixed<float, 3>& R, vnl_vector_fixed<float, 3>& N, Particle* dp) =0;
 
@@ -63,6 +69,7 @@ protected:
     vnl_vector_fixed<float, 3>      m_Spacing;
     std::vector< float >            m_CumulatedSpatialProbability;
     std::vector< int >              m_ActiveIndices;    // indices inside mask
+    float                           m_TotalSpatialProbability;  // sum of mask values inside mask
 
     bool    m_UseTrilinearInterpolation;    // is deactivated if less than 3 image slices are available
     int     m_NumActiveVoxels;              // voxels inside mask
@@ -31,7 +31,9 @@ float GibbsEnergyComputer::EvaluateOdf(vnl_vector_fixed<float, 3>& pos, vnl_vect
     dir = m_RotationMatrix*dir;
 
     // get interpolation for rotated direction
-    m_SphereInterpolator->getInterpolation(dir);
+    vnl_vector_fixed<int, 3> idx;
+    vnl_vector_fixed<float, 3> interpw;
+    m_SphereInterpolator->getInterpolation(dir, idx, interpw);
 
     // sample ODF values along particle direction
     for (int i=-sampleSteps; i <= sampleSteps;i++)
@@ -46,9 +48,9 @@ float GibbsEnergyComputer::EvaluateOdf(vnl_vector_fixed<float, 3>& pos, vnl_vect
             index[2] = floor(pos[2]/m_Spacing[2]);
             if (m_Image->GetLargestPossibleRegion().IsInside(index))
             {
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2]);
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2]);
             }
         }
         else    // use trilinear interpolation
@@ -72,51 +74,51 @@ float GibbsEnergyComputer::EvaluateOdf(vnl_vector_fixed<float, 3>& pos, vnl_vect
 
                 weight = (1-xfrac)*(1-yfrac)*(1-zfrac);
                 index[0] = xint; index[1] = yint; index[2] = zint;
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2])*weight;
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2])*weight;
 
                 weight = (xfrac)*(1-yfrac)*(1-zfrac);
                 index[0] = xint+1; index[1] = yint; index[2] = zint;
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2])*weight;
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2])*weight;
 
                 weight = (1-xfrac)*(yfrac)*(1-zfrac);
                 index[0] = xint; index[1] = yint+1; index[2] = zint;
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2])*weight;
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2])*weight;
 
                 weight = (1-xfrac)*(1-yfrac)*(zfrac);
                 index[0] = xint; index[1] = yint; index[2] = zint+1;
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2])*weight;
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2])*weight;
 
                 weight = (xfrac)*(yfrac)*(1-zfrac);
                 index[0] = xint+1; index[1] = yint+1; index[2] = zint;
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2])*weight;
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2])*weight;
 
                 weight = (1-xfrac)*(yfrac)*(zfrac);
                 index[0] = xint; index[1] = yint+1; index[2] = zint+1;
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2])*weight;
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2])*weight;
 
                 weight = (xfrac)*(1-yfrac)*(zfrac);
                 index[0] = xint+1; index[1] = yint; index[2] = zint+1;
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2])*weight;
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2])*weight;
 
                 weight = (xfrac)*(yfrac)*(zfrac);
                 index[0] = xint+1; index[1] = yint+1; index[2] = zint+1;
-                result += (m_Image->GetPixel(index)[m_SphereInterpolator->idx[0]-1]*m_SphereInterpolator->interpw[0] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[1]-1]*m_SphereInterpolator->interpw[1] +
-                       m_Image->GetPixel(index)[m_SphereInterpolator->idx[2]-1]* m_SphereInterpolator->interpw[2])*weight;
+                result += (m_Image->GetPixel(index)[idx[0]-1]*interpw[0] +
+                       m_Image->GetPixel(index)[idx[1]-1]*interpw[1] +
+                       m_Image->GetPixel(index)[idx[2]-1]* interpw[2])*weight;
             }
         }
     }
@@ -132,8 +134,9 @@ float GibbsEnergyComputer::ComputeExternalEnergy(vnl_vector_fixed<float, 3> &R,
     float odfVal = EvaluateOdf(R, N);   // evaluate ODF in given direction
 
     float modelVal = 0;
-    m_ParticleGrid->ComputeNeighbors(R);    // retrieve neighbouring particles from particle grid
-    Particle* neighbour =  m_ParticleGrid->GetNextNeighbor();
+    ParticleGrid::NeighborTracker tracker;
+    m_ParticleGrid->ComputeNeighbors(R, tracker);    // retrieve neighbouring particles from particle grid
+    Particle* neighbour =  m_ParticleGrid->GetNextNeighbor(tracker);
     while (neighbour!=nullptr)                         // iterate over nieghbouring particles
     {
         if (dp != neighbour)                        // don't evaluate against itself
@@ -147,7 +150,7 @@ float GibbsEnergyComputer::ComputeExternalEnergy(vnl_vector_fixed<float, 3> &R,
 
             modelVal += pos_w*I_0;
         }
-        neighbour =  m_ParticleGrid->GetNextNeighbor();
+        neighbour =  m_ParticleGrid->GetNextNeighbor(tracker);
     }
     modelVal += CalcI0(1.0)+m_ParticleChemicalPotential;
 
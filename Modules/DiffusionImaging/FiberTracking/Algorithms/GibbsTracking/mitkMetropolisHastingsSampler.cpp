@@ -29,6 +29,11 @@ MetropolisHastingsSampler::MetropolisHastingsSampler(ParticleGrid* grid, EnergyC
     , m_DelProb(0.1)
     , m_ChempotParticle(0.0)
     , m_AcceptedProposals(0)
+    , m_BlockMode(false)
+    , m_BlockProbability(0)
+    , m_DrawnBlockParticle(-1)
+    , m_NextReservedID(0)
+    , m_EndReservedID(0)
 {
     m_RandGen = randGen;
     m_ParticleGrid = grid;
@@ -80,6 +85,86 @@ void MetropolisHastingsSampler::PrintProposalTimes()
     std::cout << "Connection: " << 100*m_ConnectionTime.GetTotal()/sum << "/" << m_ConnectionTime.GetMean()*1000 << std::endl;
 }
 
+// restrict proposals to the given block of grid cells
+void MetropolisHastingsSampler::SetBlock(const vnl_vector_fixed<int, 3>& start, const vnl_vector_fixed<int, 3>& end, int firstReservedID, int numReservedIDs)
+{
+    m_BlockMode = true;
+    m_BlockStart = start;
+    m_BlockEnd = end;
+
+    float cellSize = m_ParticleGrid->GetCellSize();
+    for (int d=0; d<3; d++)
+    {
+        m_BlockLower[d] = m_BlockStart[d]*cellSize;
+        m_BlockUpper[d] = m_BlockEnd[d]*cellSize;
+    }
+
+    vnl_vector_fixed<int, 3> gridSize = m_ParticleGrid->GetGridSize();
+    m_BlockParticles.clear();
+    for (int z=m_BlockStart[2]; z<m_BlockEnd[2]; z++)
+        for (int y=m_BlockStart[1]; y<m_BlockEnd[1]; y++)
+            for (int x=m_BlockStart[0]; x<m_BlockEnd[0]; x++)
+            {
+                const std::vector< Particle* >& cell = m_ParticleGrid->GetCell(x + gridSize[0]*(y + gridSize[1]*z));
+                for (unsigned int i=0; i<cell.size(); i++)
+                    m_BlockParticles.push_back(cell[i]->ID);
+            }
+
+    m_BlockProbability = m_EnergyComputer->ComputeBoxProbability(m_BlockLower, m_BlockUpper, m_BlockVoxels, m_BlockCumulatedProbability);
+    m_NextReservedID = firstReservedID;
+    m_EndReservedID = firstReservedID + numReservedIDs;
+}
+
+void MetropolisHastingsSampler::ClearBlock()
+{
+    m_BlockMode = false;
+    m_BlockParticles.clear();
+    m_BlockVoxels.clear();
+    m_BlockCumulatedProbability.clear();
+    m_BlockProbability = 0;
+    m_NextReservedID = m_EndReservedID = 0;
+}
+
+bool MetropolisHastingsSampler::IsBlockEmpty()
+{
+    return m_BlockParticles.empty() && m_BlockVoxels.empty();
+}
+
+bool MetropolisHastingsSampler::IsInBlock(int cellIdx)
+{
+    if (!m_BlockMode)
+        return true;
+    if (cellIdx < 0)
+        return false;
+
+    vnl_vector_fixed<int, 3> gridSize = m_ParticleGrid->GetGridSize();
+    int x = cellIdx % gridSize[0];
+    int y = (cellIdx / gridSize[0]) % gridSize[1];
+    int z = cellIdx / (gridSize[0]*gridSize[1]);
+    return x >= m_BlockStart[0] && x < m_BlockEnd[0] && y >= m_BlockStart[1] && y < m_BlockEnd[1] && z >= m_BlockStart[2] && z < m_BlockEnd[2];
+}
+
+bool MetropolisHastingsSampler::IsInBlock(Particle* p)
+{
+    return IsInBlock(p->gridindex);
+}
+
+// draw random particle, restricted to the particles of the current block in block mode
+int MetropolisHastingsSampler::DrawParticle()
+{
+    if (m_BlockMode)
+    {
+        if (m_BlockParticles.empty())
+            return -1;
+        m_DrawnBlockParticle = m_RandGen->GetIntegerVariate()%m_BlockParticles.size();
+        return m_BlockParticles[m_DrawnBlockParticle];
+    }
+
+    if (m_ParticleGrid->m_NumParticles <= 0)
+        return -1;
+    return m_RandGen->GetIntegerVariate()%m_ParticleGrid->m_NumParticles;
+}
+
 // update temperature of simulated annealing process
 void MetropolisHastingsSampler::SetTemperature(float val)
 {
@@ -115,27 +200,50 @@ void MetropolisHastingsSampler::MakeProposal()
     if (randnum < m_BirthProb)
     {
         m_BirthTime.Start();
-        vnl_vector_fixed<float, 3> R;
-        m_EnergyComputer->DrawRandomPosition(R);
-        vnl_vector_fixed<float, 3> N = GetRandomDirection();
-        Particle prop;
-        prop.GetPos() = R;
-        prop.GetDir() = N;
-
-        float prob =  m_Density * m_DeathProb /((m_BirthProb)*(m_ParticleGrid->m_NumParticles+1));
+        if (!m_BlockMode || (!m_BlockVoxels.empty() && m_NextReservedID < m_EndReservedID))
+        {
+            vnl_vector_fixed<float, 3> R;
+            float prob;
+            if (m_BlockMode)
+            {
+                // the birth is restricted to the block, the position is drawn from the spatial distribution inside of the block
+                m_EnergyComputer->DrawRandomPositionInBox(m_BlockLower, m_BlockUpper, m_BlockVoxels, m_BlockCumulatedProbability, m_RandGen, R);
+                prob =  m_Density * m_DeathProb * m_BlockProbability /((m_BirthProb)*(m_BlockParticles.size()+1));
+            }
+            else
+            {
+                m_EnergyComputer->DrawRandomPosition(R);
+                prob =  m_Density * m_DeathProb /((m_BirthProb)*(m_ParticleGrid->m_NumParticles+1));
+            }
+            vnl_vector_fixed<float, 3> N = GetRandomDirection();
+            Particle prop;
+            prop.GetPos() = R;
+            prop.GetDir() = N;
 
-        float ex_energy = m_EnergyComputer->ComputeExternalEnergy(R,N,nullptr);
-        float in_energy = m_EnergyComputer->ComputeInternalEnergy(&prop);
-        prob *= exp((in_energy/m_InTemp+ex_energy/m_ExTemp)) ;
+            float ex_energy = m_EnergyComputer->ComputeExternalEnergy(R,N,nullptr);
+            float in_energy = m_EnergyComputer->ComputeInternalEnergy(&prop);
+            prob *= exp((in_energy/m_InTemp+ex_energy/m_ExTemp)) ;
 
-        if (prob > 1 || m_RandGen->GetVariate() < prob)
-        {
-            Particle *p = m_ParticleGrid->NewParticle(R);
-            if (p!=nullptr)
+            if (prob > 1 || m_RandGen->GetVariate() < prob)
             {
-                p->GetPos() = R;
-                p->GetDir() = N;
-                m_AcceptedProposals++;
+                Particle *p = nullptr;
+                if (!m_BlockMode)
+                    p = m_ParticleGrid->NewParticle(R);
+                else if (IsInBlock(m_ParticleGrid->GetCellIndex(R)))
+                {
+                    p = m_ParticleGrid->ActivateParticle(m_NextReservedID, R);
+                    if (p!=nullptr)
+                    {
+                        m_NextReservedID++;
+                        m_BlockParticles.push_back(p->ID);
+                    }
+                }
+                if (p!=nullptr)
+                {
+                    p->GetPos() = R;
+                    p->GetDir() = N;
+                    m_AcceptedProposals++;
+                }
             }
         }
         m_BirthTime.Stop();
@@ -144,20 +252,36 @@ void MetropolisHastingsSampler::MakeProposal()
     else if (randnum < m_BirthProb+m_DeathProb)
     {
         m_DeathTime.Start();
-        if (m_ParticleGrid->m_NumParticles > 0)
+        int pnum = DrawParticle();
+        if (pnum >= 0)
         {
-            int pnum = m_RandGen->GetIntegerVariate()%m_ParticleGrid->m_NumParticles;
             Particle *dp = m_ParticleGrid->GetParticle(pnum);
             if (dp->pID == -1 && dp->mID == -1)
             {
-                float ex_energy = m_EnergyComputer->ComputeExternalEnergy(dp->GetPos(),dp->GetDir(),dp);
-                float in_energy = m_EnergyComputer->ComputeInternalEnergy(dp);
-
-                float prob = m_ParticleGrid->m_NumParticles * (m_BirthProb) /(m_Density*m_DeathProb); //*SpatProb(dp->R);
-                prob *= exp(-(in_energy/m_InTemp+ex_energy/m_ExTemp)) ;
-                if (prob > 1 || m_RandGen->GetVariate() < prob)
+                // A block without any birth probability can never re-add the particle,
+                // the acceptance ratio is unbounded and the death is always accepted.
+                bool accept = m_BlockMode && m_BlockProbability <= 0;
+                if (!accept)
                 {
-                    m_ParticleGrid->RemoveParticle(pnum);
+                    float ex_energy = m_EnergyComputer->ComputeExternalEnergy(dp->GetPos(),dp->GetDir(),dp);
+                    float in_energy = m_EnergyComputer->ComputeInternalEnergy(dp);
+
+                    float prob = m_ParticleGrid->m_NumParticles * (m_BirthProb) /(m_Density*m_DeathProb); //*SpatProb(dp->R);
+                    if (m_BlockMode)
+                        prob = m_BlockParticles.size() * (m_BirthProb) /(m_Density*m_DeathProb*m_BlockProbability);
+                    prob *= exp(-(in_energy/m_InTemp+ex_energy/m_ExTemp)) ;
+                    accept = prob > 1 || m_RandGen->GetVariate() < prob;
+                }
+                if (accept)
+                {
+                    if (m_BlockMode)
+                    {
+                        m_ParticleGrid->DeactivateParticle(pnum);
+                        m_BlockParticles[m_DrawnBlockParticle] = m_BlockParticles.back();
+                        m_BlockParticles.pop_back();
+                    }
+                    else
+                        m_ParticleGrid->RemoveParticle(pnum);
                     m_AcceptedProposals++;
                 }
             }
@@ -167,10 +291,10 @@ void MetropolisHastingsSampler::MakeProposal()
     // Shift Proposal
     else  if (randnum < m_BirthProb+m_DeathProb+m_ShiftProb)
     {
-        if (m_ParticleGrid->m_NumParticles > 0)
+        int pnum = DrawParticle();
+        if (pnum >= 0)
         {
             m_ShiftTime.Start();
-            int pnum = m_RandGen->GetIntegerVariate()%m_ParticleGrid->m_NumParticles;
             Particle *p =  m_ParticleGrid->GetParticle(pnum);
             Particle prop_p = *p;
 
@@ -178,24 +302,27 @@ void MetropolisHastingsSampler::MakeProposal()
             DistortVector(m_Sigma/(2*m_ParticleLength), prop_p.GetDir());
             prop_p.GetDir().normalize();
 
+            if (IsInBlock(m_ParticleGrid->GetCellIndex(prop_p.GetPos())))
+            {
 
-            float ex_energy = m_EnergyComputer->ComputeExternalEnergy(prop_p.GetPos(),prop_p.GetDir(),p)
-                    - m_EnergyComputer->ComputeExternalEnergy(p->GetPos(),p->GetDir(),p);
-            float in_energy = m_EnergyComputer->ComputeInternalEnergy(&prop_p) - m_EnergyComputer->ComputeInternalEnergy(p);
+                float ex_energy = m_EnergyComputer->ComputeExternalEnergy(prop_p.GetPos(),prop_p.GetDir(),p)
+                        - m_EnergyComputer->ComputeExternalEnergy(p->GetPos(),p->GetDir(),p);
+                float in_energy = m_EnergyComputer->ComputeInternalEnergy(&prop_p) - m_EnergyComputer->ComputeInternalEnergy(p);
 
-            float prob = exp(ex_energy/m_ExTemp+in_energy/m_InTemp);
-            if (m_RandGen->GetVariate() < prob)
-            {
-                vnl_vector_fixed<float, 3> Rtmp = p->GetPos();
-                vnl_vector_fixed<float, 3> Ntmp = p->GetDir();
-                p->GetPos() = prop_p.GetPos();
-                p->GetDir() = prop_p.GetDir();
-                if (!m_ParticleGrid->TryUpdateGrid(pnum))
+                float prob = exp(ex_energy/m_ExTemp+in_energy/m_InTemp);
+                if (m_RandGen->GetVariate() < prob)
                 {
-                    p->GetPos() = Rtmp;
-                    p->GetDir() = Ntmp;
+                    vnl_vector_fixed<float, 3> Rtmp = p->GetPos();
+                    vnl_vector_fixed<float, 3> Ntmp = p->GetDir();
+                    p->GetPos() = prop_p.GetPos();
+                    p->GetDir() = prop_p.GetDir();
+                    if (!m_ParticleGrid->TryUpdateGrid(pnum))
+                    {
+                        p->GetPos() = Rtmp;
+                        p->GetDir() = Ntmp;
+                    }
+                    m_AcceptedProposals++;
                 }
-                m_AcceptedProposals++;
             }
             m_ShiftTime.Stop();
         }
@@ -203,10 +330,10 @@ void MetropolisHastingsSampler::MakeProposal()
     // Optimal Shift Proposal
     else  if (randnum < m_BirthProb+m_DeathProb+m_ShiftProb+m_OptShiftProb)
     {
-        if (m_ParticleGrid->m_NumParticles > 0)
+        int pnum = DrawParticle();
+        if (pnum >= 0)
         {
             m_OptShiftTime.Start();
-            int pnum = m_RandGen->GetIntegerVariate()%m_ParticleGrid->m_NumParticles;
             Particle *p =  m_ParticleGrid->GetParticle(pnum);
 
             bool no_proposal = false;
@@ -239,6 +366,9 @@ void MetropolisHastingsSampler::MakeProposal()
             else
                 no_proposal = true;
 
+            if (!no_proposal && !IsInBlock(m_ParticleGrid->GetCellIndex(prop_p.GetPos())))
+                no_proposal = true;
+
             if (!no_proposal)
             {
                 float cos = dot_product(prop_p.GetDir(), p->GetDir());
@@ -270,18 +400,18 @@ void MetropolisHastingsSampler::MakeProposal()
     // Connection Proposal
     else
     {
-        if (m_ParticleGrid->m_NumParticles > 0)
+        int pnum = DrawParticle();
+        if (pnum >= 0)
         {
             m_ConnectionTime.Start();
-            int pnum = m_RandGen->GetIntegerVariate()%m_ParticleGrid->m_NumParticles;
             Particle *p = m_ParticleGrid->GetParticle(pnum);
 
             EndPoint P;
             P.p = p;
             P.ep = (m_RandGen->GetVariate() > 0.5)? 1 : -1; // direction of the new tract
 
-            RemoveAndSaveTrack(P);  // remove old tract and save it for later
-            if (m_BackupTrack.m_Probability != 0)
+            bool saved = RemoveAndSaveTrack(P);  // remove old tract and save it for later
+            if (saved && m_BackupTrack.m_Probability != 0)
             {
                 MakeTrackProposal(P);   // propose new tract starting from P
 
@@ -314,17 +444,26 @@ void MetropolisHastingsSampler::ImplementTrack(Track &T)
 }
 
 // remove pending track from random particle, save it in m_BackupTrack and calculate its probability
-void MetropolisHastingsSampler::RemoveAndSaveTrack(EndPoint P)
+bool MetropolisHastingsSampler::RemoveAndSaveTrack(EndPoint P)
 {
     EndPoint Current = P;
     int cnt = 0;
     float energy = 0;
     float AccumProb = 1.0;
+    bool insideBlock = true;
     m_BackupTrack.track[cnt] = Current;
     EndPoint Next;
 
     for (;;)
     {
+        // the track leaves the block, it can not be proposed again from inside of the block
+        int nextID = (Current.ep == 1) ? Current.p->pID : Current.p->mID;
+        if (nextID != -1 && !IsInBlock(m_ParticleGrid->GetParticle(nextID)))
+        {
+            insideBlock = false;
+            break;
+        }
+
         Next.p = nullptr;
         if (Current.ep == 1)
         {
@@ -332,6 +471,7 @@ void MetropolisHastingsSampler::RemoveAndSaveTrack(EndPoint P)
             {
                 Next.p = m_ParticleGrid->GetParticle(Current.p->pID);
                 Current.p->pID = -1;
+#pragma omp atomic
                 m_ParticleGrid->m_NumConnections--;
             }
         }
@@ -341,6 +481,7 @@ void MetropolisHastingsSampler::RemoveAndSaveTrack(EndPoint P)
             {
                 Next.p = m_ParticleGrid->GetParticle(Current.p->mID);
                 Current.p->mID = -1;
+#pragma omp atomic
                 m_ParticleGrid->m_NumConnections--;
             }
         }
@@ -387,6 +528,7 @@ void MetropolisHastingsSampler::RemoveAndSaveTrack(EndPoint P)
     m_BackupTrack.m_Energy = energy;
     m_BackupTrack.m_Probability = AccumProb;
     m_BackupTrack.m_Length = cnt+1;
+    return insideBlock;
 }
 
 // generate new track using kind of a local tracking starting from P in the given direction, store it in m_ProposalTrack and calculate its probability
@@ -449,16 +591,16 @@ void MetropolisHastingsSampler::ComputeEndPointProposalDistribution(EndPoint P)
 
     float dist,dot;
     vnl_vector_fixed<float, 3> R = p->GetPos() + (p->GetDir() * (ep*m_ParticleLength) );
-    m_ParticleGrid->ComputeNeighbors(R);
+    m_ParticleGrid->ComputeNeighbors(R, m_NeighborTracker);
     m_SimpSamp.clear();
 
     m_SimpSamp.add(m_StopProb,EndPoint(nullptr,0));
 
     for (;;)
     {
-        Particle *p2 =  m_ParticleGrid->GetNextNeighbor();
+        Particle *p2 =  m_ParticleGrid->GetNextNeighbor(m_NeighborTracker);
         if (p2 == nullptr) break;
-        if (p!=p2 && p2->label == 0)
+        if (p!=p2 && p2->label == 0 && IsInBlock(p2))
         {
             if (p2->mID == -1)
             {
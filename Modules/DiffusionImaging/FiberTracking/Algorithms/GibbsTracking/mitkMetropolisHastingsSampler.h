@@ -52,11 +52,21 @@ public:
     void SetProbabilities(float birth, float death, float shift, float optShift, float connect);    ///< update the probabilities of the single proposals
     void PrintProposalTimes();  ///< print the state of the proposal time probes
 
+    /** restrict all proposals to the grid cells [start, end), used by the parallel sampler. Births use the reserved particle IDs [firstReservedID, firstReservedID+numReservedIDs). */
+    void SetBlock(const vnl_vector_fixed<int, 3>& start, const vnl_vector_fixed<int, 3>& end, int firstReservedID, int numReservedIDs);
+    void ClearBlock();          ///< make proposals on the whole grid again
+    bool IsBlockEmpty();        ///< true if the current block contains neither particles nor mask voxels
+
 protected:
 
+    /** block restriction related methods */
+    int DrawParticle();                     ///< ID of random particle (inside of block), -1 if there is none
+    bool IsInBlock(int cellIdx);
+    bool IsInBlock(Particle* p);
+
     /** connection proposal related methods */
     void ImplementTrack(Track& T);
-    void RemoveAndSaveTrack(EndPoint P);
+    bool RemoveAndSaveTrack(EndPoint P);    ///< returns false if the track leaves the current block, nothing is saved in this case
     void MakeTrackProposal(EndPoint P);
     void ComputeEndPointProposalDistribution(EndPoint P);
 
@@ -95,6 +105,22 @@ protected:
     EnergyComputer* m_EnergyComputer;       ///< computes internal and external energy of particles
     unsigned int    m_AcceptedProposals;    ///< counts accepted proposals
 
+    ParticleGrid::NeighborTracker   m_NeighborTracker;
+
+    /** domain decomposition */
+    bool                        m_BlockMode;
+    vnl_vector_fixed<int, 3>    m_BlockStart;           ///< first grid cell of block
+    vnl_vector_fixed<int, 3>    m_BlockEnd;             ///< grid cell behind last cell of block
+    vnl_vector_fixed<float, 3>  m_BlockLower;           ///< block in world coordinates
+    vnl_vector_fixed<float, 3>  m_BlockUpper;
+    float                       m_BlockProbability;     ///< probability of a birth inside of the block
+    std::vector< int >          m_BlockParticles;       ///< IDs of the particles inside of the block
+    int                         m_DrawnBlockParticle;   ///< position of the last drawn particle in m_BlockParticles
+    std::vector< int >          m_BlockVoxels;
+    std::vector< float >        m_BlockCumulatedProbability;
+    int                         m_NextReservedID;
+    int                         m_EndReservedID;
+
     /** Time probes for the single proposals */
     itk::TimeProbe  m_BirthTime;
     itk::TimeProbe  m_DeathTime;
@@ -0,0 +1,137 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkParallelMetropolisHastingsSampler.h"
+#include <algorithm>
+
+using namespace mitk;
+
+ParallelMetropolisHastingsSampler::ParallelMetropolisHastingsSampler(ParticleGrid* grid, EnergyComputer* enComp, ItkRandGenType* randGen, float curvThres, int numThreads, int blockSize, int proposalsPerBlock)
+    : m_ParticleGrid(grid)
+    , m_RandGen(randGen)
+    , m_BlockSize(blockSize)
+    , m_ProposalsPerBlock(proposalsPerBlock)
+{
+    // connected particles can be more than one cell apart, two cells keep concurrently sampled blocks independent
+    if (m_BlockSize < 2)
+        m_BlockSize = 2;
+    if (m_ProposalsPerBlock < 1)
+        m_ProposalsPerBlock = 1;
+    if (numThreads < 1)
+        numThreads = 1;
+
+    for (int i=0; i<numThreads; i++)
+    {
+        ItkRandGenType::Pointer gen = ItkRandGenType::New();
+        m_RandGens.push_back(gen);
+        m_Samplers.push_back(new MetropolisHastingsSampler(grid, enComp, gen, curvThres));
+    }
+}
+
+ParallelMetropolisHastingsSampler::~ParallelMetropolisHastingsSampler()
+{
+    for (unsigned int i=0; i<m_Samplers.size(); i++)
+        delete m_Samplers[i];
+}
+
+void ParallelMetropolisHastingsSampler::SetTemperature(float val)
+{
+    for (unsigned int i=0; i<m_Samplers.size(); i++)
+        m_Samplers[i]->SetTemperature(val);
+}
+
+int ParallelMetropolisHastingsSampler::GetNumAcceptedProposals()
+{
+    int accepted = 0;
+    for (unsigned int i=0; i<m_Samplers.size(); i++)
+        accepted += m_Samplers[i]->GetNumAcceptedProposals();
+    return accepted;
+}
+
+unsigned long ParallelMetropolisHastingsSampler::MakeSweep()
+{
+    vnl_vector_fixed<int, 3> gridSize = m_ParticleGrid->GetGridSize();
+
+    // random shift of the block borders so that no cell border is a permanent block border
+    vnl_vector_fixed<int, 3> offset, numBlocks;
+    for (int d=0; d<3; d++)
+    {
+        offset[d] = m_RandGen->GetIntegerVariate()%m_BlockSize;
+        numBlocks[d] = (gridSize[d] + offset[d] + m_BlockSize - 1)/m_BlockSize;
+    }
+    int totalBlocks = numBlocks[0]*numBlocks[1]*numBlocks[2];
+
+    // seeds are drawn in block order, independent of the thread scheduling
+    std::vector< ItkRandGenType::IntegerType > seeds(totalBlocks);
+    for (int b=0; b<totalBlocks; b++)
+        seeds[b] = m_RandGen->GetIntegerVariate();
+
+    int firstReservedID = m_ParticleGrid->BeginParallelPhase(totalBlocks*m_ProposalsPerBlock);
+    if (firstReservedID < 0)
+        return 0;
+
+    unsigned long numProposals = 0;
+    int numThreads = m_Samplers.size();
+    for (int color=0; color<8; color++)
+    {
+        std::vector< int > blocks;
+        for (int z=(color>>2)&1; z<numBlocks[2]; z+=2)
+            for (int y=(color>>1)&1; y<numBlocks[1]; y+=2)
+                for (int x=color&1; x<numBlocks[0]; x+=2)
+                    blocks.push_back(x + numBlocks[0]*(y + numBlocks[1]*z));
+
+        int nextBlock = 0;
+#pragma omp parallel for num_threads(numThreads) reduction(+:numProposals)
+        for (int t=0; t<numThreads; t++)
+        {
+            MetropolisHastingsSampler* sampler = m_Samplers[t];
+            for (;;)
+            {
+                int i;
+#pragma omp critical (ParallelSamplerNextBlock)
+                i = nextBlock++;
+                if (i >= (int)blocks.size())
+                    break;
+
+                int b = blocks[i];
+                vnl_vector_fixed<int, 3> block, start, end;
+                block[0] = b % numBlocks[0];
+                block[1] = (b / numBlocks[0]) % numBlocks[1];
+                block[2] = b / (numBlocks[0]*numBlocks[1]);
+                for (int d=0; d<3; d++)
+                {
+                    start[d] = std::max(0, block[d]*m_BlockSize - offset[d]);
+                    end[d] = std::min(gridSize[d], (block[d]+1)*m_BlockSize - offset[d]);
+                }
+
+                m_RandGens[t]->SetSeed(seeds[b]);
+                sampler->SetBlock(start, end, firstReservedID + b*m_ProposalsPerBlock, m_ProposalsPerBlock);
+                if (sampler->IsBlockEmpty())
+                    continue;
+
+                for (int k=0; k<m_ProposalsPerBlock; k++)
+                    sampler->MakeProposal();
+                numProposals += m_ProposalsPerBlock;
+            }
+        }
+    }
+
+    for (int t=0; t<numThreads; t++)
+        m_Samplers[t]->ClearBlock();
+    m_ParticleGrid->EndParallelPhase();
+
+    return numProposals;
+}
@@ -0,0 +1,61 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _PARALLELSAMPLER
+#define _PARALLELSAMPLER
+
+// MITK
+#include <MitkFiberTrackingExports.h>
+#include <mitkMetropolisHastingsSampler.h>
+
+namespace mitk
+{
+
+/**
+* \brief Generates proposals in parallel on a checkerboard decomposition of the particle grid.
+*
+* The grid is divided into blocks of BlockSize^3 cells that are colored by the parity of their block coordinates.
+* Blocks of the same color are at least BlockSize cells apart and do not interact, so they are sampled concurrently,
+* each with a restricted MetropolisHastingsSampler. The block borders are shifted randomly in every sweep.
+* Every block uses its own random generator seeded from the master generator, so the result only depends on the seed
+* and not on the number of threads.   */
+
+class MITKFIBERTRACKING_EXPORT ParallelMetropolisHastingsSampler
+{
+public:
+
+    typedef MetropolisHastingsSampler::ItkRandGenType ItkRandGenType;
+
+    ParallelMetropolisHastingsSampler(ParticleGrid* grid, EnergyComputer* enComp, ItkRandGenType* randGen, float curvThres, int numThreads, int blockSize, int proposalsPerBlock);
+    ~ParallelMetropolisHastingsSampler();
+
+    void SetTemperature(float val);
+    unsigned long MakeSweep();      ///< make ProposalsPerBlock proposals in every block, returns the number of proposals
+    int GetNumAcceptedProposals();
+
+protected:
+
+    ParticleGrid*                               m_ParticleGrid;
+    ItkRandGenType*                             m_RandGen;          ///< master random generator
+    std::vector< MetropolisHastingsSampler* >   m_Samplers;         ///< one sampler per thread
+    std::vector< ItkRandGenType::Pointer >      m_RandGens;         ///< random generators of the samplers
+    int                                         m_BlockSize;        ///< edge length of the blocks in grid cells
+    int                                         m_ProposalsPerBlock;
+};
+
+}
+
+#endif
@@ -36,13 +36,16 @@ public:
         label = 0;
         pID = -1;
         mID = -1;
+        gridindex = -1;
+        cellpos = -1;
     }
 
     ~Particle()
     {
     }
 
-    int gridindex;          // index in the grid where it is living
+    int gridindex;          // index of the grid cell where it is living (-1 if it is not part of the grid)
+    int cellpos;            // position inside of the grid cell
     int ID;                 // particle ID
     int pID;                // successor ID
     int mID;                // predecessor ID
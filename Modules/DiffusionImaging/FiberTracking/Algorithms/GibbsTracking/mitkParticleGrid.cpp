@@ -21,12 +21,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 using namespace mitk;
 
-ParticleGrid::ParticleGrid(ItkFloatImageType* image, float particleLength, int cellCapacity)
+ParticleGrid::ParticleGrid(ItkFloatImageType* image, float particleLength)
 {
     // initialize counters
     m_NumParticles = 0;
     m_NumConnections = 0;
-    m_NumCellOverflows = 0;
+    m_NumReservedParticles = 0;
     m_ParticleLength = particleLength;
 
     // define isotropic grid from voxel spacing and particle length
@@ -38,23 +38,18 @@ ParticleGrid::ParticleGrid(ItkFloatImageType* image, float particleLength, int c
     m_GridScale[1] = 1/cellSize;
     m_GridScale[2] = 1/cellSize;
 
-    m_CellCapacity = cellCapacity;          // maximum number of particles per grid cell
     m_ContainerCapacity = 100000;           // initial particle container capacity
     unsigned long  numCells = m_GridSize[0]*m_GridSize[1]*m_GridSize[2];   // number of grid cells
-    unsigned long  gridSize = numCells*m_CellCapacity;
-    if ( (unsigned long)itk::NumericTraits<int>::max()<gridSize )
+    if ( (unsigned long)itk::NumericTraits<int>::max()<numCells )
         throw std::bad_alloc();
 
     m_Particles.resize(m_ContainerCapacity);        // allocate and initialize particles
-    m_Grid.resize(gridSize, nullptr);   // allocate and initialize particle grid
-    m_OccupationCount.resize(numCells, 0);          // allocate and initialize occupation counter array
-    m_NeighbourTracker.cellidx.resize(8, 0);        // allocate and initialize neighbour tracker
-    m_NeighbourTracker.cellidx_c.resize(8, 0);
+    m_Grid.resize(numCells);                        // allocate empty grid cells
 
     for (int i = 0;i < m_ContainerCapacity;i++)     // initialize particle IDs
         m_Particles[i].ID = i;
 
-    std::cout << "ParticleGrid: allocated " << (sizeof(Particle)*m_ContainerCapacity + sizeof(Particle*)*m_GridSize[0]*m_GridSize[1]*m_GridSize[2])/1048576 << "mb for " << m_ContainerCapacity/1000 << "k particles." << std::endl;
+    std::cout << "ParticleGrid: allocated " << (sizeof(Particle)*m_ContainerCapacity + sizeof(std::vector< Particle* >)*numCells)/1048576 << "mb for " << m_ContainerCapacity/1000 << "k particles." << std::endl;
 }
 
 ParticleGrid::~ParticleGrid()
@@ -68,44 +63,40 @@ void ParticleGrid::ResetGrid()
     // initialize counters
     m_NumParticles = 0;
     m_NumConnections = 0;
-    m_NumCellOverflows = 0;
+    m_NumReservedParticles = 0;
     m_Particles.clear();
     m_Grid.clear();
-    m_OccupationCount.clear();
-    m_NeighbourTracker.cellidx.clear();
-    m_NeighbourTracker.cellidx_c.clear();
 
     int numCells = m_GridSize[0]*m_GridSize[1]*m_GridSize[2];   // number of grid cells
 
     m_Particles.resize(m_ContainerCapacity);        // allocate and initialize particles
-    m_Grid.resize(numCells*m_CellCapacity, nullptr);   // allocate and initialize particle grid
-    m_OccupationCount.resize(numCells, 0);          // allocate and initialize occupation counter array
-    m_NeighbourTracker.cellidx.resize(8, 0);        // allocate and initialize neighbour tracker
-    m_NeighbourTracker.cellidx_c.resize(8, 0);
+    m_Grid.resize(numCells);                        // allocate empty grid cells
 
     for (int i = 0;i < m_ContainerCapacity;i++)     // initialize particle IDs
         m_Particles[i].ID = i;
 }
 
-bool ParticleGrid::ReallocateGrid()
+bool ParticleGrid::ReallocateGrid(int capacity)
 {
-    int new_capacity = m_ContainerCapacity + 100000;    // increase container capacity by 100k particles
+    int new_capacity = m_ContainerCapacity;
+    while (new_capacity < capacity)
+        new_capacity += 100000;     // increase container capacity in steps of 100k particles
     try
     {
         m_Particles.resize(new_capacity);                   // reallocate particles
 
         for (int i = 0; i<m_ContainerCapacity; i++)         // update particle addresses (changed during reallocation)
-            m_Grid[m_Particles[i].gridindex] = &m_Particles[i];
+            if (m_Particles[i].gridindex != -1)
+                m_Grid[m_Particles[i].gridindex][m_Particles[i].cellpos] = &m_Particles[i];
 
         for (int i = m_ContainerCapacity; i < new_capacity; i++)    // initialize IDs of ne particles
             m_Particles[i].ID = i;
 
         m_ContainerCapacity = new_capacity;     // update member variable
-        //std::cout << "ParticleGrid: allocated " << (sizeof(Particle)*m_ContainerCapacity + sizeof(Particle*)*m_GridSize[0]*m_GridSize[1]*m_GridSize[2])/1048576 << "mb for " << m_ContainerCapacity/1000 << "k particles." << std::endl;
     }
     catch(...)
     {
-        std::cout << "ParticleGrid: allocation of " << (sizeof(Particle)*new_capacity + sizeof(Particle*)*m_GridSize[0]*m_GridSize[1]*m_GridSize[2])/1048576 << "mb for " << new_capacity/1000 << "k particles failed!" << std::endl;
+        std::cout << "ParticleGrid: allocation of " << (sizeof(Particle)*new_capacity)/1048576 << "mb for " << new_capacity/1000 << "k particles failed!" << std::endl;
         return false;
     }
     return true;
@@ -118,95 +109,74 @@ Particle* ParticleGrid::GetParticle(int ID)
     return nullptr;
 }
 
+int ParticleGrid::GetCellIndex(const vnl_vector_fixed<float, 3>& R) const
+{
+    int xint = int(R[0]*m_GridScale[0]);
+    if (xint < 0 || xint >= m_GridSize[0])
+        return -1;
+    int yint = int(R[1]*m_GridScale[1]);
+    if (yint < 0 || yint >= m_GridSize[1])
+        return -1;
+    int zint = int(R[2]*m_GridScale[2]);
+    if (zint < 0 || zint >= m_GridSize[2])
+        return -1;
+    return xint + m_GridSize[0]*(yint + m_GridSize[1]*zint);
+}
+
+void ParticleGrid::InsertIntoCell(Particle* p, int idx)
+{
+    std::vector< Particle* >& cell = m_Grid[idx];
+    p->gridindex = idx;
+    p->cellpos = cell.size();
+    cell.push_back(p);
+}
+
+void ParticleGrid::RemoveFromCell(Particle* p)
+{
+    std::vector< Particle* >& cell = m_Grid[p->gridindex];
+    if (p->cellpos < (int)cell.size()-1)
+    {
+        cell[p->cellpos] = cell.back();     // move last particle of cell to empty slot
+        cell[p->cellpos]->cellpos = p->cellpos;
+    }
+    cell.pop_back();
+    p->gridindex = -1;
+    p->cellpos = -1;
+}
 
 Particle* ParticleGrid::NewParticle(vnl_vector_fixed<float, 3> R)
 {
     if (m_NumParticles >= m_ContainerCapacity)
     {
-        if (!ReallocateGrid())
+        if (!ReallocateGrid(m_ContainerCapacity+1))
             return nullptr;
     }
 
-    int xint = int(R[0]*m_GridScale[0]);
-    if (xint < 0)
-        return nullptr;
-    if (xint >= m_GridSize[0])
-        return nullptr;
-    int yint = int(R[1]*m_GridScale[1]);
-    if (yint < 0)
-        return nullptr;
-    if (yint >= m_GridSize[1])
-        return nullptr;
-    int zint = int(R[2]*m_GridScale[2]);
-    if (zint < 0)
-        return nullptr;
-    if (zint >= m_GridSize[2])
+    int idx = GetCellIndex(R);
+    if (idx < 0)
         return nullptr;
 
-    int idx = xint + m_GridSize[0]*(yint + m_GridSize[1]*zint);
-    if (m_OccupationCount[idx] < m_CellCapacity)
-    {
-        Particle *p = &(m_Particles[m_NumParticles]);
-        p->GetPos() = R;
-        p->mID = -1;
-        p->pID = -1;
-        m_NumParticles++;
-        p->gridindex = m_CellCapacity*idx + m_OccupationCount[idx];
-        m_Grid[p->gridindex] = p;
-        m_OccupationCount[idx]++;
-        return p;
-    }
-    else
-    {
-        m_NumCellOverflows++;
-        return nullptr;
-    }
+    Particle *p = &(m_Particles[m_NumParticles]);
+    p->GetPos() = R;
+    p->mID = -1;
+    p->pID = -1;
+    m_NumParticles++;
+    InsertIntoCell(p, idx);
+    return p;
 }
 
 bool ParticleGrid::TryUpdateGrid(int k)
 {
     Particle* p = &(m_Particles[k]);
 
-    int xint = int(p->GetPos()[0]*m_GridScale[0]);
-    if (xint < 0)
-        return false;
-    if (xint >= m_GridSize[0])
-        return false;
-    int yint = int(p->GetPos()[1]*m_GridScale[1]);
-    if (yint < 0)
-        return false;
-    if (yint >= m_GridSize[1])
-        return false;
-    int zint = int(p->GetPos()[2]*m_GridScale[2]);
-    if (zint < 0)
-        return false;
-    if (zint >= m_GridSize[2])
+    int idx = GetCellIndex(p->GetPos());
+    if (idx < 0)
         return false;
 
-    int idx = xint + m_GridSize[0]*(yint+ zint*m_GridSize[1]);
-    int cellidx = p->gridindex/m_CellCapacity;
-    if (idx != cellidx) // cell has changed
+    if (idx != p->gridindex) // cell has changed
     {
-
-        if (m_OccupationCount[idx] < m_CellCapacity)
-        {
-            // remove from old position in grid;
-            int grdindex = p->gridindex;
-            m_Grid[grdindex] = m_Grid[cellidx*m_CellCapacity + m_OccupationCount[cellidx]-1];
-            m_Grid[grdindex]->gridindex = grdindex;
-            m_OccupationCount[cellidx]--;
-
-            // insert at new position in grid
-            p->gridindex = idx*m_CellCapacity + m_OccupationCount[idx];
-            m_Grid[p->gridindex] = p;
-            m_OccupationCount[idx]++;
-            return true;
-        }
-        else
-        {
-            m_NumCellOverflows++;
-            return false;
-        }
+        RemoveFromCell(p);
+        InsertIntoCell(p, idx);
     }
     return true;
 }
@@ -214,9 +184,6 @@ bool ParticleGrid::TryUpdateGrid(int k)
 void ParticleGrid::RemoveParticle(int k)
 {
     Particle* p = &(m_Particles[k]);
-    int gridIndex = p->gridindex;
-    int cellIdx = gridIndex/m_CellCapacity;
-    int idx = gridIndex%m_CellCapacity;
 
     // remove pending connections
     if (p->mID != -1)
@@ -225,13 +192,7 @@ void ParticleGrid::RemoveParticle(int k)
         DestroyConnection(p,+1);
 
     // remove from grid
-    if (idx < m_OccupationCount[cellIdx]-1)
-    {
-        m_Grid[gridIndex] = m_Grid[cellIdx*m_CellCapacity+m_OccupationCount[cellIdx]-1];
-        m_Grid[cellIdx*m_CellCapacity+m_OccupationCount[cellIdx]-1] = nullptr;
-        m_Grid[gridIndex]->gridindex = gridIndex;
-    }
-    m_OccupationCount[cellIdx]--;
+    RemoveFromCell(p);
 
     // remove from container
     if (k < m_NumParticles-1)
@@ -256,13 +217,105 @@ void ParticleGrid::RemoveParticle(int k)
 
         m_Particles[k] = m_Particles[m_NumParticles-1];         // move very last particle to empty slot
         m_Particles[m_NumParticles-1].ID = m_NumParticles-1;    // update ID of removed particle to match the index
+        m_Particles[m_NumParticles-1].gridindex = -1;
+        m_Particles[m_NumParticles-1].cellpos = -1;
         m_Particles[k].ID = k;                                  // update ID of moved particle
-        m_Grid[m_Particles[k].gridindex] = &m_Particles[k];     // update address of moved particle
+        m_Grid[m_Particles[k].gridindex][m_Particles[k].cellpos] = &m_Particles[k];     // update address of moved particle
     }
     m_NumParticles--;
 }
 
+int ParticleGrid::BeginParallelPhase(int numReservedParticles)
+{
+    // reserve beforehand, particle addresses have to stay valid during the parallel phase
+    if (m_NumParticles+numReservedParticles > m_ContainerCapacity)
+    {
+        if (!ReallocateGrid(m_NumParticles+numReservedParticles))
+            return -1;
+    }
+    m_NumReservedParticles = numReservedParticles;
+    return m_NumParticles;
+}
+
+Particle* ParticleGrid::ActivateParticle(int ID, vnl_vector_fixed<float, 3> R)
+{
+    int idx = GetCellIndex(R);
+    if (idx < 0)
+        return nullptr;
+
+    Particle *p = &(m_Particles[ID]);
+    p->GetPos() = R;
+    p->mID = -1;
+    p->pID = -1;
+    InsertIntoCell(p, idx);
+    return p;
+}
+
+void ParticleGrid::DeactivateParticle(int ID)
+{
+    // only unconnected particles are deactivated, the container is compacted in EndParallelPhase
+    RemoveFromCell(&m_Particles[ID]);
+}
+
+void ParticleGrid::EndParallelPhase()
+{
+    int numSlots = m_NumParticles + m_NumReservedParticles;
+
+    // new IDs of all active particles, keeps the order of the container
+    std::vector< int > newID(numSlots, -1);
+    int numParticles = 0;
+    for (int i=0; i<numSlots; i++)
+        if (m_Particles[i].gridindex != -1)
+            newID[i] = numParticles++;
+
+    int numConnections = 0;
+    for (int i=0; i<numSlots; i++)
+    {
+        if (newID[i]==-1)
+            continue;
+
+        Particle& p = m_Particles[i];
+        if (p.pID != -1)
+        {
+            p.pID = newID[p.pID];
+            numConnections++;
+        }
+        if (p.mID != -1)
+        {
+            p.mID = newID[p.mID];
+            numConnections++;
+        }
+        if (newID[i]!=i)
+            m_Particles[newID[i]] = p;
+
+        Particle& moved = m_Particles[newID[i]];
+        moved.ID = newID[i];
+        m_Grid[moved.gridindex][moved.cellpos] = &moved;
+    }
+
+    // reset the now unused slots
+    for (int i=numParticles; i<numSlots; i++)
+    {
+        m_Particles[i] = Particle();
+        m_Particles[i].ID = i;
+    }
+
+    m_NumParticles = numParticles;
+    m_NumReservedParticles = 0;
+    m_NumConnections = numConnections/2;
+}
+
 void ParticleGrid::ComputeNeighbors(vnl_vector_fixed<float, 3> &R)
+{
+    ComputeNeighbors(R, m_NeighbourTracker);
+}
+
+Particle* ParticleGrid::GetNextNeighbor()
+{
+    return GetNextNeighbor(m_NeighbourTracker);
+}
+
+void ParticleGrid::ComputeNeighbors(const vnl_vector_fixed<float, 3> &R, NeighborTracker& tracker) const
 {
     float xfrac = R[0]*m_GridScale[0];
     float yfrac = R[1]*m_GridScale[1];
@@ -290,48 +343,30 @@ void ParticleGrid::ComputeNeighbors(vnl_vector_fixed<float, 3> &R)
     if (m_GridSize[2] <= 1) { dz = 0; } // Necessary with 2d images (bug 15416)
 
 
-    m_NeighbourTracker.cellidx[0] = xint + m_GridSize[0]*(yint+zint*m_GridSize[1]);
-    m_NeighbourTracker.cellidx[1] = m_NeighbourTracker.cellidx[0] + dx;
-    m_NeighbourTracker.cellidx[2] = m_NeighbourTracker.cellidx[1] + dy*m_GridSize[0];
-    m_NeighbourTracker.cellidx[3] = m_NeighbourTracker.cellidx[2] - dx;
-    m_NeighbourTracker.cellidx[4] = m_NeighbourTracker.cellidx[0] + dz*m_GridSize[0]*m_GridSize[1];
-    m_NeighbourTracker.cellidx[5] = m_NeighbourTracker.cellidx[4] + dx;
-    m_NeighbourTracker.cellidx[6] = m_NeighbourTracker.cellidx[5] + dy*m_GridSize[0];
-    m_NeighbourTracker.cellidx[7] = m_NeighbourTracker.cellidx[6] - dx;
-
-
-    m_NeighbourTracker.cellidx_c[0] = m_CellCapacity*m_NeighbourTracker.cellidx[0];
-    m_NeighbourTracker.cellidx_c[1] = m_CellCapacity*m_NeighbourTracker.cellidx[1];
-    m_NeighbourTracker.cellidx_c[2] = m_CellCapacity*m_NeighbourTracker.cellidx[2];
-    m_NeighbourTracker.cellidx_c[3] = m_CellCapacity*m_NeighbourTracker.cellidx[3];
-    m_NeighbourTracker.cellidx_c[4] = m_CellCapacity*m_NeighbourTracker.cellidx[4];
-    m_NeighbourTracker.cellidx_c[5] = m_CellCapacity*m_NeighbourTracker.cellidx[5];
-    m_NeighbourTracker.cellidx_c[6] = m_CellCapacity*m_NeighbourTracker.cellidx[6];
-    m_NeighbourTracker.cellidx_c[7] = m_CellCapacity*m_NeighbourTracker.cellidx[7];
+    tracker.cellidx[0] = xint + m_GridSize[0]*(yint+zint*m_GridSize[1]);
+    tracker.cellidx[1] = tracker.cellidx[0] + dx;
+    tracker.cellidx[2] = tracker.cellidx[1] + dy*m_GridSize[0];
+    tracker.cellidx[3] = tracker.cellidx[2] - dx;
+    tracker.cellidx[4] = tracker.cellidx[0] + dz*m_GridSize[0]*m_GridSize[1];
+    tracker.cellidx[5] = tracker.cellidx[4] + dx;
+    tracker.cellidx[6] = tracker.cellidx[5] + dy*m_GridSize[0];
+    tracker.cellidx[7] = tracker.cellidx[6] - dx;
 
-    m_NeighbourTracker.cellcnt = 0;
-    m_NeighbourTracker.pcnt = 0;
+    tracker.cellcnt = 0;
+    tracker.pcnt = 0;
 }
 
-Particle* ParticleGrid::GetNextNeighbor()
+Particle* ParticleGrid::GetNextNeighbor(NeighborTracker& tracker) const
 {
-    if (m_NeighbourTracker.pcnt < m_OccupationCount[m_NeighbourTracker.cellidx[m_NeighbourTracker.cellcnt]])
-    {
-        return m_Grid[m_NeighbourTracker.cellidx_c[m_NeighbourTracker.cellcnt] + (m_NeighbourTracker.pcnt++)];
-    }
-    else
+    while (tracker.cellcnt < 8)
     {
-        for(;;)
-        {
-            m_NeighbourTracker.cellcnt++;
-            if (m_NeighbourTracker.cellcnt >= 8)
-                return nullptr;
-            if (m_OccupationCount[m_NeighbourTracker.cellidx[m_NeighbourTracker.cellcnt]] > 0)
-                break;
-        }
-        m_NeighbourTracker.pcnt = 1;
-        return m_Grid[m_NeighbourTracker.cellidx_c[m_NeighbourTracker.cellcnt]];
+        const std::vector< Particle* >& cell = m_Grid[tracker.cellidx[tracker.cellcnt]];
+        if (tracker.pcnt < (int)cell.size())
+            return cell[tracker.pcnt++];
+        tracker.cellcnt++;
+        tracker.pcnt = 0;
     }
+    return nullptr;
 }
 
 void ParticleGrid::CreateConnection(Particle *P1,int ep1, Particle *P2, int ep2)
@@ -346,6 +381,7 @@ void ParticleGrid::CreateConnection(Particle *P1,int ep1, Particle *P2, int ep2)
     else
         P2->pID = P1->ID;
 
+#pragma omp atomic
     m_NumConnections++;
 }
 
@@ -360,6 +396,7 @@ void ParticleGrid::DestroyConnection(Particle *P1,int ep1, Particle *P2, int ep2
         P2->mID = -1;
     else
         P2->pID = -1;
+#pragma omp atomic
     m_NumConnections--;
 }
 
@@ -383,6 +420,7 @@ void ParticleGrid::DestroyConnection(Particle *P1,int ep1)
     else
         P2->pID = -1;
 
+#pragma omp atomic
     m_NumConnections--;
 }
 
@@ -37,12 +37,18 @@ public:
 
     typedef itk::Image< float, 3 >  ItkFloatImageType;
 
+    struct NeighborTracker  // to run over the neighbors
+    {
+        int cellidx[8];
+        int cellcnt;
+        int pcnt;
+    };
+
     int m_NumParticles;         // number of particles
     int m_NumConnections;       // number of connections
-    int m_NumCellOverflows;     // number of cell overflows
     float m_ParticleLength;
 
-    ParticleGrid(ItkFloatImageType* image, float particleLength, int cellCapacity);
+    ParticleGrid(ItkFloatImageType* image, float particleLength);
     ~ParticleGrid();
 
     Particle* GetParticle(int ID);
@@ -54,6 +60,10 @@ public:
     void ComputeNeighbors(vnl_vector_fixed<float, 3> &R);
     Particle* GetNextNeighbor();
 
+    // reentrant versions of the neighbour search, the caller owns the tracker
+    void ComputeNeighbors(const vnl_vector_fixed<float, 3> &R, NeighborTracker& tracker) const;
+    Particle* GetNextNeighbor(NeighborTracker& tracker) const;
+
     void CreateConnection(Particle *P1,int ep1, Particle *P2, int ep2);
     void DestroyConnection(Particle *P1,int ep1, Particle *P2, int ep2);
     void DestroyConnection(Particle *P1,int ep1);
@@ -61,28 +71,34 @@ public:
     bool CheckConsistency();
     void ResetGrid();
 
+    vnl_vector_fixed< int, 3 > GetGridSize() const { return m_GridSize; }
+    float GetCellSize() const { return 1.0/m_GridScale[0]; }
+    int GetCellIndex(const vnl_vector_fixed<float, 3>& R) const;   // -1 if R is outside of the grid
+    const std::vector< Particle* >& GetCell(int idx) const { return m_Grid.at(idx); }
+
+    // Parallel phase: the container is not reallocated and particle IDs stay valid. Births use the inactive particles
+    // reserved by BeginParallelPhase, deaths only deactivate particles. EndParallelPhase compacts the container again.
+    int BeginParallelPhase(int numReservedParticles);   // returns the ID of the first reserved particle
+    Particle* ActivateParticle(int ID, vnl_vector_fixed<float, 3> R);
+    void DeactivateParticle(int ID);
+    void EndParallelPhase();
+
 protected:
 
-    bool ReallocateGrid();
+    bool ReallocateGrid(int capacity);
+    void InsertIntoCell(Particle* p, int idx);
+    void RemoveFromCell(Particle* p);
 
-    std::vector< Particle* >    m_Grid;             // the grid
-    std::vector< Particle >     m_Particles;        // particle container
-    std::vector< int >          m_OccupationCount;  // number of particles per grid cell
+    std::vector< std::vector< Particle* > > m_Grid;         // the grid, each cell grows as needed
+    std::vector< Particle >                 m_Particles;    // particle container
 
     int m_ContainerCapacity;     // maximal number of particles
+    int m_NumReservedParticles;  // inactive particles appended during a parallel phase
 
     vnl_vector_fixed< int, 3 >      m_GridSize;     // grid dimensions
     vnl_vector_fixed< float, 3 >    m_GridScale;    // scaling factor for grid
 
-    int m_CellCapacity;      // particle capacity of single cell in grid
-
-    struct NeighborTracker  // to run over the neighbors
-    {
-        std::vector< int > cellidx;
-        std::vector< int > cellidx_c;
-        int cellcnt;
-        int pcnt;
-    } m_NeighbourTracker;
+    NeighborTracker m_NeighbourTracker;
 
 };
 
@@ -52,89 +52,60 @@ public:
     ~SphereInterpolator();
 
     inline void getInterpolation(const vnl_vector_fixed<float, 3>& N)
+    {
+        getInterpolation(N, idx, interpw);
+    }
+
+    // thread safe version, the interpolation indices and weights are written to the given vectors
+    inline void getInterpolation(const vnl_vector_fixed<float, 3>& N, vnl_vector_fixed< int, 3 >& outIdx, vnl_vector_fixed< float, 3 >& outW) const
     {
         float nx = N[0];
         float ny = N[1];
         float nz = N[2];
 
+        int i;
         if (nz > 0.5)
         {
             int x = float2int(nx);
             int y = float2int(ny);
-            int i = 3*6*(x+y*size);  // (:,1,x,y)
-            idx[0] = indices[i];
-            idx[1] = indices[i+1];
-            idx[2] = indices[i+2];
-            interpw[0] = barycoords[i];
-            interpw[1] = barycoords[i+1];
-            interpw[2] = barycoords[i+2];
-            return;
+            i = 3*6*(x+y*size);  // (:,1,x,y)
         }
-        if (nz < -0.5)
+        else if (nz < -0.5)
         {
             int x = float2int(nx);
             int y = float2int(ny);
-            int i = 3*(1+6*(x+y*size));  // (:,2,x,y)
-            idx[0] = indices[i];
-            idx[1] = indices[i+1];
-            idx[2] = indices[i+2];
-            interpw[0] = barycoords[i];
-            interpw[1] = barycoords[i+1];
-            interpw[2] = barycoords[i+2];
-            return;
+            i = 3*(1+6*(x+y*size));  // (:,2,x,y)
         }
-        if (nx > 0.5)
+        else if (nx > 0.5)
         {
             int z = float2int(nz);
             int y = float2int(ny);
-            int i = 3*(2+6*(z+y*size));  // (:,2,x,y)
-            idx[0] = indices[i];
-            idx[1] = indices[i+1];
-            idx[2] = indices[i+2];
-            interpw[0] = barycoords[i];
-            interpw[1] = barycoords[i+1];
-            interpw[2] = barycoords[i+2];
-            return;
+            i = 3*(2+6*(z+y*size));  // (:,2,x,y)
         }
-        if (nx < -0.5)
+        else if (nx < -0.5)
         {
             int z = float2int(nz);
             int y = float2int(ny);
-            int i = 3*(3+6*(z+y*size));  // (:,2,x,y)
-            idx[0] = indices[i];
-            idx[1] = indices[i+1];
-            idx[2] = indices[i+2];
-            interpw[0] = barycoords[i];
-            interpw[1] = barycoords[i+1];
-            interpw[2] = barycoords[i+2];
-            return;
+            i = 3*(3+6*(z+y*size));  // (:,2,x,y)
         }
-        if (ny > 0)
+        else if (ny > 0)
         {
             int x = float2int(nx);
             int z = float2int(nz);
-            int i = 3*(4+6*(x+z*size));  // (:,1,x,y)
-            idx[0] = indices[i];
-            idx[1] = indices[i+1];
-            idx[2] = indices[i+2];
-            interpw[0] = barycoords[i];
-            interpw[1] = barycoords[i+1];
-            interpw[2] = barycoords[i+2];
-            return;
+            i = 3*(4+6*(x+z*size));  // (:,1,x,y)
         }
         else
         {
             int x = float2int(nx);
             int z = float2int(nz);
-            int i = 3*(5+6*(x+z*size));  // (:,1,x,y)
-            idx[0] = indices[i];
-            idx[1] = indices[i+1];
-            idx[2] = indices[i+2];
-            interpw[0] = barycoords[i];
-            interpw[1] = barycoords[i+1];
-            interpw[2] = barycoords[i+2];
-            return;
+            i = 3*(5+6*(x+z*size));  // (:,1,x,y)
         }
+        outIdx[0] = indices[i];
+        outIdx[1] = indices[i+1];
+        outIdx[2] = indices[i+2];
+        outW[0] = barycoords[i];
+        outW[1] = barycoords[i+1];
+        outW[2] = barycoords[i+2];
     }
 
 protected:
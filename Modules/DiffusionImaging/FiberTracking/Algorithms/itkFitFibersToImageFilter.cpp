@@ -34,6 +34,7 @@ FitFibersToImageFilter::FitFibersToImageFilter()
   , m_MeanSignal(0)
   , fiber_count(0)
   , m_Regularization(VnlCostFunction::REGU::VOXEL_VARIANCE)
+  , m_Solver(LBFGSB)
 {
   this->SetNumberOfRequiredOutputs(3);
 }
@@ -65,43 +66,64 @@ void FitFibersToImageFilter::CreateDiffSystem()
   MITK_INFO << "Num. residuals: " << m_NumResiduals;
   MITK_INFO << "Creating system ...";
 
-  A.set_size(m_NumResiduals, m_NumUnknowns);
   b.set_size(m_NumResiduals); b.fill(0.0);
 
   m_MeanTractDensity = 0;
   m_MeanSignal = 0;
   m_NumCoveredDirections = 0;
   fiber_count = 0;
-  vnl_vector<int> voxel_indicator; voxel_indicator.set_size(sz_x*sz_y*sz_z); voxel_indicator.fill(0);
+
+  std::vector< bool > nonzero_gradient(dim_four_size);
+  for (int g=0; g<dim_four_size; ++g)
+    nonzero_gradient[g] = m_SignalModel->GetGradientDirection(g).GetNorm()>=mitk::eps;
 
   unsigned int numFibers = 0;
   for (unsigned int bundle=0; bundle<m_Tractograms.size(); bundle++)
     numFibers += m_Tractograms.at(bundle)->GetNumFibers();
+  std::vector< FitFibersSparseMatrix::EntryList > entries(numFibers);
+  std::vector< double > fiber_density(numFibers, 0.0);
   boost::progress_display disp(numFibers);
   m_GroupSizes.clear();
+
+  // models drawing a random kernel per measurement are simulated in fiber order, so the result stays reproducible
+  bool parallel_simulation = m_SignalModel->IsThreadSafe();
+  if (!parallel_simulation)
+    MITK_INFO << "Signal model is not thread safe, creating system single threaded.";
+
   for (unsigned int bundle=0; bundle<m_Tractograms.size(); bundle++)
   {
     vtkSmartPointer<vtkPolyData> polydata = m_Tractograms.at(bundle)->GetFiberPolyData();
-    m_GroupSizes.push_back(m_Tractograms.at(bundle)->GetNumFibers());
-    for (unsigned int i=0; i<m_Tractograms.at(bundle)->GetNumFibers(); ++i)
-    {
-      ++disp;
-      vtkCell* cell = polydata->GetCell(i);
-      int numPoints = cell->GetNumberOfPoints();
-      vtkPoints* points = cell->GetPoints();
+    int numBundleFibers = m_Tractograms.at(bundle)->GetNumFibers();
+    m_GroupSizes.push_back(numBundleFibers);
 
-      if (numPoints<2)
-        MITK_INFO << "FIBER WITH ONLY ONE POINT ENCOUNTERED!";
+#pragma omp parallel for if(parallel_simulation)
+    for (int i=0; i<numBundleFibers; ++i)
+    {
+      std::vector< PointType3 > fiber_points;
+#pragma omp critical
+      {
+        ++disp;
+        vtkCell* cell = polydata->GetCell(i);
+        int numPoints = cell->GetNumberOfPoints();
+        vtkPoints* points = cell->GetPoints();
+        if (numPoints<2)
+          MITK_INFO << "FIBER WITH ONLY ONE POINT ENCOUNTERED!";
+        for (int j=0; j<numPoints; ++j)
+          fiber_points.push_back(mitk::imv::GetItkPoint(points->GetPoint(j)));
+      }
 
-      for (int j=0; j<numPoints-1; ++j)
+      unsigned int column = m_FitIndividualFibers ? fiber_count + i : bundle;
+      FitFibersSparseMatrix::EntryList& fiber_entries = entries[fiber_count + i];
+      double& density = fiber_density[fiber_count + i];
+      for (int j=0; j<static_cast<int>(fiber_points.size())-1; ++j)
       {
-        PointType3 startVertex = mitk::imv::GetItkPoint(points->GetPoint(j));
+        PointType3 startVertex = fiber_points[j];
         itk::Index<3> startIndex;
         itk::ContinuousIndex<float, 3> startIndexCont;
         m_DiffImage->TransformPhysicalPointToIndex(startVertex, startIndex);
         m_DiffImage->TransformPhysicalPointToContinuousIndex(startVertex, startIndexCont);
 
-        PointType3 endVertex = mitk::imv::GetItkPoint(points->GetPoint(j+1));
+        PointType3 endVertex = fiber_points[j+1];
         itk::Index<3> endIndex;
         itk::ContinuousIndex<float, 3> endIndexCont;
         m_DiffImage->TransformPhysicalPointToIndex(endVertex, endIndex);
@@ -124,56 +146,75 @@ void FitFibersToImageFilter::CreateDiffSystem()
           int z = seg.first[2];
 
           mitk::DiffusionSignalModel<>::PixelType simulated_pixel = m_SignalModel->SimulateMeasurement(fiber_dir)*seg.second;
-          VectorImgType::PixelType measured_pixel = m_DiffImage->GetPixel(seg.first);
 
           double simulated_mean = 0;
-          double measured_mean = 0;
           int num_nonzero_g = 0;
           for (int g=0; g<dim_four_size; ++g)
           {
-            if( m_SignalModel->GetGradientDirection(g).GetNorm()<mitk::eps )
+            if (!nonzero_gradient[g])
               continue;
             simulated_mean += simulated_pixel[g];
-            measured_mean += (double)measured_pixel[g];
             ++num_nonzero_g;
           }
           simulated_mean /= num_nonzero_g;
-          measured_mean /= num_nonzero_g;
           simulated_pixel -= simulated_mean;
-
-          if (voxel_indicator[x + sz_x*y + sz_x*sz_y*z]==0)
-            m_MeanSignal += measured_mean;
-          m_MeanTractDensity += simulated_mean;
-          voxel_indicator[x + sz_x*y + sz_x*sz_y*z] = 1;
+          density += simulated_mean;
 
           for (int g=0; g<dim_four_size; ++g)
           {
             unsigned int linear_index = x + sz_x*y + sz_x*sz_y*z + sz_x*sz_y*sz_z*g;
-
-            if (m_FitIndividualFibers)
-            {
-              b[linear_index] = (double)measured_pixel[g] - measured_mean;
-              A.put(linear_index, fiber_count, A.get(linear_index, fiber_count) + simulated_pixel[g]);
-            }
-            else
-            {
-              b[linear_index] = (double)measured_pixel[g] - measured_mean;
-              A.put(linear_index, bundle, A.get(linear_index, bundle) + simulated_pixel[g]);
-            }
+            fiber_entries.push_back({linear_index, column, static_cast<float>(simulated_pixel[g])});
           }
         }
-
       }
-
-      ++fiber_count;
     }
+    fiber_count += numBundleFibers;
   }
+  // sums are accumulated in a fixed order, so the system does not depend on the number of threads
+  for (double density : fiber_density)
+    m_MeanTractDensity += density;
+  A.SetEntries(m_NumResiduals, m_NumUnknowns, entries);
+
+  // every traversed voxel has entries in all gradient rows, so the first one marks it as covered
+  std::vector< double > voxel_signal(num_voxels, 0.0);
+#pragma omp parallel for
+  for (int v=0; v<num_voxels; ++v)
+  {
+    if (A.empty_row(v))
+      continue;
+
+    itk::Index<3> idx;
+    idx[0] = v % sz_x;
+    idx[1] = (v / sz_x) % sz_y;
+    idx[2] = v / (sz_x*sz_y);
+    VectorImgType::PixelType measured_pixel = m_DiffImage->GetPixel(idx);
+
+    double measured_mean = 0;
+    int num_nonzero_g = 0;
+    for (int g=0; g<dim_four_size; ++g)
+    {
+      if (!nonzero_gradient[g])
+        continue;
+      measured_mean += (double)measured_pixel[g];
+      ++num_nonzero_g;
+    }
+    measured_mean /= num_nonzero_g;
 
-  m_NumCoveredDirections = voxel_indicator.sum();
+    for (int g=0; g<dim_four_size; ++g)
+      b[v + num_voxels*g] = (double)measured_pixel[g] - measured_mean;
+    voxel_signal[v] = measured_mean;
+  }
+  for (int v=0; v<num_voxels; ++v)
+  {
+    if (A.empty_row(v))
+      continue;
+    m_MeanSignal += voxel_signal[v];
+    ++m_NumCoveredDirections;
+  }
 
   m_MeanTractDensity /= (m_NumCoveredDirections*fiber_count);
   m_MeanSignal /= m_NumCoveredDirections;
-  A /= m_MeanTractDensity;
+  A.scale(1.0/m_MeanTractDensity);
   b *= 100.0/m_MeanSignal;  // times 100 because we want to avoid too small values for computational reasons
 
   // NEW FIT
@@ -234,7 +275,6 @@ void FitFibersToImageFilter::CreatePeakSystem()
   MITK_INFO << "Num. residuals: " << m_NumResiduals;
   MITK_INFO << "Creating system ...";
 
-  A.set_size(m_NumResiduals, m_NumUnknowns);
   b.set_size(m_NumResiduals); b.fill(0.0);
 
   m_MeanTractDensity = 0;
@@ -247,31 +287,46 @@ void FitFibersToImageFilter::CreatePeakSystem()
   int numFibers = 0;
   for (unsigned int bundle=0; bundle<m_Tractograms.size(); bundle++)
     numFibers += m_Tractograms.at(bundle)->GetNumFibers();
+  std::vector< FitFibersSparseMatrix::EntryList > entries(numFibers);
+  // magnitude of the closest peak of each entry, it is the measurement of the entry's row
+  std::vector< std::vector< float > > entry_peak_mags(numFibers);
+  std::vector< double > fiber_density(numFibers, 0.0);
   boost::progress_display disp(numFibers);
   for (unsigned int bundle=0; bundle<m_Tractograms.size(); bundle++)
   {
     vtkSmartPointer<vtkPolyData> polydata = m_Tractograms.at(bundle)->GetFiberPolyData();
+    int numBundleFibers = m_Tractograms.at(bundle)->GetNumFibers();
+    m_GroupSizes.push_back(numBundleFibers);
 
-    m_GroupSizes.push_back(m_Tractograms.at(bundle)->GetNumFibers());
-    for (unsigned int i=0; i<m_Tractograms.at(bundle)->GetNumFibers(); ++i)
+#pragma omp parallel for
+    for (int i=0; i<numBundleFibers; ++i)
     {
-      ++disp;
-      vtkCell* cell = polydata->GetCell(i);
-      int numPoints = cell->GetNumberOfPoints();
-      vtkPoints* points = cell->GetPoints();
-
-      if (numPoints<2)
-        MITK_INFO << "FIBER WITH ONLY ONE POINT ENCOUNTERED!";
+      std::vector< PointType3 > fiber_points;
+#pragma omp critical
+      {
+        ++disp;
+        vtkCell* cell = polydata->GetCell(i);
+        int numPoints = cell->GetNumberOfPoints();
+        vtkPoints* points = cell->GetPoints();
+        if (numPoints<2)
+          MITK_INFO << "FIBER WITH ONLY ONE POINT ENCOUNTERED!";
+        for (int j=0; j<numPoints; ++j)
+          fiber_points.push_back(mitk::imv::GetItkPoint(points->GetPoint(j)));
+      }
 
-      for (int j=0; j<numPoints-1; ++j)
+      unsigned int column = m_FitIndividualFibers ? fiber_count + i : bundle;
+      FitFibersSparseMatrix::EntryList& fiber_entries = entries[fiber_count + i];
+      std::vector< float >& fiber_peak_mags = entry_peak_mags[fiber_count + i];
+      double& density = fiber_density[fiber_count + i];
+      for (int j=0; j<static_cast<int>(fiber_points.size())-1; ++j)
       {
-        PointType3 startVertex = mitk::imv::GetItkPoint(points->GetPoint(j));
+        PointType3 startVertex = fiber_points[j];
         itk::Index<3> startIndex;
         itk::ContinuousIndex<float, 3> startIndexCont;
         m_MaskImage->TransformPhysicalPointToIndex(startVertex, startIndex);
         m_MaskImage->TransformPhysicalPointToContinuousIndex(startVertex, startIndexCont);
 
-        PointType3 endVertex = mitk::imv::GetItkPoint(points->GetPoint(j+1));
+        PointType3 endVertex = fiber_points[j+1];
         itk::Index<3> endIndex;
         itk::ContinuousIndex<float, 3> endIndexCont;
         m_MaskImage->TransformPhysicalPointToIndex(endVertex, endIndex);
@@ -307,33 +362,37 @@ void FitFibersToImageFilter::CreatePeakSystem()
           int z = idx4[2];
 
           unsigned int linear_index = x + sz_x*y + sz_x*sz_y*z + sz_x*sz_y*sz_z*peak_id;
-
-          if (b[linear_index] == 0 && peak_id<dim_four_size-1)
-          {
-            m_NumCoveredDirections++;
-            m_MeanSignal += peak_mag;
-          }
-          m_MeanTractDensity += w;
-
-          if (m_FitIndividualFibers)
-          {
-            b[linear_index] = peak_mag;
-            A.put(linear_index, fiber_count, A.get(linear_index, fiber_count) + w);
-          }
-          else
-          {
-            b[linear_index] = peak_mag;
-            A.put(linear_index, bundle, A.get(linear_index, bundle) + w);
-          }
+          density += w;
+          fiber_entries.push_back({linear_index, column, static_cast<float>(w)});
+          fiber_peak_mags.push_back(static_cast<float>(peak_mag));
         }
       }
-
-      ++fiber_count;
     }
+    fiber_count += numBundleFibers;
+  }
+  // the measurement of a covered peak is its magnitude, the zero-peak rows stay 0
+  int num_peak_residuals = num_voxels*(dim_four_size-1);
+  for (int f=0; f<numFibers; ++f)
+  {
+    m_MeanTractDensity += fiber_density[f];
+    for (unsigned int k=0; k<entries[f].size(); ++k)
+      if (entries[f][k].row < static_cast<unsigned int>(num_peak_residuals))
+        b[entries[f][k].row] = entry_peak_mags[f][k];
+  }
+  entry_peak_mags.clear();
+  A.SetEntries(m_NumResiduals, m_NumUnknowns, entries);
+
+  for (int r=0; r<num_peak_residuals; ++r)
+  {
+    if (A.empty_row(r))
+      continue;
+    m_MeanSignal += b[r];
+    ++m_NumCoveredDirections;
   }
+
   m_MeanTractDensity /= (m_NumCoveredDirections*fiber_count);
   m_MeanSignal /= m_NumCoveredDirections;
-  A /= m_MeanTractDensity;
+  A.scale(1.0/m_MeanTractDensity);
   b *= 100.0/m_MeanSignal;  // times 100 because we want to avoid too small values for computational reasons
 
   // NEW FIT
@@ -363,7 +422,6 @@ void FitFibersToImageFilter::CreateScalarSystem()
   MITK_INFO << "Num. residuals: " << m_NumResiduals;
   MITK_INFO << "Creating system ...";
 
-  A.set_size(m_NumResiduals, m_NumUnknowns);
   b.set_size(m_NumResiduals); b.fill(0.0);
 
   m_MeanTractDensity = 0;
@@ -374,29 +432,42 @@ void FitFibersToImageFilter::CreateScalarSystem()
   int numFibers = 0;
   for (unsigned int bundle=0; bundle<m_Tractograms.size(); bundle++)
     numFibers += m_Tractograms.at(bundle)->GetNumFibers();
+  std::vector< FitFibersSparseMatrix::EntryList > entries(numFibers);
+  std::vector< double > fiber_density(numFibers, 0.0);
   boost::progress_display disp(numFibers);
   m_GroupSizes.clear();
   for (unsigned int bundle=0; bundle<m_Tractograms.size(); bundle++)
   {
     vtkSmartPointer<vtkPolyData> polydata = m_Tractograms.at(bundle)->GetFiberPolyData();
+    int numBundleFibers = m_Tractograms.at(bundle)->GetNumFibers();
+    m_GroupSizes.push_back(numBundleFibers);
 
-    m_GroupSizes.push_back(m_Tractograms.at(bundle)->GetNumFibers());
-    for (unsigned int i=0; i<m_Tractograms.at(bundle)->GetNumFibers(); ++i)
+#pragma omp parallel for
+    for (int i=0; i<numBundleFibers; ++i)
     {
-      ++disp;
-      vtkCell* cell = polydata->GetCell(i);
-      int numPoints = cell->GetNumberOfPoints();
-      vtkPoints* points = cell->GetPoints();
+      std::vector< PointType3 > fiber_points;
+#pragma omp critical
+      {
+        ++disp;
+        vtkCell* cell = polydata->GetCell(i);
+        int numPoints = cell->GetNumberOfPoints();
+        vtkPoints* points = cell->GetPoints();
+        for (int j=0; j<numPoints; ++j)
+          fiber_points.push_back(mitk::imv::GetItkPoint(points->GetPoint(j)));
+      }
 
-      for (int j=0; j<numPoints-1; ++j)
+      unsigned int column = m_FitIndividualFibers ? fiber_count + i : bundle;
+      FitFibersSparseMatrix::EntryList& fiber_entries = entries[fiber_count + i];
+      double& density = fiber_density[fiber_count + i];
+      for (int j=0; j<static_cast<int>(fiber_points.size())-1; ++j)
       {
-        PointType3 startVertex = mitk::imv::GetItkPoint(points->GetPoint(j));
+        PointType3 startVertex = fiber_points[j];
         itk::Index<3> startIndex;
         itk::ContinuousIndex<float, 3> startIndexCont;
         m_ScalarImage->TransformPhysicalPointToIndex(startVertex, startIndex);
         m_ScalarImage->TransformPhysicalPointToContinuousIndex(startVertex, startIndexCont);
 
-        PointType3 endVertex = mitk::imv::GetItkPoint(points->GetPoint(j+1));
+        PointType3 endVertex = fiber_points[j+1];
         itk::Index<3> endIndex;
         itk::ContinuousIndex<float, 3> endIndexCont;
         m_ScalarImage->TransformPhysicalPointToIndex(endVertex, endIndex);
@@ -408,39 +479,41 @@ void FitFibersToImageFilter::CreateScalarSystem()
           if (!m_ScalarImage->GetLargestPossibleRegion().IsInside(seg.first) || (m_MaskImage.IsNotNull() && m_MaskImage->GetPixel(seg.first)==0))
             continue;
 
-          float image_value = m_ScalarImage->GetPixel(seg.first);
           int x = seg.first[0];
           int y = seg.first[1];
           int z = seg.first[2];
 
           unsigned int linear_index = x + sz_x*y + sz_x*sz_y*z;
-
-          if (b[linear_index] == 0)
-          {
-            numCoveredVoxels++;
-            m_MeanSignal += image_value;
-          }
-          m_MeanTractDensity += seg.second;
-
-          if (m_FitIndividualFibers)
-          {
-            b[linear_index] = image_value;
-            A.put(linear_index, fiber_count, A.get(linear_index, fiber_count) + seg.second);
-          }
-          else
-          {
-            b[linear_index] = image_value;
-            A.put(linear_index, bundle, A.get(linear_index, bundle) + seg.second);
-          }
+          density += seg.second;
+          fiber_entries.push_back({linear_index, column, static_cast<float>(seg.second)});
         }
       }
-
-      ++fiber_count;
     }
+    fiber_count += numBundleFibers;
   }
+  for (double density : fiber_density)
+    m_MeanTractDensity += density;
+  A.SetEntries(m_NumResiduals, m_NumUnknowns, entries);
+
+  for (int v=0; v<num_voxels; ++v)
+  {
+    if (A.empty_row(v))
+      continue;
+
+    itk::Index<3> idx;
+    idx[0] = v % sz_x;
+    idx[1] = (v / sz_x) % sz_y;
+    idx[2] = v / (sz_x*sz_y);
+    double image_value = m_ScalarImage->GetPixel(idx);
+
+    b[v] = image_value;
+    m_MeanSignal += image_value;
+    ++numCoveredVoxels;
+  }
+
   m_MeanTractDensity /= (numCoveredVoxels*fiber_count);
   m_MeanSignal /= numCoveredVoxels;
-  A /= m_MeanTractDensity;
+  A.scale(1.0/m_MeanTractDensity);
   b *= 100.0/m_MeanSignal;  // times 100 because we want to avoid too small values for computational reasons
 
   // NEW FIT
@@ -499,6 +572,13 @@ void FitFibersToImageFilter::GenerateData()
   minimizer.set_bound_selection(bound_selection);
   minimizer.set_lower_bound(l);
   minimizer.set_projected_gradient_tolerance(m_GradientTolerance);
+  VnlProjectedGradientMinimizer pg_minimizer(cost);
+  pg_minimizer.set_projected_gradient_tolerance(m_GradientTolerance);
+
+  if (m_Solver==PROJECTED_GRADIENT)
+    MITK_INFO << "Solver: PROJECTED_GRADIENT";
+  else
+    MITK_INFO << "Solver: LBFGSB";
 
   if (m_Regularization==VnlCostFunction::REGU::MSM)
     MITK_INFO << "Regularization type: MSM";
@@ -518,9 +598,18 @@ void FitFibersToImageFilter::GenerateData()
   if (m_Regularization!=VnlCostFunction::REGU::NONE)  // REMOVE FOR NEW FIT AND SET cost.m_Lambda = m_Lambda
   {
     MITK_INFO << "Estimating regularization";
-    minimizer.set_trace(false);
-    minimizer.set_max_function_evals(2);
-    minimizer.minimize(m_Weights);
+    if (m_Solver==PROJECTED_GRADIENT)
+    {
+      pg_minimizer.set_trace(false);
+      pg_minimizer.set_max_function_evals(2);
+      pg_minimizer.minimize(m_Weights);
+    }
+    else
+    {
+      minimizer.set_trace(false);
+      minimizer.set_max_function_evals(2);
+      minimizer.minimize(m_Weights);
+    }
     vnl_vector<double> dx; dx.set_size(m_NumUnknowns); dx.fill(0.0);
     cost.calc_regularization_gradient(m_Weights, dx);
 
@@ -546,10 +635,18 @@ void FitFibersToImageFilter::GenerateData()
   MITK_INFO << "Using regularization factor of " << cost.m_Lambda << " (λ: " << m_Lambda << ")";
 
   MITK_INFO << "Fitting fibers";
-  minimizer.set_trace(m_Verbose);
-
-  minimizer.set_max_function_evals(m_MaxIterations);
-  minimizer.minimize(m_Weights);
+  if (m_Solver==PROJECTED_GRADIENT)
+  {
+    pg_minimizer.set_trace(m_Verbose);
+    pg_minimizer.set_max_function_evals(m_MaxIterations);
+    pg_minimizer.minimize(m_Weights);
+  }
+  else
+  {
+    minimizer.set_trace(m_Verbose);
+    minimizer.set_max_function_evals(m_MaxIterations);
+    minimizer.minimize(m_Weights);
+  }
 
   std::vector< double > weights;
   if (m_FilterOutliers)
@@ -559,10 +656,18 @@ void FitFibersToImageFilter::GenerateData()
     std::sort(weights.begin(), weights.end());
     MITK_INFO << "Setting upper weight bound to " << weights.at(m_NumUnknowns*0.99);
     vnl_vector<double> u; u.set_size(m_NumUnknowns); u.fill(weights.at(m_NumUnknowns*0.99));
-    minimizer.set_upper_bound(u);
-    bound_selection.fill(2);
-    minimizer.set_bound_selection(bound_selection);
-    minimizer.minimize(m_Weights);
+    if (m_Solver==PROJECTED_GRADIENT)
+    {
+      pg_minimizer.set_upper_bound(u);
+      pg_minimizer.minimize(m_Weights);
+    }
+    else
+    {
+      minimizer.set_upper_bound(u);
+      bound_selection.fill(2);
+      minimizer.set_bound_selection(bound_selection);
+      minimizer.minimize(m_Weights);
+    }
     weights.clear();
   }
 
@@ -589,10 +694,19 @@ void FitFibersToImageFilter::GenerateData()
   MITK_INFO << "Min: " << m_MinWeight;
   MITK_INFO << "Max: " << m_MaxWeight;
   MITK_INFO << "*************************";
-  MITK_INFO << "NumEvals: " << minimizer.get_num_evaluations();
-  MITK_INFO << "NumIterations: " << minimizer.get_num_iterations();
-  MITK_INFO << "Residual cost: " << minimizer.get_end_error();
-  m_RMSE = cost.S->get_rms_error(m_Weights);
+  if (m_Solver==PROJECTED_GRADIENT)
+  {
+    MITK_INFO << "NumEvals: " << pg_minimizer.get_num_evaluations();
+    MITK_INFO << "NumIterations: " << pg_minimizer.get_num_iterations();
+    MITK_INFO << "Residual cost: " << pg_minimizer.get_end_error();
+  }
+  else
+  {
+    MITK_INFO << "NumEvals: " << minimizer.get_num_evaluations();
+    MITK_INFO << "NumIterations: " << minimizer.get_num_iterations();
+    MITK_INFO << "Residual cost: " << minimizer.get_end_error();
+  }
+  m_RMSE = A.get_rms_error(m_Weights, b);
   MITK_INFO << "Final RMSE: " << m_RMSE;
 
   clock.Stop();
@@ -622,7 +736,7 @@ void FitFibersToImageFilter::GenerateData()
 
         ++fiber_count;
       }
-      double d_rms = cost.S->get_rms_error(temp_weights) - m_RMSE;
+      double d_rms = A.get_rms_error(temp_weights, b) - m_RMSE;
       m_RmsDiffPerBundle[bundle] = d_rms;
     }
   }
@@ -634,7 +748,7 @@ void FitFibersToImageFilter::GenerateData()
       temp_weights.set_size(m_Weights.size());
       temp_weights.copy_in(m_Weights.data_block());
       temp_weights[i] = 0;
-      double d_rms = cost.S->get_rms_error(temp_weights) - m_RMSE;
+      double d_rms = A.get_rms_error(temp_weights, b) - m_RMSE;
       m_RmsDiffPerBundle[i] = d_rms;
 
       m_Tractograms.at(i)->SetFiberWeights(m_Weights[i]);
@@ -643,7 +757,7 @@ void FitFibersToImageFilter::GenerateData()
   std::cout.rdbuf (old);
 
   // transform back
-  A *= m_MeanSignal/100.0;
+  A.scale(m_MeanSignal/100.0);
   b *= m_MeanSignal/100.0;
 
   MITK_INFO << "Generating output images ...";
@@ -686,7 +800,7 @@ void FitFibersToImageFilter::GenerateOutputDiffImages()
   m_FittedImageDiff->FillBuffer(pix);
 
   vnl_vector<double> fitted_b; fitted_b.set_size(b.size());
-  cost.S->multiply(m_Weights, fitted_b);
+  A.multiply(m_Weights, fitted_b);
 
   itk::ImageRegionIterator<VectorImgType> it1 = itk::ImageRegionIterator<VectorImgType>(m_DiffImage, m_DiffImage->GetLargestPossibleRegion());
   itk::ImageRegionIterator<VectorImgType> it2 = itk::ImageRegionIterator<VectorImgType>(m_FittedImageDiff, m_FittedImageDiff->GetLargestPossibleRegion());
@@ -777,7 +891,7 @@ void FitFibersToImageFilter::GenerateOutputScalarImages()
   m_FittedImageScalar->FillBuffer(0);
 
   vnl_vector<double> fitted_b; fitted_b.set_size(b.size());
-  cost.S->multiply(m_Weights, fitted_b);
+  A.multiply(m_Weights, fitted_b);
 
   itk::ImageRegionIterator<DoubleImgType> it1 = itk::ImageRegionIterator<DoubleImgType>(m_ScalarImage, m_ScalarImage->GetLargestPossibleRegion());
   itk::ImageRegionIterator<DoubleImgType> it2 = itk::ImageRegionIterator<DoubleImgType>(m_FittedImageScalar, m_FittedImageScalar->GetLargestPossibleRegion());
@@ -863,7 +977,7 @@ void FitFibersToImageFilter::GenerateOutputPeakImages()
   m_FittedImage->FillBuffer(0.0);
 
   vnl_vector<double> fitted_b; fitted_b.set_size(b.size());
-  cost.S->multiply(m_Weights, fitted_b);
+  A.multiply(m_Weights, fitted_b);
 
   for (unsigned int r=0; r<b.size(); r++)
   {
@@ -6,13 +6,212 @@
 #include <itkImageSource.h>
 #include <mitkPeakImage.h>
 #include <vnl/algo/vnl_lbfgsb.h>
-#include <vnl/vnl_sparse_matrix.h>
-#include <vnl/vnl_sparse_matrix_linear_system.h>
 #include <itkImageDuplicator.h>
 #include <itkTimeProbe.h>
 #include <itkMersenneTwisterRandomVariateGenerator.h>
 #include <mitkDiffusionPropertyHelper.h>
 #include <mitkDiffusionSignalModel.h>
+#include <algorithm>
+#include <deque>
+
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define FITFIBERS_SIMD_SUM _Pragma("omp simd reduction(+:sum)")
+#else
+#define FITFIBERS_SIMD_SUM
+#endif
+
+/**
+* \brief Sparse system matrix of the fiber fit in compressed sparse row format with float storage.
+*
+* The transposed matrix is stored as well, so that A*x and A^T*d can both be computed row-parallel without
+* write conflicts. Values are stored as float, products are accumulated in double.
+*/
+class FitFibersSparseMatrix
+{
+public:
+
+  struct Entry
+  {
+    unsigned int  row;
+    unsigned int  col;
+    float         value;
+  };
+  typedef std::vector< Entry > EntryList;
+
+  FitFibersSparseMatrix() : m_Rows(0), m_Cols(0) {}
+
+  unsigned int rows() const { return m_Rows; }
+  unsigned int cols() const { return m_Cols; }
+  unsigned long long nonzeros() const { return m_Values.size(); }
+  bool empty_row(unsigned int r) const { return m_RowStart[r]==m_RowStart[r+1]; }
+  unsigned long long row_size(unsigned int r) const { return m_RowStart[r+1]-m_RowStart[r]; }
+
+  /** Builds the matrix from unsorted entry lists. Duplicate entries are summed. The lists are released while building. */
+  void SetEntries(unsigned int rows, unsigned int cols, std::vector< EntryList >& entries)
+  {
+    m_Rows = rows;
+    m_Cols = cols;
+
+    // bucket entries by row (counting sort keeps the insertion order within each row)
+    std::vector< unsigned long long > row_start(rows+1, 0);
+    for (auto& list : entries)
+      for (auto& e : list)
+        ++row_start[e.row+1];
+    for (unsigned int r=0; r<rows; ++r)
+      row_start[r+1] += row_start[r];
+
+    std::vector< std::pair< unsigned int, float > > row_entries(row_start[rows]);
+    std::vector< unsigned long long > fill(row_start.begin(), row_start.end()-1);
+    for (auto& list : entries)
+    {
+      for (auto& e : list)
+        row_entries[fill[e.row]++] = std::make_pair(e.col, e.value);
+      EntryList().swap(list);
+    }
+    entries.clear();
+    std::vector< unsigned long long >().swap(fill);
+
+    // sort each row by column and sum duplicates
+    std::vector< unsigned long long > row_nnz(rows, 0);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int r=0; r<static_cast<int>(rows); ++r)
+    {
+      auto first = row_entries.begin() + row_start[r];
+      auto last = row_entries.begin() + row_start[r+1];
+      if (first==last)
+        continue;
+      std::stable_sort(first, last, [](const std::pair< unsigned int, float >& a, const std::pair< unsigned int, float >& b){ return a.first<b.first; });
+
+      auto out = first;
+      double sum = out->second;
+      for (auto it = first+1; it!=last; ++it)
+      {
+        if (it->first==out->first)
+          sum += it->second;
+        else
+        {
+          out->second = static_cast<float>(sum);
+          ++out;
+          *out = *it;
+          sum = it->second;
+        }
+      }
+      out->second = static_cast<float>(sum);
+      row_nnz[r] = (out - first) + 1;
+    }
+
+    m_RowStart.assign(rows+1, 0);
+    for (unsigned int r=0; r<rows; ++r)
+      m_RowStart[r+1] = m_RowStart[r] + row_nnz[r];
+    m_Columns.resize(m_RowStart[rows]);
+    m_Values.resize(m_RowStart[rows]);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int r=0; r<static_cast<int>(rows); ++r)
+    {
+      for (unsigned long long k=0; k<row_nnz[r]; ++k)
+      {
+        m_Columns[m_RowStart[r]+k] = row_entries[row_start[r]+k].first;
+        m_Values[m_RowStart[r]+k] = row_entries[row_start[r]+k].second;
+      }
+    }
+    std::vector< std::pair< unsigned int, float > >().swap(row_entries);
+
+    // transposed matrix
+    m_ColStart.assign(cols+1, 0);
+    for (auto c : m_Columns)
+      ++m_ColStart[c+1];
+    for (unsigned int c=0; c<cols; ++c)
+      m_ColStart[c+1] += m_ColStart[c];
+    m_TransposedRows.resize(m_Columns.size());
+    m_TransposedValues.resize(m_Columns.size());
+    std::vector< unsigned long long > col_fill(m_ColStart.begin(), m_ColStart.end()-1);
+    for (unsigned int r=0; r<rows; ++r)
+      for (unsigned long long k=m_RowStart[r]; k<m_RowStart[r+1]; ++k)
+      {
+        unsigned long long pos = col_fill[m_Columns[k]]++;
+        m_TransposedRows[pos] = r;
+        m_TransposedValues[pos] = m_Values[k];
+      }
+  }
+
+  void scale(double factor)
+  {
+    float f = static_cast<float>(factor);
+    long long n = static_cast<long long>(m_Values.size());
+#pragma omp parallel for
+    for (long long k=0; k<n; ++k)
+    {
+      m_Values[k] *= f;
+      m_TransposedValues[k] *= f;
+    }
+  }
+
+  /** y = A*x */
+  void multiply(vnl_vector<double> const& x, vnl_vector<double>& y) const
+  {
+    y.set_size(m_Rows);
+    const double* xp = x.data_block();
+    double* yp = y.data_block();
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int r=0; r<static_cast<int>(m_Rows); ++r)
+      yp[r] = row_dot(m_RowStart[r], m_RowStart[r+1], m_Columns.data(), m_Values.data(), xp);
+  }
+
+  /** y = A^T*d */
+  void transpose_multiply(vnl_vector<double> const& d, vnl_vector<double>& y) const
+  {
+    y.set_size(m_Cols);
+    const double* dp = d.data_block();
+    double* yp = y.data_block();
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int c=0; c<static_cast<int>(m_Cols); ++c)
+      yp[c] = row_dot(m_ColStart[c], m_ColStart[c+1], m_TransposedRows.data(), m_TransposedValues.data(), dp);
+  }
+
+  /** d = A*x - b, returns the squared magnitude of d */
+  double residual(vnl_vector<double> const& x, vnl_vector<double> const& b, vnl_vector<double>& d) const
+  {
+    d.set_size(m_Rows);
+    const double* xp = x.data_block();
+    const double* bp = b.data_block();
+    double* dp = d.data_block();
+    double squared_magnitude = 0;
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+:squared_magnitude)
+    for (int r=0; r<static_cast<int>(m_Rows); ++r)
+    {
+      dp[r] = row_dot(m_RowStart[r], m_RowStart[r+1], m_Columns.data(), m_Values.data(), xp) - bp[r];
+      squared_magnitude += dp[r]*dp[r];
+    }
+    return squared_magnitude;
+  }
+
+  double get_rms_error(vnl_vector<double> const& x, vnl_vector<double> const& b) const
+  {
+    vnl_vector<double> d;
+    return std::sqrt(residual(x, b, d)/m_Rows);
+  }
+
+  std::vector< unsigned long long > m_RowStart;
+  std::vector< unsigned int >       m_Columns;
+  std::vector< float >              m_Values;
+  std::vector< unsigned long long > m_ColStart;
+  std::vector< unsigned int >       m_TransposedRows;
+  std::vector< float >              m_TransposedValues;
+
+private:
+
+  static double row_dot(unsigned long long start, unsigned long long end, const unsigned int* idx, const float* val, const double* x)
+  {
+    double sum = 0;
+    FITFIBERS_SIMD_SUM
+    for (unsigned long long k=start; k<end; ++k)
+      sum += val[k]*x[idx[k]];
+    return sum;
+  }
+
+  unsigned int m_Rows;
+  unsigned int m_Cols;
+};
 
 class VnlCostFunction : public vnl_cost_function
 {
@@ -29,10 +228,8 @@ public:
     NONE
   };
 
-  vnl_sparse_matrix_linear_system< double >* S;
-  vnl_sparse_matrix< double > m_A;
-  vnl_sparse_matrix< double > m_A_Ones; // matrix indicating active weights with 1
-  vnl_vector< double > m_b;
+  const FitFibersSparseMatrix* m_A;
+  const vnl_vector< double >* m_b;
   double m_Lambda;  // regularization factor
 
   vnl_vector<double> row_sums;  // number of active weights per row
@@ -40,22 +237,16 @@ public:
   REGU regularization;
   std::vector<unsigned int> group_sizes;
 
-  void SetProblem(vnl_sparse_matrix< double >& A, vnl_vector<double>& b, double lambda, REGU regu)
+  void SetProblem(const FitFibersSparseMatrix& A, const vnl_vector<double>& b, double lambda, REGU regu)
   {
-    S = new vnl_sparse_matrix_linear_system<double>(A, b);
-    m_A = A;
-    m_b = b;
+    m_A = &A;
+    m_b = &b;
     m_Lambda = lambda;
 
-    m_A_Ones.set_size(m_A.rows(), m_A.cols());
-    m_A.reset();
-    while (m_A.next())
-      m_A_Ones.put(m_A.getrow(), m_A.getcolumn(), 1);
-
-    unsigned int N = m_b.size();
-    vnl_vector<double> ones; ones.set_size(dim); ones.fill(1.0);
+    unsigned int N = m_b->size();
     row_sums.set_size(N);
-    m_A_Ones.mult(ones, row_sums);
+    for (unsigned int r=0; r<N; ++r)
+      row_sums[r] = m_A->row_size(r);
     local_weight_means.set_size(N);
     regularization = regu;
   }
@@ -65,15 +256,15 @@ public:
     unsigned int sum = 0;
     for (auto s : sizes)
       sum += s;
-    if (sum!=m_A.cols())
+    if (sum!=m_A->cols())
     {
-      MITK_INFO << "Group sizes do not match number of unknowns (" << sum << " vs. " << m_A.cols() << ")";
+      MITK_INFO << "Group sizes do not match number of unknowns (" << sum << " vs. " << m_A->cols() << ")";
       return;
     }
     group_sizes = sizes;
   }
 
-  VnlCostFunction(const int NumVars=0) : vnl_cost_function(NumVars)
+  VnlCostFunction(const int NumVars=0) : vnl_cost_function(NumVars), m_A(nullptr), m_b(nullptr), m_Lambda(0), regularization(NONE)
   {
   }
 
@@ -118,22 +309,41 @@ public:
     cost += 10000.0*m_Lambda*tx.squared_magnitude()/dim;
   }
 
+  // mean weight of the active weights in each row
+  void calc_local_weight_means(vnl_vector<double> const &x)
+  {
+    const unsigned int* columns = m_A->m_Columns.data();
+    const unsigned long long* row_start = m_A->m_RowStart.data();
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int r=0; r<static_cast<int>(row_sums.size()); ++r)
+    {
+      double sum = 0;
+      for (unsigned long long k=row_start[r]; k<row_start[r+1]; ++k)
+        sum += x[columns[k]];
+      local_weight_means[r] = sum/row_sums[r];
+    }
+  }
+
   // Regularization: voxel-weise mean squared deaviation of weights from voxel-wise mean weight (enforce locally uniform weights)
   void regu_VoxelVariance(vnl_vector<double> const &x, double& cost)
   {
-    m_A_Ones.mult(x, local_weight_means);
-    local_weight_means = element_quotient(local_weight_means, row_sums);
+    calc_local_weight_means(x);
 
-    m_A_Ones.reset();
+    const unsigned int* columns = m_A->m_Columns.data();
+    const unsigned long long* row_start = m_A->m_RowStart.data();
     double regu = 0;
-    while (m_A_Ones.next())
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+:regu)
+    for (int r=0; r<static_cast<int>(row_sums.size()); ++r)
     {
-      double d = 0;
-      if (x[m_A_Ones.getcolumn()]>local_weight_means[m_A_Ones.getrow()])
-        d = std::exp(x[m_A_Ones.getcolumn()]) - std::exp(local_weight_means[m_A_Ones.getrow()]);
-      else
-        d = x[m_A_Ones.getcolumn()] - local_weight_means[m_A_Ones.getrow()];
-      regu += d*d;
+      for (unsigned long long k=row_start[r]; k<row_start[r+1]; ++k)
+      {
+        double d = 0;
+        if (x[columns[k]]>local_weight_means[r])
+          d = std::exp(x[columns[k]]) - std::exp(local_weight_means[r]);
+        else
+          d = x[columns[k]] - local_weight_means[r];
+        regu += d*d;
+      }
     }
     cost += m_Lambda*regu/dim;
   }
@@ -195,25 +405,28 @@ public:
 
   void grad_regu_VoxelVariance(vnl_vector<double> const &x, vnl_vector<double> &dx)
   {
-    m_A_Ones.mult(x, local_weight_means);
-    local_weight_means = element_quotient(local_weight_means, row_sums);
+    calc_local_weight_means(x);
 
-    vnl_vector<double> exp_x = x.apply(std::exp);
     vnl_vector<double> exp_means = local_weight_means.apply(std::exp);
 
-    vnl_vector<double> tdx(dim, 0);
-    m_A_Ones.reset();
-    while (m_A_Ones.next())
+    // gather per column via the transposed matrix to avoid concurrent writes
+    const unsigned int* rows = m_A->m_TransposedRows.data();
+    const unsigned long long* col_start = m_A->m_ColStart.data();
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int c=0; c<dim; ++c)
     {
-      int c = m_A_Ones.getcolumn();
-      int r = m_A_Ones.getrow();
-
-      if (x[c]>local_weight_means[r])
-        tdx[c] += exp_x[c] * ( exp_x[c] - exp_means[r] );
-      else
-        tdx[c] += x[c] - local_weight_means[r];
+      double exp_x = std::exp(x[c]);
+      double tdx = 0;
+      for (unsigned long long k=col_start[c]; k<col_start[c+1]; ++k)
+      {
+        unsigned int r = rows[k];
+        if (x[c]>local_weight_means[r])
+          tdx += exp_x * ( exp_x - exp_means[r] );
+        else
+          tdx += x[c] - local_weight_means[r];
+      }
+      dx[c] += tdx*2.0*m_Lambda/dim;
     }
-    dx += tdx*2.0*m_Lambda/dim;
   }
 
   void grad_regu_GroupLasso(vnl_vector<double> const &x, vnl_vector<double> &dx)
@@ -270,13 +483,12 @@ public:
   }
 
   // cost function
-  double f(vnl_vector<double> const &x)
+  double f(vnl_vector<double> const &x) override
   {
     // RMS error
-    unsigned int N = m_b.size();
-    vnl_vector<double> d; d.set_size(N);
-    S->multiply(x,d);
-    double cost = (d - m_b).squared_magnitude()/N;
+    unsigned int N = m_b->size();
+    vnl_vector<double> d;
+    double cost = m_A->residual(x, *m_b, d)/N;
 
     // regularize
     calc_regularization(x, cost);
@@ -285,25 +497,171 @@ public:
   }
 
   // gradient of cost function
-  void gradf(vnl_vector<double> const &x, vnl_vector<double> &dx)
+  void gradf(vnl_vector<double> const &x, vnl_vector<double> &dx) override
+  {
+    vnl_vector<double> d;
+    m_A->residual(x, *m_b, d);
+    calc_gradient(x, d, dx);
+  }
+
+  // cost and gradient share the residual vector, so A*x is only computed once per evaluation
+  void compute(vnl_vector<double> const &x, double *f, vnl_vector<double> *g) override
   {
-    dx.fill(0.0);
-    unsigned int N = m_b.size();
+    unsigned int N = m_b->size();
+    vnl_vector<double> d;
+    double squared_residual = m_A->residual(x, *m_b, d);
+    if (f)
+    {
+      *f = squared_residual/N;
+      calc_regularization(x, *f);
+    }
+    if (g)
+      calc_gradient(x, d, *g);
+  }
+
+private:
 
-    // calculate output difference d
-    vnl_vector<double> d; d.set_size(N);
-    S->multiply(x,d);
-    d -= m_b;
+  void calc_gradient(vnl_vector<double> const &x, vnl_vector<double> const &d, vnl_vector<double> &dx)
+  {
+    unsigned int N = m_b->size();
 
     // (f(u(x)))' = f'(u(x)) * u'(x)
     // d/dx_j = 1/N * Sum_i A_i,j * 2*(A_i,j * x_j - b_i)
-    S->transpose_multiply(d, dx);
+    m_A->transpose_multiply(d, dx);
     dx *= 2.0/N;
 
     calc_regularization_gradient(x,dx);
   }
 };
 
+/**
+* \brief Spectral projected gradient minimizer (Birgin et al., https://doi.org/10.1137/S1052623497330963) for the fiber fit.
+*
+* The weights are kept feasible by projecting onto the box [0, upper bound] in every step, which exploits the
+* non-negativity constraint directly. The interface mirrors the parts of vnl_lbfgsb used by the filter.
+*/
+class VnlProjectedGradientMinimizer
+{
+public:
+
+  VnlProjectedGradientMinimizer(VnlCostFunction& cost)
+    : m_Cost(cost)
+    , m_MaxFunctionEvals(100)
+    , m_GradientTolerance(1e-5)
+    , m_Trace(false)
+    , m_NumEvaluations(0)
+    , m_NumIterations(0)
+    , m_EndError(0)
+  {}
+
+  void set_upper_bound(vnl_vector<double> const& u) { m_UpperBound = u; }
+  void set_max_function_evals(int n) { m_MaxFunctionEvals = n; }
+  void set_projected_gradient_tolerance(double tol) { m_GradientTolerance = tol; }
+  void set_trace(bool trace) { m_Trace = trace; }
+
+  int get_num_evaluations() const { return m_NumEvaluations; }
+  int get_num_iterations() const { return m_NumIterations; }
+  double get_end_error() const { return m_EndError; }
+
+  bool minimize(vnl_vector<double>& x)
+  {
+    const unsigned int history_size = 10;   // non-monotone line search memory
+    const double gamma = 1e-4;              // sufficient decrease parameter
+    const double alpha_min = 1e-10;
+    const double alpha_max = 1e10;
+
+    m_NumEvaluations = 0;
+    m_NumIterations = 0;
+
+    project(x);
+    vnl_vector<double> g, g_new, d, x_new;
+    double f = 0;
+    m_Cost.compute(x, &f, &g);
+    ++m_NumEvaluations;
+    std::deque< double > history(1, f);
+
+    d = x - g; project(d); d -= x;
+    double alpha = d.inf_norm()>0 ? 1.0/d.inf_norm() : 1.0;
+
+    while (m_NumEvaluations<m_MaxFunctionEvals)
+    {
+      // projected gradient norm as convergence criterion
+      d = x - g; project(d); d -= x;
+      if (d.inf_norm()<m_GradientTolerance)
+        break;
+
+      d = x - alpha*g; project(d); d -= x;
+      double gd = dot_product(g, d);
+      double f_max = *std::max_element(history.begin(), history.end());
+
+      double lambda = 1.0;
+      double f_new = f;
+      bool accepted = false;
+      while (m_NumEvaluations<m_MaxFunctionEvals)
+      {
+        x_new = x + lambda*d;
+        m_Cost.compute(x_new, &f_new, &g_new);
+        ++m_NumEvaluations;
+        if (f_new<=f_max + gamma*lambda*gd)
+        {
+          accepted = true;
+          break;
+        }
+
+        // safeguarded quadratic interpolation of the step length
+        double lambda_q = -0.5*lambda*lambda*gd/(f_new - f - lambda*gd);
+        if (lambda_q<0.1*lambda || lambda_q>0.5*lambda)
+          lambda_q = 0.5*lambda;
+        lambda = lambda_q;
+      }
+      if (!accepted && f_new>=f)
+        break;
+
+      vnl_vector<double> s = x_new - x;
+      vnl_vector<double> y = g_new - g;
+      double sy = dot_product(s, y);
+      alpha = sy>0 ? std::min(alpha_max, std::max(alpha_min, dot_product(s, s)/sy)) : alpha_max;
+
+      x = x_new;
+      g = g_new;
+      f = f_new;
+      history.push_back(f);
+      if (history.size()>history_size)
+        history.pop_front();
+      ++m_NumIterations;
+
+      if (m_Trace)
+        MITK_INFO << "Iteration " << m_NumIterations << ": cost " << f << ", step " << lambda;
+    }
+
+    m_EndError = f;
+    return true;
+  }
+
+protected:
+
+  void project(vnl_vector<double>& x) const
+  {
+    bool upper = m_UpperBound.size()==x.size();
+    for (unsigned int i=0; i<x.size(); ++i)
+    {
+      if (x[i]<0)
+        x[i] = 0;
+      else if (upper && x[i]>m_UpperBound[i])
+        x[i] = m_UpperBound[i];
+    }
+  }
+
+  VnlCostFunction&    m_Cost;
+  vnl_vector<double>  m_UpperBound;
+  int                 m_MaxFunctionEvals;
+  double              m_GradientTolerance;
+  bool                m_Trace;
+  int                 m_NumEvaluations;
+  int                 m_NumIterations;
+  double              m_EndError;
+};
+
 namespace itk{
 
 /**
@@ -327,6 +685,12 @@ public:
   typedef itk::Image<unsigned char, 3>              UcharImgType;
   typedef itk::Image<double, 3>                     DoubleImgType;
 
+  enum SOLVER
+  {
+    LBFGSB,               ///< vnl_lbfgsb with a lower bound of 0
+    PROJECTED_GRADIENT    ///< spectral projected gradient (VnlProjectedGradientMinimizer)
+  };
+
   itkFactorylessNewMacro(Self)
   itkCloneMacro(Self)
   itkTypeMacro( FitFibersToImageFilter, ImageSource )
@@ -351,6 +715,8 @@ public:
   itkGetMacro( FilterOutliers, bool)
   itkSetMacro( Verbose, bool)
   itkGetMacro( Verbose, bool)
+  itkSetMacro( Solver, SOLVER)
+  itkGetMacro( Solver, SOLVER)
 
   itkGetMacro( Weights, vnl_vector<double>)
   itkGetMacro( RmsDiffPerBundle, vnl_vector<double>)
@@ -387,6 +753,8 @@ public:
 
   std::vector<mitk::FiberBundle::Pointer> GetTractograms() const;
 
+  /** The diffusion-weighted system is assembled in parallel only if the model is thread safe (see
+      DiffusionSignalModel::IsThreadSafe()); models drawing random kernels are evaluated in fiber order. */
   void SetSignalModel(mitk::DiffusionSignalModel<> *SignalModel);
 
   VnlCostFunction::REGU GetRegularization() const;
@@ -450,7 +818,7 @@ protected:
 
   mitk::DiffusionSignalModel<>*               m_SignalModel;
 
-  vnl_sparse_matrix<double>                   A;
+  FitFibersSparseMatrix                       A;
   vnl_vector<double>                          b;
   VnlCostFunction                             cost;
   unsigned int                                sz_x;
@@ -462,6 +830,7 @@ protected:
   unsigned int                                fiber_count;
 
   VnlCostFunction::REGU                       m_Regularization;
+  SOLVER                                      m_Solver;
   std::vector<unsigned int>                   m_GroupSizes;
 };
 
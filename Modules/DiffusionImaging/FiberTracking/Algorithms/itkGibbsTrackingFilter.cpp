@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkStandardFileLocations.h>
 #include <mitkFiberBuilder.h>
 #include <mitkMetropolisHastingsSampler.h>
+#include <mitkParallelMetropolisHastingsSampler.h>
 //#include <mitkEnergyComputer.h>
 #include <itkTensorImageToOdfImageFilter.h>
 #include <mitkGibbsEnergyComputer.h>
@@ -37,6 +38,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <boost/progress.hpp>
 #include <mitkLexicalCast.h>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 
 namespace itk{
 
@@ -63,6 +65,9 @@ GibbsTrackingFilter< ItkOdfImageType >::GibbsTrackingFilter():
   m_NumParticles(0),
   m_NumConnections(0),
   m_RandomSeed(-1),
+  m_UseParallelSampler(false),
+  m_BlockSize(2),
+  m_ProposalsPerBlock(16),
   m_LoadParameterFile(""),
   m_LutPath(""),
   m_IsInValidState(true)
@@ -123,7 +128,7 @@ GibbsTrackingFilter< ItkOdfImageType >
     m_BuildFibers = false;
     mitkThrow() << "Unable to load lookup tables.";
   }
-  ParticleGrid* particleGrid = new ParticleGrid(m_MaskImage, m_ParticleLength, m_ParticleGridCellCapacity);
+  ParticleGrid* particleGrid = new ParticleGrid(m_MaskImage, m_ParticleLength);
   GibbsEnergyComputer* encomp = new GibbsEnergyComputer(m_OdfImage, m_MaskImage, particleGrid, interpolator, randGen);
 
   //    EnergyComputer* encomp = new EnergyComputer(m_OdfImage, m_MaskImage, particleGrid, interpolator, randGen);
@@ -247,11 +252,14 @@ void GibbsTrackingFilter< ItkOdfImageType >::GenerateData()
   ParticleGrid* particleGrid;
   GibbsEnergyComputer* encomp;
   MetropolisHastingsSampler* sampler;
+  ParallelMetropolisHastingsSampler* parallelSampler = nullptr;
   try{
-    particleGrid = new ParticleGrid(m_MaskImage, m_ParticleLength, m_ParticleGridCellCapacity);
+    particleGrid = new ParticleGrid(m_MaskImage, m_ParticleLength);
     encomp = new GibbsEnergyComputer(m_OdfImage, m_MaskImage, particleGrid, interpolator, randGen);
     encomp->SetParameters(m_ParticleWeight,m_ParticleWidth,m_ConnectionPotential*m_ParticleLength*m_ParticleLength,m_CurvatureThreshold,m_InexBalance,m_ParticlePotential);
     sampler = new MetropolisHastingsSampler(particleGrid, encomp, randGen, m_CurvatureThreshold);
+    if (m_UseParallelSampler)
+      parallelSampler = new ParallelMetropolisHastingsSampler(particleGrid, encomp, randGen, m_CurvatureThreshold, this->GetNumberOfThreads(), m_BlockSize, m_ProposalsPerBlock);
   }
   catch(...)
   {
@@ -273,6 +281,8 @@ void GibbsTrackingFilter< ItkOdfImageType >::GenerateData()
   MITK_INFO << "Min. fiber length: " << m_MinFiberLength;
   MITK_INFO << "Curvature threshold: " << m_CurvatureThreshold;
   MITK_INFO << "Random seed: " << m_RandomSeed;
+  if (parallelSampler!=nullptr)
+    MITK_INFO << "Parallel sampler: " << this->GetNumberOfThreads() << " threads, " << m_ProposalsPerBlock << " proposals per block of " << m_BlockSize << "^3 grid cells";
   MITK_INFO << "----------------------------------------";
 
   // main loop
@@ -286,17 +296,36 @@ void GibbsTrackingFilter< ItkOdfImageType >::GenerateData()
     while (m_CurrentIteration<m_Iterations)
     {
       just_built_fibers = false;
-      ++disp;
-      m_CurrentIteration++;
-      if (m_AbortTracking)
-        break;
-
-      // update temperatur for simulated annealing process
-      float temperature = m_StartTemperature * exp(alpha*m_CurrentIteration/m_Iterations);
-      sampler->SetTemperature(temperature);
-      sampler->MakeProposal();
+      if (parallelSampler!=nullptr)
+      {
+        if (m_AbortTracking)
+          break;
+
+        // one sweep over all blocks, the temperature is updated once per sweep
+        float temperature = m_StartTemperature * exp(alpha*m_CurrentIteration/m_Iterations);
+        parallelSampler->SetTemperature(temperature);
+        unsigned long proposals = parallelSampler->MakeSweep();
+        if (proposals==0)
+          break;
+        disp += std::min(proposals, (unsigned long)(m_Iterations-m_CurrentIteration));
+        m_CurrentIteration += proposals;
+
+        m_ProposalAcceptance = (float)parallelSampler->GetNumAcceptedProposals()/m_CurrentIteration;
+      }
+      else
+      {
+        ++disp;
+        m_CurrentIteration++;
+        if (m_AbortTracking)
+          break;
+
+        // update temperatur for simulated annealing process
+        float temperature = m_StartTemperature * exp(alpha*m_CurrentIteration/m_Iterations);
+        sampler->SetTemperature(temperature);
+        sampler->MakeProposal();
 
-      m_ProposalAcceptance = (float)sampler->GetNumAcceptedProposals()/m_CurrentIteration;
+        m_ProposalAcceptance = (float)sampler->GetNumAcceptedProposals()/m_CurrentIteration;
+      }
       m_NumParticles = particleGrid->m_NumParticles;
       m_NumConnections = particleGrid->m_NumConnections;
 
@@ -320,6 +349,7 @@ void GibbsTrackingFilter< ItkOdfImageType >::GenerateData()
   }
   clock.Stop();
 
+  delete parallelSampler;
   delete sampler;
   delete encomp;
   delete interpolator;
@@ -71,6 +71,9 @@ public:
     itkSetMacro( CurvatureThreshold, float)         ///< Absolute angular threshold between two particles (in radians).
     itkSetMacro( DuplicateImage, bool )             ///< Work on copy of input image.
     itkSetMacro( RandomSeed, int )                  ///< Seed for random generator.
+    itkSetMacro( UseParallelSampler, bool )         ///< Sample independent blocks of the particle grid in parallel. The result depends on the seed but not on the number of threads.
+    itkSetMacro( BlockSize, int )                   ///< Edge length of the blocks of the parallel sampler in grid cells (at least 2).
+    itkSetMacro( ProposalsPerBlock, int )           ///< Proposals per block and sweep of the parallel sampler.
     itkSetMacro( LoadParameterFile, std::string )   ///< Parameter file.
     itkSetMacro( SaveParameterFile, std::string )
     itkSetMacro( LutPath, std::string )             ///< Path to lookuptables. Default is binary directory.
@@ -86,6 +89,9 @@ public:
     itkGetMacro( CurrentIteration, double)
     itkGetMacro( Iterations, double)
     itkGetMacro( IsInValidState, bool)
+    itkGetMacro( UseParallelSampler, bool )
+    itkGetMacro( BlockSize, int )
+    itkGetMacro( ProposalsPerBlock, int )
     FiberPolyDataType GetFiberBundle();             ///< Output fibers
 
     void SetDicomProperties(mitk::FiberBundle::Pointer fib);
@@ -137,15 +143,15 @@ protected:
     int             m_NumParticles;         ///< current number of particles in grid
     int             m_NumConnections;       ///< current number of connections between particles in grid
     int             m_RandomSeed;           ///< seed value for random generator (-1 for standard seeding)
+    bool            m_UseParallelSampler;   ///< use the domain decomposed parallel sampler
+    int             m_BlockSize;            ///< block edge length of the parallel sampler in grid cells
+    int             m_ProposalsPerBlock;    ///< proposals per block and sweep of the parallel sampler
     std::string     m_LoadParameterFile;    ///< filename of parameter file (reader)
     std::string     m_SaveParameterFile;    ///< filename of parameter file (writer)
     std::string     m_LutPath;              ///< path to lookuptables used by the sphere interpolator
     bool            m_IsInValidState;       ///< Whether the filter is in a valid state, false if error occured
 
     FiberPolyDataType m_FiberPolyData;      ///< container for reconstructed fibers
-
-    //Constant values
-    static const int m_ParticleGridCellCapacity = 1024;
 };
 }
 
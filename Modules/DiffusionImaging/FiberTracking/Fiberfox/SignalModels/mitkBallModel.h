@@ -54,6 +54,7 @@ public:
   /** Actual signal generation **/
   PixelType SimulateMeasurement(GradientType& fiberDirection) override;
   ScalarType SimulateMeasurement(unsigned int dir, GradientType& fiberDirection) override;
+  bool IsThreadSafe() override { return true; }
 
   void SetDiffusivity(double D) { m_Diffusivity = D; }
   double GetDiffusivity() { return m_Diffusivity; }
@@ -54,6 +54,9 @@ public:
     /** Realizes actual signal generation. Has to be implemented in subclass. **/
     virtual PixelType SimulateMeasurement(GradientType& fiberDirection) = 0;
     virtual ScalarType SimulateMeasurement(unsigned int dir, GradientType& fiberDirection) = 0;
+    /** True if SimulateMeasurement only reads the model parameters and can be called from several threads at once.
+        Models that draw random numbers during the simulation are not thread safe. **/
+    virtual bool IsThreadSafe() { return false; }
 
     void SetGradientList(DPH::GradientDirectionsContainerType* gradients)
     {
@@ -50,6 +50,7 @@ public:
   /** Actual signal generation **/
   PixelType SimulateMeasurement(GradientType& fiberDirection) override;
   ScalarType SimulateMeasurement(unsigned int dir, GradientType& fiberDirection) override;
+  bool IsThreadSafe() override { return true; }
 
 protected:
 
@@ -53,6 +53,7 @@ public:
   /** Actual signal generation **/
   PixelType SimulateMeasurement(GradientType& fiberDirection) override;
   ScalarType SimulateMeasurement(unsigned int dir, GradientType& fiberDirection) override;
+  bool IsThreadSafe() override { return true; }
 
   void SetDiffusivity(double diffusivity) { m_Diffusivity = diffusivity; } ///< Scalar diffusion constant
   double GetDiffusivity() { return m_Diffusivity; }
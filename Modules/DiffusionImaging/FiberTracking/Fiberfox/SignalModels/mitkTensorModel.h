@@ -56,6 +56,7 @@ public:
   /** Actual signal generation **/
   PixelType SimulateMeasurement(GradientType& fiberDirection) override;
   ScalarType SimulateMeasurement(unsigned int dir, GradientType& fiberDirection) override;
+  bool IsThreadSafe() override { return true; }
 
   void SetDiffusivity1(double d1){ m_KernelTensorMatrix[0][0] = d1; }
   void SetDiffusivity2(double d2){ m_KernelTensorMatrix[1][1] = d2; }
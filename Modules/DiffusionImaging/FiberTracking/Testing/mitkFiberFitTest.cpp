@@ -40,6 +40,7 @@ class mitkFiberFitTestSuite : public mitk::TestFixture
   MITK_TEST(Fit4);
   MITK_TEST(Fit5);
   MITK_TEST(Fit6);
+  MITK_TEST(FitProjectedGradient);
   CPPUNIT_TEST_SUITE_END();
 
   typedef itk::Image<float, 3> ItkFloatImgType;
@@ -261,6 +262,25 @@ public:
     CompareImages(fitter->GetResidualImage(), "GroupLasso_residual_image.nrrd");
   }
 
+  void FitProjectedGradient()
+  {
+    omp_set_num_threads(1);
+    fitter->SetLambda(0.1);
+    fitter->SetFilterOutliers(false);
+    fitter->SetRegularization(VnlCostFunction::NONE);
+    fitter->SetMaxIterations(200);
+    fitter->Update();
+    double lbfgsb_rmse = fitter->GetRMSE();
+
+    fitter->SetSolver(FitterType::PROJECTED_GRADIENT);
+    fitter->Update();
+    double pg_rmse = fitter->GetRMSE();
+
+    MITK_INFO << "RMSE L-BFGS-B: " << lbfgsb_rmse << ", projected gradient: " << pg_rmse;
+    CPPUNIT_ASSERT_MESSAGE("Weights should be non-negative", fitter->GetMinWeight()>=0);
+    CPPUNIT_ASSERT_MESSAGE("Projected gradient solver should reach the L-BFGS-B residual", pg_rmse<=lbfgsb_rmse*1.01);
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkFiberFit)
@@ -81,6 +81,16 @@ int mitkGibbsTrackingTest(int argc, char* argv[])
     gibbsTracker->Update();
     fib2 = mitk::FiberBundle::New(gibbsTracker->GetFiberBundle());
     MITK_TEST_CONDITION_REQUIRED(!fib1->Equals(fib2), "check if gibbs tracking has changed after wrong seed");
+
+    gibbsTracker->SetUseParallelSampler(true);
+    gibbsTracker->SetRandomSeed(1);
+    gibbsTracker->SetNumberOfThreads(1);
+    gibbsTracker->Update();
+    mitk::FiberBundle::Pointer fib3 = mitk::FiberBundle::New(gibbsTracker->GetFiberBundle());
+    gibbsTracker->SetNumberOfThreads(4);
+    gibbsTracker->Update();
+    fib2 = mitk::FiberBundle::New(gibbsTracker->GetFiberBundle());
+    MITK_TEST_CONDITION_REQUIRED(fib3->Equals(fib2), "check if parallel gibbs tracking is independent of the number of threads");
   }
   catch(...)
   {
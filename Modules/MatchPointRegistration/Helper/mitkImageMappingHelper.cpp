@@ -25,12 +25,22 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkGeometry3D.h>
 #include <mitkImageToItk.h>
 #include <mitkImageTimeSelector.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkPixelTypeMultiplex.h>
 
 #include "mapRegistration.h"
 
 #include "mitkImageMappingHelper.h"
 #include "mitkRegistrationHelper.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
 template <typename TImage >
 typename ::itk::InterpolateImageFunction< TImage >::Pointer generateInterpolator(mitk::ImageMappingInterpolator::Type interpolatorType)
 {
@@ -222,6 +232,301 @@ void doMITKMap(const ::itk::Image<TPixelType,VImageDimension>* input, mitk::Imag
   mitk::CastToMitkImage<>(spTask->getResultImage(),result);
 }
 
+namespace
+{
+  typedef ::map::core::Registration<3, 3> Registration3DType;
+
+  /** Result of evaluating a registration once for every voxel of a result geometry.
+   * For every result voxel it stores where to sample the input volume, so that all
+   * time steps and channels of an input can be mapped without evaluating the
+   * registration (e.g. a deformation field) again.*/
+  struct MappingGrid
+  {
+    enum SampleFlags
+    {
+      StepX = 1, //< the sample has a neighbor in x direction (linear interpolation)
+      StepY = 2,
+      StepZ = 4,
+      OutOfInput = 8, //< the mapped point is not covered by the input
+      MappingError = 16 //< the registration cannot map the point
+    };
+
+    unsigned int size[3];
+    unsigned int inputSize[3];
+    bool linear;
+    double paddingValue;
+    double errorValue;
+
+    /** offset of the (lower) sample voxel in the input volume */
+    std::vector<std::size_t> offsets;
+    /** fractional parts of the continuous input index, only used for linear interpolation */
+    std::vector<float> weights;
+    std::vector<unsigned char> flags;
+  };
+
+  unsigned int GetNumberOfMappingThreads(unsigned int slices)
+  {
+    return std::max(1u, std::min(std::thread::hardware_concurrency(), slices));
+  }
+
+  /** Checks if the input can be mapped by evaluating the registration once into a MappingGrid.
+   * Other cases (e.g. other interpolators or 2D registrations) are mapped frame by frame.*/
+  bool CanMapByGrid(const mitk::Image* input, const mitk::ImageMappingHelper::RegistrationType* registration,
+    mitk::ImageMappingInterpolator::Type interpolatorType)
+  {
+    return (interpolatorType == mitk::ImageMappingInterpolator::NearestNeighbor ||
+            interpolatorType == mitk::ImageMappingInterpolator::Linear) &&
+           input->GetDimension() >= 3 && input->GetPixelType().GetNumberOfComponents() == 1 &&
+           dynamic_cast<const Registration3DType*>(registration) != nullptr;
+  }
+
+  /** Evaluates the inverse mapping of the registration for every voxel of resultGeometry
+   * and converts it into a sample of the input geometry.*/
+  void GenerateMappingGrid(MappingGrid& grid, const Registration3DType* registration,
+    const mitk::BaseGeometry* inputGeometry, const unsigned int* inputSize,
+    const mitk::BaseGeometry* resultGeometry, bool throwOnOutOfInputAreaError, bool throwOnMappingError)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      grid.size[i] = static_cast<unsigned int>(resultGeometry->GetExtent(i));
+      grid.inputSize[i] = inputSize[i];
+    }
+
+    const std::size_t voxelCount = static_cast<std::size_t>(grid.size[0]) * grid.size[1] * grid.size[2];
+    grid.offsets.assign(voxelCount, 0);
+    grid.flags.assign(voxelCount, 0);
+    grid.weights.assign(grid.linear ? 3 * voxelCount : 0, 0.0f);
+
+    const std::size_t inputStrides[3] = { 1, inputSize[0], static_cast<std::size_t>(inputSize[0]) * inputSize[1] };
+
+    //the registration is evaluated serially, because kernels may generate their fields lazily on first use.
+    ::map::core::continuous::Elements<3>::PointType targetPoint;
+    ::map::core::continuous::Elements<3>::PointType movingPoint;
+    mitk::Point3D resultIndex;
+    mitk::Point3D worldPoint;
+    mitk::Point3D inputIndex;
+    std::size_t pos = 0;
+
+    for (unsigned int z = 0; z < grid.size[2]; ++z)
+    {
+      for (unsigned int y = 0; y < grid.size[1]; ++y)
+      {
+        for (unsigned int x = 0; x < grid.size[0]; ++x, ++pos)
+        {
+          resultIndex[0] = x;
+          resultIndex[1] = y;
+          resultIndex[2] = z;
+          resultGeometry->IndexToWorld(resultIndex, worldPoint);
+          targetPoint.CastFrom(worldPoint);
+
+          if (!registration->mapPointInverse(targetPoint, movingPoint))
+          {
+            if (throwOnMappingError)
+            {
+              mitkThrow() << "Cannot map image. Registration does not support the requested region. Point: " << worldPoint;
+            }
+            grid.flags[pos] = MappingGrid::MappingError;
+            continue;
+          }
+
+          worldPoint.CastFrom(movingPoint);
+          inputGeometry->WorldToIndex(worldPoint, inputIndex);
+
+          std::size_t offset = 0;
+          unsigned char flags = 0;
+          for (unsigned int i = 0; i < 3; ++i)
+          {
+            //same coverage as itk::ImageFunction::IsInsideBuffer
+            if (inputIndex[i] < -0.5 || inputIndex[i] >= inputSize[i] - 0.5)
+            {
+              flags = MappingGrid::OutOfInput;
+              break;
+            }
+
+            if (grid.linear)
+            {
+              //same border handling as itk::LinearInterpolateImageFunction
+              long base = static_cast<long>(std::floor(inputIndex[i]));
+              double distance = 0.0;
+              if (base < 0)
+              {
+                base = 0;
+              }
+              else if (base + 1 < static_cast<long>(inputSize[i]))
+              {
+                distance = inputIndex[i] - base;
+              }
+
+              if (distance > 0.0)
+              {
+                flags |= (1 << i);
+              }
+              grid.weights[3 * pos + i] = static_cast<float>(distance);
+              offset += base * inputStrides[i];
+            }
+            else
+            {
+              const long nearest = std::min(static_cast<long>(std::floor(inputIndex[i] + 0.5)), static_cast<long>(inputSize[i]) - 1);
+              offset += std::max(nearest, 0L) * inputStrides[i];
+            }
+          }
+
+          if (flags & MappingGrid::OutOfInput)
+          {
+            if (throwOnOutOfInputAreaError)
+            {
+              mitkThrow() << "Cannot map image. Input image does not cover the requested region. Point: " << worldPoint;
+            }
+          }
+          else
+          {
+            grid.offsets[pos] = offset;
+          }
+          grid.flags[pos] = flags;
+        }
+      }
+    }
+  }
+
+  template <typename TPixelType>
+  TPixelType CastMappedValue(double value)
+  {
+    value = std::max(value, static_cast<double>(std::numeric_limits<TPixelType>::lowest()));
+    value = std::min(value, static_cast<double>(std::numeric_limits<TPixelType>::max()));
+    return static_cast<TPixelType>(value);
+  }
+
+  /** Samples the slices [firstSlice, endSlice) of one input volume with the grid. */
+  template <typename TPixelType>
+  void ApplyMappingGrid(const MappingGrid& grid, const TPixelType* input, TPixelType* result,
+    unsigned int firstSlice, unsigned int endSlice)
+  {
+    const std::size_t sliceSize = static_cast<std::size_t>(grid.size[0]) * grid.size[1];
+    const std::size_t strideY = grid.inputSize[0];
+    const std::size_t strideZ = strideY * grid.inputSize[1];
+    const TPixelType padding = CastMappedValue<TPixelType>(grid.paddingValue);
+    const TPixelType error = CastMappedValue<TPixelType>(grid.errorValue);
+
+    const std::size_t end = endSlice * sliceSize;
+    for (std::size_t pos = firstSlice * sliceSize; pos < end; ++pos)
+    {
+      const unsigned char flags = grid.flags[pos];
+
+      if (flags & MappingGrid::MappingError)
+      {
+        result[pos] = error;
+      }
+      else if (flags & MappingGrid::OutOfInput)
+      {
+        result[pos] = padding;
+      }
+      else if (!grid.linear)
+      {
+        result[pos] = input[grid.offsets[pos]];
+      }
+      else
+      {
+        //missing neighbors have a weight of 0 and are replaced by the sample itself, so no bounds checks are needed
+        const TPixelType* p = input + grid.offsets[pos];
+        const std::size_t dx = (flags & MappingGrid::StepX) ? 1 : 0;
+        const std::size_t dy = (flags & MappingGrid::StepY) ? strideY : 0;
+        const std::size_t dz = (flags & MappingGrid::StepZ) ? strideZ : 0;
+        const double wx = grid.weights[3 * pos];
+        const double wy = grid.weights[3 * pos + 1];
+        const double wz = grid.weights[3 * pos + 2];
+
+        const double v00 = p[0] + wx * (p[dx] - static_cast<double>(p[0]));
+        const double v10 = p[dy] + wx * (p[dy + dx] - static_cast<double>(p[dy]));
+        const double v01 = p[dz] + wx * (p[dz + dx] - static_cast<double>(p[dz]));
+        const double v11 = p[dz + dy] + wx * (p[dz + dy + dx] - static_cast<double>(p[dz + dy]));
+        const double v0 = v00 + wy * (v10 - v00);
+        const double v1 = v01 + wy * (v11 - v01);
+
+        result[pos] = CastMappedValue<TPixelType>(v0 + wz * (v1 - v0));
+      }
+    }
+  }
+
+  /** Maps all volumes (time steps and channels) of the input with the grid.
+   * The threads share the volumes and process a contiguous block of result slices each.*/
+  template <typename TPixelType>
+  void MapVolumesByGrid(const mitk::PixelType&, const MappingGrid* grid, const mitk::Image* input, mitk::Image* result)
+  {
+    std::vector<std::unique_ptr<mitk::ImageReadAccessor> > readAccessors;
+    std::vector<std::unique_ptr<mitk::ImageWriteAccessor> > writeAccessors;
+    std::vector<const TPixelType*> inputVolumes;
+    std::vector<TPixelType*> resultVolumes;
+
+    for (unsigned int t = 0; t < input->GetTimeSteps(); ++t)
+    {
+      for (unsigned int n = 0; n < input->GetNumberOfChannels(); ++n)
+      {
+        readAccessors.emplace_back(new mitk::ImageReadAccessor(input, input->GetVolumeData(t, n)));
+        writeAccessors.emplace_back(new mitk::ImageWriteAccessor(result, result->GetVolumeData(t, n)));
+        inputVolumes.push_back(static_cast<const TPixelType*>(readAccessors.back()->GetData()));
+        resultVolumes.push_back(static_cast<TPixelType*>(writeAccessors.back()->GetData()));
+      }
+    }
+
+    auto mapSlices = [&](unsigned int firstSlice, unsigned int endSlice)
+    {
+      for (std::size_t i = 0; i < inputVolumes.size(); ++i)
+      {
+        ApplyMappingGrid<TPixelType>(*grid, inputVolumes[i], resultVolumes[i], firstSlice, endSlice);
+      }
+    };
+
+    const unsigned int slices = grid->size[2];
+    const unsigned int numberOfThreads = GetNumberOfMappingThreads(slices);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < numberOfThreads; ++i)
+    {
+      threads.emplace_back(mapSlices, i * slices / numberOfThreads, (i + 1) * slices / numberOfThreads);
+    }
+    mapSlices(0, slices / numberOfThreads);
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  /** Maps all time steps and channels of the input by evaluating the registration only once.*/
+  mitk::Image::Pointer MapByGrid(const mitk::Image* input, const mitk::ImageMappingHelper::RegistrationType* registration,
+    bool throwOnOutOfInputAreaError, double paddingValue, const mitk::BaseGeometry* resultGeometry,
+    bool throwOnMappingError, double errorValue, mitk::ImageMappingInterpolator::Type interpolatorType)
+  {
+    const mitk::BaseGeometry* inputGeometry = input->GetGeometry(0);
+    if (!resultGeometry)
+    {
+      resultGeometry = inputGeometry;
+    }
+
+    const unsigned int inputSize[3] = { input->GetDimension(0), input->GetDimension(1), input->GetDimension(2) };
+
+    MappingGrid grid;
+    grid.linear = interpolatorType == mitk::ImageMappingInterpolator::Linear;
+    grid.paddingValue = paddingValue;
+    grid.errorValue = errorValue;
+    GenerateMappingGrid(grid, dynamic_cast<const Registration3DType*>(registration), inputGeometry, inputSize,
+      resultGeometry, throwOnOutOfInputAreaError, throwOnMappingError);
+
+    mitk::TimeGeometry::Pointer mappedTimeGeometry = input->GetTimeGeometry()->Clone();
+    for (unsigned int i = 0; i < input->GetTimeSteps(); ++i)
+    {
+      mitk::BaseGeometry::Pointer mappedGeometry = resultGeometry->Clone();
+      mappedTimeGeometry->SetTimeStepGeometry(mappedGeometry, i);
+    }
+
+    mitk::Image::Pointer result = mitk::Image::New();
+    result->Initialize(input->GetPixelType(), *mappedTimeGeometry, input->GetNumberOfChannels(), input->GetTimeSteps());
+
+    mitkPixelTypeMultiplex3(MapVolumesByGrid, input->GetPixelType(), &grid, input, result.GetPointer());
+
+    return result;
+  }
+}
+
 mitk::ImageMappingHelper::ResultImageType::Pointer
   mitk::ImageMappingHelper::map(const InputImageType* input, const RegistrationType* registration,
   bool throwOnOutOfInputAreaError, const double& paddingValue, const ResultImageGeometryType* resultGeometry,
@@ -242,6 +547,10 @@ mitk::ImageMappingHelper::ResultImageType::Pointer
   { //map the image and done
     AccessByItk_n(input, doMITKMap, (result, registration, throwOnOutOfInputAreaError, paddingValue, resultGeometry, throwOnMappingError, errorValue, interpolatorType));
   }
+  else if (CanMapByGrid(input, registration, interpolatorType))
+  { //evaluate the registration once and resample all time steps with it
+    result = MapByGrid(input, registration, throwOnOutOfInputAreaError, paddingValue, resultGeometry, throwOnMappingError, errorValue, interpolatorType);
+  }
   else
   { //map every time step and compose
 
@@ -65,6 +65,9 @@ namespace mitk
      * @pre Dimensionality of the registration must match with the input imageinput must be valid
      * @remark Depending in the settings of throwOnOutOfInputAreaError and throwOnMappingError it may also throw
      * due to inconsistencies in the mapping process. See parameter description.
+     * @remark Inputs with several time steps that are mapped by a 3D registration with nearest neighbor or linear
+     * interpolation are not mapped frame by frame. The registration is evaluated only once for the result geometry
+     * and the resulting sampling grid is applied (multithreaded) to all time steps and channels.
      * @result Pointer to the resulting mapped image.h*/
     MITKMATCHPOINTREGISTRATION_EXPORT ResultImageType::Pointer map(const InputImageType* input, const RegistrationType* registration,
       bool throwOnOutOfInputAreaError = false, const double& paddingValue = 0,
@@ -23,6 +23,34 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkMaskedAlgorithmHelper.h>
 #include <mitkAlgorithmHelper.h>
 
+#include <mapMetaPropertyAlgorithmInterface.h>
+#include <mapMetaProperty.h>
+
+#include <itkMultiThreader.h>
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace
+{
+  typedef ::map::algorithm::facet::MetaPropertyAlgorithmInterface MetaPropertyInterfaceType;
+
+  template <typename TValueType>
+  bool SetNumberOfThreadsProperty(MetaPropertyInterfaceType* algorithm, const ::map::algorithm::MetaPropertyInfo* info,
+    unsigned int numberOfThreads)
+  {
+    if (info->getTypeInfo() != typeid(TValueType))
+    {
+      return false;
+    }
+
+    ::map::core::MetaPropertyBase::Pointer prop =
+      ::map::core::MetaProperty<TValueType>::New(static_cast<TValueType>(numberOfThreads)).GetPointer();
+    return algorithm->setProperty(info, prop);
+  }
+}
+
 mitk::Image::Pointer
 mitk::TimeFramesRegistrationHelper::GetFrameImage(const mitk::Image* image,
     mitk::TimePointType timePoint) const
@@ -44,7 +72,14 @@ mitk::TimeFramesRegistrationHelper::Generate()
   //prepare processing
   mitk::Image::Pointer targetFrame = GetFrameImage(this->m_4DImage, 0);
 
-  this->m_Registered4DImage = this->m_4DImage->Clone();
+  //the frames are written directly into the result, so only the header of the input is copied
+  this->m_Registered4DImage = mitk::Image::New();
+  this->m_Registered4DImage->Initialize(this->m_4DImage);
+  this->m_Registered4DImage->SetPropertyList(this->m_4DImage->GetPropertyList()->Clone());
+  {
+    mitk::ImageReadAccessor accessor(this->m_4DImage, this->m_4DImage->GetVolumeData(0));
+    this->m_Registered4DImage->SetVolume(accessor.GetData(), 0);
+  }
 
   Image::ConstPointer mask;
 
@@ -60,29 +95,105 @@ mitk::TimeFramesRegistrationHelper::Generate()
     }
   }
 
-  double progressDelta = 1.0 / ((this->m_4DImage->GetTimeSteps() - 1) * 3.0);
+  const unsigned int timeSteps = this->m_4DImage->GetTimeSteps();
+  double progressDelta = 1.0 / ((timeSteps - 1) * 3.0);
   m_Progress = 0.0;
 
-  //process the frames
-  for (unsigned int i = 1; i < this->m_4DImage->GetTimeSteps(); ++i)
+  unsigned int numberOfThreads = 1;
+  if (m_AlgorithmFactory)
+  {
+    numberOfThreads = std::max(1u, std::min(m_NumberOfThreads, timeSteps - 1));
+  }
+
+  if (numberOfThreads == 1)
+  {
+    ProcessFrames(m_Algorithm, 1, timeSteps, targetFrame, mask, progressDelta);
+    return;
+  }
+
+  //every block uses an own instance of the factory, so that the thread limit does not change the configured
+  //algorithm. The instances are created before the threads start, because the factory may not be thread safe.
+  const unsigned int numberOfITKThreads =
+    std::max<unsigned int>(1, itk::MultiThreader::GetGlobalDefaultNumberOfThreads() / numberOfThreads);
+  std::vector<RegistrationAlgorithmPointer> algorithms;
+  for (unsigned int i = 0; i < numberOfThreads; ++i)
   {
-    Image::Pointer movingFrame = GetFrameImage(this->m_4DImage, i);
-    Image::Pointer mappedFrame;
+    algorithms.push_back(CreateAlgorithmInstance(numberOfITKThreads));
+  }
+
+  //contiguous blocks of frames, so that each frame can be warm started with its temporal neighbor
+  const unsigned int frameCount = timeSteps - 1;
+  std::vector<std::thread> threads;
+  std::vector<std::exception_ptr> errors(numberOfThreads);
+  for (unsigned int i = 0; i < numberOfThreads; ++i)
+  {
+    const unsigned int firstFrame = 1 + i * frameCount / numberOfThreads;
+    const unsigned int endFrame = 1 + (i + 1) * frameCount / numberOfThreads;
+
+    threads.emplace_back([this, &algorithms, &errors, &targetFrame, &mask, i, firstFrame, endFrame, progressDelta]()
+    {
+      try
+      {
+        this->ProcessFrames(algorithms[i], firstFrame, endFrame, targetFrame, mask, progressDelta);
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
 
-    IgnoreListType::iterator finding = std::find(m_IgnoreList.begin(), m_IgnoreList.end(), i);
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
 
+  for (const auto& error : errors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+};
+
+void
+mitk::TimeFramesRegistrationHelper::ProcessFrames(RegistrationAlgorithmBaseType* algorithm,
+    unsigned int firstFrame, unsigned int endFrame, const mitk::Image* targetFrame,
+    const mitk::Image* targetMask, double progressDelta)
+{
+  RegistrationPointer neighborReg;
+
+  for (unsigned int i = firstFrame; i < endFrame; ++i)
+  {
+    IgnoreListType::const_iterator finding = std::find(m_IgnoreList.begin(), m_IgnoreList.end(), i);
 
     if (finding == m_IgnoreList.end())
     {
       //frame should be processed
-      RegistrationPointer reg = DoFrameRegistration(movingFrame, targetFrame, mask);
+      Image::Pointer movingFrame;
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        movingFrame = GetFrameImage(this->m_4DImage, i);
+      }
 
-      m_Progress += progressDelta;
-      this->InvokeEvent(::mitk::FrameRegistrationEvent(nullptr,
-                        "Registred frame #" +::map::core::convert::toStr(i)));
+      if (m_WarmStartFunction && neighborReg.IsNotNull())
+      {
+        m_WarmStartFunction(algorithm, neighborReg);
+      }
+
+      RegistrationPointer reg = DoFrameRegistration(algorithm, movingFrame, targetFrame, targetMask);
+
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Progress += progressDelta;
+        this->InvokeEvent(::mitk::FrameRegistrationEvent(nullptr,
+                          "Registred frame #" +::map::core::convert::toStr(i)));
+      }
 
-      mappedFrame = DoFrameMapping(movingFrame, reg, targetFrame);
+      Image::Pointer mappedFrame = DoFrameMapping(movingFrame, reg, targetFrame);
 
+      std::lock_guard<std::mutex> lock(m_Mutex);
       m_Progress += progressDelta;
       this->InvokeEvent(::mitk::FrameMappingEvent(nullptr,
                         "Mapped frame #" + ::map::core::convert::toStr(i)));
@@ -95,16 +206,21 @@ mitk::TimeFramesRegistrationHelper::Generate()
       this->m_Registered4DImage->GetTimeGeometry()->SetTimeStepGeometry(mappedFrame->GetGeometry(), i);
 
       m_Progress += progressDelta;
+      this->InvokeEvent(::itk::ProgressEvent());
+
+      neighborReg = reg;
     }
     else
     {
+      //frame is copied unchanged
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      mitk::ImageReadAccessor accessor(this->m_4DImage, this->m_4DImage->GetVolumeData(i));
+      this->m_Registered4DImage->SetVolume(accessor.GetData(), i);
+
       m_Progress += 3 * progressDelta;
+      this->InvokeEvent(::itk::ProgressEvent());
     }
-
-    this->InvokeEvent(::itk::ProgressEvent());
-
   }
-
 };
 
 mitk::Image::Pointer
@@ -126,6 +242,22 @@ SetIgnoreList(const IgnoreListType& il)
   this->Modified();
 }
 
+void
+mitk::TimeFramesRegistrationHelper::
+SetAlgorithmFactory(const AlgorithmFactoryType& factory)
+{
+  m_AlgorithmFactory = factory;
+  this->Modified();
+}
+
+void
+mitk::TimeFramesRegistrationHelper::
+SetWarmStartFunction(const WarmStartFunctionType& warmStart)
+{
+  m_WarmStartFunction = warmStart;
+  this->Modified();
+}
+
 void
 mitk::TimeFramesRegistrationHelper::ClearIgnoreList()
 {
@@ -138,19 +270,77 @@ mitk::TimeFramesRegistrationHelper::RegistrationPointer
 mitk::TimeFramesRegistrationHelper::DoFrameRegistration(const mitk::Image* movingFrame,
     const mitk::Image* targetFrame, const mitk::Image* targetMask) const
 {
-  mitk::MITKAlgorithmHelper algHelper(m_Algorithm);
+  return DoFrameRegistration(m_Algorithm, movingFrame, targetFrame, targetMask);
+};
+
+mitk::TimeFramesRegistrationHelper::RegistrationPointer
+mitk::TimeFramesRegistrationHelper::DoFrameRegistration(RegistrationAlgorithmBaseType* algorithm,
+    const mitk::Image* movingFrame, const mitk::Image* targetFrame, const mitk::Image* targetMask) const
+{
+  mitk::MITKAlgorithmHelper algHelper(algorithm);
   algHelper.SetAllowImageCasting(true);
   algHelper.SetData(movingFrame, targetFrame);
 
   if (targetMask)
   {
-    mitk::MaskedAlgorithmHelper maskHelper(m_Algorithm);
+    mitk::MaskedAlgorithmHelper maskHelper(algorithm);
     maskHelper.SetMasks(nullptr, targetMask);
   }
 
   return algHelper.GetRegistration();
 };
 
+mitk::TimeFramesRegistrationHelper::RegistrationAlgorithmPointer
+mitk::TimeFramesRegistrationHelper::CreateAlgorithmInstance(unsigned int numberOfITKThreads) const
+{
+  RegistrationAlgorithmPointer algorithm = m_AlgorithmFactory();
+
+  if (algorithm.IsNull())
+  {
+    mitkThrow() << "Cannot register image. Algorithm factory did not create an algorithm.";
+  }
+
+  MetaPropertyInterfaceType* source = dynamic_cast<MetaPropertyInterfaceType*>(m_Algorithm.GetPointer());
+  MetaPropertyInterfaceType* destination = dynamic_cast<MetaPropertyInterfaceType*>(algorithm.GetPointer());
+
+  if (destination)
+  {
+    MetaPropertyInterfaceType::MetaPropertyVectorType infos = destination->getPropertyInfos();
+    for (const auto& info : infos)
+    {
+      if (!info->isWritable())
+      {
+        continue;
+      }
+
+      if (info->getName() == "NumberOfThreads")
+      {
+        //the instances share the ITK threads instead of each using the global default
+        const bool isSet = SetNumberOfThreadsProperty<unsigned int>(destination, info, numberOfITKThreads) ||
+          SetNumberOfThreadsProperty<int>(destination, info, numberOfITKThreads) ||
+          SetNumberOfThreadsProperty<unsigned long>(destination, info, numberOfITKThreads) ||
+          SetNumberOfThreadsProperty<long>(destination, info, numberOfITKThreads);
+        if (!isSet)
+        {
+          MITK_WARN << "Cannot limit the threads of the algorithm instance. Unsupported type of property NumberOfThreads: "
+                    << info->getTypeInfo().name();
+        }
+      }
+      else if (source && info->isReadable())
+      {
+        //use the configuration of the algorithm for all instances
+        MetaPropertyInterfaceType::MetaPropertyPointer prop = source->getProperty(info);
+        if (prop)
+        {
+          destination->setProperty(info, prop);
+        }
+      }
+    }
+  }
+
+  return algorithm;
+};
+
 mitk::Image::Pointer mitk::TimeFramesRegistrationHelper::DoFrameMapping(
   const mitk::Image* movingFrame, const RegistrationType* reg, const mitk::Image* targetFrame) const
 {
@@ -28,6 +28,9 @@
 
 #include "MitkMatchPointRegistrationExports.h"
 
+#include <functional>
+#include <mutex>
+
 namespace mitk
 {
 
@@ -43,6 +46,21 @@ namespace mitk
    * - mitk::FrameRegistrationEvent: when ever a frame was registered.
    * - mitk::FrameMappingEvent: when ever a frame was mapped registered.
    * - itk::ProgressEvent: when ever a new frame was added to the result image.
+   *
+   * If an algorithm factory is set and the number of threads is larger than one, the frames are registered
+   * concurrently. The frames are split into contiguous blocks, one per thread, and each thread registers its
+   * block with an own algorithm instance created by the factory. The meta properties of the algorithm set via
+   * SetAlgorithm() are copied to these instances. In this mode the events are invoked from the worker threads,
+   * but never concurrently. As the ITK filters of each instance are multi threaded as well, the global default
+   * number of ITK threads is divided among the instances. This is done per instance via the meta property
+   * "NumberOfThreads", if the algorithm offers it; algorithms without that property keep their own threading.
+   * The algorithm set via SetAlgorithm() is not changed in this mode.
+   * If a warm start function is set, it is called before a frame is registered with the algorithm instance
+   * and the registration of the previously registered frame of the same block, so that the registration
+   * can be initialized with the result of its temporal neighbor. MatchPoint offers no generic way to
+   * initialize an algorithm with a registration, therefore this is left to the (algorithm specific) function.
+   * With a warm start function the result depends on the number of threads, because the first frame of each
+   * block has no neighbor.
    */
   class MITKMATCHPOINTREGISTRATION_EXPORT TimeFramesRegistrationHelper : public itk::Object
   {
@@ -58,6 +76,11 @@ namespace mitk
 
     typedef std::vector<mitk::TimeStepType> IgnoreListType;
 
+    /** Creates a new, unconfigured instance of the registration algorithm.*/
+    typedef std::function<RegistrationAlgorithmPointer()> AlgorithmFactoryType;
+    /** Initializes the algorithm with the registration of the neighboring frame.*/
+    typedef std::function<void(RegistrationAlgorithmBaseType*, const RegistrationType*)> WarmStartFunctionType;
+
     itkSetConstObjectMacro(4DImage, Image);
     itkGetConstObjectMacro(4DImage, Image);
 
@@ -82,6 +105,14 @@ namespace mitk
     itkSetMacro(InterpolatorType, mitk::ImageMappingInterpolator::Type);
     itkGetConstMacro(InterpolatorType, mitk::ImageMappingInterpolator::Type);
 
+    /** Number of frames that are registered concurrently. Only relevant if an algorithm factory is set.
+     * Default is 1.*/
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    void SetAlgorithmFactory(const AlgorithmFactoryType& factory);
+    void SetWarmStartFunction(const WarmStartFunctionType& warmStart);
+
     /** cleares the ignore list. Therefore all frames will be processed.*/
     void ClearIgnoreList();
     void SetIgnoreList(const IgnoreListType& il);
@@ -114,6 +145,7 @@ namespace mitk
       m_AllowUnregPixels(true),
       m_ErrorValue(0),
       m_InterpolatorType(mitk::ImageMappingInterpolator::Linear),
+      m_NumberOfThreads(1),
       m_Progress(0)
     {
       m_4DImage = nullptr;
@@ -126,6 +158,9 @@ namespace mitk
     RegistrationPointer DoFrameRegistration(const mitk::Image* movingFrame,
                                             const mitk::Image* targetFrame, const mitk::Image* targetMask) const;
 
+    RegistrationPointer DoFrameRegistration(RegistrationAlgorithmBaseType* algorithm, const mitk::Image* movingFrame,
+                                            const mitk::Image* targetFrame, const mitk::Image* targetMask) const;
+
     mitk::Image::Pointer DoFrameMapping(const mitk::Image* movingFrame, const RegistrationType* reg,
                                         const mitk::Image* targetFrame) const;
 
@@ -136,6 +171,15 @@ namespace mitk
 
     mitk::Image::Pointer GetFrameImage(const mitk::Image* image, mitk::TimePointType timePoint) const;
 
+    /** Registers (or copies, if ignored) the frames [firstFrame, endFrame) with the passed algorithm
+    * and stores them in the result image.*/
+    void ProcessFrames(RegistrationAlgorithmBaseType* algorithm, unsigned int firstFrame, unsigned int endFrame,
+                       const mitk::Image* targetFrame, const mitk::Image* targetMask, double progressDelta);
+
+    /** Creates an algorithm instance with the factory and copies the meta properties of m_Algorithm.
+    * If the instance offers the meta property "NumberOfThreads", it is set to numberOfITKThreads.*/
+    RegistrationAlgorithmPointer CreateAlgorithmInstance(unsigned int numberOfITKThreads) const;
+
     RegistrationAlgorithmPointer m_Algorithm;
 
   private:
@@ -156,7 +200,15 @@ namespace mitk
     /** Type of interpolator. Only relevant for images and if m_doGeometryRefinement is false. */
     mitk::ImageMappingInterpolator::Type m_InterpolatorType;
 
+    AlgorithmFactoryType m_AlgorithmFactory;
+    WarmStartFunctionType m_WarmStartFunction;
+    unsigned int m_NumberOfThreads;
+
     double m_Progress;
+
+    /** Serializes the access to the input image, the result image, the progress and the events
+    * if the frames are registered concurrently.*/
+    std::mutex m_Mutex;
   };
 
 }
@@ -1,3 +1,4 @@
 SET(MODULE_TESTS
+  mitkImageMappingHelperTest.cpp
   mitkTimeFramesRegistrationHelperTest.cpp
 )
\ No newline at end of file
@@ -0,0 +1,119 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+#include "mitkImageMappingHelper.h"
+#include "mitkAlgorithmHelper.h"
+
+#include <mitkImageGenerator.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageTimeSelector.h>
+
+#include <cstdlib>
+
+class mitkImageMappingHelperTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageMappingHelperTestSuite);
+  MITK_TEST(map_DynamicImage_Identity);
+  MITK_TEST(map_DynamicImage_EqualsFramewiseMapping);
+  CPPUNIT_TEST_SUITE_END();
+private:
+  mitk::Image::Pointer dynamicImage;
+  mitk::MAPRegistrationWrapper::Pointer identityReg;
+
+  mitk::Image::Pointer GetFrame(const mitk::Image* image, unsigned int timeStep) const
+  {
+    mitk::ImageTimeSelector::Pointer selector = mitk::ImageTimeSelector::New();
+    selector->SetInput(image);
+    selector->SetTimeNr(timeStep);
+    selector->UpdateLargestPossibleRegion();
+    return selector->GetOutput();
+  }
+
+  void AssertEqualVolumes(const mitk::Image* expected, unsigned int expectedTimeStep,
+                          const mitk::Image* actual, unsigned int actualTimeStep, int tolerance) const
+  {
+    mitk::ImageReadAccessor expectedAccess(expected, expected->GetVolumeData(expectedTimeStep));
+    mitk::ImageReadAccessor actualAccess(actual, actual->GetVolumeData(actualTimeStep));
+    const short* expectedValues = static_cast<const short*>(expectedAccess.GetData());
+    const short* actualValues = static_cast<const short*>(actualAccess.GetData());
+
+    const unsigned int count = expected->GetDimension(0) * expected->GetDimension(1) * expected->GetDimension(2);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      CPPUNIT_ASSERT(std::abs(expectedValues[i] - actualValues[i]) <= tolerance);
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    dynamicImage = mitk::ImageGenerator::GenerateRandomImage<short>(8, 7, 5, 3, 1, 1, 1, 1000, 0);
+    identityReg = mitk::GenerateIdentityRegistration3D();
+  }
+
+  void tearDown() override
+  {
+    dynamicImage = nullptr;
+    identityReg = nullptr;
+  }
+
+  void map_DynamicImage_Identity()
+  {
+    const mitk::ImageMappingInterpolator::Type interpolators[] = { mitk::ImageMappingInterpolator::NearestNeighbor,
+                                                                   mitk::ImageMappingInterpolator::Linear };
+
+    for (auto interpolator : interpolators)
+    {
+      mitk::Image::Pointer result = mitk::ImageMappingHelper::map(dynamicImage, identityReg->GetRegistration(),
+        false, 0, dynamicImage->GetGeometry(), true, 0, interpolator);
+
+      CPPUNIT_ASSERT_EQUAL(dynamicImage->GetTimeSteps(), result->GetTimeSteps());
+      for (unsigned int t = 0; t < dynamicImage->GetTimeSteps(); ++t)
+      {
+        AssertEqualVolumes(dynamicImage, t, result, t, 0);
+      }
+    }
+  }
+
+  void map_DynamicImage_EqualsFramewiseMapping()
+  {
+    //shifted result grid, so that the values are interpolated and the border is padded
+    mitk::BaseGeometry::Pointer resultGeometry = dynamicImage->GetGeometry()->Clone();
+    mitk::Point3D origin = resultGeometry->GetOrigin();
+    origin[0] += 0.5;
+    origin[1] += 0.25;
+    resultGeometry->SetOrigin(origin);
+
+    mitk::Image::Pointer result = mitk::ImageMappingHelper::map(dynamicImage, identityReg->GetRegistration(),
+      false, -1, resultGeometry, true, 0, mitk::ImageMappingInterpolator::Linear);
+
+    for (unsigned int t = 0; t < dynamicImage->GetTimeSteps(); ++t)
+    {
+      mitk::Image::Pointer frame = GetFrame(dynamicImage, t);
+      mitk::Image::Pointer mappedFrame = mitk::ImageMappingHelper::map(frame, identityReg->GetRegistration(),
+        false, -1, resultGeometry, true, 0, mitk::ImageMappingInterpolator::Linear);
+
+      //the weights of the grid are stored with single precision
+      AssertEqualVolumes(mappedFrame, 0, result, t, 1);
+    }
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageMappingHelper)
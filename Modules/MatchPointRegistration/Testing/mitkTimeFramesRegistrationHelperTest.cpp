@@ -18,6 +18,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkTestFixture.h"
 
 #include "mitkTimeFramesRegistrationHelper.h"
+#include "mitkFastSymmetricForcesDemonsMultiResDefaultRegistrationAlgorithm.h"
+
+#include <mitkImageReadAccessor.h>
+#include <mitkImageTimeSelector.h>
+
+#include <itkMultiThreader.h>
+
+#include <mapDiscreteElements.h>
+
+#include <cmath>
+#include <mutex>
+#include <vector>
 
 class mitkTimeFramesRegistrationHelperTestSuite : public mitk::TestFixture
 {
@@ -29,11 +41,56 @@ class mitkTimeFramesRegistrationHelperTestSuite : public mitk::TestFixture
   MITK_TEST(SetAllowUnregPixels_GetAllowUnregPixels);
   MITK_TEST(SetInterpolatorType_GetInterpolatorType);
   MITK_TEST(Set_Get_Clear_IgnoreList);
+  MITK_TEST(SetNumberOfThreads_GetNumberOfThreads);
+  MITK_TEST(GenerateConcurrently_EqualsSequentialResult);
+  MITK_TEST(WarmStart_UsesRegistrationOfNeighborFrame);
   CPPUNIT_TEST_SUITE_END();
 private:
+  typedef map::core::discrete::Elements<3>::InternalImageType InternalImageType;
+  typedef mitk::FastSymmetricForcesDemonsMultiResDefaultRegistrationAlgorithm<InternalImageType> AlgorithmType;
+
   mitk::TimeFramesRegistrationHelper::Pointer frameRegHelper;
   mitk::TimeFramesRegistrationHelper::IgnoreListType ignoreList;
 
+  /** Generates a 4D image with a gaussian blob that moves along x from frame to frame.*/
+  mitk::Image::Pointer GenerateMovingBlobImage(unsigned int size, unsigned int timeSteps) const
+  {
+    unsigned int dims[4] = { size, size, size, timeSteps };
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 4, dims);
+
+    std::vector<float> volume(size * size * size);
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      const double center = size / 2.0 + t * 0.5;
+      for (unsigned int z = 0; z < size; ++z)
+      {
+        for (unsigned int y = 0; y < size; ++y)
+        {
+          for (unsigned int x = 0; x < size; ++x)
+          {
+            const double dx = x - center;
+            const double dy = y - size / 2.0;
+            const double dz = z - size / 2.0;
+            volume[(z * size + y) * size + x] = 100.f * std::exp(-(dx * dx + dy * dy + dz * dz) / 8.0);
+          }
+        }
+      }
+      image->SetVolume(volume.data(), t);
+    }
+
+    return image;
+  }
+
+  mitk::Image::Pointer GetFrame(const mitk::Image* image, unsigned int timeStep) const
+  {
+    mitk::ImageTimeSelector::Pointer selector = mitk::ImageTimeSelector::New();
+    selector->SetInput(image);
+    selector->SetTimeNr(timeStep);
+    selector->UpdateLargestPossibleRegion();
+    return selector->GetOutput();
+  }
+
 public:
   void setUp() override
   {
@@ -106,6 +163,112 @@ public:
     CPPUNIT_ASSERT(frameRegHelper->GetIgnoreList().empty());
   }
 
+  void SetNumberOfThreads_GetNumberOfThreads()
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on default value", 1u,
+                                 frameRegHelper->GetNumberOfThreads());
+    frameRegHelper->SetNumberOfThreads(4);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on changed value", 4u,
+                                 frameRegHelper->GetNumberOfThreads());
+  }
+
+  void GenerateConcurrently_EqualsSequentialResult()
+  {
+    //one ITK thread per filter, so that the registrations of both runs are bitwise reproducible
+    const itk::ThreadIdType oldNumberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads(1);
+
+    mitk::Image::Pointer image = GenerateMovingBlobImage(16, 5);
+    mitk::TimeFramesRegistrationHelper::IgnoreListType frameIgnoreList;
+    frameIgnoreList.push_back(2);
+
+    mitk::TimeFramesRegistrationHelper::Pointer sequentialHelper = mitk::TimeFramesRegistrationHelper::New();
+    sequentialHelper->Set4DImage(image);
+    sequentialHelper->SetAlgorithm(AlgorithmType::New().GetPointer());
+    sequentialHelper->SetIgnoreList(frameIgnoreList);
+    mitk::Image::Pointer sequentialResult = sequentialHelper->GetRegisteredImage();
+
+    //3 threads for the frames 1 to 4: one block only contains the ignored frame
+    mitk::TimeFramesRegistrationHelper::Pointer concurrentHelper = mitk::TimeFramesRegistrationHelper::New();
+    concurrentHelper->Set4DImage(image);
+    concurrentHelper->SetAlgorithm(AlgorithmType::New().GetPointer());
+    concurrentHelper->SetIgnoreList(frameIgnoreList);
+    concurrentHelper->SetNumberOfThreads(3);
+    concurrentHelper->SetAlgorithmFactory([]()
+    {
+      return mitk::TimeFramesRegistrationHelper::RegistrationAlgorithmPointer(AlgorithmType::New().GetPointer());
+    });
+    mitk::Image::Pointer concurrentResult = concurrentHelper->GetRegisteredImage();
+
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads(oldNumberOfThreads);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check number of frames of the concurrent result", image->GetTimeSteps(),
+                                 concurrentResult->GetTimeSteps());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check global number of ITK threads is unchanged", oldNumberOfThreads,
+                                 itk::MultiThreader::GetGlobalDefaultNumberOfThreads());
+
+    for (unsigned int t = 0; t < image->GetTimeSteps(); ++t)
+    {
+      mitk::Image::Pointer sequentialFrame = GetFrame(sequentialResult, t);
+      mitk::Image::Pointer concurrentFrame = GetFrame(concurrentResult, t);
+      CPPUNIT_ASSERT_MESSAGE("Check concurrent frame equals sequential frame #" + std::to_string(t),
+                             mitk::Equal(*sequentialFrame, *concurrentFrame, mitk::eps, true));
+    }
+
+    mitk::Image::Pointer inputFrame = GetFrame(image, 2);
+    mitk::Image::Pointer ignoredFrame = GetFrame(concurrentResult, 2);
+    CPPUNIT_ASSERT_MESSAGE("Check ignored frame is copied unchanged",
+                           mitk::Equal(*inputFrame, *ignoredFrame, 0, true));
+  }
+
+  void WarmStart_UsesRegistrationOfNeighborFrame()
+  {
+    const itk::ThreadIdType oldNumberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads(1);
+
+    mitk::Image::Pointer image = GenerateMovingBlobImage(16, 5);
+    mitk::TimeFramesRegistrationHelper::IgnoreListType frameIgnoreList;
+    frameIgnoreList.push_back(2);
+
+    std::mutex warmStartMutex;
+    std::vector<const mitk::TimeFramesRegistrationHelper::RegistrationType*> neighborRegs;
+    auto warmStart = [&warmStartMutex, &neighborRegs](mitk::TimeFramesRegistrationHelper::RegistrationAlgorithmBaseType*,
+      const mitk::TimeFramesRegistrationHelper::RegistrationType* neighborReg)
+    {
+      std::lock_guard<std::mutex> lock(warmStartMutex);
+      neighborRegs.push_back(neighborReg);
+    };
+
+    //sequentially the frames 1, 3 and 4 are registered, 3 and 4 have a registered neighbor
+    mitk::TimeFramesRegistrationHelper::Pointer sequentialHelper = mitk::TimeFramesRegistrationHelper::New();
+    sequentialHelper->Set4DImage(image);
+    sequentialHelper->SetAlgorithm(AlgorithmType::New().GetPointer());
+    sequentialHelper->SetIgnoreList(frameIgnoreList);
+    sequentialHelper->SetWarmStartFunction(warmStart);
+    sequentialHelper->GetRegisteredImage();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check number of sequential warm starts", std::size_t(2), neighborRegs.size());
+
+    //with 2 threads the blocks are the frames 1 and 2 (ignored) and the frames 3 and 4. Only frame 4 has a neighbor.
+    neighborRegs.clear();
+    mitk::TimeFramesRegistrationHelper::Pointer concurrentHelper = mitk::TimeFramesRegistrationHelper::New();
+    concurrentHelper->Set4DImage(image);
+    concurrentHelper->SetAlgorithm(AlgorithmType::New().GetPointer());
+    concurrentHelper->SetIgnoreList(frameIgnoreList);
+    concurrentHelper->SetNumberOfThreads(2);
+    concurrentHelper->SetAlgorithmFactory([]()
+    {
+      return mitk::TimeFramesRegistrationHelper::RegistrationAlgorithmPointer(AlgorithmType::New().GetPointer());
+    });
+    concurrentHelper->SetWarmStartFunction(warmStart);
+    concurrentHelper->GetRegisteredImage();
+
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads(oldNumberOfThreads);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check number of concurrent warm starts", std::size_t(1), neighborRegs.size());
+    CPPUNIT_ASSERT_MESSAGE("Check neighbor registration is valid", neighborRegs.front() != nullptr);
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkTimeFramesRegistrationHelper)
\ No newline at end of file
@@ -80,6 +80,9 @@ public:
   mitk::TimeFramesRegistrationHelper::IgnoreListType m_IgnoreList;
   mitk::NodeUIDType m_TargetDataUID;
   mitk::NodeUIDType m_TargetMaskDataUID;
+  /** If set, the frames are registered concurrently with m_NumberOfThreads instances created by the factory.*/
+  mitk::TimeFramesRegistrationHelper::AlgorithmFactoryType m_AlgorithmFactory;
+  unsigned int m_NumberOfThreads;
 
   const map::algorithm::RegistrationAlgorithmBase *GetLoadedAlgorithm() const;
 
@@ -64,6 +64,7 @@ set(CPP_FILES
 
 set(TPP_FILES
     include/itkMultiOutputNaryFunctorImageFilter.tpp
+    include/itkMultiOutputTimeSeriesFunctorImageFilter.tpp
     include/itkMaskedStatisticsImageFilter.hxx
     include/itkMaskedNaryStatisticsImageFilter.hxx
 	include/mitkModelFitProviderBase.tpp
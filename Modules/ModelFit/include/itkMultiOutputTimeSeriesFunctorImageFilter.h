@@ -0,0 +1,147 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __itkMultiOutputTimeSeriesFunctorImageFilter_h
+#define __itkMultiOutputTimeSeriesFunctorImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkArray.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class MultiOutputTimeSeriesFunctorImageFilter
+ * \brief Perform a generic voxel-wise operation on the time series of a dynamic image and produces m output images.
+ *
+ * The filter offers the same functor interface as itk::MultiOutputNaryFunctorImageFilter, but takes
+ * the dynamic image directly as one input with the time as its last dimension (e.g. a 4D image for
+ * 3D outputs), instead of one input image per time frame. This avoids extracting (and copying) every
+ * time frame before the operation.\n
+ * The voxels of the output region are processed line by line. For every line, the time series of
+ * all voxels are gathered into voxel-major, time-contiguous arrays; each time step is a contiguous
+ * read of one line of the input buffer. Lines without any voxel inside the mask are not gathered at all.
+ * The functor is then called once per line with the time series and indices of all (masked) voxels of the line,
+ * so that it can process them as one batch (e.g. fit them together). Thus in addition to the interface of
+ * itk::MultiOutputNaryFunctorImageFilter, the functor must offer the batch operator
+ * std::vector<OutputPixelArrayType> operator()(const std::vector<InputPixelArrayType>&, const std::vector<IndexType>&),
+ * that returns the results in the order of the passed voxels.
+ *
+ * \ingroup IntensityImageFilters MultiThreaded
+ */
+
+template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage = ::itk::Image<unsigned char, TOutputImage::ImageDimension> >
+class ITK_EXPORT MultiOutputTimeSeriesFunctorImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+
+{
+public:
+  /** Standard class typedefs. */
+  typedef MultiOutputTimeSeriesFunctorImageFilter         Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MultiOutputTimeSeriesFunctorImageFilter, ImageToImageFilter);
+
+  /** Some typedefs. */
+  typedef TFunction                            FunctorType;
+  typedef TInputImage                          InputImageType;
+  typedef typename InputImageType::Pointer     InputImagePointer;
+  typedef typename InputImageType::RegionType  InputImageRegionType;
+  typedef typename InputImageType::PixelType   InputImagePixelType;
+  typedef TOutputImage                         OutputImageType;
+  typedef typename OutputImageType::Pointer    OutputImagePointer;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+  typedef typename OutputImageType::PixelType  OutputImagePixelType;
+  typedef typename FunctorType::InputPixelArrayType     SignalArrayType;
+  typedef typename FunctorType::OutputPixelArrayType    OutputArrayType;
+  typedef std::vector<SignalArrayType>                  SignalArrayBatchType;
+  typedef std::vector<OutputArrayType>                  OutputArrayBatchType;
+  typedef std::vector<typename OutputImageType::IndexType> IndexBatchType;
+  typedef TMaskImage MaskImageType;
+  typedef typename MaskImageType::Pointer     MaskImagePointer;
+  typedef typename MaskImageType::RegionType  MaskImageRegionType;
+
+  /** Get the functor object.  The functor is returned by reference.
+   * (Functors do not have to derive from itk::LightObject, so they do
+   * not necessarily have a reference count. So we cannot return a
+   * SmartPointer). */
+  FunctorType & GetFunctor() { return m_Functor; }
+
+  /** Set the functor object.  This replaces the current Functor with a
+   * copy of the specified Functor. This method requires an operator!=()
+   * be defined on the functor. */
+  void SetFunctor(FunctorType & functor)
+  {
+    if ( m_Functor != functor )
+      {
+      m_Functor = functor;
+      this->ActualizeOutputs();
+      this->Modified();
+      }
+  }
+
+  itkSetObjectMacro(Mask, MaskImageType);
+  itkGetConstObjectMacro(Mask, MaskImageType);
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(
+    InputImageDimension, unsigned int, TInputImage::ImageDimension);
+  itkStaticConstMacro(
+    OutputImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro( TimeDimensionCheck,
+                   ( Concept::SameDimension< InputImageDimension, OutputImageDimension + 1 > ) );
+  itkConceptMacro( OutputHasZeroCheck,
+                   ( Concept::HasZero< OutputImagePixelType > ) );
+  /** End concept checking */
+#endif
+protected:
+  MultiOutputTimeSeriesFunctorImageFilter();
+  virtual ~MultiOutputTimeSeriesFunctorImageFilter() {}
+
+  /** The outputs have the geometry of the input without its last (time) dimension.*/
+  virtual void GenerateOutputInformation() override;
+
+  /** The complete time series of the requested output region is needed.*/
+  virtual void GenerateInputRequestedRegion() override;
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) override;
+
+  /** Methods actualize the output settings of the filter according to the current functor*/
+  void ActualizeOutputs();
+
+private:
+  MultiOutputTimeSeriesFunctorImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);         //purposely not implemented
+
+  FunctorType m_Functor;
+  MaskImagePointer m_Mask;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMultiOutputTimeSeriesFunctorImageFilter.tpp"
+#endif
+
+#endif
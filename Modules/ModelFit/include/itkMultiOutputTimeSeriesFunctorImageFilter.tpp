@@ -0,0 +1,250 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __itkMultiOutputTimeSeriesFunctorImageFilter_hxx
+#define __itkMultiOutputTimeSeriesFunctorImageFilter_hxx
+
+#include "itkMultiOutputTimeSeriesFunctorImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+  /**
+  * Constructor
+  */
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  MultiOutputTimeSeriesFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::MultiOutputTimeSeriesFunctorImageFilter()
+  {
+    this->SetNumberOfRequiredInputs(1);
+
+    this->ActualizeOutputs();
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputTimeSeriesFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::ActualizeOutputs()
+  {
+    this->SetNumberOfRequiredOutputs(m_Functor.GetNumberOfOutputs());
+
+    for (typename Superclass::DataObjectPointerArraySizeType i = this->GetNumberOfIndexedOutputs(); i< m_Functor.GetNumberOfOutputs(); ++i)
+    {
+      this->SetNthOutput( i, this->MakeOutput(i) );
+    }
+
+    while(this->GetNumberOfIndexedOutputs() > m_Functor.GetNumberOfOutputs())
+    {
+      this->RemoveOutput(this->GetNumberOfIndexedOutputs()-1);
+    }
+  };
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputTimeSeriesFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::GenerateOutputInformation()
+  {
+    const InputImageType* input = this->GetInput();
+    if (!input)
+    {
+      return;
+    }
+
+    const InputImageRegionType& inputRegion = input->GetLargestPossibleRegion();
+
+    OutputImageRegionType outputRegion;
+    typename OutputImageType::SpacingType spacing;
+    typename OutputImageType::PointType origin;
+    typename OutputImageType::DirectionType direction;
+
+    for (unsigned int i = 0; i < OutputImageDimension; ++i)
+    {
+      outputRegion.SetIndex(i, inputRegion.GetIndex(i));
+      outputRegion.SetSize(i, inputRegion.GetSize(i));
+      spacing[i] = input->GetSpacing()[i];
+      origin[i] = input->GetOrigin()[i];
+      for (unsigned int j = 0; j < OutputImageDimension; ++j)
+      {
+        direction[i][j] = input->GetDirection()[i][j];
+      }
+    }
+
+    for (unsigned int i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
+    {
+      OutputImageType* output = this->GetOutput(i);
+      if (output)
+      {
+        output->SetLargestPossibleRegion(outputRegion);
+        output->SetSpacing(spacing);
+        output->SetOrigin(origin);
+        output->SetDirection(direction);
+      }
+    }
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputTimeSeriesFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::GenerateInputRequestedRegion()
+  {
+    InputImageType* input = const_cast<InputImageType*>(this->GetInput());
+    if (!input)
+    {
+      return;
+    }
+
+    const OutputImageRegionType& outputRegion = this->GetOutput()->GetRequestedRegion();
+    InputImageRegionType inputRegion = input->GetLargestPossibleRegion();
+
+    for (unsigned int i = 0; i < OutputImageDimension; ++i)
+    {
+      inputRegion.SetIndex(i, outputRegion.GetIndex(i));
+      inputRegion.SetSize(i, outputRegion.GetSize(i));
+    }
+
+    input->SetRequestedRegion(inputRegion);
+  }
+
+  /**
+  * ThreadedGenerateData gathers the time series line by line and calls the functor once per line
+  */
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputTimeSeriesFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId)
+  {
+    ProgressReporter progress( this, threadId,
+      outputRegionForThread.GetNumberOfPixels() );
+
+    const InputImageType* input = this->GetInput();
+
+    const unsigned int numberOfOutputImages =
+      static_cast< unsigned int >( this->GetNumberOfIndexedOutputs() );
+
+    if (numberOfOutputImages == 0 || outputRegionForThread.GetNumberOfPixels() == 0)
+    {
+      return;
+    }
+
+    if (m_Mask.IsNotNull())
+    {
+      if (!m_Mask->GetLargestPossibleRegion().IsInside(outputRegionForThread))
+      {
+        itkExceptionMacro("Mask of filter is set but does not cover region of thread. Mask region: "<< m_Mask->GetLargestPossibleRegion() <<"Thread region: "<<outputRegionForThread)
+      }
+    }
+
+    std::vector< OutputImageType * > outputs;
+    outputs.reserve(numberOfOutputImages);
+    for ( unsigned int i = 0; i < numberOfOutputImages; ++i )
+    {
+      outputs.push_back(this->GetOutput(i));
+    }
+
+    const InputImageRegionType& inputRegion = input->GetRequestedRegion();
+    const SizeValueType numberOfTimeSteps = inputRegion.GetSize(OutputImageDimension);
+    const IndexValueType firstTimeStep = inputRegion.GetIndex(OutputImageDimension);
+    const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+    const InputImagePixelType* inputBuffer = input->GetBufferPointer();
+
+    //voxel-major, time-contiguous signals of the masked voxels of one line
+    SignalArrayBatchType signals;
+    IndexBatchType indices;
+    std::vector<SizeValueType> positions;
+    signals.reserve(lineLength);
+    indices.reserve(lineLength);
+    positions.reserve(lineLength);
+    OutputArrayType invalidResult(numberOfOutputImages, 0.0);
+
+    //iterate over the first index of every line of the thread region
+    OutputImageRegionType lineStartRegion = outputRegionForThread;
+    lineStartRegion.SetSize(0, 1);
+    ImageRegionConstIteratorWithIndex< OutputImageType > lineIter(outputs.front(), lineStartRegion);
+
+    for (; !lineIter.IsAtEnd(); ++lineIter)
+    {
+      const typename OutputImageType::IndexType lineIndex = lineIter.GetIndex();
+
+      indices.clear();
+      positions.clear();
+      typename OutputImageType::IndexType voxelIndex = lineIndex;
+      for (SizeValueType x = 0; x < lineLength; ++x)
+      {
+        voxelIndex[0] = lineIndex[0] + x;
+        if (m_Mask.IsNull() || m_Mask->GetPixel(voxelIndex) > 0)
+        {
+          indices.push_back(voxelIndex);
+          positions.push_back(x);
+        }
+      }
+
+      OutputArrayBatchType results;
+
+      if (!indices.empty())
+      {
+        signals.resize(indices.size(), SignalArrayType(numberOfTimeSteps));
+
+        typename InputImageType::IndexType inputIndex;
+        for (unsigned int i = 0; i < OutputImageDimension; ++i)
+        {
+          inputIndex[i] = lineIndex[i];
+        }
+
+        for (SizeValueType t = 0; t < numberOfTimeSteps; ++t)
+        {
+          inputIndex[OutputImageDimension] = firstTimeStep + t;
+          const InputImagePixelType* linePtr = inputBuffer + input->ComputeOffset(inputIndex);
+          for (typename IndexBatchType::size_type v = 0; v < positions.size(); ++v)
+          {
+            signals[v][t] = linePtr[positions[v]];
+          }
+        }
+
+        results = m_Functor(signals, indices);
+
+        if (results.size() != indices.size())
+        {
+          itkExceptionMacro("Error. Number of results of the functor does not equal the number of passed voxels. Number of results: "<< results.size() << "; number of voxels:" << indices.size());
+        }
+      }
+
+      typename IndexBatchType::size_type validPos = 0;
+      for (SizeValueType x = 0; x < lineLength; ++x)
+      {
+        voxelIndex[0] = lineIndex[0] + x;
+
+        const bool isValid = validPos < positions.size() && positions[validPos] == x;
+        const OutputArrayType& result = isValid ? results[validPos++] : invalidResult;
+
+        if (numberOfOutputImages != result.size())
+        {
+          itkExceptionMacro("Error. Number of output images do not equal number of outputs required by functor. Number of outputs: "<< numberOfOutputImages << "; needed output number:" << this->m_Functor.GetNumberOfOutputs());
+        }
+
+        for (unsigned int i = 0; i < numberOfOutputImages; ++i)
+        {
+          outputs[i]->SetPixel(voxelIndex, result[i]);
+        }
+
+        progress.CompletedPixel();
+      }
+    }
+  }
+} // end namespace itk
+
+#endif
@@ -20,6 +20,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkObject.h>
 #include <itkLevenbergMarquardtOptimizer.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "mitkModelBase.h"
 #include "mitkModelFitFunctorBase.h"
 #include "mitkMVConstrainedCostFunctionDecorator.h"
@@ -62,6 +66,20 @@ namespace mitk
     itkSetMacro(ActivateFailureThreshold, bool);
     itkGetConstMacro(ActivateFailureThreshold, bool);
 
+    /**If set to false the cost function always computes the derivatives numerically, even if the model
+     offers an analytic jacobian (see ModelBase::HasAnalyticJacobian()). Default is true.*/
+    itkSetMacro(UseAnalyticDerivative, bool);
+    itkGetConstMacro(UseAnalyticDerivative, bool);
+
+    /**If set to true, the fits of a batch of signals (see the batch version of ModelFitFunctorBase::Compute()) are done
+     by a batched Levenberg-Marquardt solver instead of one vnl optimizer per signal. All fits of the batch iterate in
+     lockstep and the model is evaluated for the trial parameters (and the steps of the numeric derivatives) of all fits
+     with one call of ModelBase::GetSignals(). Every fit keeps its own damping and stop condition. The solver minimizes
+     the same measure (incl. constraints) as the vnl optimizer, but uses its own iteration scheme, thus the results may
+     differ within the tolerances. Single signal fits always use the vnl optimizer. Default is false.*/
+    itkSetMacro(UseBatchedSolver, bool);
+    itkGetConstMacro(UseBatchedSolver, bool);
+
     virtual ParameterNamesType GetCriterionNames() const;
 
   protected:
@@ -77,6 +95,12 @@ namespace mitk
                                       const ModelBase::ParametersType& initialParameters,
                                       DebugParameterMapType& debugParameters) const;
 
+    /** Uses the batched solver if activated (see SetUseBatchedSolver()), otherwise the fits are done by DoModelFit().
+     In batched mode, the debug parameter "optimization_time" is the time of the whole batch.*/
+    virtual ParametersVectorType DoModelFits(const SignalBatchType& values, const ModelBase* model,
+                                             const ParametersVectorType& initialParameters,
+                                             DebugParameterMapVectorType& debugParameters) const override;
+
     virtual OutputPixelArrayType GetCriteria(const ModelBase* model, const ParametersType& parameters,
         const SignalType& sample) const;
 
@@ -84,9 +108,36 @@ namespace mitk
     virtual MVModelFitCostFunction::Pointer GenerateCostFunction(const SignalType& value,
         const ModelBase* model) const;
 
+    /** Reparameterizes a cost function that was generated by GenerateCostFunction() for a former fit, so that it
+     can be reused for the passed signal and model. Returns false if the cost function cannot be reused; in this
+     case GenerateCostFunction() is called. Reimplement it if GenerateCostFunction() is reimplemented.*/
+    virtual bool ReinitializeCostFunction(MVModelFitCostFunction* costFunction, const SignalType& value,
+        const ModelBase* model) const;
+
     virtual ParameterNamesType DefineDebugParameterNames() const;
 
   private:
+    ::mitk::MVModelFitCostFunction::Pointer GenerateSquaredDifferencesCostFunction(const SignalType& value,
+        const ModelBase* model) const;
+
+    /** Optimizer and cost function of one fit. Instances are pooled and reused for the following fits, because
+     (re)creating the vnl optimizer and its cost function adaptor for every voxel is a significant part of the
+     fitting time for small models. The pool holds (at most) one instance per thread that fits concurrently.*/
+    struct FitResources
+    {
+      ::itk::LevenbergMarquardtOptimizer::Pointer optimizer;
+      MVModelFitCostFunction::Pointer costFunction;
+      unsigned int numberOfParameters = 0;
+      unsigned int numberOfValues = 0;
+    };
+    typedef std::unique_ptr<FitResources> FitResourcesPointer;
+
+    FitResourcesPointer AcquireFitResources() const;
+    void ReleaseFitResources(FitResourcesPointer resources) const;
+
+    mutable std::vector<FitResourcesPointer> m_FitResourcesPool;
+    mutable std::mutex m_FitResourcesPoolMutex;
+
     double m_Epsilon;
     double m_GradientTolerance;
     double m_ValueTolerance;
@@ -100,6 +151,10 @@ namespace mitk
     /**If set to true and an constraint checker is set. The cost function will allways fail if the penalty of the
      checker reaches the threshold. In this case no function evaluation will be done-*/
     bool m_ActivateFailureThreshold;
+
+    bool m_UseAnalyticDerivative;
+
+    bool m_UseBatchedSolver;
   };
 
 }
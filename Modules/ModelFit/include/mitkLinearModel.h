@@ -47,6 +47,8 @@ namespace mitk
 
     virtual std::string GetModelType() const override;
 
+    virtual bool HasAnalyticJacobian() const override;
+
     virtual FunctionStringType GetFunctionString() const override;
 
     virtual std::string GetXName() const override;
@@ -74,6 +76,8 @@ namespace mitk
     virtual itk::LightObject::Pointer InternalClone() const;
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const;
+
+    virtual ModelJacobianType ComputeModelJacobian(const ParametersType& parameters) const;
     virtual DerivedParameterMapType ComputeDerivedParameters(const mitk::ModelBase::ParametersType&
         parameters) const;
 
@@ -78,6 +78,10 @@ public:
 
     /**Returns the index of the first (in terms of index position) failed parameter in the last failed evaluation.*/
     ParametersType::size_type GetFailedParameter() const;
+
+    /**Resets the evaluation, penalty and failure counts as well as the last failed parameter. Used if a cost
+     function instance is reused for several fits.*/
+    void ResetStatistics();
 protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const;
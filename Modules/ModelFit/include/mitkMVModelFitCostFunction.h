@@ -30,6 +30,9 @@ namespace mitk
 /** Base class for all model fit cost function that return a multiple cost value
  * It offers also a default implementation for the numerical computation of the
  * derivatives. Normaly you just have to (re)implement CalcMeasure().
+ * If the model provides an analytic jacobian (see ModelBase::HasAnalyticJacobian()) and the
+ * cost function implements CalcMeasureDerivative(), the derivatives are computed analytically
+ * instead, which saves 2*<number of parameters> model evaluations per call of GetDerivative().
 */
 class MITKMODELFIT_EXPORT MVModelFitCostFunction : public itk::MultipleValuedCostFunction, public ModelFitCostFunctionInterface
 {
@@ -58,11 +61,29 @@ public:
     itkSetMacro(DerivativeStepLength, double);
     itkGetConstMacro(DerivativeStepLength, double);
 
+    /**If set to false, the derivatives are always computed numerically even if an analytic
+     derivative would be available. Default is true.*/
+    itkSetMacro(UseAnalyticDerivative, bool);
+    itkGetConstMacro(UseAnalyticDerivative, bool);
+    itkBooleanMacro(UseAnalyticDerivative);
+
+    /**Returns true if GetDerivative() will use the analytic derivative with the current settings and model.*/
+    bool HasAnalyticDerivative() const;
+
 protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const = 0;
 
-    MVModelFitCostFunction() : m_DerivativeStepLength(1e-5)
+    /**Indicates if the cost function implements CalcMeasureDerivative(). Default implementation returns false.*/
+    virtual bool SupportsAnalyticDerivative() const;
+
+    /**Computes the derivatives of the measure given the model signal and its jacobian for the passed parameters
+     (chain rule). derivative is already sized (number of parameters x number of values) when called.
+     Default implementation throws an exception.*/
+    virtual void CalcMeasureDerivative(const ParametersType &parameters, const SignalType& signal,
+                                       const ModelBase::ModelJacobianType& jacobian, DerivativeType& derivative) const;
+
+    MVModelFitCostFunction() : m_DerivativeStepLength(1e-5), m_UseAnalyticDerivative(true)
     {
     }
 
@@ -75,6 +96,8 @@ private:
 
     /**value (delta of parameters) used to compute the derivatives numerically*/
     double m_DerivativeStepLength;
+
+    bool m_UseAnalyticDerivative;
 };
 
 }
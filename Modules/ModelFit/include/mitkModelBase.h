@@ -78,6 +78,15 @@ namespace mitk
     typedef double DerivedParameterValueType;
     typedef std::map<ParameterNameType, DerivedParameterValueType> DerivedParameterMapType;
 
+    /** Type of the partial derivatives of the model signal. Element [i][j] is the derivative of
+     * the signal at time point j with respect to parameter i (same layout as itk::MultipleValuedCostFunction::DerivativeType).*/
+    typedef itk::Array2D<double> ModelJacobianType;
+
+    /** Type of a batch of parameter sets (or signals). Row i holds the parameters (or the signal) of the i-th model
+     * evaluation of the batch.*/
+    typedef itk::Array2D<double> ParametersBatchType;
+    typedef itk::Array2D<double> ModelResultBatchType;
+
     /**Default implementation returns a scale of 1.0 for every defined parameter.*/
     virtual ParamterScaleMapType GetParameterScales() const;
 
@@ -172,10 +181,39 @@ namespace mitk
 
     ModelResultType GetSignal(const ParametersType& parameters) const;
 
+    /** Returns the signals of a batch of parameter sets. Row i of the result is the signal for the parameters in row i
+     * of the passed batch. The same checks as for GetSignal() are performed once for the whole batch, then
+     * ComputeModelfunctions() is called. Fit functors use it to evaluate the parameters of many voxels (or the steps of
+     * a numeric derivative) with one call.
+     * @pre The number of columns of parameters must equal GetNumberOfParameters().*/
+    ModelResultBatchType GetSignals(const ParametersBatchType& parameters) const;
+
+    /** Indicates if the model implements ComputeModelJacobian() and thus can provide the partial derivatives of its
+     * signal analytically. Cost functions use this to avoid the numerical differentiation during fitting.
+     * @remark Default implementation returns false.*/
+    virtual bool HasAnalyticJacobian() const;
+
+    /** Returns the partial derivatives of the signal for the given parameters. The same checks as for GetSignal()
+     * are performed before ComputeModelJacobian() is called.
+     * @pre HasAnalyticJacobian() must return true.*/
+    ModelJacobianType GetSignalJacobian(const ParametersType& parameters) const;
+
   protected:
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const = 0;
 
+    /** Helper function called by GetSignals(). Reimplement it in derived classes if the model can evaluate several
+     * parameter sets at once more efficiently (e.g. by sharing the parts of the computation that do not depend on the
+     * parameters and vectorizing over the parameter sets). The result must equal calling ComputeModelfunction() for
+     * every row.
+     * @remark Default implementation calls ComputeModelfunction() for every row of parameters.*/
+    virtual ModelResultBatchType ComputeModelfunctions(const ParametersBatchType& parameters) const;
+
+    /** Helper function called by GetSignalJacobian(). Implement in derived classes (and reimplement HasAnalyticJacobian())
+     * to realize the analytic computation of the partial derivatives of the signal.
+     * @remark Default implementation throws an exception.*/
+    virtual ModelJacobianType ComputeModelJacobian(const ParametersType& parameters) const;
+
     /** Member is called by GetSignal() before ComputeModelfunction(). It indicates if model is in a valid state and
      * ready to compute the signal. The default implementation checks nothing and always returns true.
      * Reimplement to realize special behavior for derived classes.
@@ -58,6 +58,21 @@ namespace mitk
     OutputPixelArrayType Compute(const InputPixelArrayType& value, const ModelBase* model,
                                  const ModelBase::ParametersType& initialParameters) const;
 
+    typedef std::vector<InputPixelArrayType> InputPixelArrayBatchType;
+    typedef std::vector<OutputPixelArrayType> OutputPixelArrayBatchType;
+    typedef std::vector<ModelBase::ParametersType> InitialParametersBatchType;
+
+    /** Batch version of Compute(). Fits the passed model onto every signal of values and returns the values Compute()
+     * would return for each of them (in the same order). All signals are fitted with the same model instance, thus a
+     * batch may only contain signals that share the same static parameters. Functors can reimplement DoModelFits()
+     * to fit the whole batch at once.
+     * @pre model must point to a valid instance.
+     * @pre values and initialParameters must have the same size.
+     * @pre Size of every initial parameter set must be equal to model->GetNumberOfParameters().
+     */
+    OutputPixelArrayBatchType Compute(const InputPixelArrayBatchType& values, const ModelBase* model,
+                                      const InitialParametersBatchType& initialParameters) const;
+
     /** Returns the number of outputs the fit functor will return if compute is called.
      * The number depends in parts on the passed model.
      * @exception Exception will be thrown if no valid model is passed.*/
@@ -123,12 +138,30 @@ namespace mitk
                                       const ModelBase::ParametersType& initialParameters,
                                       DebugParameterMapType& debugParameters) const = 0;
 
+    typedef std::vector<SignalType> SignalBatchType;
+    typedef std::vector<ParametersType> ParametersVectorType;
+    typedef std::vector<DebugParameterMapType> DebugParameterMapVectorType;
+
+    /** Internal Method called by the batch version of Compute(). It does the fits of all passed signals and returns the
+    found parameters (one parameter set per signal). Reimplement it if the functor can fit several signals at once
+    (e.g. to evaluate the model for the whole batch with one call of ModelBase::GetSignals()).
+    @remark Default implementation calls DoModelFit() for every signal.
+    @param [out] debugParameters Debug parameter maps of the fits (one per signal; see DoModelFit()).*/
+    virtual ParametersVectorType DoModelFits(const SignalBatchType& values, const ModelBase* model,
+                                             const ParametersVectorType& initialParameters,
+                                             DebugParameterMapVectorType& debugParameters) const;
+
     /** Returns names of the depug parameters generated by the functor. Will be called by GetDebugParameterNames,
     if debug is activated. */
     virtual ParameterNamesType DefineDebugParameterNames()const = 0;
 
   private:
 
+    /** Assembles the output of Compute() from the fitted parameters of one signal.*/
+    OutputPixelArrayType ComposeResult(const ModelBase* model, const SignalType& sample,
+                                       const ParametersType& fittedParameters, const DebugParameterMapType& debugParams,
+                                       const ParameterNamesType& debugNames) const;
+
     typedef std::map<std::string, SVModelFitCostFunction::Pointer> CostFunctionMapType;
     CostFunctionMapType m_CostFunctionMap;
     bool m_DebugParameterMaps;
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define MODELFITFUNCTOR_POLICY_H
 
 #include "itkIndex.h"
+#include <vector>
 #include "mitkModelFitFunctorBase.h"
 #include "MitkModelFitExports.h"
 
@@ -109,6 +110,61 @@ namespace mitk
       return result;
     }
 
+    typedef std::vector<InputPixelArrayType> InputPixelArrayBatchType;
+    typedef std::vector<OutputPixelArrayType> OutputPixelArrayBatchType;
+    typedef std::vector<IndexType> IndexBatchType;
+
+    /** Batch version of operator(); returns the results for all passed signals (in the same order).
+     If no voxel of the batch has local static parameters, all voxels share the same parameterized model and
+     are fitted as one batch by the functor (see batch version of ModelFitFunctorBase::Compute()).
+     Otherwise every voxel is fitted with its own model.*/
+    inline OutputPixelArrayBatchType operator()(const InputPixelArrayBatchType& values,
+                                                const IndexBatchType& indices) const
+    {
+      if (!m_Functor)
+      {
+        itkGenericExceptionMacro( << "Error. Cannot process operator(). Functor is Null.");
+      }
+
+      if (!m_ModelParameterizer)
+      {
+        itkGenericExceptionMacro( << "Error. Cannot process operator(). Parameterizer is Null.");
+      }
+
+      bool sharedModel = !indices.empty();
+      for (IndexBatchType::const_iterator pos = indices.begin(); sharedModel && pos != indices.end(); ++pos)
+      {
+        sharedModel = m_ModelParameterizer->GetLocalStaticParameters(*pos).empty();
+      }
+
+      OutputPixelArrayBatchType result;
+
+      if (sharedModel)
+      {
+        ParameterizerType::ModelBasePointer parameterizedModel =
+          m_ModelParameterizer->GenerateParameterizedModel(indices.front());
+
+        FunctorType::InitialParametersBatchType initialParams;
+        initialParams.reserve(indices.size());
+        for (IndexBatchType::const_iterator pos = indices.begin(); pos != indices.end(); ++pos)
+        {
+          initialParams.push_back(m_ModelParameterizer->GetInitialParameterization(*pos));
+        }
+
+        result = m_Functor->Compute(values, parameterizedModel, initialParams);
+      }
+      else
+      {
+        result.reserve(values.size());
+        for (InputPixelArrayBatchType::size_type pos = 0; pos < values.size(); ++pos)
+        {
+          result.push_back((*this)(values[pos], indices[pos]));
+        }
+      }
+
+      return result;
+    }
+
   private:
 
     FunctorConstPointer m_Functor;
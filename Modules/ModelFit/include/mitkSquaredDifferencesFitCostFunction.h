@@ -43,6 +43,11 @@ public:
 protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const;
+
+    virtual bool SupportsAnalyticDerivative() const;
+
+    virtual void CalcMeasureDerivative(const ParametersType &parameters, const SignalType& signal,
+                                       const ModelBase::ModelJacobianType& jacobian, DerivativeType& derivative) const;
 	
     SquaredDifferencesFitCostFunction()
     {
@@ -48,6 +48,8 @@ namespace mitk
 
     virtual std::string GetModelType() const override;
 
+    virtual bool HasAnalyticJacobian() const override;
+
     virtual FunctionStringType GetFunctionString() const override;
 
     virtual std::string GetXName() const override;
@@ -72,6 +74,8 @@ namespace mitk
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const;
 
+    virtual ModelJacobianType ComputeModelJacobian(const ParametersType& parameters) const;
+
     virtual void SetStaticParameter(const ParameterNameType& name,
                                     const StaticParameterValuesType& values);
     virtual StaticParameterValuesType GetStaticParameterValue(const ParameterNameType& name) const;
@@ -15,10 +15,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "itkCommand.h"
-#include "itkMultiOutputNaryFunctorImageFilter.h"
+#include "itkMultiOutputTimeSeriesFunctorImageFilter.h"
 
 #include "mitkPixelBasedParameterFitImageGenerator.h"
-#include "mitkImageTimeSelector.h"
 #include "mitkImageAccessByItk.h"
 #include "mitkImageCast.h"
 #include "mitkModelFitFunctorPolicy.h"
@@ -83,12 +82,13 @@ mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType StoreResultIma
 
 template <typename TPixel, unsigned int VDim>
 void 
-  mitk::PixelBasedParameterFitImageGenerator::DoParameterFit(itk::Image<TPixel, VDim>* /*image*/)
+  mitk::PixelBasedParameterFitImageGenerator::DoParameterFit(itk::Image<TPixel, VDim>* image)
 {
-  using InputFrameImageType = itk::Image<TPixel, VDim-1>;
+  using InputImageType = itk::Image<TPixel, VDim>;
   using ParameterImageType = itk::Image<ScalarType, VDim-1>;
 
-  using FitFilterType = itk::MultiOutputNaryFunctorImageFilter<InputFrameImageType, ParameterImageType, ModelFitFunctorPolicy, InternalMaskType>;
+  //The fit filter reads the time series directly from the dynamic image, so no time frames have to be extracted.
+  using FitFilterType = itk::MultiOutputTimeSeriesFunctorImageFilter<InputImageType, ParameterImageType, ModelFitFunctorPolicy, InternalMaskType>;
 
   typename FitFilterType::Pointer fitFilter = FitFilterType::New();
 
@@ -96,21 +96,7 @@ void
   spProgressCommand->SetCallbackFunction(this, &Self::onFitProgressEvent);
   fitFilter->AddObserver(::itk::ProgressEvent(), spProgressCommand);
 
-  //add the time frames to the fit filter
-  std::vector<Image::Pointer> frameCache;
-  for (unsigned int i = 0; i < this->m_DynamicImage->GetTimeSteps(); ++i)
-  {
-    typename InputFrameImageType::Pointer frameImage;
-    mitk::ImageTimeSelector::Pointer imageTimeSelector =	mitk::ImageTimeSelector::New();
-    imageTimeSelector->SetInput(this->m_DynamicImage);
-    imageTimeSelector->SetTimeNr(i);
-    imageTimeSelector->UpdateLargestPossibleRegion();
-
-    Image::Pointer frameMITKImage = imageTimeSelector->GetOutput();
-    frameCache.push_back(frameMITKImage);
-    mitk::CastToItkImage(frameMITKImage, frameImage);
-    fitFilter->SetInput(i,frameImage);
-  }
+  fitFilter->SetInput(image);
 
   ModelBaseType::TimeGridType timeGrid = ExtractTimeGrid(m_DynamicImage);
   if (m_TimeGridByParameterizer)
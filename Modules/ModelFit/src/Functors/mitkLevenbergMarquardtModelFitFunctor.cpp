@@ -18,13 +18,172 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkSquaredDifferencesFitCostFunction.h"
 #include "mitkSumOfSquaredDifferencesFitCostFunction.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <vnl/vnl_nonlinear_minimizer.h>
 #include <mitkExceptionMacro.h>
 
+namespace
+{
+  typedef mitk::ModelBase::ParametersType ParametersType;
+  typedef itk::Array<double> MeasureType;
+
+  /** State of one fit of the batched Levenberg-Marquardt solver.*/
+  struct BatchFitState
+  {
+    ParametersType position;
+    MeasureType measure;
+    double cost = 0.0;
+    double damping = 1e-3;
+    /** J^T*J and J^T*f of the current position (in scaled parameter space).*/
+    std::vector<double> normalMatrix;
+    std::vector<double> gradient;
+    ParametersType trial;
+    double stepNorm = 0.0;
+    unsigned int evaluations = 0;
+    int stopCondition = 0;
+    bool needsDerivative = true;
+
+    unsigned int evaluationCount = 0;
+    unsigned int penaltyCount = 0;
+    unsigned int failureCount = 0;
+    int lastFailedParameter = -1;
+  };
+
+  double SumOfSquares(const MeasureType& measure)
+  {
+    double result = 0.0;
+    for (MeasureType::SizeValueType i = 0; i < measure.GetSize(); ++i)
+    {
+      result += measure[i] * measure[i];
+    }
+    return result;
+  }
+
+  /** Computes the measure of the squared differences cost function for every row of parameters; sampleIDs[row] is the
+   fit the row belongs to. If a constraint checker is passed, the penalties are added the same way as
+   MVConstrainedCostFunctionDecorator does and its statistics are counted in the states.*/
+  mitk::ModelBase::ModelResultBatchType CalcBatchMeasures(const mitk::ModelBase* model,
+    const std::vector<MeasureType>& samples, const std::vector<unsigned int>& sampleIDs,
+    const mitk::ModelBase::ParametersBatchType& parameters, const mitk::ConstraintCheckerBase* checker,
+    bool activateFailureThreshold, std::vector<BatchFitState>& states)
+  {
+    mitk::ModelBase::ModelResultBatchType measures = model->GetSignals(parameters);
+    ParametersType rowParameters(parameters.cols());
+
+    for (unsigned int row = 0; row < parameters.rows(); ++row)
+    {
+      const MeasureType& sample = samples[sampleIDs[row]];
+      if (sample.GetSize() != measures.cols())
+      {
+        mitkThrow() << "Signal size does not matche sample size!";
+      }
+
+      double penalty = 0.0;
+      if (checker)
+      {
+        BatchFitState& state = states[sampleIDs[row]];
+        state.evaluationCount++;
+
+        rowParameters.copy_in(parameters[row]);
+        penalty = checker->GetPenaltySum(rowParameters);
+
+        if (activateFailureThreshold && penalty >= checker->GetFailedConstraintValue())
+        {
+          auto penalties = checker->GetPenalties(rowParameters);
+          for (ParametersType::size_type pos = 0; pos < penalties.size(); ++pos)
+          {
+            if (penalties[pos] >= checker->GetFailedConstraintValue())
+            {
+              state.lastFailedParameter = pos;
+              break;
+            }
+          }
+          state.failureCount++;
+
+          for (unsigned int j = 0; j < measures.cols(); ++j)
+          {
+            measures(row, j) = penalty;
+          }
+          continue;
+        }
+
+        if (penalty > 0)
+        {
+          state.penaltyCount++;
+        }
+      }
+
+      for (unsigned int j = 0; j < measures.cols(); ++j)
+      {
+        const double difference = sample[j] - measures(row, j);
+        measures(row, j) = penalty + difference * difference;
+      }
+    }
+
+    return measures;
+  }
+
+  /** Solves the symmetric positive definite system a*x = b (a is a row-major n x n matrix) by a Cholesky decomposition.
+   a is overwritten and b is replaced by x. Returns false if a is not positive definite.*/
+  bool SolveCholesky(std::vector<double>& a, std::vector<double>& b, unsigned int n)
+  {
+    for (unsigned int j = 0; j < n; ++j)
+    {
+      double diagonal = a[j * n + j];
+      for (unsigned int k = 0; k < j; ++k)
+      {
+        diagonal -= a[j * n + k] * a[j * n + k];
+      }
+
+      if (!(diagonal > 0.0))
+      {
+        return false;
+      }
+
+      diagonal = std::sqrt(diagonal);
+      a[j * n + j] = diagonal;
+
+      for (unsigned int i = j + 1; i < n; ++i)
+      {
+        double value = a[i * n + j];
+        for (unsigned int k = 0; k < j; ++k)
+        {
+          value -= a[i * n + k] * a[j * n + k];
+        }
+        a[i * n + j] = value / diagonal;
+      }
+    }
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      double value = b[i];
+      for (unsigned int k = 0; k < i; ++k)
+      {
+        value -= a[i * n + k] * b[k];
+      }
+      b[i] = value / a[i * n + i];
+    }
+
+    for (unsigned int i = n; i-- > 0;)
+    {
+      double value = b[i];
+      for (unsigned int k = i + 1; k < n; ++k)
+      {
+        value -= a[k * n + i] * b[k];
+      }
+      b[i] = value / a[i * n + i];
+    }
+
+    return true;
+  }
+}
+
 mitk::LevenbergMarquardtModelFitFunctor::
 LevenbergMarquardtModelFitFunctor(): m_Epsilon(1e-5), m_GradientTolerance(1e-3),
   m_ValueTolerance(1e-5), m_Iterations(1000), m_DerivativeStepLength(1e-5),
-  m_ActivateFailureThreshold(true)
+  m_ActivateFailureThreshold(true), m_UseAnalyticDerivative(true), m_UseBatchedSolver(false)
 {};
 
 mitk::LevenbergMarquardtModelFitFunctor::
@@ -56,7 +215,7 @@ GetCriteria(const ModelBase* model, const ParametersType& parameters,
   return result;
 };
 
-mitk::MVModelFitCostFunction::Pointer mitk::LevenbergMarquardtModelFitFunctor::GenerateCostFunction(
+mitk::MVModelFitCostFunction::Pointer mitk::LevenbergMarquardtModelFitFunctor::GenerateSquaredDifferencesCostFunction(
   const SignalType& value, const ModelBase* model) const
 {
   ::mitk::SquaredDifferencesFitCostFunction::Pointer metric
@@ -64,8 +223,18 @@ mitk::MVModelFitCostFunction::Pointer mitk::LevenbergMarquardtModelFitFunctor::G
   metric->SetModel(model);
   metric->SetSample(value);
   metric->SetDerivativeStepLength(m_DerivativeStepLength);
+  metric->SetUseAnalyticDerivative(m_UseAnalyticDerivative);
 
   mitk::MVModelFitCostFunction::Pointer result = metric.GetPointer();
+  return result;
+};
+
+mitk::MVModelFitCostFunction::Pointer mitk::LevenbergMarquardtModelFitFunctor::GenerateCostFunction(
+  const SignalType& value, const ModelBase* model) const
+{
+  mitk::MVModelFitCostFunction::Pointer metric = this->GenerateSquaredDifferencesCostFunction(value, model);
+
+  mitk::MVModelFitCostFunction::Pointer result = metric;
 
   if (m_ConstraintChecker.IsNotNull())
   {
@@ -84,6 +253,60 @@ mitk::MVModelFitCostFunction::Pointer mitk::LevenbergMarquardtModelFitFunctor::G
   return result;
 };
 
+bool mitk::LevenbergMarquardtModelFitFunctor::ReinitializeCostFunction(
+  MVModelFitCostFunction* costFunction, const SignalType& value, const ModelBase* model) const
+{
+  if (m_ConstraintChecker.IsNotNull())
+  {
+    ::mitk::MVConstrainedCostFunctionDecorator* decorator = dynamic_cast<::mitk::MVConstrainedCostFunctionDecorator*>(costFunction);
+    if (!decorator || decorator->GetConstraintChecker() != m_ConstraintChecker.GetPointer())
+    {
+      return false;
+    }
+
+    decorator->SetWrappedCostFunction(this->GenerateSquaredDifferencesCostFunction(value, model));
+    decorator->SetFailureThreshold(m_ConstraintChecker->GetFailedConstraintValue());
+    decorator->SetModel(model);
+    decorator->SetSample(value);
+    decorator->SetActivateFailureThreshold(m_ActivateFailureThreshold);
+    decorator->ResetStatistics();
+    return true;
+  }
+
+  ::mitk::SquaredDifferencesFitCostFunction* metric = dynamic_cast<::mitk::SquaredDifferencesFitCostFunction*>(costFunction);
+  if (!metric)
+  {
+    return false;
+  }
+
+  metric->SetModel(model);
+  metric->SetSample(value);
+  metric->SetDerivativeStepLength(m_DerivativeStepLength);
+  metric->SetUseAnalyticDerivative(m_UseAnalyticDerivative);
+  return true;
+};
+
+mitk::LevenbergMarquardtModelFitFunctor::FitResourcesPointer
+mitk::LevenbergMarquardtModelFitFunctor::AcquireFitResources() const
+{
+  std::lock_guard<std::mutex> lock(m_FitResourcesPoolMutex);
+  if (m_FitResourcesPool.empty())
+  {
+    return FitResourcesPointer(new FitResources());
+  }
+
+  FitResourcesPointer resources = std::move(m_FitResourcesPool.back());
+  m_FitResourcesPool.pop_back();
+  return resources;
+};
+
+void
+mitk::LevenbergMarquardtModelFitFunctor::ReleaseFitResources(FitResourcesPointer resources) const
+{
+  std::lock_guard<std::mutex> lock(m_FitResourcesPoolMutex);
+  m_FitResourcesPool.push_back(std::move(resources));
+};
+
 mitk::LevenbergMarquardtModelFitFunctor::ParameterNamesType
 mitk::LevenbergMarquardtModelFitFunctor::DefineDebugParameterNames() const
 {
@@ -127,17 +350,37 @@ DoModelFit(const SignalType& value, const ModelBase* model,
     scales.Fill(1.0);
   }
 
-  mitk::MVModelFitCostFunction::Pointer metric = this->GenerateCostFunction(value, model);
+  FitResourcesPointer resources = this->AcquireFitResources();
+
+  if (resources->costFunction.IsNull() || !this->ReinitializeCostFunction(resources->costFunction, value, model))
+  {
+    resources->costFunction = this->GenerateCostFunction(value, model);
+    resources->optimizer = nullptr;
+  }
+
+  mitk::MVModelFitCostFunction::Pointer metric = resources->costFunction;
+
+  if (resources->optimizer.IsNull() || resources->numberOfParameters != metric->GetNumberOfParameters() ||
+      resources->numberOfValues != metric->GetNumberOfValues())
+  {
+    //the vnl optimizer and the cost function adaptor depend on the number of parameters and values,
+    //thus they have to be regenerated if one of them changes.
+    resources->optimizer = ::itk::LevenbergMarquardtOptimizer::New();
+    resources->optimizer->SetCostFunction(metric);
+    resources->numberOfParameters = metric->GetNumberOfParameters();
+    resources->numberOfValues = metric->GetNumberOfValues();
+  }
 
-  ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = ::itk::LevenbergMarquardtOptimizer::New();
+  ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = resources->optimizer;
 
-  optimizer->SetCostFunction(metric);
   optimizer->SetEpsilonFunction(m_Epsilon);
   optimizer->SetGradientTolerance(m_GradientTolerance);
   optimizer->SetNumberOfIterations(m_Iterations);
   optimizer->SetScales(scales);
   optimizer->SetInitialPosition(internalInitParam);
 
+  //if the optimization throws, the resources are not returned to the pool, because
+  //the optimizer may be in an undefined state.
   optimizer->StartOptimization();
 
   itk::Optimizer::ParametersType position = optimizer->GetCurrentPosition();
@@ -174,6 +417,342 @@ DoModelFit(const SignalType& value, const ModelBase* model,
       }
     }
   }
-  
+
+  this->ReleaseFitResources(std::move(resources));
+
   return position;
 };
+
+mitk::LevenbergMarquardtModelFitFunctor::ParametersVectorType
+mitk::LevenbergMarquardtModelFitFunctor::
+DoModelFits(const SignalBatchType& values, const ModelBase* model,
+            const ParametersVectorType& initialParameters,
+            DebugParameterMapVectorType& debugParameters) const
+{
+  if (!m_UseBatchedSolver || values.size() < 2)
+  {
+    return Superclass::DoModelFits(values, model, initialParameters, debugParameters);
+  }
+
+  std::chrono::time_point<std::chrono::system_clock> startTime;
+  startTime = std::chrono::system_clock::now();
+
+  //tolerance of the relative step size (default of the vnl optimizer) and range of the damping
+  const double stepTolerance = 1e-8;
+  const double minimumDamping = 1e-15;
+  const double maximumDamping = 1e16;
+
+  const unsigned int batchSize = values.size();
+  const unsigned int numberOfParameters = model->GetNumberOfParameters();
+  const unsigned int numberOfValues = values.front().GetSize();
+
+  ::itk::LevenbergMarquardtOptimizer::ScalesType scales = m_Scales;
+  if (m_Scales.GetNumberOfElements() != numberOfParameters)
+  {
+    MITK_DEBUG <<
+               "Size of scales of fit functor optimizer do not match number of model parameters. Reinitialize scales with 1.0.";
+    scales.SetSize(numberOfParameters);
+    scales.Fill(1.0);
+  }
+
+  const ConstraintCheckerBase* checker = m_ConstraintChecker.GetPointer();
+  const bool useAnalyticDerivative = m_UseAnalyticDerivative && !checker && model->HasAnalyticJacobian();
+
+  std::vector<BatchFitState> states(batchSize);
+  std::vector<unsigned int> sampleIDs(batchSize);
+  ModelBase::ParametersBatchType rows(batchSize, numberOfParameters);
+
+  for (unsigned int pos = 0; pos < batchSize; ++pos)
+  {
+    if (values[pos].GetSize() != numberOfValues)
+    {
+      mitkThrow() << "Cannot fit batch. All signals of a batch must have the same size.";
+    }
+
+    BatchFitState& state = states[pos];
+    state.position = initialParameters[pos];
+    if (state.position.GetNumberOfElements() != numberOfParameters)
+    {
+      MITK_DEBUG <<
+                 "Size of initial parameters of fit functor optimizer do not match number of model parameters. Renitialize parameters with 0.0.";
+      state.position.SetSize(numberOfParameters);
+      state.position.Fill(0.0);
+    }
+    state.normalMatrix.resize(numberOfParameters * numberOfParameters);
+    state.gradient.resize(numberOfParameters);
+
+    sampleIDs[pos] = pos;
+    rows.set_row(pos, state.position);
+  }
+
+  ModelBase::ModelResultBatchType measures = CalcBatchMeasures(model, values, sampleIDs, rows, checker,
+    m_ActivateFailureThreshold, states);
+
+  std::vector<unsigned int> activeIDs;
+  for (unsigned int pos = 0; pos < batchSize; ++pos)
+  {
+    BatchFitState& state = states[pos];
+    state.measure = measures.get_row(pos);
+    state.cost = SumOfSquares(state.measure);
+    state.evaluations = 1;
+    if (state.cost == 0.0)
+    {
+      state.stopCondition = vnl_nonlinear_minimizer::CONVERGED_FTOL;
+    }
+    else
+    {
+      activeIDs.push_back(pos);
+    }
+  }
+
+  ModelBase::ModelJacobianType jacobian(numberOfParameters, numberOfValues);
+  std::vector<double> systemMatrix(numberOfParameters * numberOfParameters);
+  std::vector<double> step(numberOfParameters);
+
+  while (!activeIDs.empty())
+  {
+    //derivatives of all fits whose position has changed
+    std::vector<unsigned int> derivativeIDs;
+    for (auto id : activeIDs)
+    {
+      if (states[id].needsDerivative)
+      {
+        derivativeIDs.push_back(id);
+      }
+    }
+
+    ModelBase::ModelResultBatchType derivativeMeasures;
+    if (!derivativeIDs.empty() && !useAnalyticDerivative)
+    {
+      //central differences of all fits and parameters in one batch
+      rows.set_size(2 * numberOfParameters * derivativeIDs.size(), numberOfParameters);
+      sampleIDs.resize(rows.rows());
+      unsigned int row = 0;
+      for (auto id : derivativeIDs)
+      {
+        for (unsigned int i = 0; i < numberOfParameters; ++i)
+        {
+          rows.set_row(row, states[id].position);
+          rows(row, i) -= m_DerivativeStepLength;
+          sampleIDs[row++] = id;
+          rows.set_row(row, states[id].position);
+          rows(row, i) += m_DerivativeStepLength;
+          sampleIDs[row++] = id;
+        }
+      }
+      derivativeMeasures = CalcBatchMeasures(model, values, sampleIDs, rows, checker, m_ActivateFailureThreshold, states);
+    }
+
+    for (unsigned int derivativePos = 0; derivativePos < derivativeIDs.size(); ++derivativePos)
+    {
+      BatchFitState& state = states[derivativeIDs[derivativePos]];
+      const MeasureType& sample = values[derivativeIDs[derivativePos]];
+
+      if (useAnalyticDerivative)
+      {
+        ModelBase::ModelResultType signal = model->GetSignal(state.position);
+        ModelBase::ModelJacobianType modelJacobian = model->GetSignalJacobian(state.position);
+        for (unsigned int i = 0; i < numberOfParameters; ++i)
+        {
+          for (unsigned int j = 0; j < numberOfValues; ++j)
+          {
+            jacobian(i, j) = -2 * (sample[j] - signal[j]) * modelJacobian(i, j) / scales[i];
+          }
+        }
+      }
+      else
+      {
+        for (unsigned int i = 0; i < numberOfParameters; ++i)
+        {
+          const unsigned int row = 2 * (derivativePos * numberOfParameters + i);
+          for (unsigned int j = 0; j < numberOfValues; ++j)
+          {
+            jacobian(i, j) = (derivativeMeasures(row + 1, j) - derivativeMeasures(row, j)) / (2 * m_DerivativeStepLength)
+                             / scales[i];
+          }
+        }
+      }
+
+      //gradient test of the vnl optimizer: cosine of the angle between the measure and the columns of the jacobian
+      const double measureNorm = std::sqrt(state.cost);
+      double gradientNorm = 0.0;
+      for (unsigned int a = 0; a < numberOfParameters; ++a)
+      {
+        double gradient = 0.0;
+        double columnNorm = 0.0;
+        for (unsigned int j = 0; j < numberOfValues; ++j)
+        {
+          gradient += jacobian(a, j) * state.measure[j];
+          columnNorm += jacobian(a, j) * jacobian(a, j);
+        }
+        state.gradient[a] = gradient;
+        if (columnNorm > 0.0)
+        {
+          gradientNorm = std::max(gradientNorm, std::abs(gradient) / (std::sqrt(columnNorm) * measureNorm));
+        }
+
+        for (unsigned int b = 0; b <= a; ++b)
+        {
+          double value = 0.0;
+          for (unsigned int j = 0; j < numberOfValues; ++j)
+          {
+            value += jacobian(a, j) * jacobian(b, j);
+          }
+          state.normalMatrix[a * numberOfParameters + b] = value;
+          state.normalMatrix[b * numberOfParameters + a] = value;
+        }
+      }
+
+      state.needsDerivative = false;
+      if (gradientNorm <= m_GradientTolerance)
+      {
+        state.stopCondition = vnl_nonlinear_minimizer::CONVERGED_GTOL;
+      }
+    }
+
+    //damped steps of all active fits, evaluated in one batch
+    std::vector<unsigned int> trialIDs;
+    for (auto id : activeIDs)
+    {
+      BatchFitState& state = states[id];
+      if (state.stopCondition != 0)
+      {
+        continue;
+      }
+
+      systemMatrix = state.normalMatrix;
+      for (unsigned int i = 0; i < numberOfParameters; ++i)
+      {
+        const double diagonal = state.normalMatrix[i * numberOfParameters + i];
+        systemMatrix[i * numberOfParameters + i] += state.damping * (diagonal > 0.0 ? diagonal : 1.0);
+        step[i] = -state.gradient[i];
+      }
+
+      if (!SolveCholesky(systemMatrix, step, numberOfParameters))
+      {
+        state.damping *= 10;
+        if (state.damping > maximumDamping)
+        {
+          state.stopCondition = vnl_nonlinear_minimizer::FAILED_FTOL_TOO_SMALL;
+        }
+        continue;
+      }
+
+      state.trial = state.position;
+      double stepNorm = 0.0;
+      for (unsigned int i = 0; i < numberOfParameters; ++i)
+      {
+        state.trial[i] += step[i] / scales[i];
+        stepNorm += step[i] * step[i];
+      }
+      state.stepNorm = std::sqrt(stepNorm);
+      trialIDs.push_back(id);
+    }
+
+    if (!trialIDs.empty())
+    {
+      rows.set_size(trialIDs.size(), numberOfParameters);
+      sampleIDs.resize(trialIDs.size());
+      for (unsigned int row = 0; row < trialIDs.size(); ++row)
+      {
+        rows.set_row(row, states[trialIDs[row]].trial);
+        sampleIDs[row] = trialIDs[row];
+      }
+
+      measures = CalcBatchMeasures(model, values, sampleIDs, rows, checker, m_ActivateFailureThreshold, states);
+
+      for (unsigned int row = 0; row < trialIDs.size(); ++row)
+      {
+        BatchFitState& state = states[trialIDs[row]];
+        MeasureType trialMeasure(measures.get_row(row));
+        const double trialCost = SumOfSquares(trialMeasure);
+        state.evaluations++;
+
+        if (trialCost < state.cost)
+        {
+          const double reduction = (state.cost - trialCost) / state.cost;
+
+          double positionNorm = 0.0;
+          for (unsigned int i = 0; i < numberOfParameters; ++i)
+          {
+            positionNorm += state.position[i] * scales[i] * state.position[i] * scales[i];
+          }
+
+          state.position = state.trial;
+          state.measure = trialMeasure;
+          state.cost = trialCost;
+          state.damping = std::max(state.damping / 10, minimumDamping);
+          state.needsDerivative = true;
+
+          if (reduction <= m_ValueTolerance || trialCost == 0.0)
+          {
+            state.stopCondition = vnl_nonlinear_minimizer::CONVERGED_FTOL;
+          }
+          else if (state.stepNorm <= stepTolerance * (std::sqrt(positionNorm) + stepTolerance))
+          {
+            state.stopCondition = vnl_nonlinear_minimizer::CONVERGED_XTOL;
+          }
+        }
+        else
+        {
+          state.damping *= 10;
+          if (state.damping > maximumDamping)
+          {
+            state.stopCondition = vnl_nonlinear_minimizer::FAILED_FTOL_TOO_SMALL;
+          }
+        }
+
+        if (state.stopCondition == 0 && state.evaluations >= m_Iterations)
+        {
+          state.stopCondition = vnl_nonlinear_minimizer::FAILED_TOO_MANY_ITERATIONS;
+        }
+      }
+    }
+
+    std::vector<unsigned int> stillActiveIDs;
+    for (auto id : activeIDs)
+    {
+      if (states[id].stopCondition == 0)
+      {
+        stillActiveIDs.push_back(id);
+      }
+    }
+    activeIDs.swap(stillActiveIDs);
+  }
+
+  std::chrono::time_point<std::chrono::system_clock> stopTime;
+  stopTime = std::chrono::system_clock::now();
+
+  ParametersVectorType result(batchSize);
+  debugParameters.resize(batchSize);
+
+  for (unsigned int pos = 0; pos < batchSize; ++pos)
+  {
+    const BatchFitState& state = states[pos];
+    result[pos] = state.position;
+
+    debugParameters[pos].clear();
+    if (this->GetDebugParameterMaps())
+    {
+      const auto timeDiff = std::chrono::duration_cast<std::chrono::milliseconds>(stopTime - startTime).count();
+      debugParameters[pos].insert(std::make_pair("optimization_time", timeDiff));
+
+      ParameterImagePixelType value = state.evaluations;
+      debugParameters[pos].insert(std::make_pair("nr_of_iterations", value));
+      value = state.stopCondition;
+      debugParameters[pos].insert(std::make_pair("stop_condition", value));
+
+      if (checker)
+      {
+        value = state.evaluationCount > 0 ? state.penaltyCount / (double)state.evaluationCount : 0.0;
+        debugParameters[pos].insert(std::make_pair("constraint_penalty_ratio", value));
+        value = state.evaluationCount > 0 ? state.failureCount / (double)state.evaluationCount : 0.0;
+        debugParameters[pos].insert(std::make_pair("constraint_failure_ratio", value));
+        value = state.lastFailedParameter;
+        debugParameters[pos].insert(std::make_pair("constraint_last_failed_parameter", value));
+      }
+    }
+  }
+
+  return result;
+};
@@ -18,6 +18,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <iostream>
 
+#include <mitkExceptionMacro.h>
+
 
 mitk::MVModelFitCostFunction::MeasureType mitk::MVModelFitCostFunction::GetValue(const ParametersType &parameter) const
 {
@@ -40,6 +42,19 @@ void mitk::MVModelFitCostFunction::GetDerivative (const ParametersType &paramete
 
   derivative.SetSize(paramCount,m_Sample.Size());
 
+  if (this->HasAnalyticDerivative())
+  {
+    SignalType signal = m_Model->GetSignal(parameters);
+
+    if(signal.GetSize() != m_Sample.GetSize()) itkExceptionMacro("Signal size does not matche sample size!");
+    if(signal.GetSize() == 0)  itkExceptionMacro("Signal is empty!");
+
+    ModelBase::ModelJacobianType jacobian = m_Model->GetSignalJacobian(parameters);
+
+    CalcMeasureDerivative(parameters, signal, jacobian, derivative);
+    return;
+  }
+
   for ( ParametersType::SizeValueType i = 0; i < paramCount; i++ )
   {
     ParametersType newParameters = parameters;
@@ -61,6 +76,22 @@ void mitk::MVModelFitCostFunction::GetDerivative (const ParametersType &paramete
 
 };
 
+bool mitk::MVModelFitCostFunction::HasAnalyticDerivative() const
+{
+  return m_UseAnalyticDerivative && m_Model.IsNotNull() && m_Model->HasAnalyticJacobian() && this->SupportsAnalyticDerivative();
+}
+
+bool mitk::MVModelFitCostFunction::SupportsAnalyticDerivative() const
+{
+  return false;
+}
+
+void mitk::MVModelFitCostFunction::CalcMeasureDerivative(const ParametersType &/*parameters*/, const SignalType& /*signal*/,
+  const ModelBase::ModelJacobianType& /*jacobian*/, DerivativeType& /*derivative*/) const
+{
+  mitkThrow() << "Error. Cost function does not implement an analytic derivative.";
+}
+
 unsigned int mitk::MVModelFitCostFunction::GetNumberOfParameters() const
 {
   return m_Model->GetNumberOfParameters();
@@ -48,6 +48,89 @@ Compute(const InputPixelArrayType& value, const ModelBase* model,
 
   ParametersType fittedParameters = DoModelFit(sample, model, initialParameters, debugParams);
 
+  return this->ComposeResult(model, sample, fittedParameters, debugParams, debugNames);
+};
+
+mitk::ModelFitFunctorBase::OutputPixelArrayBatchType
+mitk::ModelFitFunctorBase::
+Compute(const InputPixelArrayBatchType& values, const ModelBase* model,
+        const InitialParametersBatchType& initialParameters) const
+{
+  if (!model)
+  {
+    itkExceptionMacro("Cannot compute fit. Passed model is not defined.");
+  }
+
+  if (values.size() != initialParameters.size())
+  {
+    itkExceptionMacro("Cannot compute fit. Number of passed signals and initial parameter sets differ. Signals: "
+                      << values.size() << "; initial parameter sets: " << initialParameters.size());
+  }
+
+  SignalBatchType samples(values.size());
+  ParametersVectorType initials(values.size());
+
+  for (InputPixelArrayBatchType::size_type pos = 0; pos < values.size(); ++pos)
+  {
+    if (model->GetNumberOfParameters() != initialParameters[pos].Size())
+    {
+      itkExceptionMacro("Cannot compute fit. Parameter count of passed model and passed initial parameters differ. Model parameter count: "
+                        << model->GetNumberOfParameters() << "; Initial parameters: " << initialParameters[pos]);
+    }
+
+    samples[pos].SetSize(values[pos].size());
+    for (SignalType::SizeValueType i = 0; i < samples[pos].Size(); ++i)
+    {
+      samples[pos][i] = values[pos][i];
+    }
+    initials[pos] = initialParameters[pos];
+  }
+
+  ParameterNamesType debugNames;
+  if (this->m_DebugParameterMaps)
+  {
+    debugNames = this->GetDebugParameterNames();
+  }
+
+  DebugParameterMapVectorType debugParams(values.size());
+  ParametersVectorType fittedParameters = DoModelFits(samples, model, initials, debugParams);
+
+  if (fittedParameters.size() != values.size() || debugParams.size() != values.size())
+  {
+    itkExceptionMacro("Fit functor implementation seems to be inconsitent. Number of fitted parameter sets or debug maps is not equal to number of signals.");
+  }
+
+  OutputPixelArrayBatchType results(values.size());
+  for (InputPixelArrayBatchType::size_type pos = 0; pos < values.size(); ++pos)
+  {
+    results[pos] = this->ComposeResult(model, samples[pos], fittedParameters[pos], debugParams[pos], debugNames);
+  }
+
+  return results;
+};
+
+mitk::ModelFitFunctorBase::ParametersVectorType
+mitk::ModelFitFunctorBase::
+DoModelFits(const SignalBatchType& values, const ModelBase* model,
+            const ParametersVectorType& initialParameters,
+            DebugParameterMapVectorType& debugParameters) const
+{
+  ParametersVectorType result(values.size());
+  debugParameters.resize(values.size());
+
+  for (SignalBatchType::size_type pos = 0; pos < values.size(); ++pos)
+  {
+    result[pos] = DoModelFit(values[pos], model, initialParameters[pos], debugParameters[pos]);
+  }
+
+  return result;
+};
+
+mitk::ModelFitFunctorBase::OutputPixelArrayType
+mitk::ModelFitFunctorBase::
+ComposeResult(const ModelBase* model, const SignalType& sample, const ParametersType& fittedParameters,
+              const DebugParameterMapType& debugParams, const ParameterNamesType& debugNames) const
+{
   OutputPixelArrayType derivedParameters = this->GetDerivedParameters(model, fittedParameters);
 
   OutputPixelArrayType criteria = this->GetCriteria(model, fittedParameters, sample);
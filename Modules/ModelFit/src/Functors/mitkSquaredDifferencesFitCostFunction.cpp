@@ -28,3 +28,20 @@ mitk::SquaredDifferencesFitCostFunction::MeasureType mitk::SquaredDifferencesFit
 
   return measure;
 }
+
+bool mitk::SquaredDifferencesFitCostFunction::SupportsAnalyticDerivative() const
+{
+  return true;
+}
+
+void mitk::SquaredDifferencesFitCostFunction::CalcMeasureDerivative(const ParametersType &/*parameters*/, const SignalType &signal,
+  const ModelBase::ModelJacobianType& jacobian, DerivativeType& derivative) const
+{
+  for (DerivativeType::size_type i = 0; i < derivative.rows(); ++i)
+  {
+    for (SignalType::size_type j = 0; j < signal.GetSize(); ++j)
+    {
+      derivative[i][j] = -2 * (m_Sample[j] - signal[j]) * jacobian[i][j];
+    }
+  }
+}
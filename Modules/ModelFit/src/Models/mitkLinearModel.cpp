@@ -26,6 +26,11 @@ std::string mitk::LinearModel::GetModelType() const
   return "Generic";
 };
 
+bool mitk::LinearModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
 mitk::LinearModel::FunctionStringType mitk::LinearModel::GetFunctionString() const
 {
   return "slope*x+offset";
@@ -82,6 +87,20 @@ mitk::LinearModel::ComputeModelfunction(const ParametersType& parameters) const
   return signal;
 };
 
+mitk::LinearModel::ModelJacobianType
+mitk::LinearModel::ComputeModelJacobian(const ParametersType& /*parameters*/) const
+{
+  ModelJacobianType jacobian(2, m_TimeGrid.GetSize());
+
+  for (TimeGridType::size_type i = 0; i < m_TimeGrid.GetSize(); ++i)
+  {
+    jacobian[0][i] = m_TimeGrid[i];
+    jacobian[1][i] = 1.0;
+  }
+
+  return jacobian;
+};
+
 mitk::LinearModel::ParameterNamesType mitk::LinearModel::GetStaticParameterNames() const
 {
   ParameterNamesType result;
@@ -150,6 +150,91 @@ mitk::ModelBase::ModelResultType mitk::ModelBase::GetSignal(const ParametersType
   return signal;
 }
 
+mitk::ModelBase::ModelResultBatchType mitk::ModelBase::GetSignals(const ParametersBatchType& parameters) const
+{
+  if (parameters.cols() != this->GetNumberOfParameters())
+  {
+    itkExceptionMacro("Passed parameter batch has wrong size for model. Cannot evaluate model. Required number of columns: "
+                      << this->GetNumberOfParameters() << "; passed columns: " << parameters.cols());
+  }
+
+  std::string error;
+
+  if (!ValidateModel(error))
+  {
+    itkExceptionMacro("Cannot evaluate model and return signals. Model is in an invalid state. Validation error: "
+                      << error);
+  }
+
+  ModelResultBatchType signals = ComputeModelfunctions(parameters);
+
+  if (signals.rows() != parameters.rows() || signals.cols() != m_TimeGrid.GetSize())
+  {
+    itkExceptionMacro("Model signal batch has wrong size. Required size: " << parameters.rows() << "x" << m_TimeGrid.GetSize()
+                      << "; computed size: " << signals.rows() << "x" << signals.cols());
+  }
+
+  return signals;
+}
+
+mitk::ModelBase::ModelResultBatchType mitk::ModelBase::ComputeModelfunctions(const ParametersBatchType& parameters) const
+{
+  ModelResultBatchType signals(parameters.rows(), m_TimeGrid.GetSize());
+  ParametersType rowParameters(parameters.cols());
+
+  for (unsigned int row = 0; row < parameters.rows(); ++row)
+  {
+    rowParameters.copy_in(parameters[row]);
+    ModelResultType signal = ComputeModelfunction(rowParameters);
+
+    if (signal.GetSize() != signals.cols())
+    {
+      itkExceptionMacro("Model signal has wrong size. Required size: " << signals.cols() << "; computed size: " << signal.GetSize());
+    }
+
+    signals.set_row(row, signal);
+  }
+
+  return signals;
+};
+
+bool mitk::ModelBase::HasAnalyticJacobian() const
+{
+  return false;
+};
+
+mitk::ModelBase::ModelJacobianType mitk::ModelBase::GetSignalJacobian(const ParametersType& parameters) const
+{
+  if (parameters.size() != this->GetNumberOfParameters())
+  {
+    itkExceptionMacro("Passed parameter set has wrong size for model. Cannot evaluate model jacobian. Required size: "
+                      << this->GetNumberOfParameters() << "; passed parameters: " << parameters);
+  }
+
+  std::string error;
+
+  if (!ValidateModel(error))
+  {
+    itkExceptionMacro("Cannot evaluate model jacobian. Model is in an invalid state. Validation error: "
+                      << error);
+  }
+
+  ModelJacobianType jacobian = ComputeModelJacobian(parameters);
+
+  if (jacobian.rows() != parameters.size() || jacobian.cols() != m_TimeGrid.GetSize())
+  {
+    itkExceptionMacro("Model jacobian has wrong size. Required size: " << parameters.size() << "x" << m_TimeGrid.GetSize()
+                      << "; computed size: " << jacobian.rows() << "x" << jacobian.cols());
+  }
+
+  return jacobian;
+}
+
+mitk::ModelBase::ModelJacobianType mitk::ModelBase::ComputeModelJacobian(const ParametersType& /*parameters*/) const
+{
+  itkExceptionMacro("Model " << this->GetClassID() << " does not implement an analytic jacobian.");
+};
+
 bool mitk::ModelBase::ValidateModel(std::string& /*error*/) const
 {
   return true;
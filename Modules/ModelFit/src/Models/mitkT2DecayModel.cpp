@@ -26,6 +26,11 @@ std::string mitk::T2DecayModel::GetModelType() const
   return "MRSignal";
 };
 
+bool mitk::T2DecayModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
 mitk::T2DecayModel::FunctionStringType mitk::T2DecayModel::GetFunctionString() const
 {
   return "M0 * exp(-t/T2)";
@@ -61,11 +66,27 @@ mitk::T2DecayModel::ComputeModelfunction(const ParametersType& parameters) const
   for (const auto& gridPos : m_TimeGrid)
   {
     *signalPos = parameters[0] * exp(-1.0 * gridPos/ parameters[1]);
+    ++signalPos;
   }
 
   return signal;
 };
 
+mitk::T2DecayModel::ModelJacobianType
+mitk::T2DecayModel::ComputeModelJacobian(const ParametersType& parameters) const
+{
+  ModelJacobianType jacobian(this->GetNumberOfParameters(), m_TimeGrid.GetSize());
+
+  for (TimeGridType::size_type i = 0; i < m_TimeGrid.GetSize(); ++i)
+  {
+    const double decay = exp(-1.0 * m_TimeGrid[i] / parameters[1]);
+    jacobian[0][i] = decay;
+    jacobian[1][i] = parameters[0] * decay * m_TimeGrid[i] / (parameters[1] * parameters[1]);
+  }
+
+  return jacobian;
+};
+
 mitk::T2DecayModel::ParameterNamesType mitk::T2DecayModel::GetStaticParameterNames() const
 {
   ParameterNamesType result;
@@ -1,5 +1,6 @@
 SET(MODULE_TESTS
   itkMultiOutputNaryFunctorImageFilterTest.cpp
+  itkMultiOutputTimeSeriesFunctorImageFilterTest.cpp
   itkMaskedStatisticsImageFilterTest.cpp
   itkMaskedNaryStatisticsImageFilterTest.cpp
   mitkLevenbergMarquardtModelFitFunctorTest.cpp
@@ -13,4 +14,5 @@ SET(MODULE_TESTS
   mitkMVConstrainedCostFunctionDecoratorTest.cpp
   mitkConcreteModelFactoryBaseTest.cpp
   mitkFormulaParserTest.cpp
+  mitkModelFitBenchmarkTest.cpp
 )
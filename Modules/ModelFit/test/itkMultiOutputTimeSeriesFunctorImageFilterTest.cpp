@@ -0,0 +1,229 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+
+#include "itkMultiOutputTimeSeriesFunctorImageFilter.h"
+
+#include "mitkTestingMacros.h"
+#include "mitkVector.h"
+
+#include "mitkTestArtifactGenerator.h"
+
+class TestTimeSeriesFunctor
+{
+public:
+  typedef std::vector<int> InputPixelArrayType;
+  typedef std::vector<int> OutputPixelArrayType;
+  typedef itk::Index<2> IndexType;
+
+  TestTimeSeriesFunctor()
+  {
+    secondOutputSelection = 0;
+  };
+
+  ~TestTimeSeriesFunctor() {};
+
+  int secondOutputSelection;
+
+  unsigned int GetNumberOfOutputs() const
+  {
+    return 4;
+  }
+
+  bool operator!=( const TestTimeSeriesFunctor & other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator==( const TestTimeSeriesFunctor & other ) const
+  {
+    return secondOutputSelection == other.secondOutputSelection;
+  }
+
+  inline OutputPixelArrayType operator()( const InputPixelArrayType & value, const IndexType& currentIndex ) const
+  {
+    OutputPixelArrayType result;
+
+    int sum = 0;
+    for (InputPixelArrayType::const_iterator pos = value.begin(); pos != value.end(); ++pos)
+    {
+      sum += *pos;
+    }
+
+    result.push_back(sum);
+    result.push_back(value[secondOutputSelection]);
+    result.push_back(currentIndex[0]);
+    result.push_back(currentIndex[1]);
+
+    return result;
+  }
+
+  inline std::vector<OutputPixelArrayType> operator()( const std::vector<InputPixelArrayType> & values, const std::vector<IndexType>& indices ) const
+  {
+    std::vector<OutputPixelArrayType> result;
+
+    for (std::vector<InputPixelArrayType>::size_type pos = 0; pos < values.size(); ++pos)
+    {
+      result.push_back((*this)(values[pos], indices[pos]));
+    }
+
+    return result;
+  }
+};
+
+typedef itk::Image<int, 3> TestDynamicImageType;
+
+/** Generates a 2D+t image whose time steps equal mitk::GenerateTestImage() with the factors 1, 10 and 100.*/
+TestDynamicImageType::Pointer GenerateTestDynamicImage()
+{
+  TestDynamicImageType::Pointer image = TestDynamicImageType::New();
+
+  TestDynamicImageType::IndexType start;
+  start.Fill(0);
+
+  TestDynamicImageType::SizeType  size;
+  size[0]  = 3;
+  size[1]  = 3;
+  size[2]  = 3;
+
+  TestDynamicImageType::RegionType region;
+  region.SetSize(size);
+  region.SetIndex(start);
+
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIterator<TestDynamicImageType> it = itk::ImageRegionIterator<TestDynamicImageType>(image,
+      image->GetLargestPossibleRegion());
+
+  int count = 0;
+  int factor = 1;
+
+  while (!it.IsAtEnd())
+  {
+    if (count == 9)
+    {
+      count = 0;
+      factor *= 10;
+    }
+    ++count;
+
+    it.Set(count * factor);
+    ++it;
+  }
+
+  return image;
+}
+
+int itkMultiOutputTimeSeriesFunctorImageFilterTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  // always start with this!
+  MITK_TEST_BEGIN("itkMultiOutputTimeSeriesFunctorImageFilter")
+
+  //Prepare test artifacts and helper
+
+  TestDynamicImageType::Pointer dynamicImage = GenerateTestDynamicImage();
+
+  mitk::TestImageType::IndexType testIndex1;
+  testIndex1[0] =   0;
+  testIndex1[1] =   0;
+
+  mitk::TestImageType::IndexType testIndex2;
+  testIndex2[0] =   2;
+  testIndex2[1] =   0;
+
+  mitk::TestImageType::IndexType testIndex3;
+  testIndex3[0] =   0;
+  testIndex3[1] =   1;
+
+  mitk::TestImageType::IndexType testIndex4;
+  testIndex4[0] =   1;
+  testIndex4[1] =   1;
+
+  mitk::TestImageType::IndexType testIndex5;
+  testIndex5[0] =   2;
+  testIndex5[1] =   2;
+
+  //Test default usage of filter
+  typedef itk::MultiOutputTimeSeriesFunctorImageFilter<TestDynamicImageType,mitk::TestImageType,TestTimeSeriesFunctor> FilterType;
+  FilterType::Pointer testFilter = FilterType::New();
+
+  testFilter->SetInput(dynamicImage);
+
+  testFilter->SetNumberOfThreads(2);
+
+  testFilter->Update();
+
+  mitk::TestImageType::Pointer out1 = testFilter->GetOutput(0);
+  mitk::TestImageType::Pointer out2 = testFilter->GetOutput(1);
+  mitk::TestImageType::Pointer out3 = testFilter->GetOutput(2);
+  mitk::TestImageType::Pointer out4 = testFilter->GetOutput(3);
+
+  CPPUNIT_ASSERT_MESSAGE("Check size of output #1", out1->GetLargestPossibleRegion().GetSize()[0] == 3 && out1->GetLargestPossibleRegion().GetSize()[1] == 3);
+
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #1 index #1 (functor #1)",111 == out1->GetPixel(testIndex1));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #1 index #2 (functor #1)",333 == out1->GetPixel(testIndex2));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #1 index #3 (functor #1)",444 == out1->GetPixel(testIndex3));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #1 index #4 (functor #1)",555 == out1->GetPixel(testIndex4));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #1 index #5 (functor #1)",999 == out1->GetPixel(testIndex5));
+
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #2 index #1 (functor #1)",1 == out2->GetPixel(testIndex1));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #2 index #2 (functor #1)",3 == out2->GetPixel(testIndex2));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #2 index #3 (functor #1)",4 == out2->GetPixel(testIndex3));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #2 index #4 (functor #1)",5 == out2->GetPixel(testIndex4));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #2 index #5 (functor #1)",9 == out2->GetPixel(testIndex5));
+
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #3 index #2 (functor #1)",2 == out3->GetPixel(testIndex2));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #3 index #4 (functor #1)",1 == out3->GetPixel(testIndex4));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #4 index #3 (functor #1)",1 == out4->GetPixel(testIndex3));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #4 index #5 (functor #1)",2 == out4->GetPixel(testIndex5));
+
+  //Test with functor set by user
+  TestTimeSeriesFunctor funct2;
+  funct2.secondOutputSelection = 2;
+
+  testFilter->SetFunctor(funct2);
+
+  testFilter->Update();
+
+  out2 = testFilter->GetOutput(1);
+
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #2 index #1 (functor #2)",100 == out2->GetPixel(testIndex1));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #2 index #2 (functor #2)",300 == out2->GetPixel(testIndex2));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of output #2 index #5 (functor #2)",900 == out2->GetPixel(testIndex5));
+
+  //Test with mask set
+  mitk::TestMaskType::Pointer mask = mitk::GenerateTestMask();
+  testFilter->SetMask(mask);
+
+  testFilter->Update();
+
+  out1 = testFilter->GetOutput(0);
+  out2 = testFilter->GetOutput(1);
+
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #1 (functor #2)",0 == out1->GetPixel(testIndex1));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #2 (functor #2)",333 == out1->GetPixel(testIndex2));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #3 (functor #2)",444 == out1->GetPixel(testIndex3));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #4 (functor #2)",0 == out1->GetPixel(testIndex4));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #5 (functor #2)",0 == out1->GetPixel(testIndex5));
+
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #2 index #2 (functor #2)",300 == out2->GetPixel(testIndex2));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #2 index #5 (functor #2)",0 == out2->GetPixel(testIndex5));
+
+  MITK_TEST_END()
+}
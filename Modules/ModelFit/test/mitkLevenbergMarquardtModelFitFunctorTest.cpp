@@ -85,5 +85,40 @@ int mitkLevenbergMarquardtModelFitFunctorTest(int  /*argc*/, char*[] /*argv[]*/)
   MITK_TEST_CONDITION_REQUIRED(mitk::Equal(-5, output[2], 1e-6, true) == true,
                                "Check derived parameter 1 (x-intercept) for sample 2.");
 
+  //Test batch fits with and without the batched solver
+  ValueArrayType sample3(10);
+  for (int i = 0; i < 10; ++i)
+  {
+    sample3[i] = -3 * i + 1;
+  }
+
+  mitk::ModelFitFunctorBase::InputPixelArrayBatchType samples;
+  samples.push_back(sample1);
+  samples.push_back(sample2);
+  samples.push_back(sample3);
+  mitk::ModelFitFunctorBase::InitialParametersBatchType initParamsBatch(3, initParams);
+
+  const double expectedSlopes[3] = { 5, 2, -3 };
+  const double expectedOffsets[3] = { 0, 10, 1 };
+
+  for (int batched = 0; batched < 2; ++batched)
+  {
+    testFunctor->SetUseBatchedSolver(batched == 1);
+    mitk::ModelFitFunctorBase::OutputPixelArrayBatchType outputs = testFunctor->Compute(samples, model, initParamsBatch);
+
+    CPPUNIT_ASSERT_MESSAGE("Check number of functor outputs of batch.", 3 == outputs.size());
+
+    for (unsigned int pos = 0; pos < outputs.size(); ++pos)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Check number of values in functor output of batch.", 4 == outputs[pos].size());
+      MITK_TEST_CONDITION_REQUIRED(mitk::Equal(expectedSlopes[pos], outputs[pos][0], 1e-6, true) == true,
+                                   "Check fitted parameter 1 (slope) of batch sample " << pos << " (batched solver: " << batched << ").");
+      MITK_TEST_CONDITION_REQUIRED(mitk::Equal(expectedOffsets[pos], outputs[pos][1], 1e-6, true) == true,
+                                   "Check fitted parameter 2 (offset) of batch sample " << pos << " (batched solver: " << batched << ").");
+    }
+  }
+
+  MITK_TEST_FOR_EXCEPTION(::itk::ExceptionObject, testFunctor->Compute(samples, model, mitk::ModelFitFunctorBase::InitialParametersBatchType(2, initParams)));
+
   MITK_TEST_END()
 }
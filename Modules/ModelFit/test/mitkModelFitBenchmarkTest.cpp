@@ -0,0 +1,103 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <chrono>
+#include <cmath>
+
+#include "itkImageRegionConstIterator.h"
+
+#include "mitkTestingMacros.h"
+#include "mitkImage.h"
+#include "mitkImageCast.h"
+
+#include "mitkPixelBasedParameterFitImageGenerator.h"
+#include "mitkLinearModelParameterizer.h"
+#include "mitkLevenbergMarquardtModelFitFunctor.h"
+
+#include "mitkTestArtifactGenerator.h"
+
+namespace
+{
+  typedef itk::Image<mitk::ScalarType, 3> ParameterITKImageType;
+
+  mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType FitTestImage(mitk::Image* dynamicImage, bool useAnalyticDerivative,
+    unsigned int repetitions, double& duration)
+  {
+    mitk::LevenbergMarquardtModelFitFunctor::Pointer fitFunctor = mitk::LevenbergMarquardtModelFitFunctor::New();
+    fitFunctor->SetUseAnalyticDerivative(useAnalyticDerivative);
+
+    mitk::PixelBasedParameterFitImageGenerator::Pointer generator = mitk::PixelBasedParameterFitImageGenerator::New();
+    mitk::LinearModelParameterizer::Pointer parameterizer = mitk::LinearModelParameterizer::New();
+    generator->SetDynamicImage(dynamicImage);
+    generator->SetModelParameterizer(parameterizer);
+    generator->SetFitFunctor(fitFunctor);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < repetitions; ++i)
+    {
+      generator->Generate();
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+    duration = std::chrono::duration<double, std::milli>(stop - start).count() / repetitions;
+
+    return generator->GetParameterImages();
+  }
+
+  double MaximumDifference(mitk::Image* image1, mitk::Image* image2)
+  {
+    ParameterITKImageType::Pointer itkImage1;
+    ParameterITKImageType::Pointer itkImage2;
+    mitk::CastToItkImage(image1, itkImage1);
+    mitk::CastToItkImage(image2, itkImage2);
+
+    itk::ImageRegionConstIterator<ParameterITKImageType> iter1(itkImage1, itkImage1->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ParameterITKImageType> iter2(itkImage2, itkImage2->GetLargestPossibleRegion());
+
+    double result = 0.0;
+    for (; !iter1.IsAtEnd(); ++iter1, ++iter2)
+    {
+      result = std::max(result, std::abs(iter1.Get() - iter2.Get()));
+    }
+    return result;
+  }
+}
+
+/**Fits the dynamic test artifact with analytic and with numeric derivatives, checks that both
+ yield the same parameters and reports the average fitting time of both variants.*/
+int mitkModelFitBenchmarkTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  MITK_TEST_BEGIN("ModelFitBenchmark")
+
+  mitk::Image::Pointer dynamicImage = mitk::GenerateDynamicTestImageMITK();
+  const unsigned int repetitions = 20;
+
+  double numericDuration = 0.0;
+  auto numericResults = FitTestImage(dynamicImage, false, repetitions, numericDuration);
+
+  double analyticDuration = 0.0;
+  auto analyticResults = FitTestImage(dynamicImage, true, repetitions, analyticDuration);
+
+  MITK_INFO << "Average fitting time of the test artifact. Numeric derivative: " << numericDuration
+            << " ms; analytic derivative: " << analyticDuration << " ms";
+
+  CPPUNIT_ASSERT_MESSAGE("Check number of parameter images", 2 == analyticResults.size());
+  MITK_TEST_CONDITION(MaximumDifference(numericResults["slope"], analyticResults["slope"]) < 1e-4,
+                      "Check that the slope is the same for analytic and numeric derivatives.");
+  MITK_TEST_CONDITION(MaximumDifference(numericResults["offset"], analyticResults["offset"]) < 1e-4,
+                      "Check that the offset is the same for analytic and numeric derivatives.");
+
+  MITK_TEST_END()
+}
@@ -15,6 +15,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include <mitkIOUtil.h>
+#include <mitkImagePixelWriteAccessor.h>
 #include <mitkImageStatisticsHolder.h>
 #include <mitkLabelSetImage.h>
 #include <mitkTestFixture.h>
@@ -38,6 +39,8 @@ class mitkLabelSetImageTestSuite : public mitk::TestFixture
   MITK_TEST(TestRemoveLayer);
   MITK_TEST(TestRemoveLabels);
   MITK_TEST(TestMergeLabel);
+  MITK_TEST(TestLabelIndex);
+  MITK_TEST(TestUpdateLabelIndex);
   // TODO check it these functionalities can be moved into a process object
   //  MITK_TEST(TestMergeLabels);
   //  MITK_TEST(TestConcatenate);
@@ -443,6 +446,110 @@ public:
     // Check if merge label has 507 + 823 = 1330 pixels
     CPPUNIT_ASSERT_MESSAGE("Label with value 7 was not remove from the image", m_LabelSetImage->GetStatistics()->GetCountOfMaxValuedVoxels() == 1330);
   }
+
+  // Writes a 2x3x4 block of label 1 starting at (10, 20, 30) and a single voxel of label 2 at (100, 100, 100)
+  void WriteLabelBlocks()
+  {
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      for (itk::IndexValueType z = 30; z < 34; ++z)
+        for (itk::IndexValueType y = 20; y < 23; ++y)
+          for (itk::IndexValueType x = 10; x < 12; ++x)
+          {
+            itk::Index<3> index = {{x, y, z}};
+            accessor.SetPixelByIndex(index, 1);
+          }
+
+      itk::Index<3> index = {{100, 100, 100}};
+      accessor.SetPixelByIndex(index, 2);
+    }
+    m_LabelSetImage->Modified();
+  }
+
+  void TestLabelIndex()
+  {
+    this->WriteLabelBlocks();
+
+    CPPUNIT_ASSERT_EQUAL(24ul, m_LabelSetImage->GetNumberOfLabelVoxels(1));
+    CPPUNIT_ASSERT_EQUAL(1ul, m_LabelSetImage->GetNumberOfLabelVoxels(2));
+    CPPUNIT_ASSERT_EQUAL(0ul, m_LabelSetImage->GetNumberOfLabelVoxels(3));
+
+    std::vector<unsigned int> axialCounts = m_LabelSetImage->GetLabelCountsInSlices(1, 2);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(312), axialCounts.size());
+    CPPUNIT_ASSERT_EQUAL(0u, axialCounts[29]);
+    CPPUNIT_ASSERT_EQUAL(6u, axialCounts[30]);
+    CPPUNIT_ASSERT_EQUAL(6u, axialCounts[33]);
+    CPPUNIT_ASSERT_EQUAL(0u, axialCounts[34]);
+    CPPUNIT_ASSERT_EQUAL(12u, m_LabelSetImage->GetLabelCountsInSlices(1, 0)[11]);
+
+    mitk::LabelSetImage::IndexRegionType region;
+    CPPUNIT_ASSERT(m_LabelSetImage->GetLabelBoundingRegion(1, region));
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(10), region.GetIndex(0));
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(20), region.GetIndex(1));
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(30), region.GetIndex(2));
+    CPPUNIT_ASSERT_EQUAL(itk::SizeValueType(2), region.GetSize(0));
+    CPPUNIT_ASSERT_EQUAL(itk::SizeValueType(3), region.GetSize(1));
+    CPPUNIT_ASSERT_EQUAL(itk::SizeValueType(4), region.GetSize(2));
+    CPPUNIT_ASSERT(!m_LabelSetImage->GetLabelBoundingRegion(3, region));
+
+    std::vector<mitk::Label::PixelType> values = m_LabelSetImage->GetLabelValuesInImage();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), values.size());
+    CPPUNIT_ASSERT_EQUAL(mitk::Label::PixelType(2), values[2]);
+
+    // the center of mass is the middle voxel in memory order, the first one of slice 32
+    mitk::Label::Pointer label = mitk::Label::New();
+    label->SetValue(1);
+    m_LabelSetImage->GetActiveLabelSet()->AddLabel(label);
+    m_LabelSetImage->UpdateCenterOfMass(1);
+    mitk::Point3D center = m_LabelSetImage->GetLabel(1)->GetCenterOfMassIndex();
+    CPPUNIT_ASSERT_EQUAL(10.0, center[0]);
+    CPPUNIT_ASSERT_EQUAL(20.0, center[1]);
+    CPPUNIT_ASSERT_EQUAL(32.0, center[2]);
+  }
+
+  void TestUpdateLabelIndex()
+  {
+    this->WriteLabelBlocks();
+    CPPUNIT_ASSERT_EQUAL(24ul, m_LabelSetImage->GetNumberOfLabelVoxels(1));
+
+    // overwrite parts of slice 30 like a segmentation tool does
+    mitk::LabelSetImage::IndexRegionType slice;
+    slice.SetSize(0, 256);
+    slice.SetSize(1, 256);
+    slice.SetSize(2, 1);
+    slice.SetIndex(2, 30);
+
+    m_LabelSetImage->BeginLabelIndexUpdate(slice);
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      itk::Index<3> index = {{10, 20, 30}};
+      accessor.SetPixelByIndex(index, 2);
+      index[0] = 0;
+      index[1] = 0;
+      accessor.SetPixelByIndex(index, 1);
+    }
+    m_LabelSetImage->EndLabelIndexUpdate(slice);
+    m_LabelSetImage->Modified();
+
+    std::vector<unsigned int> updatedCounts[3];
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      updatedCounts[dim] = m_LabelSetImage->GetLabelCountsInSlices(1, dim);
+
+    CPPUNIT_ASSERT_EQUAL(24ul, m_LabelSetImage->GetNumberOfLabelVoxels(1));
+    CPPUNIT_ASSERT_EQUAL(2ul, m_LabelSetImage->GetNumberOfLabelVoxels(2));
+    CPPUNIT_ASSERT_EQUAL(6u, updatedCounts[2][30]);
+    CPPUNIT_ASSERT_EQUAL(1u, updatedCounts[0][0]);
+
+    mitk::LabelSetImage::IndexRegionType region;
+    CPPUNIT_ASSERT(m_LabelSetImage->GetLabelBoundingRegion(1, region));
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(0), region.GetIndex(0));
+    CPPUNIT_ASSERT_EQUAL(itk::SizeValueType(12), region.GetSize(0));
+
+    // a modification without index update causes a rescan, which has to give the same result
+    m_LabelSetImage->Modified();
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      CPPUNIT_ASSERT(updatedCounts[dim] == m_LabelSetImage->GetLabelCountsInSlices(1, dim));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImage)
@@ -20,9 +20,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageCast.h"
 #include "mitkImagePixelReadAccessor.h"
 #include "mitkImagePixelWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
 #include "mitkInteractionConst.h"
 #include "mitkLookupTableProperty.h"
 #include "mitkPadImageFilter.h"
+#include "mitkPlaneGeometry.h"
 #include "mitkRenderingManager.h"
 #include "mitkDICOMSegmentationPropertyHelper.h"
 #include "mitkDICOMQIPropertyHelper.h"
@@ -38,6 +40,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkCommand.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 template <typename TPixel, unsigned int VDimensions>
 void SetToZero(itk::Image<TPixel, VDimensions> *source)
 {
@@ -65,7 +71,7 @@ void CreateLabelMaskProcessing(mitk::Image *layerImage, mitk::Image *mask, mitk:
 }
 
 mitk::LabelSetImage::LabelSetImage()
-  : mitk::Image(), m_ActiveLayer(0), m_activeLayerInvalid(false), m_ExteriorLabel(nullptr)
+  : mitk::Image(), m_ActiveLayer(0), m_activeLayerInvalid(false), m_ExteriorLabel(nullptr), m_ModificationCount(0)
 {
   // Iniitlaize Background Label
   mitk::Color color;
@@ -85,7 +91,8 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
   : Image(other),
     m_ActiveLayer(other.GetActiveLayer()),
     m_activeLayerInvalid(false),
-    m_ExteriorLabel(other.GetExteriorLabel()->Clone())
+    m_ExteriorLabel(other.GetExteriorLabel()->Clone()),
+    m_ModificationCount(0)
 {
   for (unsigned int i = 0; i < other.GetNumberOfLayers(); i++)
   {
@@ -126,6 +133,271 @@ const mitk::Label *mitk::LabelSetImage::GetExteriorLabel() const
   return m_ExteriorLabel;
 }
 
+void mitk::LabelSetImage::Modified() const
+{
+  {
+    std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+    ++m_ModificationCount;
+    for (auto &index : m_LabelIndex)
+    {
+      // an index that was updated by the writer stays valid for the modification that announces the write
+      if (index.KeepValid && index.Valid && !index.UpdatePending)
+      {
+        index.ModificationCount = m_ModificationCount;
+      }
+      index.KeepValid = false;
+    }
+  }
+  Superclass::Modified();
+}
+
+bool mitk::LabelSetImage::IsLabelIndexUpToDate(unsigned int timeStep) const
+{
+  return timeStep < m_LabelIndex.size() && m_LabelIndex[timeStep].Valid && !m_LabelIndex[timeStep].UpdatePending &&
+         m_LabelIndex[timeStep].ModificationCount == m_ModificationCount;
+}
+
+const mitk::LabelSetImage::TimeStepLabelIndex &mitk::LabelSetImage::GetLabelIndex(unsigned int timeStep) const
+{
+  if (timeStep >= this->GetTimeSteps())
+    mitkThrow() << "Time step " << timeStep << " does not exist.";
+
+  if (m_LabelIndex.size() < this->GetTimeSteps())
+    m_LabelIndex.resize(this->GetTimeSteps());
+
+  TimeStepLabelIndex &index = m_LabelIndex[timeStep];
+  if (!this->IsLabelIndexUpToDate(timeStep))
+  {
+    IndexRegionType region;
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      region.SetSize(dim, this->GetDimension(dim));
+
+    index.Labels.clear();
+    index.UpdatePending = false;
+    index.KeepValid = false;
+    this->ScanLabelIndexRegion(index, region, timeStep, true);
+    index.Valid = true;
+    index.ModificationCount = m_ModificationCount;
+  }
+  return index;
+}
+
+void mitk::LabelSetImage::ChangeLabelIndex(
+  TimeStepLabelIndex &index, PixelType pixelValue, unsigned int x, unsigned int y, unsigned int z, bool add) const
+{
+  LabelIndexEntry &entry = index.Labels[pixelValue];
+  if (entry.CountsInSlices[0].empty())
+  {
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      entry.CountsInSlices[dim].assign(this->GetDimension(dim), 0);
+  }
+
+  if (add)
+  {
+    ++entry.NumberOfVoxels;
+    ++entry.CountsInSlices[0][x];
+    ++entry.CountsInSlices[1][y];
+    ++entry.CountsInSlices[2][z];
+  }
+  else
+  {
+    --entry.NumberOfVoxels;
+    --entry.CountsInSlices[0][x];
+    --entry.CountsInSlices[1][y];
+    --entry.CountsInSlices[2][z];
+  }
+}
+
+void mitk::LabelSetImage::ScanLabelIndexRegion(TimeStepLabelIndex &index,
+                                               const IndexRegionType &region,
+                                               unsigned int timeStep,
+                                               bool add) const
+{
+  if (this->GetPixelType().GetComponentType() != MapPixelComponentType<PixelType>::value)
+    mitkThrow() << "The label index requires the pixel type of the labels.";
+
+  IndexRegionType largestRegion;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+    largestRegion.SetSize(dim, this->GetDimension(dim));
+
+  IndexRegionType croppedRegion = region;
+  if (!croppedRegion.Crop(largestRegion))
+    return;
+
+  const std::size_t sizeX = this->GetDimension(0);
+  const std::size_t sizeY = this->GetDimension(1);
+
+  ImageReadAccessor accessor(this, this->GetVolumeData(timeStep));
+  const auto *data = static_cast<const PixelType *>(accessor.GetData());
+
+  const auto begin = croppedRegion.GetIndex();
+  const auto end = croppedRegion.GetUpperIndex();
+
+  for (auto z = begin[2]; z <= end[2]; ++z)
+  {
+    for (auto y = begin[1]; y <= end[1]; ++y)
+    {
+      const PixelType *line = data + (static_cast<std::size_t>(z) * sizeY + y) * sizeX;
+      for (auto x = begin[0]; x <= end[0]; ++x)
+      {
+        this->ChangeLabelIndex(index,
+                               line[x],
+                               static_cast<unsigned int>(x),
+                               static_cast<unsigned int>(y),
+                               static_cast<unsigned int>(z),
+                               add);
+      }
+    }
+  }
+}
+
+std::vector<unsigned int> mitk::LabelSetImage::GetLabelCountsInSlices(PixelType pixelValue,
+                                                                      unsigned int dimension,
+                                                                      unsigned int timeStep) const
+{
+  if (dimension > 2)
+    mitkThrow() << "Invalid dimension " << dimension << ".";
+
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+  const TimeStepLabelIndex &index = this->GetLabelIndex(timeStep);
+
+  auto iter = index.Labels.find(pixelValue);
+  if (iter == index.Labels.end())
+    return std::vector<unsigned int>(this->GetDimension(dimension), 0);
+
+  return iter->second.CountsInSlices[dimension];
+}
+
+unsigned long mitk::LabelSetImage::GetNumberOfLabelVoxels(PixelType pixelValue, unsigned int timeStep) const
+{
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+  const TimeStepLabelIndex &index = this->GetLabelIndex(timeStep);
+
+  auto iter = index.Labels.find(pixelValue);
+  return iter != index.Labels.end() ? iter->second.NumberOfVoxels : 0;
+}
+
+bool mitk::LabelSetImage::GetLabelBoundingRegion(PixelType pixelValue,
+                                                 IndexRegionType &region,
+                                                 unsigned int timeStep) const
+{
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+  const TimeStepLabelIndex &index = this->GetLabelIndex(timeStep);
+
+  auto iter = index.Labels.find(pixelValue);
+  if (iter == index.Labels.end() || iter->second.NumberOfVoxels == 0)
+    return false;
+
+  // the first and the last slice of each direction that contain the label
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    const std::vector<unsigned int> &counts = iter->second.CountsInSlices[dim];
+    std::size_t first = 0;
+    while (counts[first] == 0)
+      ++first;
+    std::size_t last = counts.size() - 1;
+    while (counts[last] == 0)
+      --last;
+
+    region.SetIndex(dim, first);
+    region.SetSize(dim, last - first + 1);
+  }
+  return true;
+}
+
+std::vector<mitk::LabelSetImage::PixelType> mitk::LabelSetImage::GetLabelValuesInImage(unsigned int timeStep) const
+{
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+  const TimeStepLabelIndex &index = this->GetLabelIndex(timeStep);
+
+  std::vector<PixelType> values;
+  for (const auto &entry : index.Labels)
+  {
+    if (entry.second.NumberOfVoxels > 0)
+      values.push_back(entry.first);
+  }
+  return values;
+}
+
+void mitk::LabelSetImage::BeginLabelIndexUpdate(const IndexRegionType &region, unsigned int timeStep)
+{
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+  if (timeStep >= m_LabelIndex.size())
+    return;
+
+  // an outdated index is rebuilt on the next request anyway
+  if (!this->IsLabelIndexUpToDate(timeStep))
+  {
+    m_LabelIndex[timeStep].Valid = false;
+    return;
+  }
+
+  this->ScanLabelIndexRegion(m_LabelIndex[timeStep], region, timeStep, false);
+  m_LabelIndex[timeStep].UpdatePending = true;
+}
+
+void mitk::LabelSetImage::EndLabelIndexUpdate(const IndexRegionType &region, unsigned int timeStep)
+{
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+  if (timeStep >= m_LabelIndex.size())
+    return;
+
+  TimeStepLabelIndex &index = m_LabelIndex[timeStep];
+  if (!index.Valid || !index.UpdatePending || index.ModificationCount != m_ModificationCount)
+  {
+    index.Valid = false;
+    return;
+  }
+
+  this->ScanLabelIndexRegion(index, region, timeStep, true);
+  index.UpdatePending = false;
+  index.KeepValid = true;
+}
+
+mitk::LabelSetImage::IndexRegionType mitk::LabelSetImage::GetRegionOfPlane(const PlaneGeometry *plane,
+                                                                         unsigned int timeStep) const
+{
+  IndexRegionType largestRegion;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+    largestRegion.SetSize(dim, this->GetDimension(dim));
+
+  if (!plane)
+    return largestRegion;
+
+  double minimum[3];
+  double maximum[3];
+  std::fill(minimum, minimum + 3, std::numeric_limits<double>::max());
+  std::fill(maximum, maximum + 3, std::numeric_limits<double>::lowest());
+
+  const BaseGeometry *geometry = this->GetGeometry(timeStep);
+  for (int id = 0; id < 8; ++id)
+  {
+    mitk::Point3D index;
+    geometry->WorldToIndex(plane->GetCornerPoint(id), index);
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      minimum[dim] = std::min(minimum[dim], index[dim]);
+      maximum[dim] = std::max(maximum[dim], index[dim]);
+    }
+  }
+
+  // one voxel more on each side, the reslicer rounds to the nearest voxel
+  IndexRegionType region;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    const auto lower = static_cast<IndexRegionType::IndexValueType>(std::floor(minimum[dim])) - 1;
+    const auto upper = static_cast<IndexRegionType::IndexValueType>(std::ceil(maximum[dim])) + 1;
+    region.SetIndex(dim, lower);
+    region.SetSize(dim, upper - lower + 1);
+  }
+
+  if (!region.Crop(largestRegion))
+  {
+    region.SetSize(IndexRegionType::SizeType{{0, 0, 0}});
+  }
+  return region;
+}
+
 void mitk::LabelSetImage::Initialize(const mitk::Image *other)
 {
   mitk::PixelType pixelType(mitk::MakeScalarPixelType<LabelSetImage::PixelType>());
@@ -524,11 +796,47 @@ void mitk::LabelSetImage::UpdateCenterOfMass(PixelType pixelValue, unsigned int
   if (4 == this->GetDimension())
   {
     AccessFixedDimensionByItk_2(this, CalculateCenterOfMassProcessing, 4, pixelValue, layer);
+    return;
   }
-  else
+
+  // the center is the voxel in the middle of all label voxels in memory order. The slice counts of the
+  // label index tell in which axial slice it is, so that only this slice has to be scanned.
+  mitk::Point3D pos;
+  pos.Fill(0.0);
+
+  const unsigned long numberOfVoxels = this->GetNumberOfLabelVoxels(pixelValue);
+  if (numberOfVoxels > 0)
   {
-    AccessByItk_2(this, CalculateCenterOfMassProcessing, pixelValue, layer);
+    const std::vector<unsigned int> countsInSlices = this->GetLabelCountsInSlices(pixelValue, 2);
+
+    unsigned long remaining = numberOfVoxels / 2;
+    unsigned int z = 0;
+    while (remaining >= countsInSlices[z])
+    {
+      remaining -= countsInSlices[z];
+      ++z;
+    }
+
+    const unsigned int sizeX = this->GetDimension(0);
+    const unsigned int sizeY = this->GetDimension(1);
+
+    ImageReadAccessor accessor(this, this->GetVolumeData(0));
+    const auto *slice = static_cast<const PixelType *>(accessor.GetData()) + static_cast<std::size_t>(z) * sizeX * sizeY;
+    for (std::size_t offset = 0; offset < static_cast<std::size_t>(sizeX) * sizeY; ++offset)
+    {
+      if (slice[offset] == pixelValue && remaining-- == 0)
+      {
+        pos[0] = offset % sizeX;
+        pos[1] = offset / sizeX;
+        pos[2] = z;
+        break;
+      }
+    }
   }
+
+  GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassIndex(pos);
+  this->GetSlicedGeometry()->IndexToWorld(pos, pos); // TODO: TimeGeometry?
+  GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassCoordinates(pos);
 }
 
 unsigned int mitk::LabelSetImage::GetNumberOfLabels(unsigned int layer) const
@@ -570,6 +878,8 @@ void mitk::LabelSetImage::MaskStamp(mitk::Image *mask, bool forceOverwrite)
   {
     mitkThrow() << "Could not stamp the provided mask on the selected label.";
   }
+
+  this->Modified();
 }
 
 mitk::Image::Pointer mitk::LabelSetImage::CreateLabelMask(PixelType index, bool useActiveLayer, unsigned int layer)
@@ -725,7 +1035,18 @@ void mitk::LabelSetImage::MaskStampProcessing(ImageType *itkImage, mitk::Image *
   TargetIteratorType targetIter(itkImage, itkImage->GetLargestPossibleRegion());
   targetIter.GoToBegin();
 
-  int activeLabel = this->GetActiveLabel(GetActiveLayer())->GetValue();
+  PixelType activeLabel = this->GetActiveLabel(GetActiveLayer())->GetValue();
+
+  // the label index is updated voxel by voxel instead of being rescanned after the stamp
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+  TimeStepLabelIndex *labelIndex = nullptr;
+  if (ImageType::ImageDimension == 3 && this->IsLabelIndexUpToDate(0))
+  {
+    labelIndex = &m_LabelIndex[0];
+  }
+
+  const auto size = itkImage->GetLargestPossibleRegion().GetSize();
+  unsigned int index[3] = {0, 0, 0};
 
   while (!sourceIter.IsAtEnd())
   {
@@ -736,12 +1057,31 @@ void mitk::LabelSetImage::MaskStampProcessing(ImageType *itkImage, mitk::Image *
         (forceOverwrite || !this->GetLabel(targetValue)->GetLocked())) // skip exterior and locked labels
     {
       targetIter.Set(activeLabel);
+
+      if (labelIndex && targetValue != activeLabel)
+      {
+        this->ChangeLabelIndex(*labelIndex, targetValue, index[0], index[1], index[2], false);
+        this->ChangeLabelIndex(*labelIndex, activeLabel, index[0], index[1], index[2], true);
+      }
     }
     ++sourceIter;
     ++targetIter;
+
+    if (labelIndex && ++index[0] == size[0])
+    {
+      index[0] = 0;
+      if (++index[1] == size[1])
+      {
+        index[1] = 0;
+        ++index[2];
+      }
+    }
   }
 
-  this->Modified();
+  if (labelIndex)
+  {
+    labelIndex->KeepValid = true;
+  }
 }
 
 template <typename ImageType>
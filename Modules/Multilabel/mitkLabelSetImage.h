@@ -22,12 +22,25 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <MitkMultilabelExports.h>
 
+#include <itkImageRegion.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
 namespace mitk
 {
+  class PlaneGeometry;
+
   //##Documentation
   //## @brief LabelSetImage class for handling labels and layers in a segmentation session.
   //##
   //## Handles operations for adding, removing, erasing and editing labels and layers.
+  //##
+  //## For the active layer, the image keeps an index of the number of voxels of every label in every slice of
+  //## the three image directions. It is built by one scan of a time step on the first request and afterwards
+  //## kept up to date by the writers that only change a part of the image (see BeginLabelIndexUpdate()).
+  //## Any other modification of the image causes a rescan on the next request.
   //## @ingroup Data
 
   class MITKMULTILABEL_EXPORT LabelSetImage : public Image
@@ -36,6 +49,7 @@ namespace mitk
     mitkClassMacro(LabelSetImage, Image) itkNewMacro(Self)
 
       typedef mitk::Label::PixelType PixelType;
+    typedef itk::ImageRegion<3> IndexRegionType;
 
     /**
     * \brief BeforeChangeLayerEvent (e.g. used for GUI integration)
@@ -266,6 +280,53 @@ namespace mitk
 
     const mitk::Label *GetExteriorLabel() const;
 
+    /**
+     * @brief Returns the number of voxels of a label in every slice perpendicular to the given dimension
+     * @param pixelValue the label value
+     * @param dimension the dimension that is constant within the slices, e.g. 2 for axial slices
+     * @param timeStep the time step
+     * @return one count per slice of the active layer, all zero if the label does not occur
+     */
+    std::vector<unsigned int> GetLabelCountsInSlices(PixelType pixelValue,
+                                                     unsigned int dimension,
+                                                     unsigned int timeStep = 0) const;
+
+    /**
+     * @brief Returns the number of voxels of a label in the active layer
+     */
+    unsigned long GetNumberOfLabelVoxels(PixelType pixelValue, unsigned int timeStep = 0) const;
+
+    /**
+     * @brief Gets the bounding region of a label in index coordinates
+     * @return false if the label does not occur in the active layer
+     */
+    bool GetLabelBoundingRegion(PixelType pixelValue, IndexRegionType &region, unsigned int timeStep = 0) const;
+
+    /**
+     * @brief Returns the values of all labels (including the exterior label) that occur in the active layer
+     */
+    std::vector<PixelType> GetLabelValuesInImage(unsigned int timeStep = 0) const;
+
+    /**
+     * @brief Removes the voxels of a region from the label index before they are overwritten.
+     *
+     * Has to be followed by EndLabelIndexUpdate() with the same region once the voxels are written. Call
+     * EndLabelIndexUpdate() before Modified(), so that observers of the modification find an up-to-date index.
+     */
+    void BeginLabelIndexUpdate(const IndexRegionType &region, unsigned int timeStep = 0);
+
+    /**
+     * @brief Adds the voxels of a region to the label index after they were written, see BeginLabelIndexUpdate().
+     */
+    void EndLabelIndexUpdate(const IndexRegionType &region, unsigned int timeStep = 0);
+
+    /**
+     * @brief Returns the region of all voxels that can be changed by writing a slice along the given plane
+     */
+    IndexRegionType GetRegionOfPlane(const PlaneGeometry *plane, unsigned int timeStep = 0) const;
+
+    void Modified() const override;
+
   protected:
     mitkCloneMacro(Self)
 
@@ -314,6 +375,43 @@ namespace mitk
     bool m_activeLayerInvalid;
 
     mitk::Label::Pointer m_ExteriorLabel;
+
+  private:
+    struct LabelIndexEntry
+    {
+      unsigned long NumberOfVoxels = 0;
+      std::vector<unsigned int> CountsInSlices[3];
+    };
+
+    struct TimeStepLabelIndex
+    {
+      bool Valid = false;
+      bool UpdatePending = false;
+      bool KeepValid = false;
+      unsigned long ModificationCount = 0;
+      std::map<PixelType, LabelIndexEntry> Labels;
+    };
+
+    /** Returns the index of the time step and rebuilds it if necessary. The caller has to hold m_LabelIndexMutex. */
+    const TimeStepLabelIndex &GetLabelIndex(unsigned int timeStep) const;
+
+    bool IsLabelIndexUpToDate(unsigned int timeStep) const;
+
+    void ScanLabelIndexRegion(TimeStepLabelIndex &index,
+                              const IndexRegionType &region,
+                              unsigned int timeStep,
+                              bool add) const;
+
+    void ChangeLabelIndex(TimeStepLabelIndex &index,
+                          PixelType pixelValue,
+                          unsigned int x,
+                          unsigned int y,
+                          unsigned int z,
+                          bool add) const;
+
+    mutable std::vector<TimeStepLabelIndex> m_LabelIndex;
+    mutable unsigned long m_ModificationCount;
+    mutable std::mutex m_LabelIndexMutex;
   };
 
   /**
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkDataNode.h>
 #include <mitkImageSliceSelector.h>
 #include <mitkImageStatisticsHolder.h>
+#include <mitkLabelOutlineTracer.h>
 #include <mitkLevelWindowProperty.h>
 #include <mitkLookupTableProperty.h>
 #include <mitkPixelType.h>
@@ -317,150 +318,37 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
 {
   LocalStorage *localStorage = this->GetLocalStorage(renderer);
 
-  // get the min and max index values of each direction
   int *extent = image->GetExtent();
-  int xMin = extent[0];
-  int xMax = extent[1];
-  int yMin = extent[2];
-  int yMax = extent[3];
-
   int *dims = image->GetDimensions(); // dimensions of the image
-  int line = dims[0];                 // how many pixels per line?
-  int x = xMin;                       // pixel index x
-  int y = yMin;                       // pixel index y
 
   // get the depth for each contour
   float depth = this->CalculateLayerDepth(renderer);
 
-  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();      // the points to draw
-  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New(); // the lines to connect the points
+  mitk::LabelOutlineTracer::Outlines outlines;
+  mitk::LabelOutlineTracer::Trace(static_cast<const mitk::Label::PixelType *>(image->GetScalarPointer()), dims[0], dims[1], outlines, mitk::LabelOutlineTracer::SingleLabel, pixelValue);
 
-  // We take the pointer to the first pixel of the image
-  auto *currentPixel = static_cast<mitk::Label::PixelType *>(image->GetScalarPointer());
+  // the outline points are given in pixels relative to the first pixel
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New(); // the points to draw
+  points->SetNumberOfPoints(outlines.GetNumberOfPoints());
+  for (vtkIdType i = 0; i < static_cast<vtkIdType>(outlines.GetNumberOfPoints()); ++i)
+  {
+    points->SetPoint(i,
+                     (outlines.Points[2 * i] + extent[0]) * localStorage->m_mmPerPixel[0],
+                     (outlines.Points[2 * i + 1] + extent[2]) * localStorage->m_mmPerPixel[1],
+                     depth);
+  }
 
-  while (y <= yMax)
+  // one polyline per connected outline
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New(); // the lines to connect the points
+  lines->Allocate(outlines.GetNumberOfLines() + outlines.GetNumberOfPoints());
+  for (std::size_t i = 0; i < outlines.GetNumberOfLines(); ++i)
   {
-    // if the current pixel value is set to something
-    if ((currentPixel) && (*currentPixel == pixelValue))
+    lines->InsertNextCell(outlines.LineOffsets[i + 1] - outlines.LineOffsets[i]);
+    for (vtkIdType pointId = outlines.LineOffsets[i]; pointId < outlines.LineOffsets[i + 1]; ++pointId)
     {
-      // check in which direction a line is necessary
-      // a line is added if the neighbor of the current pixel has the value 0
-      // and if the pixel is located at the edge of the image
-
-      // if   vvvvv  not the first line vvvvv
-      if (y > yMin && *(currentPixel - line) != pixelValue)
-      { // x direction - bottom edge of the pixel
-        // add the 2 points
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        // add the line between both points
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  not the last line vvvvv
-      if (y < yMax && *(currentPixel + line) != pixelValue)
-      { // x direction - top edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  not the first pixel vvvvv
-      if ((x > xMin || y > yMin) && *(currentPixel - 1) != pixelValue)
-      { // y direction - left edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  not the last pixel vvvvv
-      if ((y < yMax || (x < xMax)) && *(currentPixel + 1) != pixelValue)
-      { // y direction - right edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      /*  now consider pixels at the edge of the image  */
-
-      // if   vvvvv  left edge of image vvvvv
-      if (x == xMin)
-      { // draw left edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  right edge of image vvvvv
-      if (x == xMax)
-      { // draw right edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  bottom edge of image vvvvv
-      if (y == yMin)
-      { // draw bottom edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-
-      // if   vvvvv  top edge of image vvvvv
-      if (y == yMax)
-      { // draw top edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-      }
-    } // end if currentpixel is set
-
-    x++;
-
-    if (x > xMax)
-    { // reached end of line
-      x = xMin;
-      y++;
+      lines->InsertCellPoint(pointId);
     }
-
-    // Increase the pointer-position to the next pixel.
-    // This is safe, as the while-loop and the x-reset logic above makes
-    // sure we do not exceed the bounds of the image
-    currentPixel++;
-  } // end of while
+  }
 
   // Create a polydata to store everything in
   vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
@@ -167,9 +167,9 @@ namespace mitk
       */
     void GeneratePlane(mitk::BaseRenderer *renderer, double planeBounds[6]);
 
-    /** \brief Generates a vtkPolyData object containing the outline of a given binary slice.
+    /** \brief Generates a vtkPolyData object containing the outline of the pixels with the given value.
         \param renderer: Pointer to the renderer containing the needed information
-        \note This code is based on code from the iil library.
+        \note The outline consists of one polyline per connected boundary, see mitk::LabelOutlineTracer.
         */
     vtkSmartPointer<vtkPolyData> CreateOutlinePolyData(mitk::BaseRenderer *renderer,
                                                        vtkImageData *image,
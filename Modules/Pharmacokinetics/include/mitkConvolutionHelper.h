@@ -17,10 +17,19 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define mitkConvolutionHelper_h
 
 #include "itkArray.h"
+#include "itkArray2D.h"
 #include "mitkAIFBasedModelBase.h"
+#include <cmath>
 #include <iostream>
+#include <vector>
 #include "MitkPharmacokineticsExports.h"
 
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define MITK_CONVOLUTION_SIMD _Pragma("omp simd")
+#else
+#define MITK_CONVOLUTION_SIMD
+#endif
+
 namespace  mitk {
 /** @namespace convolution
  * @brief Helper for itk implementation of vnl fourier transformation
@@ -132,6 +141,88 @@ inline    itk::Array<double> wrap1d(itk::Array<double> kernel)
   }
 
 
+  inline itk::Array2D<double> convoluteAIFWithExponentials(const mitk::ModelBase::TimeGridType& timeGrid, const mitk::AIFBasedModelBase::AterialInputFunctionType& aif,
+                                                           const itk::Array<double>& lambdas)
+  {
+      /** @brief Computes convoluteAIFWithExponential() for several lambdas at once (e.g. for all parameter sets of a batch).
+       * Row k of the result is the convolution for lambdas[k]. The terms that only depend on the aif and the time grid are
+       * computed once per time step, and the lambdas are the inner loop, so that it is vectorized across the lambdas.
+       **/
+      const unsigned int timeSteps = timeGrid.GetSize();
+      const unsigned int count = lambdas.GetSize();
+
+      itk::Array2D<double> convolutions(count, timeSteps);
+      convolutions.fill(0.0);
+
+      std::vector<double> previous(count, 0.0);
+      std::vector<double> current(count, 0.0);
+      const double* lambda = lambdas.data_block();
+
+      for(unsigned int i = 0; i + 1 < timeSteps; ++i)
+      {
+          const double t0 = timeGrid(i);
+          const double t1 = timeGrid(i+1);
+          const double dt = t1 - t0;
+          const double m = (aif(i+1) - aif(i))/dt;
+          const double offset = aif(i) - m*t0;
+
+          const double* previousPos = previous.data();
+          double* currentPos = current.data();
+
+          MITK_CONVOLUTION_SIMD
+          for(unsigned int k = 0; k < count; ++k)
+          {
+              const double l = lambda[k];
+              const double edt = std::exp(-l * dt);
+
+              currentPos[k] = edt * previousPos[k]
+                            + offset/l * (1 - edt )
+                            + m/(l * l) * ((l * t1 - 1) - edt*(l*t0 -1));
+          }
+
+          for(unsigned int k = 0; k < count; ++k)
+          {
+              convolutions(k, i+1) = currentPos[k];
+          }
+
+          previous.swap(current);
+      }
+      return convolutions;
+  }
+
+  inline void convoluteAIFWithExponentialAndDerivative(const mitk::ModelBase::TimeGridType& timeGrid, const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, double lambda,
+                                                       itk::Array<double>& convolution, itk::Array<double>& derivative)
+  {
+      /** @brief Computes the same convolution as convoluteAIFWithExponential() and additionally its derivative with respect to lambda.
+       * The derivative is computed by differentiating the iterative formula, thus it is exact for the discretized convolution
+       * and can be used for analytic model jacobians.
+       **/
+      convolution.SetSize(timeGrid.GetSize());
+      convolution.fill(0.0);
+      derivative.SetSize(timeGrid.GetSize());
+      derivative.fill(0.0);
+
+      for(unsigned int i = 0; i< (timeGrid.GetSize()-1); ++i)
+      {
+          double dt = timeGrid(i+1) - timeGrid(i);
+          double m = (aif(i+1) - aif(i))/dt;
+          double edt = exp(-lambda *dt);
+          double dedt = -dt * edt;
+
+          double offset = aif(i) - m*timeGrid(i);
+          double ramp = (lambda * timeGrid(i+1) - 1) - edt*(lambda*timeGrid(i) -1);
+          double dramp = timeGrid(i+1) - dedt*(lambda*timeGrid(i) -1) - edt*timeGrid(i);
+
+          convolution(i+1) =edt * convolution(i)
+                           + offset/lambda * (1 - edt )
+                           + m/(lambda * lambda) * ramp;
+
+          derivative(i+1) = dedt * convolution(i) + edt * derivative(i)
+                          - offset * ((1 - edt)/(lambda * lambda) + dedt/lambda)
+                          + m * (dramp/(lambda * lambda) - 2 * ramp/(lambda * lambda * lambda));
+      }
+  }
+
   inline itk::Array<double> convoluteAIFWithConstant(mitk::ModelBase::TimeGridType timeGrid, mitk::AIFBasedModelBase::AterialInputFunctionType aif, double constant)
   {
       /** @brief Iterative Formula to Convolve aif(t) with a constant value by linear interpolation of the Aif between sampling points
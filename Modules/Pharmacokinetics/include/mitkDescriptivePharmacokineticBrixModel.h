@@ -76,6 +76,8 @@ namespace mitk
 
     virtual std::string GetModelType() const override;
 
+    virtual bool HasAnalyticJacobian() const override;
+
     virtual std::string GetXAxisName() const override;
 
     virtual std::string GetXAxisUnit() const override;
@@ -107,6 +109,8 @@ namespace mitk
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    virtual ModelJacobianType ComputeModelJacobian(const ParametersType& parameters) const override;
+
     virtual void SetStaticParameter(const ParameterNameType& name,
                                     const StaticParameterValuesType& values) override;
     virtual StaticParameterValuesType GetStaticParameterValue(const ParameterNameType& name) const
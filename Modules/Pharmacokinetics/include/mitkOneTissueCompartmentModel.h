@@ -46,6 +46,8 @@ namespace mitk
 
     virtual std::string GetModelType() const override;
 
+    virtual bool HasAnalyticJacobian() const override;
+
     virtual ParameterNamesType GetParameterNames() const override;
     virtual ParametersSizeType  GetNumberOfParameters() const override;
 
@@ -64,6 +66,12 @@ namespace mitk
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    /** Evaluates the whole batch with one call of convoluteAIFWithExponentials(), so the aif is only retrieved once
+     * and the convolution is vectorized across the parameter sets.*/
+    virtual ModelResultBatchType ComputeModelfunctions(const ParametersBatchType& parameters) const override;
+
+    virtual ModelJacobianType ComputeModelJacobian(const ParametersType& parameters) const override;
+
     virtual void PrintSelf(std::ostream& os, ::itk::Indent indent) const override;
 
   private:
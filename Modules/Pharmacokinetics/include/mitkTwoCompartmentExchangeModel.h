@@ -82,6 +82,8 @@ namespace mitk
 
     virtual std::string GetModelType() const override;
 
+    virtual bool HasAnalyticJacobian() const override;
+
     virtual ParameterNamesType GetParameterNames() const override;
     virtual ParametersSizeType  GetNumberOfParameters() const override;
 
@@ -100,6 +102,8 @@ namespace mitk
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const;
 
+    virtual ModelJacobianType ComputeModelJacobian(const ParametersType& parameters) const;
+
     virtual void PrintSelf(std::ostream& os, ::itk::Indent indent) const;
 
   private:
@@ -84,6 +84,10 @@ namespace mitk
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    /** Evaluates the whole batch with one call of convoluteAIFWithExponentials(), so the aif is only retrieved once
+     * and the convolution is vectorized across the parameter sets.*/
+    virtual ModelResultBatchType ComputeModelfunctions(const ParametersBatchType& parameters) const override;
+
     virtual void PrintSelf(std::ostream& os, ::itk::Indent indent) const;
 
   private:
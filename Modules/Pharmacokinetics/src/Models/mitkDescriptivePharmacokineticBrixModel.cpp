@@ -54,6 +54,11 @@ std::string mitk::DescriptivePharmacokineticBrixModel::GetModelType() const
   return "Perfusion.MR";
 };
 
+bool mitk::DescriptivePharmacokineticBrixModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
 std::string mitk::DescriptivePharmacokineticBrixModel::GetXAxisName() const
 {
   return "Time";
@@ -207,6 +212,89 @@ const
 
 }
 
+mitk::DescriptivePharmacokineticBrixModel::ModelJacobianType
+mitk::DescriptivePharmacokineticBrixModel::ComputeModelJacobian(const ParametersType& parameters)
+const
+{
+  if (m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Jacobian");
+  }
+
+  if (m_Tau == 0)
+  {
+    itkExceptionMacro("Injection time is 0! Cannot Calculate Jacobian");
+  }
+
+  ModelJacobianType jacobian(this->GetNumberOfParameters(), m_TimeGrid.GetSize());
+
+  double amplitude = parameters[POSITION_PARAMETER_A];
+  double       kel = parameters[POSITION_PARAMETER_kel];
+  double       kep = parameters[POSITION_PARAMETER_kep];
+  double      tlag = parameters[POSITION_PARAMETER_tlag];
+
+  double kDiff = kep - kel;
+  double scale = m_S0 * amplitude / m_Tau;
+
+  for (TimeGridType::size_type i = 0; i < m_TimeGrid.GetSize(); ++i)
+  {
+    double t = m_TimeGrid[i] / 60.0; //convert from [sec] to [min]
+
+    //tx and its derivative with respect to tlag
+    double tx = 0;
+    double dtx = 0;
+
+    if (t <= tlag)
+    {
+      tx = 0;
+    }
+    else if ((t > tlag) && (t < (m_Tau + tlag)))
+    {
+      tx = t - tlag;
+      dtx = -1;
+    }
+    else if (t >= (m_Tau + tlag))
+    {
+      tx = m_Tau;
+    }
+
+    double tDiff = t - tlag;
+    double tRest = tDiff - tx;
+    double dtRest = -1 - dtx;
+
+    //the model function is (A/tau)*(u - v) with
+    //u = kep/(kel*kDiff) * w; w = exp(-kel*tRest) - exp(-kel*tDiff)
+    //v = 1/kDiff * z; z = exp(-kep*tRest) - exp(-kep*tDiff)
+    double expkelRest = exp(-kel * tRest);
+    double expkel = exp(-kel * tDiff);
+    double expkepRest = exp(-kep * tRest);
+    double expkep = exp(-kep * tDiff);
+
+    double w = expkelRest - expkel;
+    double z = expkepRest - expkep;
+    double kelkDiff = kel * kDiff;
+    double u = kep * w / kelkDiff;
+    double v = z / kDiff;
+
+    double dwdkel = -tRest * expkelRest + tDiff * expkel;
+    double dzdkep = -tRest * expkepRest + tDiff * expkep;
+    double dwdtlag = -kel * dtRest * expkelRest - kel * expkel;
+    double dzdtlag = -kep * dtRest * expkepRest - kep * expkep;
+
+    double dudkel = kep * (dwdkel / kelkDiff - w * (kDiff - kel) / (kelkDiff * kelkDiff));
+    double dvdkel = v / kDiff;
+    double dudkep = -w / (kDiff * kDiff);
+    double dvdkep = dzdkep / kDiff - z / (kDiff * kDiff);
+
+    jacobian[POSITION_PARAMETER_A][i] = m_S0 * (u - v) / m_Tau;
+    jacobian[POSITION_PARAMETER_kel][i] = scale * (dudkel - dvdkel);
+    jacobian[POSITION_PARAMETER_kep][i] = scale * (dudkep - dvdkep);
+    jacobian[POSITION_PARAMETER_tlag][i] = scale * (kep * dwdtlag / kelkDiff - dzdtlag / kDiff);
+  }
+
+  return jacobian;
+}
+
 void mitk::DescriptivePharmacokineticBrixModel::SetStaticParameter(const ParameterNameType& name,
     const StaticParameterValuesType& values)
 {
@@ -130,6 +130,43 @@ mitk::ExtendedOneTissueCompartmentModel::ModelResultType mitk::ExtendedOneTissue
 
 
 
+mitk::ExtendedOneTissueCompartmentModel::ModelResultBatchType mitk::ExtendedOneTissueCompartmentModel::ComputeModelfunctions(
+  const ParametersBatchType& parameters) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  AterialInputFunctionType aterialInputFunction;
+  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int batchSize = parameters.rows();
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  itk::Array<double> lambdas(batchSize);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    lambdas[i] = parameters(i, POSITION_PARAMETER_k2) / 60.0;
+  }
+
+  ModelResultBatchType signals = mitk::convoluteAIFWithExponentials(this->m_TimeGrid,
+      aterialInputFunction, lambdas);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    const double K1 = parameters(i, POSITION_PARAMETER_k1) / 60.0;
+    const double VB = parameters(i, POSITION_PARAMETER_VB);
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      signals(i, t) = VB * aterialInputFunction[t] + (1 - VB) * K1 * signals(i, t);
+    }
+  }
+
+  return signals;
+}
+
 itk::LightObject::Pointer mitk::ExtendedOneTissueCompartmentModel::InternalClone() const
 {
   ExtendedOneTissueCompartmentModel::Pointer newClone = ExtendedOneTissueCompartmentModel::New();
@@ -45,6 +45,11 @@ std::string mitk::ExtendedToftsModel::GetModelType() const
   return "Perfusion.MR";
 };
 
+bool mitk::ExtendedToftsModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
 mitk::ExtendedToftsModel::ExtendedToftsModel()
 {
 
@@ -153,6 +158,44 @@ mitk::ExtendedToftsModel::ModelResultType mitk::ExtendedToftsModel::ComputeModel
 
 }
 
+mitk::ExtendedToftsModel::ModelJacobianType mitk::ExtendedToftsModel::ComputeModelJacobian(
+  const ParametersType& parameters) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Jacobian");
+  }
+
+  AterialInputFunctionType aterialInputFunction;
+  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //Model Parameters
+  double ktrans = parameters[POSITION_PARAMETER_Ktrans] / 6000.0;
+  double     ve = parameters[POSITION_PARAMETER_ve];
+
+  double lambda =  ktrans / ve;
+
+  itk::Array<double> convolution;
+  itk::Array<double> convolutionDerivative;
+  mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, lambda,
+      convolution, convolutionDerivative);
+
+  //signal = ktrans * conv(lambda) with lambda = ktrans/ve
+  ModelJacobianType jacobian(this->GetNumberOfParameters(), timeSteps);
+  jacobian.fill(0.0);
+
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    jacobian[POSITION_PARAMETER_Ktrans][i] = (convolution[i] + lambda * convolutionDerivative[i]) / 6000.0;
+    jacobian[POSITION_PARAMETER_ve][i] = -ktrans * lambda / ve * convolutionDerivative[i];
+    jacobian[POSITION_PARAMETER_vp][i] = aterialInputFunction[i];
+  }
+
+  return jacobian;
+}
+
 
 mitk::ModelBase::DerivedParameterMapType mitk::ExtendedToftsModel::ComputeDerivedParameters(
   const mitk::ModelBase::ParametersType& parameters) const
@@ -163,6 +206,44 @@ mitk::ModelBase::DerivedParameterMapType mitk::ExtendedToftsModel::ComputeDerive
   return result;
 };
 
+mitk::ExtendedToftsModel::ModelResultBatchType mitk::ExtendedToftsModel::ComputeModelfunctions(
+  const ParametersBatchType& parameters) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  AterialInputFunctionType aterialInputFunction;
+  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int batchSize = parameters.rows();
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  itk::Array<double> ktrans(batchSize);
+  itk::Array<double> lambdas(batchSize);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    ktrans[i] = parameters(i, POSITION_PARAMETER_Ktrans) / 6000.0;
+    lambdas[i] = ktrans[i] / parameters(i, POSITION_PARAMETER_ve);
+  }
+
+  ModelResultBatchType signals = mitk::convoluteAIFWithExponentials(this->m_TimeGrid,
+      aterialInputFunction, lambdas);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    const double vp = parameters(i, POSITION_PARAMETER_vp);
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      signals(i, t) = aterialInputFunction[t] * vp + ktrans[i] * signals(i, t);
+    }
+  }
+
+  return signals;
+}
+
 itk::LightObject::Pointer mitk::ExtendedToftsModel::InternalClone() const
 {
   ExtendedToftsModel::Pointer newClone = ExtendedToftsModel::New();
@@ -42,6 +42,11 @@ std::string mitk::OneTissueCompartmentModel::GetModelType() const
   return "Dynamic.PET";
 };
 
+bool mitk::OneTissueCompartmentModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
 mitk::OneTissueCompartmentModel::OneTissueCompartmentModel()
 {
 
@@ -121,9 +126,78 @@ mitk::OneTissueCompartmentModel::ModelResultType mitk::OneTissueCompartmentModel
 
 }
 
+mitk::OneTissueCompartmentModel::ModelJacobianType mitk::OneTissueCompartmentModel::ComputeModelJacobian(
+  const ParametersType& parameters) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Jacobian");
+  }
+
+  AterialInputFunctionType aterialInputFunction;
+  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
 
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //Model Parameters
+  double     K1 = (double) parameters[POSITION_PARAMETER_k1] / 60.0;
+  double     k2 = (double) parameters[POSITION_PARAMETER_k2] / 60.0;
+
+  itk::Array<double> convolution;
+  itk::Array<double> convolutionDerivative;
+  mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, k2,
+      convolution, convolutionDerivative);
+
+  ModelJacobianType jacobian(this->GetNumberOfParameters(), timeSteps);
+
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    jacobian[POSITION_PARAMETER_k1][i] = convolution[i] / 60.0;
+    jacobian[POSITION_PARAMETER_k2][i] = K1 * convolutionDerivative[i] / 60.0;
+  }
+
+  return jacobian;
+}
 
 
+
+
+mitk::OneTissueCompartmentModel::ModelResultBatchType mitk::OneTissueCompartmentModel::ComputeModelfunctions(
+  const ParametersBatchType& parameters) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  AterialInputFunctionType aterialInputFunction;
+  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int batchSize = parameters.rows();
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  itk::Array<double> lambdas(batchSize);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    lambdas[i] = parameters(i, POSITION_PARAMETER_k2) / 60.0;
+  }
+
+  ModelResultBatchType signals = mitk::convoluteAIFWithExponentials(this->m_TimeGrid,
+      aterialInputFunction, lambdas);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    const double K1 = parameters(i, POSITION_PARAMETER_k1) / 60.0;
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      signals(i, t) = K1 * signals(i, t);
+    }
+  }
+
+  return signals;
+}
+
 itk::LightObject::Pointer mitk::OneTissueCompartmentModel::InternalClone() const
 {
   OneTissueCompartmentModel::Pointer newClone = OneTissueCompartmentModel::New();
@@ -42,6 +42,11 @@ std::string mitk::StandardToftsModel::GetModelType() const
   return "Perfusion.MR";
 };
 
+bool mitk::StandardToftsModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
 mitk::StandardToftsModel::StandardToftsModel()
 {
 
@@ -144,6 +149,43 @@ mitk::StandardToftsModel::ModelResultType mitk::StandardToftsModel::ComputeModel
 
 }
 
+mitk::StandardToftsModel::ModelJacobianType mitk::StandardToftsModel::ComputeModelJacobian(
+  const ParametersType& parameters) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Jacobian");
+  }
+
+  AterialInputFunctionType aterialInputFunction;
+  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //Model Parameters
+  double ktrans = parameters[POSITION_PARAMETER_Ktrans] / 6000.0;
+  double     ve = parameters[POSITION_PARAMETER_ve];
+
+  double lambda =  ktrans / ve;
+
+  itk::Array<double> convolution;
+  itk::Array<double> convolutionDerivative;
+  mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, lambda,
+      convolution, convolutionDerivative);
+
+  //signal = ktrans * conv(lambda) with lambda = ktrans/ve
+  ModelJacobianType jacobian(this->GetNumberOfParameters(), timeSteps);
+  jacobian.fill(0.0);
+
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    jacobian[POSITION_PARAMETER_Ktrans][i] = (convolution[i] + lambda * convolutionDerivative[i]) / 6000.0;
+    jacobian[POSITION_PARAMETER_ve][i] = -ktrans * lambda / ve * convolutionDerivative[i];
+  }
+
+  return jacobian;
+}
+
 
 mitk::ModelBase::DerivedParameterMapType mitk::StandardToftsModel::ComputeDerivedParameters(
   const mitk::ModelBase::ParametersType& parameters) const
@@ -154,6 +196,43 @@ mitk::ModelBase::DerivedParameterMapType mitk::StandardToftsModel::ComputeDerive
   return result;
 };
 
+mitk::StandardToftsModel::ModelResultBatchType mitk::StandardToftsModel::ComputeModelfunctions(
+  const ParametersBatchType& parameters) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  AterialInputFunctionType aterialInputFunction;
+  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int batchSize = parameters.rows();
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  itk::Array<double> ktrans(batchSize);
+  itk::Array<double> lambdas(batchSize);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    ktrans[i] = parameters(i, POSITION_PARAMETER_Ktrans) / 6000.0;
+    lambdas[i] = ktrans[i] / parameters(i, POSITION_PARAMETER_ve);
+  }
+
+  ModelResultBatchType signals = mitk::convoluteAIFWithExponentials(this->m_TimeGrid,
+      aterialInputFunction, lambdas);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      signals(i, t) = ktrans[i] * signals(i, t);
+    }
+  }
+
+  return signals;
+}
+
 itk::LightObject::Pointer mitk::StandardToftsModel::InternalClone() const
 {
   StandardToftsModel::Pointer newClone = StandardToftsModel::New();
@@ -54,6 +54,11 @@ std::string mitk::TwoCompartmentExchangeModel::GetModelType() const
   return "Perfusion.MR";
 };
 
+bool mitk::TwoCompartmentExchangeModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
 mitk::TwoCompartmentExchangeModel::TwoCompartmentExchangeModel()
 {
 
@@ -164,6 +169,95 @@ mitk::TwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& pa
     return signal;
 }
 
+mitk::TwoCompartmentExchangeModel::ModelJacobianType
+mitk::TwoCompartmentExchangeModel::ComputeModelJacobian(const ParametersType& parameters) const
+{
+    if (this->m_TimeGrid.GetSize() == 0)
+    {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Jacobian");
+    }
+
+    AterialInputFunctionType aterialInputFunction;
+    aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+    unsigned int timeSteps = this->m_TimeGrid.GetSize();
+    ModelJacobianType jacobian(this->GetNumberOfParameters(), timeSteps);
+    jacobian.fill(0.0);
+
+    //Model Parameters
+    double F = parameters[POSITION_PARAMETER_F] / 6000.0;
+    double PS  = parameters[POSITION_PARAMETER_PS] / 6000.0;
+    double ve = parameters[POSITION_PARAMETER_ve];
+    double vp = parameters[POSITION_PARAMETER_vp];
+
+    itk::Array<double> expp;
+    itk::Array<double> dexpp;
+    itk::Array<double> expm;
+    itk::Array<double> dexpm;
+
+    if(PS != 0)
+    {
+        //Kp/Km = 0.5*(a +/- r) with a = 1/Tp + 1/Te, b = 1/(Te*Tb) and r = sqrt(a^2 - 4b);
+        //E = (Kp - 1/Tb)/r. The partial derivatives of a, b and 1/Tb are propagated via chain rule.
+        double a = (PS + F)/vp + PS/ve;
+        double b = PS/ve * F/vp;
+        double r = sqrt(a*a - 4 * b);
+        double Kp = 0.5 * (a + r);
+        double Km = 0.5 * (a - r);
+        double invTb = F/vp;
+        double E = (Kp - invTb)/r;
+
+        mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, Kp, expp, dexpp);
+        mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, Km, expm, dexpm);
+
+        const unsigned int positions[4] = { POSITION_PARAMETER_F, POSITION_PARAMETER_PS, POSITION_PARAMETER_ve, POSITION_PARAMETER_vp };
+        const double da[4] = { 1/vp, 1/vp + 1/ve, -PS/(ve*ve), -(PS + F)/(vp*vp) };
+        const double db[4] = { PS/(ve*vp), F/(ve*vp), -PS*F/(ve*ve*vp), -PS*F/(ve*vp*vp) };
+        const double dinvTb[4] = { 1/vp, 0, 0, -F/(vp*vp) };
+        const double dF[4] = { 1, 0, 0, 0 };
+        const double parameterScale[4] = { 1/6000.0, 1/6000.0, 1, 1 };
+
+        for (unsigned int p = 0; p < 4; ++p)
+        {
+            double dr = (a*da[p] - 2*db[p])/r;
+            double dKp = 0.5 * (da[p] + dr);
+            double dKm = 0.5 * (da[p] - dr);
+            double dE = (dKp - dinvTb[p])/r - (Kp - invTb)*dr/(r*r);
+
+            for (unsigned int i = 0; i < timeSteps; ++i)
+            {
+                jacobian[positions[p]][i] = parameterScale[p] * (dF[p] * (expp[i] + E*(expm[i] - expp[i]))
+                    + F * ((1 - E) * dexpp[i] * dKp + E * dexpm[i] * dKm + dE * (expm[i] - expp[i])));
+            }
+        }
+    }
+    else
+    {
+        double Kp = F/vp;
+        mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, Kp, expp, dexpp);
+
+        for (unsigned int i = 0; i < timeSteps; ++i)
+        {
+            jacobian[POSITION_PARAMETER_F][i] = (expp[i] + Kp * dexpp[i]) / 6000.0;
+            jacobian[POSITION_PARAMETER_vp][i] = -F * Kp / vp * dexpp[i];
+        }
+
+        //The exchange terms are singular for PS == 0, thus the derivative for PS is approximated
+        //by a one sided difference. The signal does not depend on ve in this case.
+        const double deltaPS = 1e-5;
+        ParametersType shiftedParameters = parameters;
+        shiftedParameters[POSITION_PARAMETER_PS] += deltaPS;
+        ModelResultType shiftedSignal = this->ComputeModelfunction(shiftedParameters);
+
+        for (unsigned int i = 0; i < timeSteps; ++i)
+        {
+            jacobian[POSITION_PARAMETER_PS][i] = (shiftedSignal[i] - F * expp[i]) / deltaPS;
+        }
+    }
+
+    return jacobian;
+}
+
 
 itk::LightObject::Pointer mitk::TwoCompartmentExchangeModel::InternalClone() const
 {
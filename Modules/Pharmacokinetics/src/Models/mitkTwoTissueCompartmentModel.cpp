@@ -156,6 +156,58 @@ mitk::TwoTissueCompartmentModel::ComputeModelfunction(const ParametersType& para
 
 
 
+mitk::TwoTissueCompartmentModel::ModelResultBatchType mitk::TwoTissueCompartmentModel::ComputeModelfunctions(
+  const ParametersBatchType& parameters) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  AterialInputFunctionType aterialInputFunction;
+  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int batchSize = parameters.rows();
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //the first half of the lambdas are the alpha1 of all parameter sets, the second half the alpha2
+  itk::Array<double> lambdas(2 * batchSize);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    double k2 = parameters(i, POSITION_PARAMETER_k2) / 60.0;
+    double k3 = parameters(i, POSITION_PARAMETER_k3) / 60.0;
+    double k4 = parameters(i, POSITION_PARAMETER_k4) / 60.0;
+
+    lambdas[i] = 0.5 * ((k2 + k3 + k4) - sqrt(square(k2 + k3 + k4) - 4 * k2 * k4));
+    lambdas[batchSize + i] = 0.5 * ((k2 + k3 + k4) + sqrt(square(k2 + k3 + k4) - 4 * k2 * k4));
+  }
+
+  ModelResultBatchType exps = mitk::convoluteAIFWithExponentials(this->m_TimeGrid,
+      aterialInputFunction, lambdas);
+
+  ModelResultBatchType signals(batchSize, timeSteps);
+
+  for (unsigned int i = 0; i < batchSize; ++i)
+  {
+    double k1 = parameters(i, POSITION_PARAMETER_K1) / 60.0;
+    double k3 = parameters(i, POSITION_PARAMETER_k3) / 60.0;
+    double k4 = parameters(i, POSITION_PARAMETER_k4) / 60.0;
+    double VB = parameters(i, POSITION_PARAMETER_VB);
+    double alpha1 = lambdas[i];
+    double alpha2 = lambdas[batchSize + i];
+
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      double Ci = k1 / (alpha2 - alpha1) * ((k4 - alpha1 + k3) * exps(i, t) + (alpha2 - k4 - k3) *
+                                            exps(batchSize + i, t));
+      signals(i, t) = VB * aterialInputFunction[t] + (1 - VB) * Ci;
+    }
+  }
+
+  return signals;
+}
+
 itk::LightObject::Pointer mitk::TwoTissueCompartmentModel::InternalClone() const
 {
   TwoTissueCompartmentModel::Pointer newClone = TwoTissueCompartmentModel::New();
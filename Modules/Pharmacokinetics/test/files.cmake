@@ -1,4 +1,6 @@
 SET(MODULE_TESTS
   mitkDescriptivePharmacokineticBrixModelTest.cpp
+  mitkModelJacobianTest.cpp
+  mitkModelSignalBatchTest.cpp
   #ConvertToConcentrationTest.cpp
 )
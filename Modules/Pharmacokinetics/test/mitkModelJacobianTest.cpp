@@ -0,0 +1,144 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <cmath>
+
+#include "mitkTestingMacros.h"
+
+#include "mitkStandardToftsModel.h"
+#include "mitkExtendedToftsModel.h"
+#include "mitkOneTissueCompartmentModel.h"
+#include "mitkTwoCompartmentExchangeModel.h"
+#include "mitkDescriptivePharmacokineticBrixModel.h"
+#include "mitkT2DecayModel.h"
+
+/**Compares the analytic jacobian of the model with central differences of the model signal.
+ The error is measured relative to the largest absolute derivative of each parameter.*/
+bool CheckJacobian(const mitk::ModelBase* model, const mitk::ModelBase::ParametersType& parameters, double tolerance)
+{
+  if (!model->HasAnalyticJacobian())
+  {
+    return false;
+  }
+
+  mitk::ModelBase::ModelJacobianType jacobian = model->GetSignalJacobian(parameters);
+
+  bool result = true;
+  for (unsigned int i = 0; i < parameters.Size(); ++i)
+  {
+    const double delta = 1e-6 * std::max(1.0, std::abs(parameters[i]));
+
+    mitk::ModelBase::ParametersType shifted = parameters;
+    shifted[i] += delta;
+    mitk::ModelBase::ModelResultType upper = model->GetSignal(shifted);
+    shifted[i] = parameters[i] - delta;
+    mitk::ModelBase::ModelResultType lower = model->GetSignal(shifted);
+
+    double maxDerivative = 1e-10;
+    double maxError = 0.0;
+    for (unsigned int j = 0; j < upper.Size(); ++j)
+    {
+      const double numeric = (upper[j] - lower[j]) / (2 * delta);
+      maxDerivative = std::max(maxDerivative, std::abs(numeric));
+      maxError = std::max(maxError, std::abs(numeric - jacobian[i][j]));
+    }
+
+    if (maxError / maxDerivative > tolerance)
+    {
+      MITK_INFO << model->GetClassID() << ": jacobian of parameter #" << i << " deviates from numeric derivative. Relative error: " << maxError / maxDerivative;
+      result = false;
+    }
+  }
+  return result;
+}
+
+int mitkModelJacobianTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  MITK_TEST_BEGIN("ModelJacobian")
+
+  //Prepare test artifacts and helper
+  mitk::ModelBase::TimeGridType grid(40);
+  mitk::AIFBasedModelBase::AterialInputFunctionType aif(40);
+
+  for (unsigned int i = 0; i < 40; ++i)
+  {
+    grid[i] = 3.5 * i;
+    aif[i] = grid[i] < 10 ? 0 : 5 * (grid[i] - 10) * exp(-(grid[i] - 10) / 15.);
+  }
+
+  mitk::StandardToftsModel::Pointer tofts = mitk::StandardToftsModel::New();
+  tofts->SetTimeGrid(grid);
+  tofts->SetAterialInputFunctionValues(aif);
+  tofts->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType toftsParameters(2);
+  toftsParameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans] = 15;
+  toftsParameters[mitk::StandardToftsModel::POSITION_PARAMETER_ve] = 0.3;
+  MITK_TEST_CONDITION(CheckJacobian(tofts, toftsParameters, 1e-5), "Check jacobian of StandardToftsModel.");
+
+  mitk::ExtendedToftsModel::Pointer extendedTofts = mitk::ExtendedToftsModel::New();
+  extendedTofts->SetTimeGrid(grid);
+  extendedTofts->SetAterialInputFunctionValues(aif);
+  extendedTofts->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType extendedToftsParameters(3);
+  extendedToftsParameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_Ktrans] = 15;
+  extendedToftsParameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_ve] = 0.3;
+  extendedToftsParameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_vp] = 0.05;
+  MITK_TEST_CONDITION(CheckJacobian(extendedTofts, extendedToftsParameters, 1e-5), "Check jacobian of ExtendedToftsModel.");
+
+  mitk::OneTissueCompartmentModel::Pointer oneTissue = mitk::OneTissueCompartmentModel::New();
+  oneTissue->SetTimeGrid(grid);
+  oneTissue->SetAterialInputFunctionValues(aif);
+  oneTissue->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType oneTissueParameters(2);
+  oneTissueParameters[mitk::OneTissueCompartmentModel::POSITION_PARAMETER_k1] = 0.5;
+  oneTissueParameters[mitk::OneTissueCompartmentModel::POSITION_PARAMETER_k2] = 0.2;
+  MITK_TEST_CONDITION(CheckJacobian(oneTissue, oneTissueParameters, 1e-5), "Check jacobian of OneTissueCompartmentModel.");
+
+  mitk::TwoCompartmentExchangeModel::Pointer exchange = mitk::TwoCompartmentExchangeModel::New();
+  exchange->SetTimeGrid(grid);
+  exchange->SetAterialInputFunctionValues(aif);
+  exchange->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType exchangeParameters(4);
+  exchangeParameters[mitk::TwoCompartmentExchangeModel::POSITION_PARAMETER_F] = 60;
+  exchangeParameters[mitk::TwoCompartmentExchangeModel::POSITION_PARAMETER_PS] = 10;
+  exchangeParameters[mitk::TwoCompartmentExchangeModel::POSITION_PARAMETER_ve] = 0.3;
+  exchangeParameters[mitk::TwoCompartmentExchangeModel::POSITION_PARAMETER_vp] = 0.05;
+  MITK_TEST_CONDITION(CheckJacobian(exchange, exchangeParameters, 1e-5), "Check jacobian of TwoCompartmentExchangeModel.");
+
+  mitk::DescriptivePharmacokineticBrixModel::Pointer brix = mitk::DescriptivePharmacokineticBrixModel::New();
+  mitk::ModelBase::TimeGridType brixGrid(22);
+  for (unsigned int i = 0; i < 22; ++i)
+  {
+    brixGrid[i] = 14.0 * i;
+  }
+  brix->SetTimeGrid(brixGrid);
+  brix->SetTau(0.5);
+  mitk::ModelBase::ParametersType brixParameters(4);
+  brixParameters[mitk::DescriptivePharmacokineticBrixModel::POSITION_PARAMETER_A] = 1.25;
+  brixParameters[mitk::DescriptivePharmacokineticBrixModel::POSITION_PARAMETER_kep] = 3.89;
+  brixParameters[mitk::DescriptivePharmacokineticBrixModel::POSITION_PARAMETER_kel] = 0.12;
+  brixParameters[mitk::DescriptivePharmacokineticBrixModel::POSITION_PARAMETER_tlag] = 1.14;
+  MITK_TEST_CONDITION(CheckJacobian(brix, brixParameters, 1e-5), "Check jacobian of DescriptivePharmacokineticBrixModel.");
+
+  mitk::T2DecayModel::Pointer t2 = mitk::T2DecayModel::New();
+  t2->SetTimeGrid(grid);
+  mitk::ModelBase::ParametersType t2Parameters(2);
+  t2Parameters[0] = 1000;
+  t2Parameters[1] = 40;
+  MITK_TEST_CONDITION(CheckJacobian(t2, t2Parameters, 1e-5), "Check jacobian of T2DecayModel.");
+
+  MITK_TEST_END()
+}
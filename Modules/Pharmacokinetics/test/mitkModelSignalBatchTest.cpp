@@ -0,0 +1,183 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <cmath>
+
+#include "mitkTestingMacros.h"
+
+#include "mitkConvolutionHelper.h"
+#include "mitkStandardToftsModel.h"
+#include "mitkExtendedToftsModel.h"
+#include "mitkOneTissueCompartmentModel.h"
+#include "mitkExtendedOneTissueCompartmentModel.h"
+#include "mitkTwoTissueCompartmentModel.h"
+#include "mitkDescriptivePharmacokineticBrixModel.h"
+
+/**Compares the signals of a batch (ModelBase::GetSignals()) with the signals of every single parameter set.
+ The error is measured relative to the largest absolute signal value.*/
+bool CheckSignalBatch(const mitk::ModelBase* model, const mitk::ModelBase::ParametersBatchType& parameters, double tolerance)
+{
+  mitk::ModelBase::ModelResultBatchType signals = model->GetSignals(parameters);
+
+  if (signals.rows() != parameters.rows() || signals.cols() != model->GetTimeGrid().GetSize())
+  {
+    MITK_INFO << model->GetClassID() << ": signal batch has wrong size.";
+    return false;
+  }
+
+  bool result = true;
+  mitk::ModelBase::ParametersType rowParameters(parameters.cols());
+  for (unsigned int row = 0; row < parameters.rows(); ++row)
+  {
+    rowParameters.copy_in(parameters[row]);
+    mitk::ModelBase::ModelResultType signal = model->GetSignal(rowParameters);
+
+    double maxValue = 1e-10;
+    double maxError = 0.0;
+    for (unsigned int j = 0; j < signal.Size(); ++j)
+    {
+      maxValue = std::max(maxValue, std::abs(signal[j]));
+      maxError = std::max(maxError, std::abs(signal[j] - signals[row][j]));
+    }
+
+    if (maxError / maxValue > tolerance)
+    {
+      MITK_INFO << model->GetClassID() << ": signal of batch row #" << row << " deviates from single signal. Relative error: " << maxError / maxValue;
+      result = false;
+    }
+  }
+  return result;
+}
+
+/**Generates a batch of parameter sets by varying every parameter of the passed set.*/
+mitk::ModelBase::ParametersBatchType GenerateParameterBatch(const mitk::ModelBase::ParametersType& parameters, unsigned int size)
+{
+  mitk::ModelBase::ParametersBatchType batch(size, parameters.Size());
+  for (unsigned int row = 0; row < size; ++row)
+  {
+    for (unsigned int i = 0; i < parameters.Size(); ++i)
+    {
+      batch[row][i] = parameters[i] * (0.5 + 0.1 * ((row + i) % size));
+    }
+  }
+  return batch;
+}
+
+int mitkModelSignalBatchTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  MITK_TEST_BEGIN("ModelSignalBatch")
+
+  //Prepare test artifacts and helper
+  mitk::ModelBase::TimeGridType grid(40);
+  mitk::AIFBasedModelBase::AterialInputFunctionType aif(40);
+
+  for (unsigned int i = 0; i < 40; ++i)
+  {
+    grid[i] = 3.5 * i;
+    aif[i] = grid[i] < 10 ? 0 : 5 * (grid[i] - 10) * exp(-(grid[i] - 10) / 15.);
+  }
+
+  //batched convolution
+  itk::Array<double> lambdas(9);
+  for (unsigned int k = 0; k < lambdas.Size(); ++k)
+  {
+    lambdas[k] = 0.002 + 0.015 * k;
+  }
+  itk::Array2D<double> convolutions = mitk::convoluteAIFWithExponentials(grid, aif, lambdas);
+  MITK_TEST_CONDITION_REQUIRED(convolutions.rows() == lambdas.Size() && convolutions.cols() == grid.Size(), "Check size of batched convolution.");
+
+  bool convolutionsEqual = true;
+  for (unsigned int k = 0; k < lambdas.Size(); ++k)
+  {
+    itk::Array<double> convolution = mitk::convoluteAIFWithExponential(grid, aif, lambdas[k]);
+    for (unsigned int i = 0; i < grid.Size(); ++i)
+    {
+      convolutionsEqual = convolutionsEqual && std::abs(convolution[i] - convolutions[k][i]) <= 1e-12 * std::max(1.0, std::abs(convolution[i]));
+    }
+  }
+  MITK_TEST_CONDITION(convolutionsEqual, "Check batched convolution equals convolution of every single lambda.");
+
+  //batched model signals
+  mitk::StandardToftsModel::Pointer tofts = mitk::StandardToftsModel::New();
+  tofts->SetTimeGrid(grid);
+  tofts->SetAterialInputFunctionValues(aif);
+  tofts->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType toftsParameters(2);
+  toftsParameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans] = 15;
+  toftsParameters[mitk::StandardToftsModel::POSITION_PARAMETER_ve] = 0.3;
+  MITK_TEST_CONDITION(CheckSignalBatch(tofts, GenerateParameterBatch(toftsParameters, 7), 1e-10), "Check signal batch of StandardToftsModel.");
+
+  mitk::ExtendedToftsModel::Pointer extendedTofts = mitk::ExtendedToftsModel::New();
+  extendedTofts->SetTimeGrid(grid);
+  extendedTofts->SetAterialInputFunctionValues(aif);
+  extendedTofts->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType extendedToftsParameters(3);
+  extendedToftsParameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_Ktrans] = 15;
+  extendedToftsParameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_ve] = 0.3;
+  extendedToftsParameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_vp] = 0.05;
+  MITK_TEST_CONDITION(CheckSignalBatch(extendedTofts, GenerateParameterBatch(extendedToftsParameters, 7), 1e-10), "Check signal batch of ExtendedToftsModel.");
+
+  mitk::OneTissueCompartmentModel::Pointer oneTissue = mitk::OneTissueCompartmentModel::New();
+  oneTissue->SetTimeGrid(grid);
+  oneTissue->SetAterialInputFunctionValues(aif);
+  oneTissue->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType oneTissueParameters(2);
+  oneTissueParameters[mitk::OneTissueCompartmentModel::POSITION_PARAMETER_k1] = 0.5;
+  oneTissueParameters[mitk::OneTissueCompartmentModel::POSITION_PARAMETER_k2] = 0.2;
+  MITK_TEST_CONDITION(CheckSignalBatch(oneTissue, GenerateParameterBatch(oneTissueParameters, 7), 1e-10), "Check signal batch of OneTissueCompartmentModel.");
+
+  mitk::ExtendedOneTissueCompartmentModel::Pointer extendedOneTissue = mitk::ExtendedOneTissueCompartmentModel::New();
+  extendedOneTissue->SetTimeGrid(grid);
+  extendedOneTissue->SetAterialInputFunctionValues(aif);
+  extendedOneTissue->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType extendedOneTissueParameters(3);
+  extendedOneTissueParameters[mitk::ExtendedOneTissueCompartmentModel::POSITION_PARAMETER_k1] = 0.5;
+  extendedOneTissueParameters[mitk::ExtendedOneTissueCompartmentModel::POSITION_PARAMETER_k2] = 0.2;
+  extendedOneTissueParameters[mitk::ExtendedOneTissueCompartmentModel::POSITION_PARAMETER_VB] = 0.05;
+  MITK_TEST_CONDITION(CheckSignalBatch(extendedOneTissue, GenerateParameterBatch(extendedOneTissueParameters, 7), 1e-10), "Check signal batch of ExtendedOneTissueCompartmentModel.");
+
+  mitk::TwoTissueCompartmentModel::Pointer twoTissue = mitk::TwoTissueCompartmentModel::New();
+  twoTissue->SetTimeGrid(grid);
+  twoTissue->SetAterialInputFunctionValues(aif);
+  twoTissue->SetAterialInputFunctionTimeGrid(grid);
+  mitk::ModelBase::ParametersType twoTissueParameters(5);
+  twoTissueParameters[mitk::TwoTissueCompartmentModel::POSITION_PARAMETER_K1] = 0.5;
+  twoTissueParameters[mitk::TwoTissueCompartmentModel::POSITION_PARAMETER_k2] = 0.3;
+  twoTissueParameters[mitk::TwoTissueCompartmentModel::POSITION_PARAMETER_k3] = 0.1;
+  twoTissueParameters[mitk::TwoTissueCompartmentModel::POSITION_PARAMETER_k4] = 0.02;
+  twoTissueParameters[mitk::TwoTissueCompartmentModel::POSITION_PARAMETER_VB] = 0.05;
+  MITK_TEST_CONDITION(CheckSignalBatch(twoTissue, GenerateParameterBatch(twoTissueParameters, 7), 1e-10), "Check signal batch of TwoTissueCompartmentModel.");
+
+  //model without batch implementation uses the default of ModelBase
+  mitk::DescriptivePharmacokineticBrixModel::Pointer brix = mitk::DescriptivePharmacokineticBrixModel::New();
+  mitk::ModelBase::TimeGridType brixGrid(22);
+  for (unsigned int i = 0; i < 22; ++i)
+  {
+    brixGrid[i] = 14.0 * i;
+  }
+  brix->SetTimeGrid(brixGrid);
+  brix->SetTau(0.5);
+  mitk::ModelBase::ParametersType brixParameters(4);
+  brixParameters[mitk::DescriptivePharmacokineticBrixModel::POSITION_PARAMETER_A] = 1.25;
+  brixParameters[mitk::DescriptivePharmacokineticBrixModel::POSITION_PARAMETER_kep] = 3.89;
+  brixParameters[mitk::DescriptivePharmacokineticBrixModel::POSITION_PARAMETER_kel] = 0.12;
+  brixParameters[mitk::DescriptivePharmacokineticBrixModel::POSITION_PARAMETER_tlag] = 1.14;
+  MITK_TEST_CONDITION(CheckSignalBatch(brix, GenerateParameterBatch(brixParameters, 7), 0.0), "Check signal batch of DescriptivePharmacokineticBrixModel.");
+
+  MITK_TEST_FOR_EXCEPTION(::itk::ExceptionObject, tofts->GetSignals(mitk::ModelBase::ParametersBatchType(3, 3)));
+
+  MITK_TEST_END()
+}
@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDiffSliceOperationApplier.h"
 
 #include "mitkDiffSliceOperation.h"
+#include "mitkLabelSetImage.h"
 #include "mitkRenderingManager.h"
 #include "mitkSegTool2D.h"
 #include <mitkExtractSliceFilter.h>
@@ -55,6 +56,16 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
     reslice->SetOverwriteMode(true);
     reslice->Modified();
 
+    // keep the label index of a label set image up to date without rescanning the volume
+    auto *labelSetImage = dynamic_cast<LabelSetImage *>(imageOperation->GetImage());
+    LabelSetImage::IndexRegionType affectedRegion;
+    if (labelSetImage)
+    {
+      affectedRegion = labelSetImage->GetRegionOfPlane(dynamic_cast<PlaneGeometry *>(imageOperation->GetWorldGeometry()),
+                                                       imageOperation->GetTimeStep());
+      labelSetImage->BeginLabelIndexUpdate(affectedRegion, imageOperation->GetTimeStep());
+    }
+
     // a wrapper for vtkImageOverwrite
     mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New(reslice);
     extractor->SetInput(imageOperation->GetImage());
@@ -66,6 +77,11 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
     extractor->Modified();
     extractor->Update();
 
+    if (labelSetImage)
+    {
+      labelSetImage->EndLabelIndexUpdate(affectedRegion, imageOperation->GetTimeStep());
+    }
+
     // make sure the modification is rendered
     RenderingManager::GetInstance()->RequestUpdateAll();
     imageOperation->GetImage()->Modified();
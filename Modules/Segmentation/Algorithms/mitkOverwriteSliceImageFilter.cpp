@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageCast.h"
 #include "mitkImageTimeSelector.h"
 #include "mitkInteractionConst.h"
+#include "mitkLabelSetImage.h"
 #include "mitkOperationEvent.h"
 #include "mitkSegmentationInterpolationController.h"
 #include "mitkUndoController.h"
@@ -109,11 +110,28 @@ void mitk::OverwriteSliceImageFilter::GenerateData()
     m_SliceDifferenceImage->Initialize(pixelType, 2, m_SliceImage->GetDimensions());
   }
 
+  // keep the label index of a label set image up to date without rescanning the volume
+  auto *labelSetImage = dynamic_cast<LabelSetImage *>(const_cast<Image *>(input.GetPointer()));
+  LabelSetImage::IndexRegionType sliceRegion;
+  if (labelSetImage)
+  {
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      sliceRegion.SetSize(dim, input->GetDimension(dim));
+    sliceRegion.SetIndex(m_SliceDimension, m_SliceIndex);
+    sliceRegion.SetSize(m_SliceDimension, 1);
+    labelSetImage->BeginLabelIndexUpdate(sliceRegion, m_TimeStep);
+  }
+
   // MITK_INFO << "Overwriting slice " << m_SliceIndex << " in dimension " << m_SliceDimension << " at time step " <<
   // m_TimeStep << std::endl;
   // this will do a long long if/else to find out both pixel types
   AccessFixedDimensionByItk(input3D, ItkImageSwitch, 3);
 
+  if (labelSetImage)
+  {
+    labelSetImage->EndLabelIndexUpdate(sliceRegion, m_TimeStep);
+  }
+
   SegmentationInterpolationController *interpolator = SegmentationInterpolationController::InterpolatorForImage(input);
   if (interpolator)
   {
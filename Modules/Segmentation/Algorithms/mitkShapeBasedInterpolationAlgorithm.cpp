@@ -20,10 +20,36 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkITKImageImport.h>
 
 #include <itkFastChamferDistanceImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
 #include <itkInvertIntensityImageFilter.h>
 #include <itkIsoContourDistanceImageFilter.h>
+#include <itkRegionOfInterestImageFilter.h>
 #include <itkSubtractImageFilter.h>
 
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // arbitrary maximum distance, distances inside of the cropped region may be smaller
+  const int MaximumDistance = 100;
+}
+
+mitk::ShapeBasedInterpolationAlgorithm::ShapeBasedInterpolationAlgorithm()
+  : m_CropMargin(2), m_MaximumNumberOfCachedDistanceMaps(4), m_NumberOfComputedDistanceMaps(0)
+{
+}
+
+mitk::ShapeBasedInterpolationAlgorithm::~ShapeBasedInterpolationAlgorithm()
+{
+}
+
+void mitk::ShapeBasedInterpolationAlgorithm::ClearCache()
+{
+  m_DistanceMapCache.clear();
+}
+
 mitk::Image::Pointer mitk::ShapeBasedInterpolationAlgorithm::Interpolate(
   Image::ConstPointer lowerSlice,
   unsigned int lowerSliceIndex,
@@ -35,31 +61,170 @@ mitk::Image::Pointer mitk::ShapeBasedInterpolationAlgorithm::Interpolate(
   unsigned int /*timeStep*/,
   Image::ConstPointer /*referenceImage*/)
 {
-  mitk::Image::Pointer lowerDistanceImage = mitk::Image::New();
-  AccessFixedDimensionByItk_1(lowerSlice, ComputeDistanceMap, 2, lowerDistanceImage);
+  SliceInformation lowerInformation;
+  AccessFixedDimensionByItk_1(lowerSlice, AnalyzeSlice, 2, lowerInformation);
+
+  SliceInformation upperInformation;
+  AccessFixedDimensionByItk_1(upperSlice, AnalyzeSlice, 2, upperInformation);
 
-  mitk::Image::Pointer upperDistanceImage = mitk::Image::New();
-  AccessFixedDimensionByItk_1(upperSlice, ComputeDistanceMap, 2, upperDistanceImage);
+  if (lowerInformation.LargestRegion != upperInformation.LargestRegion)
+  {
+    // TODO Exception etc.
+    MITK_ERROR << "The regions of the slices for the 2D interpolation are not equally sized!";
+    return resultImage;
+  }
+
+  // union of the segmented pixels of both slices, enlarged by the margin and cropped to the slice.
+  // The margin keeps the iso contour filter from seeing the border of the cropped region.
+  RegionType region;
+  DistanceFilterImageType::Pointer lowerDistanceImage;
+  DistanceFilterImageType::Pointer upperDistanceImage;
+
+  if (!lowerInformation.Empty || !upperInformation.Empty)
+  {
+    RegionType::IndexType minimum;
+    RegionType::IndexType maximum;
+    bool first = true;
+    for (const SliceInformation *information : {&lowerInformation, &upperInformation})
+    {
+      if (information->Empty)
+        continue;
+
+      for (unsigned int d = 0; d < 2; ++d)
+      {
+        const auto lower = information->BoundingRegion.GetIndex(d);
+        const auto upper = lower + static_cast<RegionType::IndexValueType>(information->BoundingRegion.GetSize(d)) - 1;
+        minimum[d] = first ? lower : std::min(minimum[d], lower);
+        maximum[d] = first ? upper : std::max(maximum[d], upper);
+      }
+      first = false;
+    }
+
+    const auto margin = static_cast<RegionType::IndexValueType>(std::max(m_CropMargin, 2u));
+    for (unsigned int d = 0; d < 2; ++d)
+    {
+      region.SetIndex(d, minimum[d] - margin);
+      region.SetSize(d, maximum[d] - minimum[d] + 1 + 2 * margin);
+    }
+    region.Crop(lowerInformation.LargestRegion);
+
+    lowerDistanceImage = this->GetDistanceMap(lowerSlice, lowerInformation, region);
+    upperDistanceImage = this->GetDistanceMap(upperSlice, upperInformation, region);
+  }
+  else
+  {
+    region.SetIndex(lowerInformation.LargestRegion.GetIndex());
+    region.SetSize(0, 0);
+    region.SetSize(1, 0);
+  }
 
   // calculate where the current slice is in comparison to the lower and upper neighboring slices
   float ratio = (float)(requestedIndex - lowerSliceIndex) / (float)(upperSliceIndex - lowerSliceIndex);
-  AccessFixedDimensionByItk_3(
-    resultImage, InterpolateIntermediateSlice, 2, upperDistanceImage, lowerDistanceImage, ratio);
+  AccessFixedDimensionByItk_n(resultImage,
+                              InterpolateIntermediateSlice,
+                              2,
+                              (region, lowerDistanceImage.GetPointer(), upperDistanceImage.GetPointer(), ratio));
 
   return resultImage;
 }
 
+template <typename TPixel, unsigned int VImageDimension>
+void mitk::ShapeBasedInterpolationAlgorithm::AnalyzeSlice(const itk::Image<TPixel, VImageDimension> *slice,
+                                                          SliceInformation &information)
+{
+  information.LargestRegion = slice->GetLargestPossibleRegion();
+
+  const auto &size = information.LargestRegion.GetSize();
+  const TPixel *buffer = slice->GetBufferPointer();
+
+  // FNV-1a over the pixel values
+  std::uint64_t hash = 14695981039346656037ull;
+  long minimum[2] = {static_cast<long>(size[0]), static_cast<long>(size[1])};
+  long maximum[2] = {-1, -1};
+
+  for (long y = 0; y < static_cast<long>(size[1]); ++y)
+  {
+    for (long x = 0; x < static_cast<long>(size[0]); ++x, ++buffer)
+    {
+      const TPixel value = *buffer;
+      const auto *bytes = reinterpret_cast<const unsigned char *>(&value);
+      for (std::size_t b = 0; b < sizeof(TPixel); ++b)
+      {
+        hash ^= bytes[b];
+        hash *= 1099511628211ull;
+      }
+
+      if (value != 0)
+      {
+        minimum[0] = std::min(minimum[0], x);
+        maximum[0] = std::max(maximum[0], x);
+        minimum[1] = std::min(minimum[1], y);
+        maximum[1] = std::max(maximum[1], y);
+      }
+    }
+  }
+
+  information.Hash = hash;
+  information.Empty = maximum[0] < 0;
+  if (!information.Empty)
+  {
+    for (unsigned int d = 0; d < 2; ++d)
+    {
+      information.BoundingRegion.SetIndex(d, information.LargestRegion.GetIndex(d) + minimum[d]);
+      information.BoundingRegion.SetSize(d, maximum[d] - minimum[d] + 1);
+    }
+  }
+}
+
+mitk::ShapeBasedInterpolationAlgorithm::DistanceFilterImageType::Pointer
+  mitk::ShapeBasedInterpolationAlgorithm::GetDistanceMap(const Image *slice,
+                                                         const SliceInformation &information,
+                                                         const RegionType &region)
+{
+  for (auto iter = m_DistanceMapCache.begin(); iter != m_DistanceMapCache.end(); ++iter)
+  {
+    if (iter->Hash == information.Hash && iter->Region == region)
+    {
+      m_DistanceMapCache.splice(m_DistanceMapCache.begin(), m_DistanceMapCache, iter);
+      return m_DistanceMapCache.front().DistanceMap;
+    }
+  }
+
+  DistanceFilterImageType::Pointer distanceMap;
+  AccessFixedDimensionByItk_2(slice, ComputeDistanceMap, 2, region, distanceMap);
+  ++m_NumberOfComputedDistanceMaps;
+
+  if (m_MaximumNumberOfCachedDistanceMaps > 0)
+  {
+    CachedDistanceMap entry;
+    entry.Hash = information.Hash;
+    entry.Region = region;
+    entry.DistanceMap = distanceMap;
+    m_DistanceMapCache.push_front(entry);
+
+    while (m_DistanceMapCache.size() > m_MaximumNumberOfCachedDistanceMaps)
+    {
+      m_DistanceMapCache.pop_back();
+    }
+  }
+
+  return distanceMap;
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::ShapeBasedInterpolationAlgorithm::ComputeDistanceMap(const itk::Image<TPixel, VImageDimension> *binaryImage,
-                                                                mitk::Image::Pointer &result)
+                                                                const RegionType &region,
+                                                                DistanceFilterImageType::Pointer &result)
 {
   typedef itk::Image<TPixel, VImageDimension> DistanceFilterInputImageType;
 
+  typedef itk::RegionOfInterestImageFilter<DistanceFilterInputImageType, DistanceFilterInputImageType> CropFilterType;
   typedef itk::FastChamferDistanceImageFilter<DistanceFilterImageType, DistanceFilterImageType> DistanceFilterType;
   typedef itk::IsoContourDistanceImageFilter<DistanceFilterInputImageType, DistanceFilterImageType> IsoContourType;
   typedef itk::InvertIntensityImageFilter<DistanceFilterInputImageType> InvertIntensityImageFilterType;
   typedef itk::SubtractImageFilter<DistanceFilterImageType, DistanceFilterImageType> SubtractImageFilterType;
 
+  typename CropFilterType::Pointer cropFilter = CropFilterType::New();
   typename DistanceFilterType::Pointer distanceFilter = DistanceFilterType::New();
   typename DistanceFilterType::Pointer distanceFilterInverted = DistanceFilterType::New();
   typename IsoContourType::Pointer isoContourFilter = IsoContourType::New();
@@ -67,15 +232,21 @@ void mitk::ShapeBasedInterpolationAlgorithm::ComputeDistanceMap(const itk::Image
   typename InvertIntensityImageFilterType::Pointer invertFilter = InvertIntensityImageFilterType::New();
   typename SubtractImageFilterType::Pointer subtractImageFilter = SubtractImageFilterType::New();
 
-  // arbitrary maximum distance
-  int maximumDistance = 100;
+  // the chamfer distance between two pixels of the region is a path inside of the region,
+  // so no distance in the region can exceed its diagonal
+  const double diagonal = std::sqrt(static_cast<double>(region.GetSize(0) * region.GetSize(0) +
+                                                        region.GetSize(1) * region.GetSize(1)));
+  const int maximumDistance = std::min(MaximumDistance, static_cast<int>(std::ceil(diagonal)) + 1);
+
+  cropFilter->SetInput(binaryImage);
+  cropFilter->SetRegionOfInterest(region);
 
   // this assumes the image contains only 1 and 0
-  invertFilter->SetInput(binaryImage);
+  invertFilter->SetInput(cropFilter->GetOutput());
   invertFilter->SetMaximum(1);
 
   // do the processing on the image and the inverted image to get inside and outside distance
-  isoContourFilter->SetInput(binaryImage);
+  isoContourFilter->SetInput(cropFilter->GetOutput());
   isoContourFilter->SetFarValue(maximumDistance + 1);
   isoContourFilter->SetLevelSetValue(0);
 
@@ -94,46 +265,47 @@ void mitk::ShapeBasedInterpolationAlgorithm::ComputeDistanceMap(const itk::Image
   subtractImageFilter->SetInput1(distanceFilterInverted->GetOutput());
   subtractImageFilter->Update();
 
-  result = mitk::GrabItkImageMemory(subtractImageFilter->GetOutput());
+  result = subtractImageFilter->GetOutput();
+  result->DisconnectPipeline();
 }
 
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::ShapeBasedInterpolationAlgorithm::InterpolateIntermediateSlice(itk::Image<TPixel, VImageDimension> *result,
-                                                                          const mitk::Image::Pointer &lower,
-                                                                          const mitk::Image::Pointer &upper,
+                                                                          const RegionType &region,
+                                                                          const DistanceFilterImageType *lower,
+                                                                          const DistanceFilterImageType *upper,
                                                                           float ratio)
 {
-  typename DistanceFilterImageType::Pointer lowerITK = DistanceFilterImageType::New();
-  typename DistanceFilterImageType::Pointer upperITK = DistanceFilterImageType::New();
-
-  CastToItkImage(lower, lowerITK);
-  CastToItkImage(upper, upperITK);
-
-  itk::ImageRegionConstIteratorWithIndex<DistanceFilterImageType> lowerIter(lowerITK,
-                                                                            lowerITK->GetLargestPossibleRegion());
+  typedef itk::Image<TPixel, VImageDimension> ResultImageType;
 
-  lowerIter.GoToBegin();
-
-  if (!lowerITK->GetLargestPossibleRegion().IsInside(upperITK->GetLargestPossibleRegion()) ||
-      !lowerITK->GetLargestPossibleRegion().IsInside(result->GetLargestPossibleRegion()))
+  if (!result->GetLargestPossibleRegion().IsInside(region))
   {
     // TODO Exception etc.
     MITK_ERROR << "The regions of the slices for the 2D interpolation are not equally sized!";
     return;
   }
 
+  // both neighboring slices are empty outside of the region
+  result->FillBuffer(0);
+
+  if (region.GetNumberOfPixels() == 0)
+    return;
+
+  itk::ImageRegionConstIterator<DistanceFilterImageType> lowerIter(lower, lower->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<DistanceFilterImageType> upperIter(upper, upper->GetLargestPossibleRegion());
+  itk::ImageRegionIterator<ResultImageType> resultIter(result, region);
+
   float weight[2] = {1.0f - ratio, ratio};
 
-  while (!lowerIter.IsAtEnd())
+  while (!resultIter.IsAtEnd())
   {
-    typename DistanceFilterImageType::PixelType lowerPixelVal = lowerIter.Get();
-    typename DistanceFilterImageType::PixelType upperPixelVal = upperITK->GetPixel(lowerIter.GetIndex());
-
     typename DistanceFilterImageType::PixelType intermediatePixelVal =
-      (weight[0] * upperPixelVal + weight[1] * lowerPixelVal > 0 ? 0 : 1);
+      (weight[0] * lowerIter.Get() + weight[1] * upperIter.Get() > 0 ? 0 : 1);
 
-    result->SetPixel(lowerIter.GetIndex(), static_cast<TPixel>(intermediatePixelVal));
+    resultIter.Set(static_cast<TPixel>(intermediatePixelVal));
 
     ++lowerIter;
+    ++upperIter;
+    ++resultIter;
   }
 }
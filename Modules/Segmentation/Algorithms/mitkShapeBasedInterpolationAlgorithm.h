@@ -20,6 +20,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkSegmentationInterpolationAlgorithm.h"
 #include <MitkSegmentationExports.h>
 
+#include <itkImageRegion.h>
+
+#include <cstdint>
+#include <list>
+
 namespace mitk
 {
   /**
@@ -31,6 +36,16 @@ namespace mitk
    * G.T. Herman, J. Zheng, C.A. Bucholtz: "Shape-based interpolation"
    * IEEE Computer Graphics & Applications, pp. 69-79,May 1992
    *
+   * The signed distance maps are only computed inside the bounding box of the segmented pixels of both
+   * slices, enlarged by CropMargin pixels. Outside of this box both slices are background, so the
+   * interpolated slice is background there as well. The distance propagation is limited to the diagonal
+   * of the box, larger distances cannot occur inside of it.
+   *
+   * The distance maps of the last slices are cached, keyed on a hash of the slice content and the box.
+   * While the user scrolls between two segmented slices, the same two source slices are interpolated for
+   * every intermediate position, and their distance maps are computed only once. Keep the algorithm
+   * object alive between calls to benefit from the cache.
+   *
    *  Last contributor:
    *  $Author:$
    */
@@ -50,17 +65,68 @@ namespace mitk
                                  unsigned int timeStep,
                                  Image::ConstPointer referenceImage) override;
 
+    /** \brief Number of pixels by which the bounding box of the segmented pixels is enlarged (at least 2). */
+    itkSetMacro(CropMargin, unsigned int);
+    itkGetConstMacro(CropMargin, unsigned int);
+
+    /** \brief Maximum number of distance maps that are kept for reuse (0 disables the cache). */
+    itkSetMacro(MaximumNumberOfCachedDistanceMaps, unsigned int);
+    itkGetConstMacro(MaximumNumberOfCachedDistanceMaps, unsigned int);
+
+    /** \brief Number of distance maps that had to be computed since the creation of this object. */
+    itkGetConstMacro(NumberOfComputedDistanceMaps, unsigned long);
+
+    /** \brief Discards all cached distance maps. */
+    void ClearCache();
+
+  protected:
+    ShapeBasedInterpolationAlgorithm();
+    ~ShapeBasedInterpolationAlgorithm() override;
+
   private:
     typedef itk::Image<mitk::ScalarType, 2> DistanceFilterImageType;
+    typedef itk::ImageRegion<2> RegionType;
+
+    struct SliceInformation
+    {
+      std::uint64_t Hash;
+      bool Empty;
+      RegionType LargestRegion;
+      RegionType BoundingRegion;
+    };
+
+    struct CachedDistanceMap
+    {
+      std::uint64_t Hash;
+      RegionType Region;
+      DistanceFilterImageType::Pointer DistanceMap;
+    };
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void AnalyzeSlice(const itk::Image<TPixel, VImageDimension> *slice, SliceInformation &information);
+
+    DistanceFilterImageType::Pointer GetDistanceMap(const Image *slice,
+                                                    const SliceInformation &information,
+                                                    const RegionType &region);
 
     template <typename TPixel, unsigned int VImageDimension>
-    void ComputeDistanceMap(const itk::Image<TPixel, VImageDimension> *, mitk::Image::Pointer &result);
+    void ComputeDistanceMap(const itk::Image<TPixel, VImageDimension> *,
+                            const RegionType &region,
+                            DistanceFilterImageType::Pointer &result);
 
     template <typename TPixel, unsigned int VImageDimension>
     void InterpolateIntermediateSlice(itk::Image<TPixel, VImageDimension> *result,
-                                      const mitk::Image::Pointer &lowerDistanceImage,
-                                      const mitk::Image::Pointer &upperDistanceImage,
+                                      const RegionType &region,
+                                      const DistanceFilterImageType *lowerDistanceImage,
+                                      const DistanceFilterImageType *upperDistanceImage,
                                       float ratio);
+
+    unsigned int m_CropMargin;
+    unsigned int m_MaximumNumberOfCachedDistanceMaps;
+    unsigned long m_NumberOfComputedDistanceMaps;
+
+    // most recently used first
+    std::list<CachedDistanceMap> m_DistanceMapCache;
   };
 
 } // namespace
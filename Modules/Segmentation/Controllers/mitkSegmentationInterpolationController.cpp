@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageCast.h"
 #include "mitkImageReadAccessor.h"
 #include "mitkImageTimeSelector.h"
+#include "mitkLabelSetImage.h"
 #include <mitkExtractSliceFilter.h>
 #include <mitkImageAccessByItk.h>
 //#include <mitkPlaneGeometry.h>
@@ -47,7 +48,9 @@ mitk::SegmentationInterpolationController *mitk::SegmentationInterpolationContro
 }
 
 mitk::SegmentationInterpolationController::SegmentationInterpolationController()
-  : m_BlockModified(false), m_2DInterpolationActivated(false)
+  : m_InterpolationAlgorithm(ShapeBasedInterpolationAlgorithm::New().GetPointer()),
+    m_BlockModified(false),
+    m_2DInterpolationActivated(false)
 {
 }
 
@@ -137,16 +140,39 @@ void mitk::SegmentationInterpolationController::SetSegmentationVolume(const Imag
 
   s_InterpolatorForImage.insert(std::make_pair(m_Segmentation, this));
 
-  // for all timesteps
-  // scan whole image
-  for (unsigned int timeStep = 0; timeStep < m_Segmentation->GetTimeSteps(); ++timeStep)
+  auto labelSetImage = dynamic_cast<const LabelSetImage *>(m_Segmentation.GetPointer());
+  if (labelSetImage)
+  {
+    // a label set image keeps the voxel counts per slice itself, the counts are the sum of the pixel values
+    for (unsigned int timeStep = 0; timeStep < m_Segmentation->GetTimeSteps(); ++timeStep)
+    {
+      for (auto pixelValue : labelSetImage->GetLabelValuesInImage(timeStep))
+      {
+        if (pixelValue == 0)
+          continue;
+
+        for (unsigned int dim = 0; dim < 3; ++dim)
+        {
+          const std::vector<unsigned int> counts = labelSetImage->GetLabelCountsInSlices(pixelValue, dim, timeStep);
+          for (unsigned int slice = 0; slice < counts.size(); ++slice)
+            m_SegmentationCountInSlice[timeStep][dim][slice] += pixelValue * counts[slice];
+        }
+      }
+    }
+  }
+  else
   {
-    ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();
-    timeSelector->SetInput(m_Segmentation);
-    timeSelector->SetTimeNr(timeStep);
-    timeSelector->UpdateLargestPossibleRegion();
-    Image::Pointer segmentation3D = timeSelector->GetOutput();
-    AccessFixedDimensionByItk_2(segmentation3D, ScanWholeVolume, 3, m_Segmentation, timeStep);
+    // for all timesteps
+    // scan whole image
+    for (unsigned int timeStep = 0; timeStep < m_Segmentation->GetTimeSteps(); ++timeStep)
+    {
+      ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();
+      timeSelector->SetInput(m_Segmentation);
+      timeSelector->SetTimeNr(timeStep);
+      timeSelector->UpdateLargestPossibleRegion();
+      Image::Pointer segmentation3D = timeSelector->GetOutput();
+      AccessFixedDimensionByItk_2(segmentation3D, ScanWholeVolume, 3, m_Segmentation, timeStep);
+    }
   }
 
   // PrintStatus();
@@ -576,9 +602,7 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
   // interpolation algorithm can use e.g. itk::ImageSliceConstIteratorWithIndex to
   //   inspect the original patient image at appropriate positions
 
-  mitk::SegmentationInterpolationAlgorithm::Pointer algorithm =
-    mitk::ShapeBasedInterpolationAlgorithm::New().GetPointer();
-  return algorithm->Interpolate(lowerMITKSlice.GetPointer(),
+  return m_InterpolationAlgorithm->Interpolate(lowerMITKSlice.GetPointer(),
                                 lowerBound,
                                 upperMITKSlice.GetPointer(),
                                 upperBound,
@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkCommon.h"
 #include "mitkImage.h"
+#include "mitkSegmentationInterpolationAlgorithm.h"
 #include <MitkSegmentationExports.h>
 
 #include <itkImage.h>
@@ -217,6 +218,10 @@ namespace mitk
 
     Image::ConstPointer m_Segmentation;
     Image::ConstPointer m_ReferenceImage;
+
+    /// kept between calls, so that the algorithm can reuse its distance maps while the user scrolls
+    SegmentationInterpolationAlgorithm::Pointer m_InterpolationAlgorithm;
+
     bool m_BlockModified;
     bool m_2DInterpolationActivated;
   };
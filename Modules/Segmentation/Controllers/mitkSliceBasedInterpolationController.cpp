@@ -46,7 +46,9 @@ mitk::SliceBasedInterpolationController *mitk::SliceBasedInterpolationController
 }
 
 mitk::SliceBasedInterpolationController::SliceBasedInterpolationController()
-  : m_WorkingImage(nullptr), m_ReferenceImage(nullptr)
+  : m_WorkingImage(nullptr),
+    m_ReferenceImage(nullptr),
+    m_InterpolationAlgorithm(ShapeBasedInterpolationAlgorithm::New().GetPointer())
 {
 }
 
@@ -105,7 +107,20 @@ void mitk::SliceBasedInterpolationController::SetWorkingImage(LabelSetImage *new
 
   this->ResetLabelCount();
 
-  AccessFixedDimensionByItk_1(m_WorkingImage, ScanImageITKProcessing, 3, 0);
+  // the working image keeps the voxel counts per slice of all labels itself
+  const unsigned int numberOfLabels = m_WorkingImage->GetNumberOfLabels();
+  for (auto pixelValue : m_WorkingImage->GetLabelValuesInImage(0))
+  {
+    if (pixelValue >= numberOfLabels)
+      continue;
+
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      const std::vector<unsigned int> counts = m_WorkingImage->GetLabelCountsInSlices(pixelValue, dim, 0);
+      for (unsigned int slice = 0; slice < counts.size(); ++slice)
+        m_LabelCountInSlice[0][dim][slice][pixelValue] = counts[slice];
+    }
+  }
 
   // for all timesteps, scan whole image: TODO: enable this again for 3D+time
   /*
@@ -241,56 +256,6 @@ void mitk::SliceBasedInterpolationController::ScanSliceITKProcessing(const itk::
   }
 }
 
-template <typename TPixel, unsigned int VImageDimension>
-void mitk::SliceBasedInterpolationController::ScanImageITKProcessing(itk::Image<TPixel, VImageDimension> *input,
-                                                                     unsigned int timeStep)
-{
-  typedef itk::ImageSliceConstIteratorWithIndex<itk::Image<TPixel, VImageDimension>> IteratorType;
-
-  IteratorType iter(input, input->GetLargestPossibleRegion());
-  iter.SetFirstDirection(0);
-  iter.SetSecondDirection(1);
-
-  typename IteratorType::IndexType index;
-  unsigned int x = 0;
-  unsigned int y = 0;
-  unsigned int z = 0;
-
-  std::vector<int> numberOfPixels; // number of pixels per slice that are equal to the active label
-  unsigned int numberOfLabels = m_WorkingImage->GetNumberOfLabels();
-  numberOfPixels.resize(numberOfLabels);
-
-  iter.GoToBegin();
-  while (!iter.IsAtEnd())
-  {
-    while (!iter.IsAtEndOfSlice())
-    {
-      while (!iter.IsAtEndOfLine())
-      {
-        index = iter.GetIndex();
-        x = index[0];
-        y = index[1];
-        z = index[2];
-
-        int value = static_cast<unsigned int>(iter.Get());
-        ++m_LabelCountInSlice[timeStep][0][x][value];
-        ++m_LabelCountInSlice[timeStep][1][y][value];
-        ++numberOfPixels[value];
-
-        ++iter;
-      }
-      iter.NextLine();
-    }
-
-    for (unsigned int label = 0; label < numberOfLabels; ++label)
-      m_LabelCountInSlice[timeStep][2][z][label] += numberOfPixels[label];
-
-    // clear label counter
-    numberOfPixels.assign(numberOfLabels, 0);
-    iter.NextSlice();
-  }
-}
-
 mitk::Image::Pointer mitk::SliceBasedInterpolationController::Interpolate(unsigned int sliceDimension,
                                                                           unsigned int sliceIndex,
                                                                           const mitk::PlaneGeometry *currentPlane,
@@ -436,10 +401,7 @@ mitk::Image::Pointer mitk::SliceBasedInterpolationController::Interpolate(unsign
   // interpolation algorithm can use e.g. itk::ImageSliceConstIteratorWithIndex to
   //   inspect the original patient image at appropriate positions
 
-  mitk::SegmentationInterpolationAlgorithm::Pointer algorithm =
-    mitk::ShapeBasedInterpolationAlgorithm::New().GetPointer();
-
-  algorithm->Interpolate(
+  m_InterpolationAlgorithm->Interpolate(
     lowerMITKSlice.GetPointer(), lowerBound, upperMITKSlice.GetPointer(), upperBound, sliceIndex, 0, resultImage);
 
   return resultImage;
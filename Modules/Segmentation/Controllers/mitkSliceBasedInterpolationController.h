@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define mitkSliceBasedInterpolationController_h_Included
 
 #include "mitkLabelSetImage.h"
+#include "mitkSegmentationInterpolationAlgorithm.h"
 #include <MitkSegmentationExports.h>
 
 #include <itkImage.h>
@@ -183,10 +184,6 @@ namespace mitk
     template <typename PixelType>
     void ScanSliceITKProcessing(const itk::Image<PixelType, 2> *, const SetChangedSliceOptions &options);
 
-    /// internal scan of the whole image
-    template <typename TPixel, unsigned int VImageDimension>
-    void ScanImageITKProcessing(itk::Image<TPixel, VImageDimension> *, unsigned int timeStep);
-
     /**
       An array that of flags. One for each dimension of the image. A flag is set, when a slice in a certain dimension
       has at least one pixel that is not 0 (which would mean that it has to be considered by the interpolation
@@ -200,6 +197,9 @@ namespace mitk
 
     LabelSetImage::Pointer m_WorkingImage;
     Image::Pointer m_ReferenceImage;
+
+    /// kept between calls, so that the algorithm can reuse its distance maps while the user scrolls
+    SegmentationInterpolationAlgorithm::Pointer m_InterpolationAlgorithm;
   };
 } // namespace
 
@@ -88,17 +88,18 @@ const char *mitk::FastMarchingTool3D::GetName() const
   return "Fast Marching 3D";
 }
 
+// The parameters are only stored here, the filters may be running in the background.
+// They are passed to the pipeline in Update().
+
 void mitk::FastMarchingTool3D::SetUpperThreshold(double value)
 {
   m_UpperThreshold = value / 10.0;
-  m_ThresholdFilter->SetUpperThreshold(m_UpperThreshold);
   m_NeedUpdate = true;
 }
 
 void mitk::FastMarchingTool3D::SetLowerThreshold(double value)
 {
   m_LowerThreshold = value / 10.0;
-  m_ThresholdFilter->SetLowerThreshold(m_LowerThreshold);
   m_NeedUpdate = true;
 }
 
@@ -107,7 +108,6 @@ void mitk::FastMarchingTool3D::SetBeta(double value)
   if (m_Beta != value)
   {
     m_Beta = value;
-    m_SigmoidFilter->SetBeta(m_Beta);
     m_NeedUpdate = true;
   }
 }
@@ -119,7 +119,6 @@ void mitk::FastMarchingTool3D::SetSigma(double value)
     if (value > 0.0)
     {
       m_Sigma = value;
-      m_GradientMagnitudeFilter->SetSigma(m_Sigma);
       m_NeedUpdate = true;
     }
   }
@@ -130,7 +129,6 @@ void mitk::FastMarchingTool3D::SetAlpha(double value)
   if (m_Alpha != value)
   {
     m_Alpha = value;
-    m_SigmoidFilter->SetAlpha(m_Alpha);
     m_NeedUpdate = true;
   }
 }
@@ -140,7 +138,6 @@ void mitk::FastMarchingTool3D::SetStoppingValue(double value)
   if (m_StoppingValue != value)
   {
     m_StoppingValue = value;
-    m_FastMarchingFilter->SetStoppingValue(m_StoppingValue);
     m_NeedUpdate = true;
   }
 }
@@ -175,8 +172,6 @@ void mitk::FastMarchingTool3D::Activated()
 
   m_ReferenceImageAsITK = InternalImageType::New();
 
-  m_ProgressCommand = mitk::ToolCommand::New();
-
   m_ThresholdFilter = ThresholdingFilterType::New();
   m_ThresholdFilter->SetLowerThreshold(m_LowerThreshold);
   m_ThresholdFilter->SetUpperThreshold(m_UpperThreshold);
@@ -184,24 +179,20 @@ void mitk::FastMarchingTool3D::Activated()
   m_ThresholdFilter->SetInsideValue(1.0);
 
   m_SmoothFilter = SmoothingFilterType::New();
-  m_SmoothFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
   m_SmoothFilter->SetTimeStep(0.05);
   m_SmoothFilter->SetNumberOfIterations(2);
   m_SmoothFilter->SetConductanceParameter(9.0);
 
   m_GradientMagnitudeFilter = GradientFilterType::New();
-  m_GradientMagnitudeFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
   m_GradientMagnitudeFilter->SetSigma(m_Sigma);
 
   m_SigmoidFilter = SigmoidFilterType::New();
-  m_SigmoidFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
   m_SigmoidFilter->SetAlpha(m_Alpha);
   m_SigmoidFilter->SetBeta(m_Beta);
   m_SigmoidFilter->SetOutputMinimum(0.0);
   m_SigmoidFilter->SetOutputMaximum(1.0);
 
   m_FastMarchingFilter = FastMarchingFilterType::New();
-  m_FastMarchingFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
   m_FastMarchingFilter->SetStoppingValue(m_StoppingValue);
 
   m_SeedContainer = NodeContainer::New();
@@ -232,13 +223,11 @@ void mitk::FastMarchingTool3D::Activated()
 
 void mitk::FastMarchingTool3D::Deactivated()
 {
+  this->CancelTasks();
+
   m_ToolManager->GetDataStorage()->Remove(this->m_ResultImageNode);
   m_ToolManager->GetDataStorage()->Remove(this->m_SeedsAsPointSetNode);
   this->ClearSeeds();
-  this->m_SmoothFilter->RemoveAllObservers();
-  this->m_SigmoidFilter->RemoveAllObservers();
-  this->m_GradientMagnitudeFilter->RemoveAllObservers();
-  this->m_FastMarchingFilter->RemoveAllObservers();
   m_ResultImageNode = nullptr;
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
@@ -261,6 +250,9 @@ void mitk::FastMarchingTool3D::Deactivated()
 
 void mitk::FastMarchingTool3D::Initialize()
 {
+  // the reference image is replaced, a running computation must not read it anymore
+  this->CancelTasks();
+
   m_ReferenceImage = dynamic_cast<mitk::Image *>(m_ToolManager->GetReferenceData(0)->GetData());
   if (m_ReferenceImage->GetTimeGeometry()->CountTimeSteps() > 1)
   {
@@ -277,6 +269,9 @@ void mitk::FastMarchingTool3D::Initialize()
 
 void mitk::FastMarchingTool3D::ConfirmSegmentation()
 {
+  // the preview has to show the result of the current parameters
+  this->WaitForTasks();
+
   // combine preview image with current working segmentation
   if (dynamic_cast<mitk::Image *>(m_ResultImageNode->GetData()))
   {
@@ -333,7 +328,6 @@ void mitk::FastMarchingTool3D::OnAddPoint()
   node.SetValue(seedValue);
   node.SetIndex(seedPosition);
   this->m_SeedContainer->InsertElement(this->m_SeedContainer->Size(), node);
-  m_FastMarchingFilter->Modified();
 
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
@@ -351,7 +345,6 @@ void mitk::FastMarchingTool3D::OnDelete()
   {
     // delete last element of seeds container
     this->m_SeedContainer->pop_back();
-    m_FastMarchingFilter->Modified();
 
     mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
@@ -363,46 +356,67 @@ void mitk::FastMarchingTool3D::OnDelete()
 
 void mitk::FastMarchingTool3D::Update()
 {
-  const unsigned int progress_steps = 200;
+  if (!m_NeedUpdate)
+    return;
 
-  if (m_NeedUpdate)
-  {
-    m_ProgressCommand->AddStepsToDo(progress_steps);
+  m_NeedUpdate = false;
 
-    // remove interaction with poinset while updating
-    m_SeedPointInteractor->SetDataNode(nullptr);
-    CurrentlyBusy.Send(true);
-    try
-    {
-      m_ThresholdFilter->Update();
-    }
-    catch (itk::ExceptionObject &excep)
-    {
-      MITK_ERROR << "Exception caught: " << excep.GetDescription();
-
-      m_ProgressCommand->SetProgress(progress_steps);
-      CurrentlyBusy.Send(false);
+  // remove interaction with poinset while updating
+  m_SeedPointInteractor->SetDataNode(nullptr);
 
-      std::string msg = excep.GetDescription();
-      ErrorMessage.Send(msg);
+  // snapshot of the parameters and seeds, the GUI may change them while the pipeline runs
+  const float lowerThreshold = m_LowerThreshold;
+  const float upperThreshold = m_UpperThreshold;
+  const float stoppingValue = m_StoppingValue;
+  const float sigma = m_Sigma;
+  const float alpha = m_Alpha;
+  const float beta = m_Beta;
+
+  NodeContainer::Pointer seeds = NodeContainer::New();
+  seeds->Initialize();
+  for (auto iter = m_SeedContainer->Begin(); iter != m_SeedContainer->End(); ++iter)
+  {
+    seeds->InsertElement(iter.Index(), iter.Value());
+  }
 
-      return;
-    }
-    m_ProgressCommand->SetProgress(progress_steps);
-    CurrentlyBusy.Send(false);
-
-    // make output visible
-    mitk::Image::Pointer result = mitk::Image::New();
-    CastToMitkImage(m_ThresholdFilter->GetOutput(), result);
-    result->GetGeometry()->SetOrigin(m_ReferenceImage->GetGeometry()->GetOrigin());
-    result->GetGeometry()->SetIndexToWorldTransform(m_ReferenceImage->GetGeometry()->GetIndexToWorldTransform());
-    m_ResultImageNode->SetData(result);
-    m_ResultImageNode->SetVisibility(true);
-    mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+  mitk::Image::Pointer referenceImage = m_ReferenceImage;
+  auto result = std::make_shared<mitk::Image::Pointer>();
+
+  // a newer call supersedes this computation, which is then aborted in one of the filters
+  this->SubmitTask(
+    "FastMarching",
+    [=](ToolTaskExecutor::CancellationToken &token) {
+      m_ThresholdFilter->SetLowerThreshold(lowerThreshold);
+      m_ThresholdFilter->SetUpperThreshold(upperThreshold);
+      m_FastMarchingFilter->SetStoppingValue(stoppingValue);
+      m_FastMarchingFilter->SetTrialPoints(seeds);
+      m_GradientMagnitudeFilter->SetSigma(sigma);
+      m_SigmoidFilter->SetAlpha(alpha);
+      m_SigmoidFilter->SetBeta(beta);
+
+      token.Observe(m_SmoothFilter, 2.0f);
+      token.Observe(m_GradientMagnitudeFilter, 1.0f);
+      token.Observe(m_SigmoidFilter, 1.0f);
+      token.Observe(m_FastMarchingFilter, 4.0f);
+      token.Observe(m_ThresholdFilter, 1.0f);
 
-    // add interaction with poinset again
-    m_SeedPointInteractor->SetDataNode(m_SeedsAsPointSetNode);
-  }
+      m_ThresholdFilter->Update();
+      token.ThrowIfCancelled();
+
+      *result = mitk::Image::New();
+      CastToMitkImage(m_ThresholdFilter->GetOutput(), *result);
+      (*result)->GetGeometry()->SetOrigin(referenceImage->GetGeometry()->GetOrigin());
+      (*result)->GetGeometry()->SetIndexToWorldTransform(referenceImage->GetGeometry()->GetIndexToWorldTransform());
+    },
+    [this, result]() {
+      // make output visible
+      m_ResultImageNode->SetData(*result);
+      m_ResultImageNode->SetVisibility(true);
+      mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+
+      // add interaction with poinset again
+      m_SeedPointInteractor->SetDataNode(m_SeedsAsPointSetNode);
+    });
 }
 
 void mitk::FastMarchingTool3D::ClearSeeds()
@@ -437,9 +451,6 @@ void mitk::FastMarchingTool3D::ClearSeeds()
     m_PointSetRemoveObserverTag = m_SeedsAsPointSet->AddObserver(mitk::PointSetRemoveEvent(), pointRemovedCommand);
   }
 
-  if (this->m_FastMarchingFilter.IsNotNull())
-    m_FastMarchingFilter->Modified();
-
   this->m_NeedUpdate = true;
 }
 
@@ -21,7 +21,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDataNode.h"
 #include "mitkPointSet.h"
 #include "mitkPointSetDataInteractor.h"
-#include "mitkToolCommand.h"
 #include <MitkSegmentationExports.h>
 
 #include "mitkMessage.h"
@@ -107,7 +106,9 @@ namespace mitk
     /// \brief Clear all seed points.
     void ClearSeeds();
 
-    /// \brief Updates the itk pipeline and shows the result of FastMarching.
+    /// \brief Updates the itk pipeline in the background and shows the result of FastMarching.
+    ///
+    /// A call while the pipeline is still running cancels the running update.
     void Update();
 
   protected:
@@ -127,8 +128,6 @@ namespace mitk
     /// \brief Reset all relevant inputs of the itk pipeline.
     void Reset();
 
-    mitk::ToolCommand::Pointer m_ProgressCommand;
-
     Image::Pointer m_ReferenceImage;
 
     bool m_NeedUpdate;
@@ -86,6 +86,9 @@ void mitk::OtsuTool3D::Activated()
 
 void mitk::OtsuTool3D::Deactivated()
 {
+  this->CancelTasks();
+  m_RequestedRegionIDs.clear();
+
   m_ToolManager->GetDataStorage()->Remove(this->m_MultiLabelResultNode);
   m_MultiLabelResultNode = nullptr;
   m_ToolManager->GetDataStorage()->Remove(this->m_BinaryPreviewNode);
@@ -110,29 +113,46 @@ us::ModuleResource mitk::OtsuTool3D::GetIconResource() const
 
 void mitk::OtsuTool3D::RunSegmentation(int regions, bool useValley, int numberOfBins)
 {
-  // this->m_OtsuSegmentationDialog->setCursor(Qt::WaitCursor);
-
   int numberOfThresholds = regions - 1;
 
   unsigned int timestep = mitk::RenderingManager::GetInstance()->GetTimeNavigationController()->GetTime()->GetPos();
 
   mitk::Image::Pointer image3D = Get3DImage(m_OriginalImage, timestep);
 
-  mitk::OtsuSegmentationFilter::Pointer otsuFilter = mitk::OtsuSegmentationFilter::New();
-  otsuFilter->SetNumberOfThresholds(numberOfThresholds);
-  otsuFilter->SetValleyEmphasis(useValley);
-  otsuFilter->SetNumberOfBins(numberOfBins);
-  otsuFilter->SetInput(image3D);
-
-  try
-  {
-    otsuFilter->Update();
-  }
-  catch (...)
-  {
-    mitkThrow() << "itkOtsuFilter error (image dimension must be in {2, 3} and image must not be RGB)";
-  }
+  // previews of the current result are outdated now
+  this->CancelTasks("BinaryPreview");
+  m_RequestedRegionIDs.clear();
+
+  auto resultImage = std::make_shared<mitk::LabelSetImage::Pointer>();
+
+  this->SubmitTask(
+    "Segmentation",
+    [image3D, numberOfThresholds, useValley, numberOfBins, resultImage](ToolTaskExecutor::CancellationToken &token) {
+      mitk::OtsuSegmentationFilter::Pointer otsuFilter = mitk::OtsuSegmentationFilter::New();
+      otsuFilter->SetNumberOfThresholds(numberOfThresholds);
+      otsuFilter->SetValleyEmphasis(useValley);
+      otsuFilter->SetNumberOfBins(numberOfBins);
+      otsuFilter->SetInput(image3D);
+
+      try
+      {
+        otsuFilter->Update();
+      }
+      catch (...)
+      {
+        token.ThrowIfCancelled();
+        mitkThrow() << "itkOtsuFilter error (image dimension must be in {2, 3} and image must not be RGB)";
+      }
+      token.ThrowIfCancelled();
+
+      *resultImage = mitk::LabelSetImage::New();
+      (*resultImage)->InitializeByLabeledImage(otsuFilter->GetOutput());
+    },
+    [this, numberOfThresholds, resultImage]() { this->ShowSegmentationResult(*resultImage, numberOfThresholds); });
+}
 
+void mitk::OtsuTool3D::ShowSegmentationResult(mitk::LabelSetImage *resultImage, int numberOfThresholds)
+{
   m_ToolManager->GetDataStorage()->Remove(this->m_MultiLabelResultNode);
   m_MultiLabelResultNode = nullptr;
   m_MultiLabelResultNode = mitk::DataNode::New();
@@ -141,8 +161,6 @@ void mitk::OtsuTool3D::RunSegmentation(int regions, bool useValley, int numberOf
   m_ToolManager->GetDataStorage()->Add(this->m_MultiLabelResultNode);
   m_MultiLabelResultNode->SetOpacity(1.0);
 
-  mitk::LabelSetImage::Pointer resultImage = mitk::LabelSetImage::New();
-  resultImage->InitializeByLabeledImage(otsuFilter->GetOutput());
   this->m_MultiLabelResultNode->SetData(resultImage);
   m_MultiLabelResultNode->SetProperty("binary", mitk::BoolProperty::New(false));
   mitk::RenderingModeProperty::Pointer renderingMode = mitk::RenderingModeProperty::New();
@@ -165,16 +183,34 @@ void mitk::OtsuTool3D::RunSegmentation(int regions, bool useValley, int numberOf
   levWinProp->SetLevelWindow(levelwindow);
   m_MultiLabelResultNode->SetProperty("levelwindow", levWinProp);
 
-  // m_BinaryPreviewNode->SetVisibility(false);
-  //  m_MultiLabelResultNode->SetVisibility(true);
-  // this->m_OtsuSegmentationDialog->setCursor(Qt::ArrowCursor);
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+
+  // regions that were selected while the segmentation was computed
+  if (!m_RequestedRegionIDs.empty())
+  {
+    std::vector<int> regionIDs;
+    regionIDs.swap(m_RequestedRegionIDs);
+    this->UpdateBinaryPreview(regionIDs);
+  }
+
+  SegmentationFinished.Send(numberOfThresholds + 1);
 }
 
 void mitk::OtsuTool3D::ConfirmSegmentation()
 {
+  // the binary preview has to match the current selection
+  this->WaitForTasks();
+
+  auto binaryPreview = dynamic_cast<mitk::Image *>(m_BinaryPreviewNode->GetData());
+  if (nullptr == binaryPreview)
+  {
+    // the computation of the preview failed or no region was selected
+    this->ErrorMessage.Send("No region of the Otsu segmentation is selected.");
+    return;
+  }
+
   mitk::LabelSetImage::Pointer resultImage = mitk::LabelSetImage::New();
-  resultImage->InitializeByLabeledImage(dynamic_cast<mitk::Image *>(m_BinaryPreviewNode->GetData()));
+  resultImage->InitializeByLabeledImage(binaryPreview);
   GetTargetSegmentationNode()->SetData(resultImage);
 
   m_ToolManager->ActivateTool(-1);
@@ -182,13 +218,42 @@ void mitk::OtsuTool3D::ConfirmSegmentation()
 
 void mitk::OtsuTool3D::UpdateBinaryPreview(std::vector<int> regionIDs)
 {
+  if (regionIDs.empty())
+    return;
+
+  // the preview is computed as soon as the new multi label result is available
+  if (this->HasPendingTask("Segmentation"))
+  {
+    m_RequestedRegionIDs = regionIDs;
+    return;
+  }
+
   m_MultiLabelResultNode->SetVisibility(false);
   mitk::Image::Pointer multiLabelSegmentation = dynamic_cast<mitk::Image *>(m_MultiLabelResultNode->GetData());
-  AccessByItk_1(multiLabelSegmentation, CalculatePreview, regionIDs);
+  if (multiLabelSegmentation.IsNull())
+    return;
+
+  auto binarySegmentation = std::make_shared<mitk::Image::Pointer>();
+
+  this->SubmitTask(
+    "BinaryPreview",
+    [this, multiLabelSegmentation, regionIDs, binarySegmentation](ToolTaskExecutor::CancellationToken &token) {
+      AccessByItk_3(multiLabelSegmentation, CalculatePreview, regionIDs, *binarySegmentation, token);
+    },
+    [this, binarySegmentation]() {
+      m_BinaryPreviewNode->SetData(*binarySegmentation);
+      m_BinaryPreviewNode->SetVisibility(true);
+      m_BinaryPreviewNode->SetProperty("outline binary", mitk::BoolProperty::New(false));
+
+      mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+    });
 }
 
 template <typename TPixel, unsigned int VImageDimension>
-void mitk::OtsuTool3D::CalculatePreview(itk::Image<TPixel, VImageDimension> *itkImage, std::vector<int> regionIDs)
+void mitk::OtsuTool3D::CalculatePreview(itk::Image<TPixel, VImageDimension> *itkImage,
+                                        std::vector<int> regionIDs,
+                                        itk::SmartPointer<Image> &binarySegmentation,
+                                        ToolTaskExecutor::CancellationToken &token)
 {
   typedef itk::Image<TPixel, VImageDimension> InputImageType;
   typedef itk::Image<mitk::Tool::DefaultSegmentationDataType, VImageDimension> OutputImageType;
@@ -196,6 +261,7 @@ void mitk::OtsuTool3D::CalculatePreview(itk::Image<TPixel, VImageDimension> *itk
   typedef itk::BinaryThresholdImageFilter<InputImageType, OutputImageType> FilterType;
 
   typename FilterType::Pointer filter = FilterType::New();
+  token.Observe(filter);
 
   // InputImageType::Pointer itkImage;
   typename OutputImageType::Pointer itkBinaryTempImage1;
@@ -215,10 +281,13 @@ void mitk::OtsuTool3D::CalculatePreview(itk::Image<TPixel, VImageDimension> *itk
 
   typename itk::OrImageFilter<OutputImageType, OutputImageType>::Pointer orFilter =
     itk::OrImageFilter<OutputImageType, OutputImageType>::New();
+  token.Observe(orFilter);
 
   // if more than one region id is used compute the union of all given binary regions
   for (auto it = regionIDs.begin(); it != regionIDs.end(); ++it)
   {
+    token.ThrowIfCancelled();
+
     filter->SetLowerThreshold(*it);
     filter->SetUpperThreshold(*it);
     filter->SetInsideValue(1);
@@ -233,14 +302,9 @@ void mitk::OtsuTool3D::CalculatePreview(itk::Image<TPixel, VImageDimension> *itk
     itkBinaryResultImage = orFilter->GetOutput();
     itkBinaryTempImage2 = itkBinaryResultImage;
   }
+  token.ThrowIfCancelled();
   //----------------------------------------------------------------------------------------------------
-  mitk::Image::Pointer binarySegmentation;
   mitk::CastToMitkImage(itkBinaryResultImage, binarySegmentation);
-  m_BinaryPreviewNode->SetData(binarySegmentation);
-  m_BinaryPreviewNode->SetVisibility(true);
-  m_BinaryPreviewNode->SetProperty("outline binary", mitk::BoolProperty::New(false));
-
-  mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 }
 
 // void mitk::OtsuTool3D::UpdateBinaryPreview(int regionID)
@@ -39,12 +39,19 @@ namespace mitk
     const char **GetXPM() const override;
     us::ModuleResource GetIconResource() const override;
 
+    /** \brief Sends the number of regions once a multi label result of RunSegmentation is shown. */
+    Message1<int> SegmentationFinished;
+
     void Activated() override;
     void Deactivated() override;
 
+    /** \brief Computes the multi label result in the background. A new call cancels a running computation.
+
+      SegmentationFinished is sent when the result is shown, errors are sent via ErrorMessage. */
     void RunSegmentation(int regions, bool useValley, int numberOfBins);
     void ConfirmSegmentation();
     // void UpdateBinaryPreview(int regionID);
+    /** \brief Computes the union of the given regions in the background. A new call supersedes a running one. */
     void UpdateBinaryPreview(std::vector<int> regionIDs);
     void UpdateVolumePreview(bool volumeRendering);
     void ShowMultiLabelResultNode(bool);
@@ -55,8 +62,13 @@ namespace mitk
     OtsuTool3D();
     ~OtsuTool3D() override;
 
+    void ShowSegmentationResult(LabelSetImage *resultImage, int numberOfThresholds);
+
     template <typename TPixel, unsigned int VImageDimension>
-    void CalculatePreview(itk::Image<TPixel, VImageDimension> *itkImage, std::vector<int> regionIDs);
+    void CalculatePreview(itk::Image<TPixel, VImageDimension> *itkImage,
+                          std::vector<int> regionIDs,
+                          itk::SmartPointer<Image> &binarySegmentation,
+                          ToolTaskExecutor::CancellationToken &token);
 
     itk::SmartPointer<Image> m_OriginalImage;
     // holds the user selected binary segmentation
@@ -66,6 +78,9 @@ namespace mitk
     // holds the user selected binary segmentation masked original image
     mitk::DataNode::Pointer m_MaskedImagePreviewNode;
 
+    // regions selected while the multilabel result is still being computed
+    std::vector<int> m_RequestedRegionIDs;
+
   }; // class
 } // namespace
 #endif
@@ -107,6 +107,8 @@ void mitk::PickingTool::Activated()
 
 void mitk::PickingTool::Deactivated()
 {
+  this->CancelTasks();
+
   m_PointSet->Clear();
   // remove from data storage and disable interaction
   GetDataStorage()->Remove(m_PointSetNode);
@@ -168,20 +170,35 @@ void mitk::PickingTool::OnPointAdded()
 
   if (orgImage.IsNotNull())
   {
-    if (orgImage->GetDimension() == 4)
-    { // there may be 4D segmentation data even though we currently don't support that
-      mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-      timeSelector->SetInput(orgImage);
-      timeSelector->SetTimeNr(timeStep);
-      timeSelector->UpdateLargestPossibleRegion();
-      mitk::Image *timedImage = timeSelector->GetOutput();
-
-      AccessByItk_2(timedImage, StartRegionGrowing, timedImage->GetGeometry(), seedPoint);
-    }
-    else if (orgImage->GetDimension() == 3)
-    {
-      AccessByItk_2(orgImage, StartRegionGrowing, orgImage->GetGeometry(), seedPoint);
-    }
+    auto result = std::make_shared<mitk::LabelSetImage::Pointer>();
+
+    // picking again before the previous region was grown supersedes it
+    this->SubmitTask(
+      "Picking",
+      [this, orgImage, timeStep, seedPoint, result](ToolTaskExecutor::CancellationToken &token) {
+        if (orgImage->GetDimension() == 4)
+        { // there may be 4D segmentation data even though we currently don't support that
+          mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
+          timeSelector->SetInput(orgImage);
+          timeSelector->SetTimeNr(timeStep);
+          timeSelector->UpdateLargestPossibleRegion();
+          mitk::Image *timedImage = timeSelector->GetOutput();
+
+          AccessByItk_n(timedImage, StartRegionGrowing, (timedImage->GetGeometry(), seedPoint, *result, token));
+        }
+        else if (orgImage->GetDimension() == 3)
+        {
+          AccessByItk_n(orgImage, StartRegionGrowing, (orgImage->GetGeometry(), seedPoint, *result, token));
+        }
+      },
+      [this, result]() {
+        if (result->IsNull())
+          return;
+
+        m_ResultNode->SetData(*result);
+        mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+      });
+
     this->m_PointSet->Clear();
   }
 }
@@ -189,12 +206,15 @@ void mitk::PickingTool::OnPointAdded()
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::PickingTool::StartRegionGrowing(itk::Image<TPixel, VImageDimension> *itkImage,
                                            mitk::BaseGeometry *imageGeometry,
-                                           mitk::PointSet::PointType seedPoint)
+                                           mitk::PointSet::PointType seedPoint,
+                                           mitk::LabelSetImage::Pointer &result,
+                                           ToolTaskExecutor::CancellationToken &token)
 {
   typedef itk::Image<TPixel, VImageDimension> InputImageType;
   typedef typename InputImageType::IndexType IndexType;
   typedef itk::ConnectedThresholdImageFilter<InputImageType, InputImageType> RegionGrowingFilterType;
   typename RegionGrowingFilterType::Pointer regionGrower = RegionGrowingFilterType::New();
+  token.Observe(regionGrower);
 
   // convert world coordinates to image indices
   IndexType seedIndex;
@@ -222,19 +242,19 @@ void mitk::PickingTool::StartRegionGrowing(itk::Image<TPixel, VImageDimension> *
   {
     return;
   }
+  token.ThrowIfCancelled();
 
   // Store result and preview
   mitk::Image::Pointer resultImage = mitk::ImportItkImage(regionGrower->GetOutput(), imageGeometry)->Clone();
-  mitk::LabelSetImage::Pointer resultLabelSetImage = mitk::LabelSetImage::New();
-  resultLabelSetImage->InitializeByLabeledImage(resultImage);
-
-  m_ResultNode->SetData(resultLabelSetImage);
-
-  mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+  result = mitk::LabelSetImage::New();
+  result->InitializeByLabeledImage(resultImage);
 }
 
 void mitk::PickingTool::ConfirmSegmentation()
 {
+  // the picked region has to be complete
+  this->WaitForTasks();
+
   mitk::DataNode::Pointer newNode = mitk::DataNode::New();
   newNode->SetProperty("name", mitk::StringProperty::New(m_WorkingData->GetName() + "_picked"));
 
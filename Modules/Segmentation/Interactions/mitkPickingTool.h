@@ -77,11 +77,13 @@ namespace mitk
 
     mitk::DataNode::Pointer m_ResultNode;
 
-    // itk regrowing
+    // itk regrowing, runs in the background
     template <typename TPixel, unsigned int VImageDimension>
     void StartRegionGrowing(itk::Image<TPixel, VImageDimension> *itkImage,
                             mitk::BaseGeometry *imageGeometry,
-                            mitk::PointSet::PointType seedPoint);
+                            mitk::PointSet::PointType seedPoint,
+                            itk::SmartPointer<LabelSetImage> &result,
+                            ToolTaskExecutor::CancellationToken &token);
 
     // seed point
     PointSet::Pointer m_PointSet;
@@ -394,6 +394,15 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   reslice->SetOverwriteMode(true);
   reslice->Modified();
 
+  // keep the label index of a label set image up to date without rescanning the volume
+  auto *labelSetImage = dynamic_cast<LabelSetImage *>(image);
+  LabelSetImage::IndexRegionType affectedRegion;
+  if (labelSetImage)
+  {
+    affectedRegion = labelSetImage->GetRegionOfPlane(sliceInfo.plane, sliceInfo.timestep);
+    labelSetImage->BeginLabelIndexUpdate(affectedRegion, sliceInfo.timestep);
+  }
+
   mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New(reslice);
   extractor->SetInput(image);
   extractor->SetTimeStep(sliceInfo.timestep);
@@ -404,6 +413,11 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   extractor->Modified();
   extractor->Update();
 
+  if (labelSetImage)
+  {
+    labelSetImage->EndLabelIndexUpdate(affectedRegion, sliceInfo.timestep);
+  }
+
   // the image was modified within the pipeline, but not marked so
   image->Modified();
   image->GetVtkImageData()->Modified();
@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageWriteAccessor.h"
 #include "mitkLevelWindowProperty.h"
 #include "mitkLookupTableProperty.h"
+#include "mitkProgressBar.h"
 #include "mitkProperties.h"
 #include "mitkVtkResliceInterpolationProperty.h"
 #include <mitkDICOMSegmentationPropertyHelper.cpp>
@@ -36,6 +37,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 mitk::Tool::Tool(const char *type, const us::Module *interactorModule)
   : m_EventConfig("DisplayConfigMITK.xml"),
     m_ToolManager(nullptr),
+    m_TasksBusy(false),
+    m_TaskProgressSteps(0),
     m_PredicateImages(NodePredicateDataType::New("Image")), // for reference images
     m_PredicateDim3(NodePredicateDimension::New(3, 1)),
     m_PredicateDim4(NodePredicateDimension::New(4, 1)),
@@ -60,6 +63,8 @@ mitk::Tool::Tool(const char *type, const us::Module *interactorModule)
 
 mitk::Tool::~Tool()
 {
+  ToolTaskExecutor::GetInstance()->CancelAll(this);
+  ToolTaskExecutor::GetInstance()->Wait(this);
 }
 
 bool mitk::Tool::CanHandle(BaseData *) const
@@ -145,6 +150,8 @@ void mitk::Tool::Activated()
 
 void mitk::Tool::Deactivated()
 {
+  this->CancelTasks();
+
   // Re-enabling InteractionEventObservers that have been previously disabled for legacy handling of Tools
   // in new interaction framework
   for (auto it = m_DisplayInteractorConfigs.begin();
@@ -165,6 +172,100 @@ void mitk::Tool::Deactivated()
   m_DisplayInteractorConfigs.clear();
 }
 
+void mitk::Tool::WaitForTasks()
+{
+  // applying a result may submit a follow-up task (e.g. the preview of a new multi label result)
+  do
+  {
+    ToolTaskExecutor::GetInstance()->Wait(this);
+    ToolTaskExecutor::GetInstance()->ProcessPendingCallbacks();
+  } while (this->IsComputing());
+}
+
+bool mitk::Tool::IsComputing() const
+{
+  return ToolTaskExecutor::GetInstance()->IsBusy(static_cast<const void *>(this));
+}
+
+void mitk::Tool::SubmitTask(const std::string &channel,
+                            const ToolTaskExecutor::ComputeFunction &compute,
+                            const std::function<void()> &finished)
+{
+  if (!m_TasksBusy)
+  {
+    m_TasksBusy = true;
+    m_TaskProgressSteps = 0;
+    ProgressBar::GetInstance()->AddStepsToDo(100);
+    CurrentlyBusy.Send(true);
+  }
+
+  ToolTaskExecutor::GetInstance()->Submit(
+    ToolTaskExecutor::TaskKey(this, channel),
+    compute,
+    [this, finished](bool success, const std::string &errorMessage) {
+      this->OnTaskFinished(success, errorMessage, finished);
+    },
+    [this](float progress) { this->OnTaskProgress(progress); });
+}
+
+void mitk::Tool::CancelTasks(const std::string &channel)
+{
+  ToolTaskExecutor::GetInstance()->Cancel(ToolTaskExecutor::TaskKey(this, channel));
+  ToolTaskExecutor::GetInstance()->Wait(this);
+  this->UpdateBusyState();
+}
+
+void mitk::Tool::CancelTasks()
+{
+  ToolTaskExecutor::GetInstance()->CancelAll(this);
+  ToolTaskExecutor::GetInstance()->Wait(this);
+  this->UpdateBusyState();
+}
+
+bool mitk::Tool::HasPendingTask(const std::string &channel) const
+{
+  return ToolTaskExecutor::GetInstance()->IsBusy(ToolTaskExecutor::TaskKey(this, channel));
+}
+
+void mitk::Tool::OnTaskFinished(bool success, const std::string &errorMessage, const std::function<void()> &finished)
+{
+  if (success)
+  {
+    if (finished)
+      finished();
+  }
+  else
+  {
+    MITK_ERROR << this->GetName() << ": " << errorMessage;
+    ErrorMessage.Send(errorMessage);
+  }
+
+  this->UpdateBusyState();
+}
+
+void mitk::Tool::OnTaskProgress(float progress)
+{
+  // superseded computations start over, the progress bar only moves forward
+  const int steps = static_cast<int>(progress * 100.0f);
+  if (steps > m_TaskProgressSteps)
+  {
+    ProgressBar::GetInstance()->Progress(steps - m_TaskProgressSteps);
+    m_TaskProgressSteps = steps;
+  }
+  ProgressMessage.Send(progress);
+}
+
+void mitk::Tool::UpdateBusyState()
+{
+  if (m_TasksBusy && !this->IsComputing())
+  {
+    m_TasksBusy = false;
+    ProgressBar::GetInstance()->Progress(100 - m_TaskProgressSteps);
+    m_TaskProgressSteps = 0;
+    CurrentlyBusy.Send(false);
+  }
+}
+
 itk::Object::Pointer mitk::Tool::GetGUI(const std::string &toolkitPrefix, const std::string &toolkitPostfix)
 {
   itk::Object::Pointer object;
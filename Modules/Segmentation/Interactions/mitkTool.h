@@ -33,6 +33,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNodePredicateProperty.h"
 #include "mitkToolEvents.h"
 #include "mitkToolFactoryMacro.h"
+#include "mitkToolTaskExecutor.h"
 #include <MitkSegmentationExports.h>
 #include <mitkLabel.h>
 
@@ -114,6 +115,11 @@ namespace mitk
      */
     Message1<std::string> GeneralMessage;
 
+    /**
+     * \brief To send the progress (0 to 1) of a computation that runs in the background (to be shown by some GUI)
+     */
+    Message1<float> ProgressMessage;
+
     mitkClassMacro(Tool, EventStateMachine);
 
     // no New(), there should only be subclasses
@@ -197,6 +203,19 @@ namespace mitk
 
     virtual bool CanHandle(BaseData *referenceData) const;
 
+    /**
+    \brief Blocks until all background computations of this tool are finished and applies their results.
+
+    Tasks that are submitted while the results are applied are waited for as well, so the tool is idle
+    when this method returns. Must be called from the GUI thread, e.g. before a preview is confirmed.
+    */
+    void WaitForTasks();
+
+    /**
+    \brief Returns true while a background computation of this tool is queued or running.
+    */
+    bool IsComputing() const;
+
   protected:
     friend class ToolManager;
 
@@ -218,6 +237,39 @@ namespace mitk
     */
     virtual void Deactivated();
 
+    /**
+    \brief Runs compute in a background thread of the mitk::ToolTaskExecutor.
+
+    A task submitted on the same channel supersedes a running or queued one: the old computation is
+    cancelled and only the newest result is applied. finished is called from the GUI thread and should
+    apply the result (set node data, request rendering). compute must not touch the data storage or GUI and
+    should register its ITK filters with the token, so that they report progress and can be aborted.
+
+    While tasks are pending, CurrentlyBusy and ProgressMessage are sent and the application progress bar is
+    advanced. If compute throws, the exception message is sent via ErrorMessage.
+    */
+    void SubmitTask(const std::string &channel,
+                    const ToolTaskExecutor::ComputeFunction &compute,
+                    const std::function<void()> &finished);
+
+    /**
+    \brief Cancels the computation of the channel and waits until it returned. Its result is discarded.
+    */
+    void CancelTasks(const std::string &channel);
+
+    /**
+    \brief Cancels all computations of this tool and waits until they returned.
+
+    Tools that use SubmitTask should call this at the beginning of Deactivated(), before the members used by
+    the computations are reset.
+    */
+    void CancelTasks();
+
+    /**
+    \brief Returns true while a computation of the channel is queued or running.
+    */
+    bool HasPendingTask(const std::string &channel) const;
+
     /**
     \brief Let subclasses change their event configuration.
     */
@@ -234,6 +286,13 @@ namespace mitk
     ToolManager *m_ToolManager;
 
   private:
+    void OnTaskFinished(bool success, const std::string &errorMessage, const std::function<void()> &finished);
+    void OnTaskProgress(float progress);
+    void UpdateBusyState();
+
+    bool m_TasksBusy;
+    int m_TaskProgressSteps;
+
     // for reference data
     NodePredicateDataType::Pointer m_PredicateImages;
     NodePredicateDimension::Pointer m_PredicateDim3;
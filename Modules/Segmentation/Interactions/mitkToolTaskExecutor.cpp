@@ -0,0 +1,448 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkToolTaskExecutor.h"
+
+#include <mitkCallbackFromGUIThread.h>
+#include <mitkLogMacros.h>
+
+#include <itkEventObject.h>
+#include <itkMacro.h>
+
+#include <algorithm>
+#include <cmath>
+
+mitk::ToolTaskExecutor::CancellationToken::CancellationToken() : m_Cancelled(false), m_Progress(0.0f)
+{
+  m_FilterCommand = itk::MemberCommand<CancellationToken>::New();
+  m_FilterCommand->SetCallbackFunction(this, &CancellationToken::OnFilterProgress);
+}
+
+mitk::ToolTaskExecutor::CancellationToken::~CancellationToken()
+{
+  this->ReleaseFilters();
+}
+
+bool mitk::ToolTaskExecutor::CancellationToken::IsCancelled() const
+{
+  return m_Cancelled;
+}
+
+void mitk::ToolTaskExecutor::CancellationToken::Cancel()
+{
+  m_Cancelled = true;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto &observed : m_Filters)
+  {
+    observed.Filter->AbortGenerateDataOn();
+  }
+}
+
+void mitk::ToolTaskExecutor::CancellationToken::ThrowIfCancelled() const
+{
+  if (m_Cancelled)
+  {
+    throw itk::ProcessAborted(__FILE__, __LINE__);
+  }
+}
+
+void mitk::ToolTaskExecutor::CancellationToken::Observe(itk::ProcessObject *filter, float weight)
+{
+  if (filter == nullptr)
+    return;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  ObservedFilter observed;
+  observed.Filter = filter;
+  observed.Tag = filter->AddObserver(itk::ProgressEvent(), m_FilterCommand);
+  observed.Weight = std::max(weight, 0.0f);
+  observed.Progress = 0.0f;
+  m_Filters.push_back(observed);
+
+  if (m_Cancelled)
+  {
+    filter->AbortGenerateDataOn();
+  }
+}
+
+void mitk::ToolTaskExecutor::CancellationToken::SetProgress(float progress)
+{
+  progress = std::min(std::max(progress, 0.0f), 1.0f);
+
+  // only whole percents are reported to the GUI thread
+  const bool changed = std::floor(progress * 100.0f) != std::floor(m_Progress * 100.0f);
+  m_Progress = progress;
+
+  if (changed && m_ProgressChanged)
+  {
+    m_ProgressChanged();
+  }
+}
+
+float mitk::ToolTaskExecutor::CancellationToken::GetProgress() const
+{
+  return m_Progress;
+}
+
+void mitk::ToolTaskExecutor::CancellationToken::OnFilterProgress(itk::Object *caller, const itk::EventObject &)
+{
+  auto *filter = dynamic_cast<itk::ProcessObject *>(caller);
+  if (filter == nullptr)
+    return;
+
+  if (m_Cancelled)
+  {
+    filter->AbortGenerateDataOn();
+    return;
+  }
+
+  float weightedProgress = 0.0f;
+  float totalWeight = 0.0f;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (auto &observed : m_Filters)
+    {
+      if (observed.Filter.GetPointer() == filter)
+      {
+        observed.Progress = filter->GetProgress();
+      }
+      weightedProgress += observed.Weight * observed.Progress;
+      totalWeight += observed.Weight;
+    }
+  }
+
+  if (totalWeight > 0.0f)
+  {
+    this->SetProgress(weightedProgress / totalWeight);
+  }
+}
+
+void mitk::ToolTaskExecutor::CancellationToken::ReleaseFilters()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto &observed : m_Filters)
+  {
+    observed.Filter->RemoveObserver(observed.Tag);
+  }
+  m_Filters.clear();
+}
+
+mitk::ToolTaskExecutor *mitk::ToolTaskExecutor::GetInstance()
+{
+  static ToolTaskExecutor instance;
+  return &instance;
+}
+
+mitk::ToolTaskExecutor::ToolTaskExecutor(unsigned int numberOfThreads, bool postToGUIThread)
+  : m_LastGeneration(0), m_Stop(false), m_PostToGUIThread(postToGUIThread), m_CallbackPosted(false)
+{
+  auto command = itk::SimpleMemberCommand<ToolTaskExecutor>::New();
+  command->SetCallbackFunction(this, &ToolTaskExecutor::PostedCallback);
+  m_GUICommand = command;
+
+  numberOfThreads = std::max(numberOfThreads, 1u);
+  for (unsigned int i = 0; i < numberOfThreads; ++i)
+  {
+    m_Threads.emplace_back(&ToolTaskExecutor::ThreadMain, this);
+  }
+}
+
+mitk::ToolTaskExecutor::~ToolTaskExecutor()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+    for (auto &slot : m_Slots)
+    {
+      if (slot.second.Running)
+        slot.second.Running->Token->Cancel();
+    }
+  }
+  m_TaskCondition.notify_all();
+
+  for (auto &thread : m_Threads)
+  {
+    thread.join();
+  }
+}
+
+void mitk::ToolTaskExecutor::Submit(const TaskKey &key,
+                                    const ComputeFunction &compute,
+                                    const FinishedFunction &finished,
+                                    const ProgressFunction &progress)
+{
+  auto task = std::make_shared<Task>();
+  task->Key = key;
+  task->Compute = compute;
+  task->Finished = finished;
+  task->Progress = progress;
+  task->Token = std::make_shared<CancellationToken>();
+  task->Success = false;
+  task->DeliveredProgress = -1.0f;
+  if (progress)
+  {
+    task->Token->m_ProgressChanged = [this]() { this->PostCallback(); };
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    task->Generation = ++m_LastGeneration;
+
+    Slot &slot = m_Slots[key];
+    slot.Generation = task->Generation;
+
+    const bool alreadyQueued = slot.Waiting != nullptr;
+    if (alreadyQueued)
+      slot.Waiting->Token->Cancel();
+    slot.Waiting = task;
+
+    // a running task of the same key is superseded; the new task is started as soon as it returned
+    if (slot.Running)
+    {
+      slot.Running->Token->Cancel();
+      return;
+    }
+
+    if (alreadyQueued)
+      return;
+
+    m_ReadyKeys.push_back(key);
+  }
+  m_TaskCondition.notify_one();
+}
+
+void mitk::ToolTaskExecutor::Cancel(const TaskKey &key)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto iter = m_Slots.find(key);
+  if (iter == m_Slots.end())
+    return;
+
+  Slot &slot = iter->second;
+  if (slot.Waiting)
+  {
+    slot.Waiting->Token->Cancel();
+    slot.Waiting = nullptr;
+    m_ReadyKeys.erase(std::remove(m_ReadyKeys.begin(), m_ReadyKeys.end(), key), m_ReadyKeys.end());
+  }
+
+  if (slot.Running)
+  {
+    slot.Running->Token->Cancel();
+    slot.Generation = ++m_LastGeneration;
+  }
+  else
+  {
+    m_Slots.erase(iter);
+    m_IdleCondition.notify_all();
+  }
+}
+
+void mitk::ToolTaskExecutor::CancelAll(const void *owner)
+{
+  std::vector<TaskKey> keys;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const auto &slot : m_Slots)
+    {
+      if (slot.first.first == owner)
+        keys.push_back(slot.first);
+    }
+  }
+
+  for (const auto &key : keys)
+  {
+    this->Cancel(key);
+  }
+}
+
+void mitk::ToolTaskExecutor::Wait(const void *owner)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_IdleCondition.wait(lock, [this, owner]() {
+    for (const auto &slot : m_Slots)
+    {
+      if (slot.first.first == owner && (slot.second.Running || slot.second.Waiting))
+        return false;
+    }
+    return true;
+  });
+}
+
+bool mitk::ToolTaskExecutor::IsBusy(const TaskKey &key) const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto iter = m_Slots.find(key);
+  return iter != m_Slots.end() && (iter->second.Running || iter->second.Waiting);
+}
+
+bool mitk::ToolTaskExecutor::IsBusy(const void *owner) const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (const auto &slot : m_Slots)
+  {
+    if (slot.first.first == owner && (slot.second.Running || slot.second.Waiting))
+      return true;
+  }
+  return false;
+}
+
+unsigned int mitk::ToolTaskExecutor::ProcessPendingCallbacks()
+{
+  std::vector<TaskPointer> finishedTasks;
+  std::vector<TaskPointer> runningTasks;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_CallbackPosted = false;
+
+    for (const auto &task : m_FinishedTasks)
+    {
+      // results of tasks that were superseded or cancelled after they finished are dropped
+      auto iter = m_Slots.find(task->Key);
+      if (iter == m_Slots.end() || iter->second.Generation != task->Generation)
+        continue;
+
+      finishedTasks.push_back(task);
+      if (!iter->second.Running && !iter->second.Waiting)
+        m_Slots.erase(iter);
+    }
+    m_FinishedTasks.clear();
+
+    for (const auto &slot : m_Slots)
+    {
+      if (slot.second.Running && slot.second.Running->Progress)
+        runningTasks.push_back(slot.second.Running);
+    }
+  }
+
+  // callbacks are called without holding the lock, they may submit new tasks
+  for (const auto &task : runningTasks)
+  {
+    const float progress = task->Token->GetProgress();
+    if (progress != task->DeliveredProgress)
+    {
+      task->DeliveredProgress = progress;
+      task->Progress(progress);
+    }
+  }
+
+  for (const auto &task : finishedTasks)
+  {
+    if (task->Progress && task->DeliveredProgress != 1.0f)
+      task->Progress(1.0f);
+
+    if (task->Finished)
+      task->Finished(task->Success, task->ErrorMessage);
+  }
+
+  return static_cast<unsigned int>(finishedTasks.size());
+}
+
+void mitk::ToolTaskExecutor::ThreadMain()
+{
+  while (true)
+  {
+    TaskPointer task;
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_TaskCondition.wait(lock, [this]() { return m_Stop || !m_ReadyKeys.empty(); });
+      if (m_Stop)
+        return;
+
+      TaskKey key = m_ReadyKeys.front();
+      m_ReadyKeys.pop_front();
+
+      Slot &slot = m_Slots[key];
+      task = slot.Waiting;
+      slot.Waiting = nullptr;
+      slot.Running = task;
+    }
+
+    if (!task)
+      continue;
+
+    if (!task->Token->IsCancelled())
+    {
+      try
+      {
+        task->Compute(*(task->Token));
+        task->Success = true;
+      }
+      catch (const itk::ProcessAborted &)
+      {
+        task->ErrorMessage = "Computation aborted.";
+      }
+      catch (const std::exception &e)
+      {
+        task->ErrorMessage = e.what();
+      }
+      catch (...)
+      {
+        task->ErrorMessage = "Unknown error.";
+      }
+    }
+    // observers are removed here, the filters may be used by the next task of this key right away
+    task->Token->ReleaseFilters();
+
+    bool post = false;
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      auto iter = m_Slots.find(task->Key);
+      if (iter != m_Slots.end())
+      {
+        Slot &slot = iter->second;
+        slot.Running = nullptr;
+
+        if (slot.Waiting)
+        {
+          m_ReadyKeys.push_back(task->Key);
+          m_TaskCondition.notify_one();
+        }
+        else if (!task->Token->IsCancelled() && slot.Generation == task->Generation)
+        {
+          m_FinishedTasks.push_back(task);
+          post = true;
+        }
+        else
+        {
+          m_Slots.erase(iter);
+        }
+      }
+      m_IdleCondition.notify_all();
+    }
+
+    if (post)
+      this->PostCallback();
+  }
+}
+
+void mitk::ToolTaskExecutor::PostCallback()
+{
+  if (!m_PostToGUIThread)
+    return;
+
+  // at most one callback is queued in the GUI event loop at any time
+  if (!m_CallbackPosted.exchange(true))
+  {
+    CallbackFromGUIThread::GetInstance()->CallThisFromGUIThread(m_GUICommand);
+  }
+}
+
+void mitk::ToolTaskExecutor::PostedCallback()
+{
+  this->ProcessPendingCallbacks();
+}
@@ -0,0 +1,208 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkToolTaskExecutor_h_Included
+#define mitkToolTaskExecutor_h_Included
+
+#include <MitkSegmentationExports.h>
+
+#include <itkCommand.h>
+#include <itkProcessObject.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mitk
+{
+  /**
+    \brief Runs the computations of segmentation tools in background threads.
+
+    \ingroup ToolManagerEtAl
+
+    A task consists of a compute function, which is executed by one of the worker threads, and a finished
+    function, which is called from the GUI thread (see mitk::CallbackFromGUIThread) once the computation
+    succeeded. Tasks are identified by a key made of an owner (usually the tool) and a channel name.
+
+    Tasks with the same key are coalesced: submitting a task cancels the running task of the same key and
+    replaces a task that is still waiting. Only the result of the newest task of a key is ever delivered,
+    so that a preview that is recomputed on every slider movement never shows outdated results and never
+    blocks rendering. Tasks of the same key never run concurrently, so a compute function may use ITK
+    filters that are stored in the tool.
+
+    Each task gets a CancellationToken. ITK filters registered with CancellationToken::Observe report their
+    progress through the token and are aborted via itk::ProcessObject::AbortGenerateDataOn() when the task
+    is cancelled or superseded.
+
+    Tools normally use this class through mitk::Tool::SubmitTask.
+  */
+  class MITKSEGMENTATION_EXPORT ToolTaskExecutor
+  {
+  public:
+    /**
+      \brief Shared state between a task and the code that cancels it.
+    */
+    class MITKSEGMENTATION_EXPORT CancellationToken
+    {
+    public:
+      CancellationToken();
+      ~CancellationToken();
+
+      bool IsCancelled() const;
+
+      /** \brief Marks the task as cancelled and aborts all observed filters. */
+      void Cancel();
+
+      /** \brief Throws an itk::ProcessAborted exception if the task was cancelled. */
+      void ThrowIfCancelled() const;
+
+      /**
+        \brief Aborts the filter when the task gets cancelled and uses its progress as progress of the task.
+
+        If several filters are observed, the task progress is the weighted mean of the filter progresses.
+        The observer is removed when the compute function of the task returns.
+      */
+      void Observe(itk::ProcessObject *filter, float weight = 1.0f);
+
+      /** \brief Progress of the task in [0, 1] */
+      void SetProgress(float progress);
+      float GetProgress() const;
+
+    private:
+      friend class ToolTaskExecutor;
+
+      struct ObservedFilter
+      {
+        itk::ProcessObject::Pointer Filter;
+        unsigned long Tag;
+        float Weight;
+        float Progress;
+      };
+
+      void OnFilterProgress(itk::Object *caller, const itk::EventObject &event);
+      void ReleaseFilters();
+
+      std::atomic<bool> m_Cancelled;
+      std::atomic<float> m_Progress;
+      std::mutex m_Mutex;
+      std::vector<ObservedFilter> m_Filters;
+      itk::MemberCommand<CancellationToken>::Pointer m_FilterCommand;
+      std::function<void()> m_ProgressChanged;
+    };
+
+    typedef std::pair<const void *, std::string> TaskKey;
+    typedef std::function<void(CancellationToken &)> ComputeFunction;
+    typedef std::function<void(bool success, const std::string &errorMessage)> FinishedFunction;
+    typedef std::function<void(float progress)> ProgressFunction;
+
+    /** \brief The executor that is shared by all tools of the module. */
+    static ToolTaskExecutor *GetInstance();
+
+    /**
+      \param numberOfThreads number of worker threads
+      \param postToGUIThread if false, results are only delivered by explicit calls of ProcessPendingCallbacks()
+    */
+    explicit ToolTaskExecutor(unsigned int numberOfThreads = 2, bool postToGUIThread = true);
+    ~ToolTaskExecutor();
+
+    /**
+      \brief Queues a task and supersedes any running or waiting task with the same key.
+
+      finished is called from the GUI thread, with success == false and the exception message if
+      compute threw. progress is optional and also called from the GUI thread.
+    */
+    void Submit(const TaskKey &key,
+                const ComputeFunction &compute,
+                const FinishedFunction &finished,
+                const ProgressFunction &progress = ProgressFunction());
+
+    /** \brief Cancels the running and the waiting task of the key. No result of them is delivered. */
+    void Cancel(const TaskKey &key);
+
+    /** \brief Cancels all tasks of the owner. */
+    void CancelAll(const void *owner);
+
+    /** \brief Blocks until no task of the owner is running or waiting. Must not be called from a compute function. */
+    void Wait(const void *owner);
+
+    /** \brief Returns true if a task of the key is running or waiting. */
+    bool IsBusy(const TaskKey &key) const;
+
+    /** \brief Returns true if any task of the owner is running or waiting. */
+    bool IsBusy(const void *owner) const;
+
+    /**
+      \brief Delivers the progress of running tasks and the results of finished tasks.
+
+      Is called automatically from the GUI thread. Returns the number of delivered results.
+    */
+    unsigned int ProcessPendingCallbacks();
+
+  private:
+    struct Task
+    {
+      TaskKey Key;
+      unsigned long Generation;
+      ComputeFunction Compute;
+      FinishedFunction Finished;
+      ProgressFunction Progress;
+      std::shared_ptr<CancellationToken> Token;
+      bool Success;
+      std::string ErrorMessage;
+      float DeliveredProgress;
+    };
+    typedef std::shared_ptr<Task> TaskPointer;
+
+    struct Slot
+    {
+      TaskPointer Running;
+      TaskPointer Waiting;
+      unsigned long Generation;
+    };
+
+    ToolTaskExecutor(const ToolTaskExecutor &) = delete;
+    ToolTaskExecutor &operator=(const ToolTaskExecutor &) = delete;
+
+    void ThreadMain();
+    void PostCallback();
+    void PostedCallback();
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_TaskCondition;
+    std::condition_variable m_IdleCondition;
+
+    std::map<TaskKey, Slot> m_Slots;
+    std::deque<TaskKey> m_ReadyKeys;
+    std::vector<TaskPointer> m_FinishedTasks;
+    unsigned long m_LastGeneration;
+    bool m_Stop;
+
+    bool m_PostToGUIThread;
+    std::atomic<bool> m_CallbackPosted;
+    itk::Command::Pointer m_GUICommand;
+
+    std::vector<std::thread> m_Threads;
+  };
+}
+
+#endif
@@ -29,7 +29,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkProgressBar.h"
 #include "mitkRenderingManager.h"
 #include "mitkRenderingModeProperty.h"
-#include "mitkToolCommand.h"
 #include "mitkToolManager.h"
 #include <mitkSliceNavigationController.h>
 
@@ -40,7 +39,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <vtkLookupTable.h>
 
-#include <itkExceptionObject.h>
 #include <itkGradientMagnitudeRecursiveGaussianImageFilter.h>
 #include <itkWatershedImageFilter.h>
 
@@ -64,6 +62,7 @@ void mitk::WatershedTool::Activated()
 
 void mitk::WatershedTool::Deactivated()
 {
+  this->CancelTasks();
   Superclass::Deactivated();
 }
 
@@ -95,55 +94,59 @@ void mitk::WatershedTool::DoIt()
   unsigned int timestep = mitk::RenderingManager::GetInstance()->GetTimeNavigationController()->GetTime()->GetPos();
   input = Get3DImage(input, timestep);
 
-  mitk::Image::Pointer output;
-
-  try
-  {
-    // create and run itk filter pipeline
-    AccessByItk_1(input.GetPointer(), ITKWatershed, output);
-
-    mitk::LabelSetImage::Pointer labelSetOutput = mitk::LabelSetImage::New();
-    labelSetOutput->InitializeByLabeledImage(output);
-
-    // create a new datanode for output
-    mitk::DataNode::Pointer dataNode = mitk::DataNode::New();
-    dataNode->SetData(labelSetOutput);
-
-    // set name of data node
-    std::string name = referenceData->GetName() + "_Watershed";
-    dataNode->SetName(name);
-
-    // look, if there is already a node with this name
-    mitk::DataStorage::SetOfObjects::ConstPointer children =
-      m_ToolManager->GetDataStorage()->GetDerivations(referenceData);
-    mitk::DataStorage::SetOfObjects::ConstIterator currentNode = children->Begin();
-    mitk::DataNode::Pointer removeNode;
-    while (currentNode != children->End())
-    {
-      if (dataNode->GetName().compare(currentNode->Value()->GetName()) == 0)
+  // the parameters are copied, the sliders may change them while the pipeline runs
+  const std::pair<double, double> parameters(m_Threshold, m_Level);
+  auto labelSetOutput = std::make_shared<mitk::LabelSetImage::Pointer>();
+
+  this->SubmitTask(
+    "Watershed",
+    [this, input, parameters, labelSetOutput](ToolTaskExecutor::CancellationToken &token) {
+      mitk::Image::Pointer output;
+
+      // create and run itk filter pipeline
+      AccessByItk_3(input.GetPointer(), ITKWatershed, output, parameters, token);
+
+      *labelSetOutput = mitk::LabelSetImage::New();
+      (*labelSetOutput)->InitializeByLabeledImage(output);
+    },
+    [this, referenceData, labelSetOutput]() {
+      // create a new datanode for output
+      mitk::DataNode::Pointer dataNode = mitk::DataNode::New();
+      dataNode->SetData(*labelSetOutput);
+
+      // set name of data node
+      std::string name = referenceData->GetName() + "_Watershed";
+      dataNode->SetName(name);
+
+      // look, if there is already a node with this name
+      mitk::DataStorage::SetOfObjects::ConstPointer children =
+        m_ToolManager->GetDataStorage()->GetDerivations(referenceData);
+      mitk::DataStorage::SetOfObjects::ConstIterator currentNode = children->Begin();
+      mitk::DataNode::Pointer removeNode;
+      while (currentNode != children->End())
       {
-        removeNode = currentNode->Value();
+        if (dataNode->GetName().compare(currentNode->Value()->GetName()) == 0)
+        {
+          removeNode = currentNode->Value();
+        }
+        currentNode++;
       }
-      currentNode++;
-    }
-    // remove node with same name
-    if (removeNode.IsNotNull())
-      m_ToolManager->GetDataStorage()->Remove(removeNode);
-
-    // add output to the data storage
-    m_ToolManager->GetDataStorage()->Add(dataNode, referenceData);
-  }
-  catch (itk::ExceptionObject &e)
-  {
-    MITK_ERROR << "Watershed Filter Error: " << e.GetDescription();
-  }
-
-  RenderingManager::GetInstance()->RequestUpdateAll();
+      // remove node with same name
+      if (removeNode.IsNotNull())
+        m_ToolManager->GetDataStorage()->Remove(removeNode);
+
+      // add output to the data storage
+      m_ToolManager->GetDataStorage()->Add(dataNode, referenceData);
+
+      RenderingManager::GetInstance()->RequestUpdateAll();
+    });
 }
 
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::WatershedTool::ITKWatershed(itk::Image<TPixel, VImageDimension> *originalImage,
-                                       mitk::Image::Pointer &segmentation)
+                                       mitk::Image::Pointer &segmentation,
+                                       const std::pair<double, double> &parameters,
+                                       ToolTaskExecutor::CancellationToken &token)
 {
   typedef itk::WatershedImageFilter<itk::Image<float, VImageDimension>> WatershedFilter;
   typedef itk::GradientMagnitudeRecursiveGaussianImageFilter<itk::Image<TPixel, VImageDimension>,
@@ -154,18 +157,16 @@ void mitk::WatershedTool::ITKWatershed(itk::Image<TPixel, VImageDimension> *orig
   typename MagnitudeFilter::Pointer magnitude = MagnitudeFilter::New();
   magnitude->SetInput(originalImage);
   magnitude->SetSigma(1.0);
-
-  // use the progress bar
-  mitk::ToolCommand::Pointer command = mitk::ToolCommand::New();
-  command->AddStepsToDo(60);
+  token.Observe(magnitude, 1.0f);
 
   // then add the watershed filter to the pipeline
   typename WatershedFilter::Pointer watershed = WatershedFilter::New();
   watershed->SetInput(magnitude->GetOutput());
-  watershed->SetThreshold(m_Threshold);
-  watershed->SetLevel(m_Level);
-  watershed->AddObserver(itk::ProgressEvent(), command);
+  watershed->SetThreshold(parameters.first);
+  watershed->SetLevel(parameters.second);
+  token.Observe(watershed, 4.0f);
   watershed->Update();
+  token.ThrowIfCancelled();
 
   // then make sure, that the output has the desired pixel type
   typedef itk::CastImageFilter<typename WatershedFilter::OutputImageType,
@@ -177,9 +178,6 @@ void mitk::WatershedTool::ITKWatershed(itk::Image<TPixel, VImageDimension> *orig
   // start the whole pipeline
   cast->Update();
 
-  // reset the progress bar by setting progress
-  command->SetProgress(10);
-
   // since we obtain a new image from our pipeline, we have to make sure, that our mitk::Image::Pointer
   // is responsible for the memory management of the output image
   segmentation = mitk::GrabItkImageMemory(cast->GetOutput());
@@ -57,7 +57,10 @@ namespace mitk
     void SetLevel(double l) { m_Level = l; }
     /** \brief Grabs the tool reference data and creates an ITK pipeline consisting of a GradientMagnitude
       * image filter followed by a Watershed image filter. The output of the filter pipeline is then added
-      * to the data storage. */
+      * to the data storage.
+      *
+      * The pipeline runs in the background. Calling DoIt() again before it finished cancels the running
+      * computation, only the result of the last call is added to the data storage. */
     void DoIt();
 
     /** \brief Creates and runs an ITK filter pipeline consisting of the filters: GradientMagnitude-, Watershed- and
@@ -65,9 +68,14 @@ namespace mitk
       *
       * \param originalImage The input image, which is delivered by the AccessByItk macro.
       * \param segmentation A pointer to the output image, which will point to the pipeline output after execution.
+      * \param parameters Threshold and level of the watershed filter.
+      * \param token Aborts the pipeline when the computation is cancelled.
       */
     template <typename TPixel, unsigned int VImageDimension>
-    void ITKWatershed(itk::Image<TPixel, VImageDimension> *originalImage, itk::SmartPointer<mitk::Image> &segmentation);
+    void ITKWatershed(itk::Image<TPixel, VImageDimension> *originalImage,
+                      itk::SmartPointer<mitk::Image> &segmentation,
+                      const std::pair<double, double> &parameters,
+                      ToolTaskExecutor::CancellationToken &token);
 
     const char **GetXPM() const override;
     const char *GetName() const override;
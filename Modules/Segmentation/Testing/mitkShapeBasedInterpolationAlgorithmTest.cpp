@@ -0,0 +1,161 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkITKImageImport.h>
+#include <mitkImageCast.h>
+#include <mitkShapeBasedInterpolationAlgorithm.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkImage.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+class mitkShapeBasedInterpolationAlgorithmTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkShapeBasedInterpolationAlgorithmTestSuite);
+  MITK_TEST(TestInterpolationIsRestrictedToBoundingBox);
+  MITK_TEST(TestDistanceMapsAreReused);
+  MITK_TEST(TestEmptySlices);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<unsigned char, 2> SliceType;
+
+  mitk::ShapeBasedInterpolationAlgorithm::Pointer m_Algorithm;
+  mitk::Image::Pointer m_LowerSlice;
+  mitk::Image::Pointer m_UpperSlice;
+
+  static mitk::Image::Pointer CreateDisc(long centerX, long centerY, long radius)
+  {
+    SliceType::RegionType region;
+    region.SetSize(0, 64);
+    region.SetSize(1, 64);
+
+    SliceType::Pointer slice = SliceType::New();
+    slice->SetRegions(region);
+    slice->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<SliceType> iter(slice, region);
+    for (; !iter.IsAtEnd(); ++iter)
+    {
+      const long dx = iter.GetIndex()[0] - centerX;
+      const long dy = iter.GetIndex()[1] - centerY;
+      iter.Set(radius >= 0 && dx * dx + dy * dy <= radius * radius ? 1 : 0);
+    }
+
+    return mitk::ImportItkImage(slice)->Clone();
+  }
+
+  mitk::Image::Pointer Interpolate(unsigned int requestedIndex)
+  {
+    mitk::Image::Pointer result = m_LowerSlice->Clone();
+    return m_Algorithm->Interpolate(
+      m_LowerSlice.GetPointer(), 0, m_UpperSlice.GetPointer(), 4, requestedIndex, 0, result, 0, nullptr);
+  }
+
+  static SliceType::Pointer ToItk(const mitk::Image::Pointer &image)
+  {
+    SliceType::Pointer slice;
+    mitk::CastToItkImage(image, slice);
+    return slice;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Algorithm = mitk::ShapeBasedInterpolationAlgorithm::New();
+    m_LowerSlice = CreateDisc(24, 30, 6);
+    m_UpperSlice = CreateDisc(32, 30, 6);
+  }
+
+  void tearDown() override
+  {
+    m_Algorithm = nullptr;
+    m_LowerSlice = nullptr;
+    m_UpperSlice = nullptr;
+  }
+
+  void TestInterpolationIsRestrictedToBoundingBox()
+  {
+    SliceType::Pointer result = ToItk(this->Interpolate(2));
+
+    unsigned int numberOfSegmentedPixels = 0;
+    itk::ImageRegionConstIteratorWithIndex<SliceType> iter(result, result->GetLargestPossibleRegion());
+    for (; !iter.IsAtEnd(); ++iter)
+    {
+      const SliceType::IndexType index = iter.GetIndex();
+      const bool insideBox = index[0] >= 18 && index[0] <= 38 && index[1] >= 24 && index[1] <= 36;
+      if (!insideBox)
+      {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("No pixel outside of the bounding box of both slices is segmented",
+                                     0,
+                                     static_cast<int>(iter.Get()));
+      }
+      numberOfSegmentedPixels += iter.Get();
+    }
+
+    CPPUNIT_ASSERT(numberOfSegmentedPixels > 0);
+
+    // the center between both discs is inside of both of them
+    SliceType::IndexType center = {{28, 30}};
+    CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(result->GetPixel(center)));
+  }
+
+  void TestDistanceMapsAreReused()
+  {
+    SliceType::Pointer first = ToItk(this->Interpolate(1));
+    CPPUNIT_ASSERT_EQUAL(2ul, m_Algorithm->GetNumberOfComputedDistanceMaps());
+
+    // scrolling to the other intermediate slices does not change the source slices
+    this->Interpolate(2);
+    this->Interpolate(3);
+    CPPUNIT_ASSERT_EQUAL(2ul, m_Algorithm->GetNumberOfComputedDistanceMaps());
+
+    SliceType::Pointer second = ToItk(this->Interpolate(1));
+    itk::ImageRegionConstIterator<SliceType> firstIter(first, first->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<SliceType> secondIter(second, second->GetLargestPossibleRegion());
+    for (; !firstIter.IsAtEnd(); ++firstIter, ++secondIter)
+    {
+      CPPUNIT_ASSERT_EQUAL(firstIter.Get(), secondIter.Get());
+    }
+
+    // a changed slice gets a new distance map
+    m_UpperSlice = CreateDisc(34, 30, 6);
+    this->Interpolate(2);
+    CPPUNIT_ASSERT_EQUAL(4ul, m_Algorithm->GetNumberOfComputedDistanceMaps());
+
+    m_Algorithm->ClearCache();
+    this->Interpolate(2);
+    CPPUNIT_ASSERT_EQUAL(6ul, m_Algorithm->GetNumberOfComputedDistanceMaps());
+  }
+
+  void TestEmptySlices()
+  {
+    m_LowerSlice = CreateDisc(24, 30, -1);
+    m_UpperSlice = CreateDisc(32, 30, -1);
+
+    SliceType::Pointer result = ToItk(this->Interpolate(2));
+    itk::ImageRegionConstIterator<SliceType> iter(result, result->GetLargestPossibleRegion());
+    for (; !iter.IsAtEnd(); ++iter)
+    {
+      CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(iter.Get()));
+    }
+    CPPUNIT_ASSERT_EQUAL(0ul, m_Algorithm->GetNumberOfComputedDistanceMaps());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkShapeBasedInterpolationAlgorithm)
@@ -0,0 +1,241 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkToolTaskExecutor.h>
+
+#include <itkBinaryThresholdImageFilter.h>
+#include <itkImage.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+class mitkToolTaskExecutorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkToolTaskExecutorTestSuite);
+  MITK_TEST(TestResultIsDeliveredByProcessPendingCallbacks);
+  MITK_TEST(TestNewerTaskSupersedesRunningTask);
+  MITK_TEST(TestCancelAbortsObservedFilter);
+  MITK_TEST(TestExceptionIsReported);
+  MITK_TEST(TestDifferentKeysRunIndependently);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::ToolTaskExecutor::CancellationToken TokenType;
+
+  mitk::ToolTaskExecutor *m_Executor;
+  int m_Owner;
+
+  static void WaitUntil(const std::atomic<bool> &flag)
+  {
+    while (!flag)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  static void WaitUntilCancelled(const TokenType &token)
+  {
+    while (!token.IsCancelled())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    // results are only delivered by explicit calls of ProcessPendingCallbacks, there is no GUI thread
+    m_Executor = new mitk::ToolTaskExecutor(2, false);
+  }
+
+  void tearDown() override
+  {
+    delete m_Executor;
+    m_Executor = nullptr;
+  }
+
+  void TestResultIsDeliveredByProcessPendingCallbacks()
+  {
+    int result = 0;
+    bool finished = false;
+    float lastProgress = 0.0f;
+
+    m_Executor->Submit(mitk::ToolTaskExecutor::TaskKey(&m_Owner, "Preview"),
+                       [&result](TokenType &token) {
+                         token.SetProgress(0.5f);
+                         result = 42;
+                       },
+                       [&finished](bool success, const std::string &) { finished = success; },
+                       [&lastProgress](float progress) { lastProgress = progress; });
+
+    m_Executor->Wait(&m_Owner);
+    CPPUNIT_ASSERT_MESSAGE("Finished callback must not be called before ProcessPendingCallbacks", !finished);
+    CPPUNIT_ASSERT(!m_Executor->IsBusy(&m_Owner));
+
+    CPPUNIT_ASSERT_EQUAL(1u, m_Executor->ProcessPendingCallbacks());
+    CPPUNIT_ASSERT(finished);
+    CPPUNIT_ASSERT_EQUAL(42, result);
+    CPPUNIT_ASSERT_EQUAL(1.0f, lastProgress);
+
+    CPPUNIT_ASSERT_EQUAL(0u, m_Executor->ProcessPendingCallbacks());
+  }
+
+  void TestNewerTaskSupersedesRunningTask()
+  {
+    const mitk::ToolTaskExecutor::TaskKey key(&m_Owner, "Preview");
+
+    std::atomic<bool> firstStarted(false);
+    std::atomic<bool> firstCancelled(false);
+    std::atomic<int> computedTasks(0);
+    std::vector<int> deliveredTasks;
+
+    m_Executor->Submit(key,
+                       [&](TokenType &token) {
+                         firstStarted = true;
+                         WaitUntilCancelled(token);
+                         firstCancelled = true;
+                         ++computedTasks;
+                       },
+                       [&deliveredTasks](bool, const std::string &) { deliveredTasks.push_back(1); });
+    WaitUntil(firstStarted);
+
+    // the second task is replaced by the third before it could start, the first one is cancelled
+    m_Executor->Submit(key,
+                       [&computedTasks](TokenType &) { ++computedTasks; },
+                       [&deliveredTasks](bool, const std::string &) { deliveredTasks.push_back(2); });
+    m_Executor->Submit(key,
+                       [&computedTasks](TokenType &) { ++computedTasks; },
+                       [&deliveredTasks](bool, const std::string &) { deliveredTasks.push_back(3); });
+    CPPUNIT_ASSERT(m_Executor->IsBusy(key));
+
+    m_Executor->Wait(&m_Owner);
+    m_Executor->ProcessPendingCallbacks();
+
+    CPPUNIT_ASSERT(firstCancelled);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The replaced task must not be computed", 2, computedTasks.load());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), deliveredTasks.size());
+    CPPUNIT_ASSERT_EQUAL(3, deliveredTasks.front());
+  }
+
+  void TestCancelAbortsObservedFilter()
+  {
+    typedef itk::Image<unsigned short, 3> ImageType;
+    typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> FilterType;
+
+    ImageType::RegionType region;
+    region.SetSize(0, 64);
+    region.SetSize(1, 64);
+    region.SetSize(2, 64);
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(region);
+    image->Allocate();
+    image->FillBuffer(1);
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetLowerThreshold(1);
+
+    const mitk::ToolTaskExecutor::TaskKey key(&m_Owner, "Filter");
+    std::atomic<bool> started(false);
+    std::atomic<bool> aborted(false);
+    bool finished = false;
+
+    m_Executor->Submit(key,
+                       [&](TokenType &token) {
+                         token.Observe(filter);
+                         started = true;
+                         WaitUntilCancelled(token);
+                         try
+                         {
+                           filter->Update();
+                         }
+                         catch (const itk::ProcessAborted &)
+                         {
+                           aborted = true;
+                           throw;
+                         }
+                       },
+                       [&finished](bool, const std::string &) { finished = true; });
+
+    WaitUntil(started);
+    m_Executor->Cancel(key);
+    m_Executor->Wait(&m_Owner);
+    m_Executor->ProcessPendingCallbacks();
+
+    CPPUNIT_ASSERT_MESSAGE("The observed filter has to be aborted", aborted);
+    CPPUNIT_ASSERT_MESSAGE("A cancelled task must not deliver a result", !finished);
+
+    // the observer is removed again, the filter can be used without the token
+    filter->Modified();
+    CPPUNIT_ASSERT_NO_THROW(filter->Update());
+  }
+
+  void TestExceptionIsReported()
+  {
+    bool success = true;
+    std::string message;
+
+    m_Executor->Submit(mitk::ToolTaskExecutor::TaskKey(&m_Owner, "Preview"),
+                       [](TokenType &) { throw std::runtime_error("invalid input"); },
+                       [&](bool taskSuccess, const std::string &errorMessage) {
+                         success = taskSuccess;
+                         message = errorMessage;
+                       });
+
+    m_Executor->Wait(&m_Owner);
+    CPPUNIT_ASSERT_EQUAL(1u, m_Executor->ProcessPendingCallbacks());
+    CPPUNIT_ASSERT(!success);
+    CPPUNIT_ASSERT_EQUAL(std::string("invalid input"), message);
+  }
+
+  void TestDifferentKeysRunIndependently()
+  {
+    int otherOwner = 0;
+    std::atomic<bool> release(false);
+    int delivered = 0;
+
+    auto compute = [&release](TokenType &token) {
+      while (!release && !token.IsCancelled())
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    };
+    auto finished = [&delivered](bool success, const std::string &) {
+      if (success)
+        ++delivered;
+    };
+
+    m_Executor->Submit(mitk::ToolTaskExecutor::TaskKey(&m_Owner, "Segmentation"), compute, finished);
+    m_Executor->Submit(mitk::ToolTaskExecutor::TaskKey(&m_Owner, "Preview"), compute, finished);
+    m_Executor->Submit(mitk::ToolTaskExecutor::TaskKey(&otherOwner, "Segmentation"), compute, finished);
+
+    // cancelling one owner does not touch the tasks of another owner
+    m_Executor->CancelAll(&otherOwner);
+    m_Executor->Wait(&otherOwner);
+    CPPUNIT_ASSERT(m_Executor->IsBusy(&m_Owner));
+
+    release = true;
+    m_Executor->Wait(&m_Owner);
+    CPPUNIT_ASSERT_EQUAL(2u, m_Executor->ProcessPendingCallbacks());
+    CPPUNIT_ASSERT_EQUAL(2, delivered);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkToolTaskExecutor)
@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "QmitkOtsuTool3DGUI.h"
 #include "QmitkConfirmSegmentationDialog.h"
 
+#include <QApplication>
 #include <QMessageBox>
 #include <qlabel.h>
 #include <qlayout.h>
@@ -42,6 +43,15 @@ QmitkOtsuTool3DGUI::QmitkOtsuTool3DGUI() : QmitkToolGUI(), m_NumberOfRegions(0)
 
 QmitkOtsuTool3DGUI::~QmitkOtsuTool3DGUI()
 {
+  if (m_OtsuTool3DTool.IsNotNull())
+  {
+    m_OtsuTool3DTool->CurrentlyBusy -=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, bool>(this, &QmitkOtsuTool3DGUI::BusyStateChanged);
+    m_OtsuTool3DTool->ErrorMessage -=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, std::string>(this, &QmitkOtsuTool3DGUI::OnToolErrorMessage);
+    m_OtsuTool3DTool->SegmentationFinished -=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, int>(this, &QmitkOtsuTool3DGUI::OnSegmentationFinished);
+  }
 }
 
 void QmitkOtsuTool3DGUI::OnRegionSpinboxChanged(int numberOfRegions)
@@ -71,7 +81,8 @@ void QmitkOtsuTool3DGUI::OnRegionSelectionChanged()
     for (it = m_SelectedItems.begin(); it != m_SelectedItems.end(); ++it)
       regionIDs.push_back((*it)->text().toInt());
     m_OtsuTool3DTool->UpdateBinaryPreview(regionIDs);
-    m_Controls.m_ConfSegButton->setEnabled(true);
+    // otherwise enabled by BusyStateChanged once the preview is available
+    m_Controls.m_ConfSegButton->setEnabled(!m_OtsuTool3DTool->IsComputing());
   }
 }
 
@@ -93,7 +104,27 @@ void QmitkOtsuTool3DGUI::OnAdvancedSettingsButtonToggled(bool toggled)
 
 void QmitkOtsuTool3DGUI::OnNewToolAssociated(mitk::Tool *tool)
 {
+  if (m_OtsuTool3DTool.IsNotNull())
+  {
+    m_OtsuTool3DTool->CurrentlyBusy -=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, bool>(this, &QmitkOtsuTool3DGUI::BusyStateChanged);
+    m_OtsuTool3DTool->ErrorMessage -=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, std::string>(this, &QmitkOtsuTool3DGUI::OnToolErrorMessage);
+    m_OtsuTool3DTool->SegmentationFinished -=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, int>(this, &QmitkOtsuTool3DGUI::OnSegmentationFinished);
+  }
+
   m_OtsuTool3DTool = dynamic_cast<mitk::OtsuTool3D *>(tool);
+
+  if (m_OtsuTool3DTool.IsNotNull())
+  {
+    m_OtsuTool3DTool->CurrentlyBusy +=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, bool>(this, &QmitkOtsuTool3DGUI::BusyStateChanged);
+    m_OtsuTool3DTool->ErrorMessage +=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, std::string>(this, &QmitkOtsuTool3DGUI::OnToolErrorMessage);
+    m_OtsuTool3DTool->SegmentationFinished +=
+      mitk::MessageDelegate1<QmitkOtsuTool3DGUI, int>(this, &QmitkOtsuTool3DGUI::OnSegmentationFinished);
+  }
 }
 
 void QmitkOtsuTool3DGUI::OnSegmentationRegionAccept()
@@ -131,53 +162,69 @@ void QmitkOtsuTool3DGUI::OnSpinboxValueAccept()
 
   if (m_OtsuTool3DTool.IsNotNull())
   {
-    try
+    int proceed;
+    QMessageBox *messageBox = new QMessageBox(QMessageBox::Question,
+                                              nullptr,
+                                              "The otsu segmentation computation may take several minutes depending "
+                                              "on the number of Regions you selected. Proceed anyway?",
+                                              QMessageBox::Ok | QMessageBox::Cancel);
+    if (m_Controls.m_Spinbox->value() >= 5)
     {
-      int proceed;
-      QMessageBox *messageBox = new QMessageBox(QMessageBox::Question,
-                                                nullptr,
-                                                "The otsu segmentation computation may take several minutes depending "
-                                                "on the number of Regions you selected. Proceed anyway?",
-                                                QMessageBox::Ok | QMessageBox::Cancel);
-      if (m_Controls.m_Spinbox->value() >= 5)
-      {
-        proceed = messageBox->exec();
-        if (proceed != QMessageBox::Ok)
-          return;
-      }
-
-      m_NumberOfRegions = m_Controls.m_Spinbox->value();
-      m_UseValleyEmphasis = m_Controls.m_ValleyCheckbox->isChecked();
-      m_NumberOfBins = m_Controls.m_BinsSpinBox->value();
-
-      this->setCursor(Qt::WaitCursor);
-      m_OtsuTool3DTool->RunSegmentation(m_NumberOfRegions, m_UseValleyEmphasis, m_NumberOfBins);
-      this->setCursor(Qt::ArrowCursor);
-    }
-    catch (...)
-    {
-      this->setCursor(Qt::ArrowCursor);
-      QMessageBox *messageBox =
-        new QMessageBox(QMessageBox::Critical,
-                        nullptr,
-                        "itkOtsuFilter error: image dimension must be in {2, 3} and no RGB images can be handled.");
-      messageBox->exec();
-      delete messageBox;
-      return;
+      proceed = messageBox->exec();
+      if (proceed != QMessageBox::Ok)
+        return;
     }
-    // insert regions into widget
-    QString itemName;
-    QListWidgetItem *item;
+
+    m_NumberOfRegions = m_Controls.m_Spinbox->value();
+    m_UseValleyEmphasis = m_Controls.m_ValleyCheckbox->isChecked();
+    m_NumberOfBins = m_Controls.m_BinsSpinBox->value();
+
+    // the regions of the previous result are outdated, the new ones are inserted in OnSegmentationFinished
     m_Controls.m_selectionListWidget->clear();
-    for (int i = 0; i < m_Controls.m_Spinbox->value(); ++i)
-    {
-      itemName = QString::number(i);
-      item = new QListWidgetItem(itemName);
-      m_Controls.m_selectionListWidget->addItem(item);
-    }
-    // deactivate 'confirm segmentation'-button
     m_Controls.m_ConfSegButton->setEnabled(false);
+
+    // runs in the background, errors are reported via OnToolErrorMessage
+    m_OtsuTool3DTool->RunSegmentation(m_NumberOfRegions, m_UseValleyEmphasis, m_NumberOfBins);
+  }
+}
+
+void QmitkOtsuTool3DGUI::OnSegmentationFinished(int numberOfRegions)
+{
+  // insert regions into widget
+  QString itemName;
+  QListWidgetItem *item;
+  m_Controls.m_selectionListWidget->clear();
+  for (int i = 0; i < numberOfRegions; ++i)
+  {
+    itemName = QString::number(i);
+    item = new QListWidgetItem(itemName);
+    m_Controls.m_selectionListWidget->addItem(item);
+  }
+  // deactivate 'confirm segmentation'-button
+  m_Controls.m_ConfSegButton->setEnabled(false);
+}
+
+void QmitkOtsuTool3DGUI::OnToolErrorMessage(std::string message)
+{
+  // allow to rerun the segmentation with the same parameters
+  m_NumberOfRegions = 0;
+
+  QMessageBox::critical(nullptr, "Otsu segmentation", QString::fromStdString(message));
+}
+
+void QmitkOtsuTool3DGUI::BusyStateChanged(bool busy)
+{
+  if (busy)
+  {
+    QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
+  }
+  else
+  {
+    QApplication::restoreOverrideCursor();
   }
+
+  // confirming is only possible once the preview of the selected regions is available
+  m_Controls.m_ConfSegButton->setEnabled(!busy && !m_Controls.m_selectionListWidget->selectedItems().isEmpty());
 }
 
 void QmitkOtsuTool3DGUI::OnVolumePreviewChecked(int state)
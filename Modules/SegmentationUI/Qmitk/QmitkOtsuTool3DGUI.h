@@ -70,6 +70,15 @@ protected:
   QmitkOtsuTool3DGUI();
   ~QmitkOtsuTool3DGUI() override;
 
+  /** \brief Inserts the regions of the new multi label result into the selection list */
+  void OnSegmentationFinished(int numberOfRegions);
+
+  /** \brief Shows errors of the background computations */
+  void OnToolErrorMessage(std::string message);
+
+  /** \brief Shows whether the tool computes in the background and keeps confirming disabled meanwhile */
+  void BusyStateChanged(bool busy);
+
   mitk::OtsuTool3D::Pointer m_OtsuTool3DTool;
 
   Ui_QmitkOtsuToolWidgetControls m_Controls;
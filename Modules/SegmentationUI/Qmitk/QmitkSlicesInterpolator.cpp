@@ -1263,6 +1263,9 @@ void QmitkSlicesInterpolator::SetCurrentContourListID()
         m_SurfaceInterpolator->SetMaxSpacing(maxSpacing);
         m_SurfaceInterpolator->SetMinSpacing(minSpacing);
         m_SurfaceInterpolator->SetDistanceImageVolume(50000);
+        // Interpolate with the partition of unity even for few contour points. Its local solutions and the
+        // distances of unchanged regions are reused, so editing a contour only recomputes its neighbourhood.
+        m_SurfaceInterpolator->SetMaximumNumberOfCentersForDirectSolution(0);
 
         mitk::Image *segmentationImage = dynamic_cast<mitk::Image *>(workingNode->GetData());
         /*if (segmentationImage->GetDimension() == 3)
@@ -17,7 +17,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "QmitkWatershedToolGUI.h"
 
 #include "QmitkNewSegmentationDialog.h"
-#include "mitkProgressBar.h"
 
 #include <qapplication.h>
 #include <qlabel.h>
@@ -92,8 +91,8 @@ QmitkWatershedToolGUI::~QmitkWatershedToolGUI()
 {
   if (m_WatershedTool.IsNotNull())
   {
-    // m_WatershedTool->SizeChanged -= mitk::MessageDelegate1<QmitkWatershedToolGUI, int>( this,
-    // &QmitkWatershedToolGUI::OnSizeChanged );
+    m_WatershedTool->CurrentlyBusy -=
+      mitk::MessageDelegate1<QmitkWatershedToolGUI, bool>(this, &QmitkWatershedToolGUI::BusyStateChanged);
   }
 }
 
@@ -101,8 +100,8 @@ void QmitkWatershedToolGUI::OnNewToolAssociated(mitk::Tool *tool)
 {
   if (m_WatershedTool.IsNotNull())
   {
-    // m_WatershedTool->SizeChanged -= mitk::MessageDelegate1<QmitkWatershedToolGUI, int>( this,
-    // &QmitkWatershedToolGUI::OnSizeChanged );
+    m_WatershedTool->CurrentlyBusy -=
+      mitk::MessageDelegate1<QmitkWatershedToolGUI, bool>(this, &QmitkWatershedToolGUI::BusyStateChanged);
   }
 
   m_WatershedTool = dynamic_cast<mitk::WatershedTool *>(tool);
@@ -111,8 +110,8 @@ void QmitkWatershedToolGUI::OnNewToolAssociated(mitk::Tool *tool)
 
   if (m_WatershedTool.IsNotNull())
   {
-    //    m_WatershedTool->SizeChanged += mitk::MessageDelegate1<QmitkWatershedToolGUI, int>( this,
-    //    &QmitkWatershedToolGUI::OnSizeChanged );
+    m_WatershedTool->CurrentlyBusy +=
+      mitk::MessageDelegate1<QmitkWatershedToolGUI, bool>(this, &QmitkWatershedToolGUI::BusyStateChanged);
   }
 }
 
@@ -138,17 +137,23 @@ void QmitkWatershedToolGUI::OnSliderValueLevelChanged(int value)
 
 void QmitkWatershedToolGUI::OnCreateSegmentation()
 {
-  QApplication::setOverrideCursor(Qt::BusyCursor);
-  m_InformationLabel->setText(QString("Please wait some time for computation..."));
-  m_InformationLabel->repaint();
-  QApplication::processEvents();
-
-  m_WatershedTool->DoIt();
-  m_InformationLabel->setText(QString(""));
-  QApplication::setOverrideCursor(Qt::ArrowCursor);
+  if (m_WatershedTool.IsNotNull())
+  {
+    // runs in the background, a second click restarts the computation with the current parameters
+    m_WatershedTool->DoIt();
+  }
+}
 
-  for (int i = 0; i < 60; ++i)
+void QmitkWatershedToolGUI::BusyStateChanged(bool busy)
+{
+  if (busy)
+  {
+    m_InformationLabel->setText(QString("Please wait some time for computation..."));
+    QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
+  }
+  else
   {
-    mitk::ProgressBar::GetInstance()->Progress();
+    m_InformationLabel->setText(QString(""));
+    QApplication::restoreOverrideCursor();
   }
 }
@@ -57,6 +57,9 @@ protected:
   QmitkWatershedToolGUI();
   ~QmitkWatershedToolGUI() override;
 
+  /** \brief Shows whether the tool computes the segmentation in the background */
+  void BusyStateChanged(bool busy);
+
   QSlider *m_SliderThreshold;
   QSlider *m_SliderLevel;
 
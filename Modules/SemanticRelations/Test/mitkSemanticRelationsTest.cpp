@@ -31,6 +31,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 #include <mitkPropertyNameHelper.h>
+#include <mitkVectorProperty.h>
 
 // mitk persistence
 #include <mitkPersistenceService.h>
@@ -42,6 +43,7 @@ class mitkSemanticRelationsTestSuite : public mitk::TestFixture
   MITK_TEST(InferenceTest);
   MITK_TEST(DataStorageAccessTest);
   MITK_TEST(RemoveAndUnlinkTest);
+  MITK_TEST(RelationStorageTest);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -99,6 +101,13 @@ public:
     MITK_INFO << "=== RemoveAndUnlinkTest end ===";
   }
 
+  void RelationStorageTest()
+  {
+    MITK_INFO << "=== RelationStorageTest start ===";
+    ModifiedPropertyList();
+    MITK_INFO << "=== RelationStorageTest end ===";
+  }
+
   //////////////////////////////////////////////////////////////////////////
   // SPECIFIC TESTS
   //////////////////////////////////////////////////////////////////////////
@@ -595,6 +604,59 @@ public:
       mitk::SemanticRelationException);
   }
 
+  // RelationStorageTest
+  void ModifiedPropertyList()
+  {
+    MITK_INFO << "=== ModifiedPropertyList";
+
+    // load data
+    mitk::SemanticRelationsIntegration semanticRelationsIntegration;
+
+    auto PETImage = mitk::SemanticRelationsTestHelper::GetPatientTwoPETImage();
+    CPPUNIT_ASSERT_MESSAGE("Not a valid image data node", PETImage.IsNotNull());
+    semanticRelationsIntegration.AddImage(PETImage);
+
+    auto PETSegmentation = mitk::SemanticRelationsTestHelper::GetPatientTwoSegmentation();
+    CPPUNIT_ASSERT_MESSAGE("Not a valid segmentation data node", PETSegmentation.IsNotNull());
+    semanticRelationsIntegration.AddSegmentation(PETSegmentation, PETImage);
+
+    auto lesion = mitk::GenerateNewLesion();
+    semanticRelationsIntegration.AddLesionAndLinkSegmentation(PETSegmentation, lesion);
+
+    // start test
+    auto caseID = mitk::GetCaseIDFromDataNode(PETImage);
+    auto imageID = mitk::GetIDFromDataNode(PETImage);
+    auto segmentationID = mitk::GetIDFromDataNode(PETSegmentation);
+
+    auto allSegmentationIDsOfImage = mitk::RelationStorage::GetAllSegmentationIDsOfImage(caseID, imageID);
+    CPPUNIT_ASSERT_MESSAGE("One segmentation should be stored for the image",
+      allSegmentationIDsOfImage.size() == 1 && allSegmentationIDsOfImage.front() == segmentationID);
+
+    auto allSegmentationIDsOfLesion = mitk::RelationStorage::GetAllSegmentationIDsOfLesion(caseID, lesion);
+    CPPUNIT_ASSERT_MESSAGE("One segmentation should be stored for the lesion", allSegmentationIDsOfLesion.size() == 1);
+
+    semanticRelationsIntegration.UnlinkSegmentationFromLesion(PETSegmentation);
+    allSegmentationIDsOfLesion = mitk::RelationStorage::GetAllSegmentationIDsOfLesion(caseID, lesion);
+    CPPUNIT_ASSERT_MESSAGE("No segmentation should be stored for the lesion", allSegmentationIDsOfLesion.empty());
+
+    // modify the storage data without using the relation storage
+    PERSISTENCE_GET_SERVICE_MACRO
+    CPPUNIT_ASSERT_MESSAGE("Persistence service could not be loaded", nullptr != persistenceService);
+    mitk::PropertyList::Pointer propertyList = persistenceService->GetPropertyList(caseID);
+    propertyList->SetProperty("segmentations", mitk::VectorProperty<std::string>::New());
+
+    auto allSegmentationIDsOfCase = mitk::RelationStorage::GetAllSegmentationIDsOfCase(caseID);
+    CPPUNIT_ASSERT_MESSAGE("No segmentation should be stored after modifying the property list", allSegmentationIDsOfCase.empty());
+    allSegmentationIDsOfImage = mitk::RelationStorage::GetAllSegmentationIDsOfImage(caseID, imageID);
+    CPPUNIT_ASSERT_MESSAGE("No segmentation should be stored for the image after modifying the property list", allSegmentationIDsOfImage.empty());
+
+    persistenceService->RemovePropertyList(caseID);
+    auto allLesions = mitk::RelationStorage::GetAllLesionsOfCase(caseID);
+    CPPUNIT_ASSERT_MESSAGE("No lesion should be stored after removing the property list", allLesions.empty());
+    auto allImageIDs = mitk::RelationStorage::GetAllImageIDsOfCase(caseID);
+    CPPUNIT_ASSERT_MESSAGE("No image should be stored after removing the property list", allImageIDs.empty());
+  }
+
   // RemoveAndUnlinkTest
   void CPRemoveAndUnlink()
   {
@@ -29,6 +29,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 // c++
 #include <algorithm>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace
 {
@@ -59,16 +61,59 @@ namespace
     return caseIDsVectorProperty->GetValue();
   }
 
+  /**
+  * @brief The case IDs of the "caseIDs" vector property as a set. AddCase inserts new case IDs directly.
+  *        The set is rebuilt if the vector property was replaced, e.g. because the persistence service
+  *        loaded its property lists again.
+  */
+  struct CaseIDCache
+  {
+    mitk::BaseProperty::Pointer caseIDsVectorProperty;
+    std::unordered_set<mitk::SemanticTypes::CaseID> caseIDs;
+  };
+
+  CaseIDCache& GetCaseIDCache()
+  {
+    static CaseIDCache caseIDCache;
+    return caseIDCache;
+  }
+
+  bool CaseIDExists(mitk::IPersistenceService* persistenceService, const mitk::SemanticTypes::CaseID& caseID)
+  {
+    std::string listIdentifier = "caseIDs";
+    mitk::PropertyList::Pointer propertyList = persistenceService->GetPropertyList(listIdentifier);
+    if (nullptr == propertyList)
+    {
+      return false;
+    }
+
+    mitk::VectorProperty<std::string>* caseIDsVectorProperty = dynamic_cast<mitk::VectorProperty<std::string>*>(propertyList->GetProperty(listIdentifier));
+    if (nullptr == caseIDsVectorProperty)
+    {
+      return false;
+    }
+
+    CaseIDCache& caseIDCache = GetCaseIDCache();
+    if (caseIDCache.caseIDsVectorProperty != caseIDsVectorProperty)
+    {
+      const auto& caseIDs = caseIDsVectorProperty->GetValue();
+      caseIDCache.caseIDsVectorProperty = caseIDsVectorProperty;
+      caseIDCache.caseIDs = std::unordered_set<mitk::SemanticTypes::CaseID>(caseIDs.begin(), caseIDs.end());
+    }
+
+    return caseIDCache.caseIDs.count(caseID) > 0;
+  }
+
   bool CaseIDExists(const mitk::SemanticTypes::CaseID& caseID)
   {
-    auto allCaseIDs = GetCaseIDs();
-    auto existingCase = std::find(allCaseIDs.begin(), allCaseIDs.end(), caseID);
-    if (existingCase == allCaseIDs.end())
+    PERSISTENCE_GET_SERVICE_MACRO
+    if (nullptr == persistenceService)
     {
+      MITK_DEBUG << "Persistence service could not be loaded";
       return false;
     }
 
-    return true;
+    return CaseIDExists(persistenceService, caseID);
   }
 
   mitk::PropertyList::Pointer GetStorageData(const mitk::SemanticTypes::CaseID& caseID)
@@ -84,7 +129,7 @@ namespace
     // The persistence service may create a new property list with the given ID, if no property list is found.
     // Since we don't want to return a new property list but rather inform the user that the given case
     // is not a valid, stored case, we will return nullptr in that case.
-    if (CaseIDExists(caseID))
+    if (CaseIDExists(persistenceService, caseID))
     {
       // the property list is valid for a whole case and contains all the properties for the current case
       return persistenceService->GetPropertyList(const_cast<mitk::SemanticTypes::CaseID&>(caseID));
@@ -93,15 +138,8 @@ namespace
     return nullptr;
   }
 
-  mitk::SemanticTypes::Lesion GenerateLesion(const mitk::SemanticTypes::CaseID& caseID, const mitk::SemanticTypes::ID& lesionID)
+  mitk::SemanticTypes::Lesion GenerateLesion(const mitk::PropertyList* propertyList, const mitk::SemanticTypes::ID& lesionID)
   {
-    mitk::PropertyList::Pointer propertyList = GetStorageData(caseID);
-    if (nullptr == propertyList)
-    {
-      MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
-      return mitk::SemanticTypes::Lesion();
-    }
-
     mitk::VectorProperty<std::string>* lesionDataProperty = dynamic_cast<mitk::VectorProperty<std::string>*>(propertyList->GetProperty(lesionID));
     if (nullptr == lesionDataProperty)
     {
@@ -138,15 +176,8 @@ namespace
     return mitk::SemanticTypes::Lesion();
   }
 
-  mitk::SemanticTypes::ControlPoint GenerateControlpoint(const mitk::SemanticTypes::CaseID& caseID, const mitk::SemanticTypes::ID& controlPointUID)
+  mitk::SemanticTypes::ControlPoint GenerateControlpoint(const mitk::PropertyList* propertyList, const mitk::SemanticTypes::ID& controlPointUID)
   {
-    mitk::PropertyList::Pointer propertyList = GetStorageData(caseID);
-    if (nullptr == propertyList)
-    {
-      MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
-      return mitk::SemanticTypes::ControlPoint();
-    }
-
     // retrieve a vector property that contains the integer values of the date of a control point (0. year 1. month 2. day)
     mitk::VectorProperty<int>* controlPointVectorProperty = dynamic_cast<mitk::VectorProperty<int>*>(propertyList->GetProperty(controlPointUID));
     if (nullptr == controlPointVectorProperty)
@@ -172,496 +203,655 @@ namespace
 
     return generatedControlPoint;
   }
-}
 
-mitk::SemanticTypes::LesionVector mitk::RelationStorage::GetAllLesionsOfCase(const SemanticTypes::CaseID& caseID)
-{
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  /**
+  * @brief The relations of a case, read from the property list of the case and indexed for the queries
+  *        of the relation storage. The modifications of the relation storage update the graph directly.
+  *        The graph is rebuilt when the property list was replaced or modified otherwise.
+  */
+  struct RelationGraph
+  {
+    RelationGraph() : propertyListMTime(0), valid(false) {}
+
+    mitk::PropertyList::Pointer propertyList;
+    itk::ModifiedTimeType propertyListMTime;
+    bool valid;
+
+    mitk::SemanticTypes::LesionVector lesions;
+    // contains the lesions of the case and the lesions referenced by segmentations
+    std::unordered_map<mitk::SemanticTypes::ID, mitk::SemanticTypes::Lesion> lesionsByUID;
+    mitk::SemanticTypes::ControlPointVector controlPoints;
+    // contains the control points of the case and the control points referenced by images
+    std::unordered_map<mitk::SemanticTypes::ID, mitk::SemanticTypes::ControlPoint> controlPointsByUID;
+    mitk::SemanticTypes::ExaminationPeriodVector examinationPeriods;
+    mitk::SemanticTypes::InformationTypeVector informationTypes;
+
+    mitk::SemanticTypes::IDVector imageIDs;
+    // image ID -> (information type, control point UID)
+    std::unordered_map<mitk::SemanticTypes::ID, std::pair<mitk::SemanticTypes::InformationType, mitk::SemanticTypes::ID>> imageData;
+    std::unordered_map<mitk::SemanticTypes::ID, mitk::SemanticTypes::IDVector> imageIDsOfControlPoint;
+    std::unordered_map<mitk::SemanticTypes::InformationType, mitk::SemanticTypes::IDVector> imageIDsOfInformationType;
+
+    mitk::SemanticTypes::IDVector segmentationIDs;
+    // segmentation ID -> (image ID, lesion UID)
+    std::unordered_map<mitk::SemanticTypes::ID, std::pair<mitk::SemanticTypes::ID, mitk::SemanticTypes::ID>> segmentationData;
+    std::unordered_map<mitk::SemanticTypes::ID, mitk::SemanticTypes::IDVector> segmentationIDsOfImage;
+    std::unordered_map<mitk::SemanticTypes::ID, mitk::SemanticTypes::IDVector> segmentationIDsOfLesion;
+  };
+
+  std::unordered_map<mitk::SemanticTypes::CaseID, RelationGraph>& GetRelationGraphs()
   {
-    MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
-    return SemanticTypes::LesionVector();
+    static std::unordered_map<mitk::SemanticTypes::CaseID, RelationGraph> relationGraphs;
+    return relationGraphs;
   }
-  // retrieve a vector property that contains the valid lesion-IDs for the current case
-  VectorProperty<std::string>* lesionsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("lesions"));
-  if (nullptr == lesionsVectorProperty)
+
+  std::vector<std::string> GetStringVector(const mitk::PropertyList* propertyList, const std::string& propertyKey)
   {
-    MITK_DEBUG << "Could not find any lesion in the storage.";
-    return SemanticTypes::LesionVector();
+    auto vectorProperty = dynamic_cast<mitk::VectorProperty<std::string>*>(propertyList->GetProperty(propertyKey));
+    if (nullptr == vectorProperty)
+    {
+      return std::vector<std::string>();
+    }
+
+    return vectorProperty->GetValue();
   }
 
-  std::vector<std::string> lesionsVectorPropertyValue = lesionsVectorProperty->GetValue();
-  SemanticTypes::LesionVector allLesionsOfCase;
-  for (const auto& lesionID : lesionsVectorPropertyValue)
+  bool GenerateExaminationPeriod(const mitk::PropertyList* propertyList, const mitk::SemanticTypes::ID& examinationPeriodID, mitk::SemanticTypes::ExaminationPeriod& generatedExaminationPeriod)
   {
-    SemanticTypes::Lesion generatedLesion = GenerateLesion(caseID, lesionID);
-    if (!generatedLesion.UID.empty())
+    // an examination period has an arbitrary number of vector values (name and control point UIDs) (at least one for the name)
+    std::vector<std::string> examinationPeriodData = GetStringVector(propertyList, examinationPeriodID);
+    if (examinationPeriodData.empty())
     {
-      allLesionsOfCase.push_back(generatedLesion);
+      MITK_DEBUG << "Incorrect examination period storage. At least one (1) value for the examination period name has to be stored.";
+      return false;
     }
+
+    generatedExaminationPeriod.UID = examinationPeriodID;
+    generatedExaminationPeriod.name = examinationPeriodData[0];
+    generatedExaminationPeriod.controlPointUIDs.assign(examinationPeriodData.begin() + 1, examinationPeriodData.end());
+    return true;
   }
 
-  return allLesionsOfCase;
-}
+  void BuildRelationGraph(mitk::PropertyList* propertyList, RelationGraph& graph)
+  {
+    graph = RelationGraph();
+    graph.propertyList = propertyList;
+    graph.propertyListMTime = propertyList->GetMTime();
+    graph.valid = true;
 
-mitk::SemanticTypes::Lesion mitk::RelationStorage::GetLesionOfSegmentation(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& segmentationID)
-{
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+    for (const auto& lesionID : GetStringVector(propertyList, "lesions"))
+    {
+      mitk::SemanticTypes::Lesion generatedLesion = GenerateLesion(propertyList, lesionID);
+      if (!generatedLesion.UID.empty())
+      {
+        graph.lesions.push_back(generatedLesion);
+        graph.lesionsByUID[lesionID] = generatedLesion;
+      }
+    }
+
+    for (const auto& controlPointUID : GetStringVector(propertyList, "controlpoints"))
+    {
+      mitk::SemanticTypes::ControlPoint generatedControlPoint = GenerateControlpoint(propertyList, controlPointUID);
+      if (!generatedControlPoint.UID.empty())
+      {
+        graph.controlPoints.push_back(generatedControlPoint);
+        graph.controlPointsByUID[controlPointUID] = generatedControlPoint;
+      }
+    }
+
+    for (const auto& examinationPeriodID : GetStringVector(propertyList, "examinationperiods"))
+    {
+      mitk::SemanticTypes::ExaminationPeriod generatedExaminationPeriod;
+      if (GenerateExaminationPeriod(propertyList, examinationPeriodID, generatedExaminationPeriod))
+      {
+        graph.examinationPeriods.push_back(generatedExaminationPeriod);
+      }
+    }
+
+    graph.informationTypes = GetStringVector(propertyList, "informationtypes");
+
+    graph.imageIDs = GetStringVector(propertyList, "images");
+    for (const auto& imageID : graph.imageIDs)
+    {
+      // an image has to have exactly two values (0. information type 1. control point ID)
+      std::vector<std::string> imageVectorValue = GetStringVector(propertyList, imageID);
+      if (imageVectorValue.size() != 2)
+      {
+        continue;
+      }
+
+      graph.imageData[imageID] = std::make_pair(imageVectorValue[0], imageVectorValue[1]);
+      graph.imageIDsOfInformationType[imageVectorValue[0]].push_back(imageID);
+      graph.imageIDsOfControlPoint[imageVectorValue[1]].push_back(imageID);
+      if (0 == graph.controlPointsByUID.count(imageVectorValue[1]))
+      {
+        mitk::SemanticTypes::ControlPoint generatedControlPoint = GenerateControlpoint(propertyList, imageVectorValue[1]);
+        if (!generatedControlPoint.UID.empty())
+        {
+          graph.controlPointsByUID[imageVectorValue[1]] = generatedControlPoint;
+        }
+      }
+    }
+
+    graph.segmentationIDs = GetStringVector(propertyList, "segmentations");
+    for (const auto& segmentationID : graph.segmentationIDs)
+    {
+      // a segmentation has to have exactly two values (0. image ID 1. lesion ID)
+      std::vector<std::string> segmentationVectorValue = GetStringVector(propertyList, segmentationID);
+      if (segmentationVectorValue.size() != 2)
+      {
+        continue;
+      }
+
+      graph.segmentationData[segmentationID] = std::make_pair(segmentationVectorValue[0], segmentationVectorValue[1]);
+      graph.segmentationIDsOfImage[segmentationVectorValue[0]].push_back(segmentationID);
+      graph.segmentationIDsOfLesion[segmentationVectorValue[1]].push_back(segmentationID);
+      if (!segmentationVectorValue[1].empty() && 0 == graph.lesionsByUID.count(segmentationVectorValue[1]))
+      {
+        mitk::SemanticTypes::Lesion generatedLesion = GenerateLesion(propertyList, segmentationVectorValue[1]);
+        if (!generatedLesion.UID.empty())
+        {
+          graph.lesionsByUID[segmentationVectorValue[1]] = generatedLesion;
+        }
+      }
+    }
+  }
+
+  /**
+  * @brief Return the relation graph of the given case, which is rebuilt if necessary.
+  *        Returns nullptr if the case is not stored.
+  */
+  const RelationGraph* GetRelationGraph(const mitk::SemanticTypes::CaseID& caseID)
   {
-    MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
-    return SemanticTypes::Lesion();
+    mitk::PropertyList::Pointer propertyList = GetStorageData(caseID);
+    if (nullptr == propertyList)
+    {
+      GetRelationGraphs().erase(caseID);
+      return nullptr;
+    }
+
+    RelationGraph& graph = GetRelationGraphs()[caseID];
+    if (!graph.valid || graph.propertyList != propertyList || graph.propertyListMTime != propertyList->GetMTime())
+    {
+      BuildRelationGraph(propertyList, graph);
+    }
+
+    return &graph;
   }
 
-  // retrieve a vector property that contains the referenced ID of a segmentation (0. image ID 1. lesion ID)
-  VectorProperty<std::string>* segmentationVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(segmentationID));
-  if (nullptr == segmentationVectorProperty)
+  /**
+  * @brief Has to be called by every function that modifies the storage data of a case, before the property list
+  *        is modified. Returns the relation graph of the case if it matches the property list, so that the
+  *        modification can be applied to it, or nullptr if the graph has to be built at the next query anyway.
+  *        The graph stays invalid until FinishRelationGraphUpdate is called, so that it is rebuilt if the
+  *        modification is aborted halfway.
+  *        Modifications of the vector properties do not modify the property list itself.
+  */
+  RelationGraph* StartRelationGraphUpdate(const mitk::SemanticTypes::CaseID& caseID, const mitk::PropertyList* propertyList)
   {
-    MITK_DEBUG << "Could not find the segmentation " << segmentationID << " in the storage.";
-    return SemanticTypes::Lesion();
+    auto graph = GetRelationGraphs().find(caseID);
+    if (graph == GetRelationGraphs().end())
+    {
+      return nullptr;
+    }
+
+    bool upToDate = graph->second.valid
+      && graph->second.propertyList == propertyList
+      && graph->second.propertyListMTime == propertyList->GetMTime();
+    graph->second.valid = false;
+
+    return upToDate ? &graph->second : nullptr;
   }
 
-  std::vector<std::string> segmentationVectorPropertyValue = segmentationVectorProperty->GetValue();
-  // the lesion ID of a segmentation is the second value in the vector
-  if (segmentationVectorPropertyValue.size() != 2)
+  /**
+  * @brief Marks the updated graph as valid for the current state of its property list.
+  */
+  void FinishRelationGraphUpdate(RelationGraph* graph)
   {
-    MITK_DEBUG << "Incorrect segmentation storage. Not two (2) IDs stored.";
-    return SemanticTypes::Lesion();
+    if (nullptr == graph)
+    {
+      return;
+    }
+
+    graph->propertyListMTime = graph->propertyList->GetMTime();
+    graph->valid = true;
   }
 
-  std::string lesionID = segmentationVectorPropertyValue[1];
-  if (lesionID.empty())
+  void RemoveID(mitk::SemanticTypes::IDVector& ids, const mitk::SemanticTypes::ID& id)
   {
-    // segmentation does not refer to any lesion; return empty lesion
-    return SemanticTypes::Lesion();
+    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
   }
 
-  return GenerateLesion(caseID, lesionID);
-}
+  /**
+  * @brief Collects the IDs that refer to the given value again, in the order of all IDs (as BuildRelationGraph does).
+  *        The value is the first or the second referenced ID of the data map.
+  */
+  template <typename DataMap>
+  void UpdateIndex(const mitk::SemanticTypes::IDVector& allIDs,
+                   const DataMap& data,
+                   bool firstValue,
+                   const mitk::SemanticTypes::ID& value,
+                   std::unordered_map<mitk::SemanticTypes::ID, mitk::SemanticTypes::IDVector>& index)
+  {
+    mitk::SemanticTypes::IDVector ids;
+    for (const auto& id : allIDs)
+    {
+      auto entry = data.find(id);
+      if (entry != data.end() && (firstValue ? entry->second.first : entry->second.second) == value)
+      {
+        ids.push_back(id);
+      }
+    }
 
-mitk::SemanticTypes::ControlPointVector mitk::RelationStorage::GetAllControlPointsOfCase(const SemanticTypes::CaseID& caseID)
-{
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+    if (ids.empty())
+    {
+      index.erase(value);
+    }
+    else
+    {
+      index[value] = ids;
+    }
+  }
+
+  /**
+  * @brief Reads the stored data of the image again and updates the image indices.
+  *        The image IDs of the graph have to be updated before.
+  */
+  void UpdateImage(const mitk::PropertyList* propertyList, RelationGraph& graph, const mitk::SemanticTypes::ID& imageID)
   {
-    MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
-    return SemanticTypes::ControlPointVector();
+    std::vector<mitk::SemanticTypes::InformationType> informationTypes;
+    mitk::SemanticTypes::IDVector controlPointUIDs;
+    auto imageData = graph.imageData.find(imageID);
+    if (imageData != graph.imageData.end())
+    {
+      informationTypes.push_back(imageData->second.first);
+      controlPointUIDs.push_back(imageData->second.second);
+      graph.imageData.erase(imageData);
+    }
+
+    // an image has to have exactly two values (0. information type 1. control point ID)
+    std::vector<std::string> imageVectorValue = GetStringVector(propertyList, imageID);
+    bool isImageOfCase = std::find(graph.imageIDs.begin(), graph.imageIDs.end(), imageID) != graph.imageIDs.end();
+    if (isImageOfCase && imageVectorValue.size() == 2)
+    {
+      graph.imageData[imageID] = std::make_pair(imageVectorValue[0], imageVectorValue[1]);
+      informationTypes.push_back(imageVectorValue[0]);
+      controlPointUIDs.push_back(imageVectorValue[1]);
+      if (0 == graph.controlPointsByUID.count(imageVectorValue[1]))
+      {
+        mitk::SemanticTypes::ControlPoint generatedControlPoint = GenerateControlpoint(propertyList, imageVectorValue[1]);
+        if (!generatedControlPoint.UID.empty())
+        {
+          graph.controlPointsByUID[imageVectorValue[1]] = generatedControlPoint;
+        }
+      }
+    }
+
+    for (const auto& informationType : informationTypes)
+    {
+      UpdateIndex(graph.imageIDs, graph.imageData, true, informationType, graph.imageIDsOfInformationType);
+    }
+    for (const auto& controlPointUID : controlPointUIDs)
+    {
+      UpdateIndex(graph.imageIDs, graph.imageData, false, controlPointUID, graph.imageIDsOfControlPoint);
+    }
   }
 
-  // retrieve a vector property that contains the valid control point-IDs for the current case
-  VectorProperty<std::string>* controlPointsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("controlpoints"));
-  if (nullptr == controlPointsVectorProperty)
+  /**
+  * @brief Reads the stored data of the lesion again, e.g. after it was added or overwritten.
+  */
+  void UpdateLesion(const mitk::PropertyList* propertyList, RelationGraph& graph, const mitk::SemanticTypes::ID& lesionID)
   {
-    MITK_DEBUG << "Could not find any control points in the storage.";
-    return SemanticTypes::ControlPointVector();
+    mitk::SemanticTypes::Lesion generatedLesion = GenerateLesion(propertyList, lesionID);
+    bool isLesionOfCase = false;
+    for (auto lesion = graph.lesions.begin(); lesion != graph.lesions.end();)
+    {
+      if (lesion->UID != lesionID)
+      {
+        ++lesion;
+      }
+      else if (generatedLesion.UID.empty())
+      {
+        lesion = graph.lesions.erase(lesion);
+      }
+      else
+      {
+        *lesion = generatedLesion;
+        isLesionOfCase = true;
+        ++lesion;
+      }
+    }
+
+    // lesions that are not part of the case are only stored if they are referenced by a segmentation
+    bool isReferenced = graph.segmentationIDsOfLesion.count(lesionID) > 0;
+    if (generatedLesion.UID.empty() || (!isLesionOfCase && !isReferenced))
+    {
+      graph.lesionsByUID.erase(lesionID);
+    }
+    else
+    {
+      graph.lesionsByUID[lesionID] = generatedLesion;
+    }
   }
 
-  std::vector<std::string> controlPointsVectorPropertyValue = controlPointsVectorProperty->GetValue();
-  SemanticTypes::ControlPointVector allControlPointsOfCase;
-  for (const auto& controlPointUID : controlPointsVectorPropertyValue)
+  /**
+  * @brief Reads the stored data of the segmentation again and updates the segmentation indices.
+  *        The segmentation IDs of the graph have to be updated before.
+  */
+  void UpdateSegmentation(const mitk::PropertyList* propertyList, RelationGraph& graph, const mitk::SemanticTypes::ID& segmentationID)
   {
-    SemanticTypes::ControlPoint generatedControlPoint = GenerateControlpoint(caseID, controlPointUID);
-    if (!generatedControlPoint.UID.empty())
+    mitk::SemanticTypes::IDVector imageIDs;
+    mitk::SemanticTypes::IDVector lesionIDs;
+    auto segmentationData = graph.segmentationData.find(segmentationID);
+    if (segmentationData != graph.segmentationData.end())
+    {
+      imageIDs.push_back(segmentationData->second.first);
+      lesionIDs.push_back(segmentationData->second.second);
+      graph.segmentationData.erase(segmentationData);
+    }
+
+    // a segmentation has to have exactly two values (0. image ID 1. lesion ID)
+    std::vector<std::string> segmentationVectorValue = GetStringVector(propertyList, segmentationID);
+    bool isSegmentationOfCase = std::find(graph.segmentationIDs.begin(), graph.segmentationIDs.end(), segmentationID) != graph.segmentationIDs.end();
+    if (isSegmentationOfCase && segmentationVectorValue.size() == 2)
+    {
+      graph.segmentationData[segmentationID] = std::make_pair(segmentationVectorValue[0], segmentationVectorValue[1]);
+      imageIDs.push_back(segmentationVectorValue[0]);
+      lesionIDs.push_back(segmentationVectorValue[1]);
+    }
+
+    for (const auto& imageID : imageIDs)
+    {
+      UpdateIndex(graph.segmentationIDs, graph.segmentationData, true, imageID, graph.segmentationIDsOfImage);
+    }
+    for (const auto& lesionID : lesionIDs)
     {
-      allControlPointsOfCase.push_back(generatedControlPoint);
+      UpdateIndex(graph.segmentationIDs, graph.segmentationData, false, lesionID, graph.segmentationIDsOfLesion);
+      if (!lesionID.empty())
+      {
+        // a lesion that is not part of the case is only stored while a segmentation refers to it
+        UpdateLesion(propertyList, graph, lesionID);
+      }
+    }
+  }
+
+  /**
+  * @brief Reads the stored data of all lesions of the lesion class again, e.g. after the class type was
+  *        overwritten or the lesion class was removed.
+  */
+  void UpdateLesionsOfClass(const mitk::PropertyList* propertyList, RelationGraph& graph, const mitk::SemanticTypes::ID& lesionClassID)
+  {
+    mitk::SemanticTypes::IDVector lesionIDs;
+    for (const auto& lesion : graph.lesionsByUID)
+    {
+      if (lesion.second.lesionClass.UID == lesionClassID)
+      {
+        lesionIDs.push_back(lesion.first);
+      }
+    }
+
+    for (const auto& lesionID : lesionIDs)
+    {
+      UpdateLesion(propertyList, graph, lesionID);
     }
   }
 
-  return allControlPointsOfCase;
+  /**
+  * @brief Reads the stored data of the examination period again. Examination periods that are not
+  *        part of the graph are ignored.
+  */
+  void UpdateExaminationPeriod(const mitk::PropertyList* propertyList, RelationGraph& graph, const mitk::SemanticTypes::ID& examinationPeriodID)
+  {
+    for (auto examinationPeriod = graph.examinationPeriods.begin(); examinationPeriod != graph.examinationPeriods.end();)
+    {
+      if (examinationPeriod->UID == examinationPeriodID && !GenerateExaminationPeriod(propertyList, examinationPeriodID, *examinationPeriod))
+      {
+        examinationPeriod = graph.examinationPeriods.erase(examinationPeriod);
+      }
+      else
+      {
+        ++examinationPeriod;
+      }
+    }
+  }
 }
 
-mitk::SemanticTypes::ControlPoint mitk::RelationStorage::GetControlPointOfImage(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID)
+mitk::SemanticTypes::LesionVector mitk::RelationStorage::GetAllLesionsOfCase(const SemanticTypes::CaseID& caseID)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
-    return SemanticTypes::ControlPoint();
+    return SemanticTypes::LesionVector();
   }
-  // retrieve a vector property that contains the information type and the referenced ID of a control point (0. information type 1. control point ID)
-  VectorProperty<std::string>* imageVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(imageID));
-  if (nullptr == imageVectorProperty)
+
+  return graph->lesions;
+}
+
+mitk::SemanticTypes::Lesion mitk::RelationStorage::GetLesionOfSegmentation(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& segmentationID)
+{
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
-    MITK_DEBUG << "Could not find the image " << imageID << " in the storage.";
-    return SemanticTypes::ControlPoint();
+    MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
+    return SemanticTypes::Lesion();
   }
 
-  std::vector<std::string> imageVectorPropertyValue = imageVectorProperty->GetValue();
-  SemanticTypes::ControlPoint controlPoint;
-  // an image has to have exactly two values (the information type and the ID of the control point)
-  if (imageVectorPropertyValue.size() != 2)
+  auto segmentationData = graph->segmentationData.find(segmentationID);
+  if (segmentationData == graph->segmentationData.end())
   {
-    MITK_DEBUG << "Incorrect data storage. Not two (2) values stored.";
-    return SemanticTypes::ControlPoint();
+    MITK_DEBUG << "Could not find the segmentation " << segmentationID << " in the storage.";
+    return SemanticTypes::Lesion();
   }
 
-  // the second value of the image vector is the ID of the referenced control point
-  std::string controlPointID = imageVectorPropertyValue[1];
-  // retrieve a vector property that contains the integer values of the date of a control point (0. year 1. month 2. day)
-  VectorProperty<int>* controlPointVectorProperty = dynamic_cast<VectorProperty<int>*>(propertyList->GetProperty(controlPointID));
-  if (nullptr == controlPointVectorProperty)
+  // the lesion ID of a segmentation is the second value
+  auto lesion = graph->lesionsByUID.find(segmentationData->second.second);
+  if (lesion == graph->lesionsByUID.end())
   {
-    MITK_DEBUG << "Could not find the control point " << controlPointID << " in the storage.";
-    return SemanticTypes::ControlPoint();
+    // segmentation does not refer to any (valid) lesion; return empty lesion
+    return SemanticTypes::Lesion();
   }
 
-  std::vector<int> controlPointVectorPropertyValue = controlPointVectorProperty->GetValue();
-  // a control point has to have exactly three integer values (year, month and day)
-  if (controlPointVectorPropertyValue.size() != 3)
+  return lesion->second;
+}
+
+mitk::SemanticTypes::ControlPointVector mitk::RelationStorage::GetAllControlPointsOfCase(const SemanticTypes::CaseID& caseID)
+{
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
-    MITK_DEBUG << "Incorrect control point storage. Not three (3) values of the date are stored.";
-    return SemanticTypes::ControlPoint();
+    MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
+    return SemanticTypes::ControlPointVector();
   }
 
-  // set the values of the control point
-  controlPoint.UID = controlPointID;
-  controlPoint.date = boost::gregorian::date(controlPointVectorPropertyValue[0],
-                                             controlPointVectorPropertyValue[1],
-                                             controlPointVectorPropertyValue[2]);
-
-  return controlPoint;
+  return graph->controlPoints;
 }
 
-mitk::SemanticTypes::ExaminationPeriodVector mitk::RelationStorage::GetAllExaminationPeriodsOfCase(const SemanticTypes::CaseID& caseID)
+mitk::SemanticTypes::ControlPoint mitk::RelationStorage::GetControlPointOfImage(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
-    return SemanticTypes::ExaminationPeriodVector();
+    return SemanticTypes::ControlPoint();
   }
 
-  // retrieve a vector property that contains the valid examination period UIDs for the current case
-  VectorProperty<std::string>::Pointer examinationPeriodsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("examinationperiods"));
-  if (nullptr == examinationPeriodsVectorProperty)
+  auto imageData = graph->imageData.find(imageID);
+  if (imageData == graph->imageData.end())
   {
-    MITK_DEBUG << "Could not find any examination periods in the storage.";
-    return SemanticTypes::ExaminationPeriodVector();
+    MITK_DEBUG << "Could not find the image " << imageID << " in the storage.";
+    return SemanticTypes::ControlPoint();
   }
 
-  std::vector<std::string> examinationPeriodsVectorPropertyValue = examinationPeriodsVectorProperty->GetValue();
-  SemanticTypes::ExaminationPeriodVector allExaminationPeriods;
-  for (const auto& examinationPeriodID : examinationPeriodsVectorPropertyValue)
+  // the second value of the image data is the ID of the referenced control point
+  auto controlPoint = graph->controlPointsByUID.find(imageData->second.second);
+  if (controlPoint == graph->controlPointsByUID.end())
   {
-    // retrieve a vector property that contains the represented control point-IDs
-    VectorProperty<std::string>::Pointer examinationPeriodVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(examinationPeriodID));
-    if (nullptr == examinationPeriodVectorProperty)
-    {
-      MITK_DEBUG << "Could not find the examination period " << examinationPeriodID << " in the storage.";
-      continue;
-    }
+    MITK_DEBUG << "Could not find the control point " << imageData->second.second << " in the storage.";
+    return SemanticTypes::ControlPoint();
+  }
 
-    std::vector<std::string> examinationPeriodVectorPropertyValue = examinationPeriodVectorProperty->GetValue();
-    // an examination period has an arbitrary number of vector values (name and control point UIDs) (at least one for the name)
-    if (examinationPeriodVectorPropertyValue.empty())
-    {
-      MITK_DEBUG << "Incorrect examination period storage. At least one (1) value for the examination period name has to be stored.";
-      continue;
-    }
-    else
-    {
-      // set the values of the name and the control points
-      SemanticTypes::ExaminationPeriod generatedExaminationPeriod;
-      generatedExaminationPeriod.UID = examinationPeriodID;
-      generatedExaminationPeriod.name = examinationPeriodVectorPropertyValue[0];
-      for (size_t i = 1; i < examinationPeriodVectorPropertyValue.size(); ++i)
-      {
-        generatedExaminationPeriod.controlPointUIDs.push_back(examinationPeriodVectorPropertyValue[i]);
-      }
+  return controlPoint->second;
+}
 
-      allExaminationPeriods.push_back(generatedExaminationPeriod);
-    }
+mitk::SemanticTypes::ExaminationPeriodVector mitk::RelationStorage::GetAllExaminationPeriodsOfCase(const SemanticTypes::CaseID& caseID)
+{
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
+  {
+    MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
+    return SemanticTypes::ExaminationPeriodVector();
   }
-  return allExaminationPeriods;
+
+  return graph->examinationPeriods;
 }
 
 mitk::SemanticTypes::InformationTypeVector mitk::RelationStorage::GetAllInformationTypesOfCase(const SemanticTypes::CaseID& caseID)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::InformationTypeVector();
   }
-  // retrieve a vector property that contains the valid information types of the current case
-  VectorProperty<std::string>* informationTypesVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("informationtypes"));
-  if (nullptr == informationTypesVectorProperty)
-  {
-    MITK_DEBUG << "Could not find any information types in the storage.";
-    return SemanticTypes::InformationTypeVector();
-  }
 
-  return informationTypesVectorProperty->GetValue();
+  return graph->informationTypes;
 }
 
 mitk::SemanticTypes::InformationType mitk::RelationStorage::GetInformationTypeOfImage(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::InformationType();
   }
-  // retrieve a vector property that contains the information type and the referenced ID of an image (0. information type 1. control point ID)
-  VectorProperty<std::string>* imageVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(imageID));
-  if (nullptr == imageVectorProperty)
-  {
-    MITK_DEBUG << "Could not find the image " << imageID << " in the storage.";
-    return SemanticTypes::InformationType();
-  }
 
-  std::vector<std::string> imageVectorPropertyValue = imageVectorProperty->GetValue();
-  // an image has to have exactly two values (the information type and the ID of the control point)
-  if (imageVectorPropertyValue.size() != 2)
+  auto imageData = graph->imageData.find(imageID);
+  if (imageData == graph->imageData.end())
   {
-    MITK_DEBUG << "Incorrect data storage. Not two (2) values stored.";
+    MITK_DEBUG << "Could not find the image " << imageID << " in the storage.";
     return SemanticTypes::InformationType();
   }
 
-  // the first value of the image vector is the information type
-  return imageVectorPropertyValue[0];
+  // the first value of the image data is the information type
+  return imageData->second.first;
 }
 
 mitk::SemanticTypes::IDVector mitk::RelationStorage::GetAllImageIDsOfCase(const SemanticTypes::CaseID& caseID)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::IDVector();
   }
-  // retrieve a vector property that contains the valid image-IDs of the current case
-  VectorProperty<std::string>* imagesVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("images"));
-  if (nullptr == imagesVectorProperty)
-  {
-    MITK_DEBUG << "Could not find any image in the storage.";
-    return SemanticTypes::IDVector();
-  }
 
-  return imagesVectorProperty->GetValue();
+  return graph->imageIDs;
 }
 
 mitk::SemanticTypes::IDVector mitk::RelationStorage::GetAllImageIDsOfControlPoint(const SemanticTypes::CaseID& caseID, const SemanticTypes::ControlPoint& controlPoint)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::IDVector();
   }
-  // retrieve a vector property that contains the valid image-IDs of the current case
-  VectorProperty<std::string>* imagesVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("images"));
-  if (nullptr == imagesVectorProperty)
-  {
-    MITK_DEBUG << "Could not find any image in the storage.";
-    return SemanticTypes::IDVector();
-  }
 
-  mitk::SemanticTypes::IDVector allImageIDsOfControlPoint;
-  std::vector<std::string> imagesVectorPropertyValue = imagesVectorProperty->GetValue();
-  for (const auto& imageID : imagesVectorPropertyValue)
+  auto imageIDs = graph->imageIDsOfControlPoint.find(controlPoint.UID);
+  if (imageIDs == graph->imageIDsOfControlPoint.end())
   {
-    // retrieve a vector property that contains the referenced ID of an image (0. information type 1. control point ID)
-    VectorProperty<std::string>* imageVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(imageID));
-    if (nullptr == imageVectorProperty)
-    {
-      continue;
-    }
-
-    std::vector<std::string> imageVectorPropertyValue = imageVectorProperty->GetValue();
-    // an image has to have exactly two values (the information type and the ID of the control point)
-    if (imageVectorPropertyValue.size() != 2)
-    {
-      continue;
-    }
-
-    // the second value of the image vector is the ID of the referenced control point
-    if (imageVectorPropertyValue[1] == controlPoint.UID)
-    {
-      allImageIDsOfControlPoint.push_back(imageID);
-    }
+    return SemanticTypes::IDVector();
   }
 
-  return allImageIDsOfControlPoint;
+  return imageIDs->second;
 }
 
 mitk::SemanticTypes::IDVector mitk::RelationStorage::GetAllImageIDsOfInformationType(const SemanticTypes::CaseID& caseID, const SemanticTypes::InformationType& informationType)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::IDVector();
   }
-  // retrieve a vector property that contains the valid image-IDs of the current case
-  VectorProperty<std::string>* imagesVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("images"));
-  if (nullptr == imagesVectorProperty)
-  {
-    MITK_DEBUG << "Could not find any image in the storage.";
-    return SemanticTypes::IDVector();
-  }
 
-  mitk::SemanticTypes::IDVector allImageIDsOfInformationType;
-  std::vector<std::string> imagesVectorPropertyValue = imagesVectorProperty->GetValue();
-  for (const auto& imageID : imagesVectorPropertyValue)
+  auto imageIDs = graph->imageIDsOfInformationType.find(informationType);
+  if (imageIDs == graph->imageIDsOfInformationType.end())
   {
-    // retrieve a vector property that contains the referenced ID of an image (0. information type 1. control point ID)
-    VectorProperty<std::string>* imageVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(imageID));
-    if (nullptr == imageVectorProperty)
-    {
-      continue;
-    }
-
-    std::vector<std::string> imageVectorPropertyValue = imageVectorProperty->GetValue();
-    // an image has to have exactly two values (the information type and the ID of the control point)
-    if (imageVectorPropertyValue.size() != 2)
-    {
-      continue;
-    }
-
-    // the first value of the image vector is the ID of the referenced information type
-    if (imageVectorPropertyValue[0] == informationType)
-    {
-      allImageIDsOfInformationType.push_back(imageID);
-    }
+    return SemanticTypes::IDVector();
   }
 
-  return allImageIDsOfInformationType;
+  return imageIDs->second;
 }
 
 mitk::SemanticTypes::IDVector mitk::RelationStorage::GetAllSegmentationIDsOfCase(const SemanticTypes::CaseID& caseID)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::IDVector();
   }
-  // retrieve a vector property that contains the valid segmentation-IDs for the current case
-  VectorProperty<std::string>* segmentationsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("segmentations"));
-  if (nullptr == segmentationsVectorProperty)
-  {
-    MITK_DEBUG << "Could not find any segmentation in the storage.";
-    return SemanticTypes::IDVector();
-  }
 
-  return segmentationsVectorProperty->GetValue();
+  return graph->segmentationIDs;
 }
 
 mitk::SemanticTypes::IDVector mitk::RelationStorage::GetAllSegmentationIDsOfImage(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::IDVector();
   }
-  // retrieve a vector property that contains the valid segmentation-IDs for the current case
-  VectorProperty<std::string>* segmentationsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("segmentations"));
-  if (nullptr == segmentationsVectorProperty)
-  {
-    MITK_DEBUG << "Could not find any segmentation in the storage.";
-    return SemanticTypes::IDVector();
-  }
 
-  mitk::SemanticTypes::IDVector allSegmentationIDsOfImage;
-  std::vector<std::string> segmentationsVectorPropertyValue = segmentationsVectorProperty->GetValue();
-  for (const auto& segmentationID : segmentationsVectorPropertyValue)
+  auto segmentationIDs = graph->segmentationIDsOfImage.find(imageID);
+  if (segmentationIDs == graph->segmentationIDsOfImage.end())
   {
-    // retrieve a vector property that contains the referenced ID of a segmentation (0. image ID 1. lesion ID)
-    VectorProperty<std::string>* segmentationVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(segmentationID));
-    if (nullptr == segmentationVectorProperty)
-    {
-      continue;
-    }
-
-    std::vector<std::string> segmentationVectorPropertyValue = segmentationVectorProperty->GetValue();
-    // a segmentation has to have exactly two values (the ID of the referenced image and the ID of the referenced lesion)
-    if (segmentationVectorPropertyValue.size() != 2)
-    {
-      continue;
-    }
-
-    // the first value of the segmentation vector is the ID of the referenced image
-    if (segmentationVectorPropertyValue[0] == imageID)
-    {
-      allSegmentationIDsOfImage.push_back(segmentationID);
-    }
+    return SemanticTypes::IDVector();
   }
 
-  return allSegmentationIDsOfImage;
+  return segmentationIDs->second;
 }
 
 mitk::SemanticTypes::IDVector mitk::RelationStorage::GetAllSegmentationIDsOfLesion(const SemanticTypes::CaseID& caseID, const SemanticTypes::Lesion& lesion)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::IDVector();
   }
-  // retrieve a vector property that contains the valid segmentation-IDs for the current case
-  VectorProperty<std::string>* segmentationsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("segmentations"));
-  if (nullptr == segmentationsVectorProperty)
-  {
-    MITK_DEBUG << "Could not find any segmentation in the storage.";
-    return SemanticTypes::IDVector();
-  }
 
-  mitk::SemanticTypes::IDVector allSegmentationIDsOfLesion;
-  std::vector<std::string> segmentationsVectorPropertyValue = segmentationsVectorProperty->GetValue();
-  for (const auto& segmentationID : segmentationsVectorPropertyValue)
+  auto segmentationIDs = graph->segmentationIDsOfLesion.find(lesion.UID);
+  if (segmentationIDs == graph->segmentationIDsOfLesion.end())
   {
-    // retrieve a vector property that contains the referenced ID of a segmentation (0. image ID 1. lesion ID)
-    VectorProperty<std::string>* segmentationVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(segmentationID));
-    if (nullptr == segmentationVectorProperty)
-    {
-      continue;
-    }
-
-    std::vector<std::string> segmentationVectorPropertyValue = segmentationVectorProperty->GetValue();
-    // a segmentation has to have exactly two values (the ID of the referenced image and the ID of the referenced lesion)
-    if (segmentationVectorPropertyValue.size() != 2)
-    {
-      continue;
-    }
-
-    // the second value of the segmentation vector is the ID of the referenced lesion
-    if (segmentationVectorPropertyValue[1] == lesion.UID)
-    {
-      allSegmentationIDsOfLesion.push_back(segmentationID);
-    }
+    return SemanticTypes::IDVector();
   }
 
-  return allSegmentationIDsOfLesion;
+  return segmentationIDs->second;
 }
 
 mitk::SemanticTypes::ID mitk::RelationStorage::GetImageIDOfSegmentation(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& segmentationID)
 {
-  PropertyList::Pointer propertyList = GetStorageData(caseID);
-  if (nullptr == propertyList)
+  const RelationGraph* graph = GetRelationGraph(caseID);
+  if (nullptr == graph)
   {
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return SemanticTypes::ID();
   }
 
-  // retrieve a vector property that contains the referenced ID of a segmentation (0. image ID 1. lesion ID)
-  VectorProperty<std::string>* segmentationVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(segmentationID));
-  if (nullptr == segmentationVectorProperty)
+  auto segmentationData = graph->segmentationData.find(segmentationID);
+  if (segmentationData == graph->segmentationData.end())
   {
     MITK_DEBUG << "Could not find the segmentation " << segmentationID << " in the storage.";
     return SemanticTypes::ID();
   }
 
-  std::vector<std::string> segmentationVectorPropertyValue = segmentationVectorProperty->GetValue();
-  // the lesion ID of a segmentation is the second value in the vector
-  if (segmentationVectorPropertyValue.size() != 2)
-  {
-    MITK_DEBUG << "Incorrect segmentation storage. Not two (2) IDs stored.";
-    return SemanticTypes::ID();
-  }
-
-  return segmentationVectorPropertyValue[0];
+  // the first value of the segmentation data is the ID of the referenced image
+  return segmentationData->second.first;
 }
 
 std::vector<mitk::SemanticTypes::CaseID> mitk::RelationStorage::GetAllCaseIDs()
@@ -712,6 +902,12 @@ void mitk::RelationStorage::AddCase(const SemanticTypes::CaseID& caseID)
   caseIDsVectorPropertyValue.push_back(caseID);
   caseIDsVectorProperty->SetValue(caseIDsVectorPropertyValue);
   propertyList->SetProperty(listIdentifier, caseIDsVectorProperty);
+
+  CaseIDCache& caseIDCache = GetCaseIDCache();
+  if (caseIDCache.caseIDsVectorProperty == caseIDsVectorProperty)
+  {
+    caseIDCache.caseIDs.insert(caseID);
+  }
 }
 
 void mitk::RelationStorage::AddImage(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID)
@@ -722,6 +918,7 @@ void mitk::RelationStorage::AddImage(const SemanticTypes::CaseID& caseID, const
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
 
   // retrieve a vector property that contains the valid image-IDs for the current case
   VectorProperty<std::string>::Pointer imagesVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("images"));
@@ -738,6 +935,7 @@ void mitk::RelationStorage::AddImage(const SemanticTypes::CaseID& caseID, const
   auto existingImage = std::find(imagesVectorPropertyValue.begin(), imagesVectorPropertyValue.end(), imageID);
   if (existingImage != imagesVectorPropertyValue.end())
   {
+    FinishRelationGraphUpdate(graph);
     return;
   }
 
@@ -752,6 +950,13 @@ void mitk::RelationStorage::AddImage(const SemanticTypes::CaseID& caseID, const
   std::vector<std::string> imageVectorPropertyValue(2);
   imageVectorProperty->SetValue(imageVectorPropertyValue);
   propertyList->SetProperty(imageID, imageVectorProperty);
+
+  if (nullptr != graph)
+  {
+    graph->imageIDs.push_back(imageID);
+    UpdateImage(propertyList, *graph, imageID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveImage(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID)
@@ -762,6 +967,7 @@ void mitk::RelationStorage::RemoveImage(const SemanticTypes::CaseID& caseID, con
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
 
   // retrieve a vector property that contains the valid image-IDs for the current case
   VectorProperty<std::string>::Pointer imagesVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("images"));
@@ -787,6 +993,13 @@ void mitk::RelationStorage::RemoveImage(const SemanticTypes::CaseID& caseID, con
 
   // remove the image instance itself
   propertyList->DeleteProperty(imageID);
+
+  if (nullptr != graph)
+  {
+    RemoveID(graph->imageIDs, imageID);
+    UpdateImage(propertyList, *graph, imageID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::AddSegmentation(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& segmentationID, const SemanticTypes::ID& parentID)
@@ -797,6 +1010,7 @@ void mitk::RelationStorage::AddSegmentation(const SemanticTypes::CaseID& caseID,
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
 
   // retrieve a vector property that contains the valid segmentation-IDs for the current case
   VectorProperty<std::string>::Pointer segmentationsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("segmentations"));
@@ -813,6 +1027,7 @@ void mitk::RelationStorage::AddSegmentation(const SemanticTypes::CaseID& caseID,
   auto existingSegmentation = std::find(segmentationsVectorPropertyValue.begin(), segmentationsVectorPropertyValue.end(), segmentationID);
   if (existingSegmentation != segmentationsVectorPropertyValue.end())
   {
+    FinishRelationGraphUpdate(graph);
     return;
   }
 
@@ -828,6 +1043,13 @@ void mitk::RelationStorage::AddSegmentation(const SemanticTypes::CaseID& caseID,
   segmentationVectorPropertyValue[0] = parentID;
   segmentationVectorProperty->SetValue(segmentationVectorPropertyValue);
   propertyList->SetProperty(segmentationID, segmentationVectorProperty);
+
+  if (nullptr != graph)
+  {
+    graph->segmentationIDs.push_back(segmentationID);
+    UpdateSegmentation(propertyList, *graph, segmentationID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveSegmentation(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& segmentationID)
@@ -838,6 +1060,7 @@ void mitk::RelationStorage::RemoveSegmentation(const SemanticTypes::CaseID& case
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
 
   // retrieve a vector property that contains the valid segmentation-IDs for the current case
   VectorProperty<std::string>::Pointer segmentationsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("segmentations"));
@@ -863,6 +1086,13 @@ void mitk::RelationStorage::RemoveSegmentation(const SemanticTypes::CaseID& case
 
   // remove the lesion instance itself
   propertyList->DeleteProperty(segmentationID);
+
+  if (nullptr != graph)
+  {
+    RemoveID(graph->segmentationIDs, segmentationID);
+    UpdateSegmentation(propertyList, *graph, segmentationID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::AddLesion(const SemanticTypes::CaseID& caseID, const SemanticTypes::Lesion& lesion)
@@ -873,6 +1103,8 @@ void mitk::RelationStorage::AddLesion(const SemanticTypes::CaseID& caseID, const
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid lesion-IDs for the current case
   VectorProperty<std::string>::Pointer lesionsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("lesions"));
   std::vector<std::string> lesionsVectorPropertyValue;
@@ -888,6 +1120,7 @@ void mitk::RelationStorage::AddLesion(const SemanticTypes::CaseID& caseID, const
   const auto& existingIndex = std::find(lesionsVectorPropertyValue.begin(), lesionsVectorPropertyValue.end(), lesion.UID);
   if (existingIndex != lesionsVectorPropertyValue.end())
   {
+    FinishRelationGraphUpdate(graph);
     return;
   }
 
@@ -908,6 +1141,15 @@ void mitk::RelationStorage::AddLesion(const SemanticTypes::CaseID& caseID, const
   // add the lesion class with the lesion class UID as key and the class type as value
   std::string lesionClassType = lesion.lesionClass.classType;
   propertyList->SetStringProperty(lesion.lesionClass.UID.c_str(), lesionClassType.c_str());
+
+  if (nullptr != graph)
+  {
+    graph->lesions.push_back(lesion);
+    UpdateLesion(propertyList, *graph, lesion.UID);
+    // the class type may have been changed for other lesions of the class as well
+    UpdateLesionsOfClass(propertyList, *graph, lesion.lesionClass.UID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::OverwriteLesion(const SemanticTypes::CaseID& caseID, const SemanticTypes::Lesion& lesion)
@@ -918,6 +1160,8 @@ void mitk::RelationStorage::OverwriteLesion(const SemanticTypes::CaseID& caseID,
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid lesion-IDs for the current case
   VectorProperty<std::string>* lesionVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("lesions"));
   if (nullptr == lesionVectorProperty)
@@ -941,6 +1185,14 @@ void mitk::RelationStorage::OverwriteLesion(const SemanticTypes::CaseID& caseID,
     // overwrite the lesion class with the lesion class UID as key and the new, given class type as value
     std::string lesionClassType = lesion.lesionClass.classType;
     propertyList->SetStringProperty(lesion.lesionClass.UID.c_str(), lesionClassType.c_str());
+
+    if (nullptr != graph)
+    {
+      UpdateLesion(propertyList, *graph, lesion.UID);
+      // the class type may have been changed for other lesions of the class as well
+      UpdateLesionsOfClass(propertyList, *graph, lesion.lesionClass.UID);
+    }
+    FinishRelationGraphUpdate(graph);
   }
   else
   {
@@ -956,6 +1208,8 @@ void mitk::RelationStorage::LinkSegmentationToLesion(const SemanticTypes::CaseID
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid lesion-IDs for the current case
   VectorProperty<std::string>* lesionVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("lesions"));
   if (nullptr == lesionVectorProperty)
@@ -987,6 +1241,12 @@ void mitk::RelationStorage::LinkSegmentationToLesion(const SemanticTypes::CaseID
     // the lesion ID of a segmentation is the second value in the vector
     segmentationVectorPropertyValue[1] = lesion.UID;
     segmentationVectorProperty->SetValue(segmentationVectorPropertyValue);
+
+    if (nullptr != graph)
+    {
+      UpdateSegmentation(propertyList, *graph, segmentationID);
+    }
+    FinishRelationGraphUpdate(graph);
     return;
   }
 
@@ -1001,6 +1261,8 @@ void mitk::RelationStorage::UnlinkSegmentationFromLesion(const SemanticTypes::Ca
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the referenced ID of a segmentation (0. image ID 1. lesion ID)
   VectorProperty<std::string>* segmentationVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(segmentationID));
   if (nullptr == segmentationVectorProperty)
@@ -1021,6 +1283,12 @@ void mitk::RelationStorage::UnlinkSegmentationFromLesion(const SemanticTypes::Ca
   // set the lesion reference to an empty string for removal
   segmentationVectorPropertyValue[1] = "";
   segmentationVectorProperty->SetValue(segmentationVectorPropertyValue);
+
+  if (nullptr != graph)
+  {
+    UpdateSegmentation(propertyList, *graph, segmentationID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveLesion(const SemanticTypes::CaseID& caseID, const SemanticTypes::Lesion& lesion)
@@ -1031,6 +1299,8 @@ void mitk::RelationStorage::RemoveLesion(const SemanticTypes::CaseID& caseID, co
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid lesions of the current case
   VectorProperty<std::string>* lesionVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("lesions"));
   if (nullptr == lesionVectorProperty)
@@ -1064,16 +1334,30 @@ void mitk::RelationStorage::RemoveLesion(const SemanticTypes::CaseID& caseID, co
 
   std::vector<std::string> lesionData = lesionDataProperty->GetValue();
   // a lesion date has to have exactly two values (the name of the lesion and the UID of the lesion class)
+  std::string lesionClassID;
   if (lesionData.size() != 2)
   {
     MITK_DEBUG << "Incorrect lesion data storage. Not two (2) strings of the lesion UID and the lesion name are stored.";
   }
   else
   {
-    std::string lesionClassID = lesionData[1];
+    lesionClassID = lesionData[1];
     RemoveLesionClass(caseID, lesionClassID);
   }
   propertyList->DeleteProperty(lesion.UID);
+
+  if (nullptr != graph)
+  {
+    graph->lesions.erase(std::remove_if(graph->lesions.begin(), graph->lesions.end(),
+      [&lesion](const SemanticTypes::Lesion& existingLesion) { return existingLesion.UID == lesion.UID; }), graph->lesions.end());
+    UpdateLesion(propertyList, *graph, lesion.UID);
+    if (!lesionClassID.empty())
+    {
+      // the lesion class may have been removed as well
+      UpdateLesionsOfClass(propertyList, *graph, lesionClassID);
+    }
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveLesionClass(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& lesionClassID)
@@ -1084,6 +1368,7 @@ void mitk::RelationStorage::RemoveLesionClass(const SemanticTypes::CaseID& caseI
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
 
   // retrieve a vector property that contains the lesion class
   StringProperty* lesionClassProperty = dynamic_cast<StringProperty*>(propertyList->GetProperty(lesionClassID));
@@ -1097,6 +1382,7 @@ void mitk::RelationStorage::RemoveLesionClass(const SemanticTypes::CaseID& caseI
   VectorProperty<std::string>* lesionVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("lesions"));
   if (nullptr == lesionVectorProperty)
   {
+    FinishRelationGraphUpdate(graph);
     return;
   }
 
@@ -1125,7 +1411,14 @@ void mitk::RelationStorage::RemoveLesionClass(const SemanticTypes::CaseID& caseI
   {
     // lesion class ID not referenced; remove lesion class
     propertyList->DeleteProperty(lesionClassID);
+
+    if (nullptr != graph)
+    {
+      // only lesions that are referenced by segmentations but not part of the case can still use the class
+      UpdateLesionsOfClass(propertyList, *graph, lesionClassID);
+    }
   }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::AddControlPoint(const SemanticTypes::CaseID& caseID, const SemanticTypes::ControlPoint& controlPoint)
@@ -1136,6 +1429,8 @@ void mitk::RelationStorage::AddControlPoint(const SemanticTypes::CaseID& caseID,
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid controlPoint UIDs for the current case
   VectorProperty<std::string>::Pointer controlPointsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("controlpoints"));
   std::vector<std::string> controlPointsVectorPropertyValue;
@@ -1151,6 +1446,7 @@ void mitk::RelationStorage::AddControlPoint(const SemanticTypes::CaseID& caseID,
   const auto existingControlPoint = std::find(controlPointsVectorPropertyValue.begin(), controlPointsVectorPropertyValue.end(), controlPoint.UID);
   if (existingControlPoint != controlPointsVectorPropertyValue.end())
   {
+    FinishRelationGraphUpdate(graph);
     return;
   }
 
@@ -1169,6 +1465,17 @@ void mitk::RelationStorage::AddControlPoint(const SemanticTypes::CaseID& caseID,
   VectorProperty<int>::Pointer newControlPointVectorProperty = VectorProperty<int>::New();
   newControlPointVectorProperty->SetValue(controlPointDate);
   propertyList->SetProperty(controlPoint.UID, newControlPointVectorProperty);
+
+  if (nullptr != graph)
+  {
+    SemanticTypes::ControlPoint generatedControlPoint = GenerateControlpoint(propertyList, controlPoint.UID);
+    if (!generatedControlPoint.UID.empty())
+    {
+      graph->controlPoints.push_back(generatedControlPoint);
+      graph->controlPointsByUID[controlPoint.UID] = generatedControlPoint;
+    }
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::LinkImageToControlPoint(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID, const SemanticTypes::ControlPoint& controlPoint)
@@ -1179,6 +1486,8 @@ void mitk::RelationStorage::LinkImageToControlPoint(const SemanticTypes::CaseID&
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid controlPoint UIDs for the current case
   VectorProperty<std::string>* controlPointsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("controlpoints"));
   if (nullptr == controlPointsVectorProperty)
@@ -1211,6 +1520,12 @@ void mitk::RelationStorage::LinkImageToControlPoint(const SemanticTypes::CaseID&
     // the second value of the image vector is the ID of the referenced control point
     imageVectorPropertyValue[1] = controlPoint.UID;
     imageVectorProperty->SetValue(imageVectorPropertyValue);
+
+    if (nullptr != graph)
+    {
+      UpdateImage(propertyList, *graph, imageID);
+    }
+    FinishRelationGraphUpdate(graph);
     return;
   }
 
@@ -1225,6 +1540,8 @@ void mitk::RelationStorage::UnlinkImageFromControlPoint(const SemanticTypes::Cas
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the referenced ID of a date (0. information type 1. control point ID)
   VectorProperty<std::string>* imageVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(imageID));
   if (nullptr == imageVectorProperty)
@@ -1245,6 +1562,12 @@ void mitk::RelationStorage::UnlinkImageFromControlPoint(const SemanticTypes::Cas
   // set the control point reference to an empty string for removal
   imageVectorPropertyValue[1] = "";
   imageVectorProperty->SetValue(imageVectorPropertyValue);
+
+  if (nullptr != graph)
+  {
+    UpdateImage(propertyList, *graph, imageID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveControlPoint(const SemanticTypes::CaseID& caseID, const SemanticTypes::ControlPoint& controlPoint)
@@ -1255,6 +1578,8 @@ void mitk::RelationStorage::RemoveControlPoint(const SemanticTypes::CaseID& case
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid controlPoint UIDs for the current case
   VectorProperty<std::string>* controlPointsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("controlpoints"));
   if (nullptr == controlPointsVectorProperty)
@@ -1279,6 +1604,14 @@ void mitk::RelationStorage::RemoveControlPoint(const SemanticTypes::CaseID& case
 
   // remove the control point instance itself
   propertyList->DeleteProperty(controlPoint.UID);
+
+  if (nullptr != graph)
+  {
+    graph->controlPoints.erase(std::remove_if(graph->controlPoints.begin(), graph->controlPoints.end(),
+      [&controlPoint](const SemanticTypes::ControlPoint& existingControlPoint) { return existingControlPoint.UID == controlPoint.UID; }), graph->controlPoints.end());
+    graph->controlPointsByUID.erase(controlPoint.UID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::AddExaminationPeriod(const SemanticTypes::CaseID& caseID, const SemanticTypes::ExaminationPeriod& examinationPeriod)
@@ -1289,6 +1622,8 @@ void mitk::RelationStorage::AddExaminationPeriod(const SemanticTypes::CaseID& ca
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid examination period UIDs for the current case
   VectorProperty<std::string>::Pointer examinationPeriodsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("examinationperiods"));
   std::vector<std::string> examinationPeriodsVectorPropertyValue;
@@ -1304,6 +1639,7 @@ void mitk::RelationStorage::AddExaminationPeriod(const SemanticTypes::CaseID& ca
   const auto& existingIndex = std::find(examinationPeriodsVectorPropertyValue.begin(), examinationPeriodsVectorPropertyValue.end(), examinationPeriod.UID);
   if (existingIndex != examinationPeriodsVectorPropertyValue.end())
   {
+    FinishRelationGraphUpdate(graph);
     return;
   }
 
@@ -1319,6 +1655,13 @@ void mitk::RelationStorage::AddExaminationPeriod(const SemanticTypes::CaseID& ca
   VectorProperty<std::string>::Pointer newExaminationPeriodVectorProperty = VectorProperty<std::string>::New();
   newExaminationPeriodVectorProperty->SetValue(examinationPeriodData);
   propertyList->SetProperty(examinationPeriod.UID, newExaminationPeriodVectorProperty);
+
+  if (nullptr != graph)
+  {
+    graph->examinationPeriods.push_back(examinationPeriod);
+    UpdateExaminationPeriod(propertyList, *graph, examinationPeriod.UID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::AddControlPointToExaminationPeriod(const SemanticTypes::CaseID& caseID, const SemanticTypes::ControlPoint& controlPoint, const SemanticTypes::ExaminationPeriod& examinationPeriod)
@@ -1329,6 +1672,7 @@ void mitk::RelationStorage::AddControlPointToExaminationPeriod(const SemanticTyp
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
 
   // retrieve a vector property that contains the represented control point UIDs of the given examination period
   VectorProperty<std::string>* controlPointUIDsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(examinationPeriod.UID));
@@ -1342,10 +1686,10 @@ void mitk::RelationStorage::AddControlPointToExaminationPeriod(const SemanticTyp
   // store the control point UID
   controlPointUIDsVectorPropertyValue.push_back(controlPoint.UID);
   // sort the vector according to the date of the control points referenced by the UIDs
-  auto lambda = [&caseID](const SemanticTypes::ID& leftControlPointUID, const SemanticTypes::ID& rightControlPointUID)
+  auto lambda = [&propertyList](const SemanticTypes::ID& leftControlPointUID, const SemanticTypes::ID& rightControlPointUID)
   {
-    const auto& leftControlPoint = GenerateControlpoint(caseID, leftControlPointUID);
-    const auto& rightControlPoint = GenerateControlpoint(caseID, rightControlPointUID);
+    const auto& leftControlPoint = GenerateControlpoint(propertyList, leftControlPointUID);
+    const auto& rightControlPoint = GenerateControlpoint(propertyList, rightControlPointUID);
 
     return leftControlPoint.date <= rightControlPoint.date;
   };
@@ -1353,6 +1697,12 @@ void mitk::RelationStorage::AddControlPointToExaminationPeriod(const SemanticTyp
   std::sort(controlPointUIDsVectorPropertyValue.begin(), controlPointUIDsVectorPropertyValue.end(), lambda);
   // store the modified and sorted control point UID vector of this examination period
   controlPointUIDsVectorProperty->SetValue(controlPointUIDsVectorPropertyValue);
+
+  if (nullptr != graph)
+  {
+    UpdateExaminationPeriod(propertyList, *graph, examinationPeriod.UID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveControlPointFromExaminationPeriod(const SemanticTypes::CaseID& caseID, const SemanticTypes::ControlPoint& controlPoint, const SemanticTypes::ExaminationPeriod& examinationPeriod)
@@ -1363,6 +1713,7 @@ void mitk::RelationStorage::RemoveControlPointFromExaminationPeriod(const Semant
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
 
   // retrieve a vector property that contains the represented control point UIDs of the given examination period
   VectorProperty<std::string>* controlPointUIDsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(examinationPeriod.UID));
@@ -1385,13 +1736,23 @@ void mitk::RelationStorage::RemoveControlPointFromExaminationPeriod(const Semant
     if (controlPointUIDsVectorPropertyValue.size() < 2)
     {
       RemoveExaminationPeriod(caseID, examinationPeriod);
+      if (nullptr != graph)
+      {
+        graph->examinationPeriods.erase(std::remove_if(graph->examinationPeriods.begin(), graph->examinationPeriods.end(),
+          [&examinationPeriod](const SemanticTypes::ExaminationPeriod& existingExaminationPeriod) { return existingExaminationPeriod.UID == examinationPeriod.UID; }), graph->examinationPeriods.end());
+      }
     }
     else
     {
       // store the modified vector value
       controlPointUIDsVectorProperty->SetValue(controlPointUIDsVectorPropertyValue);
+      if (nullptr != graph)
+      {
+        UpdateExaminationPeriod(propertyList, *graph, examinationPeriod.UID);
+      }
     }
   }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveExaminationPeriod(const SemanticTypes::CaseID& caseID, const SemanticTypes::ExaminationPeriod& examinationPeriod)
@@ -1402,6 +1763,8 @@ void mitk::RelationStorage::RemoveExaminationPeriod(const SemanticTypes::CaseID&
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid examination period UIDs for the current case
   VectorProperty<std::string>::Pointer examinationPeriodsVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("examinationperiods"));
   if (nullptr == examinationPeriodsVectorProperty)
@@ -1425,6 +1788,13 @@ void mitk::RelationStorage::RemoveExaminationPeriod(const SemanticTypes::CaseID&
 
   // remove the examination period instance itself
   propertyList->DeleteProperty(examinationPeriod.UID);
+
+  if (nullptr != graph)
+  {
+    graph->examinationPeriods.erase(std::remove_if(graph->examinationPeriods.begin(), graph->examinationPeriods.end(),
+      [&examinationPeriod](const SemanticTypes::ExaminationPeriod& existingExaminationPeriod) { return existingExaminationPeriod.UID == examinationPeriod.UID; }), graph->examinationPeriods.end());
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::AddInformationTypeToImage(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID, const SemanticTypes::InformationType& informationType)
@@ -1435,6 +1805,8 @@ void mitk::RelationStorage::AddInformationTypeToImage(const SemanticTypes::CaseI
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid information types of the current case
   VectorProperty<std::string>::Pointer informationTypesVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("informationtypes"));
   std::vector<std::string> informationTypesVectorPropertyValue;
@@ -1454,6 +1826,10 @@ void mitk::RelationStorage::AddInformationTypeToImage(const SemanticTypes::CaseI
     informationTypesVectorPropertyValue.push_back(informationType);
     informationTypesVectorProperty->SetValue(informationTypesVectorPropertyValue);
     propertyList->SetProperty("informationtypes", informationTypesVectorProperty);
+    if (nullptr != graph)
+    {
+      graph->informationTypes.push_back(informationType);
+    }
   }
 
   // set / overwrite the information type of the given data
@@ -1476,6 +1852,12 @@ void mitk::RelationStorage::AddInformationTypeToImage(const SemanticTypes::CaseI
   // the first value of the image vector is the information type
   imageVectorPropertyValue[0] = informationType;
   imageVectorProperty->SetValue(imageVectorPropertyValue);
+
+  if (nullptr != graph)
+  {
+    UpdateImage(propertyList, *graph, imageID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveInformationTypeFromImage(const SemanticTypes::CaseID& caseID, const SemanticTypes::ID& imageID)
@@ -1486,6 +1868,8 @@ void mitk::RelationStorage::RemoveInformationTypeFromImage(const SemanticTypes::
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the referenced ID of an image (0. information type 1. control point ID)
   VectorProperty<std::string>* imageVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty(imageID));
   if (nullptr == imageVectorProperty)
@@ -1506,6 +1890,12 @@ void mitk::RelationStorage::RemoveInformationTypeFromImage(const SemanticTypes::
   // set the information type to an empty string for removal
   imageVectorPropertyValue[0] = "";
   imageVectorProperty->SetValue(imageVectorPropertyValue);
+
+  if (nullptr != graph)
+  {
+    UpdateImage(propertyList, *graph, imageID);
+  }
+  FinishRelationGraphUpdate(graph);
 }
 
 void mitk::RelationStorage::RemoveInformationType(const SemanticTypes::CaseID& caseID, const SemanticTypes::InformationType& informationType)
@@ -1516,6 +1906,8 @@ void mitk::RelationStorage::RemoveInformationType(const SemanticTypes::CaseID& c
     MITK_DEBUG << "Could not find the property list " << caseID << " for the current MITK workbench / session.";
     return;
   }
+  RelationGraph* graph = StartRelationGraphUpdate(caseID, propertyList);
+
   // retrieve a vector property that contains the valid information types of the current case
   VectorProperty<std::string>* informationTypesVectorProperty = dynamic_cast<VectorProperty<std::string>*>(propertyList->GetProperty("informationtypes"));
   if (nullptr == informationTypesVectorProperty)
@@ -1536,4 +1928,10 @@ void mitk::RelationStorage::RemoveInformationType(const SemanticTypes::CaseID& c
     // or store the modified vector value
     informationTypesVectorProperty->SetValue(informationTypesVectorPropertyValue);
   }
+
+  if (nullptr != graph)
+  {
+    RemoveID(graph->informationTypes, informationType);
+  }
+  FinishRelationGraphUpdate(graph);
 }
@@ -1,6 +1,7 @@
 set(MODULE_TESTS
   mitkComputeContourSetNormalsFilterTest.cpp
   mitkCreateDistanceImageFromSurfaceFilterTest.cpp
+  mitkCreateDistanceImageFromSurfaceFilterBenchmarkTest.cpp
   mitkImageToPointCloudFilterTest.cpp
   mitkPointCloudScoringFilterTest
   mitkReduceContourSetFilterTest.cpp
@@ -0,0 +1,274 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkCreateDistanceImageFromSurfaceFilter.h>
+#include <mitkImageCast.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkImageRegionConstIterator.h>
+#include <itkMath.h>
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+/**
+ * Interpolates synthetic contours of an ellipsoid with an increasing number of contours,
+ * compares the partition of unity interpolation against the global equation system and
+ * reports the run times of both approaches. Also checks that an incremental update after
+ * adding a contour yields the same result as interpolating all contours at once.
+ *
+ * The contours are kept small, so that the dense global equation systems (three centers per
+ * contour point) stay below about 1500 centers and the suite runs as a unit test.
+ */
+class mitkCreateDistanceImageFromSurfaceFilterBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkCreateDistanceImageFromSurfaceFilterBenchmarkTestSuite);
+  MITK_TEST(TestPartitionOfUnityMatchesDirectSolution);
+  MITK_TEST(TestBenchmarkOverContourCounts);
+  MITK_TEST(TestIncrementalUpdate);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> DistanceImageType;
+  typedef itk::Image<unsigned char, 3> ReferenceImageType;
+
+  static const unsigned int NUMBER_OF_POINTS_PER_CONTOUR = 50;
+
+  ReferenceImageType::Pointer m_ReferenceImage;
+
+  /** Contour in the plane z with the normals stored as cell data, as done by the ComputeContourSetNormalsFilter */
+  mitk::Surface::Pointer CreateEllipsoidContour(double z, double radius)
+  {
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+    vtkSmartPointer<vtkDoubleArray> normals = vtkSmartPointer<vtkDoubleArray>::New();
+    normals->SetNumberOfComponents(3);
+
+    const double contourRadius = std::sqrt(radius * radius - z * z);
+    polys->InsertNextCell(NUMBER_OF_POINTS_PER_CONTOUR);
+    for (unsigned int i = 0; i < NUMBER_OF_POINTS_PER_CONTOUR; ++i)
+    {
+      const double angle = 2 * itk::Math::pi * i / NUMBER_OF_POINTS_PER_CONTOUR;
+      points->InsertNextPoint(1.3 * contourRadius * std::cos(angle), contourRadius * std::sin(angle), z);
+      polys->InsertCellPoint(i);
+
+      double normal[3] = {std::cos(angle) / 1.3, std::sin(angle), 0.0};
+      const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1]);
+      normal[0] /= length;
+      normal[1] /= length;
+      normals->InsertNextTuple(normal);
+    }
+
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetPolys(polys);
+    polyData->GetCellData()->SetNormals(normals);
+
+    mitk::Surface::Pointer surface = mitk::Surface::New();
+    surface->SetVtkPolyData(polyData);
+    return surface;
+  }
+
+  std::vector<mitk::Surface::Pointer> CreateEllipsoidContours(unsigned int numberOfContours)
+  {
+    const double radius = 40.0;
+    std::vector<mitk::Surface::Pointer> contours;
+    for (unsigned int i = 0; i < numberOfContours; ++i)
+    {
+      const double z = radius * 0.9 * (2.0 * (i + 0.5) / numberOfContours - 1.0);
+      contours.push_back(CreateEllipsoidContour(z, radius));
+    }
+    return contours;
+  }
+
+  DistanceImageType::Pointer Interpolate(const std::vector<mitk::Surface::Pointer> &contours,
+                                         unsigned int maximumNumberOfCentersForDirectSolution,
+                                         double &duration)
+  {
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer filter = mitk::CreateDistanceImageFromSurfaceFilter::New();
+    filter->SetReferenceImage(m_ReferenceImage.GetPointer());
+    filter->SetMaximumNumberOfCentersForDirectSolution(maximumNumberOfCentersForDirectSolution);
+    for (unsigned int i = 0; i < contours.size(); ++i)
+    {
+      filter->SetInput(i, contours[i]);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    filter->Update();
+    auto stop = std::chrono::high_resolution_clock::now();
+    duration = std::chrono::duration<double, std::milli>(stop - start).count();
+
+    DistanceImageType::Pointer distanceImage;
+    mitk::CastToItkImage(filter->GetOutput(), distanceImage);
+    return distanceImage;
+  }
+
+  bool IsInside(DistanceImageType *distanceImage, double x, double y, double z)
+  {
+    DistanceImageType::PointType point;
+    point[0] = x;
+    point[1] = y;
+    point[2] = z;
+    DistanceImageType::IndexType index;
+    distanceImage->TransformPhysicalPointToIndex(point, index);
+    return distanceImage->GetPixel(index) < 0;
+  }
+
+public:
+  void setUp() override
+  {
+    ReferenceImageType::SizeType size;
+    size.Fill(140);
+    ReferenceImageType::PointType origin;
+    origin.Fill(-70);
+    m_ReferenceImage = ReferenceImageType::New();
+    m_ReferenceImage->SetRegions(size);
+    m_ReferenceImage->SetOrigin(origin);
+  }
+
+  void tearDown() override { m_ReferenceImage = nullptr; }
+
+  void TestPartitionOfUnityMatchesDirectSolution()
+  {
+    auto contours = CreateEllipsoidContours(8);
+
+    double directDuration = 0;
+    double patchDuration = 0;
+    DistanceImageType::Pointer direct = Interpolate(contours, 100000, directDuration);
+    DistanceImageType::Pointer patches = Interpolate(contours, 0, patchDuration);
+
+    CPPUNIT_ASSERT_MESSAGE("Distance images differ in geometry",
+                           direct->GetLargestPossibleRegion() == patches->GetLargestPossibleRegion());
+
+    // Both approximate the same implicit function, so the classification may only differ for voxels that
+    // are close to the surface in both images. A difference anywhere else means a hole in the narrow
+    // band or a wrongly filled region.
+    const double bandWidth = 2 * direct->GetSpacing()[0];
+    itk::ImageRegionConstIterator<DistanceImageType> directIter(direct, direct->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<DistanceImageType> patchIter(patches, patches->GetLargestPossibleRegion());
+    unsigned int numberOfDifferentSigns = 0;
+    unsigned int numberOfDifferentSignsOutsideBand = 0;
+    unsigned int numberOfVoxels = 0;
+    for (; !directIter.IsAtEnd(); ++directIter, ++patchIter, ++numberOfVoxels)
+    {
+      if ((directIter.Get() < 0) != (patchIter.Get() < 0))
+      {
+        ++numberOfDifferentSigns;
+        if (std::fabs(directIter.Get()) >= bandWidth || std::fabs(patchIter.Get()) >= bandWidth)
+          ++numberOfDifferentSignsOutsideBand;
+      }
+    }
+
+    MITK_INFO << "Voxels classified differently: " << numberOfDifferentSigns << " of " << numberOfVoxels;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Partition of unity and direct solution classify voxels away from the surface "
+                                 "differently",
+                                 0u,
+                                 numberOfDifferentSignsOutsideBand);
+    CPPUNIT_ASSERT_MESSAGE("Partition of unity and direct solution classify too many voxels differently",
+                           numberOfDifferentSigns < 0.005 * numberOfVoxels);
+  }
+
+  void TestBenchmarkOverContourCounts()
+  {
+    const unsigned int contourCounts[] = {5, 10, 20, 40};
+    for (auto numberOfContours : contourCounts)
+    {
+      auto contours = CreateEllipsoidContours(numberOfContours);
+
+      double patchDuration = 0;
+      DistanceImageType::Pointer patches = Interpolate(contours, 0, patchDuration);
+      CPPUNIT_ASSERT_MESSAGE("Center of the ellipsoid is not inside", IsInside(patches, 0, 0, 0));
+      CPPUNIT_ASSERT_MESSAGE("Point beside the ellipsoid is not outside", !IsInside(patches, 0, 45, 0));
+
+      // The global equation system is only timed for moderate sizes, it becomes far too expensive beyond
+      if (numberOfContours <= 10)
+      {
+        double directDuration = 0;
+        DistanceImageType::Pointer direct = Interpolate(contours, 100000, directDuration);
+        CPPUNIT_ASSERT_MESSAGE("Center of the ellipsoid is not inside", IsInside(direct, 0, 0, 0));
+        MITK_INFO << numberOfContours << " contours: direct solution " << directDuration
+                  << " ms, partition of unity " << patchDuration << " ms";
+      }
+      else
+      {
+        MITK_INFO << numberOfContours << " contours: partition of unity " << patchDuration << " ms";
+      }
+    }
+  }
+
+  void TestIncrementalUpdate()
+  {
+    // The contour that is added last lies within the extent of the others, so that the
+    // geometry of the distance image does not change
+    auto contours = CreateEllipsoidContours(21);
+    std::rotate(contours.begin() + 5, contours.begin() + 6, contours.end());
+
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer filter = mitk::CreateDistanceImageFromSurfaceFilter::New();
+    filter->SetReferenceImage(m_ReferenceImage.GetPointer());
+    filter->SetMaximumNumberOfCentersForDirectSolution(0);
+    for (unsigned int i = 0; i < contours.size() - 1; ++i)
+    {
+      filter->SetInput(i, contours[i]);
+    }
+    filter->Update();
+    CPPUNIT_ASSERT_EQUAL(0u, filter->GetNumberOfReusedPatches());
+
+    filter->SetInput(contours.size() - 1, contours.back());
+    auto start = std::chrono::high_resolution_clock::now();
+    filter->Update();
+    auto stop = std::chrono::high_resolution_clock::now();
+    const double incrementalDuration = std::chrono::duration<double, std::milli>(stop - start).count();
+
+    DistanceImageType::Pointer incremental;
+    mitk::CastToItkImage(filter->GetOutput(), incremental);
+
+    double completeDuration = 0;
+    DistanceImageType::Pointer complete = Interpolate(contours, 0, completeDuration);
+
+    MITK_INFO << "Adding one contour to " << contours.size() - 1 << " contours: incremental update "
+              << incrementalDuration << " ms (" << filter->GetNumberOfReusedPatches() << " patches and "
+              << filter->GetNumberOfReusedDistanceValues() << " distance values reused), complete update "
+              << completeDuration << " ms";
+
+    CPPUNIT_ASSERT_MESSAGE("No local solution was reused", filter->GetNumberOfReusedPatches() > 0);
+    CPPUNIT_ASSERT_MESSAGE("No distance value was reused", filter->GetNumberOfReusedDistanceValues() > 0);
+    CPPUNIT_ASSERT_MESSAGE("Distance images differ in geometry",
+                           incremental->GetLargestPossibleRegion() == complete->GetLargestPossibleRegion());
+
+    // Reusing the local solutions must not change the result
+    itk::ImageRegionConstIterator<DistanceImageType> incrementalIter(incremental,
+                                                                      incremental->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<DistanceImageType> completeIter(complete, complete->GetLargestPossibleRegion());
+    unsigned int numberOfDifferentValues = 0;
+    for (; !incrementalIter.IsAtEnd(); ++incrementalIter, ++completeIter)
+    {
+      if (incrementalIter.Get() != completeIter.Get())
+        ++numberOfDifferentValues;
+    }
+    CPPUNIT_ASSERT_EQUAL(0u, numberOfDifferentValues);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkCreateDistanceImageFromSurfaceFilterBenchmark)
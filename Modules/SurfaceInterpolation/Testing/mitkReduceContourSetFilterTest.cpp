@@ -26,6 +26,7 @@ class mitkReduceContourSetFilterTestSuite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkReduceContourSetFilterTestSuite);
   MITK_TEST(TestReduceContourWithNthPoint);
   MITK_TEST(TestReduceContourWithDouglasPeuker);
+  MITK_TEST(TestReuseOfReducedContours);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -74,6 +75,32 @@ public:
       "Unequal contours",
       mitk::Equal(*(reducedContour->GetVtkPolyData()), *(reference->GetVtkPolyData()), 0.000001, true));
   }
+
+  // Unchanged contours are not reduced again
+  void TestReuseOfReducedContours()
+  {
+    mitk::Surface::Pointer contour =
+      mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath("SurfaceInterpolation/Reference/SingleContour.vtk"));
+    m_ContourReducer->SetInput(contour);
+    m_ContourReducer->SetReductionType(mitk::ReduceContourSetFilter::NTH_POINT);
+    m_ContourReducer->SetStepSize(20);
+    m_ContourReducer->Update();
+    vtkPolyData *reducedPolyData = m_ContourReducer->GetOutput()->GetVtkPolyData();
+    unsigned int numberOfPoints = m_ContourReducer->GetNumberOfPointsAfterReduction();
+
+    m_ContourReducer->Modified();
+    m_ContourReducer->Update();
+    CPPUNIT_ASSERT_MESSAGE("Unchanged contour was reduced again",
+                           m_ContourReducer->GetOutput()->GetVtkPolyData() == reducedPolyData);
+    CPPUNIT_ASSERT_EQUAL(numberOfPoints, m_ContourReducer->GetNumberOfPointsAfterReduction());
+
+    m_ContourReducer->SetStepSize(10);
+    m_ContourReducer->Update();
+    CPPUNIT_ASSERT_MESSAGE("Contour was not reduced again after the step size changed",
+                           m_ContourReducer->GetOutput()->GetVtkPolyData() != reducedPolyData);
+    CPPUNIT_ASSERT_MESSAGE("Smaller step size did not keep more points",
+                           m_ContourReducer->GetNumberOfPointsAfterReduction() > numberOfPoints);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkReduceContourSetFilter)
@@ -39,6 +39,9 @@ void mitk::ComputeContourSetNormalsFilter::GenerateData()
 {
   unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
 
+  // Only the contours that are still inputs are kept in the cache
+  ContourNormalsMap usedContourNormals;
+
   // Iterating over each input
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
@@ -46,6 +49,20 @@ void mitk::ComputeContourSetNormalsFilter::GenerateData()
     auto *currentSurface = this->GetInput(i);
     vtkPolyData *polyData = currentSurface->GetVtkPolyData();
 
+    // The normals of a contour only depend on its points and polygons. The segmentation image is only
+    // sampled within the contour's plane, where it changes only together with the contour itself.
+    auto cachedNormals = m_ContourNormals.find(polyData);
+    if (cachedNormals != m_ContourNormals.end() && polyData->GetPoints() != nullptr &&
+        cachedNormals->second.PointsMTime == polyData->GetPoints()->GetMTime() &&
+        cachedNormals->second.PolysMTime == polyData->GetPolys()->GetMTime() &&
+        cachedNormals->second.MaxSpacing == m_MaxSpacing &&
+        cachedNormals->second.UsedSegmentationImage == m_SegmentationBinaryImage.IsNotNull())
+    {
+      this->GetOutput(i)->GetVtkPolyData()->GetCellData()->SetNormals(cachedNormals->second.Normals);
+      usedContourNormals.insert(*cachedNormals);
+      continue;
+    }
+
     vtkSmartPointer<vtkCellArray> existingPolys = polyData->GetPolys();
 
     vtkSmartPointer<vtkPoints> existingPoints = polyData->GetPoints();
@@ -242,8 +259,21 @@ void mitk::ComputeContourSetNormalsFilter::GenerateData()
 
     Surface::Pointer surface = this->GetOutput(i);
     surface->GetVtkPolyData()->GetCellData()->SetNormals(normals);
+
+    if (polyData->GetPoints() != nullptr)
+    {
+      ContourNormals &contourNormals = usedContourNormals[polyData];
+      contourNormals.PolyData = polyData;
+      contourNormals.PointsMTime = polyData->GetPoints()->GetMTime();
+      contourNormals.PolysMTime = polyData->GetPolys()->GetMTime();
+      contourNormals.MaxSpacing = m_MaxSpacing;
+      contourNormals.UsedSegmentationImage = m_SegmentationBinaryImage.IsNotNull();
+      contourNormals.Normals = normals;
+    }
   } // end for all inputs
 
+  m_ContourNormals.swap(usedContourNormals);
+
   // Setting progressbar
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(this->m_ProgressStepSize);
@@ -32,6 +32,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkImage.h"
 
+#include <map>
+
 namespace mitk
 {
   /**
@@ -49,6 +51,9 @@ namespace mitk
    Note: If a segmentation binary image is provided this filter assures that the computed normals
          do not point into the segmentation image
 
+   The normals of every input contour are cached and reused as long as the points and polygons of
+   the contour do not change, so that only new or modified contours are processed by an update.
+
    $Author: fetzer$
 */
   class MITKSURFACEINTERPOLATION_EXPORT ComputeContourSetNormalsFilter : public SurfaceToSurfaceFilter
@@ -89,6 +94,20 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
+    /** \brief The normals computed for one input contour */
+    struct ContourNormals
+    {
+      vtkSmartPointer<vtkPolyData> PolyData;
+      vtkMTimeType PointsMTime;
+      vtkMTimeType PolysMTime;
+      double MaxSpacing;
+      bool UsedSegmentationImage;
+      vtkSmartPointer<vtkDoubleArray> Normals;
+    };
+    typedef std::map<const vtkPolyData *, ContourNormals> ContourNormalsMap;
+
+    ContourNormalsMap m_ContourNormals;
+
     // The segmentation out of which the contours were extracted. Can be used to determine the direction of the normals
     mitk::Image::Pointer m_SegmentationBinaryImage;
     double m_MaxSpacing;
@@ -26,7 +26,42 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkNeighborhoodIterator.h"
 
+#include <array>
+#include <cmath>
+#include <numeric>
 #include <queue>
+#include <set>
+
+namespace
+{
+  /**
+  * Wendland's compactly supported C2 function, used to blend the patches of the partition of unity.
+  * r is the distance to the patch center relative to the patch radius.
+  */
+  inline double WendlandWeight(double r)
+  {
+    if (r >= 1.0)
+      return 0.0;
+    const double t = 1.0 - r;
+    return t * t * t * t * (4.0 * r + 1.0);
+  }
+
+  template <class TPoint>
+  inline double SquaredDistanceToBox(const TPoint &p, const TPoint &minimum, const TPoint &maximum)
+  {
+    double distance = 0.0;
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      double delta = 0.0;
+      if (p[dim] < minimum[dim])
+        delta = minimum[dim] - p[dim];
+      else if (p[dim] > maximum[dim])
+        delta = p[dim] - maximum[dim];
+      distance += delta * delta;
+    }
+    return distance;
+  }
+}
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 {
@@ -109,9 +144,15 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 }
 
 mitk::CreateDistanceImageFromSurfaceFilter::CreateDistanceImageFromSurfaceFilter()
-  : m_DistanceImageSpacing(0.0), m_DistanceImageDefaultBufferValue(0.0)
+  : m_ReusePreviousDistanceValues(false),
+    m_NumberOfReusedPatches(0),
+    m_NumberOfReusedDistanceValues(0),
+    m_DistanceImageSpacing(0.0),
+    m_DistanceImageDefaultBufferValue(0.0)
 {
   m_DistanceImageVolume = 50000;
+  m_MaximumNumberOfCentersForDirectSolution = 3000;
+  m_NumberOfCentersPerPatch = 50;
   this->m_UseProgressBar = false;
   this->m_ProgressStepSize = 5;
 
@@ -125,19 +166,41 @@ mitk::CreateDistanceImageFromSurfaceFilter::~CreateDistanceImageFromSurfaceFilte
 
 void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 {
+  m_NumberOfReusedPatches = 0;
+  m_NumberOfReusedDistanceValues = 0;
+
   this->PreprocessContourPoints();
   this->CreateEmptyDistanceImage();
 
-  // First of all we have to build the equation-system from the existing contour-edge-points
-  this->CreateSolutionMatrixAndFunctionValues();
+  if (m_Centers.size() > m_MaximumNumberOfCentersForDirectSolution)
+  {
+    // One global equation system would be too large, so the distance function
+    // is assembled from local interpolants (partition of unity)
+    this->ReduceContourPoints();
+    this->CreateInnerAndOuterPoints();
 
-  if (this->m_UseProgressBar)
-    mitk::ProgressBar::GetInstance()->Progress(1);
+    if (this->m_UseProgressBar)
+      mitk::ProgressBar::GetInstance()->Progress(1);
 
-  m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+    this->CreatePatchesAndSolveLocalSystems();
 
-  if (this->m_UseProgressBar)
-    mitk::ProgressBar::GetInstance()->Progress(2);
+    if (this->m_UseProgressBar)
+      mitk::ProgressBar::GetInstance()->Progress(2);
+  }
+  else
+  {
+    // First of all we have to build the equation-system from the existing contour-edge-points
+    this->CreateInnerAndOuterPoints();
+    this->CreateSolutionMatrixAndFunctionValues();
+
+    if (this->m_UseProgressBar)
+      mitk::ProgressBar::GetInstance()->Progress(1);
+
+    m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+
+    if (this->m_UseProgressBar)
+      mitk::ProgressBar::GetInstance()->Progress(2);
+  }
 
   // The last step is to create the distance map with the interpolated distance function
   this->FillDistanceImage();
@@ -145,8 +208,22 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(2);
 
+  // The local solutions and the distance values can be reused by the next update
+  if (!m_Patches.empty())
+  {
+    m_PreviousDistanceImageITK = m_DistanceImageITK;
+  }
+  else
+  {
+    m_PreviousPatches.clear();
+    m_PreviousLeafPatches.clear();
+    m_PreviousDistanceImageITK = nullptr;
+  }
+
   m_Centers.clear();
   m_Normals.clear();
+  m_Patches.clear();
+  m_PatchTree.clear();
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
@@ -172,6 +249,9 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   PointType currentPoint;
   PointType normal;
 
+  // Lookup of the points that have already been added, searching m_Centers would be quadratic
+  std::set<std::array<double, 3>> existingCenters;
+
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
     auto currentSurface = this->GetInput(i);
@@ -203,9 +283,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
         currentPoint.copy_in(p);
 
-        int count = std::count(m_Centers.begin(), m_Centers.end(), currentPoint);
-
-        if (count == 0)
+        if (existingCenters.insert({{p[0], p[1], p[2]}}).second)
         {
           double currentNormal[3];
           currentCellNormals->GetTuple(cell[j], currentNormal);
@@ -222,7 +300,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   }     // end for all outputs
 }
 
-void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunctionValues()
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateInnerAndOuterPoints()
 {
   // For we can now calculate the exact size of the centers we initialize the data structures
   unsigned int numberOfCenters = m_Centers.size();
@@ -264,9 +342,12 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
 
     m_FunctionValues[numberOfCenters * 2 + i] = m_DistanceImageSpacing;
   }
+}
 
-  // Now we have created all centers and all function values. Next step is to create the solution matrix
-  numberOfCenters = m_Centers.size();
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunctionValues()
+{
+  // All centers and all function values have been created. Next step is to create the solution matrix
+  unsigned int numberOfCenters = m_Centers.size();
 
   m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
 
@@ -326,6 +407,14 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   narrowbandPoints.push(currentIndex);
   m_DistanceImageITK->SetPixel(currentIndex, distance);
 
+  // The previous distance image can only be used if the new one has the same geometry
+  m_ReusePreviousDistanceValues =
+    !m_Patches.empty() && m_PreviousDistanceImageITK.IsNotNull() &&
+    m_PreviousDistanceImageITK->GetLargestPossibleRegion() == m_DistanceImageITK->GetLargestPossibleRegion() &&
+    m_PreviousDistanceImageITK->GetOrigin() == m_DistanceImageITK->GetOrigin() &&
+    m_PreviousDistanceImageITK->GetSpacing() == m_DistanceImageITK->GetSpacing() &&
+    m_PreviousDistanceImageITK->GetDirection() == m_DistanceImageITK->GetDirection();
+
   NeighborhoodImageIterator::RadiusType radius;
   radius.Fill(1);
   NeighborhoodImageIterator nIt(radius, m_DistanceImageITK, m_DistanceImageITK->GetLargestPossibleRegion());
@@ -355,7 +444,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
         currentPoint[2] = currentPointAsPoint[2];
 
         // and check the distance
-        distance = this->CalculateDistanceValue(currentPoint);
+        distance = this->CalculateDistanceValue(currentIndex, currentPoint);
         if (std::fabs(distance) <= m_DistanceImageSpacing * 2)
         {
           nIt.SetPixel(*relativeNb, distance);
@@ -423,8 +512,30 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   CastToMitkImage(m_DistanceImageITK, resultImage);
 }
 
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(const IndexType &index, const PointType &p)
+{
+  // Values of the narrow band of the previous distance image are exact as long as the leaf is unchanged
+  if (m_ReusePreviousDistanceValues)
+  {
+    const PatchTreeNode *leaf = this->FindPatchTreeLeaf(p);
+    if (leaf != nullptr && leaf->Unchanged)
+    {
+      const double previousDistance = m_PreviousDistanceImageITK->GetPixel(index);
+      if (std::fabs(previousDistance) <= m_DistanceImageSpacing * 2)
+      {
+        ++m_NumberOfReusedDistanceValues;
+        return previousDistance;
+      }
+    }
+  }
+  return this->CalculateDistanceValue(p);
+}
+
 double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p)
 {
+  if (!m_Patches.empty())
+    return this->CalculatePatchDistanceValue(p);
+
   double distanceValue(0);
   PointType p1;
   PointType p2;
@@ -444,6 +555,351 @@ double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointT
   return distanceValue;
 }
 
+void mitk::CreateDistanceImageFromSurfaceFilter::ReduceContourPoints()
+{
+  // Points that are closer than half a voxel of the distance image add no information
+  // to the interpolation, but make the local equation systems ill-conditioned
+  const double cellSize = 0.5 * m_DistanceImageSpacing;
+
+  std::set<std::array<long long, 3>> occupiedCells;
+  CenterList reducedCenters;
+  NormalList reducedNormals;
+  reducedCenters.reserve(m_Centers.size());
+  reducedNormals.reserve(m_Normals.size());
+
+  for (unsigned int i = 0; i < m_Centers.size(); ++i)
+  {
+    const PointType &center = m_Centers[i];
+    std::array<long long, 3> cell = {{static_cast<long long>(std::floor(center[0] / cellSize)),
+                                      static_cast<long long>(std::floor(center[1] / cellSize)),
+                                      static_cast<long long>(std::floor(center[2] / cellSize))}};
+    if (occupiedCells.insert(cell).second)
+    {
+      reducedCenters.push_back(center);
+      reducedNormals.push_back(m_Normals[i]);
+    }
+  }
+
+  m_Centers.swap(reducedCenters);
+  m_Normals.swap(reducedNormals);
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::CreatePatchesAndSolveLocalSystems()
+{
+  // The first third of the centers are the contour points, followed by the inner and the outer points
+  const unsigned int numberOfPoints = m_Centers.size() / 3;
+
+  m_Patches.clear();
+  m_PatchTree.clear();
+
+  // The root node encloses the reference image, all centers and the margin that is added around them
+  // in the distance image. As long as it does not change, contours that are added or removed only
+  // change the octree in their neighbourhood, which allows to reuse the other local solutions.
+  PatchTreeNode root;
+  root.Code = 1;
+  root.FirstChild = -1;
+  root.Unchanged = false;
+  root.Minimum = m_Centers.front();
+  root.Maximum = m_Centers.front();
+  for (const auto &center : m_Centers)
+  {
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      root.Minimum[dim] = std::min(root.Minimum[dim], center[dim]);
+      root.Maximum[dim] = std::max(root.Maximum[dim], center[dim]);
+    }
+  }
+  if (m_ReferenceImage.IsNotNull())
+  {
+    const DistanceImageType::RegionType region = m_ReferenceImage->GetLargestPossibleRegion();
+    for (unsigned int corner = 0; corner < 8; ++corner)
+    {
+      itk::ContinuousIndex<double, 3> cornerIndex;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        cornerIndex[dim] = ((corner >> dim) & 1) != 0 ? region.GetIndex()[dim] + region.GetSize()[dim] - 0.5
+                                                       : region.GetIndex()[dim] - 0.5;
+      }
+      DistanceImageType::PointType cornerPoint;
+      m_ReferenceImage->TransformContinuousIndexToPhysicalPoint(cornerIndex, cornerPoint);
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        root.Minimum[dim] = std::min(root.Minimum[dim], cornerPoint[dim]);
+        root.Maximum[dim] = std::max(root.Maximum[dim], cornerPoint[dim]);
+      }
+    }
+  }
+  const double margin = 8 * m_DistanceImageSpacing;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    root.Minimum[dim] -= margin;
+    root.Maximum[dim] += margin;
+  }
+  root.Points.resize(numberOfPoints);
+  std::iota(root.Points.begin(), root.Points.end(), 0);
+  m_PatchTree.push_back(root);
+
+  // Subdivide every node that holds more points than wanted for one patch. Children are
+  // appended to the tree, so iterating over the indices visits them as well. The depth is
+  // limited by the number of bits of the location code.
+  const unsigned int maximumPointsPerLeaf = std::max(m_NumberOfCentersPerPatch, 1u);
+  const unsigned long long maximumCode = 1ull << 60;
+  for (std::size_t nodeIndex = 0; nodeIndex < m_PatchTree.size(); ++nodeIndex)
+  {
+    const PointType minimum = m_PatchTree[nodeIndex].Minimum;
+    const PointType maximum = m_PatchTree[nodeIndex].Maximum;
+    if (m_PatchTree[nodeIndex].Points.size() <= maximumPointsPerLeaf ||
+        (maximum - minimum).two_norm() < 2 * m_DistanceImageSpacing || m_PatchTree[nodeIndex].Code >= maximumCode)
+    {
+      continue;
+    }
+
+    const PointType middle = (minimum + maximum) * 0.5;
+    std::vector<unsigned int> points;
+    points.swap(m_PatchTree[nodeIndex].Points);
+    const int firstChild = static_cast<int>(m_PatchTree.size());
+    m_PatchTree[nodeIndex].FirstChild = firstChild;
+    const unsigned long long parentCode = m_PatchTree[nodeIndex].Code;
+
+    for (unsigned int octant = 0; octant < 8; ++octant)
+    {
+      PatchTreeNode child;
+      child.Code = (parentCode << 3) | octant;
+      child.FirstChild = -1;
+      child.Unchanged = false;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        const bool upper = ((octant >> dim) & 1) != 0;
+        child.Minimum[dim] = upper ? middle[dim] : minimum[dim];
+        child.Maximum[dim] = upper ? maximum[dim] : middle[dim];
+      }
+      m_PatchTree.push_back(child);
+    }
+
+    for (auto pointIndex : points)
+    {
+      unsigned int octant = 0;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        if (m_Centers[pointIndex][dim] >= middle[dim])
+          octant |= 1u << dim;
+      }
+      m_PatchTree[firstChild + octant].Points.push_back(pointIndex);
+    }
+  }
+
+  // Every leaf defines one patch. Its support is the sphere around the leaf, which overlaps the
+  // neighbouring leaves. Leaves with only a few points (e.g. between two contours) get a larger
+  // support until the local interpolant is determined by enough points.
+  const unsigned int minimumPointsPerPatch =
+    std::min(numberOfPoints, std::max(maximumPointsPerLeaf / 4, 10u));
+  const double overlap = 1.1;
+  std::vector<unsigned int> patchPoints;
+
+  for (std::size_t nodeIndex = 0; nodeIndex < m_PatchTree.size(); ++nodeIndex)
+  {
+    const PatchTreeNode &node = m_PatchTree[nodeIndex];
+    if (node.FirstChild != -1)
+      continue;
+
+    RBFPatch patch;
+    patch.Code = node.Code;
+    patch.Reused = false;
+    patch.Center = (node.Minimum + node.Maximum) * 0.5;
+    patch.Radius = overlap * 0.5 * (node.Maximum - node.Minimum).two_norm();
+    this->CollectPointsInSphere(patch.Center, patch.Radius, patchPoints);
+    while (patchPoints.size() < minimumPointsPerPatch)
+    {
+      patch.Radius *= 1.5;
+      this->CollectPointsInSphere(patch.Center, patch.Radius, patchPoints);
+    }
+
+    // Local equation system with the same basis function as the global one
+    const unsigned int numberOfLocalPoints = patchPoints.size();
+    patch.Centers.resize(numberOfLocalPoints * 3);
+    Eigen::VectorXd functionValues(numberOfLocalPoints * 3);
+    for (unsigned int i = 0; i < numberOfLocalPoints; ++i)
+    {
+      for (unsigned int offset = 0; offset < 3; ++offset)
+      {
+        const unsigned int globalIndex = patchPoints[i] + offset * numberOfPoints;
+        patch.Centers[i + offset * numberOfLocalPoints] = m_Centers[globalIndex];
+        functionValues[i + offset * numberOfLocalPoints] = m_FunctionValues[globalIndex];
+      }
+    }
+
+    // A patch with the same support and the same centers as in the last update has the same solution.
+    // The function values are determined by the centers and the spacing, which is part of the centers.
+    auto previousPatch = m_PreviousPatches.find(patch.Code);
+    if (previousPatch != m_PreviousPatches.end() && previousPatch->second.Center == patch.Center &&
+        previousPatch->second.Radius == patch.Radius && previousPatch->second.Centers == patch.Centers)
+    {
+      patch.Weights = previousPatch->second.Weights;
+      patch.Reused = true;
+      ++m_NumberOfReusedPatches;
+    }
+    else
+    {
+      const unsigned int numberOfLocalCenters = patch.Centers.size();
+      Eigen::MatrixXd solutionMatrix(numberOfLocalCenters, numberOfLocalCenters);
+      for (unsigned int i = 0; i < numberOfLocalCenters; ++i)
+      {
+        for (unsigned int j = 0; j < numberOfLocalCenters; ++j)
+        {
+          solutionMatrix(i, j) = (patch.Centers[i] - patch.Centers[j]).two_norm();
+        }
+      }
+      patch.Weights = solutionMatrix.partialPivLu().solve(functionValues);
+    }
+
+    m_Patches.push_back(patch);
+  }
+
+  // Register every patch at the leaves its support overlaps, so that the evaluation
+  // only has to look at the patches of the leaf that contains the evaluated point
+  std::vector<std::size_t> nodeStack;
+  for (unsigned int patchIndex = 0; patchIndex < m_Patches.size(); ++patchIndex)
+  {
+    const RBFPatch &patch = m_Patches[patchIndex];
+    const double squaredRadius = patch.Radius * patch.Radius;
+
+    nodeStack.assign(1, 0);
+    while (!nodeStack.empty())
+    {
+      PatchTreeNode &node = m_PatchTree[nodeStack.back()];
+      nodeStack.pop_back();
+
+      if (SquaredDistanceToBox(patch.Center, node.Minimum, node.Maximum) >= squaredRadius)
+        continue;
+
+      if (node.FirstChild == -1)
+      {
+        node.Patches.push_back(patchIndex);
+      }
+      else
+      {
+        for (int child = 0; child < 8; ++child)
+          nodeStack.push_back(node.FirstChild + child);
+      }
+    }
+  }
+
+  // A leaf yields the same distance values as in the last update if it is covered by the same patches
+  // and none of them has been solved again
+  std::map<unsigned long long, std::vector<unsigned long long>> leafPatches;
+  for (auto &node : m_PatchTree)
+  {
+    if (node.FirstChild != -1)
+      continue;
+
+    std::vector<unsigned long long> &patchCodes = leafPatches[node.Code];
+    bool allPatchesReused = true;
+    for (auto patchIndex : node.Patches)
+    {
+      patchCodes.push_back(m_Patches[patchIndex].Code);
+      allPatchesReused = allPatchesReused && m_Patches[patchIndex].Reused;
+    }
+
+    auto previousLeaf = m_PreviousLeafPatches.find(node.Code);
+    node.Unchanged = allPatchesReused && previousLeaf != m_PreviousLeafPatches.end() && previousLeaf->second == patchCodes;
+  }
+
+  m_PreviousLeafPatches.swap(leafPatches);
+  m_PreviousPatches.clear();
+  for (const auto &patch : m_Patches)
+  {
+    m_PreviousPatches[patch.Code] = patch;
+  }
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::CollectPointsInSphere(const PointType &center,
+                                                                        double radius,
+                                                                        std::vector<unsigned int> &points) const
+{
+  points.clear();
+  const double squaredRadius = radius * radius;
+
+  std::vector<std::size_t> nodeStack(1, 0);
+  while (!nodeStack.empty())
+  {
+    const PatchTreeNode &node = m_PatchTree[nodeStack.back()];
+    nodeStack.pop_back();
+
+    if (SquaredDistanceToBox(center, node.Minimum, node.Maximum) > squaredRadius)
+      continue;
+
+    if (node.FirstChild == -1)
+    {
+      for (auto pointIndex : node.Points)
+      {
+        const PointType delta = m_Centers[pointIndex] - center;
+        if (delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2] <= squaredRadius)
+          points.push_back(pointIndex);
+      }
+    }
+    else
+    {
+      for (int child = 0; child < 8; ++child)
+        nodeStack.push_back(node.FirstChild + child);
+    }
+  }
+}
+
+const mitk::CreateDistanceImageFromSurfaceFilter::PatchTreeNode *
+  mitk::CreateDistanceImageFromSurfaceFilter::FindPatchTreeLeaf(const PointType &p) const
+{
+  const PatchTreeNode *node = &m_PatchTree.front();
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    if (p[dim] < node->Minimum[dim] || p[dim] > node->Maximum[dim])
+      return nullptr;
+  }
+
+  // Descend to the leaf that contains the point, using the same octant rule as the subdivision
+  while (node->FirstChild != -1)
+  {
+    unsigned int octant = 0;
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      if (p[dim] >= 0.5 * (node->Minimum[dim] + node->Maximum[dim]))
+        octant |= 1u << dim;
+    }
+    node = &m_PatchTree[node->FirstChild + octant];
+  }
+  return node;
+}
+
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculatePatchDistanceValue(const PointType &p) const
+{
+  const PatchTreeNode *node = this->FindPatchTreeLeaf(p);
+  if (node == nullptr)
+    return m_DistanceImageDefaultBufferValue;
+
+  double weightedDistance = 0.0;
+  double weightSum = 0.0;
+  for (auto patchIndex : node->Patches)
+  {
+    const RBFPatch &patch = m_Patches[patchIndex];
+    const double weight = WendlandWeight((p - patch.Center).two_norm() / patch.Radius);
+    if (weight <= 0.0)
+      continue;
+
+    double distanceValue = 0.0;
+    for (unsigned int i = 0; i < patch.Centers.size(); ++i)
+    {
+      distanceValue += (p - patch.Centers[i]).two_norm() * patch.Weights[i];
+    }
+    weightedDistance += weight * distanceValue;
+    weightSum += weight;
+  }
+
+  // Points that are not covered by any patch are far away from all contours
+  if (weightSum <= 0.0)
+    return m_DistanceImageDefaultBufferValue;
+
+  return weightedDistance / weightSum;
+}
+
 void mitk::CreateDistanceImageFromSurfaceFilter::GenerateOutputInformation()
 {
 }
@@ -29,6 +29,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <Eigen/Dense>
 
+#include <map>
+
 namespace mitk
 {
   /**
@@ -61,6 +63,19 @@ namespace mitk
          adjusted by calling SetDistanceImageVolume(unsigned int volume) which specifies the number ob pixels enclosed
   by the image.
 
+         Up to GetMaximumNumberOfCentersForDirectSolution() contour points the weights of the radial basis functions
+         are determined by solving one dense equation system for all points. For larger point sets this becomes too
+         expensive (cubic time and quadratic memory), so the points are first reduced to at most one point per half
+         distance image voxel and the domain is decomposed by an octree into overlapping spherical patches
+         (partition of unity). A small dense system is solved for the points of each patch and the local
+         interpolants are blended with compactly supported Wendland weights. A distance value is then evaluated
+         from the few patches that cover the octree leaf containing the point instead of from all points.
+
+         The octree is spanned over the reference image, so adding or removing a contour only changes the leaves
+         around it. The local solutions are kept between two updates and a patch is only solved again if its
+         points have changed. If the distance image keeps its geometry, the distance values of all leaves whose
+         patches are unchanged are taken from the previous distance image as well. Reset() keeps these caches.
+
   \ingroup Process
 
   $Author: fetzer$
@@ -103,6 +118,27 @@ namespace mitk
     */
     itkSetMacro(DistanceImageVolume, unsigned int);
 
+    /**
+    \brief Set the number of contour points up to which one global equation system is solved.
+           Larger point sets are interpolated with the partition of unity approach described above.
+           Default is 3000.
+    */
+    itkSetMacro(MaximumNumberOfCentersForDirectSolution, unsigned int);
+    itkGetConstMacro(MaximumNumberOfCentersForDirectSolution, unsigned int);
+
+    /**
+    \brief Set the number of contour points that is aimed at for each patch of the partition of unity.
+           Octree cells with more points are subdivided. Default is 50.
+    */
+    itkSetMacro(NumberOfCentersPerPatch, unsigned int);
+    itkGetConstMacro(NumberOfCentersPerPatch, unsigned int);
+
+    /** \brief Number of patches whose local solution was reused by the last update */
+    itkGetConstMacro(NumberOfReusedPatches, unsigned int);
+
+    /** \brief Number of distance values that were taken from the previous distance image by the last update */
+    itkGetConstMacro(NumberOfReusedDistanceValues, unsigned int);
+
     void PrintEquationSystem();
 
     // Resets the filter, i.e. removes all inputs and outputs
@@ -131,8 +167,48 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
+    /** \brief A local interpolant of the partition of unity */
+    struct RBFPatch
+    {
+      // Location code of the octree leaf the patch belongs to
+      unsigned long long Code;
+      PointType Center;
+      double Radius;
+      CenterList Centers;
+      Eigen::VectorXd Weights;
+      // True if the solution was taken over from the last update
+      bool Reused;
+    };
+
+    /** \brief Node of the octree that defines the patches and is used to look them up */
+    struct PatchTreeNode
+    {
+      // Location code: 1 for the root, (parent code << 3) | octant for the children
+      unsigned long long Code;
+      PointType Minimum;
+      PointType Maximum;
+      // Index of the first of the eight children, -1 for leaves
+      int FirstChild;
+      // Indices of the contour points inside the node (leaves only)
+      std::vector<unsigned int> Points;
+      // Indices of the patches whose support overlaps the node (leaves only)
+      std::vector<unsigned int> Patches;
+      // True if the leaf is covered by the same patches as in the last update
+      bool Unchanged;
+    };
+
+    void CreateInnerAndOuterPoints();
     void CreateSolutionMatrixAndFunctionValues();
     double CalculateDistanceValue(PointType p);
+    double CalculateDistanceValue(const IndexType &index, const PointType &p);
+
+    /** \brief Keeps at most one contour point per cell of half the distance image spacing */
+    void ReduceContourPoints();
+    /** \brief Builds the octree, the patches and solves the local equation systems */
+    void CreatePatchesAndSolveLocalSystems();
+    void CollectPointsInSphere(const PointType &center, double radius, std::vector<unsigned int> &points) const;
+    double CalculatePatchDistanceValue(const PointType &p) const;
+    const PatchTreeNode *FindPatchTreeLeaf(const PointType &p) const;
 
     void FillDistanceImage();
 
@@ -166,12 +242,25 @@ namespace mitk
     Eigen::VectorXd m_FunctionValues;
     Eigen::VectorXd m_Weights;
 
+    std::vector<RBFPatch> m_Patches;
+    std::vector<PatchTreeNode> m_PatchTree;
+
+    // Results of the last update that are reused by the next one
+    std::map<unsigned long long, RBFPatch> m_PreviousPatches;
+    std::map<unsigned long long, std::vector<unsigned long long>> m_PreviousLeafPatches;
+    DistanceImageType::Pointer m_PreviousDistanceImageITK;
+    bool m_ReusePreviousDistanceValues;
+    unsigned int m_NumberOfReusedPatches;
+    unsigned int m_NumberOfReusedDistanceValues;
+
     DistanceImageType::Pointer m_DistanceImageITK;
     itk::ImageBase<3>::Pointer m_ReferenceImage;
 
     double m_DistanceImageSpacing;
     double m_DistanceImageDefaultBufferValue;
     unsigned int m_DistanceImageVolume;
+    unsigned int m_MaximumNumberOfCentersForDirectSolution;
+    unsigned int m_NumberOfCentersPerPatch;
 
     bool m_UseProgressBar;
     unsigned int m_ProgressStepSize;
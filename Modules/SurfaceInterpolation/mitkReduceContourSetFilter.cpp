@@ -60,15 +60,14 @@ void mitk::ReduceContourSetFilter::GenerateData()
   //  unsigned int numberOfPointsBefore (0);
   m_NumberOfPointsAfterReduction = 0;
 
+  // Only the contours that are still inputs are kept in the cache
+  ReducedContourMap usedReducedContours;
+
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
     auto *currentSurface = this->GetInput(i);
     vtkSmartPointer<vtkPolyData> polyData = currentSurface->GetVtkPolyData();
 
-    newPolyData = vtkSmartPointer<vtkPolyData>::New();
-    newPolygons = vtkSmartPointer<vtkCellArray>::New();
-    newPoints = vtkSmartPointer<vtkPoints>::New();
-
     vtkSmartPointer<vtkCellArray> existingPolys = polyData->GetPolys();
 
     vtkSmartPointer<vtkPoints> existingPoints = polyData->GetPoints();
@@ -78,43 +77,83 @@ void mitk::ReduceContourSetFilter::GenerateData()
     vtkIdType *cell(nullptr);
     vtkIdType cellSize(0);
 
+    // The intersection test depends on all other contours, so it is always done. Whether a
+    // polygon is incorporated is part of the cache key of the reduced contour.
+    std::vector<bool> incorporatedPolygons;
     for (existingPolys->InitTraversal(); existingPolys->GetNextCell(cellSize, cell);)
     {
-      bool incorporatePolygon =
-        this->CheckForIntersection(cell, cellSize, existingPoints, /*numberOfIntersections, intersectionPoints, */ i);
-      if (!incorporatePolygon)
-        continue;
+      incorporatedPolygons.push_back(
+        this->CheckForIntersection(cell, cellSize, existingPoints, /*numberOfIntersections, intersectionPoints, */ i));
+    }
 
-      vtkSmartPointer<vtkPolygon> newPolygon = vtkSmartPointer<vtkPolygon>::New();
+    auto cachedContour = m_ReducedContours.find(currentSurface);
+    if (cachedContour != m_ReducedContours.end() && cachedContour->second.InputPolyData == polyData &&
+        cachedContour->second.InputMTime == polyData->GetMTime() &&
+        cachedContour->second.IncorporatedPolygons == incorporatedPolygons &&
+        cachedContour->second.Parameters == this->GetReductionParameters())
+    {
+      // The contour has not changed since the last update
+      newPolyData = cachedContour->second.ReducedPolyData;
+      m_NumberOfPointsAfterReduction += cachedContour->second.NumberOfPointsAfterReduction;
+      usedReducedContours.insert(*cachedContour);
+    }
+    else
+    {
+      newPolyData = vtkSmartPointer<vtkPolyData>::New();
+      newPolygons = vtkSmartPointer<vtkCellArray>::New();
+      newPoints = vtkSmartPointer<vtkPoints>::New();
 
-      if (m_ReductionType == NTH_POINT)
+      unsigned int numberOfPointsAfterReduction(0);
+      unsigned int polygonIndex(0);
+      for (existingPolys->InitTraversal(); existingPolys->GetNextCell(cellSize, cell); ++polygonIndex)
       {
-        this->ReduceNumberOfPointsByNthPoint(cellSize, cell, existingPoints, newPolygon, newPoints);
-        if (newPolygon->GetPointIds()->GetNumberOfIds() != 0)
+        if (!incorporatedPolygons[polygonIndex])
+          continue;
+
+        vtkSmartPointer<vtkPolygon> newPolygon = vtkSmartPointer<vtkPolygon>::New();
+
+        if (m_ReductionType == NTH_POINT)
         {
-          newPolygons->InsertNextCell(newPolygon);
+          this->ReduceNumberOfPointsByNthPoint(cellSize, cell, existingPoints, newPolygon, newPoints);
+          if (newPolygon->GetPointIds()->GetNumberOfIds() != 0)
+          {
+            newPolygons->InsertNextCell(newPolygon);
+          }
         }
-      }
-      else if (m_ReductionType == DOUGLAS_PEUCKER)
-      {
-        this->ReduceNumberOfPointsByDouglasPeucker(cellSize, cell, existingPoints, newPolygon, newPoints);
-        if (newPolygon->GetPointIds()->GetNumberOfIds() > 3)
+        else if (m_ReductionType == DOUGLAS_PEUCKER)
         {
-          newPolygons->InsertNextCell(newPolygon);
+          this->ReduceNumberOfPointsByDouglasPeucker(cellSize, cell, existingPoints, newPolygon, newPoints);
+          if (newPolygon->GetPointIds()->GetNumberOfIds() > 3)
+          {
+            newPolygons->InsertNextCell(newPolygon);
+          }
         }
+
+        // Again for evaluation
+        //      numberOfPointsBefore += cellSize;
+        numberOfPointsAfterReduction += newPolygon->GetPointIds()->GetNumberOfIds();
       }
 
-      // Again for evaluation
-      //      numberOfPointsBefore += cellSize;
-      m_NumberOfPointsAfterReduction += newPolygon->GetPointIds()->GetNumberOfIds();
+      if (newPolygons->GetNumberOfCells() != 0)
+      {
+        newPolyData->SetPolys(newPolygons);
+        newPolyData->SetPoints(newPoints);
+        newPolyData->BuildLinks();
+      }
+      m_NumberOfPointsAfterReduction += numberOfPointsAfterReduction;
+
+      ReducedContour &reducedContour = usedReducedContours[currentSurface];
+      reducedContour.Input = currentSurface;
+      reducedContour.InputPolyData = polyData;
+      reducedContour.InputMTime = polyData->GetMTime();
+      reducedContour.IncorporatedPolygons = incorporatedPolygons;
+      reducedContour.Parameters = this->GetReductionParameters();
+      reducedContour.ReducedPolyData = newPolyData;
+      reducedContour.NumberOfPointsAfterReduction = numberOfPointsAfterReduction;
     }
 
-    if (newPolygons->GetNumberOfCells() != 0)
+    if (newPolyData->GetNumberOfPolys() != 0)
     {
-      newPolyData->SetPolys(newPolygons);
-      newPolyData->SetPoints(newPoints);
-      newPolyData->BuildLinks();
-
       this->SetNumberOfIndexedOutputs(numberOfOutputs + 1);
       mitk::Surface::Pointer surface = mitk::Surface::New();
       this->SetNthOutput(numberOfOutputs, surface.GetPointer());
@@ -123,6 +162,8 @@ void mitk::ReduceContourSetFilter::GenerateData()
     }
   }
 
+  m_ReducedContours.swap(usedReducedContours);
+
   //  MITK_INFO<<"Points before: "<<numberOfPointsBefore<<" ##### Points after: "<<numberOfPointsAfter;
   this->SetNumberOfIndexedOutputs(numberOfOutputs);
 
@@ -137,6 +178,13 @@ void mitk::ReduceContourSetFilter::GenerateData()
     mitk::ProgressBar::GetInstance()->Progress(this->m_ProgressStepSize);
 }
 
+std::vector<double> mitk::ReduceContourSetFilter::GetReductionParameters() const
+{
+  std::vector<double> parameters = {
+    static_cast<double>(m_ReductionType), static_cast<double>(m_StepSize), m_Tolerance, m_MinSpacing, m_MaxSpacing};
+  return parameters;
+}
+
 void mitk::ReduceContourSetFilter::ReduceNumberOfPointsByNthPoint(
   vtkIdType cellSize, vtkIdType *cell, vtkPoints *points, vtkPolygon *reducedPolygon, vtkPoints *reducedPoints)
 {
@@ -505,6 +553,9 @@ void mitk::ReduceContourSetFilter::Reset()
   this->SetNumberOfIndexedInputs(0);
   this->SetNumberOfIndexedOutputs(0);
 
+  // The reduced contours are kept, so that the contours which are set again afterwards are not reduced again.
+  // Contours which are not set again are removed from the cache by the next update.
+
   // BUG XXXXX Fix
   mitk::Surface::Pointer output = mitk::Surface::New();
   this->SetNthOutput(0, output.GetPointer());
@@ -29,7 +29,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkPolygon.h"
 #include "vtkSmartPointer.h"
 
+#include <map>
 #include <stack>
+#include <vector>
 
 namespace mitk
 {
@@ -50,6 +52,10 @@ namespace mitk
 
     The output is a mitk::Surface.
 
+    The reduced contour of every input is cached. As long as an input surface, its polygons that survive the
+    intersection test and the reduction parameters do not change, the reduced contour of the last update is
+    reused. Adding a single contour to a large contour set therefore only reduces the new contour.
+
     $Author: fetzer$
   */
 
@@ -107,6 +113,21 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
+    /** \brief The reduction result of one input contour */
+    struct ReducedContour
+    {
+      Surface::ConstPointer Input;
+      vtkSmartPointer<vtkPolyData> InputPolyData;
+      vtkMTimeType InputMTime;
+      std::vector<bool> IncorporatedPolygons;
+      std::vector<double> Parameters;
+      vtkSmartPointer<vtkPolyData> ReducedPolyData;
+      unsigned int NumberOfPointsAfterReduction;
+    };
+    typedef std::map<const Surface *, ReducedContour> ReducedContourMap;
+
+    std::vector<double> GetReductionParameters() const;
+
     void ReduceNumberOfPointsByNthPoint(
       vtkIdType cellSize, vtkIdType *cell, vtkPoints *points, vtkPolygon *reducedPolygon, vtkPoints *reducedPoints);
 
@@ -132,6 +153,8 @@ namespace mitk
 
     unsigned int m_NumberOfPointsAfterReduction;
 
+    ReducedContourMap m_ReducedContours;
+
   }; // class
 
 } // namespace
@@ -363,6 +363,16 @@ void mitk::SurfaceInterpolationController::SetDistanceImageVolume(unsigned int d
   m_InterpolateSurfaceFilter->SetDistanceImageVolume(distImgVolume);
 }
 
+void mitk::SurfaceInterpolationController::SetMaximumNumberOfCentersForDirectSolution(unsigned int numberOfCenters)
+{
+  m_InterpolateSurfaceFilter->SetMaximumNumberOfCentersForDirectSolution(numberOfCenters);
+}
+
+unsigned int mitk::SurfaceInterpolationController::GetMaximumNumberOfCentersForDirectSolution() const
+{
+  return m_InterpolateSurfaceFilter->GetMaximumNumberOfCentersForDirectSolution();
+}
+
 mitk::Image::Pointer mitk::SurfaceInterpolationController::GetCurrentSegmentation()
 {
   return m_SelectedSegmentation;
@@ -376,6 +386,14 @@ mitk::Image *mitk::SurfaceInterpolationController::GetImage()
 double mitk::SurfaceInterpolationController::EstimatePortionOfNeededMemory()
 {
   double numberOfPointsAfterReduction = m_ReduceFilter->GetNumberOfPointsAfterReduction() * 3;
+  if (m_ReduceFilter->GetNumberOfPointsAfterReduction() >
+      m_InterpolateSurfaceFilter->GetMaximumNumberOfCentersForDirectSolution())
+  {
+    // The partition of unity only builds the small equation systems of the patches, one after the other.
+    // A patch covers its octree leaf and parts of the neighbouring leaves.
+    numberOfPointsAfterReduction =
+      std::min(numberOfPointsAfterReduction, 3.0 * 8 * m_InterpolateSurfaceFilter->GetNumberOfCentersPerPatch());
+  }
   double sizeOfPoints = pow(numberOfPointsAfterReduction, 2) * sizeof(double);
   double totalMem = mitk::MemoryUtilities::GetTotalSizeOfPhysicalRam();
   double percentage = sizeOfPoints / totalMem;
@@ -144,6 +144,16 @@ namespace mitk
      */
     void SetDistanceImageVolume(unsigned int distImageVolume);
 
+    /**
+     * Sets the number of contour points up to which the interpolation solves one global equation system.
+     * Above it the partition of unity is used, whose local solutions are reused when contours are added
+     * or removed. Setting 0 always uses the partition of unity, which is faster for interactive sessions
+     * but only approximates the global solution. The default of mitk::CreateDistanceImageFromSurfaceFilter
+     * is kept unless this is called.
+     */
+    void SetMaximumNumberOfCentersForDirectSolution(unsigned int numberOfCenters);
+    unsigned int GetMaximumNumberOfCentersForDirectSolution() const;
+
     /**
      * @brief Get the current selected segmentation for which the interpolation is performed
      * @return the current segmentation image
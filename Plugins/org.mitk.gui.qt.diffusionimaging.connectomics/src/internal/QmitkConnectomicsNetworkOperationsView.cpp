@@ -81,6 +81,8 @@ void QmitkConnectomicsNetworkOperationsView::CreateQtPartControl( QWidget *paren
     this->m_Controls->convertToRGBAImagePushButton->show();
     this->m_Controls->assignFreeSurferColorsPushButton->show();
     this->m_Controls->modularizePushButton->hide();
+    this->m_Controls->numberOfChainsLabel->hide();
+    this->m_Controls->numberOfChainsSpinBox->hide();
     this->m_Controls->pruneOptionsGroupBox->show();
   }
   else
@@ -88,6 +90,8 @@ void QmitkConnectomicsNetworkOperationsView::CreateQtPartControl( QWidget *paren
     this->m_Controls->convertToRGBAImagePushButton->show();
     this->m_Controls->assignFreeSurferColorsPushButton->show();
     this->m_Controls->modularizePushButton->show();
+    this->m_Controls->numberOfChainsLabel->show();
+    this->m_Controls->numberOfChainsSpinBox->show();
     this->m_Controls->pruneOptionsGroupBox->show();
   }
 
@@ -437,10 +441,13 @@ void QmitkConnectomicsNetworkOperationsView::OnModularizePushButtonClicked()
         permutation->SetNetwork( connectomicsNetwork );
         permutation->SetDepth( depthOfModuleRecursive );
         permutation->SetStepSize( stepSize );
+        // different results on each run, the seeds are drawn here and not in the parallel chains
+        permutation->SetSeed( static_cast< unsigned int >( rand() ) );
+        manager->SetSeed( static_cast< unsigned int >( rand() ) );
 
         manager->SetPermutation( permutation.GetPointer() );
 
-        manager->RunSimulatedAnnealing( startTemperature, stepSize );
+        manager->RunSimulatedAnnealing( startTemperature, stepSize, m_Controls->numberOfChainsSpinBox->value() );
 
         MappingType mapping = permutation->GetMapping();
 
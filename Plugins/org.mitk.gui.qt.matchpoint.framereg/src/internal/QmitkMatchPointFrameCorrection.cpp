@@ -44,6 +44,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <QFileDialog>
 #include <QErrorMessage>
 #include <QThreadPool>
+#include <QThread>
 #include <QDateTime>
 
 // MatchPoint
@@ -57,6 +58,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mapConvert.h>
 #include <mapDeploymentDLLAccess.h>
 
+#include <algorithm>
+
 const std::string QmitkMatchPointFrameCorrection::VIEW_ID =
   "org.mitk.views.matchpoint.algorithm.framereg";
 
@@ -203,6 +206,7 @@ void QmitkMatchPointFrameCorrection::CreateQtPartControl(QWidget* parent)
   m_Controls.m_tabs->setCurrentIndex(0);
 
   m_Controls.m_mapperSettings->AllowSampling(false);
+  m_Controls.m_sbConcurrentFrames->setMaximum(std::max(1, QThread::idealThreadCount()));
 
   m_AlgorithmSelectionListener.reset(new
                                      berry::SelectionChangedAdapter<QmitkMatchPointFrameCorrection>(this,
@@ -632,6 +636,13 @@ void QmitkMatchPointFrameCorrection::OnStartRegBtnPushed()
   pJob->m_TargetDataUID = mitk::EnsureUID(this->m_spSelectedTargetNode->GetData());
   pJob->m_IgnoreList = this->GenerateIgnoreList();
 
+  ::map::deployment::DLLHandle::Pointer dllHandle = m_LoadedDLLHandle;
+  pJob->m_AlgorithmFactory = [dllHandle]()
+  {
+    return ::map::deployment::getRegistrationAlgorithm(dllHandle);
+  };
+  pJob->m_NumberOfThreads = m_Controls.m_sbConcurrentFrames->value();
+
   if (m_spSelectedTargetMaskData.IsNotNull())
   {
     pJob->m_spTargetMask = m_spSelectedTargetMaskData;
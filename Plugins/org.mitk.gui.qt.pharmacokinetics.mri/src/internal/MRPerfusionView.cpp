@@ -1393,6 +1393,8 @@ mitk::ModelFitFunctorBase::Pointer MRPerfusionView::CreateDefaultFitFunctor(
   scales.SetSize(refModel->GetNumberOfParameters());
   scales.Fill(1.0);
   fitFunctor->SetScales(scales);
+  //pixel based fits pass the masked voxels of an image line as one batch
+  fitFunctor->SetUseBatchedSolver(true);
 
   fitFunctor->SetDebugParameterMaps(m_Controls.checkDebug->isChecked());
 
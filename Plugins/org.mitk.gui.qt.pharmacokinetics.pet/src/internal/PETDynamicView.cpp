@@ -812,6 +812,8 @@ mitk::ModelFitFunctorBase::Pointer PETDynamicView::CreateDefaultFitFunctor(
   scales.SetSize(refModel->GetNumberOfParameters());
   scales.Fill(1.0);
   fitFunctor->SetScales(scales);
+  //pixel based fits pass the masked voxels of an image line as one batch
+  fitFunctor->SetUseBatchedSolver(true);
 
   return fitFunctor.GetPointer();
 }